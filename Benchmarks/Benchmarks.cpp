@@ -0,0 +1,61 @@
+#include "Benchmarks.h"
+
+#include <cstdio>
+#include <cstring>
+
+/*
+* CPU microbenchmarks for engine systems that do not need a window or a RenderLayer.
+*
+* Usage: Benchmarks [Name]
+*/
+
+struct BenchmarkEntry
+{
+    const char*   Name;
+    BenchmarkFunc Func;
+};
+
+static const BenchmarkEntry GBenchmarks[] =
+{
+    { "FrustumCulling",          RunFrustumCullingBenchmark },
+    { "BoundingVolumeHierarchy", RunBoundingVolumeHierarchyBenchmark },
+    { "ClassType",               RunClassTypeBenchmark },
+    { "RenderGraph",             RunRenderGraphBenchmark },
+};
+
+int main(int Argc, char** Argv)
+{
+    const char* Filter = (Argc > 1) ? Argv[1] : nullptr;
+
+    int32 Result = 0;
+    bool  HasRun = false;
+    for (const BenchmarkEntry& Benchmark : GBenchmarks)
+    {
+        if (Filter && strcmp(Filter, Benchmark.Name) != 0)
+        {
+            continue;
+        }
+
+        printf("--- %s ---\n", Benchmark.Name);
+        if (!Benchmark.Func())
+        {
+            printf("%s: FAILED\n", Benchmark.Name);
+            Result = -1;
+        }
+
+        HasRun = true;
+    }
+
+    if (!HasRun)
+    {
+        printf("Unknown benchmark '%s', available benchmarks:\n", Filter);
+        for (const BenchmarkEntry& Benchmark : GBenchmarks)
+        {
+            printf("    %s\n", Benchmark.Name);
+        }
+
+        return -1;
+    }
+
+    return Result;
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include "Core/Types.h"
+
+/*
+* Each benchmark prints its results to stdout and returns false if an optimized path gives a different result than
+* the reference path.
+*/
+
+typedef bool(*BenchmarkFunc)();
+
+bool RunFrustumCullingBenchmark();
+bool RunBoundingVolumeHierarchyBenchmark();
+bool RunClassTypeBenchmark();
+bool RunRenderGraphBenchmark();
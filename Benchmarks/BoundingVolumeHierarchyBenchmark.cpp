@@ -0,0 +1,153 @@
+#include "PreCompiled.h"
+#include "Benchmarks.h"
+
+#include "Scene/BoundingVolumeHierarchy.h"
+
+#include "Time/Platform/PlatformTime.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+/*
+* Compares a frustum query in the BoundingVolumeHierarchy with the linear CullBoundingBoxes for a large open scene,
+* where the camera only sees a small part of the objects. Also measures the build and the refit after a part of the
+* objects has moved.
+*/
+
+static constexpr float  WORLD_SIZE                = 10000.0f;
+static constexpr uint32 NUM_QUERY_ITERATIONS      = 100;
+static constexpr uint32 MOVED_OBJECTS_PER_MILLION = 10000;
+
+static Frustum CreateBenchmarkFrustum(float Yaw)
+{
+    const float NearPlane = 0.01f;
+    const float FarPlane  = 1000.0f;
+
+    const XMVECTOR Position = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+    const XMVECTOR Forward  = XMVectorSet(sinf(Yaw), 0.0f, cosf(Yaw), 0.0f);
+
+    XMFLOAT4X4 View;
+    XMMATRIX XmView = XMMatrixLookToLH(Position, Forward, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    XMStoreFloat4x4(&View, XMMatrixTranspose(XmView));
+
+    XMFLOAT4X4 Projection;
+    XMStoreFloat4x4(&Projection, XMMatrixPerspectiveFovLH(XMConvertToRadians(90.0f), 16.0f / 9.0f, NearPlane, FarPlane));
+
+    return Frustum(FarPlane, View, Projection);
+}
+
+static double TicksToMilliseconds(uint64 Ticks, uint64 Frequency)
+{
+    return (double(Ticks) * 1000.0) / double(Frequency);
+}
+
+static bool RunWithNumBoxes(uint32 NumBoxes)
+{
+    std::mt19937 Generator(1337);
+    std::uniform_real_distribution<float> PositionDistribution(-WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+    std::uniform_real_distribution<float> HeightDistribution(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> ExtentDistribution(0.5f, 5.0f);
+
+    BoundingBoxSoA Boxes;
+    Boxes.Reserve(NumBoxes);
+    for (uint32 Index = 0; Index < NumBoxes; Index++)
+    {
+        const XMFLOAT3 Center(PositionDistribution(Generator), HeightDistribution(Generator), PositionDistribution(Generator));
+        const XMFLOAT3 Extent(ExtentDistribution(Generator), ExtentDistribution(Generator), ExtentDistribution(Generator));
+        Boxes.Add(Center, Extent);
+    }
+
+    const uint64 Frequency = PlatformTime::QueryPerformanceFrequency();
+
+    BoundingVolumeHierarchy BVH;
+    uint64 StartTicks = PlatformTime::QueryPerformanceCounter();
+    BVH.Build(Boxes);
+    const double BuildMilliseconds = TicksToMilliseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency);
+
+    const BVHStatistics& Statistics = BVH.GetStatistics();
+    printf("%u boxes, %u nodes, %u leaves, depth %u, SAH cost %.2f\n", NumBoxes, Statistics.NumNodes, Statistics.NumLeaves, Statistics.MaxDepth, Statistics.BuildCost);
+    printf("    %-24s %10.3f ms\n", "Build", BuildMilliseconds);
+
+    bool Result = true;
+
+    // Turn the camera around so that the queries see different parts of the tree
+    TArray<uint64> LinearMask;
+    TArray<uint64> TreeMask;
+    double LinearMilliseconds = 0.0;
+    double TreeMilliseconds   = 0.0;
+    uint32 NumVisible         = 0;
+    for (uint32 Iteration = 0; Iteration < NUM_QUERY_ITERATIONS; Iteration++)
+    {
+        const Frustum CameraFrustum = CreateBenchmarkFrustum(XM_2PI * float(Iteration) / float(NUM_QUERY_ITERATIONS));
+
+        StartTicks = PlatformTime::QueryPerformanceCounter();
+        CullBoundingBoxes(CameraFrustum, Boxes, LinearMask);
+        LinearMilliseconds += TicksToMilliseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency);
+
+        StartTicks = PlatformTime::QueryPerformanceCounter();
+        BVH.QueryFrustum(CameraFrustum, TreeMask);
+        TreeMilliseconds += TicksToMilliseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency);
+
+        if (memcmp(LinearMask.Data(), TreeMask.Data(), LinearMask.SizeInBytes()) != 0)
+        {
+            printf("    Frustum query %u gives a different result than CullBoundingBoxes\n", Iteration);
+            Result = false;
+        }
+
+        for (uint32 Index = 0; Index < NumBoxes; Index++)
+        {
+            NumVisible += IsBoxVisible(TreeMask, Index) ? 1 : 0;
+        }
+    }
+
+    LinearMilliseconds /= double(NUM_QUERY_ITERATIONS);
+    TreeMilliseconds   /= double(NUM_QUERY_ITERATIONS);
+
+    printf("    %-24s %10.3f ms  (%.2f%% visible)\n", "CullBoundingBoxes", LinearMilliseconds, (100.0 * double(NumVisible)) / (double(NumBoxes) * double(NUM_QUERY_ITERATIONS)));
+    printf("    %-24s %10.3f ms %6.2fx\n", "QueryFrustum", TreeMilliseconds, LinearMilliseconds / TreeMilliseconds);
+
+    // Move a part of the objects a short distance, which is what happens to the dynamic objects of a scene every frame
+    std::uniform_real_distribution<float> OffsetDistribution(-1.0f, 1.0f);
+
+    const uint32 NumMoved = std::max<uint32>(uint32((uint64(NumBoxes) * MOVED_OBJECTS_PER_MILLION) / 1000000), 1);
+    TArray<uint32> MovedObjects;
+    for (uint32 Index = 0; Index < NumMoved; Index++)
+    {
+        const uint32 Object = (Index * 7919) % NumBoxes;
+        const XMFLOAT3 Center(Boxes.GetCenterX()[Object] + OffsetDistribution(Generator), Boxes.GetCenterY()[Object], Boxes.GetCenterZ()[Object] + OffsetDistribution(Generator));
+        const XMFLOAT3 Extent(Boxes.GetExtentX()[Object], Boxes.GetExtentY()[Object], Boxes.GetExtentZ()[Object]);
+        Boxes.Set(Object, Center, Extent);
+        MovedObjects.EmplaceBack(Object);
+    }
+
+    StartTicks = PlatformTime::QueryPerformanceCounter();
+    const bool IsRebuilt = BVH.Update(MovedObjects);
+    const double UpdateMilliseconds = TicksToMilliseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency);
+
+    printf("    %-24s %10.3f ms  (%u moved, %s, SAH cost %.2f)\n", "Update", UpdateMilliseconds, NumMoved, IsRebuilt ? "rebuilt" : "refitted", BVH.GetStatistics().Cost);
+
+    const Frustum CameraFrustum = CreateBenchmarkFrustum(0.0f);
+    CullBoundingBoxes(CameraFrustum, Boxes, LinearMask);
+    BVH.QueryFrustum(CameraFrustum, TreeMask);
+    if (memcmp(LinearMask.Data(), TreeMask.Data(), LinearMask.SizeInBytes()) != 0)
+    {
+        printf("    Frustum query after Update gives a different result than CullBoundingBoxes\n");
+        Result = false;
+    }
+
+    return Result;
+}
+
+bool RunBoundingVolumeHierarchyBenchmark()
+{
+    bool Result = true;
+
+    const uint32 BoxCounts[] = { 10000, 100000, 1000000 };
+    for (uint32 NumBoxes : BoxCounts)
+    {
+        Result = RunWithNumBoxes(NumBoxes) && Result;
+    }
+
+    return Result;
+}
@@ -0,0 +1,162 @@
+#include "PreCompiled.h"
+#include "Benchmarks.h"
+
+#include "Scene/Lights/PointLight.h"
+#include "Scene/Lights/DirectionalLight.h"
+#include "Scene/Lights/SpotLight.h"
+
+#include "Time/Platform/PlatformTime.h"
+
+#include <cstdio>
+#include <random>
+
+/*
+* Measures the type checks that run for every light and component each frame. Cast<PointLight> uses the fast path
+* for final classes, IsSubClassOf<Light> uses the pre-order ranges of ClassType, and both are compared with walking
+* the super classes, which is how IsSubClassOf used to work.
+*/
+
+static constexpr uint32 NUM_LIGHTS          = 10000;
+static constexpr uint32 NUM_CAST_ITERATIONS = 1000;
+
+static bool IsSubClassOfByWalk(const ClassType* Current, const ClassType* Class)
+{
+    for (; Current; Current = Current->GetSuperClass())
+    {
+        if (Current == Class)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static double TicksToMilliseconds(uint64 Ticks, uint64 Frequency)
+{
+    return (double(Ticks) * 1000.0) / double(Frequency);
+}
+
+bool RunClassTypeBenchmark()
+{
+    std::mt19937 Generator(1337);
+    std::uniform_int_distribution<uint32> TypeDistribution(0, 2);
+
+    TArray<Light*> Lights;
+    Lights.Reserve(NUM_LIGHTS);
+    for (uint32 Index = 0; Index < NUM_LIGHTS; Index++)
+    {
+        const uint32 Type = TypeDistribution(Generator);
+        if (Type == 0)
+        {
+            Lights.EmplaceBack(DBG_NEW PointLight());
+        }
+        else if (Type == 1)
+        {
+            Lights.EmplaceBack(DBG_NEW DirectionalLight());
+        }
+        else
+        {
+            Lights.EmplaceBack(DBG_NEW SpotLight());
+        }
+    }
+
+    const uint64 Frequency = PlatformTime::QueryPerformanceFrequency();
+    const ClassType* PointLightClass = PointLight::GetStaticClass();
+    const ClassType* LightClass      = Light::GetStaticClass();
+
+    // The counts are printed so that the compiler can not remove the loops
+    uint64 NumWalkPointLights = 0;
+    uint64 StartTicks = PlatformTime::QueryPerformanceCounter();
+    for (uint32 Iteration = 0; Iteration < NUM_CAST_ITERATIONS; Iteration++)
+    {
+        for (Light* CurrentLight : Lights)
+        {
+            NumWalkPointLights += IsSubClassOfByWalk(CurrentLight->GetClass(), PointLightClass) ? 1 : 0;
+        }
+    }
+    const double WalkMilliseconds = TicksToMilliseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency);
+
+    uint64 NumCastPointLights = 0;
+    StartTicks = PlatformTime::QueryPerformanceCounter();
+    for (uint32 Iteration = 0; Iteration < NUM_CAST_ITERATIONS; Iteration++)
+    {
+        for (Light* CurrentLight : Lights)
+        {
+            NumCastPointLights += Cast<PointLight>(CurrentLight) ? 1 : 0;
+        }
+    }
+    const double CastMilliseconds = TicksToMilliseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency);
+
+    uint64 NumWalkLights = 0;
+    StartTicks = PlatformTime::QueryPerformanceCounter();
+    for (uint32 Iteration = 0; Iteration < NUM_CAST_ITERATIONS; Iteration++)
+    {
+        for (Light* CurrentLight : Lights)
+        {
+            NumWalkLights += IsSubClassOfByWalk(CurrentLight->GetClass(), LightClass) ? 1 : 0;
+        }
+    }
+    const double WalkBaseMilliseconds = TicksToMilliseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency);
+
+    // Light is not final, so this takes the range compare
+    uint64 NumRangeLights = 0;
+    StartTicks = PlatformTime::QueryPerformanceCounter();
+    for (uint32 Iteration = 0; Iteration < NUM_CAST_ITERATIONS; Iteration++)
+    {
+        for (Light* CurrentLight : Lights)
+        {
+            NumRangeLights += IsSubClassOf<Light>(CurrentLight) ? 1 : 0;
+        }
+    }
+    const double RangeMilliseconds = TicksToMilliseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency);
+
+    const double NumChecks = double(NUM_LIGHTS) * double(NUM_CAST_ITERATIONS);
+    printf("%u lights, %llu point lights\n", NUM_LIGHTS, NumCastPointLights / NUM_CAST_ITERATIONS);
+    printf("    %-28s %10.3f ms %8.2f ns/check\n", "Walk (PointLight)", WalkMilliseconds, (WalkMilliseconds * 1000000.0) / NumChecks);
+    printf("    %-28s %10.3f ms %8.2f ns/check %6.2fx\n", "Cast<PointLight>", CastMilliseconds, (CastMilliseconds * 1000000.0) / NumChecks, WalkMilliseconds / CastMilliseconds);
+    printf("    %-28s %10.3f ms %8.2f ns/check\n", "Walk (Light)", WalkBaseMilliseconds, (WalkBaseMilliseconds * 1000000.0) / NumChecks);
+    printf("    %-28s %10.3f ms %8.2f ns/check %6.2fx\n", "IsSubClassOf<Light>", RangeMilliseconds, (RangeMilliseconds * 1000000.0) / NumChecks, WalkBaseMilliseconds / RangeMilliseconds);
+
+    bool Result = true;
+    if (NumWalkPointLights != NumCastPointLights)
+    {
+        printf("    Cast<PointLight> found %llu point lights, walking the super classes found %llu\n", NumCastPointLights, NumWalkPointLights);
+        Result = false;
+    }
+
+    if (NumWalkLights != NumRangeLights)
+    {
+        printf("    IsSubClassOf<Light> found %llu lights, walking the super classes found %llu\n", NumRangeLights, NumWalkLights);
+        Result = false;
+    }
+
+    // Every registered class must agree with the walk, not only the lights
+    const ClassType* Classes[] =
+    {
+        CoreObject::GetStaticClass(),
+        Light::GetStaticClass(),
+        PointLight::GetStaticClass(),
+        DirectionalLight::GetStaticClass(),
+        SpotLight::GetStaticClass(),
+    };
+
+    for (const ClassType* Class : Classes)
+    {
+        for (const ClassType* Other : Classes)
+        {
+            if (Class->IsSubClassOf(Other) != IsSubClassOfByWalk(Class, Other))
+            {
+                printf("    %s::IsSubClassOf(%s) is wrong\n", Class->GetName(), Other->GetName());
+                Result = false;
+            }
+        }
+    }
+
+    for (Light* CurrentLight : Lights)
+    {
+        SafeDelete(CurrentLight);
+    }
+
+    return Result;
+}
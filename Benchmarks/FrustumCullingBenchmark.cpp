@@ -0,0 +1,151 @@
+#include "PreCompiled.h"
+#include "Benchmarks.h"
+
+#include "Scene/FrustumCulling.h"
+
+#include "Time/Platform/PlatformTime.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+/*
+* Compares Frustum::CheckAABB, which is what the renderer used to call once per MeshDrawCommand, with
+* CullBoundingBoxes for every instruction set that the CPU supports. The boxes are spread out in a cube around the
+* camera so that only some of them are inside the frustum.
+*/
+
+static constexpr uint32 TOTAL_BOXES_PER_MEASUREMENT = 10000000;
+
+static Frustum CreateBenchmarkFrustum()
+{
+    const float NearPlane = 0.01f;
+    const float FarPlane  = 1000.0f;
+
+    XMFLOAT4X4 View;
+    XMMATRIX XmView = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    XMStoreFloat4x4(&View, XMMatrixTranspose(XmView));
+
+    XMFLOAT4X4 Projection;
+    XMStoreFloat4x4(&Projection, XMMatrixPerspectiveFovLH(XMConvertToRadians(90.0f), 16.0f / 9.0f, NearPlane, FarPlane));
+
+    return Frustum(FarPlane, View, Projection);
+}
+
+static double TicksToNanoseconds(uint64 Ticks, uint64 Frequency)
+{
+    return (double(Ticks) * 1000000000.0) / double(Frequency);
+}
+
+static bool RunWithNumBoxes(const Frustum& CameraFrustum, uint32 NumBoxes)
+{
+    std::mt19937 Generator(1337);
+    std::uniform_real_distribution<float> PositionDistribution(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> ExtentDistribution(0.5f, 5.0f);
+
+    TArray<AABB>   Boxes(NumBoxes);
+    BoundingBoxSoA BoxesSoA;
+    BoxesSoA.Reserve(NumBoxes);
+    for (uint32 Index = 0; Index < NumBoxes; Index++)
+    {
+        const XMFLOAT3 Center(PositionDistribution(Generator), PositionDistribution(Generator), PositionDistribution(Generator));
+        const XMFLOAT3 Extent(ExtentDistribution(Generator), ExtentDistribution(Generator), ExtentDistribution(Generator));
+
+        Boxes[Index].Top    = XMFLOAT3(Center.x + Extent.x, Center.y + Extent.y, Center.z + Extent.z);
+        Boxes[Index].Bottom = XMFLOAT3(Center.x - Extent.x, Center.y - Extent.y, Center.z - Extent.z);
+        BoxesSoA.Add(Center, Extent);
+    }
+
+    const uint32 NumIterations = std::max<uint32>(TOTAL_BOXES_PER_MEASUREMENT / NumBoxes, 1);
+    const uint64 Frequency     = PlatformTime::QueryPerformanceFrequency();
+
+    // Reference
+    TArray<uint64> ReferenceMask((NumBoxes + 63) / 64, 0);
+    uint64 StartTicks = PlatformTime::QueryPerformanceCounter();
+    for (uint32 Iteration = 0; Iteration < NumIterations; Iteration++)
+    {
+        for (uint32 Index = 0; Index < NumBoxes; Index++)
+        {
+            if (CameraFrustum.CheckAABB(Boxes[Index]))
+            {
+                ReferenceMask[Index / 64] |= uint64(1) << (Index % 64);
+            }
+        }
+    }
+
+    const double ReferenceNanoseconds = TicksToNanoseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency) / double(NumIterations);
+
+    uint32 NumVisible = 0;
+    for (uint32 Index = 0; Index < NumBoxes; Index++)
+    {
+        NumVisible += IsBoxVisible(ReferenceMask, Index) ? 1 : 0;
+    }
+
+    printf("%u boxes, %u visible, %u iteration(s)\n", NumBoxes, NumVisible, NumIterations);
+    printf("    %-16s %10.3f ms %8.2f ns/box\n", "CheckAABB", ReferenceNanoseconds / 1000000.0, ReferenceNanoseconds / double(NumBoxes));
+
+    bool Result = true;
+
+    TArray<uint64> ScalarMask;
+    const ECullingInstructionSet SupportedInstructionSet = GetSupportedCullingInstructionSet();
+    for (uint32 InstructionSetIndex = 0; InstructionSetIndex <= uint32(SupportedInstructionSet); InstructionSetIndex++)
+    {
+        const ECullingInstructionSet InstructionSet = ECullingInstructionSet(InstructionSetIndex);
+
+        TArray<uint64> VisibilityMask;
+        StartTicks = PlatformTime::QueryPerformanceCounter();
+        for (uint32 Iteration = 0; Iteration < NumIterations; Iteration++)
+        {
+            CullBoundingBoxes(CameraFrustum, BoxesSoA, VisibilityMask, InstructionSet);
+        }
+
+        const double Nanoseconds = TicksToNanoseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency) / double(NumIterations);
+
+        // The corner test and the p-vertex test can only disagree for boxes that touch a plane because of rounding
+        uint32 NumDifferentFromReference = 0;
+        for (uint32 Index = 0; Index < NumBoxes; Index++)
+        {
+            if (IsBoxVisible(VisibilityMask, Index) != IsBoxVisible(ReferenceMask, Index))
+            {
+                NumDifferentFromReference++;
+            }
+        }
+
+        printf("    %-16s %10.3f ms %8.2f ns/box %6.2fx  (%u differ from CheckAABB)\n",
+            ToString(InstructionSet),
+            Nanoseconds / 1000000.0,
+            Nanoseconds / double(NumBoxes),
+            ReferenceNanoseconds / Nanoseconds,
+            NumDifferentFromReference);
+
+        // All instruction sets must give exactly the same result
+        if (InstructionSet == ECullingInstructionSet::Scalar)
+        {
+            ScalarMask = VisibilityMask;
+        }
+        else if (memcmp(ScalarMask.Data(), VisibilityMask.Data(), VisibilityMask.SizeInBytes()) != 0)
+        {
+            printf("    %s gives a different result than Scalar\n", ToString(InstructionSet));
+            Result = false;
+        }
+    }
+
+    return Result;
+}
+
+bool RunFrustumCullingBenchmark()
+{
+    printf("Supported instruction set: %s\n", ToString(GetSupportedCullingInstructionSet()));
+
+    const Frustum CameraFrustum = CreateBenchmarkFrustum();
+
+    bool Result = true;
+
+    const uint32 BoxCounts[] = { 10000, 100000, 1000000 };
+    for (uint32 NumBoxes : BoxCounts)
+    {
+        Result = RunWithNumBoxes(CameraFrustum, NumBoxes) && Result;
+    }
+
+    return Result;
+}
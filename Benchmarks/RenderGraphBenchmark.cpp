@@ -0,0 +1,116 @@
+#include "PreCompiled.h"
+#include "Benchmarks.h"
+
+#include "Rendering/RenderGraph.h"
+
+#include "Time/Platform/PlatformTime.h"
+
+#include <cstdio>
+
+/*
+* Compiles a chain of passes where each pass reads the texture of the previous pass and writes a new texture with the
+* same description, like the downsample chain of a bloom. Transient textures whose lifetimes do not overlap must share
+* a physical texture, so the whole chain needs two of them, while a texture with another description must get its own.
+* Compile does not touch the RenderLayer, so it runs without a device.
+*/
+
+static constexpr uint32 NUM_CHAIN_PASSES       = 1000;
+static constexpr uint32 NUM_COMPILE_ITERATIONS = 100;
+
+static double TicksToMilliseconds(uint64 Ticks, uint64 Frequency)
+{
+    return (double(Ticks) * 1000.0) / double(Frequency);
+}
+
+static void BuildChainGraph(RenderGraph& Graph, TArray<RenderGraphTexture>& OutChainTextures, RenderGraphTexture& OutOtherTexture)
+{
+    const RenderGraphTextureDesc ChainDesc(EFormat::R16G16B16A16_Float, 1920, 1080, TextureFlags_RWTexture);
+    const RenderGraphTextureDesc OtherDesc(EFormat::R8G8B8A8_Unorm, 1920, 1080, TextureFlags_RWTexture);
+
+    OutChainTextures.Clear();
+    for (uint32 PassIndex = 0; PassIndex < NUM_CHAIN_PASSES; PassIndex++)
+    {
+        OutChainTextures.EmplaceBack(Graph.CreateTexture("Chain " + std::to_string(PassIndex), ChainDesc));
+
+        RenderGraphPassBuilder Builder = Graph.AddPass("Chain Pass", ERenderGraphQueue::Compute, [](CommandList&) {});
+        if (PassIndex > 0)
+        {
+            Builder.Read(OutChainTextures[PassIndex - 1], EResourceState::NonPixelShaderResource);
+        }
+
+        Builder.Write(OutChainTextures[PassIndex], EResourceState::UnorderedAccess);
+    }
+
+    OutOtherTexture = Graph.CreateTexture("Other", OtherDesc);
+    Graph.AddPass("Resolve", ERenderGraphQueue::Compute, [](CommandList&) {})
+        .Read(OutChainTextures[NUM_CHAIN_PASSES - 1], EResourceState::NonPixelShaderResource)
+        .Write(OutOtherTexture, EResourceState::UnorderedAccess)
+        .SetSideEffects();
+}
+
+bool RunRenderGraphBenchmark()
+{
+    bool Result = true;
+
+    TArray<RenderGraphTexture> ChainTextures;
+    RenderGraphTexture         OtherTexture;
+
+    const uint64 Frequency = PlatformTime::QueryPerformanceFrequency();
+
+    double CompileMilliseconds = 0.0;
+    for (uint32 Iteration = 0; Iteration < NUM_COMPILE_ITERATIONS; Iteration++)
+    {
+        RenderGraph Graph;
+        BuildChainGraph(Graph, ChainTextures, OtherTexture);
+
+        const uint64 StartTicks = PlatformTime::QueryPerformanceCounter();
+        Graph.Compile();
+        CompileMilliseconds += TicksToMilliseconds(PlatformTime::QueryPerformanceCounter() - StartTicks, Frequency);
+
+        if (Iteration > 0)
+        {
+            continue;
+        }
+
+        // Texture N is last read by pass N + 1, so texture N + 2 is the first one that can reuse its physical texture
+        for (uint32 Index = 0; Index + 2 < ChainTextures.Size(); Index++)
+        {
+            const uint32 Slot         = Graph.GetTextureNode(ChainTextures[Index]).PhysicalSlot;
+            const uint32 NextSlot     = Graph.GetTextureNode(ChainTextures[Index + 1]).PhysicalSlot;
+            const uint32 NextNextSlot = Graph.GetTextureNode(ChainTextures[Index + 2]).PhysicalSlot;
+            if (Slot == NextSlot || Slot != NextNextSlot)
+            {
+                printf("    Chain textures %u, %u and %u are assigned to slots %u, %u and %u\n", Index, Index + 1, Index + 2, Slot, NextSlot, NextNextSlot);
+                Result = false;
+                break;
+            }
+        }
+
+        const uint32 OtherSlot = Graph.GetTextureNode(OtherTexture).PhysicalSlot;
+        for (RenderGraphTexture ChainTexture : ChainTextures)
+        {
+            if (Graph.GetTextureNode(ChainTexture).PhysicalSlot == OtherSlot)
+            {
+                printf("    A texture with another description shares slot %u with the chain\n", OtherSlot);
+                Result = false;
+                break;
+            }
+        }
+
+        const RenderGraphStatistics& Statistics = Graph.GetStatistics();
+        if (Statistics.NumPhysicalTextures != 3 || Statistics.PhysicalBytes >= Statistics.TransientBytes)
+        {
+            printf("    Expected 3 physical textures, got %u\n", Statistics.NumPhysicalTextures);
+            Result = false;
+        }
+
+        printf("    %u transient textures in %u physical textures, %.2f MB instead of %.2f MB\n",
+            Statistics.NumTransientTextures,
+            Statistics.NumPhysicalTextures,
+            double(Statistics.PhysicalBytes) / (1024.0 * 1024.0),
+            double(Statistics.TransientBytes) / (1024.0 * 1024.0));
+    }
+
+    printf("    %-24s %10.3f ms  (%u passes)\n", "Compile", CompileMilliseconds / double(NUM_COMPILE_ITERATIONS), NUM_CHAIN_PASSES + 1);
+    return Result;
+}
@@ -0,0 +1,121 @@
+#include "RenderLayer/RenderLayer.h"
+#include "RenderLayer/CommandListCapture.h"
+#include "RenderLayer/CommandListReplay.h"
+
+#include "Core/Application/Log.h"
+#include "Core/Application/Generic/GenericOutputConsole.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*
+* Replays a frame captured with the console command r.CaptureFrame on the NullRenderLayer and prints the number of
+* commands and the time spent on each command type. This makes it possible to measure the CPU cost of the command
+* stream without a GPU.
+*
+* Usage: CommandListReplay <Capture> [-iterations N] [-dump <Output>]
+*/
+
+static void PrintUsage()
+{
+    printf("Usage: CommandListReplay <Capture> [-iterations N] [-dump <Output>]\n");
+}
+
+int main(int Argc, char** Argv)
+{
+    if (Argc < 2)
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    const std::string CaptureFilename = Argv[1];
+
+    uint32      NumIterations = 1;
+    std::string DumpFilename;
+    for (int32 i = 2; i < Argc; i++)
+    {
+        if (strcmp(Argv[i], "-iterations") == 0 && i + 1 < Argc)
+        {
+            NumIterations = uint32(atoi(Argv[++i]));
+        }
+        else if (strcmp(Argv[i], "-dump") == 0 && i + 1 < Argc)
+        {
+            DumpFilename = Argv[++i];
+        }
+        else
+        {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    GConsoleOutput = GenericOutputConsole::Create();
+    if (!GConsoleOutput)
+    {
+        return -1;
+    }
+
+    int32 Result = 0;
+
+    CommandListCapture Capture;
+    if (!Capture.LoadFromFile(CaptureFilename))
+    {
+        LOG_ERROR("Failed to load capture '" + CaptureFilename + "'");
+        Result = -1;
+    }
+    else if (!RenderLayer::Init(ERenderLayerApi::Null))
+    {
+        LOG_ERROR("Failed to initialize the NullRenderLayer");
+        Result = -1;
+    }
+    else
+    {
+        {
+            CommandListReplayer Replayer(Capture);
+            if (!DumpFilename.empty())
+            {
+                const std::string Text = Replayer.DumpToString();
+
+                FILE* File = fopen(DumpFilename.c_str(), "w");
+                if (File)
+                {
+                    fwrite(Text.c_str(), 1, Text.size(), File);
+                    fclose(File);
+                }
+                else
+                {
+                    LOG_ERROR("Failed to open '" + DumpFilename + "'");
+                    Result = -1;
+                }
+            }
+
+            ICommandContext* CmdContext = GetDefaultCommandContext();
+            if (Replayer.CreateResources() && CmdContext)
+            {
+                CommandReplayStatistics Statistics;
+                for (uint32 i = 0; i < NumIterations; i++)
+                {
+                    if (!Replayer.Replay(*CmdContext, Statistics))
+                    {
+                        Result = -1;
+                        break;
+                    }
+                }
+
+                printf("Replayed %u commands %u time(s)\n", Capture.GetNumCommands(), NumIterations);
+                printf("%s", Statistics.ToString().c_str());
+            }
+            else
+            {
+                Result = -1;
+            }
+        }
+
+        RenderLayer::Release();
+    }
+
+    SafeDelete(GConsoleOutput);
+    return Result;
+}
@@ -1,5 +1,7 @@
 #include "ClassType.h"
 
+static ClassType* GRootClasses = nullptr;
+
 ClassType::ClassType(
     const char* InName,
     const ClassType* InSuperClass,
@@ -8,17 +10,40 @@ ClassType::ClassType(
     , SuperClass(InSuperClass)
     , SizeInBytes(SizeInBytes)
 {
+    // The super class is always registered first, since its GetStaticClass is called to construct this class. The
+    // super classes are static objects, so the const only means that the pointer is not used to change its info.
+    if (SuperClass)
+    {
+        ClassType* MutableSuperClass = const_cast<ClassType*>(SuperClass);
+        NextSibling = MutableSuperClass->FirstSubClass;
+        MutableSuperClass->FirstSubClass = this;
+    }
+    else
+    {
+        NextSibling  = GRootClasses;
+        GRootClasses = this;
+    }
+
+    RenumberClasses();
+}
+
+void ClassType::RenumberClasses()
+{
+    uint32 NextIndex = 0;
+    for (ClassType* Root = GRootClasses; Root; Root = Root->NextSibling)
+    {
+        NextIndex = NumberClass(Root, NextIndex);
+    }
 }
 
-bool ClassType::IsSubClassOf(const ClassType* Class) const
+uint32 ClassType::NumberClass(ClassType* Class, uint32 NextIndex)
 {
-    for (const ClassType* Current = this; Current; Current = Current->GetSuperClass())
+    Class->Index = NextIndex++;
+    for (ClassType* SubClass = Class->FirstSubClass; SubClass; SubClass = SubClass->NextSibling)
     {
-        if (Current == Class)
-        {
-            return true;
-        }
+        NextIndex = NumberClass(SubClass, NextIndex);
     }
 
-    return false;
+    Class->LastSubClassIndex = NextIndex - 1;
+    return NextIndex;
 }
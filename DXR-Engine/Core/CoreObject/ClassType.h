@@ -1,7 +1,16 @@
 #pragma once
 #include "Core.h"
 
-// ClassType stores info about a class, for now inheritance
+/*
+* ClassType stores info about a class, for now inheritance.
+*
+* Every class is numbered in pre-order when it is registered, so that the subclasses of a class are exactly the
+* classes with an index in [Index, LastSubClassIndex], which makes IsSubClassOf two compares instead of a walk up the
+* super classes. Classes are registered the first time GetStaticClass is called, and a new class renumbers all
+* classes. This must therefore not happen at the same time as IsSubClassOf on another thread, which holds as long as
+* the first object of each class is created on the main thread.
+*/
+
 class ClassType
 {
 public:
@@ -12,7 +21,10 @@ public:
 
     ~ClassType() = default;
 
-    bool IsSubClassOf(const ClassType* Class) const;
+    FORCEINLINE bool IsSubClassOf(const ClassType* Class) const
+    {
+        return Index >= Class->Index && Index <= Class->LastSubClassIndex;
+    }
 
     template<typename T>
     FORCEINLINE bool IsSubClassOf() const
@@ -25,8 +37,22 @@ public:
 
     uint32 GetSizeInBytes() const { return SizeInBytes; }
 
+    // Pre-order index among all registered classes
+    uint32 GetIndex() const { return Index; }
+    uint32 GetLastSubClassIndex() const { return LastSubClassIndex; }
+
 private:
+    static void RenumberClasses();
+    static uint32 NumberClass(ClassType* Class, uint32 NextIndex);
+
     const char*      Name;
     const ClassType* SuperClass;
     const uint32     SizeInBytes;
-};
\ No newline at end of file
+
+    // Children of the super class are linked through NextSibling, classes without a super class are roots
+    ClassType* FirstSubClass = nullptr;
+    ClassType* NextSibling   = nullptr;
+
+    uint32 Index             = 0;
+    uint32 LastSubClassIndex = 0;
+};
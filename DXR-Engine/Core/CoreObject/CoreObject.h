@@ -1,6 +1,8 @@
 #pragma once
 #include "ClassType.h"
 
+#include <type_traits>
+
 #define CORE_OBJECT(TCoreObject, TSuperClass) \
 private: \
     typedef TCoreObject This; \
@@ -47,7 +49,16 @@ bool IsSubClassOf(CoreObject* Object)
 {
     Assert(Object != nullptr);
     Assert(Object->GetClass() != nullptr);
-    return Object->GetClass()->IsSubClassOf<T>();
+
+    // A final class has no subclasses, so only the class itself can match
+    if constexpr (std::is_final_v<T>)
+    {
+        return Object->GetClass() == T::GetStaticClass();
+    }
+    else
+    {
+        return Object->GetClass()->IsSubClassOf<T>();
+    }
 }
 
 template<typename T>
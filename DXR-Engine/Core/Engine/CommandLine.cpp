@@ -0,0 +1,48 @@
+#include "CommandLine.h"
+
+#include <cctype>
+
+std::string CommandLine::Arguments;
+
+void CommandLine::Init(const char* InCommandLine)
+{
+    Arguments = InCommandLine ? InCommandLine : "";
+}
+
+bool CommandLine::HasFlag(const char* Flag)
+{
+    const size_t FlagLength = strlen(Flag);
+
+    size_t Position = 0;
+    while (Position < Arguments.size())
+    {
+        while (Position < Arguments.size() && isspace(uint8(Arguments[Position])))
+        {
+            Position++;
+        }
+
+        size_t End = Position;
+        while (End < Arguments.size() && !isspace(uint8(Arguments[End])))
+        {
+            End++;
+        }
+
+        if (End - Position == FlagLength)
+        {
+            bool IsEqual = true;
+            for (size_t Index = 0; Index < FlagLength && IsEqual; Index++)
+            {
+                IsEqual = tolower(uint8(Arguments[Position + Index])) == tolower(uint8(Flag[Index]));
+            }
+
+            if (IsEqual)
+            {
+                return true;
+            }
+        }
+
+        Position = End;
+    }
+
+    return false;
+}
\ No newline at end of file
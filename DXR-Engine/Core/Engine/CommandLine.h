@@ -0,0 +1,22 @@
+#pragma once
+#include "Core.h"
+
+#include <string>
+
+/*
+* Arguments that the engine was started with. Flags are whitespace separated words, like "-nullrhi", and are compared
+* without regard to case.
+*/
+
+class CommandLine
+{
+public:
+    static void Init(const char* InCommandLine);
+
+    static bool HasFlag(const char* Flag);
+
+    static const std::string& Get() { return Arguments; }
+
+private:
+    static std::string Arguments;
+};
\ No newline at end of file
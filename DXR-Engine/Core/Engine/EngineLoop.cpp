@@ -2,6 +2,7 @@
 #include "EngineLoop.h"
 
 #include "Core/Engine/EngineGlobals.h"
+#include "Core/Engine/CommandLine.h"
 #include "Core/Application/Application.h"
 #include "Core/Application/Generic/GenericOutputConsole.h"
 #include "Core/Application/Platform/Platform.h"
@@ -56,8 +57,14 @@ bool EngineLoop::Init()
         return false;
     }
 
-    // RenderAPI
-    if (!RenderLayer::Init(ERenderLayerApi::D3D12))
+    // RenderAPI, -nullrhi runs the renderer without a GPU so that the CPU-side can be benchmarked
+#if ENABLE_NULL_RENDER_LAYER || !defined(PLATFORM_WINDOWS)
+    const ERenderLayerApi RenderApi = ERenderLayerApi::Null;
+#else
+    const ERenderLayerApi RenderApi = CommandLine::HasFlag("-nullrhi") ? ERenderLayerApi::Null : ERenderLayerApi::D3D12;
+#endif
+
+    if (!RenderLayer::Init(RenderApi))
     {
         return false;
     }
@@ -116,6 +123,11 @@ void EngineLoop::Tick(Timestamp Deltatime)
 
     Profiler::Tick();
 
+    // Swap in the textures that finished loading before the scene is rendered
+    TextureFactory::Tick();
+
+    GApplication->Scene->Tick(Deltatime);
+
     GRenderer.Tick(*GApplication->Scene);
 }
 
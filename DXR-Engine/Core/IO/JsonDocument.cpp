@@ -0,0 +1,494 @@
+#include "JsonDocument.h"
+
+#include <charconv>
+#include <cstring>
+
+/*
+* Recursive descent parser. The children of a container are collected on a stack while it is parsed, and copied to the
+* document in one run when it is closed, which is what keeps the children of every value next to each other.
+*/
+
+class JsonParser
+{
+public:
+    JsonParser(const char* Text, uint64 Size, TArray<JsonValue>& InValues)
+        : Cursor(Text)
+        , Start(Text)
+        , End(Text + Size)
+        , Values(InValues)
+    {
+    }
+
+    bool Parse()
+    {
+        JsonValue Root;
+        if (!ParseValue(Root, 0))
+        {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (Cursor != End)
+        {
+            return Fail("Unexpected characters after the root value");
+        }
+
+        Values.PushBack(Root);
+        return true;
+    }
+
+    uint64 GetErrorOffset() const
+    {
+        return uint64(Cursor - Start);
+    }
+
+    const char* GetError() const
+    {
+        return Error;
+    }
+
+private:
+    bool Fail(const char* Message)
+    {
+        Error = Message;
+        return false;
+    }
+
+    void SkipWhitespace()
+    {
+        while (Cursor < End && (*Cursor == ' ' || *Cursor == '\t' || *Cursor == '\n' || *Cursor == '\r'))
+        {
+            Cursor++;
+        }
+    }
+
+    bool Consume(char Character)
+    {
+        SkipWhitespace();
+        if (Cursor < End && *Cursor == Character)
+        {
+            Cursor++;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool ParseLiteral(const char* Literal, uint32 Length)
+    {
+        if (uint64(End - Cursor) < Length || memcmp(Cursor, Literal, Length) != 0)
+        {
+            return Fail("Invalid literal");
+        }
+
+        Cursor += Length;
+        return true;
+    }
+
+    // Cursor is at the opening quote
+    bool ParseString(const char*& OutString, uint32& OutLength)
+    {
+        Cursor++;
+
+        const char* StringStart = Cursor;
+        while (Cursor < End && *Cursor != '"')
+        {
+            if (uint8(*Cursor) < 0x20)
+            {
+                return Fail("Control character in string");
+            }
+
+            // The escape sequence is validated when the string is read
+            Cursor += (*Cursor == '\\') ? 2 : 1;
+        }
+
+        if (Cursor >= End)
+        {
+            return Fail("Unterminated string");
+        }
+
+        OutString = StringStart;
+        OutLength = uint32(Cursor - StringStart);
+        Cursor++;
+        return true;
+    }
+
+    bool ParseNumber(double& OutNumber)
+    {
+        const char* NumberStart = Cursor;
+        while (Cursor < End && (strchr("+-.eE", *Cursor) != nullptr || (*Cursor >= '0' && *Cursor <= '9')))
+        {
+            Cursor++;
+        }
+
+        // Unlike strtod, from_chars does not depend on the locale, which could expect a comma as the decimal separator.
+        // It also reads the text in place, since it does not need a null terminator.
+        const std::from_chars_result Result = std::from_chars(NumberStart, Cursor, OutNumber);
+        if (Result.ec == std::errc::result_out_of_range)
+        {
+            return Fail("Number out of range");
+        }
+
+        if (Result.ec != std::errc() || Result.ptr != Cursor)
+        {
+            return Fail("Invalid number");
+        }
+
+        return true;
+    }
+
+    bool ParseValue(JsonValue& OutValue, uint32 Depth)
+    {
+        SkipWhitespace();
+        if (Cursor >= End)
+        {
+            return Fail("Unexpected end of text");
+        }
+
+        const char Character = *Cursor;
+        if (Character == '{' || Character == '[')
+        {
+            return ParseContainer(OutValue, Depth);
+        }
+        else if (Character == '"')
+        {
+            OutValue.Type = EJsonType::String;
+            return ParseString(OutValue.String, OutValue.StringLength);
+        }
+        else if (Character == 't')
+        {
+            OutValue.Type = EJsonType::Bool;
+            OutValue.Bool = true;
+            return ParseLiteral("true", 4);
+        }
+        else if (Character == 'f')
+        {
+            OutValue.Type = EJsonType::Bool;
+            OutValue.Bool = false;
+            return ParseLiteral("false", 5);
+        }
+        else if (Character == 'n')
+        {
+            OutValue.Type = EJsonType::Null;
+            return ParseLiteral("null", 4);
+        }
+        else if (Character == '-' || (Character >= '0' && Character <= '9'))
+        {
+            OutValue.Type = EJsonType::Number;
+            return ParseNumber(OutValue.Number);
+        }
+
+        return Fail("Unexpected character");
+    }
+
+    // Cursor is at the opening bracket
+    bool ParseContainer(JsonValue& OutValue, uint32 Depth)
+    {
+        if (Depth >= JSON_MAX_DEPTH)
+        {
+            return Fail("Nesting is too deep");
+        }
+
+        const bool  IsObject     = (*Cursor == '{');
+        const char  CloseBracket = IsObject ? '}' : ']';
+        const uint32 StackStart  = Stack.Size();
+        Cursor++;
+
+        if (!Consume(CloseBracket))
+        {
+            do
+            {
+                JsonValue Child;
+                if (IsObject)
+                {
+                    SkipWhitespace();
+                    if (Cursor >= End || *Cursor != '"')
+                    {
+                        return Fail("Expected a key");
+                    }
+
+                    if (!ParseString(Child.Key, Child.KeyLength))
+                    {
+                        return false;
+                    }
+
+                    if (!Consume(':'))
+                    {
+                        return Fail("Expected ':'");
+                    }
+                }
+
+                if (!ParseValue(Child, Depth + 1))
+                {
+                    return false;
+                }
+
+                Stack.PushBack(Child);
+            } while (Consume(','));
+
+            if (!Consume(CloseBracket))
+            {
+                return Fail(IsObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+            }
+        }
+
+        OutValue.Type        = IsObject ? EJsonType::Object : EJsonType::Array;
+        OutValue.FirstChild  = Values.Size();
+        OutValue.NumChildren = Stack.Size() - StackStart;
+        for (uint32 Index = StackStart; Index < Stack.Size(); Index++)
+        {
+            Values.PushBack(Stack[Index]);
+        }
+
+        Stack.Resize(StackStart);
+        return true;
+    }
+
+    const char* Cursor;
+    const char* Start;
+    const char* End;
+
+    TArray<JsonValue>& Values;
+    TArray<JsonValue>  Stack;
+
+    const char* Error = "";
+};
+
+bool JsonDocument::Parse(const char* Text, uint64 Size)
+{
+    Values.Clear();
+
+    JsonParser Parser(Text, Size, Values);
+    if (!Parser.Parse())
+    {
+        LOG_ERROR("[JsonDocument]: " + std::string(Parser.GetError()) + " at offset " + std::to_string(Parser.GetErrorOffset()));
+        Values.Clear();
+        return false;
+    }
+
+    return true;
+}
+
+const JsonValue* JsonDocument::Find(const JsonValue& Object, const char* Key) const
+{
+    if (Object.Type != EJsonType::Object)
+    {
+        return nullptr;
+    }
+
+    // Keys with escape sequences are compared as they are written, which is fine for the names that are looked up
+    const size_t KeyLength = strlen(Key);
+    for (uint32 Index = 0; Index < Object.NumChildren; Index++)
+    {
+        const JsonValue& Member = Values[Object.FirstChild + Index];
+        if (Member.KeyLength == KeyLength && memcmp(Member.Key, Key, KeyLength) == 0)
+        {
+            return &Member;
+        }
+    }
+
+    return nullptr;
+}
+
+const JsonValue* JsonDocument::FindObject(const JsonValue& Object, const char* Key) const
+{
+    const JsonValue* Member = Find(Object, Key);
+    return (Member && Member->Type == EJsonType::Object) ? Member : nullptr;
+}
+
+const JsonValue* JsonDocument::FindArray(const JsonValue& Object, const char* Key) const
+{
+    const JsonValue* Member = Find(Object, Key);
+    return (Member && Member->Type == EJsonType::Array) ? Member : nullptr;
+}
+
+double JsonDocument::GetNumber(const JsonValue& Object, const char* Key, double Default) const
+{
+    const JsonValue* Member = Find(Object, Key);
+    return (Member && Member->Type == EJsonType::Number) ? Member->Number : Default;
+}
+
+int64 JsonDocument::GetInteger(const JsonValue& Object, const char* Key, int64 Default) const
+{
+    const JsonValue* Member = Find(Object, Key);
+    if (!Member || Member->Type != EJsonType::Number)
+    {
+        return Default;
+    }
+
+    // Numbers that do not fit or are not whole are not valid indices or sizes
+    const double Number = Member->Number;
+    if (Number < -9.0e15 || Number > 9.0e15 || Number != double(int64(Number)))
+    {
+        return Default;
+    }
+
+    return int64(Number);
+}
+
+bool JsonDocument::GetBool(const JsonValue& Object, const char* Key, bool Default) const
+{
+    const JsonValue* Member = Find(Object, Key);
+    return (Member && Member->Type == EJsonType::Bool) ? Member->Bool : Default;
+}
+
+std::string JsonDocument::GetString(const JsonValue& Object, const char* Key, const std::string& Default) const
+{
+    const JsonValue* Member = Find(Object, Key);
+    return (Member && Member->Type == EJsonType::String) ? GetString(*Member) : Default;
+}
+
+bool JsonDocument::GetNumbers(const JsonValue& Object, const char* Key, float* OutNumbers, uint32 Count) const
+{
+    const JsonValue* Member = FindArray(Object, Key);
+    if (!Member || Member->NumChildren != Count)
+    {
+        return false;
+    }
+
+    for (uint32 Index = 0; Index < Count; Index++)
+    {
+        if (Values[Member->FirstChild + Index].Type != EJsonType::Number)
+        {
+            return false;
+        }
+    }
+
+    for (uint32 Index = 0; Index < Count; Index++)
+    {
+        OutNumbers[Index] = float(Values[Member->FirstChild + Index].Number);
+    }
+
+    return true;
+}
+
+static int32 ParseHexDigit(char Character)
+{
+    if (Character >= '0' && Character <= '9')
+    {
+        return Character - '0';
+    }
+    else if (Character >= 'a' && Character <= 'f')
+    {
+        return Character - 'a' + 10;
+    }
+    else if (Character >= 'A' && Character <= 'F')
+    {
+        return Character - 'A' + 10;
+    }
+
+    return -1;
+}
+
+// Returns -1 if there are not four hex digits
+static int32 ParseCodeUnit(const char* String, uint32 Remaining)
+{
+    if (Remaining < 4)
+    {
+        return -1;
+    }
+
+    int32 CodeUnit = 0;
+    for (uint32 Index = 0; Index < 4; Index++)
+    {
+        const int32 Digit = ParseHexDigit(String[Index]);
+        if (Digit < 0)
+        {
+            return -1;
+        }
+
+        CodeUnit = (CodeUnit << 4) | Digit;
+    }
+
+    return CodeUnit;
+}
+
+static void AppendUTF8(std::string& OutString, uint32 CodePoint)
+{
+    if (CodePoint < 0x80)
+    {
+        OutString += char(CodePoint);
+    }
+    else if (CodePoint < 0x800)
+    {
+        OutString += char(0xC0 | (CodePoint >> 6));
+        OutString += char(0x80 | (CodePoint & 0x3F));
+    }
+    else if (CodePoint < 0x10000)
+    {
+        OutString += char(0xE0 | (CodePoint >> 12));
+        OutString += char(0x80 | ((CodePoint >> 6) & 0x3F));
+        OutString += char(0x80 | (CodePoint & 0x3F));
+    }
+    else
+    {
+        OutString += char(0xF0 | (CodePoint >> 18));
+        OutString += char(0x80 | ((CodePoint >> 12) & 0x3F));
+        OutString += char(0x80 | ((CodePoint >> 6) & 0x3F));
+        OutString += char(0x80 | (CodePoint & 0x3F));
+    }
+}
+
+std::string JsonDocument::GetString(const JsonValue& Value)
+{
+    std::string Result;
+    if (Value.Type != EJsonType::String)
+    {
+        return Result;
+    }
+
+    const char*  String = Value.String;
+    const uint32 Length = Value.StringLength;
+    Result.reserve(Length);
+
+    // Invalid escape sequences are kept as they are written
+    for (uint32 Index = 0; Index < Length; Index++)
+    {
+        if (String[Index] != '\\' || Index + 1 >= Length)
+        {
+            Result += String[Index];
+            continue;
+        }
+
+        const char Escaped = String[++Index];
+        switch (Escaped)
+        {
+        case 'b': Result += '\b'; break;
+        case 'f': Result += '\f'; break;
+        case 'n': Result += '\n'; break;
+        case 'r': Result += '\r'; break;
+        case 't': Result += '\t'; break;
+        case 'u':
+        {
+            int32 CodePoint = ParseCodeUnit(String + Index + 1, Length - Index - 1);
+            if (CodePoint < 0)
+            {
+                Result += "\\u";
+                break;
+            }
+
+            Index += 4;
+
+            // Characters outside of the basic plane are written as a pair of surrogates
+            if (CodePoint >= 0xD800 && CodePoint < 0xDC00 && Index + 2 < Length && String[Index + 1] == '\\' && String[Index + 2] == 'u')
+            {
+                const int32 LowSurrogate = ParseCodeUnit(String + Index + 3, Length - Index - 3);
+                if (LowSurrogate >= 0xDC00 && LowSurrogate < 0xE000)
+                {
+                    CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+                    Index += 6;
+                }
+            }
+
+            AppendUTF8(Result, uint32(CodePoint));
+            break;
+        }
+        default:
+            // Covers \", \\ and \/
+            Result += Escaped;
+            break;
+        }
+    }
+
+    return Result;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "Core.h"
+
+#include "Core/Containers/Array.h"
+
+#include <string>
+
+// Objects and arrays deeper than this are rejected, so that a damaged file can not overflow the stack
+constexpr uint32 JSON_MAX_DEPTH = 256;
+
+enum class EJsonType : uint8
+{
+    Null   = 0,
+    Bool   = 1,
+    Number = 2,
+    String = 3,
+    Array  = 4,
+    Object = 5,
+};
+
+struct JsonValue
+{
+    EJsonType Type = EJsonType::Null;
+    bool      Bool = false;
+
+    double Number = 0.0;
+
+    // Points into the text without the quotes, escape sequences are only resolved by JsonDocument::GetString
+    const char* String       = nullptr;
+    uint32      StringLength = 0;
+
+    // Name of the value when it is a member of an object, stored in the same way as String
+    const char* Key       = nullptr;
+    uint32      KeyLength = 0;
+
+    // The elements of an array or the members of an object are the values [FirstChild, FirstChild + NumChildren)
+    uint32 FirstChild  = 0;
+    uint32 NumChildren = 0;
+};
+
+/*
+* JSON parser that does not copy the text, which has to outlive the document. All values are stored in one array, and
+* the children of an array or object are next to each other, so an element is found by index without following links.
+* Lookups that do not find a member or find one with another type return the default that the caller passes.
+*/
+
+class JsonDocument
+{
+public:
+    JsonDocument()  = default;
+    ~JsonDocument() = default;
+
+    // Returns false and logs where the error is when the text is not valid JSON
+    bool Parse(const char* Text, uint64 Size);
+
+    const JsonValue& GetRoot() const
+    {
+        Assert(!Values.IsEmpty());
+        return Values.Back();
+    }
+
+    const JsonValue& GetChild(const JsonValue& Parent, uint32 Index) const
+    {
+        Assert(Index < Parent.NumChildren);
+        return Values[Parent.FirstChild + Index];
+    }
+
+    // Returns nullptr if Object is not an object or does not have the member
+    const JsonValue* Find(const JsonValue& Object, const char* Key) const;
+
+    // Returns nullptr if the member is not an object or an array
+    const JsonValue* FindObject(const JsonValue& Object, const char* Key) const;
+    const JsonValue* FindArray(const JsonValue& Object, const char* Key) const;
+
+    double      GetNumber(const JsonValue& Object, const char* Key, double Default) const;
+    int64       GetInteger(const JsonValue& Object, const char* Key, int64 Default) const;
+    bool        GetBool(const JsonValue& Object, const char* Key, bool Default) const;
+    std::string GetString(const JsonValue& Object, const char* Key, const std::string& Default) const;
+
+    // Reads up to Count numbers from an array member, returns false and leaves OutNumbers as it is if the member is
+    // not an array of exactly Count numbers
+    bool GetNumbers(const JsonValue& Object, const char* Key, float* OutNumbers, uint32 Count) const;
+
+    // Resolves the escape sequences, where \u is converted to UTF-8
+    static std::string GetString(const JsonValue& Value);
+
+private:
+    TArray<JsonValue> Values;
+};
@@ -0,0 +1,6 @@
+#pragma once
+#ifdef PLATFORM_WINDOWS
+    #include "Core/IO/Windows/WindowsMappedFile.h"
+#else
+    #error No Platform Defined
+#endif
@@ -0,0 +1,90 @@
+#pragma once
+#include "Windows/Windows.h"
+
+#include <string>
+
+// Maps a whole file read only into the address space, the pages are read from disk when they are first touched
+class WindowsMappedFile
+{
+public:
+    WindowsMappedFile() = default;
+
+    ~WindowsMappedFile()
+    {
+        Close();
+    }
+
+    WindowsMappedFile(const WindowsMappedFile&)            = delete;
+    WindowsMappedFile& operator=(const WindowsMappedFile&) = delete;
+
+    bool Open(const std::string& Filename) noexcept
+    {
+        Close();
+
+        File = CreateFileA(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (File == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER FileSize;
+        if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart == 0)
+        {
+            Close();
+            return false;
+        }
+
+        Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!Mapping)
+        {
+            Close();
+            return false;
+        }
+
+        Data = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!Data)
+        {
+            Close();
+            return false;
+        }
+
+        Size = uint64(FileSize.QuadPart);
+        return true;
+    }
+
+    void Close() noexcept
+    {
+        if (Data)
+        {
+            UnmapViewOfFile(Data);
+            Data = nullptr;
+        }
+
+        if (Mapping)
+        {
+            CloseHandle(Mapping);
+            Mapping = nullptr;
+        }
+
+        if (File != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(File);
+            File = INVALID_HANDLE_VALUE;
+        }
+
+        Size = 0;
+    }
+
+    bool IsOpen() const { return Data != nullptr; }
+
+    const void* GetData() const { return Data; }
+    uint64 GetSize() const { return Size; }
+
+private:
+    HANDLE File    = INVALID_HANDLE_VALUE;
+    HANDLE Mapping = nullptr;
+    void*  Data    = nullptr;
+    uint64 Size    = 0;
+};
+
+typedef WindowsMappedFile MappedFile;
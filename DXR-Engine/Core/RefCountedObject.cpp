@@ -1,5 +1,7 @@
 #include "RefCountedObject.h"
 
+#include "Core/Threading/Platform/PlatformAtomic.h"
+
 RefCountedObject::RefCountedObject()
     : StrongReferences(0)
 {
@@ -8,16 +10,16 @@ RefCountedObject::RefCountedObject()
 
 uint32 RefCountedObject::AddRef()
 {
-    return ++StrongReferences;
+    return uint32(PlatformAtomic::InterlockedIncrement(&StrongReferences));
 }
 
 uint32 RefCountedObject::Release()
 {
-    uint32 NewRefCount = --StrongReferences;
-    if (StrongReferences <= 0)
+    const int32 NewRefCount = PlatformAtomic::InterlockedDecrement(&StrongReferences);
+    if (NewRefCount <= 0)
     {
         delete this;
     }
 
-    return NewRefCount;
+    return uint32(NewRefCount);
 }
@@ -7,11 +7,12 @@ public:
     RefCountedObject();
     virtual ~RefCountedObject() = default;
 
+    // AddRef and Release are atomic so that resources can be referenced from CommandLists recorded on worker threads
     uint32 AddRef();
     uint32 Release();
 
-    uint32 GetRefCount() const { return StrongReferences; }
+    uint32 GetRefCount() const { return uint32(StrongReferences); }
 
 private:
-    uint32 StrongReferences;
+    volatile int32 StrongReferences;
 };
\ No newline at end of file
@@ -36,8 +36,15 @@ bool TaskManager::PopTask(Task& OutTask)
     }
 }
 
+bool TaskManager::HasPendingTasks()
+{
+    TScopedLock<Mutex> Lock(TaskMutex);
+    return !Tasks.IsEmpty();
+}
+
 void TaskManager::KillWorkers()
 {
+    TScopedLock<Mutex> Lock(WakeMutex);
     IsRunning = false;
 
     WakeCondition.NotifyAll();
@@ -53,8 +60,13 @@ void TaskManager::WorkThread()
 
         if (!Instance.PopTask(CurrentTask))
         {
+            // Tasks are added while holding WakeMutex, so a task that was added after PopTask failed is either seen
+            // here or notifies after the wait has started
             TScopedLock<Mutex> Lock(Instance.WakeMutex);
-            Instance.WakeCondition.Wait(Lock);
+            while (Instance.IsRunning && !Instance.HasPendingTasks())
+            {
+                Instance.WakeCondition.Wait(Lock);
+            }
         }
         else
         {
@@ -97,24 +109,43 @@ bool TaskManager::Init()
 
 TaskID TaskManager::AddTask(const Task& NewTask)
 {
+    TScopedLock<Mutex> WakeLock(WakeMutex);
+
     {
         TScopedLock<Mutex> Lock(TaskMutex);
         Tasks.EmplaceBack(NewTask);
     }
 
-    ThreadID NewTaskID = TaskAdded.Increment();
+    TaskID NewTaskID = TaskAdded.Increment();
 
     WakeCondition.NotifyOne();
 
     return NewTaskID;
 }
 
+bool TaskManager::ExecuteTask()
+{
+    Task CurrentTask;
+    if (!PopTask(CurrentTask))
+    {
+        return false;
+    }
+
+    CurrentTask.Delegate();
+    TaskCompleted++;
+
+    return true;
+}
+
 void TaskManager::WaitForTask(TaskID Task)
 {
     while (TaskCompleted.Load() < Task)
     {
-        // Look into proper yeild
-        PlatformProcess::Sleep(0);
+        if (!ExecuteTask())
+        {
+            // Look into proper yeild
+            PlatformProcess::Sleep(0);
+        }
     }
 }
 
@@ -122,8 +153,11 @@ void TaskManager::WaitForAllTasks()
 {
     while (TaskCompleted.Load() < TaskAdded.Load())
     {
-        // Look into proper yeild
-        PlatformProcess::Sleep(0);
+        if (!ExecuteTask())
+        {
+            // Look into proper yeild
+            PlatformProcess::Sleep(0);
+        }
     }
 }
 
@@ -22,11 +22,18 @@ public:
 
     TaskID AddTask(const Task& NewTask);
 
+    // Executes the oldest task that no worker has started on the calling thread, returns false if there was none.
+    // Threads that wait for tasks call this, so that they never wait on a task that is still in the queue.
+    bool ExecuteTask();
+
     void WaitForTask(TaskID Task);
     void WaitForAllTasks();
 
     void Release();
 
+    // Zero before Init has been called, tasks that are added are not executed until there are workers
+    uint32 GetNumWorkers() const { return WorkThreads.Size(); }
+
     static TaskManager& Get();
 
 private:
@@ -34,6 +41,7 @@ private:
     ~TaskManager();
 
     bool PopTask(Task& OutTask);
+    bool HasPendingTasks();
 
     void KillWorkers();
 
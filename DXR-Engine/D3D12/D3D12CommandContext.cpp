@@ -14,45 +14,86 @@
 
 #include <pix.h>
 
-void D3D12ResourceBarrierBatcher::AddTransitionBarrier(ID3D12Resource* Resource, D3D12_RESOURCE_STATES BeforeState, D3D12_RESOURCE_STATES AfterState)
+void D3D12ResourceBarrierBatcher::AddTransitionBarrier(ID3D12Resource* Resource, D3D12_RESOURCE_STATES BeforeState, D3D12_RESOURCE_STATES AfterState, uint32 Subresource)
 {
     Assert(Resource != nullptr);
 
-    if (BeforeState != AfterState)
+    if (BeforeState == AfterState)
     {
-        // Make sure we are not already have transition for this resource
-        for (TArray<D3D12_RESOURCE_BARRIER>::Iterator It = Barriers.Begin(); It != Barriers.End(); It++)
+        return;
+    }
+
+    const D3D12BarrierKey Key = { Resource, Subresource };
+
+    auto PendingTransition = PendingTransitions.find(Key);
+    if (PendingTransition != PendingTransitions.end())
+    {
+        const uint32 Index = PendingTransition->second;
+
+        auto LastBarrier = LastBarriers.find(Resource);
+        if (LastBarrier != LastBarriers.end() && LastBarrier->second == Index)
         {
-            if ((*It).Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+            D3D12_RESOURCE_BARRIER& Barrier = Barriers[Index];
+            if (Barrier.Transition.StateBefore == AfterState)
             {
-                if ((*It).Transition.pResource == Resource)
-                {
-                    if ((*It).Transition.StateBefore == AfterState)
-                    {
-                        It = Barriers.Erase(It);
-                    }
-                    else
-                    {
-                        (*It).Transition.StateAfter = AfterState;
-                    }
-
-                    return;
-                }
+                // The resource is transitioned back into the state it was in, remove the barrier
+                Barrier.Transition.pResource = nullptr;
+                NumRemovedBarriers++;
+
+                PendingTransitions.erase(PendingTransition);
+                LastBarriers.erase(LastBarrier);
+            }
+            else
+            {
+                Barrier.Transition.StateAfter = AfterState;
             }
+
+            return;
         }
+    }
+
+    D3D12_RESOURCE_BARRIER Barrier;
+    Memory::Memzero(&Barrier);
 
-        // Add new resource barrier
-        D3D12_RESOURCE_BARRIER Barrier;
-        Memory::Memzero(&Barrier);
+    Barrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    Barrier.Transition.pResource   = Resource;
+    Barrier.Transition.StateAfter  = AfterState;
+    Barrier.Transition.StateBefore = BeforeState;
+    Barrier.Transition.Subresource = Subresource;
 
-        Barrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        Barrier.Transition.pResource   = Resource;
-        Barrier.Transition.StateAfter  = AfterState;
-        Barrier.Transition.StateBefore = BeforeState;
-        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    const uint32 Index = Barriers.Size();
+    PendingTransitions[Key] = Index;
+    LastBarriers[Resource]  = Index;
 
-        Barriers.EmplaceBack(Barrier);
+    Barriers.EmplaceBack(Barrier);
+}
+
+void D3D12ResourceBarrierBatcher::FlushBarriers(D3D12CommandListHandle& CmdList)
+{
+    if (NumRemovedBarriers > 0)
+    {
+        uint32 NumBarriers = 0;
+        for (const D3D12_RESOURCE_BARRIER& Barrier : Barriers)
+        {
+            const bool IsRemoved = (Barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION) && (Barrier.Transition.pResource == nullptr);
+            if (!IsRemoved)
+            {
+                Barriers[NumBarriers++] = Barrier;
+            }
+        }
+
+        Barriers.Resize(NumBarriers);
+        NumRemovedBarriers = 0;
+    }
+
+    if (!Barriers.IsEmpty())
+    {
+        CmdList.ResourceBarrier(Barriers.Data(), Barriers.Size());
+        Barriers.Clear();
     }
+
+    PendingTransitions.clear();
+    LastBarriers.clear();
 }
 
 D3D12GPUResourceUploader::D3D12GPUResourceUploader(D3D12Device* InDevice)
@@ -780,19 +821,27 @@ void D3D12CommandContext::UpdateTexture2D(Texture2D* Destination, uint32 Width,
 
         D3D12BaseTexture* DxDestination = D3D12TextureCast(Destination);
         const DXGI_FORMAT NativeFormat  = DxDestination->GetNativeFormat();
-        const uint32 Stride      = GetFormatStride(NativeFormat);
-        const uint32 RowPitch    = ((Width * Stride) + (D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1u)) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1u);
-        const uint32 SizeInBytes = Height * RowPitch;
+
+        // Rows are rows of blocks for block compressed formats
+        const EFormat Format         = Destination->GetFormat();
+        const uint32 SourceRowPitch  = GetRowPitchFromFormat(Format, Width);
+        const uint32 NumRows         = GetNumRowsFromFormat(Format, Height);
+        const uint32 RowPitch        = (SourceRowPitch + (D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1u)) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1u);
+        const uint32 SizeInBytes     = NumRows * RowPitch;
     
         D3D12GPUResourceUploader& GpuResourceUploader = CmdBatch->GetGpuResourceUploader();
         D3D12UploadAllocation Allocation = GpuResourceUploader.LinearAllocate(SizeInBytes);
 
         const uint8* Source = reinterpret_cast<const uint8*>(SourceData);
-        for (uint32 y = 0; y < Height; y++)
+        for (uint32 y = 0; y < NumRows; y++)
         {
-            Memory::Memcpy(Allocation.MappedPtr + (y * RowPitch), Source + (y * Width * Stride), Width * Stride);
+            Memory::Memcpy(Allocation.MappedPtr + (y * RowPitch), Source + (y * SourceRowPitch), SourceRowPitch);
         }
 
+        // The footprint of a block compressed mip covers whole blocks, even when the mip is smaller than a block
+        const uint32 FootprintWidth  = IsBlockCompressed(Format) ? Math::AlignUp<uint32>(Width, 4) : Width;
+        const uint32 FootprintHeight = IsBlockCompressed(Format) ? Math::AlignUp<uint32>(Height, 4) : Height;
+
         // Copy to Dest
         D3D12_TEXTURE_COPY_LOCATION SourceLocation;
         Memory::Memzero(&SourceLocation);
@@ -800,8 +849,8 @@ void D3D12CommandContext::UpdateTexture2D(Texture2D* Destination, uint32 Width,
         SourceLocation.pResource                          = GpuResourceUploader.GetGpuResource();
         SourceLocation.Type                               = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
         SourceLocation.PlacedFootprint.Footprint.Format   = NativeFormat;
-        SourceLocation.PlacedFootprint.Footprint.Width    = Width;
-        SourceLocation.PlacedFootprint.Footprint.Height   = Height;
+        SourceLocation.PlacedFootprint.Footprint.Width    = FootprintWidth;
+        SourceLocation.PlacedFootprint.Footprint.Height   = FootprintHeight;
         SourceLocation.PlacedFootprint.Footprint.Depth    = 1;
         SourceLocation.PlacedFootprint.Footprint.RowPitch = RowPitch;
         SourceLocation.PlacedFootprint.Offset             = Allocation.ResourceOffset;
@@ -1023,6 +1072,9 @@ void D3D12CommandContext::GenerateMips(Texture* Texture)
     
     Assert(Desc.MipLevels > 1);
 
+    // The mips are generated with copies, which requires the texture to be in the CopyDest state
+    TransitionTexture(Texture, EResourceState::CopyDest, ALL_SUBRESOURCES);
+
     // TODO: Create this placed from a Heap? See what performance is 
     TRef<D3D12Resource> StagingTexture = DBG_NEW D3D12Resource(GetDevice(), Desc, DxTexture->GetResource()->GetHeapType());
     if (!StagingTexture->Init(D3D12_RESOURCE_STATE_COMMON, nullptr))
@@ -1201,25 +1253,59 @@ void D3D12CommandContext::GenerateMips(Texture* Texture)
     CmdBatch->AddInUseResource(StagingTexture.Get());
 }
 
-void D3D12CommandContext::TransitionTexture(Texture* Texture, EResourceState BeforeState, EResourceState AfterState)
+void D3D12CommandContext::TransitionTexture(Texture* Texture, EResourceState AfterState, uint32 Subresource)
 {
-    const D3D12_RESOURCE_STATES DxBeforeState = ConvertResourceState(BeforeState);
-    const D3D12_RESOURCE_STATES DxAfterState  = ConvertResourceState(AfterState);
+    Assert(Texture != nullptr);
 
-    D3D12BaseTexture* Resource = D3D12TextureCast(Texture);
-    TransitionResource(Resource->GetResource(), DxBeforeState, DxAfterState);
+    D3D12BaseTexture* DxTexture = D3D12TextureCast(Texture);
+    D3D12Resource*    Resource  = DxTexture->GetResource();
+
+    ResourceStateTracker& StateTracker = Texture->GetStateTracker();
+
+    const D3D12_RESOURCE_STATES DxAfterState = ConvertResourceState(AfterState);
+    if (Subresource == ALL_SUBRESOURCES && StateTracker.IsUniform())
+    {
+        const D3D12_RESOURCE_STATES DxBeforeState = ConvertResourceState(StateTracker.GetState());
+        TransitionResource(Resource, DxBeforeState, DxAfterState, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    }
+    else if (Subresource == ALL_SUBRESOURCES)
+    {
+        // The subresources are in different states, so each one needs its own barrier
+        const uint32 NumSubresources = StateTracker.GetNumTrackedSubresources();
+        for (uint32 Index = 0; Index < NumSubresources; Index++)
+        {
+            const D3D12_RESOURCE_STATES DxBeforeState = ConvertResourceState(StateTracker.GetSubresourceState(Index));
+            TransitionResource(Resource, DxBeforeState, DxAfterState, Index);
+        }
+    }
+    else
+    {
+        const D3D12_RESOURCE_STATES DxBeforeState = ConvertResourceState(StateTracker.GetSubresourceState(Subresource));
+        TransitionResource(Resource, DxBeforeState, DxAfterState, Subresource);
+    }
+
+    const D3D12_RESOURCE_DESC& Desc = Resource->GetDesc();
+    const uint32 NumArraySlices  = (Desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D) ? 1 : Desc.DepthOrArraySize;
+    const uint32 NumSubresources = Desc.MipLevels * NumArraySlices;
+    StateTracker.SetSubresourceState(Subresource, AfterState, NumSubresources);
 
     CmdBatch->AddInUseResource(Texture);
 }
 
-void D3D12CommandContext::TransitionBuffer(Buffer* Buffer, EResourceState BeforeState, EResourceState AfterState)
+void D3D12CommandContext::TransitionBuffer(Buffer* Buffer, EResourceState AfterState)
 {
-    const D3D12_RESOURCE_STATES DxBeforeState = ConvertResourceState(BeforeState);
+    Assert(Buffer != nullptr);
+
+    ResourceStateTracker& StateTracker = Buffer->GetStateTracker();
+
+    const D3D12_RESOURCE_STATES DxBeforeState = ConvertResourceState(StateTracker.GetState());
     const D3D12_RESOURCE_STATES DxAfterState  = ConvertResourceState(AfterState);
     
     D3D12BaseBuffer* Resource = D3D12BufferCast(Buffer);
     TransitionResource(Resource->GetResource(), DxBeforeState, DxAfterState);
 
+    StateTracker.SetState(AfterState);
+
     CmdBatch->AddInUseResource(Buffer);
 }
 
@@ -17,6 +17,10 @@
 #include "D3D12DescriptorCache.h"
 #include "D3D12GPUProfiler.h"
 
+#include "Utilities/HashUtilities.h"
+
+#include <unordered_map>
+
 struct D3D12UploadAllocation
 {
     uint8*  MappedPtr      = nullptr;
@@ -141,13 +145,40 @@ public:
     TArray<TComPtr<ID3D12Resource>> NativeResources;
 };
 
+struct D3D12BarrierKey
+{
+    bool operator==(const D3D12BarrierKey& Other) const
+    {
+        return Resource == Other.Resource && Subresource == Other.Subresource;
+    }
+
+    ID3D12Resource* Resource;
+    uint32 Subresource;
+};
+
+struct D3D12BarrierKeyHasher
+{
+    size_t operator()(const D3D12BarrierKey& Key) const
+    {
+        size_t Hash = std::hash<ID3D12Resource*>()(Key.Resource);
+        HashCombine<uint32>(Hash, Key.Subresource);
+        return Hash;
+    }
+};
+
+/*
+* Collects barriers until the next draw, dispatch or copy. A transition of a resource that already has a pending
+* transition is merged into the pending one, and if the resource is transitioned back into the state it was in before
+* the pending transition both are removed. The pending transitions are found with a hash-lookup.
+*/
+
 class D3D12ResourceBarrierBatcher
 {
 public:
     D3D12ResourceBarrierBatcher()  = default;
     ~D3D12ResourceBarrierBatcher() = default;
 
-    void AddTransitionBarrier(ID3D12Resource* Resource, D3D12_RESOURCE_STATES BeforeState, D3D12_RESOURCE_STATES AfterState);
+    void AddTransitionBarrier(ID3D12Resource* Resource, D3D12_RESOURCE_STATES BeforeState, D3D12_RESOURCE_STATES AfterState, uint32 Subresource);
 
     void AddUnorderedAccessBarrier(ID3D12Resource* Resource)
     {
@@ -159,30 +190,29 @@ public:
         Barrier.Type          = D3D12_RESOURCE_BARRIER_TYPE_UAV;
         Barrier.UAV.pResource = Resource;
 
+        LastBarriers[Resource] = Barriers.Size();
         Barriers.EmplaceBack(Barrier);
     }
 
-    void FlushBarriers(D3D12CommandListHandle& CmdList)
-    {
-        if (!Barriers.IsEmpty())
-        {
-            CmdList.ResourceBarrier(Barriers.Data(), Barriers.Size());
-            Barriers.Clear();
-        }
-    }
-
-    FORCEINLINE const D3D12_RESOURCE_BARRIER* GetBarriers() const
-    {
-        return Barriers.Data();
-    }
+    void FlushBarriers(D3D12CommandListHandle& CmdList);
 
-    FORCEINLINE uint32 GetNumBarriers() const
+    FORCEINLINE uint32 GetNumPendingBarriers() const
     {
-        return Barriers.Size();
+        return Barriers.Size() - NumRemovedBarriers;
     }
 
 private:
     TArray<D3D12_RESOURCE_BARRIER> Barriers;
+
+    // Index of the pending transition for each subresource
+    std::unordered_map<D3D12BarrierKey, uint32, D3D12BarrierKeyHasher> PendingTransitions;
+
+    // Index of the last pending barrier of any type for each resource, transitions are only merged when no other
+    // barrier for the same resource was added after it, otherwise the order of the barriers would change
+    std::unordered_map<ID3D12Resource*, uint32> LastBarriers;
+
+    // Removed barriers are kept as barriers with a nullptr resource until the next flush
+    uint32 NumRemovedBarriers = 0;
 };
 
 class D3D12CommandContext : public ICommandContext, public D3D12DeviceChild
@@ -209,9 +239,13 @@ public:
         BarrierBatcher.AddUnorderedAccessBarrier(Resource->GetResource());
     }
 
-    void TransitionResource(D3D12Resource* Resource, D3D12_RESOURCE_STATES BeforeState, D3D12_RESOURCE_STATES AfterState)
+    void TransitionResource(
+        D3D12Resource* Resource, 
+        D3D12_RESOURCE_STATES BeforeState, 
+        D3D12_RESOURCE_STATES AfterState, 
+        uint32 Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
     {
-        BarrierBatcher.AddTransitionBarrier(Resource->GetResource(), BeforeState, AfterState);
+        BarrierBatcher.AddTransitionBarrier(Resource->GetResource(), BeforeState, AfterState, Subresource);
     }
 
     void FlushResourceBarriers()
@@ -294,8 +328,8 @@ public:
 
     virtual void GenerateMips(Texture* Texture) override final;
 
-    virtual void TransitionTexture(Texture* Texture, EResourceState BeforeState, EResourceState AfterState) override final;
-    virtual void TransitionBuffer(Buffer* Buffer, EResourceState BeforeState, EResourceState AfterState) override final;
+    virtual void TransitionTexture(Texture* Texture, EResourceState AfterState, uint32 Subresource) override final;
+    virtual void TransitionBuffer(Buffer* Buffer, EResourceState AfterState) override final;
 
     virtual void UnorderedAccessTextureBarrier(Texture* Texture) override final;
     virtual void UnorderedAccessBufferBarrier(Buffer* Buffer) override final;
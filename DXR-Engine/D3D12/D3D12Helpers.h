@@ -146,6 +146,18 @@ inline DXGI_FORMAT ConvertFormat(EFormat Format)
     case EFormat::R8_Uint:               return DXGI_FORMAT_R8_UINT;
     case EFormat::R8_Snorm:              return DXGI_FORMAT_R8_SNORM;
     case EFormat::R8_Sint:               return DXGI_FORMAT_R8_SINT;
+    case EFormat::BC1_Typeless:          return DXGI_FORMAT_BC1_TYPELESS;
+    case EFormat::BC1_Unorm:             return DXGI_FORMAT_BC1_UNORM;
+    case EFormat::BC1_Unorm_SRGB:        return DXGI_FORMAT_BC1_UNORM_SRGB;
+    case EFormat::BC4_Typeless:          return DXGI_FORMAT_BC4_TYPELESS;
+    case EFormat::BC4_Unorm:             return DXGI_FORMAT_BC4_UNORM;
+    case EFormat::BC4_Snorm:             return DXGI_FORMAT_BC4_SNORM;
+    case EFormat::BC5_Typeless:          return DXGI_FORMAT_BC5_TYPELESS;
+    case EFormat::BC5_Unorm:             return DXGI_FORMAT_BC5_UNORM;
+    case EFormat::BC5_Snorm:             return DXGI_FORMAT_BC5_SNORM;
+    case EFormat::BC7_Typeless:          return DXGI_FORMAT_BC7_TYPELESS;
+    case EFormat::BC7_Unorm:             return DXGI_FORMAT_BC7_UNORM;
+    case EFormat::BC7_Unorm_SRGB:        return DXGI_FORMAT_BC7_UNORM_SRGB;
     default: return DXGI_FORMAT_UNKNOWN;
     }
 }
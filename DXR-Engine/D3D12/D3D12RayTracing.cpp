@@ -8,8 +8,8 @@
 #include "D3D12CommandList.h"
 #include "D3D12DescriptorHeap.h"
 
-D3D12RayTracingGeometry::D3D12RayTracingGeometry(D3D12Device* InDevice, uint32 InFlags)
-    : RayTracingGeometry(InFlags)
+D3D12RayTracingGeometry::D3D12RayTracingGeometry(D3D12Device* InDevice, uint32 InFlags, EFormat InVertexFormat)
+    : RayTracingGeometry(InFlags, InVertexFormat)
     , D3D12DeviceChild(InDevice)
     , VertexBuffer(nullptr)
     , IndexBuffer(nullptr)
@@ -28,7 +28,7 @@ bool D3D12RayTracingGeometry::Build(D3D12CommandContext& CmdContext, bool Update
     GeometryDesc.Type                                 = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
     GeometryDesc.Triangles.VertexBuffer.StartAddress  = VertexBuffer->GetResource()->GetGPUVirtualAddress();
     GeometryDesc.Triangles.VertexBuffer.StrideInBytes = VertexBuffer->GetStride();
-    GeometryDesc.Triangles.VertexFormat               = DXGI_FORMAT_R32G32B32_FLOAT;
+    GeometryDesc.Triangles.VertexFormat               = ConvertFormat(GetVertexFormat());
     GeometryDesc.Triangles.VertexCount                = VertexBuffer->GetNumVertices();
     GeometryDesc.Flags                                = D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE;
 
@@ -11,7 +11,7 @@ class Material;
 class D3D12RayTracingGeometry : public RayTracingGeometry, public D3D12DeviceChild
 {
 public:
-    D3D12RayTracingGeometry(D3D12Device* InDevice, uint32 InFlags);
+    D3D12RayTracingGeometry(D3D12Device* InDevice, uint32 InFlags, EFormat InVertexFormat);
     ~D3D12RayTracingGeometry() = default;
 
     bool Build(class D3D12CommandContext& CmdContext, bool Update);
@@ -388,11 +388,11 @@ TD3D12Texture* D3D12RenderLayer::CreateTexture(
 
         DirectCmdContext->Begin();
 
-        DirectCmdContext->TransitionTexture(Texture2D, EResourceState::Common, EResourceState::CopyDest);
+        DirectCmdContext->TransitionTexture(Texture2D, EResourceState::CopyDest, ALL_SUBRESOURCES);
         DirectCmdContext->UpdateTexture2D(Texture2D, SizeX, SizeY, 0, InitialData->GetData());
 
         // NOTE: Transition into InitialState
-        DirectCmdContext->TransitionTexture(Texture2D, EResourceState::CopyDest, InitialState);
+        DirectCmdContext->TransitionTexture(Texture2D, InitialState, ALL_SUBRESOURCES);
 
         DirectCmdContext->End();
     }
@@ -401,7 +401,7 @@ TD3D12Texture* D3D12RenderLayer::CreateTexture(
         if (InitialState != EResourceState::Common)
         {
             DirectCmdContext->Begin();
-            DirectCmdContext->TransitionTexture(NewTexture.Get(), EResourceState::Common, InitialState);
+            DirectCmdContext->TransitionTexture(NewTexture.Get(), InitialState, ALL_SUBRESOURCES);
             DirectCmdContext->End();
         }
     }
@@ -542,6 +542,12 @@ bool D3D12RenderLayer::FinalizeBufferResource(TD3D12Buffer* Buffer, uint32 SizeI
         Buffer->SetResource(Resource.ReleaseOwnership());
     }
 
+    // Upload buffers have to stay in the GenericRead state
+    if (Flags & BufferFlag_Upload)
+    {
+        Buffer->GetStateTracker().SetState(EResourceState::GenericRead);
+    }
+
     if (InitialData)
     {
         if (Buffer->IsUpload())
@@ -561,11 +567,11 @@ bool D3D12RenderLayer::FinalizeBufferResource(TD3D12Buffer* Buffer, uint32 SizeI
         {
             DirectCmdContext->Begin();
 
-            DirectCmdContext->TransitionBuffer(Buffer, EResourceState::Common, EResourceState::CopyDest);
+            DirectCmdContext->TransitionBuffer(Buffer, EResourceState::CopyDest);
             DirectCmdContext->UpdateBuffer(Buffer, 0, InitialData->GetSizeInBytes(), InitialData->GetData());
             
             // NOTE: Transfer to the initialstate
-            DirectCmdContext->TransitionBuffer(Buffer, EResourceState::CopyDest, InitialState);
+            DirectCmdContext->TransitionBuffer(Buffer, InitialState);
 
             DirectCmdContext->End();
         }
@@ -575,7 +581,7 @@ bool D3D12RenderLayer::FinalizeBufferResource(TD3D12Buffer* Buffer, uint32 SizeI
         if (InitialState != EResourceState::Common && !Buffer->IsUpload())
         {
             DirectCmdContext->Begin();
-            DirectCmdContext->TransitionBuffer(Buffer, EResourceState::Common, InitialState);
+            DirectCmdContext->TransitionBuffer(Buffer, InitialState);
             DirectCmdContext->End();
         }
     }
@@ -650,12 +656,12 @@ StructuredBuffer* D3D12RenderLayer::CreateStructuredBuffer(uint32 Stride, uint32
     }
 }
 
-RayTracingGeometry* D3D12RenderLayer::CreateRayTracingGeometry(uint32 Flags, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer)
+RayTracingGeometry* D3D12RenderLayer::CreateRayTracingGeometry(uint32 Flags, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer, EFormat VertexFormat)
 {
     D3D12VertexBuffer* DxVertexBuffer = static_cast<D3D12VertexBuffer*>(VertexBuffer);
     D3D12IndexBuffer*  DxIndexBuffer  = static_cast<D3D12IndexBuffer*>(IndexBuffer);
 
-    TRef<D3D12RayTracingGeometry> Geometry = DBG_NEW D3D12RayTracingGeometry(Device, Flags);
+    TRef<D3D12RayTracingGeometry> Geometry = DBG_NEW D3D12RayTracingGeometry(Device, Flags, VertexFormat);
     Geometry->VertexBuffer = MakeSharedRef<D3D12VertexBuffer>(DxVertexBuffer);
     Geometry->IndexBuffer  = MakeSharedRef<D3D12IndexBuffer>(DxIndexBuffer);
     
@@ -799,12 +805,17 @@ ShaderResourceView* D3D12RenderLayer::CreateShaderResourceView(const ShaderResou
 
         Assert(Buffer->IsSRV());
 
+        // Raw views count 32-bit elements, so the vertices have to start and end on one
+        const uint32 FirstByte = CreateInfo.VertexBuffer.FirstVertex * Buffer->GetStride();
+        const uint32 NumBytes  = CreateInfo.VertexBuffer.NumVertices * Buffer->GetStride();
+        Assert(FirstByte % sizeof(uint32) == 0 && NumBytes % sizeof(uint32) == 0);
+
         Desc.ViewDimension              = D3D12_SRV_DIMENSION_BUFFER;
-        Desc.Buffer.FirstElement        = CreateInfo.VertexBuffer.FirstVertex;
-        Desc.Buffer.NumElements         = CreateInfo.VertexBuffer.NumVertices;
-        Desc.Format                     = DXGI_FORMAT_UNKNOWN;
-        Desc.Buffer.Flags               = D3D12_BUFFER_SRV_FLAG_NONE;
-        Desc.Buffer.StructureByteStride = Buffer->GetStride();
+        Desc.Buffer.FirstElement        = FirstByte / sizeof(uint32);
+        Desc.Buffer.NumElements         = NumBytes / sizeof(uint32);
+        Desc.Format                     = DXGI_FORMAT_R32_TYPELESS;
+        Desc.Buffer.Flags               = D3D12_BUFFER_SRV_FLAG_RAW;
+        Desc.Buffer.StructureByteStride = 0;
     }
     else if (CreateInfo.Type == ShaderResourceViewCreateInfo::EType::IndexBuffer)
     {
@@ -813,11 +824,16 @@ ShaderResourceView* D3D12RenderLayer::CreateShaderResourceView(const ShaderResou
         Resource = DxBuffer->GetResource();
 
         Assert(Buffer->IsSRV());
-        Assert(Buffer->GetFormat() != EIndexFormat::uint16);
+
+        // 16-bit indices are read two at a time, CreateIndexBuffer pads the buffer to a whole number of 32-bit elements
+        const uint32 Stride    = GetStrideFromIndexFormat(Buffer->GetFormat());
+        const uint32 FirstByte = CreateInfo.IndexBuffer.FirstIndex * Stride;
+        const uint32 NumBytes  = Math::AlignUp<uint32>(CreateInfo.IndexBuffer.NumIndices * Stride, sizeof(uint32));
+        Assert(FirstByte % sizeof(uint32) == 0);
 
         Desc.ViewDimension              = D3D12_SRV_DIMENSION_BUFFER;
-        Desc.Buffer.FirstElement        = CreateInfo.IndexBuffer.FirstIndex;
-        Desc.Buffer.NumElements         = CreateInfo.IndexBuffer.NumIndices;
+        Desc.Buffer.FirstElement        = FirstByte / sizeof(uint32);
+        Desc.Buffer.NumElements         = NumBytes / sizeof(uint32);
         Desc.Format                     = DXGI_FORMAT_R32_TYPELESS;
         Desc.Buffer.Flags               = D3D12_BUFFER_SRV_FLAG_RAW;
         Desc.Buffer.StructureByteStride = 0;
@@ -2,6 +2,8 @@
 
 #include "Main/EngineMain.h"
 
+#include "Core/Engine/CommandLine.h"
+
 #include "Core/Application/Windows/WindowsPlatform.h"
 
 #include "Debug/Debug.h"
@@ -25,6 +27,8 @@ int WINAPI WinMain(HINSTANCE Instance, HINSTANCE PrevInstance, LPSTR CmdLine, in
 
     WindowsPlatform::PreMainInit(Instance);
 
+    CommandLine::Init(CmdLine);
+
     return EngineMain();
 }
 
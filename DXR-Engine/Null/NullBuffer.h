@@ -0,0 +1,48 @@
+#pragma once
+#include "RenderLayer/Resources.h"
+
+#include "Memory/Memory.h"
+
+/*
+* Buffers in the NullRenderLayer are backed by system memory so that Map and UpdateBuffer behave like on a GPU
+* backend. This keeps the CPU-cost of filling buffers in benchmarks close to the real thing.
+*/
+
+template<typename TBaseBuffer>
+class TNullBuffer : public TBaseBuffer
+{
+public:
+    template<typename... TBufferArgs>
+    TNullBuffer(uint32 InSizeInBytes, TBufferArgs&&... Args)
+        : TBaseBuffer(Forward<TBufferArgs>(Args)...)
+        , Memory(InSizeInBytes)
+    {
+    }
+
+    virtual void* Map(uint32 Offset, uint32 Size) override
+    {
+        Assert(uint64(Offset) + uint64(Size) <= uint64(Memory.Size()));
+        UNREFERENCED_VARIABLE(Size);
+        return Memory.Data() + Offset;
+    }
+
+    virtual void Unmap(uint32 Offset, uint32 Size) override
+    {
+        UNREFERENCED_VARIABLE(Offset);
+        UNREFERENCED_VARIABLE(Size);
+    }
+
+    virtual bool IsValid() const override { return true; }
+
+    uint8* GetData() { return Memory.Data(); }
+
+    uint32 GetSizeInBytes() const { return Memory.Size(); }
+
+private:
+    TArray<uint8> Memory;
+};
+
+using NullVertexBuffer     = TNullBuffer<VertexBuffer>;
+using NullIndexBuffer      = TNullBuffer<IndexBuffer>;
+using NullConstantBuffer   = TNullBuffer<ConstantBuffer>;
+using NullStructuredBuffer = TNullBuffer<StructuredBuffer>;
\ No newline at end of file
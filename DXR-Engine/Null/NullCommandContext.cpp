@@ -0,0 +1,477 @@
+#include "NullCommandContext.h"
+
+#include "Core/Application/Log.h"
+
+void NullCommandContext::Begin()
+{
+    Validate(IsReady == false, "NullCommandContext::Begin called while the context is already recording");
+
+    ClearState();
+    IsReady = true;
+
+    Statistics.NumBatches++;
+}
+
+void NullCommandContext::End()
+{
+    Validate(IsReady == true, "NullCommandContext::End called without a matching call to Begin");
+    IsReady = false;
+}
+
+void NullCommandContext::ClearRenderTargetView(RenderTargetView* RenderTargetView, const ColorF& ClearColor)
+{
+    UNREFERENCED_VARIABLE(ClearColor);
+
+    ValidateIsReady("ClearRenderTargetView");
+    Validate(RenderTargetView != nullptr, "ClearRenderTargetView called with a nullptr RenderTargetView");
+    CountCommand();
+}
+
+void NullCommandContext::ClearDepthStencilView(DepthStencilView* DepthStencilView, const DepthStencilF& ClearValue)
+{
+    UNREFERENCED_VARIABLE(ClearValue);
+
+    ValidateIsReady("ClearDepthStencilView");
+    Validate(DepthStencilView != nullptr, "ClearDepthStencilView called with a nullptr DepthStencilView");
+    CountCommand();
+}
+
+void NullCommandContext::ClearUnorderedAccessViewFloat(UnorderedAccessView* UnorderedAccessView, const ColorF& ClearColor)
+{
+    UNREFERENCED_VARIABLE(ClearColor);
+
+    ValidateIsReady("ClearUnorderedAccessViewFloat");
+    Validate(UnorderedAccessView != nullptr, "ClearUnorderedAccessViewFloat called with a nullptr UnorderedAccessView");
+    CountCommand();
+}
+
+void NullCommandContext::SetRenderTargets(RenderTargetView* const* RenderTargetViews, uint32 RenderTargetCount, DepthStencilView* DepthStencilView)
+{
+    ValidateIsReady("SetRenderTargets");
+
+    for (uint32 i = 0; i < RenderTargetCount; i++)
+    {
+        Validate(RenderTargetViews[i] != nullptr, "SetRenderTargets called with a nullptr RenderTargetView");
+    }
+
+    NumBoundRenderTargets = RenderTargetCount;
+    HasDepthStencil       = DepthStencilView != nullptr;
+    CountStateChange();
+}
+
+void NullCommandContext::SetVertexBuffers(VertexBuffer* const* VertexBuffers, uint32 BufferCount, uint32 BufferSlot)
+{
+    UNREFERENCED_VARIABLE(BufferSlot);
+
+    ValidateIsReady("SetVertexBuffers");
+    Validate(BufferCount == 0 || VertexBuffers != nullptr, "SetVertexBuffers called without any VertexBuffers");
+    CountStateChange();
+}
+
+void NullCommandContext::SetIndexBuffer(IndexBuffer* IndexBuffer)
+{
+    ValidateIsReady("SetIndexBuffer");
+
+    CurrentIndexBuffer = IndexBuffer;
+    CountStateChange();
+}
+
+void NullCommandContext::SetGraphicsPipelineState(GraphicsPipelineState* PipelineState)
+{
+    ValidateIsReady("SetGraphicsPipelineState");
+
+    CurrentGraphicsPipeline = PipelineState;
+    CountStateChange();
+}
+
+void NullCommandContext::SetComputePipelineState(ComputePipelineState* PipelineState)
+{
+    ValidateIsReady("SetComputePipelineState");
+
+    CurrentComputePipeline = PipelineState;
+    CountStateChange();
+}
+
+void NullCommandContext::Set32BitShaderConstants(Shader* Shader, const void* Shader32BitConstants, uint32 Num32BitConstants)
+{
+    ValidateIsReady("Set32BitShaderConstants");
+    Validate(Shader != nullptr, "Set32BitShaderConstants called with a nullptr Shader");
+    Validate(Num32BitConstants == 0 || Shader32BitConstants != nullptr, "Set32BitShaderConstants called without any data");
+    CountStateChange();
+}
+
+void NullCommandContext::UpdateBuffer(Buffer* Destination, uint64 OffsetInBytes, uint64 SizeInBytes, const void* SourceData)
+{
+    ValidateIsReady("UpdateBuffer");
+    Validate(Destination != nullptr, "UpdateBuffer called with a nullptr Destination");
+    Validate(SourceData != nullptr, "UpdateBuffer called with a nullptr SourceData");
+
+    if (Destination && SourceData && SizeInBytes != 0)
+    {
+        // Map asserts that the range is within the buffer
+        void* Data = Destination->Map(uint32(OffsetInBytes), uint32(SizeInBytes));
+        Memory::Memcpy(Data, SourceData, SizeInBytes);
+        Destination->Unmap(uint32(OffsetInBytes), uint32(SizeInBytes));
+
+        Statistics.NumBytesUploaded += SizeInBytes;
+    }
+
+    Statistics.NumCopies++;
+    CountCommand();
+}
+
+void NullCommandContext::UpdateTexture2D(Texture2D* Destination, uint32 Width, uint32 Height, uint32 MipLevel, const void* SourceData)
+{
+    ValidateIsReady("UpdateTexture2D");
+    Validate(Destination != nullptr, "UpdateTexture2D called with a nullptr Destination");
+
+    if (Destination)
+    {
+        Validate(MipLevel < Destination->GetNumMips(), "UpdateTexture2D called with a MipLevel that is out of range");
+        Validate(Width <= Destination->GetWidth() && Height <= Destination->GetHeight(), "UpdateTexture2D called with a region larger than the texture");
+    }
+
+    if (SourceData && Width > 0 && Height > 0)
+    {
+        Statistics.NumBytesUploaded += uint64(Width) * uint64(Height) * uint64(GetByteStrideFromFormat(Destination ? Destination->GetFormat() : EFormat::Unknown));
+    }
+
+    Statistics.NumCopies++;
+    CountCommand();
+}
+
+void NullCommandContext::ResolveTexture(Texture* Destination, Texture* Source)
+{
+    ValidateIsReady("ResolveTexture");
+    Validate(Destination != nullptr && Source != nullptr, "ResolveTexture called with a nullptr Texture");
+
+    Statistics.NumCopies++;
+    CountCommand();
+}
+
+void NullCommandContext::CopyBuffer(Buffer* Destination, Buffer* Source, const CopyBufferInfo& CopyInfo)
+{
+    ValidateIsReady("CopyBuffer");
+    Validate(Destination != nullptr && Source != nullptr, "CopyBuffer called with a nullptr Buffer");
+
+    if (Destination && Source && CopyInfo.SizeInBytes != 0)
+    {
+        const void* SourceData = Source->Map(uint32(CopyInfo.SourceOffset), CopyInfo.SizeInBytes);
+        void* DestinationData  = Destination->Map(CopyInfo.DestinationOffset, CopyInfo.SizeInBytes);
+        Memory::Memmove(DestinationData, SourceData, CopyInfo.SizeInBytes);
+
+        Destination->Unmap(CopyInfo.DestinationOffset, CopyInfo.SizeInBytes);
+        Source->Unmap(uint32(CopyInfo.SourceOffset), CopyInfo.SizeInBytes);
+    }
+
+    Statistics.NumCopies++;
+    CountCommand();
+}
+
+void NullCommandContext::CopyTexture(Texture* Destination, Texture* Source)
+{
+    ValidateIsReady("CopyTexture");
+    Validate(Destination != nullptr && Source != nullptr, "CopyTexture called with a nullptr Texture");
+
+    Statistics.NumCopies++;
+    CountCommand();
+}
+
+void NullCommandContext::CopyTextureRegion(Texture* Destination, Texture* Source, const CopyTextureInfo& CopyTextureInfo)
+{
+    UNREFERENCED_VARIABLE(CopyTextureInfo);
+
+    ValidateIsReady("CopyTextureRegion");
+    Validate(Destination != nullptr && Source != nullptr, "CopyTextureRegion called with a nullptr Texture");
+
+    Statistics.NumCopies++;
+    CountCommand();
+}
+
+void NullCommandContext::BuildRayTracingGeometry(RayTracingGeometry* Geometry, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer, bool Update)
+{
+    UNREFERENCED_VARIABLE(Update);
+
+    ValidateIsReady("BuildRayTracingGeometry");
+    Validate(Geometry != nullptr && VertexBuffer != nullptr && IndexBuffer != nullptr, "BuildRayTracingGeometry called with a nullptr resource");
+    CountCommand();
+}
+
+void NullCommandContext::BuildRayTracingScene(RayTracingScene* RayTracingScene, const RayTracingGeometryInstance* Instances, uint32 NumInstances, bool Update)
+{
+    UNREFERENCED_VARIABLE(Update);
+
+    ValidateIsReady("BuildRayTracingScene");
+    Validate(RayTracingScene != nullptr, "BuildRayTracingScene called with a nullptr RayTracingScene");
+    Validate(NumInstances == 0 || Instances != nullptr, "BuildRayTracingScene called without any instances");
+    CountCommand();
+}
+
+void NullCommandContext::SetRayTracingBindings(
+    RayTracingScene* RayTracingScene,
+    RayTracingPipelineState* PipelineState,
+    const RayTracingShaderResources* GlobalResource,
+    const RayTracingShaderResources* RayGenLocalResources,
+    const RayTracingShaderResources* MissLocalResources,
+    const RayTracingShaderResources* HitGroupResources, uint32 NumHitGroupResources)
+{
+    UNREFERENCED_VARIABLE(GlobalResource);
+    UNREFERENCED_VARIABLE(RayGenLocalResources);
+    UNREFERENCED_VARIABLE(MissLocalResources);
+
+    ValidateIsReady("SetRayTracingBindings");
+    Validate(RayTracingScene != nullptr && PipelineState != nullptr, "SetRayTracingBindings called with a nullptr RayTracingScene or PipelineState");
+    Validate(NumHitGroupResources == 0 || HitGroupResources != nullptr, "SetRayTracingBindings called without any HitGroupResources");
+    CountStateChange();
+}
+
+void NullCommandContext::GenerateMips(Texture* Texture)
+{
+    ValidateIsReady("GenerateMips");
+    Validate(Texture != nullptr, "GenerateMips called with a nullptr Texture");
+
+    Statistics.NumDispatchCalls++;
+    CountCommand();
+}
+
+static uint32 GetNumSubresources(Texture* Texture)
+{
+    uint32 NumArraySlices = 1;
+    if (Texture2DArray* TextureArray = Texture->AsTexture2DArray())
+    {
+        NumArraySlices = TextureArray->GetNumArraySlices();
+    }
+    else if (Texture->AsTextureCube())
+    {
+        NumArraySlices = 6;
+    }
+    else if (TextureCubeArray* CubeArray = Texture->AsTextureCubeArray())
+    {
+        NumArraySlices = CubeArray->GetNumArraySlices() * 6;
+    }
+
+    return Texture->GetNumMips() * NumArraySlices;
+}
+
+void NullCommandContext::TransitionTexture(Texture* Texture, EResourceState AfterState, uint32 Subresource)
+{
+    ValidateIsReady("TransitionTexture");
+    if (!Validate(Texture != nullptr, "TransitionTexture called with a nullptr Texture"))
+    {
+        return;
+    }
+
+    const uint32 NumSubresources = GetNumSubresources(Texture);
+    if (!Validate(Subresource == ALL_SUBRESOURCES || Subresource < NumSubresources, "TransitionTexture called with an invalid Subresource"))
+    {
+        return;
+    }
+
+    // Count the barriers that the D3D12RenderLayer would issue
+    ResourceStateTracker& StateTracker = Texture->GetStateTracker();
+    if (Subresource == ALL_SUBRESOURCES && !StateTracker.IsUniform())
+    {
+        for (uint32 Index = 0; Index < StateTracker.GetNumTrackedSubresources(); Index++)
+        {
+            if (StateTracker.GetSubresourceState(Index) != AfterState)
+            {
+                Statistics.NumBarriers++;
+            }
+        }
+    }
+    else if (StateTracker.GetSubresourceState(Subresource == ALL_SUBRESOURCES ? 0 : Subresource) != AfterState)
+    {
+        Statistics.NumBarriers++;
+    }
+    else
+    {
+        Statistics.NumRedundantBarriers++;
+    }
+
+    StateTracker.SetSubresourceState(Subresource, AfterState, NumSubresources);
+    CountCommand();
+}
+
+void NullCommandContext::TransitionBuffer(Buffer* Buffer, EResourceState AfterState)
+{
+    ValidateIsReady("TransitionBuffer");
+    if (!Validate(Buffer != nullptr, "TransitionBuffer called with a nullptr Buffer"))
+    {
+        return;
+    }
+
+    ResourceStateTracker& StateTracker = Buffer->GetStateTracker();
+    if (StateTracker.GetState() != AfterState)
+    {
+        Statistics.NumBarriers++;
+    }
+    else
+    {
+        Statistics.NumRedundantBarriers++;
+    }
+
+    StateTracker.SetState(AfterState);
+    CountCommand();
+}
+
+void NullCommandContext::UnorderedAccessTextureBarrier(Texture* Texture)
+{
+    ValidateIsReady("UnorderedAccessTextureBarrier");
+    Validate(Texture != nullptr, "UnorderedAccessTextureBarrier called with a nullptr Texture");
+
+    Statistics.NumBarriers++;
+    CountCommand();
+}
+
+void NullCommandContext::UnorderedAccessBufferBarrier(Buffer* Buffer)
+{
+    ValidateIsReady("UnorderedAccessBufferBarrier");
+    Validate(Buffer != nullptr, "UnorderedAccessBufferBarrier called with a nullptr Buffer");
+
+    Statistics.NumBarriers++;
+    CountCommand();
+}
+
+void NullCommandContext::Draw(uint32 VertexCount, uint32 StartVertexLocation)
+{
+    UNREFERENCED_VARIABLE(VertexCount);
+    UNREFERENCED_VARIABLE(StartVertexLocation);
+
+    ValidateGraphicsState("Draw", false);
+
+    Statistics.NumDrawCalls++;
+    CountCommand();
+}
+
+void NullCommandContext::DrawIndexed(uint32 IndexCount, uint32 StartIndexLocation, uint32 BaseVertexLocation)
+{
+    UNREFERENCED_VARIABLE(BaseVertexLocation);
+
+    ValidateGraphicsState("DrawIndexed", true);
+    if (CurrentIndexBuffer)
+    {
+        Validate(StartIndexLocation + IndexCount <= CurrentIndexBuffer->GetNumIndicies(), "DrawIndexed reads outside of the bound IndexBuffer");
+    }
+
+    Statistics.NumDrawCalls++;
+    CountCommand();
+}
+
+void NullCommandContext::DrawInstanced(uint32 VertexCountPerInstance, uint32 InstanceCount, uint32 StartVertexLocation, uint32 StartInstanceLocation)
+{
+    UNREFERENCED_VARIABLE(VertexCountPerInstance);
+    UNREFERENCED_VARIABLE(InstanceCount);
+    UNREFERENCED_VARIABLE(StartVertexLocation);
+    UNREFERENCED_VARIABLE(StartInstanceLocation);
+
+    ValidateGraphicsState("DrawInstanced", false);
+
+    Statistics.NumDrawCalls++;
+    CountCommand();
+}
+
+void NullCommandContext::DrawIndexedInstanced(
+    uint32 IndexCountPerInstance,
+    uint32 InstanceCount,
+    uint32 StartIndexLocation,
+    uint32 BaseVertexLocation,
+    uint32 StartInstanceLocation)
+{
+    UNREFERENCED_VARIABLE(InstanceCount);
+    UNREFERENCED_VARIABLE(BaseVertexLocation);
+    UNREFERENCED_VARIABLE(StartInstanceLocation);
+
+    ValidateGraphicsState("DrawIndexedInstanced", true);
+    if (CurrentIndexBuffer)
+    {
+        Validate(StartIndexLocation + IndexCountPerInstance <= CurrentIndexBuffer->GetNumIndicies(), "DrawIndexedInstanced reads outside of the bound IndexBuffer");
+    }
+
+    Statistics.NumDrawCalls++;
+    CountCommand();
+}
+
+void NullCommandContext::Dispatch(uint32 WorkGroupsX, uint32 WorkGroupsY, uint32 WorkGroupsZ)
+{
+    ValidateIsReady("Dispatch");
+    Validate(CurrentComputePipeline != nullptr, "Dispatch called without a bound ComputePipelineState");
+    Validate(WorkGroupsX > 0 && WorkGroupsY > 0 && WorkGroupsZ > 0, "Dispatch called with zero WorkGroups");
+
+    Statistics.NumDispatchCalls++;
+    CountCommand();
+}
+
+void NullCommandContext::DispatchRays(
+    RayTracingScene* InScene,
+    RayTracingPipelineState* InPipelineState,
+    uint32 InWidth,
+    uint32 InHeight,
+    uint32 InDepth)
+{
+    UNREFERENCED_VARIABLE(InWidth);
+    UNREFERENCED_VARIABLE(InHeight);
+    UNREFERENCED_VARIABLE(InDepth);
+
+    ValidateIsReady("DispatchRays");
+    Validate(InScene != nullptr && InPipelineState != nullptr, "DispatchRays called with a nullptr RayTracingScene or PipelineState");
+
+    Statistics.NumDispatchRays++;
+    CountCommand();
+}
+
+void NullCommandContext::ClearState()
+{
+    CurrentGraphicsPipeline = nullptr;
+    CurrentComputePipeline  = nullptr;
+    CurrentIndexBuffer      = nullptr;
+    NumBoundRenderTargets   = 0;
+    HasDepthStencil         = false;
+}
+
+void NullCommandContext::CountBinding(Shader* Shader, uint32 NumBindings)
+{
+    ValidateIsReady("SetShaderResources");
+    Validate(Shader != nullptr, "Tried to bind resources to a nullptr Shader");
+
+    Statistics.NumResourceBindings += NumBindings;
+    CountStateChange();
+}
+
+bool NullCommandContext::Validate(bool Condition, const std::string& Message)
+{
+    if (!Condition)
+    {
+        Statistics.NumValidationErrors++;
+        LOG_ERROR("[NullCommandContext]: " + Message);
+    }
+
+    return Condition;
+}
+
+void NullCommandContext::ValidateIsReady(const char* Function)
+{
+    if (!IsReady)
+    {
+        Validate(false, std::string(Function) + " called outside of Begin/End");
+    }
+}
+
+void NullCommandContext::ValidateGraphicsState(const char* Function, bool Indexed)
+{
+    ValidateIsReady(Function);
+
+    if (!CurrentGraphicsPipeline)
+    {
+        Validate(false, std::string(Function) + " called without a bound GraphicsPipelineState");
+    }
+
+    if (NumBoundRenderTargets == 0 && !HasDepthStencil)
+    {
+        Validate(false, std::string(Function) + " called without any bound RenderTargets or DepthStencil");
+    }
+
+    if (Indexed && !CurrentIndexBuffer)
+    {
+        Validate(false, std::string(Function) + " called without a bound IndexBuffer");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#pragma once
+#include "RenderLayer/ICommandContext.h"
+
+#ifdef COMPILER_VISUAL_STUDIO
+    #pragma warning(push)
+    #pragma warning(disable : 4100) // Disable unreferenced variable
+#endif
+
+struct NullCommandContextStatistics
+{
+    uint32 NumBatches           = 0;
+    uint32 NumCommands          = 0;
+    uint32 NumDrawCalls         = 0;
+    uint32 NumDispatchCalls     = 0;
+    uint32 NumDispatchRays      = 0;
+    uint32 NumBarriers          = 0;
+    uint32 NumRedundantBarriers = 0; // Transitions into the state the resource already was in
+    uint32 NumCopies            = 0;
+    uint32 NumStateChanges      = 0;
+    uint32 NumResourceBindings  = 0;
+    uint32 NumValidationErrors  = 0;
+    uint64 NumBytesUploaded     = 0;
+};
+
+/*
+* CommandContext that executes commands without a GPU. Buffer updates and copies are performed on the system memory 
+* backing the NullBuffers, and the state needed to validate draws and dispatches is tracked so that errors in the 
+* recorded CommandLists are reported. Everything else only increments the statistics.
+*/
+
+class NullCommandContext : public ICommandContext
+{
+public:
+    NullCommandContext()  = default;
+    ~NullCommandContext() = default;
+
+    virtual void Begin() override;
+    virtual void End()   override;
+
+    virtual void BeginTimeStamp(GPUProfiler* Profiler, uint32 Index) override { CountCommand(); }
+    virtual void EndTimeStamp(GPUProfiler* Profiler, uint32 Index)   override { CountCommand(); }
+
+    virtual void ClearRenderTargetView(RenderTargetView* RenderTargetView, const ColorF& ClearColor) override;
+    virtual void ClearDepthStencilView(DepthStencilView* DepthStencilView, const DepthStencilF& ClearValue) override;
+    virtual void ClearUnorderedAccessViewFloat(UnorderedAccessView* UnorderedAccessView, const ColorF& ClearColor) override;
+
+    virtual void SetShadingRate(EShadingRate ShadingRate) override { CountStateChange(); }
+    virtual void SetShadingRateImage(Texture2D* ShadingImage) override { CountStateChange(); }
+
+    virtual void BeginRenderPass() override { CountCommand(); }
+    virtual void EndRenderPass()   override { CountCommand(); }
+
+    virtual void SetViewport(float Width, float Height, float MinDepth, float MaxDepth, float x, float y) override { CountStateChange(); }
+    virtual void SetScissorRect(float Width, float Height, float x, float y) override { CountStateChange(); }
+
+    virtual void SetBlendFactor(const ColorF& Color) override { CountStateChange(); }
+
+    virtual void SetRenderTargets(RenderTargetView* const* RenderTargetViews, uint32 RenderTargetCount, DepthStencilView* DepthStencilView) override;
+
+    virtual void SetVertexBuffers(VertexBuffer* const* VertexBuffers, uint32 BufferCount, uint32 BufferSlot) override;
+    virtual void SetIndexBuffer(IndexBuffer* IndexBuffer) override;
+
+    virtual void SetPrimitiveTopology(EPrimitiveTopology PrimitveTopologyType) override { CountStateChange(); }
+
+    virtual void SetGraphicsPipelineState(class GraphicsPipelineState* PipelineState) override;
+    virtual void SetComputePipelineState(class ComputePipelineState* PipelineState)   override;
+
+    virtual void Set32BitShaderConstants(Shader* Shader, const void* Shader32BitConstants, uint32 Num32BitConstants) override;
+
+    virtual void SetShaderResourceView(Shader* Shader, ShaderResourceView* ShaderResourceView, uint32 ParameterIndex) override { CountBinding(Shader, 1); }
+    virtual void SetShaderResourceViews(Shader* Shader, ShaderResourceView* const* ShaderResourceView, uint32 NumShaderResourceViews, uint32 ParameterIndex) override { CountBinding(Shader, NumShaderResourceViews); }
+
+    virtual void SetUnorderedAccessView(Shader* Shader, UnorderedAccessView* UnorderedAccessView, uint32 ParameterIndex) override { CountBinding(Shader, 1); }
+    virtual void SetUnorderedAccessViews(Shader* Shader, UnorderedAccessView* const* UnorderedAccessViews, uint32 NumUnorderedAccessViews, uint32 ParameterIndex) override { CountBinding(Shader, NumUnorderedAccessViews); }
+
+    virtual void SetConstantBuffer(Shader* Shader, ConstantBuffer* ConstantBuffer, uint32 ParameterIndex) override { CountBinding(Shader, 1); }
+    virtual void SetConstantBuffers(Shader* Shader, ConstantBuffer* const* ConstantBuffers, uint32 NumConstantBuffers, uint32 ParameterIndex) override { CountBinding(Shader, NumConstantBuffers); }
+
+    virtual void SetSamplerState(Shader* Shader, SamplerState* SamplerState, uint32 ParameterIndex) override { CountBinding(Shader, 1); }
+    virtual void SetSamplerStates(Shader* Shader, SamplerState* const* SamplerStates, uint32 NumSamplerStates, uint32 ParameterIndex) override { CountBinding(Shader, NumSamplerStates); }
+
+    virtual void UpdateBuffer(Buffer* Destination, uint64 OffsetInBytes, uint64 SizeInBytes, const void* SourceData) override;
+    virtual void UpdateTexture2D(Texture2D* Destination, uint32 Width, uint32 Height, uint32 MipLevel, const void* SourceData) override;
+
+    virtual void ResolveTexture(Texture* Destination, Texture* Source) override;
+
+    virtual void CopyBuffer(Buffer* Destination, Buffer* Source, const CopyBufferInfo& CopyInfo) override;
+    virtual void CopyTexture(Texture* Destination, Texture* Source) override;
+    virtual void CopyTextureRegion(Texture* Destination, Texture* Source, const CopyTextureInfo& CopyTextureInfo) override;
+
+    virtual void DiscardResource(class Resource* Resource) override { CountCommand(); }
+
+    virtual void BuildRayTracingGeometry(RayTracingGeometry* Geometry, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer, bool Update) override;
+    virtual void BuildRayTracingScene(RayTracingScene* RayTracingScene, const RayTracingGeometryInstance* Instances, uint32 NumInstances, bool Update) override;
+
+    virtual void SetRayTracingBindings(
+        RayTracingScene* RayTracingScene,
+        RayTracingPipelineState* PipelineState,
+        const RayTracingShaderResources* GlobalResource,
+        const RayTracingShaderResources* RayGenLocalResources,
+        const RayTracingShaderResources* MissLocalResources,
+        const RayTracingShaderResources* HitGroupResources, uint32 NumHitGroupResources) override;
+
+    virtual void GenerateMips(Texture* Texture) override;
+
+    virtual void TransitionTexture(Texture* Texture, EResourceState AfterState, uint32 Subresource) override;
+    virtual void TransitionBuffer(Buffer* Buffer, EResourceState AfterState) override;
+
+    virtual void UnorderedAccessTextureBarrier(Texture* Texture) override;
+    virtual void UnorderedAccessBufferBarrier(Buffer* Buffer) override;
+
+    virtual void Draw(uint32 VertexCount, uint32 StartVertexLocation) override;
+    virtual void DrawIndexed(uint32 IndexCount, uint32 StartIndexLocation, uint32 BaseVertexLocation) override;
+    virtual void DrawInstanced(uint32 VertexCountPerInstance, uint32 InstanceCount, uint32 StartVertexLocation, uint32 StartInstanceLocation) override;
+
+    virtual void DrawIndexedInstanced(
+        uint32 IndexCountPerInstance,
+        uint32 InstanceCount,
+        uint32 StartIndexLocation,
+        uint32 BaseVertexLocation,
+        uint32 StartInstanceLocation) override;
+
+    virtual void Dispatch(uint32 WorkGroupsX, uint32 WorkGroupsY, uint32 WorkGroupsZ) override;
+
+    virtual void DispatchRays(
+        RayTracingScene* InScene,
+        RayTracingPipelineState* InPipelineState,
+        uint32 InWidth,
+        uint32 InHeight,
+        uint32 InDepth) override;
+
+    virtual void ClearState() override;
+    virtual void Flush()      override { }
+
+    virtual void InsertMarker(const std::string& Message) override { CountCommand(); }
+
+    virtual void BeginExternalCapture() override { }
+    virtual void EndExternalCapture()   override { }
+
+    const NullCommandContextStatistics& GetStatistics() const { return Statistics; }
+
+    void ResetStatistics() { Statistics = NullCommandContextStatistics(); }
+
+private:
+    void CountCommand()
+    {
+        Statistics.NumCommands++;
+    }
+
+    void CountStateChange()
+    {
+        Statistics.NumCommands++;
+        Statistics.NumStateChanges++;
+    }
+
+    void CountBinding(Shader* Shader, uint32 NumBindings);
+
+    // Returns the condition so that the command can be skipped when it is invalid
+    bool Validate(bool Condition, const std::string& Message);
+    void ValidateIsReady(const char* Function);
+    void ValidateGraphicsState(const char* Function, bool Indexed);
+
+    NullCommandContextStatistics Statistics;
+
+    GraphicsPipelineState* CurrentGraphicsPipeline = nullptr;
+    ComputePipelineState*  CurrentComputePipeline  = nullptr;
+    IndexBuffer* CurrentIndexBuffer    = nullptr;
+    uint32       NumBoundRenderTargets = 0;
+    bool         HasDepthStencil       = false;
+    bool         IsReady               = false;
+};
+
+#ifdef COMPILER_VISUAL_STUDIO
+    #pragma warning(pop)
+#endif
\ No newline at end of file
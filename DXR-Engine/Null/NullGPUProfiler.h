@@ -0,0 +1,18 @@
+#pragma once
+#include "RenderLayer/GPUProfiler.h"
+
+// There is no GPU-timeline in the NullRenderLayer so all queries report zero time
+class NullGPUProfiler : public GPUProfiler
+{
+public:
+    virtual void GetTimeQuery(TimeQuery& OutQuery, uint32 Index) const override
+    {
+        UNREFERENCED_VARIABLE(Index);
+        OutQuery.Begin = 0;
+        OutQuery.End   = 0;
+    }
+
+    virtual uint64 GetFrequency() const override { return 1; }
+
+    virtual bool IsValid() const override { return true; }
+};
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include "RenderLayer/PipelineState.h"
+#include "RenderLayer/SamplerState.h"
+
+class NullInputLayoutState : public InputLayoutState
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullDepthStencilState : public DepthStencilState
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullRasterizerState : public RasterizerState
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullBlendState : public BlendState
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullSamplerState : public SamplerState
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullGraphicsPipelineState : public GraphicsPipelineState
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullComputePipelineState : public ComputePipelineState
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullRayTracingPipelineState : public RayTracingPipelineState
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include "RenderLayer/RayTracing.h"
+
+#include "NullViews.h"
+
+class NullRayTracingGeometry : public RayTracingGeometry
+{
+public:
+    NullRayTracingGeometry(uint32 InFlags, EFormat InVertexFormat)
+        : RayTracingGeometry(InFlags, InVertexFormat)
+    {
+    }
+
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullRayTracingScene : public RayTracingScene
+{
+public:
+    NullRayTracingScene(uint32 InFlags)
+        : RayTracingScene(InFlags)
+        , View(DBG_NEW NullShaderResourceView())
+    {
+    }
+
+    virtual ShaderResourceView* GetShaderResourceView() const override { return View.Get(); }
+
+    virtual bool IsValid() const override { return true; }
+
+private:
+    TRef<NullShaderResourceView> View;
+};
\ No newline at end of file
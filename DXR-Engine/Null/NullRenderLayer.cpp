@@ -0,0 +1,314 @@
+#include "NullRenderLayer.h"
+#include "NullTexture.h"
+#include "NullBuffer.h"
+#include "NullShader.h"
+#include "NullPipelineState.h"
+#include "NullRayTracing.h"
+#include "NullViewport.h"
+#include "NullGPUProfiler.h"
+
+#ifdef COMPILER_VISUAL_STUDIO
+    #pragma warning(push)
+    #pragma warning(disable : 4100) // Disable unreferenced variable
+#endif
+
+// Textures are created directly in the initial state since there is no upload that requires a transition
+template<typename TNullTextureType>
+static TNullTextureType* SetInitialState(TNullTextureType* NewTexture, EResourceState InitialState)
+{
+    NewTexture->GetStateTracker().SetState(InitialState);
+    return NewTexture;
+}
+
+// Used when there is no window to take the size from, matches the size of the default window
+static constexpr uint32 NULL_DEFAULT_VIEWPORT_WIDTH  = 1920;
+static constexpr uint32 NULL_DEFAULT_VIEWPORT_HEIGHT = 1080;
+
+NullRenderLayer::NullRenderLayer()
+    : GenericRenderLayer(ERenderLayerApi::Null)
+    , DirectCmdContext(nullptr)
+{
+}
+
+NullRenderLayer::~NullRenderLayer()
+{
+    DirectCmdContext.Reset();
+}
+
+bool NullRenderLayer::Init(bool EnableDebug)
+{
+    DirectCmdContext = DBG_NEW NullCommandContext();
+    return true;
+}
+
+Texture2D* NullRenderLayer::CreateTexture2D(
+    EFormat Format,
+    uint32 Width,
+    uint32 Height,
+    uint32 NumMips,
+    uint32 NumSamples,
+    uint32 Flags,
+    EResourceState InitialState,
+    const ResourceData* InitalData,
+    const ClearValue& OptimizedClearValue)
+{
+    return SetInitialState(DBG_NEW NullTexture2D(Format, Width, Height, NumMips, NumSamples, Flags, OptimizedClearValue), InitialState);
+}
+
+Texture2DArray* NullRenderLayer::CreateTexture2DArray(
+    EFormat Format,
+    uint32 Width,
+    uint32 Height,
+    uint32 NumMips,
+    uint32 NumSamples,
+    uint32 NumArraySlices,
+    uint32 Flags,
+    EResourceState InitialState,
+    const ResourceData* InitalData,
+    const ClearValue& OptimizedClearValue)
+{
+    return SetInitialState(DBG_NEW NullTexture2DArray(Format, Width, Height, NumMips, NumSamples, NumArraySlices, Flags, OptimizedClearValue), InitialState);
+}
+
+TextureCube* NullRenderLayer::CreateTextureCube(
+    EFormat Format,
+    uint32 Size,
+    uint32 NumMips,
+    uint32 Flags,
+    EResourceState InitialState,
+    const ResourceData* InitalData,
+    const ClearValue& OptimizedClearValue)
+{
+    return SetInitialState(DBG_NEW NullTextureCube(Format, Size, NumMips, Flags, OptimizedClearValue), InitialState);
+}
+
+TextureCubeArray* NullRenderLayer::CreateTextureCubeArray(
+    EFormat Format,
+    uint32 Size,
+    uint32 NumMips,
+    uint32 NumArraySlices,
+    uint32 Flags,
+    EResourceState InitialState,
+    const ResourceData* InitalData,
+    const ClearValue& OptimizedClearValue)
+{
+    return SetInitialState(DBG_NEW NullTextureCubeArray(Format, Size, NumMips, NumArraySlices, Flags, OptimizedClearValue), InitialState);
+}
+
+Texture3D* NullRenderLayer::CreateTexture3D(
+    EFormat Format,
+    uint32 Width,
+    uint32 Height,
+    uint32 Depth,
+    uint32 NumMips,
+    uint32 Flags,
+    EResourceState InitialState,
+    const ResourceData* InitalData,
+    const ClearValue& OptimizedClearValue)
+{
+    return SetInitialState(DBG_NEW NullTexture3D(Format, Width, Height, Depth, NumMips, Flags, OptimizedClearValue), InitialState);
+}
+
+SamplerState* NullRenderLayer::CreateSamplerState(const SamplerStateCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullSamplerState();
+}
+
+template<typename TNullBufferType, typename... TBufferArgs>
+TNullBufferType* NullRenderLayer::CreateBuffer(uint32 SizeInBytes, EResourceState InitialState, const ResourceData* InitialData, TBufferArgs&&... Args)
+{
+    TNullBufferType* NewBuffer = DBG_NEW TNullBufferType(SizeInBytes, Forward<TBufferArgs>(Args)...);
+    NewBuffer->GetStateTracker().SetState(InitialState);
+
+    if (InitialData && InitialData->GetData())
+    {
+        const uint32 CopySize = Math::Min(InitialData->GetSizeInBytes(), SizeInBytes);
+        Memory::Memcpy(NewBuffer->GetData(), InitialData->GetData(), CopySize);
+    }
+
+    return NewBuffer;
+}
+
+VertexBuffer* NullRenderLayer::CreateVertexBuffer(uint32 Stride, uint32 NumVertices, uint32 Flags, EResourceState InitialState, const ResourceData* InitialData)
+{
+    const uint32 SizeInBytes = NumVertices * Stride;
+    return CreateBuffer<NullVertexBuffer>(SizeInBytes, InitialState, InitialData, NumVertices, Stride, Flags);
+}
+
+IndexBuffer* NullRenderLayer::CreateIndexBuffer(EIndexFormat Format, uint32 NumIndices, uint32 Flags, EResourceState InitialState, const ResourceData* InitialData)
+{
+    const uint32 SizeInBytes = NumIndices * GetStrideFromIndexFormat(Format);
+    return CreateBuffer<NullIndexBuffer>(SizeInBytes, InitialState, InitialData, Format, NumIndices, Flags);
+}
+
+ConstantBuffer* NullRenderLayer::CreateConstantBuffer(uint32 Size, uint32 Flags, EResourceState InitialState, const ResourceData* InitialData)
+{
+    return CreateBuffer<NullConstantBuffer>(Size, InitialState, InitialData, Size, Flags);
+}
+
+StructuredBuffer* NullRenderLayer::CreateStructuredBuffer(uint32 Stride, uint32 NumElements, uint32 Flags, EResourceState InitialState, const ResourceData* InitialData)
+{
+    const uint32 SizeInBytes = NumElements * Stride;
+    return CreateBuffer<NullStructuredBuffer>(SizeInBytes, InitialState, InitialData, NumElements, Stride, Flags);
+}
+
+RayTracingScene* NullRenderLayer::CreateRayTracingScene(uint32 Flags, RayTracingGeometryInstance* Instances, uint32 NumInstances)
+{
+    return DBG_NEW NullRayTracingScene(Flags);
+}
+
+RayTracingGeometry* NullRenderLayer::CreateRayTracingGeometry(uint32 Flags, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer, EFormat VertexFormat)
+{
+    return DBG_NEW NullRayTracingGeometry(Flags, VertexFormat);
+}
+
+ShaderResourceView* NullRenderLayer::CreateShaderResourceView(const ShaderResourceViewCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullShaderResourceView();
+}
+
+UnorderedAccessView* NullRenderLayer::CreateUnorderedAccessView(const UnorderedAccessViewCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullUnorderedAccessView();
+}
+
+RenderTargetView* NullRenderLayer::CreateRenderTargetView(const RenderTargetViewCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullRenderTargetView();
+}
+
+DepthStencilView* NullRenderLayer::CreateDepthStencilView(const DepthStencilViewCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullDepthStencilView();
+}
+
+ComputeShader* NullRenderLayer::CreateComputeShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullComputeShader();
+}
+
+VertexShader* NullRenderLayer::CreateVertexShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullVertexShader();
+}
+
+HullShader* NullRenderLayer::CreateHullShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullHullShader();
+}
+
+DomainShader* NullRenderLayer::CreateDomainShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullDomainShader();
+}
+
+GeometryShader* NullRenderLayer::CreateGeometryShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullGeometryShader();
+}
+
+MeshShader* NullRenderLayer::CreateMeshShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullMeshShader();
+}
+
+AmplificationShader* NullRenderLayer::CreateAmplificationShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullAmplificationShader();
+}
+
+PixelShader* NullRenderLayer::CreatePixelShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullPixelShader();
+}
+
+RayGenShader* NullRenderLayer::CreateRayGenShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullRayGenShader();
+}
+
+RayAnyHitShader* NullRenderLayer::CreateRayAnyHitShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullRayAnyHitShader();
+}
+
+RayClosestHitShader* NullRenderLayer::CreateRayClosestHitShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullRayClosestHitShader();
+}
+
+RayMissShader* NullRenderLayer::CreateRayMissShader(const TArray<uint8>& ShaderCode)
+{
+    return DBG_NEW NullRayMissShader();
+}
+
+DepthStencilState* NullRenderLayer::CreateDepthStencilState(const DepthStencilStateCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullDepthStencilState();
+}
+
+RasterizerState* NullRenderLayer::CreateRasterizerState(const RasterizerStateCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullRasterizerState();
+}
+
+BlendState* NullRenderLayer::CreateBlendState(const BlendStateCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullBlendState();
+}
+
+InputLayoutState* NullRenderLayer::CreateInputLayout(const InputLayoutStateCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullInputLayoutState();
+}
+
+GraphicsPipelineState* NullRenderLayer::CreateGraphicsPipelineState(const GraphicsPipelineStateCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullGraphicsPipelineState();
+}
+
+ComputePipelineState* NullRenderLayer::CreateComputePipelineState(const ComputePipelineStateCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullComputePipelineState();
+}
+
+RayTracingPipelineState* NullRenderLayer::CreateRayTracingPipelineState(const RayTracingPipelineStateCreateInfo& CreateInfo)
+{
+    return DBG_NEW NullRayTracingPipelineState();
+}
+
+GPUProfiler* NullRenderLayer::CreateProfiler()
+{
+    return DBG_NEW NullGPUProfiler();
+}
+
+Viewport* NullRenderLayer::CreateViewport(GenericWindow* Window, uint32 Width, uint32 Height, EFormat ColorFormat, EFormat DepthFormat)
+{
+    if (Width == 0)
+    {
+        Width = Window ? Window->GetWidth() : NULL_DEFAULT_VIEWPORT_WIDTH;
+    }
+
+    if (Height == 0)
+    {
+        Height = Window ? Window->GetHeight() : NULL_DEFAULT_VIEWPORT_HEIGHT;
+    }
+
+    return DBG_NEW NullViewport(ColorFormat, Width, Height);
+}
+
+void NullRenderLayer::CheckRayTracingSupport(RayTracingSupport& OutSupport)
+{
+    OutSupport.Tier              = ERayTracingTier::NotSupported;
+    OutSupport.MaxRecursionDepth = 0;
+}
+
+void NullRenderLayer::CheckShadingRateSupport(ShadingRateSupport& OutSupport)
+{
+    OutSupport.Tier                     = EShadingRateTier::NotSupported;
+    OutSupport.ShadingRateImageTileSize = 0;
+}
+
+#ifdef COMPILER_VISUAL_STUDIO
+    #pragma warning(pop)
+#endif
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+#include "RenderLayer/GenericRenderLayer.h"
+
+#include "NullCommandContext.h"
+
+/*
+* RenderLayer that does not use any graphics API. All resources are created in system memory and the commands are 
+* validated and counted by the NullCommandContext. This makes it possible to run the renderer headless, which is 
+* used to benchmark and profile the CPU-side of the renderer without being limited by the GPU or driver.
+*/
+
+class NullRenderLayer : public GenericRenderLayer
+{
+public:
+    NullRenderLayer();
+    ~NullRenderLayer();
+
+    virtual bool Init(bool EnableDebug) override final;
+
+    virtual Texture2D* CreateTexture2D(
+        EFormat Format,
+        uint32 Width,
+        uint32 Height,
+        uint32 NumMips,
+        uint32 NumSamples,
+        uint32 Flags,
+        EResourceState InitialState,
+        const ResourceData* InitalData,
+        const ClearValue& OptimizedClearValue) override final;
+
+    virtual Texture2DArray* CreateTexture2DArray(
+        EFormat Format,
+        uint32 Width,
+        uint32 Height,
+        uint32 NumMips,
+        uint32 NumSamples,
+        uint32 NumArraySlices,
+        uint32 Flags,
+        EResourceState InitialState,
+        const ResourceData* InitalData,
+        const ClearValue& OptimizedClearValue) override final;
+
+    virtual TextureCube* CreateTextureCube(
+        EFormat Format,
+        uint32 Size,
+        uint32 NumMips,
+        uint32 Flags,
+        EResourceState InitialState,
+        const ResourceData* InitalData,
+        const ClearValue& OptimizedClearValue) override final;
+
+    virtual TextureCubeArray* CreateTextureCubeArray(
+        EFormat Format,
+        uint32 Size,
+        uint32 NumMips,
+        uint32 NumArraySlices,
+        uint32 Flags,
+        EResourceState InitialState,
+        const ResourceData* InitalData,
+        const ClearValue& OptimizedClearValue) override final;
+
+    virtual Texture3D* CreateTexture3D(
+        EFormat Format,
+        uint32 Width,
+        uint32 Height,
+        uint32 Depth,
+        uint32 NumMips,
+        uint32 Flags,
+        EResourceState InitialState,
+        const ResourceData* InitalData,
+        const ClearValue& OptimizedClearValue) override final;
+
+    virtual class SamplerState* CreateSamplerState(const struct SamplerStateCreateInfo& CreateInfo) override final;
+
+    virtual VertexBuffer* CreateVertexBuffer(uint32 Stride, uint32 NumVertices, uint32 Flags, EResourceState InitialState, const ResourceData* InitalData) override final;
+    virtual IndexBuffer* CreateIndexBuffer(EIndexFormat Format, uint32 NumIndices, uint32 Flags, EResourceState InitialState, const ResourceData* InitalData) override final;
+    virtual ConstantBuffer* CreateConstantBuffer(uint32 Size, uint32 Flags, EResourceState InitialState, const ResourceData* InitalData) override final;
+    virtual StructuredBuffer* CreateStructuredBuffer(uint32 Stride, uint32 NumElements, uint32 Flags, EResourceState InitialState, const ResourceData* InitalData) override final;
+
+    virtual RayTracingScene* CreateRayTracingScene(uint32 Flags, RayTracingGeometryInstance* Instances, uint32 NumInstances) override final;
+    virtual RayTracingGeometry* CreateRayTracingGeometry(uint32 Flags, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer, EFormat VertexFormat) override final;
+
+    virtual ShaderResourceView* CreateShaderResourceView(const ShaderResourceViewCreateInfo& CreateInfo) override final;
+    virtual UnorderedAccessView* CreateUnorderedAccessView(const UnorderedAccessViewCreateInfo& CreateInfo) override final;
+    virtual RenderTargetView* CreateRenderTargetView(const RenderTargetViewCreateInfo& CreateInfo) override final;
+    virtual DepthStencilView* CreateDepthStencilView(const DepthStencilViewCreateInfo& CreateInfo) override final;
+
+    virtual class ComputeShader* CreateComputeShader(const TArray<uint8>& ShaderCode) override final;
+
+    virtual class VertexShader* CreateVertexShader(const TArray<uint8>& ShaderCode) override final;
+    virtual class HullShader* CreateHullShader(const TArray<uint8>& ShaderCode) override final;
+    virtual class DomainShader* CreateDomainShader(const TArray<uint8>& ShaderCode) override final;
+    virtual class GeometryShader* CreateGeometryShader(const TArray<uint8>& ShaderCode) override final;
+    virtual class MeshShader* CreateMeshShader(const TArray<uint8>& ShaderCode) override final;
+    virtual class AmplificationShader* CreateAmplificationShader(const TArray<uint8>& ShaderCode) override final;
+    virtual class PixelShader* CreatePixelShader(const TArray<uint8>& ShaderCode) override final;
+
+    virtual class RayGenShader* CreateRayGenShader(const TArray<uint8>& ShaderCode) override final;
+    virtual class RayAnyHitShader* CreateRayAnyHitShader(const TArray<uint8>& ShaderCode) override final;
+    virtual class RayClosestHitShader* CreateRayClosestHitShader(const TArray<uint8>& ShaderCode) override final;
+    virtual class RayMissShader* CreateRayMissShader(const TArray<uint8>& ShaderCode) override final;
+
+    virtual class DepthStencilState* CreateDepthStencilState(const DepthStencilStateCreateInfo& CreateInfo) override final;
+    virtual class RasterizerState* CreateRasterizerState(const RasterizerStateCreateInfo& CreateInfo) override final;
+    virtual class BlendState* CreateBlendState(const BlendStateCreateInfo& CreateInfo) override final;
+    virtual class InputLayoutState* CreateInputLayout(const InputLayoutStateCreateInfo& CreateInfo) override final;
+
+    virtual class GraphicsPipelineState* CreateGraphicsPipelineState(const GraphicsPipelineStateCreateInfo& CreateInfo) override final;
+    virtual class ComputePipelineState* CreateComputePipelineState(const ComputePipelineStateCreateInfo& CreateInfo) override final;
+    virtual class RayTracingPipelineState* CreateRayTracingPipelineState(const RayTracingPipelineStateCreateInfo& CreateInfo) override final;
+
+    virtual class GPUProfiler* CreateProfiler() override final;
+
+    virtual class Viewport* CreateViewport(GenericWindow* Window, uint32 Width, uint32 Height, EFormat ColorFormat, EFormat DepthFormat) override final;
+
+    virtual class ICommandContext* GetDefaultCommandContext() override final
+    {
+        return DirectCmdContext.Get();
+    }
+
+    virtual std::string GetAdapterName() override final
+    {
+        return "Null";
+    }
+
+    virtual void CheckRayTracingSupport(RayTracingSupport& OutSupport) override final;
+    virtual void CheckShadingRateSupport(ShadingRateSupport& OutSupport) override final;
+
+    virtual bool UAVSupportsFormat(EFormat Format) override final
+    {
+        UNREFERENCED_VARIABLE(Format);
+        return true;
+    }
+
+    const NullCommandContextStatistics& GetStatistics() const { return DirectCmdContext->GetStatistics(); }
+
+private:
+    template<typename TNullBufferType, typename... TBufferArgs>
+    TNullBufferType* CreateBuffer(uint32 SizeInBytes, EResourceState InitialState, const ResourceData* InitialData, TBufferArgs&&... Args);
+
+    TRef<NullCommandContext> DirectCmdContext;
+};
\ No newline at end of file
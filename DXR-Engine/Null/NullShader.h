@@ -0,0 +1,50 @@
+#pragma once
+#include "RenderLayer/Shader.h"
+
+#ifdef COMPILER_VISUAL_STUDIO
+    #pragma warning(push)
+    #pragma warning(disable : 4100) // Disable unreferenced variable
+#endif
+
+// Shaders in the NullRenderLayer has no reflection data, all parameter lookups fail
+template<typename TBaseShader>
+class TNullShader : public TBaseShader
+{
+public:
+    TNullShader() = default;
+    ~TNullShader() = default;
+
+    virtual void GetShaderParameterInfo(ShaderParameterInfo& OutShaderParameterInfo) const override
+    {
+        OutShaderParameterInfo = ShaderParameterInfo();
+    }
+
+    virtual bool GetConstantBufferIndexByName(const std::string& InName, uint32& OutIndex) const override      { return false; }
+    virtual bool GetUnorderedAccessViewIndexByName(const std::string& InName, uint32& OutIndex) const override { return false; }
+    virtual bool GetShaderResourceViewIndexByName(const std::string& InName, uint32& OutIndex) const override  { return false; }
+    virtual bool GetSamplerIndexByName(const std::string& InName, uint32& OutIndex) const override             { return false; }
+
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullComputeShader : public TNullShader<ComputeShader>
+{
+public:
+    virtual XMUINT3 GetThreadGroupXYZ() const override { return XMUINT3(1, 1, 1); }
+};
+
+using NullVertexShader        = TNullShader<VertexShader>;
+using NullHullShader          = TNullShader<HullShader>;
+using NullDomainShader        = TNullShader<DomainShader>;
+using NullGeometryShader      = TNullShader<GeometryShader>;
+using NullMeshShader          = TNullShader<MeshShader>;
+using NullAmplificationShader = TNullShader<AmplificationShader>;
+using NullPixelShader         = TNullShader<PixelShader>;
+using NullRayGenShader        = TNullShader<RayGenShader>;
+using NullRayAnyHitShader     = TNullShader<RayAnyHitShader>;
+using NullRayClosestHitShader = TNullShader<RayClosestHitShader>;
+using NullRayMissShader       = TNullShader<RayMissShader>;
+
+#ifdef COMPILER_VISUAL_STUDIO
+    #pragma warning(pop)
+#endif
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include "RenderLayer/ShaderCompiler.h"
+
+#ifdef COMPILER_VISUAL_STUDIO
+    #pragma warning(push)
+    #pragma warning(disable : 4100) // Disable unreferenced variable
+#endif
+
+// Shaders are never executed by the NullRenderLayer so compilation always succeeds with empty bytecode
+class NullShaderCompiler : public IShaderCompiler
+{
+public:
+    NullShaderCompiler()  = default;
+    ~NullShaderCompiler() = default;
+
+    virtual bool CompileFromFile(
+        const std::string& FilePath,
+        const std::string& EntryPoint,
+        const TArray<ShaderDefine>* Defines,
+        EShaderStage ShaderStage,
+        EShaderModel ShaderModel,
+        TArray<uint8>& Code) override
+    {
+        Code.Clear();
+        return true;
+    }
+
+    virtual bool CompileShader(
+        const std::string& ShaderSource,
+        const std::string& EntryPoint,
+        const TArray<ShaderDefine>* Defines,
+        EShaderStage ShaderStage,
+        EShaderModel ShaderModel,
+        TArray<uint8>& Code) override
+    {
+        Code.Clear();
+        return true;
+    }
+};
+
+#ifdef COMPILER_VISUAL_STUDIO
+    #pragma warning(pop)
+#endif
\ No newline at end of file
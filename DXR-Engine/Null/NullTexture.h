@@ -0,0 +1,69 @@
+#pragma once
+#include "RenderLayer/Resources.h"
+
+#include "NullViews.h"
+
+template<typename TBaseTexture>
+class TNullTexture : public TBaseTexture
+{
+public:
+    template<typename... TTextureArgs>
+    TNullTexture(TTextureArgs&&... Args)
+        : TBaseTexture(Forward<TTextureArgs>(Args)...)
+        , ShaderResourceView(nullptr)
+    {
+        if (TBaseTexture::IsSRV())
+        {
+            ShaderResourceView = DBG_NEW NullShaderResourceView();
+        }
+    }
+
+    virtual ShaderResourceView* GetShaderResourceView() const override { return ShaderResourceView.Get(); }
+
+    virtual bool IsValid() const override { return true; }
+
+private:
+    TRef<NullShaderResourceView> ShaderResourceView;
+};
+
+template<typename TBaseTexture2D>
+class TNullTexture2D : public TNullTexture<TBaseTexture2D>
+{
+public:
+    template<typename... TTextureArgs>
+    TNullTexture2D(TTextureArgs&&... Args)
+        : TNullTexture<TBaseTexture2D>(Forward<TTextureArgs>(Args)...)
+        , RenderTargetView(nullptr)
+        , DepthStencilView(nullptr)
+        , UnorderedAccessView(nullptr)
+    {
+        const uint32 Flags = TBaseTexture2D::GetFlags();
+        if ((Flags & TextureFlag_RTV) && !(Flags & TextureFlag_NoDefaultRTV))
+        {
+            RenderTargetView = DBG_NEW NullRenderTargetView();
+        }
+        if ((Flags & TextureFlag_DSV) && !(Flags & TextureFlag_NoDefaultDSV))
+        {
+            DepthStencilView = DBG_NEW NullDepthStencilView();
+        }
+        if (TBaseTexture2D::IsUAV())
+        {
+            UnorderedAccessView = DBG_NEW NullUnorderedAccessView();
+        }
+    }
+
+    virtual RenderTargetView*    GetRenderTargetView()    const override { return RenderTargetView.Get(); }
+    virtual DepthStencilView*    GetDepthStencilView()    const override { return DepthStencilView.Get(); }
+    virtual UnorderedAccessView* GetUnorderedAccessView() const override { return UnorderedAccessView.Get(); }
+
+private:
+    TRef<NullRenderTargetView>    RenderTargetView;
+    TRef<NullDepthStencilView>    DepthStencilView;
+    TRef<NullUnorderedAccessView> UnorderedAccessView;
+};
+
+using NullTexture2D        = TNullTexture2D<Texture2D>;
+using NullTexture2DArray   = TNullTexture2D<Texture2DArray>;
+using NullTextureCube      = TNullTexture<TextureCube>;
+using NullTextureCubeArray = TNullTexture<TextureCubeArray>;
+using NullTexture3D        = TNullTexture<Texture3D>;
\ No newline at end of file
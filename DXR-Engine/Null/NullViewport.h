@@ -0,0 +1,47 @@
+#pragma once
+#include "RenderLayer/Viewport.h"
+
+#include "NullTexture.h"
+
+class NullViewport : public Viewport
+{
+public:
+    NullViewport(EFormat InFormat, uint32 InWidth, uint32 InHeight)
+        : Viewport(InFormat, InWidth, InHeight)
+        , BackBuffer(nullptr)
+    {
+        CreateBackBuffer();
+    }
+
+    virtual bool Resize(uint32 InWidth, uint32 InHeight) override
+    {
+        if (InWidth != Width || InHeight != Height)
+        {
+            Width  = InWidth;
+            Height = InHeight;
+            CreateBackBuffer();
+        }
+
+        return true;
+    }
+
+    virtual bool Present(bool VerticalSync) override
+    {
+        UNREFERENCED_VARIABLE(VerticalSync);
+        return true;
+    }
+
+    virtual RenderTargetView* GetRenderTargetView() const override { return BackBuffer->GetRenderTargetView(); }
+    virtual Texture2D* GetBackBuffer() const override { return BackBuffer.Get(); }
+
+    virtual bool IsValid() const override { return true; }
+
+private:
+    void CreateBackBuffer()
+    {
+        BackBuffer = DBG_NEW NullTexture2D(Format, Width, Height, 1, 1, TextureFlag_RTV, ClearValue());
+        BackBuffer->SetName("NullViewport BackBuffer");
+    }
+
+    TRef<NullTexture2D> BackBuffer;
+};
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+#include "RenderLayer/ResourceViews.h"
+
+// Views in the NullRenderLayer does not reference any memory, they only exist so that the renderer can bind them
+
+class NullShaderResourceView : public ShaderResourceView
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullUnorderedAccessView : public UnorderedAccessView
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullRenderTargetView : public RenderTargetView
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
+
+class NullDepthStencilView : public DepthStencilView
+{
+public:
+    virtual bool IsValid() const override { return true; }
+};
\ No newline at end of file
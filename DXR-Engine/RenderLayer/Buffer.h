@@ -1,5 +1,6 @@
 #pragma once
 #include "ResourceBase.h"
+#include "ResourceState.h"
 
 enum class EIndexFormat
 {
@@ -65,6 +66,7 @@ public:
     Buffer(uint32 InFlags)
         : Resource()
         , Flags(InFlags)
+        , StateTracker()
     {
     }
 
@@ -82,8 +84,13 @@ public:
     bool IsUAV() const    { return (Flags & BufferFlag_UAV); }
     bool IsSRV() const    { return (Flags & BufferFlag_SRV); }
 
+    // The state is updated by the RenderLayer when a transition is executed
+    ResourceStateTracker& GetStateTracker() { return StateTracker; }
+    const ResourceStateTracker& GetStateTracker() const { return StateTracker; }
+
 private:
     uint32 Flags;
+    ResourceStateTracker StateTracker;
 };
 
 class VertexBuffer : public Buffer
@@ -5,7 +5,26 @@ CommandListExecutor GCmdListExecutor;
 void CommandListExecutor::ExecuteCommandList(CommandList& CmdList)
 {
     Assert(CmdList.IsRecording == false);
+    InternalExecuteCommandList(CmdList);
+}
+
+void CommandListExecutor::ExecuteCommandLists(CommandList* const* CmdLists, uint32 NumCmdLists)
+{
+    ICommandContext& Context = GetContext();
+    Context.Begin();
 
+    for (uint32 i = 0; i < NumCmdLists; i++)
+    {
+        Assert(CmdLists[i] != nullptr);
+        Assert(CmdLists[i]->IsRecording == false);
+        InternalExecuteCommandList(*CmdLists[i]);
+    }
+
+    Context.End();
+}
+
+void CommandListExecutor::InternalExecuteCommandList(CommandList& CmdList)
+{
     RenderCommand* Cmd = CmdList.First;
     while (Cmd != nullptr)
     {
@@ -304,7 +304,8 @@ public:
     {
         Assert(Destination != nullptr);
 
-        const uint32 SizeInBytes = Width * Height * GetByteStrideFromFormat(Destination->GetFormat());
+        const EFormat Format     = Destination->GetFormat();
+        const uint32 SizeInBytes = GetRowPitchFromFormat(Format, Width) * GetNumRowsFromFormat(Format, Height);
 
         void* TempSourceData = CmdAllocator.Allocate(SizeInBytes, 1);
         Memory::Memcpy(TempSourceData, SourceData, SizeInBytes);
@@ -368,30 +369,22 @@ public:
         InsertCommand<GenerateMipsRenderCommand>(Texture);
     }
 
-    void TransitionTexture(Texture* Texture, EResourceState BeforeState, EResourceState AfterState)
+    // The current state of the resource is known when the command is executed, which means that a transition into
+    // the state that the resource already is in does not result in a barrier
+    void TransitionTexture(Texture* Texture, EResourceState AfterState, uint32 Subresource = ALL_SUBRESOURCES)
     {
         Assert(Texture != nullptr);
 
-        if (BeforeState != AfterState)
-        {
-            Texture->AddRef();
-            InsertCommand<TransitionTextureRenderCommand>(Texture, BeforeState, AfterState);
-        }
-        else
-        {
-            LOG_WARNING("Texture '" + Texture->GetName() + "' Was transitioned with the same Before- and AfterState (=" + ToString(BeforeState) + ")");
-        }
+        Texture->AddRef();
+        InsertCommand<TransitionTextureRenderCommand>(Texture, AfterState, Subresource);
     }
 
-    void TransitionBuffer(Buffer* Buffer, EResourceState BeforeState, EResourceState AfterState)
+    void TransitionBuffer(Buffer* Buffer, EResourceState AfterState)
     {
         Assert(Buffer != nullptr);
 
-        if (BeforeState != AfterState)
-        {
-            Buffer->AddRef();
-            InsertCommand<TransitionBufferRenderCommand>(Buffer, BeforeState, AfterState);
-        }
+        Buffer->AddRef();
+        InsertCommand<TransitionBufferRenderCommand>(Buffer, AfterState);
     }
 
     void UnorderedAccessTextureBarrier(Texture* Texture)
@@ -538,6 +531,10 @@ class CommandListExecutor
 {
 public:
     void ExecuteCommandList(CommandList& CmdList);
+    
+    // Executes the CommandLists in array order as one batch, the lists should not call Begin or End themselves
+    void ExecuteCommandLists(CommandList* const* CmdLists, uint32 NumCmdLists);
+
     void WaitForGPU();
 
     void SetContext(ICommandContext* InCmdContext)
@@ -553,6 +550,8 @@ public:
     }
 
 private:
+    void InternalExecuteCommandList(CommandList& CmdList);
+
     ICommandContext* CmdContext = nullptr;
 };
 
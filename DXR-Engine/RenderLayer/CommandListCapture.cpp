@@ -0,0 +1,899 @@
+#include "CommandListCapture.h"
+#include "Resources.h"
+#include "ResourceViews.h"
+#include "PipelineState.h"
+#include "SamplerState.h"
+#include "RayTracing.h"
+#include "GPUProfiler.h"
+
+#include <cstdio>
+
+#define FORWARD_COMMAND(Call) \
+    if (ForwardContext) \
+    { \
+        ForwardContext->Call; \
+    }
+
+struct CaptureFileHeader
+{
+    uint32 Magic;
+    uint32 Version;
+    uint32 NumResources;
+    uint32 NumCommands;
+    uint64 StreamSize;
+};
+
+const char* ToString(ECaptureCommand Command)
+{
+    switch (Command)
+    {
+        case ECaptureCommand::Begin:                         return "Begin";
+        case ECaptureCommand::End:                           return "End";
+        case ECaptureCommand::BeginTimeStamp:                return "BeginTimeStamp";
+        case ECaptureCommand::EndTimeStamp:                  return "EndTimeStamp";
+        case ECaptureCommand::ClearRenderTargetView:         return "ClearRenderTargetView";
+        case ECaptureCommand::ClearDepthStencilView:         return "ClearDepthStencilView";
+        case ECaptureCommand::ClearUnorderedAccessViewFloat: return "ClearUnorderedAccessViewFloat";
+        case ECaptureCommand::SetShadingRate:                return "SetShadingRate";
+        case ECaptureCommand::SetShadingRateImage:           return "SetShadingRateImage";
+        case ECaptureCommand::BeginRenderPass:               return "BeginRenderPass";
+        case ECaptureCommand::EndRenderPass:                 return "EndRenderPass";
+        case ECaptureCommand::SetViewport:                   return "SetViewport";
+        case ECaptureCommand::SetScissorRect:                return "SetScissorRect";
+        case ECaptureCommand::SetBlendFactor:                return "SetBlendFactor";
+        case ECaptureCommand::SetRenderTargets:              return "SetRenderTargets";
+        case ECaptureCommand::SetVertexBuffers:              return "SetVertexBuffers";
+        case ECaptureCommand::SetIndexBuffer:                return "SetIndexBuffer";
+        case ECaptureCommand::SetPrimitiveTopology:          return "SetPrimitiveTopology";
+        case ECaptureCommand::SetGraphicsPipelineState:      return "SetGraphicsPipelineState";
+        case ECaptureCommand::SetComputePipelineState:       return "SetComputePipelineState";
+        case ECaptureCommand::Set32BitShaderConstants:       return "Set32BitShaderConstants";
+        case ECaptureCommand::SetShaderResourceView:         return "SetShaderResourceView";
+        case ECaptureCommand::SetShaderResourceViews:        return "SetShaderResourceViews";
+        case ECaptureCommand::SetUnorderedAccessView:        return "SetUnorderedAccessView";
+        case ECaptureCommand::SetUnorderedAccessViews:       return "SetUnorderedAccessViews";
+        case ECaptureCommand::SetConstantBuffer:             return "SetConstantBuffer";
+        case ECaptureCommand::SetConstantBuffers:            return "SetConstantBuffers";
+        case ECaptureCommand::SetSamplerState:               return "SetSamplerState";
+        case ECaptureCommand::SetSamplerStates:              return "SetSamplerStates";
+        case ECaptureCommand::UpdateBuffer:                  return "UpdateBuffer";
+        case ECaptureCommand::UpdateTexture2D:               return "UpdateTexture2D";
+        case ECaptureCommand::ResolveTexture:                return "ResolveTexture";
+        case ECaptureCommand::CopyBuffer:                    return "CopyBuffer";
+        case ECaptureCommand::CopyTexture:                   return "CopyTexture";
+        case ECaptureCommand::CopyTextureRegion:             return "CopyTextureRegion";
+        case ECaptureCommand::DiscardResource:               return "DiscardResource";
+        case ECaptureCommand::BuildRayTracingGeometry:       return "BuildRayTracingGeometry";
+        case ECaptureCommand::BuildRayTracingScene:          return "BuildRayTracingScene";
+        case ECaptureCommand::SetRayTracingBindings:         return "SetRayTracingBindings";
+        case ECaptureCommand::GenerateMips:                  return "GenerateMips";
+        case ECaptureCommand::TransitionTexture:             return "TransitionTexture";
+        case ECaptureCommand::TransitionBuffer:              return "TransitionBuffer";
+        case ECaptureCommand::UnorderedAccessTextureBarrier: return "UnorderedAccessTextureBarrier";
+        case ECaptureCommand::UnorderedAccessBufferBarrier:  return "UnorderedAccessBufferBarrier";
+        case ECaptureCommand::Draw:                          return "Draw";
+        case ECaptureCommand::DrawIndexed:                   return "DrawIndexed";
+        case ECaptureCommand::DrawInstanced:                 return "DrawInstanced";
+        case ECaptureCommand::DrawIndexedInstanced:          return "DrawIndexedInstanced";
+        case ECaptureCommand::Dispatch:                      return "Dispatch";
+        case ECaptureCommand::DispatchRays:                  return "DispatchRays";
+        case ECaptureCommand::ClearState:                    return "ClearState";
+        case ECaptureCommand::Flush:                         return "Flush";
+        case ECaptureCommand::InsertMarker:                  return "InsertMarker";
+        case ECaptureCommand::BeginExternalCapture:          return "BeginExternalCapture";
+        case ECaptureCommand::EndExternalCapture:            return "EndExternalCapture";
+        default: return "Unknown";
+    }
+}
+
+const char* ToString(ECaptureResourceType ResourceType)
+{
+    switch (ResourceType)
+    {
+        case ECaptureResourceType::Texture2D:               return "Texture2D";
+        case ECaptureResourceType::Texture2DArray:          return "Texture2DArray";
+        case ECaptureResourceType::TextureCube:             return "TextureCube";
+        case ECaptureResourceType::TextureCubeArray:        return "TextureCubeArray";
+        case ECaptureResourceType::Texture3D:               return "Texture3D";
+        case ECaptureResourceType::VertexBuffer:            return "VertexBuffer";
+        case ECaptureResourceType::IndexBuffer:             return "IndexBuffer";
+        case ECaptureResourceType::ConstantBuffer:          return "ConstantBuffer";
+        case ECaptureResourceType::StructuredBuffer:        return "StructuredBuffer";
+        case ECaptureResourceType::ShaderResourceView:      return "ShaderResourceView";
+        case ECaptureResourceType::UnorderedAccessView:     return "UnorderedAccessView";
+        case ECaptureResourceType::RenderTargetView:        return "RenderTargetView";
+        case ECaptureResourceType::DepthStencilView:        return "DepthStencilView";
+        case ECaptureResourceType::Shader:                  return "Shader";
+        case ECaptureResourceType::SamplerState:            return "SamplerState";
+        case ECaptureResourceType::GraphicsPipelineState:   return "GraphicsPipelineState";
+        case ECaptureResourceType::ComputePipelineState:    return "ComputePipelineState";
+        case ECaptureResourceType::RayTracingPipelineState: return "RayTracingPipelineState";
+        case ECaptureResourceType::RayTracingGeometry:      return "RayTracingGeometry";
+        case ECaptureResourceType::RayTracingScene:         return "RayTracingScene";
+        case ECaptureResourceType::GPUProfiler:             return "GPUProfiler";
+        default: return "Unknown";
+    }
+}
+
+/*
+* CommandListCapture
+*/
+
+bool CommandListCapture::SaveToFile(const std::string& Filename) const
+{
+    FILE* File = fopen(Filename.c_str(), "wb");
+    if (!File)
+    {
+        LOG_ERROR("[CommandListCapture]: Failed to open '" + Filename + "' for writing");
+        return false;
+    }
+
+    CaptureFileHeader Header;
+    Header.Magic        = COMMAND_LIST_CAPTURE_MAGIC;
+    Header.Version      = COMMAND_LIST_CAPTURE_VERSION;
+    Header.NumResources = Resources.Size();
+    Header.NumCommands  = NumCommands;
+    Header.StreamSize   = Stream.Size();
+    fwrite(&Header, sizeof(CaptureFileHeader), 1, File);
+
+    for (const CaptureResourceDesc& Desc : Resources)
+    {
+        fwrite(&Desc.Type, sizeof(Desc.Type), 1, File);
+        fwrite(&Desc.Format, sizeof(Desc.Format), 1, File);
+        fwrite(&Desc.Width, sizeof(uint32), 1, File);
+        fwrite(&Desc.Height, sizeof(uint32), 1, File);
+        fwrite(&Desc.DepthOrArraySize, sizeof(uint32), 1, File);
+        fwrite(&Desc.NumMips, sizeof(uint32), 1, File);
+        fwrite(&Desc.NumSamples, sizeof(uint32), 1, File);
+        fwrite(&Desc.Flags, sizeof(uint32), 1, File);
+        fwrite(&Desc.Stride, sizeof(uint32), 1, File);
+
+        const uint32 NameLength = uint32(Desc.Name.size());
+        fwrite(&NameLength, sizeof(uint32), 1, File);
+        fwrite(Desc.Name.data(), 1, NameLength, File);
+    }
+
+    fwrite(Stream.Data(), 1, Stream.Size(), File);
+
+    const bool Result = ferror(File) == 0;
+    fclose(File);
+
+    if (!Result)
+    {
+        LOG_ERROR("[CommandListCapture]: Failed to write '" + Filename + "'");
+    }
+
+    return Result;
+}
+
+bool CommandListCapture::LoadFromFile(const std::string& Filename)
+{
+    Reset();
+
+    FILE* File = fopen(Filename.c_str(), "rb");
+    if (!File)
+    {
+        LOG_ERROR("[CommandListCapture]: Failed to open '" + Filename + "'");
+        return false;
+    }
+
+    fseek(File, 0, SEEK_END);
+    const long FileSize = ftell(File);
+    fseek(File, 0, SEEK_SET);
+
+    TArray<uint8> FileData(uint32(FileSize > 0 ? FileSize : 0));
+    const size_t BytesRead = fread(FileData.Data(), 1, FileData.Size(), File);
+    fclose(File);
+
+    if (BytesRead != FileData.Size())
+    {
+        LOG_ERROR("[CommandListCapture]: Failed to read '" + Filename + "'");
+        return false;
+    }
+
+    CaptureStreamReader Reader(FileData.Data(), FileData.Size());
+
+    const CaptureFileHeader Header = Reader.Read<CaptureFileHeader>();
+    if (Header.Magic != COMMAND_LIST_CAPTURE_MAGIC || Header.Version != COMMAND_LIST_CAPTURE_VERSION)
+    {
+        LOG_ERROR("[CommandListCapture]: '" + Filename + "' is not a capture or has an unsupported version");
+        return false;
+    }
+
+    Resources.Resize(Header.NumResources);
+    for (CaptureResourceDesc& Desc : Resources)
+    {
+        Desc.Type             = Reader.Read<ECaptureResourceType>();
+        Desc.Format           = Reader.Read<EFormat>();
+        Desc.Width            = Reader.Read<uint32>();
+        Desc.Height           = Reader.Read<uint32>();
+        Desc.DepthOrArraySize = Reader.Read<uint32>();
+        Desc.NumMips          = Reader.Read<uint32>();
+        Desc.NumSamples       = Reader.Read<uint32>();
+        Desc.Flags            = Reader.Read<uint32>();
+        Desc.Stride           = Reader.Read<uint32>();
+        Desc.Name             = Reader.ReadString();
+    }
+
+    const uint8* StreamData = reinterpret_cast<const uint8*>(Reader.ReadPayload(Header.StreamSize));
+    if (Reader.HasErrors() || !StreamData)
+    {
+        LOG_ERROR("[CommandListCapture]: '" + Filename + "' is truncated");
+        Reset();
+        return false;
+    }
+
+    Stream.Resize(uint32(Header.StreamSize));
+    Memory::Memcpy(Stream.Data(), StreamData, Header.StreamSize);
+    NumCommands = Header.NumCommands;
+    return true;
+}
+
+/*
+* CaptureCommandContext
+*/
+
+void CaptureCommandContext::Begin()
+{
+    WriteCommand(ECaptureCommand::Begin);
+    FORWARD_COMMAND(Begin());
+}
+
+void CaptureCommandContext::End()
+{
+    WriteCommand(ECaptureCommand::End);
+    FORWARD_COMMAND(End());
+}
+
+void CaptureCommandContext::BeginTimeStamp(GPUProfiler* Profiler, uint32 Index)
+{
+    WriteCommand(ECaptureCommand::BeginTimeStamp);
+    WriteResource(Profiler, ECaptureResourceType::GPUProfiler);
+    Write(Index);
+    FORWARD_COMMAND(BeginTimeStamp(Profiler, Index));
+}
+
+void CaptureCommandContext::EndTimeStamp(GPUProfiler* Profiler, uint32 Index)
+{
+    WriteCommand(ECaptureCommand::EndTimeStamp);
+    WriteResource(Profiler, ECaptureResourceType::GPUProfiler);
+    Write(Index);
+    FORWARD_COMMAND(EndTimeStamp(Profiler, Index));
+}
+
+void CaptureCommandContext::ClearRenderTargetView(RenderTargetView* RenderTargetView, const ColorF& ClearColor)
+{
+    WriteCommand(ECaptureCommand::ClearRenderTargetView);
+    WriteResource(RenderTargetView, ECaptureResourceType::RenderTargetView);
+    Write(ClearColor);
+    FORWARD_COMMAND(ClearRenderTargetView(RenderTargetView, ClearColor));
+}
+
+void CaptureCommandContext::ClearDepthStencilView(DepthStencilView* DepthStencilView, const DepthStencilF& ClearValue)
+{
+    WriteCommand(ECaptureCommand::ClearDepthStencilView);
+    WriteResource(DepthStencilView, ECaptureResourceType::DepthStencilView);
+    Write(ClearValue.Depth);
+    Write(ClearValue.Stencil);
+    FORWARD_COMMAND(ClearDepthStencilView(DepthStencilView, ClearValue));
+}
+
+void CaptureCommandContext::ClearUnorderedAccessViewFloat(UnorderedAccessView* UnorderedAccessView, const ColorF& ClearColor)
+{
+    WriteCommand(ECaptureCommand::ClearUnorderedAccessViewFloat);
+    WriteResource(UnorderedAccessView, ECaptureResourceType::UnorderedAccessView);
+    Write(ClearColor);
+    FORWARD_COMMAND(ClearUnorderedAccessViewFloat(UnorderedAccessView, ClearColor));
+}
+
+void CaptureCommandContext::SetShadingRate(EShadingRate ShadingRate)
+{
+    WriteCommand(ECaptureCommand::SetShadingRate);
+    Write(ShadingRate);
+    FORWARD_COMMAND(SetShadingRate(ShadingRate));
+}
+
+void CaptureCommandContext::SetShadingRateImage(Texture2D* ShadingImage)
+{
+    WriteCommand(ECaptureCommand::SetShadingRateImage);
+    WriteResource(ShadingImage, ECaptureResourceType::Texture2D);
+    FORWARD_COMMAND(SetShadingRateImage(ShadingImage));
+}
+
+void CaptureCommandContext::BeginRenderPass()
+{
+    WriteCommand(ECaptureCommand::BeginRenderPass);
+    FORWARD_COMMAND(BeginRenderPass());
+}
+
+void CaptureCommandContext::EndRenderPass()
+{
+    WriteCommand(ECaptureCommand::EndRenderPass);
+    FORWARD_COMMAND(EndRenderPass());
+}
+
+void CaptureCommandContext::SetViewport(float Width, float Height, float MinDepth, float MaxDepth, float x, float y)
+{
+    WriteCommand(ECaptureCommand::SetViewport);
+    Write(Width);
+    Write(Height);
+    Write(MinDepth);
+    Write(MaxDepth);
+    Write(x);
+    Write(y);
+    FORWARD_COMMAND(SetViewport(Width, Height, MinDepth, MaxDepth, x, y));
+}
+
+void CaptureCommandContext::SetScissorRect(float Width, float Height, float x, float y)
+{
+    WriteCommand(ECaptureCommand::SetScissorRect);
+    Write(Width);
+    Write(Height);
+    Write(x);
+    Write(y);
+    FORWARD_COMMAND(SetScissorRect(Width, Height, x, y));
+}
+
+void CaptureCommandContext::SetBlendFactor(const ColorF& Color)
+{
+    WriteCommand(ECaptureCommand::SetBlendFactor);
+    Write(Color);
+    FORWARD_COMMAND(SetBlendFactor(Color));
+}
+
+void CaptureCommandContext::SetRenderTargets(RenderTargetView* const* RenderTargetViews, uint32 RenderTargetCount, DepthStencilView* DepthStencilView)
+{
+    WriteCommand(ECaptureCommand::SetRenderTargets);
+    WriteResourceArray(RenderTargetViews, RenderTargetCount, ECaptureResourceType::RenderTargetView);
+    WriteResource(DepthStencilView, ECaptureResourceType::DepthStencilView);
+    FORWARD_COMMAND(SetRenderTargets(RenderTargetViews, RenderTargetCount, DepthStencilView));
+}
+
+void CaptureCommandContext::SetVertexBuffers(VertexBuffer* const* VertexBuffers, uint32 BufferCount, uint32 BufferSlot)
+{
+    WriteCommand(ECaptureCommand::SetVertexBuffers);
+    WriteResourceArray(VertexBuffers, BufferCount, ECaptureResourceType::VertexBuffer);
+    Write(BufferSlot);
+    FORWARD_COMMAND(SetVertexBuffers(VertexBuffers, BufferCount, BufferSlot));
+}
+
+void CaptureCommandContext::SetIndexBuffer(IndexBuffer* IndexBuffer)
+{
+    WriteCommand(ECaptureCommand::SetIndexBuffer);
+    WriteResource(IndexBuffer, ECaptureResourceType::IndexBuffer);
+    FORWARD_COMMAND(SetIndexBuffer(IndexBuffer));
+}
+
+void CaptureCommandContext::SetPrimitiveTopology(EPrimitiveTopology PrimitveTopologyType)
+{
+    WriteCommand(ECaptureCommand::SetPrimitiveTopology);
+    Write(PrimitveTopologyType);
+    FORWARD_COMMAND(SetPrimitiveTopology(PrimitveTopologyType));
+}
+
+void CaptureCommandContext::SetGraphicsPipelineState(GraphicsPipelineState* PipelineState)
+{
+    WriteCommand(ECaptureCommand::SetGraphicsPipelineState);
+    WriteResource(PipelineState, ECaptureResourceType::GraphicsPipelineState);
+    FORWARD_COMMAND(SetGraphicsPipelineState(PipelineState));
+}
+
+void CaptureCommandContext::SetComputePipelineState(ComputePipelineState* PipelineState)
+{
+    WriteCommand(ECaptureCommand::SetComputePipelineState);
+    WriteResource(PipelineState, ECaptureResourceType::ComputePipelineState);
+    FORWARD_COMMAND(SetComputePipelineState(PipelineState));
+}
+
+void CaptureCommandContext::Set32BitShaderConstants(Shader* Shader, const void* Shader32BitConstants, uint32 Num32BitConstants)
+{
+    WriteCommand(ECaptureCommand::Set32BitShaderConstants);
+    WriteResource(Shader, ECaptureResourceType::Shader);
+    Write(Num32BitConstants);
+    WritePayload(Shader32BitConstants, Num32BitConstants * sizeof(uint32));
+    FORWARD_COMMAND(Set32BitShaderConstants(Shader, Shader32BitConstants, Num32BitConstants));
+}
+
+void CaptureCommandContext::SetShaderResourceView(Shader* Shader, ShaderResourceView* ShaderResourceView, uint32 ParameterIndex)
+{
+    WriteCommand(ECaptureCommand::SetShaderResourceView);
+    WriteResource(Shader, ECaptureResourceType::Shader);
+    WriteResource(ShaderResourceView, ECaptureResourceType::ShaderResourceView);
+    Write(ParameterIndex);
+    FORWARD_COMMAND(SetShaderResourceView(Shader, ShaderResourceView, ParameterIndex));
+}
+
+void CaptureCommandContext::SetShaderResourceViews(Shader* Shader, ShaderResourceView* const* ShaderResourceView, uint32 NumShaderResourceViews, uint32 ParameterIndex)
+{
+    WriteCommand(ECaptureCommand::SetShaderResourceViews);
+    WriteResource(Shader, ECaptureResourceType::Shader);
+    WriteResourceArray(ShaderResourceView, NumShaderResourceViews, ECaptureResourceType::ShaderResourceView);
+    Write(ParameterIndex);
+    FORWARD_COMMAND(SetShaderResourceViews(Shader, ShaderResourceView, NumShaderResourceViews, ParameterIndex));
+}
+
+void CaptureCommandContext::SetUnorderedAccessView(Shader* Shader, UnorderedAccessView* UnorderedAccessView, uint32 ParameterIndex)
+{
+    WriteCommand(ECaptureCommand::SetUnorderedAccessView);
+    WriteResource(Shader, ECaptureResourceType::Shader);
+    WriteResource(UnorderedAccessView, ECaptureResourceType::UnorderedAccessView);
+    Write(ParameterIndex);
+    FORWARD_COMMAND(SetUnorderedAccessView(Shader, UnorderedAccessView, ParameterIndex));
+}
+
+void CaptureCommandContext::SetUnorderedAccessViews(Shader* Shader, UnorderedAccessView* const* UnorderedAccessViews, uint32 NumUnorderedAccessViews, uint32 ParameterIndex)
+{
+    WriteCommand(ECaptureCommand::SetUnorderedAccessViews);
+    WriteResource(Shader, ECaptureResourceType::Shader);
+    WriteResourceArray(UnorderedAccessViews, NumUnorderedAccessViews, ECaptureResourceType::UnorderedAccessView);
+    Write(ParameterIndex);
+    FORWARD_COMMAND(SetUnorderedAccessViews(Shader, UnorderedAccessViews, NumUnorderedAccessViews, ParameterIndex));
+}
+
+void CaptureCommandContext::SetConstantBuffer(Shader* Shader, ConstantBuffer* ConstantBuffer, uint32 ParameterIndex)
+{
+    WriteCommand(ECaptureCommand::SetConstantBuffer);
+    WriteResource(Shader, ECaptureResourceType::Shader);
+    WriteResource(ConstantBuffer, ECaptureResourceType::ConstantBuffer);
+    Write(ParameterIndex);
+    FORWARD_COMMAND(SetConstantBuffer(Shader, ConstantBuffer, ParameterIndex));
+}
+
+void CaptureCommandContext::SetConstantBuffers(Shader* Shader, ConstantBuffer* const* ConstantBuffers, uint32 NumConstantBuffers, uint32 ParameterIndex)
+{
+    WriteCommand(ECaptureCommand::SetConstantBuffers);
+    WriteResource(Shader, ECaptureResourceType::Shader);
+    WriteResourceArray(ConstantBuffers, NumConstantBuffers, ECaptureResourceType::ConstantBuffer);
+    Write(ParameterIndex);
+    FORWARD_COMMAND(SetConstantBuffers(Shader, ConstantBuffers, NumConstantBuffers, ParameterIndex));
+}
+
+void CaptureCommandContext::SetSamplerState(Shader* Shader, SamplerState* SamplerState, uint32 ParameterIndex)
+{
+    WriteCommand(ECaptureCommand::SetSamplerState);
+    WriteResource(Shader, ECaptureResourceType::Shader);
+    WriteResource(SamplerState, ECaptureResourceType::SamplerState);
+    Write(ParameterIndex);
+    FORWARD_COMMAND(SetSamplerState(Shader, SamplerState, ParameterIndex));
+}
+
+void CaptureCommandContext::SetSamplerStates(Shader* Shader, SamplerState* const* SamplerStates, uint32 NumSamplerStates, uint32 ParameterIndex)
+{
+    WriteCommand(ECaptureCommand::SetSamplerStates);
+    WriteResource(Shader, ECaptureResourceType::Shader);
+    WriteResourceArray(SamplerStates, NumSamplerStates, ECaptureResourceType::SamplerState);
+    Write(ParameterIndex);
+    FORWARD_COMMAND(SetSamplerStates(Shader, SamplerStates, NumSamplerStates, ParameterIndex));
+}
+
+void CaptureCommandContext::UpdateBuffer(Buffer* Destination, uint64 OffsetInBytes, uint64 SizeInBytes, const void* SourceData)
+{
+    WriteCommand(ECaptureCommand::UpdateBuffer);
+    WriteResource(Destination, ECaptureResourceType::Unknown);
+    Write(OffsetInBytes);
+    Write(SizeInBytes);
+    WritePayload(SourceData, SizeInBytes);
+    FORWARD_COMMAND(UpdateBuffer(Destination, OffsetInBytes, SizeInBytes, SourceData));
+}
+
+void CaptureCommandContext::UpdateTexture2D(Texture2D* Destination, uint32 Width, uint32 Height, uint32 MipLevel, const void* SourceData)
+{
+    WriteCommand(ECaptureCommand::UpdateTexture2D);
+    WriteResource(Destination, ECaptureResourceType::Texture2D);
+    Write(Width);
+    Write(Height);
+    Write(MipLevel);
+
+    // Same size as the CommandList allocates for the upload
+    const uint64 SizeInBytes = uint64(Width) * uint64(Height) * uint64(GetByteStrideFromFormat(Destination->GetFormat()));
+    Write(SizeInBytes);
+    WritePayload(SourceData, SizeInBytes);
+
+    FORWARD_COMMAND(UpdateTexture2D(Destination, Width, Height, MipLevel, SourceData));
+}
+
+void CaptureCommandContext::ResolveTexture(Texture* Destination, Texture* Source)
+{
+    WriteCommand(ECaptureCommand::ResolveTexture);
+    WriteResource(Destination, ECaptureResourceType::Unknown);
+    WriteResource(Source, ECaptureResourceType::Unknown);
+    FORWARD_COMMAND(ResolveTexture(Destination, Source));
+}
+
+void CaptureCommandContext::CopyBuffer(Buffer* Destination, Buffer* Source, const CopyBufferInfo& CopyInfo)
+{
+    WriteCommand(ECaptureCommand::CopyBuffer);
+    WriteResource(Destination, ECaptureResourceType::Unknown);
+    WriteResource(Source, ECaptureResourceType::Unknown);
+    Write(CopyInfo.SourceOffset);
+    Write(CopyInfo.DestinationOffset);
+    Write(CopyInfo.SizeInBytes);
+    FORWARD_COMMAND(CopyBuffer(Destination, Source, CopyInfo));
+}
+
+void CaptureCommandContext::CopyTexture(Texture* Destination, Texture* Source)
+{
+    WriteCommand(ECaptureCommand::CopyTexture);
+    WriteResource(Destination, ECaptureResourceType::Unknown);
+    WriteResource(Source, ECaptureResourceType::Unknown);
+    FORWARD_COMMAND(CopyTexture(Destination, Source));
+}
+
+void CaptureCommandContext::CopyTextureRegion(Texture* Destination, Texture* Source, const CopyTextureInfo& CopyTextureInfo)
+{
+    WriteCommand(ECaptureCommand::CopyTextureRegion);
+    WriteResource(Destination, ECaptureResourceType::Unknown);
+    WriteResource(Source, ECaptureResourceType::Unknown);
+    Write(CopyTextureInfo);
+    FORWARD_COMMAND(CopyTextureRegion(Destination, Source, CopyTextureInfo));
+}
+
+void CaptureCommandContext::DiscardResource(Resource* Resource)
+{
+    WriteCommand(ECaptureCommand::DiscardResource);
+    WriteResource(Resource, ECaptureResourceType::Unknown);
+    FORWARD_COMMAND(DiscardResource(Resource));
+}
+
+void CaptureCommandContext::BuildRayTracingGeometry(RayTracingGeometry* Geometry, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer, bool Update)
+{
+    WriteCommand(ECaptureCommand::BuildRayTracingGeometry);
+    WriteResource(Geometry, ECaptureResourceType::RayTracingGeometry);
+    WriteResource(VertexBuffer, ECaptureResourceType::VertexBuffer);
+    WriteResource(IndexBuffer, ECaptureResourceType::IndexBuffer);
+    Write(Update);
+    FORWARD_COMMAND(BuildRayTracingGeometry(Geometry, VertexBuffer, IndexBuffer, Update));
+}
+
+void CaptureCommandContext::BuildRayTracingScene(RayTracingScene* RayTracingScene, const RayTracingGeometryInstance* Instances, uint32 NumInstances, bool Update)
+{
+    WriteCommand(ECaptureCommand::BuildRayTracingScene);
+    WriteResource(RayTracingScene, ECaptureResourceType::RayTracingScene);
+
+    Write(NumInstances);
+    for (uint32 i = 0; i < NumInstances; i++)
+    {
+        const RayTracingGeometryInstance& Instance = Instances[i];
+        WriteResource(Instance.Instance.Get(), ECaptureResourceType::RayTracingGeometry);
+        Write(Instance.InstanceIndex);
+        Write(Instance.HitGroupIndex);
+        Write(Instance.Flags);
+        Write(Instance.Mask);
+        Write(Instance.Transform);
+    }
+
+    Write(Update);
+    FORWARD_COMMAND(BuildRayTracingScene(RayTracingScene, Instances, NumInstances, Update));
+}
+
+void CaptureCommandContext::SetRayTracingBindings(
+    RayTracingScene* RayTracingScene,
+    RayTracingPipelineState* PipelineState,
+    const RayTracingShaderResources* GlobalResource,
+    const RayTracingShaderResources* RayGenLocalResources,
+    const RayTracingShaderResources* MissLocalResources,
+    const RayTracingShaderResources* HitGroupResources, uint32 NumHitGroupResources)
+{
+    WriteCommand(ECaptureCommand::SetRayTracingBindings);
+    WriteResource(RayTracingScene, ECaptureResourceType::RayTracingScene);
+    WriteResource(PipelineState, ECaptureResourceType::RayTracingPipelineState);
+    WriteRayTracingResources(GlobalResource);
+    WriteRayTracingResources(RayGenLocalResources);
+    WriteRayTracingResources(MissLocalResources);
+
+    Write(NumHitGroupResources);
+    for (uint32 i = 0; i < NumHitGroupResources; i++)
+    {
+        WriteRayTracingResources(&HitGroupResources[i]);
+    }
+
+    FORWARD_COMMAND(SetRayTracingBindings(RayTracingScene, PipelineState, GlobalResource, RayGenLocalResources, MissLocalResources, HitGroupResources, NumHitGroupResources));
+}
+
+void CaptureCommandContext::GenerateMips(Texture* Texture)
+{
+    WriteCommand(ECaptureCommand::GenerateMips);
+    WriteResource(Texture, ECaptureResourceType::Unknown);
+    FORWARD_COMMAND(GenerateMips(Texture));
+}
+
+void CaptureCommandContext::TransitionTexture(Texture* Texture, EResourceState AfterState, uint32 Subresource)
+{
+    WriteCommand(ECaptureCommand::TransitionTexture);
+    WriteResource(Texture, ECaptureResourceType::Unknown);
+    Write(AfterState);
+    Write(Subresource);
+    FORWARD_COMMAND(TransitionTexture(Texture, AfterState, Subresource));
+}
+
+void CaptureCommandContext::TransitionBuffer(Buffer* Buffer, EResourceState AfterState)
+{
+    WriteCommand(ECaptureCommand::TransitionBuffer);
+    WriteResource(Buffer, ECaptureResourceType::Unknown);
+    Write(AfterState);
+    FORWARD_COMMAND(TransitionBuffer(Buffer, AfterState));
+}
+
+void CaptureCommandContext::UnorderedAccessTextureBarrier(Texture* Texture)
+{
+    WriteCommand(ECaptureCommand::UnorderedAccessTextureBarrier);
+    WriteResource(Texture, ECaptureResourceType::Unknown);
+    FORWARD_COMMAND(UnorderedAccessTextureBarrier(Texture));
+}
+
+void CaptureCommandContext::UnorderedAccessBufferBarrier(Buffer* Buffer)
+{
+    WriteCommand(ECaptureCommand::UnorderedAccessBufferBarrier);
+    WriteResource(Buffer, ECaptureResourceType::Unknown);
+    FORWARD_COMMAND(UnorderedAccessBufferBarrier(Buffer));
+}
+
+void CaptureCommandContext::Draw(uint32 VertexCount, uint32 StartVertexLocation)
+{
+    WriteCommand(ECaptureCommand::Draw);
+    Write(VertexCount);
+    Write(StartVertexLocation);
+    FORWARD_COMMAND(Draw(VertexCount, StartVertexLocation));
+}
+
+void CaptureCommandContext::DrawIndexed(uint32 IndexCount, uint32 StartIndexLocation, uint32 BaseVertexLocation)
+{
+    WriteCommand(ECaptureCommand::DrawIndexed);
+    Write(IndexCount);
+    Write(StartIndexLocation);
+    Write(BaseVertexLocation);
+    FORWARD_COMMAND(DrawIndexed(IndexCount, StartIndexLocation, BaseVertexLocation));
+}
+
+void CaptureCommandContext::DrawInstanced(uint32 VertexCountPerInstance, uint32 InstanceCount, uint32 StartVertexLocation, uint32 StartInstanceLocation)
+{
+    WriteCommand(ECaptureCommand::DrawInstanced);
+    Write(VertexCountPerInstance);
+    Write(InstanceCount);
+    Write(StartVertexLocation);
+    Write(StartInstanceLocation);
+    FORWARD_COMMAND(DrawInstanced(VertexCountPerInstance, InstanceCount, StartVertexLocation, StartInstanceLocation));
+}
+
+void CaptureCommandContext::DrawIndexedInstanced(
+    uint32 IndexCountPerInstance,
+    uint32 InstanceCount,
+    uint32 StartIndexLocation,
+    uint32 BaseVertexLocation,
+    uint32 StartInstanceLocation)
+{
+    WriteCommand(ECaptureCommand::DrawIndexedInstanced);
+    Write(IndexCountPerInstance);
+    Write(InstanceCount);
+    Write(StartIndexLocation);
+    Write(BaseVertexLocation);
+    Write(StartInstanceLocation);
+    FORWARD_COMMAND(DrawIndexedInstanced(IndexCountPerInstance, InstanceCount, StartIndexLocation, BaseVertexLocation, StartInstanceLocation));
+}
+
+void CaptureCommandContext::Dispatch(uint32 WorkGroupsX, uint32 WorkGroupsY, uint32 WorkGroupsZ)
+{
+    WriteCommand(ECaptureCommand::Dispatch);
+    Write(WorkGroupsX);
+    Write(WorkGroupsY);
+    Write(WorkGroupsZ);
+    FORWARD_COMMAND(Dispatch(WorkGroupsX, WorkGroupsY, WorkGroupsZ));
+}
+
+void CaptureCommandContext::DispatchRays(
+    RayTracingScene* InScene,
+    RayTracingPipelineState* InPipelineState,
+    uint32 InWidth,
+    uint32 InHeight,
+    uint32 InDepth)
+{
+    WriteCommand(ECaptureCommand::DispatchRays);
+    WriteResource(InScene, ECaptureResourceType::RayTracingScene);
+    WriteResource(InPipelineState, ECaptureResourceType::RayTracingPipelineState);
+    Write(InWidth);
+    Write(InHeight);
+    Write(InDepth);
+    FORWARD_COMMAND(DispatchRays(InScene, InPipelineState, InWidth, InHeight, InDepth));
+}
+
+void CaptureCommandContext::ClearState()
+{
+    WriteCommand(ECaptureCommand::ClearState);
+    FORWARD_COMMAND(ClearState());
+}
+
+void CaptureCommandContext::Flush()
+{
+    WriteCommand(ECaptureCommand::Flush);
+    FORWARD_COMMAND(Flush());
+}
+
+void CaptureCommandContext::InsertMarker(const std::string& Message)
+{
+    WriteCommand(ECaptureCommand::InsertMarker);
+    WriteString(Message);
+    FORWARD_COMMAND(InsertMarker(Message));
+}
+
+void CaptureCommandContext::BeginExternalCapture()
+{
+    WriteCommand(ECaptureCommand::BeginExternalCapture);
+    FORWARD_COMMAND(BeginExternalCapture());
+}
+
+void CaptureCommandContext::EndExternalCapture()
+{
+    WriteCommand(ECaptureCommand::EndExternalCapture);
+    FORWARD_COMMAND(EndExternalCapture());
+}
+
+void CaptureCommandContext::WritePayload(const void* Data, uint64 SizeInBytes)
+{
+    if (SizeInBytes > 0)
+    {
+        Assert(Data != nullptr);
+
+        TArray<uint8>& Stream = Capture.Stream;
+
+        // TArray::Resize does not grow geometrically, so reserve ahead to avoid a reallocation for each command
+        const uint32 Offset  = Stream.Size();
+        const uint32 NewSize = Offset + uint32(SizeInBytes);
+        if (NewSize > Stream.Capacity())
+        {
+            Stream.Reserve(NewSize + (NewSize / 2));
+        }
+
+        Stream.Resize(NewSize);
+        Memory::Memcpy(Stream.Data() + Offset, Data, SizeInBytes);
+    }
+}
+
+void CaptureCommandContext::WriteString(const std::string& String)
+{
+    const uint32 Length = uint32(String.size());
+    Write(Length);
+    WritePayload(String.data(), Length);
+}
+
+void CaptureCommandContext::WriteRayTracingResources(const RayTracingShaderResources* Resources)
+{
+    const bool HasResources = Resources != nullptr;
+    Write(HasResources);
+
+    if (HasResources)
+    {
+        WriteString(Resources->Identifier);
+        WriteResourceArray(Resources->ConstantBuffers.Data(), Resources->ConstantBuffers.Size(), ECaptureResourceType::ConstantBuffer);
+        WriteResourceArray(Resources->ShaderResourceViews.Data(), Resources->ShaderResourceViews.Size(), ECaptureResourceType::ShaderResourceView);
+        WriteResourceArray(Resources->UnorderedAccessViews.Data(), Resources->UnorderedAccessViews.Size(), ECaptureResourceType::UnorderedAccessView);
+        WriteResourceArray(Resources->SamplerStates.Data(), Resources->SamplerStates.Size(), ECaptureResourceType::SamplerState);
+    }
+}
+
+void CaptureCommandContext::WriteResource(Resource* InResource, ECaptureResourceType Type)
+{
+    if (!InResource)
+    {
+        Write(uint32(0));
+        return;
+    }
+
+    auto It = ResourceIds.find(InResource);
+    if (It != ResourceIds.end())
+    {
+        Write(It->second);
+        return;
+    }
+
+    CaptureResourceDesc Desc;
+    Desc.Type = Type;
+    Desc.Name = InResource->GetName();
+
+    // Textures and buffers are described by their most derived type, so that they can be recreated during replay
+    if (Texture* TextureResource = dynamic_cast<Texture*>(InResource))
+    {
+        Desc.Format  = TextureResource->GetFormat();
+        Desc.NumMips = TextureResource->GetNumMips();
+        Desc.Flags   = TextureResource->GetFlags();
+
+        if (Texture2DArray* Texture2DArrayResource = TextureResource->AsTexture2DArray())
+        {
+            Desc.Type             = ECaptureResourceType::Texture2DArray;
+            Desc.Width            = Texture2DArrayResource->GetWidth();
+            Desc.Height           = Texture2DArrayResource->GetHeight();
+            Desc.NumSamples       = Texture2DArrayResource->GetNumSamples();
+            Desc.DepthOrArraySize = Texture2DArrayResource->GetNumArraySlices();
+        }
+        else if (Texture2D* Texture2DResource = TextureResource->AsTexture2D())
+        {
+            Desc.Type             = ECaptureResourceType::Texture2D;
+            Desc.Width            = Texture2DResource->GetWidth();
+            Desc.Height           = Texture2DResource->GetHeight();
+            Desc.NumSamples       = Texture2DResource->GetNumSamples();
+            Desc.DepthOrArraySize = 1;
+        }
+        else if (TextureCubeArray* TextureCubeArrayResource = TextureResource->AsTextureCubeArray())
+        {
+            Desc.Type             = ECaptureResourceType::TextureCubeArray;
+            Desc.Width            = TextureCubeArrayResource->GetSize();
+            Desc.Height           = TextureCubeArrayResource->GetSize();
+            Desc.DepthOrArraySize = TextureCubeArrayResource->GetNumArraySlices();
+        }
+        else if (TextureCube* TextureCubeResource = TextureResource->AsTextureCube())
+        {
+            Desc.Type             = ECaptureResourceType::TextureCube;
+            Desc.Width            = TextureCubeResource->GetSize();
+            Desc.Height           = TextureCubeResource->GetSize();
+            Desc.DepthOrArraySize = 1;
+        }
+        else if (Texture3D* Texture3DResource = TextureResource->AsTexture3D())
+        {
+            Desc.Type             = ECaptureResourceType::Texture3D;
+            Desc.Width            = Texture3DResource->GetWidth();
+            Desc.Height           = Texture3DResource->GetHeight();
+            Desc.DepthOrArraySize = Texture3DResource->GetDepth();
+        }
+    }
+    else if (Buffer* BufferResource = dynamic_cast<Buffer*>(InResource))
+    {
+        Desc.Flags = BufferResource->GetFlags();
+
+        if (VertexBuffer* VertexBufferResource = BufferResource->AsVertexBuffer())
+        {
+            Desc.Type   = ECaptureResourceType::VertexBuffer;
+            Desc.Width  = VertexBufferResource->GetNumVertices();
+            Desc.Stride = VertexBufferResource->GetStride();
+        }
+        else if (IndexBuffer* IndexBufferResource = BufferResource->AsIndexBuffer())
+        {
+            Desc.Type   = ECaptureResourceType::IndexBuffer;
+            Desc.Width  = IndexBufferResource->GetNumIndicies();
+            Desc.Stride = GetStrideFromIndexFormat(IndexBufferResource->GetFormat());
+        }
+        else if (ConstantBuffer* ConstantBufferResource = BufferResource->AsConstantBuffer())
+        {
+            Desc.Type   = ECaptureResourceType::ConstantBuffer;
+            Desc.Width  = ConstantBufferResource->GetSize();
+            Desc.Stride = 1;
+        }
+        else if (StructuredBuffer* StructuredBufferResource = BufferResource->AsStructuredBuffer())
+        {
+            Desc.Type   = ECaptureResourceType::StructuredBuffer;
+            Desc.Width  = StructuredBufferResource->GetNumElements();
+            Desc.Stride = StructuredBufferResource->GetStride();
+        }
+    }
+    else if (Shader* ShaderResource = dynamic_cast<Shader*>(InResource))
+    {
+        Desc.Type = ECaptureResourceType::Shader;
+        if (ShaderResource->AsComputeShader())
+        {
+            Desc.Flags = uint32(EShaderStage::Compute);
+        }
+        else if (ShaderResource->AsPixelShader())
+        {
+            Desc.Flags = uint32(EShaderStage::Pixel);
+        }
+        else
+        {
+            Desc.Flags = uint32(EShaderStage::Vertex);
+        }
+    }
+    else if (RayTracingGeometry* GeometryResource = dynamic_cast<RayTracingGeometry*>(InResource))
+    {
+        Desc.Flags  = GeometryResource->GetFlags();
+        Desc.Format = GeometryResource->GetVertexFormat();
+    }
+    else if (RayTracingScene* SceneResource = dynamic_cast<RayTracingScene*>(InResource))
+    {
+        Desc.Flags = SceneResource->GetFlags();
+    }
+
+    Capture.Resources.EmplaceBack(Desc);
+
+    const uint32 NewId = Capture.Resources.Size();
+    ResourceIds.insert(std::make_pair(InResource, NewId));
+    ReferencedResources.EmplaceBack(MakeSharedRef<Resource>(InResource));
+
+    Write(NewId);
+}
\ No newline at end of file
@@ -0,0 +1,377 @@
+#pragma once
+#include "ICommandContext.h"
+
+#include <unordered_map>
+
+#ifdef COMPILER_VISUAL_STUDIO
+    #pragma warning(push)
+    #pragma warning(disable : 4100) // Disable unreferenced variable
+#endif
+
+#define COMMAND_LIST_CAPTURE_MAGIC   0x50414358 // 'XCAP'
+#define COMMAND_LIST_CAPTURE_VERSION 2
+
+// One opcode for each function in ICommandContext
+enum class ECaptureCommand : uint8
+{
+    Begin = 0,
+    End,
+    BeginTimeStamp,
+    EndTimeStamp,
+    ClearRenderTargetView,
+    ClearDepthStencilView,
+    ClearUnorderedAccessViewFloat,
+    SetShadingRate,
+    SetShadingRateImage,
+    BeginRenderPass,
+    EndRenderPass,
+    SetViewport,
+    SetScissorRect,
+    SetBlendFactor,
+    SetRenderTargets,
+    SetVertexBuffers,
+    SetIndexBuffer,
+    SetPrimitiveTopology,
+    SetGraphicsPipelineState,
+    SetComputePipelineState,
+    Set32BitShaderConstants,
+    SetShaderResourceView,
+    SetShaderResourceViews,
+    SetUnorderedAccessView,
+    SetUnorderedAccessViews,
+    SetConstantBuffer,
+    SetConstantBuffers,
+    SetSamplerState,
+    SetSamplerStates,
+    UpdateBuffer,
+    UpdateTexture2D,
+    ResolveTexture,
+    CopyBuffer,
+    CopyTexture,
+    CopyTextureRegion,
+    DiscardResource,
+    BuildRayTracingGeometry,
+    BuildRayTracingScene,
+    SetRayTracingBindings,
+    GenerateMips,
+    TransitionTexture,
+    TransitionBuffer,
+    UnorderedAccessTextureBarrier,
+    UnorderedAccessBufferBarrier,
+    Draw,
+    DrawIndexed,
+    DrawInstanced,
+    DrawIndexedInstanced,
+    Dispatch,
+    DispatchRays,
+    ClearState,
+    Flush,
+    InsertMarker,
+    BeginExternalCapture,
+    EndExternalCapture,
+    Count
+};
+
+const char* ToString(ECaptureCommand Command);
+
+enum class ECaptureResourceType : uint8
+{
+    Unknown = 0,
+    Texture2D,
+    Texture2DArray,
+    TextureCube,
+    TextureCubeArray,
+    Texture3D,
+    VertexBuffer,
+    IndexBuffer,
+    ConstantBuffer,
+    StructuredBuffer,
+    ShaderResourceView,
+    UnorderedAccessView,
+    RenderTargetView,
+    DepthStencilView,
+    Shader,
+    SamplerState,
+    GraphicsPipelineState,
+    ComputePipelineState,
+    RayTracingPipelineState,
+    RayTracingGeometry,
+    RayTracingScene,
+    GPUProfiler,
+};
+
+const char* ToString(ECaptureResourceType ResourceType);
+
+/*
+* Description of a resource referenced by a capture. Resources are given ids in the order they are first used, which
+* keeps the ids stable between two captures of the same frame. Id zero is reserved for nullptr.
+*/
+
+struct CaptureResourceDesc
+{
+    ECaptureResourceType Type = ECaptureResourceType::Unknown;
+    EFormat Format     = EFormat::Unknown;
+    uint32  Width      = 0;
+    uint32  Height     = 0;
+    uint32  DepthOrArraySize = 0;
+    uint32  NumMips    = 0;
+    uint32  NumSamples = 0;
+    uint32  Flags      = 0;
+    uint32  Stride     = 0;
+    std::string Name;
+};
+
+// Stores a serialized stream of ICommandContext-calls, all the arguments and payloads are stored inline
+class CommandListCapture
+{
+public:
+    CommandListCapture()  = default;
+    ~CommandListCapture() = default;
+
+    bool SaveToFile(const std::string& Filename) const;
+    bool LoadFromFile(const std::string& Filename);
+
+    void Reset()
+    {
+        Resources.Clear();
+        Stream.Clear();
+        NumCommands = 0;
+    }
+
+    const TArray<CaptureResourceDesc>& GetResources() const { return Resources; }
+    const TArray<uint8>& GetStream() const { return Stream; }
+
+    uint32 GetNumCommands() const { return NumCommands; }
+
+private:
+    friend class CaptureCommandContext;
+
+    TArray<CaptureResourceDesc> Resources;
+    TArray<uint8> Stream;
+    uint32 NumCommands = 0;
+};
+
+// Reads values from a command stream, once an error is encountered all following reads returns zero
+class CaptureStreamReader
+{
+public:
+    CaptureStreamReader(const uint8* InData, uint64 InSize)
+        : Data(InData)
+        , Size(InSize)
+        , Offset(0)
+        , HasError(false)
+    {
+    }
+
+    template<typename T>
+    T Read()
+    {
+        T Value = T();
+        ReadData(&Value, sizeof(T));
+        return Value;
+    }
+
+    const void* ReadPayload(uint64 PayloadSize)
+    {
+        if (!HasError && Offset + PayloadSize <= Size)
+        {
+            const void* Payload = Data + Offset;
+            Offset += PayloadSize;
+            return Payload;
+        }
+
+        HasError = true;
+        return nullptr;
+    }
+
+    std::string ReadString()
+    {
+        const uint32 Length = Read<uint32>();
+
+        const char* String = reinterpret_cast<const char*>(ReadPayload(Length));
+        return String ? std::string(String, Length) : std::string();
+    }
+
+    bool IsEndOfStream() const { return Offset >= Size; }
+    bool HasErrors()     const { return HasError; }
+
+private:
+    void ReadData(void* Destination, uint64 DataSize)
+    {
+        const void* Source = ReadPayload(DataSize);
+        if (Source)
+        {
+            Memory::Memcpy(Destination, Source, DataSize);
+        }
+    }
+
+    const uint8* Data;
+    uint64 Size;
+    uint64 Offset;
+    bool   HasError;
+};
+
+/*
+* CommandContext that serializes every call into a CommandListCapture. If a context to forward to is supplied all calls
+* are executed as well, so a frame can be captured by temporarily setting this context to the CommandListExecutor.
+* All resources that are referenced are kept alive until the context is destroyed so that addresses are not reused
+* during the capture.
+*/
+
+class CaptureCommandContext : public ICommandContext
+{
+public:
+    CaptureCommandContext(CommandListCapture& InCapture, ICommandContext* InForwardContext)
+        : ICommandContext()
+        , Capture(InCapture)
+        , ForwardContext(InForwardContext)
+        , ResourceIds()
+        , ReferencedResources()
+    {
+    }
+
+    ~CaptureCommandContext() = default;
+
+    virtual void Begin() override;
+    virtual void End()   override;
+
+    virtual void BeginTimeStamp(GPUProfiler* Profiler, uint32 Index) override;
+    virtual void EndTimeStamp(GPUProfiler* Profiler, uint32 Index)   override;
+
+    virtual void ClearRenderTargetView(RenderTargetView* RenderTargetView, const ColorF& ClearColor) override;
+    virtual void ClearDepthStencilView(DepthStencilView* DepthStencilView, const DepthStencilF& ClearValue) override;
+    virtual void ClearUnorderedAccessViewFloat(UnorderedAccessView* UnorderedAccessView, const ColorF& ClearColor) override;
+
+    virtual void SetShadingRate(EShadingRate ShadingRate) override;
+    virtual void SetShadingRateImage(Texture2D* ShadingImage) override;
+
+    virtual void BeginRenderPass() override;
+    virtual void EndRenderPass()   override;
+
+    virtual void SetViewport(float Width, float Height, float MinDepth, float MaxDepth, float x, float y) override;
+    virtual void SetScissorRect(float Width, float Height, float x, float y) override;
+
+    virtual void SetBlendFactor(const ColorF& Color) override;
+
+    virtual void SetRenderTargets(RenderTargetView* const* RenderTargetViews, uint32 RenderTargetCount, DepthStencilView* DepthStencilView) override;
+
+    virtual void SetVertexBuffers(VertexBuffer* const* VertexBuffers, uint32 BufferCount, uint32 BufferSlot) override;
+    virtual void SetIndexBuffer(IndexBuffer* IndexBuffer) override;
+
+    virtual void SetPrimitiveTopology(EPrimitiveTopology PrimitveTopologyType) override;
+
+    virtual void SetGraphicsPipelineState(class GraphicsPipelineState* PipelineState) override;
+    virtual void SetComputePipelineState(class ComputePipelineState* PipelineState)   override;
+
+    virtual void Set32BitShaderConstants(Shader* Shader, const void* Shader32BitConstants, uint32 Num32BitConstants) override;
+
+    virtual void SetShaderResourceView(Shader* Shader, ShaderResourceView* ShaderResourceView, uint32 ParameterIndex) override;
+    virtual void SetShaderResourceViews(Shader* Shader, ShaderResourceView* const* ShaderResourceView, uint32 NumShaderResourceViews, uint32 ParameterIndex) override;
+
+    virtual void SetUnorderedAccessView(Shader* Shader, UnorderedAccessView* UnorderedAccessView, uint32 ParameterIndex) override;
+    virtual void SetUnorderedAccessViews(Shader* Shader, UnorderedAccessView* const* UnorderedAccessViews, uint32 NumUnorderedAccessViews, uint32 ParameterIndex) override;
+
+    virtual void SetConstantBuffer(Shader* Shader, ConstantBuffer* ConstantBuffer, uint32 ParameterIndex) override;
+    virtual void SetConstantBuffers(Shader* Shader, ConstantBuffer* const* ConstantBuffers, uint32 NumConstantBuffers, uint32 ParameterIndex) override;
+
+    virtual void SetSamplerState(Shader* Shader, SamplerState* SamplerState, uint32 ParameterIndex) override;
+    virtual void SetSamplerStates(Shader* Shader, SamplerState* const* SamplerStates, uint32 NumSamplerStates, uint32 ParameterIndex) override;
+
+    virtual void UpdateBuffer(Buffer* Destination, uint64 OffsetInBytes, uint64 SizeInBytes, const void* SourceData) override;
+    virtual void UpdateTexture2D(Texture2D* Destination, uint32 Width, uint32 Height, uint32 MipLevel, const void* SourceData) override;
+
+    virtual void ResolveTexture(Texture* Destination, Texture* Source) override;
+
+    virtual void CopyBuffer(Buffer* Destination, Buffer* Source, const CopyBufferInfo& CopyInfo) override;
+    virtual void CopyTexture(Texture* Destination, Texture* Source) override;
+    virtual void CopyTextureRegion(Texture* Destination, Texture* Source, const CopyTextureInfo& CopyTextureInfo) override;
+
+    virtual void DiscardResource(class Resource* Resource) override;
+
+    virtual void BuildRayTracingGeometry(RayTracingGeometry* Geometry, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer, bool Update) override;
+    virtual void BuildRayTracingScene(RayTracingScene* RayTracingScene, const RayTracingGeometryInstance* Instances, uint32 NumInstances, bool Update) override;
+
+    virtual void SetRayTracingBindings(
+        RayTracingScene* RayTracingScene,
+        RayTracingPipelineState* PipelineState,
+        const RayTracingShaderResources* GlobalResource,
+        const RayTracingShaderResources* RayGenLocalResources,
+        const RayTracingShaderResources* MissLocalResources,
+        const RayTracingShaderResources* HitGroupResources, uint32 NumHitGroupResources) override;
+
+    virtual void GenerateMips(Texture* Texture) override;
+
+    virtual void TransitionTexture(Texture* Texture, EResourceState AfterState, uint32 Subresource) override;
+    virtual void TransitionBuffer(Buffer* Buffer, EResourceState AfterState) override;
+
+    virtual void UnorderedAccessTextureBarrier(Texture* Texture) override;
+    virtual void UnorderedAccessBufferBarrier(Buffer* Buffer) override;
+
+    virtual void Draw(uint32 VertexCount, uint32 StartVertexLocation) override;
+    virtual void DrawIndexed(uint32 IndexCount, uint32 StartIndexLocation, uint32 BaseVertexLocation) override;
+    virtual void DrawInstanced(uint32 VertexCountPerInstance, uint32 InstanceCount, uint32 StartVertexLocation, uint32 StartInstanceLocation) override;
+
+    virtual void DrawIndexedInstanced(
+        uint32 IndexCountPerInstance,
+        uint32 InstanceCount,
+        uint32 StartIndexLocation,
+        uint32 BaseVertexLocation,
+        uint32 StartInstanceLocation) override;
+
+    virtual void Dispatch(uint32 WorkGroupsX, uint32 WorkGroupsY, uint32 WorkGroupsZ) override;
+
+    virtual void DispatchRays(
+        RayTracingScene* InScene,
+        RayTracingPipelineState* InPipelineState,
+        uint32 InWidth,
+        uint32 InHeight,
+        uint32 InDepth) override;
+
+    virtual void ClearState() override;
+    virtual void Flush()      override;
+
+    virtual void InsertMarker(const std::string& Message) override;
+
+    virtual void BeginExternalCapture() override;
+    virtual void EndExternalCapture()   override;
+
+private:
+    void WriteCommand(ECaptureCommand Command)
+    {
+        Write(Command);
+        Capture.NumCommands++;
+    }
+
+    template<typename T>
+    void Write(const T& Value)
+    {
+        WritePayload(&Value, sizeof(T));
+    }
+
+    void WritePayload(const void* Data, uint64 SizeInBytes);
+    void WriteString(const std::string& String);
+    void WriteRayTracingResources(const RayTracingShaderResources* Resources);
+
+    // Writes the id of the resource, and adds the resource to the capture the first time it is referenced
+    void WriteResource(Resource* Resource, ECaptureResourceType Type);
+
+    template<typename TResource>
+    void WriteResourceArray(TResource* const* Resources, uint32 NumResources, ECaptureResourceType Type)
+    {
+        Write(NumResources);
+        for (uint32 i = 0; i < NumResources; i++)
+        {
+            WriteResource(Resources[i], Type);
+        }
+    }
+
+    CommandListCapture& Capture;
+    ICommandContext*    ForwardContext;
+
+    std::unordered_map<Resource*, uint32> ResourceIds;
+    TArray<TRef<Resource>> ReferencedResources;
+};
+
+#ifdef COMPILER_VISUAL_STUDIO
+    #pragma warning(pop)
+#endif
\ No newline at end of file
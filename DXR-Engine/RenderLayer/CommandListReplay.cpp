@@ -0,0 +1,972 @@
+#include "CommandListReplay.h"
+#include "GenericRenderLayer.h"
+#include "PipelineState.h"
+#include "SamplerState.h"
+#include "RayTracing.h"
+#include "GPUProfiler.h"
+
+#include "Time/Platform/PlatformTime.h"
+
+#include <cstdio>
+
+// Executes the call on the context and measures the time it took
+#define REPLAY_COMMAND(Call) \
+    if (CmdContext) \
+    { \
+        const uint64 StartTicks = PlatformTime::QueryPerformanceCounter(); \
+        CmdContext->Call; \
+        CommandTicks += PlatformTime::QueryPerformanceCounter() - StartTicks; \
+    }
+
+struct CaptureResourceId
+{
+    uint32 Id = 0;
+};
+
+static std::string ToText(uint32 Value)
+{
+    return std::to_string(Value);
+}
+
+static std::string ToText(uint64 Value)
+{
+    return std::to_string(Value);
+}
+
+static std::string ToText(uint8 Value)
+{
+    return std::to_string(uint32(Value));
+}
+
+static std::string ToText(float Value)
+{
+    return std::to_string(Value);
+}
+
+static std::string ToText(bool Value)
+{
+    return Value ? "true" : "false";
+}
+
+static std::string ToText(EResourceState Value)
+{
+    return ToString(Value);
+}
+
+static std::string ToText(EShadingRate Value)
+{
+    return ToString(Value);
+}
+
+static std::string ToText(EPrimitiveTopology Value)
+{
+    return ToString(Value);
+}
+
+static std::string ToText(const ColorF& Value)
+{
+    return "(" + ToText(Value.r) + ", " + ToText(Value.g) + ", " + ToText(Value.b) + ", " + ToText(Value.a) + ")";
+}
+
+static std::string ToText(const std::string& Value)
+{
+    return '\"' + Value + '\"';
+}
+
+static std::string ToText(CaptureResourceId Value)
+{
+    return Value.Id ? '#' + std::to_string(Value.Id) : std::string("null");
+}
+
+static std::string ToText(const TArray<CaptureResourceId>& Value)
+{
+    std::string Text = "[";
+    for (uint32 i = 0; i < Value.Size(); i++)
+    {
+        Text += (i > 0) ? ", " + ToText(Value[i]) : ToText(Value[i]);
+    }
+
+    return Text + "]";
+}
+
+static void DumpArgs(std::string* OutText)
+{
+    UNREFERENCED_VARIABLE(OutText);
+}
+
+template<typename T, typename... TRest>
+static void DumpArgs(std::string* OutText, const char* Name, const T& Value, TRest&&... Rest)
+{
+    if (OutText)
+    {
+        *OutText += ' ';
+        *OutText += Name;
+        *OutText += '=';
+        *OutText += ToText(Value);
+
+        DumpArgs(OutText, Forward<TRest>(Rest)...);
+    }
+}
+
+static CaptureResourceId ReadResourceId(CaptureStreamReader& Reader)
+{
+    CaptureResourceId Id;
+    Id.Id = Reader.Read<uint32>();
+    return Id;
+}
+
+static TArray<CaptureResourceId> ReadResourceIds(CaptureStreamReader& Reader)
+{
+    const uint32 NumIds = Reader.Read<uint32>();
+
+    TArray<CaptureResourceId> Ids;
+    for (uint32 i = 0; i < NumIds && !Reader.HasErrors(); i++)
+    {
+        Ids.EmplaceBack(ReadResourceId(Reader));
+    }
+
+    return Ids;
+}
+
+std::string CommandReplayStatistics::ToString() const
+{
+    std::string Result;
+
+    char Line[256];
+    snprintf(Line, sizeof(Line), "%-32s %10s %14s %12s\n", "Command", "Count", "Total (us)", "Avg (ns)");
+    Result += Line;
+
+    uint32 TotalCommands = 0;
+    for (uint32 i = 0; i < uint32(ECaptureCommand::Count); i++)
+    {
+        if (NumCommands[i] > 0)
+        {
+            const double TotalMicroSeconds = double(Nanoseconds[i]) / 1000.0;
+            const double AverageNanoSeconds = double(Nanoseconds[i]) / double(NumCommands[i]);
+            snprintf(Line, sizeof(Line), "%-32s %10u %14.3f %12.1f\n", ::ToString(ECaptureCommand(i)), NumCommands[i], TotalMicroSeconds, AverageNanoSeconds);
+            Result += Line;
+
+            TotalCommands += NumCommands[i];
+        }
+    }
+
+    snprintf(Line, sizeof(Line), "%-32s %10u %14.3f\n", "Total", TotalCommands, double(TotalNanoseconds) / 1000.0);
+    Result += Line;
+    return Result;
+}
+
+bool CommandListReplayer::CreateResources()
+{
+    Assert(gRenderLayer != nullptr);
+
+    StandIns.Clear();
+    StandInOwners.Clear();
+
+    const TArray<CaptureResourceDesc>& Resources = Capture.GetResources();
+    for (const CaptureResourceDesc& Desc : Resources)
+    {
+        TRef<Resource> StandIn = CreateStandIn(Desc);
+        if (!StandIn && Desc.Type != ECaptureResourceType::Unknown)
+        {
+            LOG_WARNING("[CommandListReplayer]: Failed to create a stand-in for " + std::string(::ToString(Desc.Type)) + " '" + Desc.Name + "'");
+        }
+        else if (StandIn)
+        {
+            StandIn->SetName(Desc.Name);
+        }
+
+        StandIns.EmplaceBack(StandIn);
+    }
+
+    return true;
+}
+
+bool CommandListReplayer::Replay(ICommandContext& CmdContext, CommandReplayStatistics& OutStatistics)
+{
+    Assert(StandIns.Size() == Capture.GetResources().Size());
+    return ExecuteStream(&CmdContext, &OutStatistics, nullptr);
+}
+
+std::string CommandListReplayer::DumpToString()
+{
+    std::string Text;
+
+    const TArray<CaptureResourceDesc>& Resources = Capture.GetResources();
+    for (uint32 i = 0; i < Resources.Size(); i++)
+    {
+        const CaptureResourceDesc& Desc = Resources[i];
+        Text += "Resource #" + std::to_string(i + 1) + ' ' + ::ToString(Desc.Type) + " '" + Desc.Name + "'";
+        Text += " Format=" + std::string(::ToString(Desc.Format));
+        Text += " Size=" + std::to_string(Desc.Width) + 'x' + std::to_string(Desc.Height) + 'x' + std::to_string(Desc.DepthOrArraySize);
+        Text += " NumMips=" + std::to_string(Desc.NumMips);
+        Text += " Flags=" + std::to_string(Desc.Flags);
+        Text += " Stride=" + std::to_string(Desc.Stride) + '\n';
+    }
+
+    ExecuteStream(nullptr, nullptr, &Text);
+    return Text;
+}
+
+Resource* CommandListReplayer::CreateStandIn(const CaptureResourceDesc& Desc)
+{
+    const EResourceState InitialState = EResourceState::Common;
+    switch (Desc.Type)
+    {
+        case ECaptureResourceType::Texture2D:
+            return gRenderLayer->CreateTexture2D(Desc.Format, Desc.Width, Desc.Height, Desc.NumMips, Desc.NumSamples, Desc.Flags, InitialState, nullptr, ClearValue());
+        case ECaptureResourceType::Texture2DArray:
+            return gRenderLayer->CreateTexture2DArray(Desc.Format, Desc.Width, Desc.Height, Desc.NumMips, Desc.NumSamples, Desc.DepthOrArraySize, Desc.Flags, InitialState, nullptr, ClearValue());
+        case ECaptureResourceType::TextureCube:
+            return gRenderLayer->CreateTextureCube(Desc.Format, Desc.Width, Desc.NumMips, Desc.Flags, InitialState, nullptr, ClearValue());
+        case ECaptureResourceType::TextureCubeArray:
+            return gRenderLayer->CreateTextureCubeArray(Desc.Format, Desc.Width, Desc.NumMips, Desc.DepthOrArraySize, Desc.Flags, InitialState, nullptr, ClearValue());
+        case ECaptureResourceType::Texture3D:
+            return gRenderLayer->CreateTexture3D(Desc.Format, Desc.Width, Desc.Height, Desc.DepthOrArraySize, Desc.NumMips, Desc.Flags, InitialState, nullptr, ClearValue());
+
+        case ECaptureResourceType::VertexBuffer:
+            return gRenderLayer->CreateVertexBuffer(Desc.Stride, Desc.Width, Desc.Flags, InitialState, nullptr);
+        case ECaptureResourceType::IndexBuffer:
+        {
+            const EIndexFormat IndexFormat = (Desc.Stride == 2) ? EIndexFormat::uint16 : EIndexFormat::uint32;
+            return gRenderLayer->CreateIndexBuffer(IndexFormat, Desc.Width, Desc.Flags, InitialState, nullptr);
+        }
+        case ECaptureResourceType::ConstantBuffer:
+            return gRenderLayer->CreateConstantBuffer(Desc.Width, Desc.Flags, InitialState, nullptr);
+        case ECaptureResourceType::StructuredBuffer:
+            return gRenderLayer->CreateStructuredBuffer(Desc.Stride, Desc.Width, Desc.Flags, InitialState, nullptr);
+
+        // Views are taken from the default views of a small texture
+        case ECaptureResourceType::ShaderResourceView:
+        case ECaptureResourceType::UnorderedAccessView:
+        case ECaptureResourceType::RenderTargetView:
+        case ECaptureResourceType::DepthStencilView:
+        {
+            EFormat Format = EFormat::R8G8B8A8_Unorm;
+            uint32  Flags  = TextureFlag_SRV;
+            if (Desc.Type == ECaptureResourceType::UnorderedAccessView)
+            {
+                Flags = TextureFlags_RWTexture;
+            }
+            else if (Desc.Type == ECaptureResourceType::RenderTargetView)
+            {
+                Flags = TextureFlags_RenderTarget;
+            }
+            else if (Desc.Type == ECaptureResourceType::DepthStencilView)
+            {
+                Format = EFormat::D32_Float;
+                Flags  = TextureFlag_DSV;
+            }
+
+            TRef<Texture2D> Owner = gRenderLayer->CreateTexture2D(Format, 1, 1, 1, 1, Flags, InitialState, nullptr, ClearValue());
+            if (!Owner)
+            {
+                return nullptr;
+            }
+
+            StandInOwners.EmplaceBack(Owner);
+
+            Resource* View = nullptr;
+            if (Desc.Type == ECaptureResourceType::ShaderResourceView)
+            {
+                View = Owner->GetShaderResourceView();
+            }
+            else if (Desc.Type == ECaptureResourceType::UnorderedAccessView)
+            {
+                View = Owner->GetUnorderedAccessView();
+            }
+            else if (Desc.Type == ECaptureResourceType::RenderTargetView)
+            {
+                View = Owner->GetRenderTargetView();
+            }
+            else
+            {
+                View = Owner->GetDepthStencilView();
+            }
+
+            // The returned pointer is adopted by a TRef
+            if (View)
+            {
+                View->AddRef();
+            }
+
+            return View;
+        }
+
+        case ECaptureResourceType::Shader:
+        {
+            const TArray<uint8> EmptyCode;
+            const EShaderStage Stage = EShaderStage(Desc.Flags);
+            if (Stage == EShaderStage::Compute)
+            {
+                return gRenderLayer->CreateComputeShader(EmptyCode);
+            }
+            else if (Stage == EShaderStage::Pixel)
+            {
+                return gRenderLayer->CreatePixelShader(EmptyCode);
+            }
+            else
+            {
+                return gRenderLayer->CreateVertexShader(EmptyCode);
+            }
+        }
+
+        case ECaptureResourceType::SamplerState:
+            return gRenderLayer->CreateSamplerState(SamplerStateCreateInfo());
+        case ECaptureResourceType::GraphicsPipelineState:
+            return gRenderLayer->CreateGraphicsPipelineState(GraphicsPipelineStateCreateInfo());
+        case ECaptureResourceType::ComputePipelineState:
+            return gRenderLayer->CreateComputePipelineState(ComputePipelineStateCreateInfo());
+        case ECaptureResourceType::RayTracingPipelineState:
+            return gRenderLayer->CreateRayTracingPipelineState(RayTracingPipelineStateCreateInfo());
+        case ECaptureResourceType::RayTracingGeometry:
+            return gRenderLayer->CreateRayTracingGeometry(Desc.Flags, nullptr, nullptr, Desc.Format);
+        case ECaptureResourceType::RayTracingScene:
+            return gRenderLayer->CreateRayTracingScene(Desc.Flags, nullptr, 0);
+        case ECaptureResourceType::GPUProfiler:
+            return gRenderLayer->CreateProfiler();
+
+        default:
+            return nullptr;
+    }
+}
+
+bool CommandListReplayer::ExecuteStream(ICommandContext* CmdContext, CommandReplayStatistics* OutStatistics, std::string* OutText)
+{
+    const TArray<uint8>& Stream = Capture.GetStream();
+    CaptureStreamReader Reader(Stream.Data(), Stream.Size());
+
+    const uint64 Frequency = PlatformTime::QueryPerformanceFrequency();
+    constexpr uint64 NANOSECONDS = 1000 * 1000 * 1000;
+
+    // Temporary arrays that are reused between commands
+    TArray<RenderTargetView*>    RenderTargets;
+    TArray<VertexBuffer*>        VertexBuffers;
+    TArray<ShaderResourceView*>  ShaderResourceViews;
+    TArray<UnorderedAccessView*> UnorderedAccessViews;
+    TArray<ConstantBuffer*>      ConstantBuffers;
+    TArray<SamplerState*>        SamplerStates;
+    TArray<RayTracingGeometryInstance> Instances;
+    TArray<RayTracingShaderResources>  HitGroupResources;
+
+    auto ResolveArray = [this](const TArray<CaptureResourceId>& Ids, auto& OutResources)
+    {
+        using TResource = std::remove_pointer_t<std::decay_t<decltype(OutResources[0])>>;
+
+        OutResources.Clear();
+        for (CaptureResourceId Id : Ids)
+        {
+            OutResources.EmplaceBack(GetStandIn<TResource>(Id.Id));
+        }
+    };
+
+    auto ReadRayTracingResources = [&](RayTracingShaderResources& OutResources, std::string* OutResourceText) -> bool
+    {
+        const bool HasResources = Reader.Read<bool>();
+        if (HasResources)
+        {
+            OutResources.Identifier = Reader.ReadString();
+
+            const TArray<CaptureResourceId> ConstantBufferIds      = ReadResourceIds(Reader);
+            const TArray<CaptureResourceId> ShaderResourceViewIds  = ReadResourceIds(Reader);
+            const TArray<CaptureResourceId> UnorderedAccessViewIds = ReadResourceIds(Reader);
+            const TArray<CaptureResourceId> SamplerStateIds        = ReadResourceIds(Reader);
+
+            ResolveArray(ConstantBufferIds, OutResources.ConstantBuffers);
+            ResolveArray(ShaderResourceViewIds, OutResources.ShaderResourceViews);
+            ResolveArray(UnorderedAccessViewIds, OutResources.UnorderedAccessViews);
+            ResolveArray(SamplerStateIds, OutResources.SamplerStates);
+
+            DumpArgs(OutResourceText,
+                "Identifier", OutResources.Identifier,
+                "ConstantBuffers", ConstantBufferIds,
+                "ShaderResourceViews", ShaderResourceViewIds,
+                "UnorderedAccessViews", UnorderedAccessViewIds,
+                "SamplerStates", SamplerStateIds);
+        }
+        else if (OutResourceText)
+        {
+            *OutResourceText += " null";
+        }
+
+        return HasResources;
+    };
+
+    const uint64 StreamStartTicks = PlatformTime::QueryPerformanceCounter();
+
+    while (!Reader.IsEndOfStream() && !Reader.HasErrors())
+    {
+        const ECaptureCommand Command = Reader.Read<ECaptureCommand>();
+        if (OutText)
+        {
+            *OutText += ::ToString(Command);
+        }
+
+        uint64 CommandTicks = 0;
+        switch (Command)
+        {
+            case ECaptureCommand::Begin:
+            {
+                REPLAY_COMMAND(Begin());
+                break;
+            }
+            case ECaptureCommand::End:
+            {
+                REPLAY_COMMAND(End());
+                break;
+            }
+            case ECaptureCommand::BeginTimeStamp:
+            case ECaptureCommand::EndTimeStamp:
+            {
+                const CaptureResourceId Profiler = ReadResourceId(Reader);
+                const uint32 Index = Reader.Read<uint32>();
+                if (Command == ECaptureCommand::BeginTimeStamp)
+                {
+                    REPLAY_COMMAND(BeginTimeStamp(GetStandIn<GPUProfiler>(Profiler.Id), Index));
+                }
+                else
+                {
+                    REPLAY_COMMAND(EndTimeStamp(GetStandIn<GPUProfiler>(Profiler.Id), Index));
+                }
+
+                DumpArgs(OutText, "Profiler", Profiler, "Index", Index);
+                break;
+            }
+            case ECaptureCommand::ClearRenderTargetView:
+            {
+                const CaptureResourceId View = ReadResourceId(Reader);
+                const ColorF ClearColor = Reader.Read<ColorF>();
+                REPLAY_COMMAND(ClearRenderTargetView(GetStandIn<RenderTargetView>(View.Id), ClearColor));
+                DumpArgs(OutText, "RenderTargetView", View, "ClearColor", ClearColor);
+                break;
+            }
+            case ECaptureCommand::ClearDepthStencilView:
+            {
+                const CaptureResourceId View = ReadResourceId(Reader);
+
+                DepthStencilF ClearValue;
+                ClearValue.Depth   = Reader.Read<float>();
+                ClearValue.Stencil = Reader.Read<uint8>();
+
+                REPLAY_COMMAND(ClearDepthStencilView(GetStandIn<DepthStencilView>(View.Id), ClearValue));
+                DumpArgs(OutText, "DepthStencilView", View, "Depth", ClearValue.Depth, "Stencil", ClearValue.Stencil);
+                break;
+            }
+            case ECaptureCommand::ClearUnorderedAccessViewFloat:
+            {
+                const CaptureResourceId View = ReadResourceId(Reader);
+                const ColorF ClearColor = Reader.Read<ColorF>();
+                REPLAY_COMMAND(ClearUnorderedAccessViewFloat(GetStandIn<UnorderedAccessView>(View.Id), ClearColor));
+                DumpArgs(OutText, "UnorderedAccessView", View, "ClearColor", ClearColor);
+                break;
+            }
+            case ECaptureCommand::SetShadingRate:
+            {
+                const EShadingRate ShadingRate = Reader.Read<EShadingRate>();
+                REPLAY_COMMAND(SetShadingRate(ShadingRate));
+                DumpArgs(OutText, "ShadingRate", ShadingRate);
+                break;
+            }
+            case ECaptureCommand::SetShadingRateImage:
+            {
+                const CaptureResourceId Image = ReadResourceId(Reader);
+                REPLAY_COMMAND(SetShadingRateImage(GetStandIn<Texture2D>(Image.Id)));
+                DumpArgs(OutText, "ShadingImage", Image);
+                break;
+            }
+            case ECaptureCommand::BeginRenderPass:
+            {
+                REPLAY_COMMAND(BeginRenderPass());
+                break;
+            }
+            case ECaptureCommand::EndRenderPass:
+            {
+                REPLAY_COMMAND(EndRenderPass());
+                break;
+            }
+            case ECaptureCommand::SetViewport:
+            {
+                const float Width    = Reader.Read<float>();
+                const float Height   = Reader.Read<float>();
+                const float MinDepth = Reader.Read<float>();
+                const float MaxDepth = Reader.Read<float>();
+                const float x        = Reader.Read<float>();
+                const float y        = Reader.Read<float>();
+                REPLAY_COMMAND(SetViewport(Width, Height, MinDepth, MaxDepth, x, y));
+                DumpArgs(OutText, "Width", Width, "Height", Height, "MinDepth", MinDepth, "MaxDepth", MaxDepth, "x", x, "y", y);
+                break;
+            }
+            case ECaptureCommand::SetScissorRect:
+            {
+                const float Width  = Reader.Read<float>();
+                const float Height = Reader.Read<float>();
+                const float x      = Reader.Read<float>();
+                const float y      = Reader.Read<float>();
+                REPLAY_COMMAND(SetScissorRect(Width, Height, x, y));
+                DumpArgs(OutText, "Width", Width, "Height", Height, "x", x, "y", y);
+                break;
+            }
+            case ECaptureCommand::SetBlendFactor:
+            {
+                const ColorF Color = Reader.Read<ColorF>();
+                REPLAY_COMMAND(SetBlendFactor(Color));
+                DumpArgs(OutText, "Color", Color);
+                break;
+            }
+            case ECaptureCommand::SetRenderTargets:
+            {
+                const TArray<CaptureResourceId> RenderTargetIds = ReadResourceIds(Reader);
+                const CaptureResourceId DepthStencil = ReadResourceId(Reader);
+
+                ResolveArray(RenderTargetIds, RenderTargets);
+                REPLAY_COMMAND(SetRenderTargets(RenderTargets.Data(), RenderTargets.Size(), GetStandIn<DepthStencilView>(DepthStencil.Id)));
+                DumpArgs(OutText, "RenderTargetViews", RenderTargetIds, "DepthStencilView", DepthStencil);
+                break;
+            }
+            case ECaptureCommand::SetVertexBuffers:
+            {
+                const TArray<CaptureResourceId> BufferIds = ReadResourceIds(Reader);
+                const uint32 BufferSlot = Reader.Read<uint32>();
+
+                ResolveArray(BufferIds, VertexBuffers);
+                REPLAY_COMMAND(SetVertexBuffers(VertexBuffers.Data(), VertexBuffers.Size(), BufferSlot));
+                DumpArgs(OutText, "VertexBuffers", BufferIds, "BufferSlot", BufferSlot);
+                break;
+            }
+            case ECaptureCommand::SetIndexBuffer:
+            {
+                const CaptureResourceId Buffer = ReadResourceId(Reader);
+                REPLAY_COMMAND(SetIndexBuffer(GetStandIn<IndexBuffer>(Buffer.Id)));
+                DumpArgs(OutText, "IndexBuffer", Buffer);
+                break;
+            }
+            case ECaptureCommand::SetPrimitiveTopology:
+            {
+                const EPrimitiveTopology Topology = Reader.Read<EPrimitiveTopology>();
+                REPLAY_COMMAND(SetPrimitiveTopology(Topology));
+                DumpArgs(OutText, "PrimitiveTopology", Topology);
+                break;
+            }
+            case ECaptureCommand::SetGraphicsPipelineState:
+            {
+                const CaptureResourceId PipelineState = ReadResourceId(Reader);
+                REPLAY_COMMAND(SetGraphicsPipelineState(GetStandIn<GraphicsPipelineState>(PipelineState.Id)));
+                DumpArgs(OutText, "PipelineState", PipelineState);
+                break;
+            }
+            case ECaptureCommand::SetComputePipelineState:
+            {
+                const CaptureResourceId PipelineState = ReadResourceId(Reader);
+                REPLAY_COMMAND(SetComputePipelineState(GetStandIn<ComputePipelineState>(PipelineState.Id)));
+                DumpArgs(OutText, "PipelineState", PipelineState);
+                break;
+            }
+            case ECaptureCommand::Set32BitShaderConstants:
+            {
+                const CaptureResourceId ShaderId = ReadResourceId(Reader);
+                const uint32 Num32BitConstants = Reader.Read<uint32>();
+                const void* Constants = Reader.ReadPayload(Num32BitConstants * sizeof(uint32));
+                if (Constants || Num32BitConstants == 0)
+                {
+                    REPLAY_COMMAND(Set32BitShaderConstants(GetStandIn<Shader>(ShaderId.Id), Constants, Num32BitConstants));
+                }
+
+                DumpArgs(OutText, "Shader", ShaderId, "Num32BitConstants", Num32BitConstants);
+                break;
+            }
+            case ECaptureCommand::SetShaderResourceView:
+            {
+                const CaptureResourceId ShaderId = ReadResourceId(Reader);
+                const CaptureResourceId View     = ReadResourceId(Reader);
+                const uint32 ParameterIndex = Reader.Read<uint32>();
+                REPLAY_COMMAND(SetShaderResourceView(GetStandIn<Shader>(ShaderId.Id), GetStandIn<ShaderResourceView>(View.Id), ParameterIndex));
+                DumpArgs(OutText, "Shader", ShaderId, "ShaderResourceView", View, "ParameterIndex", ParameterIndex);
+                break;
+            }
+            case ECaptureCommand::SetShaderResourceViews:
+            {
+                const CaptureResourceId ShaderId = ReadResourceId(Reader);
+                const TArray<CaptureResourceId> ViewIds = ReadResourceIds(Reader);
+                const uint32 ParameterIndex = Reader.Read<uint32>();
+
+                ResolveArray(ViewIds, ShaderResourceViews);
+                REPLAY_COMMAND(SetShaderResourceViews(GetStandIn<Shader>(ShaderId.Id), ShaderResourceViews.Data(), ShaderResourceViews.Size(), ParameterIndex));
+                DumpArgs(OutText, "Shader", ShaderId, "ShaderResourceViews", ViewIds, "ParameterIndex", ParameterIndex);
+                break;
+            }
+            case ECaptureCommand::SetUnorderedAccessView:
+            {
+                const CaptureResourceId ShaderId = ReadResourceId(Reader);
+                const CaptureResourceId View     = ReadResourceId(Reader);
+                const uint32 ParameterIndex = Reader.Read<uint32>();
+                REPLAY_COMMAND(SetUnorderedAccessView(GetStandIn<Shader>(ShaderId.Id), GetStandIn<UnorderedAccessView>(View.Id), ParameterIndex));
+                DumpArgs(OutText, "Shader", ShaderId, "UnorderedAccessView", View, "ParameterIndex", ParameterIndex);
+                break;
+            }
+            case ECaptureCommand::SetUnorderedAccessViews:
+            {
+                const CaptureResourceId ShaderId = ReadResourceId(Reader);
+                const TArray<CaptureResourceId> ViewIds = ReadResourceIds(Reader);
+                const uint32 ParameterIndex = Reader.Read<uint32>();
+
+                ResolveArray(ViewIds, UnorderedAccessViews);
+                REPLAY_COMMAND(SetUnorderedAccessViews(GetStandIn<Shader>(ShaderId.Id), UnorderedAccessViews.Data(), UnorderedAccessViews.Size(), ParameterIndex));
+                DumpArgs(OutText, "Shader", ShaderId, "UnorderedAccessViews", ViewIds, "ParameterIndex", ParameterIndex);
+                break;
+            }
+            case ECaptureCommand::SetConstantBuffer:
+            {
+                const CaptureResourceId ShaderId = ReadResourceId(Reader);
+                const CaptureResourceId Buffer   = ReadResourceId(Reader);
+                const uint32 ParameterIndex = Reader.Read<uint32>();
+                REPLAY_COMMAND(SetConstantBuffer(GetStandIn<Shader>(ShaderId.Id), GetStandIn<ConstantBuffer>(Buffer.Id), ParameterIndex));
+                DumpArgs(OutText, "Shader", ShaderId, "ConstantBuffer", Buffer, "ParameterIndex", ParameterIndex);
+                break;
+            }
+            case ECaptureCommand::SetConstantBuffers:
+            {
+                const CaptureResourceId ShaderId = ReadResourceId(Reader);
+                const TArray<CaptureResourceId> BufferIds = ReadResourceIds(Reader);
+                const uint32 ParameterIndex = Reader.Read<uint32>();
+
+                ResolveArray(BufferIds, ConstantBuffers);
+                REPLAY_COMMAND(SetConstantBuffers(GetStandIn<Shader>(ShaderId.Id), ConstantBuffers.Data(), ConstantBuffers.Size(), ParameterIndex));
+                DumpArgs(OutText, "Shader", ShaderId, "ConstantBuffers", BufferIds, "ParameterIndex", ParameterIndex);
+                break;
+            }
+            case ECaptureCommand::SetSamplerState:
+            {
+                const CaptureResourceId ShaderId = ReadResourceId(Reader);
+                const CaptureResourceId Sampler  = ReadResourceId(Reader);
+                const uint32 ParameterIndex = Reader.Read<uint32>();
+                REPLAY_COMMAND(SetSamplerState(GetStandIn<Shader>(ShaderId.Id), GetStandIn<SamplerState>(Sampler.Id), ParameterIndex));
+                DumpArgs(OutText, "Shader", ShaderId, "SamplerState", Sampler, "ParameterIndex", ParameterIndex);
+                break;
+            }
+            case ECaptureCommand::SetSamplerStates:
+            {
+                const CaptureResourceId ShaderId = ReadResourceId(Reader);
+                const TArray<CaptureResourceId> SamplerIds = ReadResourceIds(Reader);
+                const uint32 ParameterIndex = Reader.Read<uint32>();
+
+                ResolveArray(SamplerIds, SamplerStates);
+                REPLAY_COMMAND(SetSamplerStates(GetStandIn<Shader>(ShaderId.Id), SamplerStates.Data(), SamplerStates.Size(), ParameterIndex));
+                DumpArgs(OutText, "Shader", ShaderId, "SamplerStates", SamplerIds, "ParameterIndex", ParameterIndex);
+                break;
+            }
+            case ECaptureCommand::UpdateBuffer:
+            {
+                const CaptureResourceId Destination = ReadResourceId(Reader);
+                const uint64 OffsetInBytes = Reader.Read<uint64>();
+                const uint64 SizeInBytes   = Reader.Read<uint64>();
+                const void*  SourceData    = Reader.ReadPayload(SizeInBytes);
+                if (SourceData)
+                {
+                    REPLAY_COMMAND(UpdateBuffer(GetStandIn<Buffer>(Destination.Id), OffsetInBytes, SizeInBytes, SourceData));
+                }
+
+                DumpArgs(OutText, "Destination", Destination, "OffsetInBytes", OffsetInBytes, "SizeInBytes", SizeInBytes);
+                break;
+            }
+            case ECaptureCommand::UpdateTexture2D:
+            {
+                const CaptureResourceId Destination = ReadResourceId(Reader);
+                const uint32 Width       = Reader.Read<uint32>();
+                const uint32 Height      = Reader.Read<uint32>();
+                const uint32 MipLevel    = Reader.Read<uint32>();
+                const uint64 SizeInBytes = Reader.Read<uint64>();
+                const void*  SourceData  = Reader.ReadPayload(SizeInBytes);
+                if (SourceData)
+                {
+                    REPLAY_COMMAND(UpdateTexture2D(GetStandIn<Texture2D>(Destination.Id), Width, Height, MipLevel, SourceData));
+                }
+
+                DumpArgs(OutText, "Destination", Destination, "Width", Width, "Height", Height, "MipLevel", MipLevel);
+                break;
+            }
+            case ECaptureCommand::ResolveTexture:
+            case ECaptureCommand::CopyTexture:
+            {
+                const CaptureResourceId Destination = ReadResourceId(Reader);
+                const CaptureResourceId Source      = ReadResourceId(Reader);
+                if (Command == ECaptureCommand::ResolveTexture)
+                {
+                    REPLAY_COMMAND(ResolveTexture(GetStandIn<Texture>(Destination.Id), GetStandIn<Texture>(Source.Id)));
+                }
+                else
+                {
+                    REPLAY_COMMAND(CopyTexture(GetStandIn<Texture>(Destination.Id), GetStandIn<Texture>(Source.Id)));
+                }
+
+                DumpArgs(OutText, "Destination", Destination, "Source", Source);
+                break;
+            }
+            case ECaptureCommand::CopyBuffer:
+            {
+                const CaptureResourceId Destination = ReadResourceId(Reader);
+                const CaptureResourceId Source      = ReadResourceId(Reader);
+
+                CopyBufferInfo CopyInfo;
+                CopyInfo.SourceOffset      = Reader.Read<uint64>();
+                CopyInfo.DestinationOffset = Reader.Read<uint32>();
+                CopyInfo.SizeInBytes       = Reader.Read<uint32>();
+
+                REPLAY_COMMAND(CopyBuffer(GetStandIn<Buffer>(Destination.Id), GetStandIn<Buffer>(Source.Id), CopyInfo));
+                DumpArgs(OutText,
+                    "Destination", Destination,
+                    "Source", Source,
+                    "SourceOffset", CopyInfo.SourceOffset,
+                    "DestinationOffset", CopyInfo.DestinationOffset,
+                    "SizeInBytes", CopyInfo.SizeInBytes);
+                break;
+            }
+            case ECaptureCommand::CopyTextureRegion:
+            {
+                const CaptureResourceId Destination = ReadResourceId(Reader);
+                const CaptureResourceId Source      = ReadResourceId(Reader);
+                const CopyTextureInfo CopyInfo = Reader.Read<CopyTextureInfo>();
+                REPLAY_COMMAND(CopyTextureRegion(GetStandIn<Texture>(Destination.Id), GetStandIn<Texture>(Source.Id), CopyInfo));
+                DumpArgs(OutText, "Destination", Destination, "Source", Source, "Width", CopyInfo.Width, "Height", CopyInfo.Height, "Depth", CopyInfo.Depth);
+                break;
+            }
+            case ECaptureCommand::DiscardResource:
+            {
+                const CaptureResourceId DiscardedResource = ReadResourceId(Reader);
+                REPLAY_COMMAND(DiscardResource(GetStandIn<Resource>(DiscardedResource.Id)));
+                DumpArgs(OutText, "Resource", DiscardedResource);
+                break;
+            }
+            case ECaptureCommand::BuildRayTracingGeometry:
+            {
+                const CaptureResourceId Geometry = ReadResourceId(Reader);
+                const CaptureResourceId Vertices = ReadResourceId(Reader);
+                const CaptureResourceId Indices  = ReadResourceId(Reader);
+                const bool Update = Reader.Read<bool>();
+                REPLAY_COMMAND(BuildRayTracingGeometry(
+                    GetStandIn<RayTracingGeometry>(Geometry.Id),
+                    GetStandIn<VertexBuffer>(Vertices.Id),
+                    GetStandIn<IndexBuffer>(Indices.Id),
+                    Update));
+
+                DumpArgs(OutText, "Geometry", Geometry, "VertexBuffer", Vertices, "IndexBuffer", Indices, "Update", Update);
+                break;
+            }
+            case ECaptureCommand::BuildRayTracingScene:
+            {
+                const CaptureResourceId Scene = ReadResourceId(Reader);
+                const uint32 NumInstances = Reader.Read<uint32>();
+
+                Instances.Clear();
+                for (uint32 i = 0; i < NumInstances && !Reader.HasErrors(); i++)
+                {
+                    RayTracingGeometryInstance& Instance = Instances.EmplaceBack();
+                    Instance.Instance      = MakeSharedRef<RayTracingGeometry>(GetStandIn<RayTracingGeometry>(ReadResourceId(Reader).Id));
+                    Instance.InstanceIndex = Reader.Read<uint32>();
+                    Instance.HitGroupIndex = Reader.Read<uint32>();
+                    Instance.Flags         = Reader.Read<uint32>();
+                    Instance.Mask          = Reader.Read<uint32>();
+                    Instance.Transform     = Reader.Read<XMFLOAT3X4>();
+                }
+
+                const bool Update = Reader.Read<bool>();
+                REPLAY_COMMAND(BuildRayTracingScene(GetStandIn<RayTracingScene>(Scene.Id), Instances.Data(), Instances.Size(), Update));
+                DumpArgs(OutText, "Scene", Scene, "NumInstances", NumInstances, "Update", Update);
+                break;
+            }
+            case ECaptureCommand::SetRayTracingBindings:
+            {
+                const CaptureResourceId Scene         = ReadResourceId(Reader);
+                const CaptureResourceId PipelineState = ReadResourceId(Reader);
+                DumpArgs(OutText, "Scene", Scene, "PipelineState", PipelineState);
+
+                RayTracingShaderResources GlobalResources;
+                RayTracingShaderResources RayGenLocalResources;
+                RayTracingShaderResources MissLocalResources;
+
+                const bool HasGlobalResources = ReadRayTracingResources(GlobalResources, OutText);
+                const bool HasRayGenResources = ReadRayTracingResources(RayGenLocalResources, OutText);
+                const bool HasMissResources   = ReadRayTracingResources(MissLocalResources, OutText);
+
+                const uint32 NumHitGroupResources = Reader.Read<uint32>();
+                HitGroupResources.Resize(NumHitGroupResources);
+                for (uint32 i = 0; i < NumHitGroupResources && !Reader.HasErrors(); i++)
+                {
+                    ReadRayTracingResources(HitGroupResources[i], OutText);
+                }
+
+                REPLAY_COMMAND(SetRayTracingBindings(
+                    GetStandIn<RayTracingScene>(Scene.Id),
+                    GetStandIn<RayTracingPipelineState>(PipelineState.Id),
+                    HasGlobalResources ? &GlobalResources : nullptr,
+                    HasRayGenResources ? &RayGenLocalResources : nullptr,
+                    HasMissResources   ? &MissLocalResources : nullptr,
+                    HitGroupResources.Data(),
+                    HitGroupResources.Size()));
+                break;
+            }
+            case ECaptureCommand::GenerateMips:
+            {
+                const CaptureResourceId TextureId = ReadResourceId(Reader);
+                REPLAY_COMMAND(GenerateMips(GetStandIn<Texture>(TextureId.Id)));
+                DumpArgs(OutText, "Texture", TextureId);
+                break;
+            }
+            case ECaptureCommand::TransitionTexture:
+            {
+                const CaptureResourceId TextureId = ReadResourceId(Reader);
+                const EResourceState AfterState = Reader.Read<EResourceState>();
+                const uint32 Subresource = Reader.Read<uint32>();
+                REPLAY_COMMAND(TransitionTexture(GetStandIn<Texture>(TextureId.Id), AfterState, Subresource));
+                DumpArgs(OutText, "Texture", TextureId, "AfterState", AfterState, "Subresource", Subresource);
+                break;
+            }
+            case ECaptureCommand::TransitionBuffer:
+            {
+                const CaptureResourceId BufferId = ReadResourceId(Reader);
+                const EResourceState AfterState = Reader.Read<EResourceState>();
+                REPLAY_COMMAND(TransitionBuffer(GetStandIn<Buffer>(BufferId.Id), AfterState));
+                DumpArgs(OutText, "Buffer", BufferId, "AfterState", AfterState);
+                break;
+            }
+            case ECaptureCommand::UnorderedAccessTextureBarrier:
+            {
+                const CaptureResourceId TextureId = ReadResourceId(Reader);
+                REPLAY_COMMAND(UnorderedAccessTextureBarrier(GetStandIn<Texture>(TextureId.Id)));
+                DumpArgs(OutText, "Texture", TextureId);
+                break;
+            }
+            case ECaptureCommand::UnorderedAccessBufferBarrier:
+            {
+                const CaptureResourceId BufferId = ReadResourceId(Reader);
+                REPLAY_COMMAND(UnorderedAccessBufferBarrier(GetStandIn<Buffer>(BufferId.Id)));
+                DumpArgs(OutText, "Buffer", BufferId);
+                break;
+            }
+            case ECaptureCommand::Draw:
+            {
+                const uint32 VertexCount         = Reader.Read<uint32>();
+                const uint32 StartVertexLocation = Reader.Read<uint32>();
+                REPLAY_COMMAND(Draw(VertexCount, StartVertexLocation));
+                DumpArgs(OutText, "VertexCount", VertexCount, "StartVertexLocation", StartVertexLocation);
+                break;
+            }
+            case ECaptureCommand::DrawIndexed:
+            {
+                const uint32 IndexCount         = Reader.Read<uint32>();
+                const uint32 StartIndexLocation = Reader.Read<uint32>();
+                const uint32 BaseVertexLocation = Reader.Read<uint32>();
+                REPLAY_COMMAND(DrawIndexed(IndexCount, StartIndexLocation, BaseVertexLocation));
+                DumpArgs(OutText, "IndexCount", IndexCount, "StartIndexLocation", StartIndexLocation, "BaseVertexLocation", BaseVertexLocation);
+                break;
+            }
+            case ECaptureCommand::DrawInstanced:
+            {
+                const uint32 VertexCountPerInstance = Reader.Read<uint32>();
+                const uint32 InstanceCount          = Reader.Read<uint32>();
+                const uint32 StartVertexLocation    = Reader.Read<uint32>();
+                const uint32 StartInstanceLocation  = Reader.Read<uint32>();
+                REPLAY_COMMAND(DrawInstanced(VertexCountPerInstance, InstanceCount, StartVertexLocation, StartInstanceLocation));
+                DumpArgs(OutText,
+                    "VertexCountPerInstance", VertexCountPerInstance,
+                    "InstanceCount", InstanceCount,
+                    "StartVertexLocation", StartVertexLocation,
+                    "StartInstanceLocation", StartInstanceLocation);
+                break;
+            }
+            case ECaptureCommand::DrawIndexedInstanced:
+            {
+                const uint32 IndexCountPerInstance = Reader.Read<uint32>();
+                const uint32 InstanceCount         = Reader.Read<uint32>();
+                const uint32 StartIndexLocation    = Reader.Read<uint32>();
+                const uint32 BaseVertexLocation    = Reader.Read<uint32>();
+                const uint32 StartInstanceLocation = Reader.Read<uint32>();
+                REPLAY_COMMAND(DrawIndexedInstanced(IndexCountPerInstance, InstanceCount, StartIndexLocation, BaseVertexLocation, StartInstanceLocation));
+                DumpArgs(OutText,
+                    "IndexCountPerInstance", IndexCountPerInstance,
+                    "InstanceCount", InstanceCount,
+                    "StartIndexLocation", StartIndexLocation,
+                    "BaseVertexLocation", BaseVertexLocation,
+                    "StartInstanceLocation", StartInstanceLocation);
+                break;
+            }
+            case ECaptureCommand::Dispatch:
+            {
+                const uint32 WorkGroupsX = Reader.Read<uint32>();
+                const uint32 WorkGroupsY = Reader.Read<uint32>();
+                const uint32 WorkGroupsZ = Reader.Read<uint32>();
+                REPLAY_COMMAND(Dispatch(WorkGroupsX, WorkGroupsY, WorkGroupsZ));
+                DumpArgs(OutText, "WorkGroupsX", WorkGroupsX, "WorkGroupsY", WorkGroupsY, "WorkGroupsZ", WorkGroupsZ);
+                break;
+            }
+            case ECaptureCommand::DispatchRays:
+            {
+                const CaptureResourceId Scene         = ReadResourceId(Reader);
+                const CaptureResourceId PipelineState = ReadResourceId(Reader);
+                const uint32 Width  = Reader.Read<uint32>();
+                const uint32 Height = Reader.Read<uint32>();
+                const uint32 Depth  = Reader.Read<uint32>();
+                REPLAY_COMMAND(DispatchRays(GetStandIn<RayTracingScene>(Scene.Id), GetStandIn<RayTracingPipelineState>(PipelineState.Id), Width, Height, Depth));
+                DumpArgs(OutText, "Scene", Scene, "PipelineState", PipelineState, "Width", Width, "Height", Height, "Depth", Depth);
+                break;
+            }
+            case ECaptureCommand::ClearState:
+            {
+                REPLAY_COMMAND(ClearState());
+                break;
+            }
+            case ECaptureCommand::Flush:
+            {
+                REPLAY_COMMAND(Flush());
+                break;
+            }
+            case ECaptureCommand::InsertMarker:
+            {
+                const std::string Message = Reader.ReadString();
+                REPLAY_COMMAND(InsertMarker(Message));
+                DumpArgs(OutText, "Message", Message);
+                break;
+            }
+            case ECaptureCommand::BeginExternalCapture:
+            {
+                REPLAY_COMMAND(BeginExternalCapture());
+                break;
+            }
+            case ECaptureCommand::EndExternalCapture:
+            {
+                REPLAY_COMMAND(EndExternalCapture());
+                break;
+            }
+            default:
+            {
+                LOG_ERROR("[CommandListReplayer]: Unknown command in capture");
+                return false;
+            }
+        }
+
+        if (OutText)
+        {
+            *OutText += '\n';
+        }
+
+        if (OutStatistics)
+        {
+            const uint32 CommandIndex = uint32(Command);
+            OutStatistics->NumCommands[CommandIndex]++;
+            OutStatistics->Nanoseconds[CommandIndex] += (CommandTicks * NANOSECONDS) / Frequency;
+        }
+    }
+
+    if (OutStatistics)
+    {
+        // Total includes the decoding of the stream
+        const uint64 StreamTicks = PlatformTime::QueryPerformanceCounter() - StreamStartTicks;
+        OutStatistics->TotalNanoseconds += (StreamTicks * NANOSECONDS) / Frequency;
+    }
+
+    if (Reader.HasErrors())
+    {
+        LOG_ERROR("[CommandListReplayer]: Capture is truncated");
+        return false;
+    }
+
+    return true;
+}
\ No newline at end of file
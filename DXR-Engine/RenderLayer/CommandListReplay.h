@@ -0,0 +1,77 @@
+#pragma once
+#include "CommandListCapture.h"
+
+struct CommandReplayStatistics
+{
+    CommandReplayStatistics()
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        Memory::Memzero(NumCommands, sizeof(NumCommands));
+        Memory::Memzero(Nanoseconds, sizeof(Nanoseconds));
+        TotalNanoseconds = 0;
+    }
+
+    // Formats the statistics as a table with one row per command type that was executed
+    std::string ToString() const;
+
+    uint32 NumCommands[uint32(ECaptureCommand::Count)];
+    uint64 Nanoseconds[uint32(ECaptureCommand::Count)];
+    uint64 TotalNanoseconds;
+};
+
+/*
+* Replays a CommandListCapture against an ICommandContext. The resources in the capture are replaced by stand-ins
+* created with the current RenderLayer from the recorded descriptions. Shaders and pipelines can not be recreated
+* from a capture, which means that the stand-ins are only meaningful on the NullRenderLayer, where the replay is used
+* to measure the cost of the command stream itself.
+*/
+
+class CommandListReplayer
+{
+public:
+    CommandListReplayer(const CommandListCapture& InCapture)
+        : Capture(InCapture)
+        , StandIns()
+        , StandInOwners()
+    {
+    }
+
+    ~CommandListReplayer() = default;
+
+    // Creates the stand-in resources, must be called before Replay
+    bool CreateResources();
+
+    // Replays all the commands, the time is measured around each call to the context
+    bool Replay(ICommandContext& CmdContext, CommandReplayStatistics& OutStatistics);
+
+    // Writes the command stream as text, one command per line, which makes it possible to diff two captures
+    std::string DumpToString();
+
+private:
+    bool ExecuteStream(ICommandContext* CmdContext, CommandReplayStatistics* OutStatistics, std::string* OutText);
+
+    Resource* CreateStandIn(const CaptureResourceDesc& Desc);
+
+    template<typename TResource>
+    TResource* GetStandIn(uint32 Id) const
+    {
+        if (Id == 0 || Id > StandIns.Size())
+        {
+            return nullptr;
+        }
+
+        return dynamic_cast<TResource*>(StandIns[Id - 1].Get());
+    }
+
+    const CommandListCapture& Capture;
+
+    // Index is the id of the resource minus one
+    TArray<TRef<Resource>> StandIns;
+
+    // Views are created from stand-in textures that are kept here
+    TArray<TRef<Resource>> StandInOwners;
+};
\ No newline at end of file
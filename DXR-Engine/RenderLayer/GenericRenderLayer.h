@@ -15,6 +15,7 @@ enum class ERenderLayerApi : uint32
 {
     Unknown = 0,
     D3D12   = 1,
+    Null    = 2,
 };
 
 inline const char* ToString(ERenderLayerApi RenderLayerApi)
@@ -22,6 +23,7 @@ inline const char* ToString(ERenderLayerApi RenderLayerApi)
     switch (RenderLayerApi)
     {
         case ERenderLayerApi::D3D12: return "D3D12";
+        case ERenderLayerApi::Null:  return "Null";
         default: return "Unknown";
     }
 }
@@ -125,7 +127,7 @@ public:
     virtual StructuredBuffer* CreateStructuredBuffer(uint32 Stride, uint32 NumElements, uint32 Flags, EResourceState InitialState, const ResourceData* InitalData) = 0;
 
     virtual RayTracingScene* CreateRayTracingScene(uint32 Flags, RayTracingGeometryInstance* Instances, uint32 NumInstances) = 0;
-    virtual RayTracingGeometry* CreateRayTracingGeometry(uint32 Flags, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer) = 0;
+    virtual RayTracingGeometry* CreateRayTracingGeometry(uint32 Flags, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer, EFormat VertexFormat) = 0;
 
     virtual ShaderResourceView* CreateShaderResourceView(const ShaderResourceViewCreateInfo& CreateInfo) = 0;
     virtual UnorderedAccessView* CreateUnorderedAccessView(const UnorderedAccessViewCreateInfo& CreateInfo) = 0;
@@ -309,9 +311,11 @@ FORCEINLINE RayTracingScene* CreateRayTracingScene(uint32 Flags, RayTracingGeome
     return gRenderLayer->CreateRayTracingScene(Flags, Instances, NumInstances);
 }
 
-FORCEINLINE RayTracingGeometry* CreateRayTracingGeometry(uint32 Flags, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer)
+// VertexFormat is the format of the position at the start of each vertex, the fourth component of a four component
+// format is ignored
+FORCEINLINE RayTracingGeometry* CreateRayTracingGeometry(uint32 Flags, VertexBuffer* VertexBuffer, IndexBuffer* IndexBuffer, EFormat VertexFormat = EFormat::R32G32B32_Float)
 {
-    return gRenderLayer->CreateRayTracingGeometry(Flags, VertexBuffer, IndexBuffer);
+    return gRenderLayer->CreateRayTracingGeometry(Flags, VertexBuffer, IndexBuffer, VertexFormat);
 }
 
 FORCEINLINE ShaderResourceView* CreateShaderResourceView(const ShaderResourceViewCreateInfo& CreateInfo)
@@ -401,6 +405,7 @@ FORCEINLINE ShaderResourceView* CreateShaderResourceView(
     return CreateShaderResourceView(CreateInfo);
 }
 
+// Views of vertex and index buffers are raw views, which are read with a ByteAddressBuffer
 FORCEINLINE ShaderResourceView* CreateShaderResourceView(VertexBuffer* Buffer, uint32 FirstVertex, uint32 NumVertices)
 {
     ShaderResourceViewCreateInfo CreateInfo(ShaderResourceViewCreateInfo::EType::VertexBuffer);
@@ -77,8 +77,9 @@ public:
 
     virtual void GenerateMips(Texture* Texture) = 0;
 
-    virtual void TransitionTexture(Texture* Texture, EResourceState BeforeState, EResourceState AfterState) = 0;
-    virtual void TransitionBuffer(Buffer* Buffer, EResourceState BeforeState, EResourceState AfterState) = 0;
+    // The state before the transition is tracked by the context, redundant transitions are removed
+    virtual void TransitionTexture(Texture* Texture, EResourceState AfterState, uint32 Subresource) = 0;
+    virtual void TransitionBuffer(Buffer* Buffer, EResourceState AfterState) = 0;
 
     virtual void UnorderedAccessTextureBarrier(Texture* Texture) = 0;
     virtual void UnorderedAccessBufferBarrier(Buffer* Buffer) = 0;
@@ -0,0 +1,181 @@
+#include "ParallelCommandListRecorder.h"
+
+#include "Core/Threading/TaskManager.h"
+#include "Core/Threading/ScopedLock.h"
+
+ParallelCommandListRecorder::~ParallelCommandListRecorder()
+{
+    WaitForRecording();
+
+    // The tasks refer to the recorder, so the ones that are still queued have to run before it is destroyed
+    TScopedLock<Mutex> Lock(CompletedMutex);
+    while (NumQueuedTasks.Load() > 0)
+    {
+        CompletedCondition.Wait(Lock);
+    }
+}
+
+CommandList& ParallelCommandListRecorder::BeginCommandList()
+{
+    RecordEntry& Entry = AllocateEntry();
+    return Entry.CmdList;
+}
+
+void ParallelCommandListRecorder::RecordAsync(const RecordCommandListDelegate& RecordFunc)
+{
+    RecordEntry& Entry = AllocateEntry();
+    Entry.RangeBegin = 0;
+    Entry.RangeEnd   = 0;
+    Entry.RecordFunc.BindLambda([RecordFunc](CommandList& CmdList, uint32, uint32)
+    {
+        RecordCommandListDelegate Func = RecordFunc;
+        Func(CmdList);
+    });
+
+    DispatchEntry(Entry);
+}
+
+void ParallelCommandListRecorder::RecordRangeAsync(uint32 NumItems, uint32 MaxCommandLists, uint32 MinItemsPerCommandList, const RecordCommandListRangeDelegate& RecordFunc)
+{
+    if (NumItems == 0)
+    {
+        return;
+    }
+
+    const uint32 MinItems      = Math::Max<uint32>(MinItemsPerCommandList, 1);
+    const uint32 NumRanges     = Math::Max<uint32>(Math::Min<uint32>(MaxCommandLists, NumItems / MinItems), 1);
+    const uint32 ItemsPerRange = NumItems / NumRanges;
+    const uint32 Remainder     = NumItems % NumRanges;
+
+    uint32 RangeBegin = 0;
+    for (uint32 i = 0; i < NumRanges; i++)
+    {
+        // Spread the remainder over the first ranges so that all lists are roughly the same size
+        const uint32 RangeSize = ItemsPerRange + (i < Remainder ? 1 : 0);
+
+        RecordEntry& Entry = AllocateEntry();
+        Entry.RangeBegin = RangeBegin;
+        Entry.RangeEnd   = RangeBegin + RangeSize;
+        Entry.RecordFunc = RecordFunc;
+
+        DispatchEntry(Entry);
+
+        RangeBegin += RangeSize;
+    }
+
+    Assert(RangeBegin == NumItems);
+}
+
+void ParallelCommandListRecorder::WaitForRecording()
+{
+    while (RecordPendingEntry())
+    {
+    }
+
+    // Only entries that workers are recording are left. The workers increment the counter while holding the lock, so a
+    // notification can not be missed between the check and the wait.
+    TScopedLock<Mutex> Lock(CompletedMutex);
+    while (NumCompletedTasks.Load() < NumDispatchedTasks.Load())
+    {
+        CompletedCondition.Wait(Lock);
+    }
+}
+
+void ParallelCommandListRecorder::Execute(CommandListExecutor& Executor)
+{
+    WaitForRecording();
+
+    NumDrawCalls     = 0;
+    NumDispatchCalls = 0;
+    NumCommands      = 0;
+
+    SubmitCmdLists.Clear();
+    for (uint32 i = 0; i < NumCommandLists; i++)
+    {
+        CommandList& CmdList = Entries[i]->CmdList;
+        NumDrawCalls     += CmdList.GetNumDrawCalls();
+        NumDispatchCalls += CmdList.GetNumDispatchCalls();
+        NumCommands      += CmdList.GetNumCommands();
+
+        SubmitCmdLists.EmplaceBack(&CmdList);
+    }
+
+    Executor.ExecuteCommandLists(SubmitCmdLists.Data(), SubmitCmdLists.Size());
+
+    Reset();
+}
+
+void ParallelCommandListRecorder::Reset()
+{
+    WaitForRecording();
+
+    for (uint32 i = 0; i < NumCommandLists; i++)
+    {
+        RecordEntry& Entry = *Entries[i];
+        Entry.CmdList.Reset();
+        Entry.RecordFunc.Unbind();
+    }
+
+    NumCommandLists = 0;
+    NumDispatchedTasks.Store(0);
+    NumCompletedTasks.Store(0);
+}
+
+ParallelCommandListRecorder::RecordEntry& ParallelCommandListRecorder::AllocateEntry()
+{
+    // Entries are heap allocated so that workers can hold on to them while the array grows
+    if (NumCommandLists >= Entries.Size())
+    {
+        Entries.EmplaceBack(MakeUnique<RecordEntry>());
+    }
+
+    return *Entries[NumCommandLists++];
+}
+
+void ParallelCommandListRecorder::DispatchEntry(RecordEntry& Entry)
+{
+    NumDispatchedTasks.Increment();
+    NumQueuedTasks.Increment();
+
+    {
+        TScopedLock<Mutex> Lock(PendingMutex);
+        PendingEntries.EmplaceBack(&Entry);
+    }
+
+    ParallelCommandListRecorder* Recorder = this;
+
+    Task RecordTask;
+    RecordTask.Delegate.BindLambda([Recorder]()
+    {
+        Recorder->RecordPendingEntry();
+
+        TScopedLock<Mutex> Lock(Recorder->CompletedMutex);
+        Recorder->NumQueuedTasks.Decrement();
+        Recorder->CompletedCondition.NotifyAll();
+    });
+
+    TaskManager::Get().AddTask(RecordTask);
+}
+
+bool ParallelCommandListRecorder::RecordPendingEntry()
+{
+    RecordEntry* Entry = nullptr;
+    {
+        TScopedLock<Mutex> Lock(PendingMutex);
+        if (PendingEntries.IsEmpty())
+        {
+            return false;
+        }
+
+        Entry = PendingEntries.Back();
+        PendingEntries.PopBack();
+    }
+
+    Entry->RecordFunc(Entry->CmdList, Entry->RangeBegin, Entry->RangeEnd);
+
+    TScopedLock<Mutex> Lock(CompletedMutex);
+    NumCompletedTasks.Increment();
+    CompletedCondition.NotifyAll();
+
+    return true;
+}
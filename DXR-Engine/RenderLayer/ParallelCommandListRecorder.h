@@ -0,0 +1,90 @@
+#pragma once
+#include "CommandList.h"
+
+#include "Core/Threading/ThreadSafeInt.h"
+#include "Core/Threading/Platform/Mutex.h"
+#include "Core/Threading/Platform/ConditionVariable.h"
+#include "Core/Delegates/Delegate.h"
+
+typedef TDelegate<void(CommandList&)>                 RecordCommandListDelegate;
+typedef TDelegate<void(CommandList&, uint32, uint32)> RecordCommandListRangeDelegate;
+
+/*
+* Records a frame into several CommandLists, some of them on the TaskManager's workers, and submits them to the 
+* CommandListExecutor in the order that they were requested. Each CommandList owns its own LinearAllocator so 
+* recording threads never share memory. The CommandLists are kept between frames to reuse the allocators.
+*/
+
+class ParallelCommandListRecorder
+{
+public:
+    ParallelCommandListRecorder() = default;
+    ~ParallelCommandListRecorder();
+
+    // Returns a CommandList that is recorded on the calling thread
+    CommandList& BeginCommandList();
+
+    // Records a CommandList on a worker thread
+    void RecordAsync(const RecordCommandListDelegate& RecordFunc);
+
+    /*
+    * Splits [0, NumItems) into at most MaxCommandLists ranges of at least MinItemsPerCommandList items and records 
+    * each range into its own CommandList on a worker thread. The ranges are submitted in ascending order. 
+    */
+    void RecordRangeAsync(uint32 NumItems, uint32 MaxCommandLists, uint32 MinItemsPerCommandList, const RecordCommandListRangeDelegate& RecordFunc);
+
+    // Records the CommandLists that no worker has started on the calling thread, and then waits for the rest
+    void WaitForRecording();
+
+    // Waits for all recording tasks and executes all CommandLists in submission order
+    void Execute(CommandListExecutor& Executor);
+
+    void Reset();
+
+    uint32 GetNumDrawCalls()     const { return NumDrawCalls; }
+    uint32 GetNumDispatchCalls() const { return NumDispatchCalls; }
+    uint32 GetNumCommands()      const { return NumCommands; }
+    uint32 GetNumCommandLists()  const { return NumCommandLists; }
+
+private:
+    struct RecordEntry
+    {
+        CommandList CmdList;
+        RecordCommandListRangeDelegate RecordFunc;
+        uint32 RangeBegin = 0;
+        uint32 RangeEnd   = 0;
+    };
+
+    RecordEntry& AllocateEntry();
+
+    void DispatchEntry(RecordEntry& Entry);
+
+    // Records one of the pending entries, returns false if there were none
+    bool RecordPendingEntry();
+
+    TArray<TUniquePtr<RecordEntry>> Entries;
+    TArray<CommandList*> SubmitCmdLists;
+
+    uint32 NumCommandLists = 0;
+
+    // Entries that have been dispatched but that nobody has started to record. Each entry has a task on the
+    // TaskManager, but the task records whichever entry is pending when it runs, so that the calling thread can take
+    // entries in WaitForRecording without waiting for the tasks to be scheduled.
+    TArray<RecordEntry*> PendingEntries;
+    Mutex                PendingMutex;
+
+    ThreadSafeInt32 NumDispatchedTasks;
+    ThreadSafeInt32 NumCompletedTasks;
+
+    // Tasks that have not run yet, a task can outlive the frame that it was dispatched in if the entry was recorded
+    // by the calling thread
+    ThreadSafeInt32 NumQueuedTasks;
+
+    // WaitForRecording sleeps on the condition until the last worker has finished, instead of spinning
+    Mutex             CompletedMutex;
+    ConditionVariable CompletedCondition;
+
+    uint32 NumDrawCalls     = 0;
+    uint32 NumDispatchCalls = 0;
+    uint32 NumCommands      = 0;
+};
\ No newline at end of file
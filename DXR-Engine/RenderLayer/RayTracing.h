@@ -25,15 +25,20 @@ enum ERayTracingInstanceFlags
 class RayTracingGeometry : public Resource
 {
 public:
-    RayTracingGeometry(uint32 InFlags)
+    RayTracingGeometry(uint32 InFlags, EFormat InVertexFormat)
         : Flags(InFlags)
+        , VertexFormat(InVertexFormat)
     {
     }
 
     uint32 GetFlags() const { return Flags; }
 
+    // Format of the positions, which are the first element of each vertex
+    EFormat GetVertexFormat() const { return VertexFormat; }
+
 private:
-    uint32 Flags;
+    uint32  Flags;
+    EFormat VertexFormat;
 };
 
 // RayTracing Scene (Top Level Acceleration Structure)
@@ -860,40 +860,38 @@ struct GenerateMipsRenderCommand : public RenderCommand
 // TransitionTexture RenderCommand
 struct TransitionTextureRenderCommand : public RenderCommand
 {
-    TransitionTextureRenderCommand(Texture* InTexture, EResourceState InBeforeState, EResourceState InAfterState)
+    TransitionTextureRenderCommand(Texture* InTexture, EResourceState InAfterState, uint32 InSubresource)
         : Texture(InTexture)
-        , BeforeState(InBeforeState)
         , AfterState(InAfterState)
+        , Subresource(InSubresource)
     {
     }
 
     virtual void Execute(ICommandContext& CmdContext) override
     {
-        CmdContext.TransitionTexture(Texture.Get(), BeforeState, AfterState);
+        CmdContext.TransitionTexture(Texture.Get(), AfterState, Subresource);
     }
 
     TRef<Texture> Texture;
-    EResourceState BeforeState;
     EResourceState AfterState;
+    uint32 Subresource;
 };
 
 // TransitionBuffer RenderCommand
 struct TransitionBufferRenderCommand : public RenderCommand
 {
-    TransitionBufferRenderCommand(Buffer* InBuffer, EResourceState InBeforeState, EResourceState InAfterState)
+    TransitionBufferRenderCommand(Buffer* InBuffer, EResourceState InAfterState)
         : Buffer(InBuffer)
-        , BeforeState(InBeforeState)
         , AfterState(InAfterState)
     {
     }
 
     virtual void Execute(ICommandContext& CmdContext) override
     {
-        CmdContext.TransitionBuffer(Buffer.Get(), BeforeState, AfterState);
+        CmdContext.TransitionBuffer(Buffer.Get(), AfterState);
     }
 
     TRef<Buffer> Buffer;
-    EResourceState BeforeState;
     EResourceState AfterState;
 };
 
@@ -1,12 +1,18 @@
 #include "RenderLayer.h"
 #include "CommandList.h"
 
-#include "D3D12/D3D12RenderLayer.h"
-#include "D3D12/D3D12ShaderCompiler.h"
+#ifdef PLATFORM_WINDOWS
+    #include "D3D12/D3D12RenderLayer.h"
+    #include "D3D12/D3D12ShaderCompiler.h"
+#endif
+
+#include "Null/NullRenderLayer.h"
+#include "Null/NullShaderCompiler.h"
 
 bool RenderLayer::Init(ERenderLayerApi InRenderApi)
 {
     // Select RenderLayer
+#ifdef PLATFORM_WINDOWS
     if (InRenderApi == ERenderLayerApi::D3D12)
     {
         gRenderLayer = DBG_NEW D3D12RenderLayer();
@@ -20,6 +26,13 @@ bool RenderLayer::Init(ERenderLayerApi InRenderApi)
         gShaderCompiler = Compiler;
     }
     else
+#endif
+    if (InRenderApi == ERenderLayerApi::Null)
+    {
+        gRenderLayer    = DBG_NEW NullRenderLayer();
+        gShaderCompiler = DBG_NEW NullShaderCompiler();
+    }
+    else
     {
         LOG_ERROR("[RenderLayer::Init] Invalid RenderLayer enum");
         
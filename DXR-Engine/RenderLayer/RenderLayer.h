@@ -6,6 +6,10 @@
 #define ENABLE_API_GPU_DEBUGGING   0
 #define ENABLE_API_GPU_BREADCRUMBS 0
 
+// Always run the renderer on the NullRenderLayer, used to benchmark the CPU-side of the renderer without a GPU. Without
+// this the NullRenderLayer is selected at startup with the -nullrhi argument.
+#define ENABLE_NULL_RENDER_LAYER   0
+
 class RenderLayer
 {
 public:
@@ -93,6 +93,18 @@ enum class EFormat
     R8_Uint                  = 62,
     R8_Snorm                 = 63,
     R8_Sint                  = 64,
+    BC1_Typeless             = 70,
+    BC1_Unorm                = 71,
+    BC1_Unorm_SRGB           = 72,
+    BC4_Typeless             = 79,
+    BC4_Unorm                = 80,
+    BC4_Snorm                = 81,
+    BC5_Typeless             = 82,
+    BC5_Unorm                = 83,
+    BC5_Snorm                = 84,
+    BC7_Typeless             = 97,
+    BC7_Unorm                = 98,
+    BC7_Unorm_SRGB           = 99,
 };
 
 inline const char* ToString(EFormat Format)
@@ -159,6 +171,18 @@ inline const char* ToString(EFormat Format)
     case EFormat::R8_Uint:                  return "R8_Uint";
     case EFormat::R8_Snorm:                 return "R8_Snorm";
     case EFormat::R8_Sint:                  return "R8_Sint";
+    case EFormat::BC1_Typeless:             return "BC1_Typeless";
+    case EFormat::BC1_Unorm:                return "BC1_Unorm";
+    case EFormat::BC1_Unorm_SRGB:           return "BC1_Unorm_SRGB";
+    case EFormat::BC4_Typeless:             return "BC4_Typeless";
+    case EFormat::BC4_Unorm:                return "BC4_Unorm";
+    case EFormat::BC4_Snorm:                return "BC4_Snorm";
+    case EFormat::BC5_Typeless:             return "BC5_Typeless";
+    case EFormat::BC5_Unorm:                return "BC5_Unorm";
+    case EFormat::BC5_Snorm:                return "BC5_Snorm";
+    case EFormat::BC7_Typeless:             return "BC7_Typeless";
+    case EFormat::BC7_Unorm:                return "BC7_Unorm";
+    case EFormat::BC7_Unorm_SRGB:           return "BC7_Unorm_SRGB";
     default: return "Unknown";
     }
 }
@@ -258,6 +282,61 @@ inline uint32 GetByteStrideFromFormat(EFormat Format)
     }
 }
 
+// Block compressed formats store blocks of 4x4 texels, GetByteStrideFromFormat returns zero for them
+inline bool IsBlockCompressed(EFormat Format)
+{
+    return (Format >= EFormat::BC1_Typeless && Format <= EFormat::BC7_Unorm_SRGB);
+}
+
+inline uint32 GetBlockSizeFromFormat(EFormat Format)
+{
+    switch (Format)
+    {
+        case EFormat::BC1_Typeless:
+        case EFormat::BC1_Unorm:
+        case EFormat::BC1_Unorm_SRGB:
+        case EFormat::BC4_Typeless:
+        case EFormat::BC4_Unorm:
+        case EFormat::BC4_Snorm:
+        {
+            return 8;
+        }
+
+        case EFormat::BC5_Typeless:
+        case EFormat::BC5_Unorm:
+        case EFormat::BC5_Snorm:
+        case EFormat::BC7_Typeless:
+        case EFormat::BC7_Unorm:
+        case EFormat::BC7_Unorm_SRGB:
+        {
+            return 16;
+        }
+
+        default:
+        {
+            return 0;
+        }
+    }
+}
+
+// Size of one row of texels, or of one row of blocks for block compressed formats
+inline uint32 GetRowPitchFromFormat(EFormat Format, uint32 Width)
+{
+    if (IsBlockCompressed(Format))
+    {
+        return ((Width + 3) / 4) * GetBlockSizeFromFormat(Format);
+    }
+    else
+    {
+        return Width * GetByteStrideFromFormat(Format);
+    }
+}
+
+inline uint32 GetNumRowsFromFormat(EFormat Format, uint32 Height)
+{
+    return IsBlockCompressed(Format) ? (Height + 3) / 4 : Height;
+}
+
 enum class EComparisonFunc
 {
     Never        = 1,
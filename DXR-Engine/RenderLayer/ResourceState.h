@@ -0,0 +1,96 @@
+#pragma once
+#include "RenderingCore.h"
+
+#include "Core/Containers/Array.h"
+
+// Used as subresource to transition all subresources of a resource
+constexpr uint32 ALL_SUBRESOURCES = uint32(~0);
+
+// Mips are stored before array slices, which is the same layout as D3D12 uses for plane zero
+inline uint32 CalculateSubresource(uint32 MipLevel, uint32 ArraySlice, uint32 NumMips)
+{
+    return MipLevel + (ArraySlice * NumMips);
+}
+
+/*
+* Tracks the current state of a resource on the GPU-timeline. As long as all subresources are in the same state only
+* a single state is stored, the per subresource states are allocated the first time a single subresource is
+* transitioned and are dropped again when all subresources end up in the same state.
+*/
+
+class ResourceStateTracker
+{
+public:
+    ResourceStateTracker(EResourceState InitialState = EResourceState::Common)
+        : UniformState(InitialState)
+        , SubresourceStates()
+    {
+    }
+
+    // Sets the state of all subresources
+    void SetState(EResourceState State)
+    {
+        UniformState = State;
+        SubresourceStates.Clear();
+    }
+
+    void SetSubresourceState(uint32 Subresource, EResourceState State, uint32 NumSubresources)
+    {
+        if (Subresource == ALL_SUBRESOURCES)
+        {
+            SetState(State);
+            return;
+        }
+
+        Assert(Subresource < NumSubresources);
+
+        if (SubresourceStates.IsEmpty())
+        {
+            if (UniformState == State)
+            {
+                return;
+            }
+
+            SubresourceStates.Resize(NumSubresources, UniformState);
+        }
+
+        SubresourceStates[Subresource] = State;
+
+        // Go back to a single state when the last subresource that differed is transitioned
+        for (EResourceState SubresourceState : SubresourceStates)
+        {
+            if (SubresourceState != State)
+            {
+                return;
+            }
+        }
+
+        SetState(State);
+    }
+
+    // Only valid when all subresources are in the same state
+    EResourceState GetState() const
+    {
+        Assert(IsUniform());
+        return UniformState;
+    }
+
+    EResourceState GetSubresourceState(uint32 Subresource) const
+    {
+        if (SubresourceStates.IsEmpty())
+        {
+            return UniformState;
+        }
+
+        Assert(Subresource < SubresourceStates.Size());
+        return SubresourceStates[Subresource];
+    }
+
+    bool IsUniform() const { return SubresourceStates.IsEmpty(); }
+
+    uint32 GetNumTrackedSubresources() const { return SubresourceStates.Size(); }
+
+private:
+    EResourceState UniformState;
+    TArray<EResourceState> SubresourceStates;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "ResourceBase.h"
+#include "ResourceState.h"
 
 enum ETextureFlags
 {
@@ -26,6 +27,7 @@ public:
         , NumMips(InNumMips)
         , Flags(InFlags)
         , OptimalClearValue(InOptimalClearValue)
+        , StateTracker()
     {
     }
 
@@ -46,6 +48,10 @@ public:
 
     const ClearValue& GetOptimalClearValue() const { return OptimalClearValue; }
 
+    // The state is updated by the RenderLayer when a transition is executed
+    ResourceStateTracker& GetStateTracker() { return StateTracker; }
+    const ResourceStateTracker& GetStateTracker() const { return StateTracker; }
+
     // Checks weather a default shaderrsourceview is created by the renderlayer
     bool IsUAV() const { return (Flags & TextureFlag_UAV) && !(Flags & TextureFlag_NoDefaultUAV); }
     bool IsSRV() const { return (Flags & TextureFlag_SRV) && !(Flags & TextureFlag_NoDefaultSRV); }
@@ -57,6 +63,7 @@ private:
     uint32  NumMips;
     uint32  Flags;
     ClearValue OptimalClearValue;
+    ResourceStateTracker StateTracker;
 };
 
 class Texture2D : public Texture
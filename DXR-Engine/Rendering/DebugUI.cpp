@@ -643,8 +643,8 @@ void DebugUI::Render(CommandList& CmdList)
     CmdList.SetBlendFactor(ColorF(0.0f, 0.0f, 0.0f, 0.0f));
 
     // TODO: Do not change to GenericRead, change to vertex/constantbuffer
-    CmdList.TransitionBuffer(GlobalImGuiState.VertexBuffer.Get(), EResourceState::GenericRead, EResourceState::CopyDest);
-    CmdList.TransitionBuffer(GlobalImGuiState.IndexBuffer.Get(), EResourceState::GenericRead, EResourceState::CopyDest);
+    CmdList.TransitionBuffer(GlobalImGuiState.VertexBuffer.Get(), EResourceState::CopyDest);
+    CmdList.TransitionBuffer(GlobalImGuiState.IndexBuffer.Get(), EResourceState::CopyDest);
 
     uint32 VertexOffset = 0;
     uint32 IndexOffset  = 0;
@@ -662,8 +662,8 @@ void DebugUI::Render(CommandList& CmdList)
         IndexOffset  += IndexSize;
     }
 
-    CmdList.TransitionBuffer(GlobalImGuiState.VertexBuffer.Get(), EResourceState::CopyDest, EResourceState::GenericRead);
-    CmdList.TransitionBuffer(GlobalImGuiState.IndexBuffer.Get(), EResourceState::CopyDest, EResourceState::GenericRead);
+    CmdList.TransitionBuffer(GlobalImGuiState.VertexBuffer.Get(), EResourceState::GenericRead);
+    CmdList.TransitionBuffer(GlobalImGuiState.IndexBuffer.Get(), EResourceState::GenericRead);
 
     CmdList.SetSamplerState(GlobalImGuiState.PShader.Get(), GlobalImGuiState.PointSampler.Get(), 0);
 
@@ -683,13 +683,7 @@ void DebugUI::Render(CommandList& CmdList)
                 ImGuiImage* Image = reinterpret_cast<ImGuiImage*>(Cmd->TextureId);
                 GlobalImGuiState.Images.EmplaceBack(Image);
                 
-                if (Image->BeforeState != EResourceState::PixelShaderResource)
-                {
-                    CmdList.TransitionTexture(Image->Image.Get(), Image->BeforeState, EResourceState::PixelShaderResource);
-
-                    // TODO: Another way to do this? May break somewhere?
-                    Image->BeforeState = EResourceState::PixelShaderResource;
-                }
+                CmdList.TransitionTexture(Image->Image.Get(), EResourceState::PixelShaderResource);
 
                 CmdList.SetShaderResourceView(GlobalImGuiState.PShader.Get(), Image->ImageView.Get(), 0);
 
@@ -717,10 +711,7 @@ void DebugUI::Render(CommandList& CmdList)
     {
         Assert(Image != nullptr);
 
-        if (Image->AfterState != EResourceState::PixelShaderResource)
-        {
-            CmdList.TransitionTexture(Image->Image.Get(), EResourceState::PixelShaderResource, Image->AfterState);
-        }
+        CmdList.TransitionTexture(Image->Image.Get(), Image->AfterState);
     }
 
 
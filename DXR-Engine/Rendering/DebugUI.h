@@ -14,17 +14,17 @@ struct ImGuiImage
 {
     ImGuiImage() = default;
 
-    ImGuiImage(const TRef<ShaderResourceView>& InImageView, const TRef<Texture>& InImage, EResourceState InBefore, EResourceState InAfter)
+    ImGuiImage(const TRef<ShaderResourceView>& InImageView, const TRef<Texture>& InImage, EResourceState InAfterState)
         : ImageView(InImageView)
         , Image(InImage)
-        , BeforeState(InBefore)
-        , AfterState(InAfter)
+        , AfterState(InAfterState)
     {
     }
 
     TRef<ShaderResourceView> ImageView;
     TRef<Texture>  Image;
-    EResourceState BeforeState;
+
+    // State that the image is transitioned into after the UI is rendered
     EResourceState AfterState;
     bool AllowBlending = false;
 };
@@ -12,9 +12,14 @@
 
 TConsoleVariable<bool> GDrawTileDebug(false);
 
+TConsoleVariable<int32> GParallelRecordingCmdLists(8);
+TConsoleVariable<int32> GParallelRecordingMinDraws(64);
+
 bool DeferredRenderer::Init(FrameResources& FrameResources)
 {
     INIT_CONSOLE_VARIABLE("r.DrawTileDebug", &GDrawTileDebug);
+    INIT_CONSOLE_VARIABLE("r.ParallelRecordingCmdLists", &GParallelRecordingCmdLists);
+    INIT_CONSOLE_VARIABLE("r.ParallelRecordingMinDraws", &GParallelRecordingMinDraws);
 
     if (!CreateGBuffer(FrameResources))
     {
@@ -41,6 +46,7 @@ bool DeferredRenderer::Init(FrameResources& FrameResources)
         {
             { "ENABLE_PARALLAX_MAPPING", "1" },
             { "ENABLE_NORMAL_MAPPING",   "1" },
+            { "ENABLE_PACKED_VERTICES",  MESH_PACKED_VERTICES ? "1" : "0" },
         };
 
         if (!ShaderCompiler::CompileFromFile("../DXR-Engine/Shaders/GeometryPass.hlsl", "VSMain", &Defines, EShaderStage::Vertex, EShaderModel::SM_6_0, ShaderCode))
@@ -123,7 +129,7 @@ bool DeferredRenderer::Init(FrameResources& FrameResources)
         }
 
         GraphicsPipelineStateCreateInfo PipelineStateInfo;
-        PipelineStateInfo.InputLayoutState                       = FrameResources.StdInputLayout.Get();
+        PipelineStateInfo.InputLayoutState                       = FrameResources.MeshInputLayout.Get();
         PipelineStateInfo.BlendState                             = BlendState.Get();
         PipelineStateInfo.DepthStencilState                      = GeometryDepthStencilState.Get();
         PipelineStateInfo.RasterizerState                        = GeometryRasterizerState.Get();
@@ -150,7 +156,12 @@ bool DeferredRenderer::Init(FrameResources& FrameResources)
 
     // PrePass
     {
-        if (!ShaderCompiler::CompileFromFile("../DXR-Engine/Shaders/PrePass.hlsl", "Main", nullptr, EShaderStage::Vertex, EShaderModel::SM_6_0, ShaderCode))
+        TArray<ShaderDefine> Defines =
+        {
+            { "ENABLE_PACKED_VERTICES", MESH_PACKED_VERTICES ? "1" : "0" },
+        };
+
+        if (!ShaderCompiler::CompileFromFile("../DXR-Engine/Shaders/PrePass.hlsl", "Main", &Defines, EShaderStage::Vertex, EShaderModel::SM_6_0, ShaderCode))
         {
             Debug::DebugBreak();
             return false;
@@ -213,7 +224,7 @@ bool DeferredRenderer::Init(FrameResources& FrameResources)
         }
 
         GraphicsPipelineStateCreateInfo PipelineStateInfo;
-        PipelineStateInfo.InputLayoutState                   = FrameResources.StdInputLayout.Get();
+        PipelineStateInfo.InputLayoutState                   = FrameResources.MeshInputLayout.Get();
         PipelineStateInfo.BlendState                         = BlendState.Get();
         PipelineStateInfo.DepthStencilState                  = DepthStencilState.Get();
         PipelineStateInfo.RasterizerState                    = RasterizerState.Get();
@@ -315,7 +326,7 @@ bool DeferredRenderer::Init(FrameResources& FrameResources)
     CommandList CmdList;
     CmdList.Begin();
 
-    CmdList.TransitionTexture(StagingTexture.Get(), EResourceState::Common, EResourceState::UnorderedAccess);
+    CmdList.TransitionTexture(StagingTexture.Get(), EResourceState::UnorderedAccess);
 
     CmdList.SetComputePipelineState(BRDF_PipelineState.Get());
 
@@ -329,12 +340,12 @@ bool DeferredRenderer::Init(FrameResources& FrameResources)
 
     CmdList.UnorderedAccessTextureBarrier(StagingTexture.Get());
 
-    CmdList.TransitionTexture(StagingTexture.Get(), EResourceState::UnorderedAccess, EResourceState::CopySource);
-    CmdList.TransitionTexture(FrameResources.IntegrationLUT.Get(), EResourceState::Common, EResourceState::CopyDest);
+    CmdList.TransitionTexture(StagingTexture.Get(), EResourceState::CopySource);
+    CmdList.TransitionTexture(FrameResources.IntegrationLUT.Get(), EResourceState::CopyDest);
 
     CmdList.CopyTexture(FrameResources.IntegrationLUT.Get(), StagingTexture.Get());
 
-    CmdList.TransitionTexture(FrameResources.IntegrationLUT.Get(), EResourceState::CopyDest, EResourceState::PixelShaderResource);
+    CmdList.TransitionTexture(FrameResources.IntegrationLUT.Get(), EResourceState::PixelShaderResource);
 
     CmdList.End();
     GCmdListExecutor.ExecuteCommandList(CmdList);
@@ -428,110 +439,74 @@ void DeferredRenderer::Release()
 
 void DeferredRenderer::RenderPrePass(CommandList& CmdList, const FrameResources& FrameResources)
 {
-    const float RenderWidth  = float(FrameResources.MainWindowViewport->GetWidth());
-    const float RenderHeight = float(FrameResources.MainWindowViewport->GetHeight());
-
     INSERT_DEBUG_CMDLIST_MARKER(CmdList, "Begin PrePass");
 
     TRACE_SCOPE("PrePass");
 
-    CmdList.SetViewport(RenderWidth, RenderHeight, 0.0f, 1.0f, 0.0f, 0.0f);
-    CmdList.SetScissorRect(RenderWidth, RenderHeight, 0, 0);
+    RecordPrePass(CmdList, FrameResources, 0, FrameResources.DeferredVisibleCommands.Size());
 
-    struct PerObject
-    {
-        XMFLOAT4X4 Matrix;
-    } PerObjectBuffer;
-
-    CmdList.SetRenderTargets(nullptr, 0, FrameResources.GBuffer[GBUFFER_DEPTH_INDEX]->GetDepthStencilView());
+    INSERT_DEBUG_CMDLIST_MARKER(CmdList, "End PrePass");
+}
 
-    CmdList.SetGraphicsPipelineState(PrePassPipelineState.Get());
+void DeferredRenderer::RenderBasePass(CommandList& CmdList, const FrameResources& FrameResources)
+{
+    INSERT_DEBUG_CMDLIST_MARKER(CmdList, "Begin GeometryPass");
 
-    CmdList.SetConstantBuffer(PrePassVertexShader.Get(), FrameResources.CameraBuffer.Get(), 0);
+    TRACE_SCOPE("GeometryPass");
 
     for (const MeshDrawCommand& Command : FrameResources.DeferredVisibleCommands)
     {
-        if (!Command.Material->HasHeightMap())
+        if (Command.Material->IsBufferDirty())
         {
-            CmdList.SetVertexBuffers(&Command.VertexBuffer, 1, 0);
-            CmdList.SetIndexBuffer(Command.IndexBuffer);
-
-            PerObjectBuffer.Matrix = Command.CurrentActor->GetTransform().GetMatrix();
-
-            CmdList.Set32BitShaderConstants(PrePassVertexShader.Get(), &PerObjectBuffer, 16);
-
-            CmdList.DrawIndexedInstanced(Command.IndexBuffer->GetNumIndicies(), 1, 0, 0, 0);
+            Command.Material->BuildBuffer(CmdList);
         }
     }
 
-    INSERT_DEBUG_CMDLIST_MARKER(CmdList, "End PrePass");
+    RecordBasePass(CmdList, FrameResources, 0, FrameResources.DeferredVisibleCommands.Size());
+
+    INSERT_DEBUG_CMDLIST_MARKER(CmdList, "End GeometryPass");
 }
 
-void DeferredRenderer::RenderBasePass(CommandList& CmdList, const FrameResources& FrameResources)
+void DeferredRenderer::RenderPrePass(ParallelCommandListRecorder& Recorder, const FrameResources& FrameResources)
 {
-    INSERT_DEBUG_CMDLIST_MARKER(CmdList, "Begin GeometryPass");
-
-    TRACE_SCOPE("GeometryPass");
-
-    const float RenderWidth  = float(FrameResources.MainWindowViewport->GetWidth());
-    const float RenderHeight = float(FrameResources.MainWindowViewport->GetHeight());
+    TRACE_SCOPE("PrePass");
 
-    CmdList.SetViewport(RenderWidth, RenderHeight, 0.0f, 1.0f, 0.0f, 0.0f);
-    CmdList.SetScissorRect(RenderWidth, RenderHeight, 0, 0);
+    const uint32 NumCommands = FrameResources.DeferredVisibleCommands.Size();
+    const uint32 NumCmdLists = uint32(GParallelRecordingCmdLists.GetInt());
 
-    RenderTargetView* RenderTargets[] =
+    RecordCommandListRangeDelegate RecordFunc;
+    RecordFunc.BindLambda([this, &FrameResources](CommandList& CmdList, uint32 BeginCommand, uint32 EndCommand)
     {
-        FrameResources.GBuffer[GBUFFER_ALBEDO_INDEX]->GetRenderTargetView(),
-        FrameResources.GBuffer[GBUFFER_NORMAL_INDEX]->GetRenderTargetView(),
-        FrameResources.GBuffer[GBUFFER_MATERIAL_INDEX]->GetRenderTargetView(),
-        FrameResources.GBuffer[GBUFFER_VIEW_NORMAL_INDEX]->GetRenderTargetView(),
-    };
-    CmdList.SetRenderTargets(RenderTargets, 4, FrameResources.GBuffer[GBUFFER_DEPTH_INDEX]->GetDepthStencilView());
+        RecordPrePass(CmdList, FrameResources, BeginCommand, EndCommand);
+    });
 
-    // Setup Pipeline
-    CmdList.SetGraphicsPipelineState(PipelineState.Get());
+    Recorder.RecordRangeAsync(NumCommands, NumCmdLists, GParallelRecordingMinDraws.GetInt(), RecordFunc);
+}
 
-    struct TransformBuffer
-    {
-        XMFLOAT4X4 Transform;
-        XMFLOAT4X4 TransformInv;
-    } TransformPerObject;
+void DeferredRenderer::RenderBasePass(ParallelCommandListRecorder& Recorder, const FrameResources& FrameResources)
+{
+    TRACE_SCOPE("GeometryPass");
 
+    // Materials are updated on the recording thread since the workers cannot modify shared state
+    CommandList& CmdList = Recorder.BeginCommandList();
     for (const MeshDrawCommand& Command : FrameResources.DeferredVisibleCommands)
     {
-        CmdList.SetVertexBuffers(&Command.VertexBuffer, 1, 0);
-        CmdList.SetIndexBuffer(Command.IndexBuffer);
-
         if (Command.Material->IsBufferDirty())
         {
             Command.Material->BuildBuffer(CmdList);
         }
+    }
 
-        CmdList.SetConstantBuffer(BaseVertexShader.Get(), FrameResources.CameraBuffer.Get(), 0);
-
-        ConstantBuffer* MaterialBuffer = Command.Material->GetMaterialBuffer();
-        CmdList.SetConstantBuffer(BasePixelShader.Get(), MaterialBuffer, 0);
-
-        TransformPerObject.Transform    = Command.CurrentActor->GetTransform().GetMatrix();
-        TransformPerObject.TransformInv = Command.CurrentActor->GetTransform().GetMatrixInverse();
-
-        ShaderResourceView* const* ShaderResourceViews = Command.Material->GetShaderResourceViews();
-        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[0], 0);
-        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[1], 1);
-        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[2], 2);
-        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[3], 3);
-        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[4], 4);
-        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[5], 5);
-
-        SamplerState* Sampler = Command.Material->GetMaterialSampler();
-        CmdList.SetSamplerState(BasePixelShader.Get(), Sampler, 0);
-
-        CmdList.Set32BitShaderConstants(BaseVertexShader.Get(), &TransformPerObject, 32);
+    const uint32 NumCommands = FrameResources.DeferredVisibleCommands.Size();
+    const uint32 NumCmdLists = uint32(GParallelRecordingCmdLists.GetInt());
 
-        CmdList.DrawIndexedInstanced(Command.IndexBuffer->GetNumIndicies(), 1, 0, 0, 0);
-    }
+    RecordCommandListRangeDelegate RecordFunc;
+    RecordFunc.BindLambda([this, &FrameResources](CommandList& CmdList, uint32 BeginCommand, uint32 EndCommand)
+    {
+        RecordBasePass(CmdList, FrameResources, BeginCommand, EndCommand);
+    });
 
-    INSERT_DEBUG_CMDLIST_MARKER(CmdList, "End GeometryPass");
+    Recorder.RecordRangeAsync(NumCommands, NumCmdLists, GParallelRecordingMinDraws.GetInt(), RecordFunc);
 }
 
 void DeferredRenderer::RenderDeferredTiledLightPass(CommandList& CmdList, const FrameResources& FrameResources, const LightSetup& LightSetup)
@@ -604,6 +579,101 @@ void DeferredRenderer::RenderDeferredTiledLightPass(CommandList& CmdList, const
     INSERT_DEBUG_CMDLIST_MARKER(CmdList, "End LightPass");
 }
 
+void DeferredRenderer::RecordPrePass(CommandList& CmdList, const FrameResources& FrameResources, uint32 BeginCommand, uint32 EndCommand)
+{
+    const float RenderWidth  = float(FrameResources.MainWindowViewport->GetWidth());
+    const float RenderHeight = float(FrameResources.MainWindowViewport->GetHeight());
+
+    CmdList.SetViewport(RenderWidth, RenderHeight, 0.0f, 1.0f, 0.0f, 0.0f);
+    CmdList.SetScissorRect(RenderWidth, RenderHeight, 0, 0);
+
+    struct PerObject
+    {
+        XMFLOAT4X4 Matrix;
+    } PerObjectBuffer;
+
+    CmdList.SetRenderTargets(nullptr, 0, FrameResources.GBuffer[GBUFFER_DEPTH_INDEX]->GetDepthStencilView());
+
+    CmdList.SetGraphicsPipelineState(PrePassPipelineState.Get());
+
+    CmdList.SetConstantBuffer(PrePassVertexShader.Get(), FrameResources.CameraBuffer.Get(), 0);
+
+    for (uint32 i = BeginCommand; i < EndCommand; i++)
+    {
+        const MeshDrawCommand& Command = FrameResources.DeferredVisibleCommands[i];
+        if (!Command.Material->HasHeightMap())
+        {
+            CmdList.SetVertexBuffers(&Command.VertexBuffer, 1, 0);
+            CmdList.SetIndexBuffer(Command.IndexBuffer);
+
+            PerObjectBuffer.Matrix = Command.Mesh->GetVertexTransform(Command.CurrentActor->GetTransform().GetMatrix());
+
+            CmdList.Set32BitShaderConstants(PrePassVertexShader.Get(), &PerObjectBuffer, 16);
+
+            FrameResources.DrawMeshCommand(CmdList, Command);
+        }
+    }
+}
+
+void DeferredRenderer::RecordBasePass(CommandList& CmdList, const FrameResources& FrameResources, uint32 BeginCommand, uint32 EndCommand)
+{
+    const float RenderWidth  = float(FrameResources.MainWindowViewport->GetWidth());
+    const float RenderHeight = float(FrameResources.MainWindowViewport->GetHeight());
+
+    CmdList.SetViewport(RenderWidth, RenderHeight, 0.0f, 1.0f, 0.0f, 0.0f);
+    CmdList.SetScissorRect(RenderWidth, RenderHeight, 0, 0);
+
+    RenderTargetView* RenderTargets[] =
+    {
+        FrameResources.GBuffer[GBUFFER_ALBEDO_INDEX]->GetRenderTargetView(),
+        FrameResources.GBuffer[GBUFFER_NORMAL_INDEX]->GetRenderTargetView(),
+        FrameResources.GBuffer[GBUFFER_MATERIAL_INDEX]->GetRenderTargetView(),
+        FrameResources.GBuffer[GBUFFER_VIEW_NORMAL_INDEX]->GetRenderTargetView(),
+    };
+    CmdList.SetRenderTargets(RenderTargets, 4, FrameResources.GBuffer[GBUFFER_DEPTH_INDEX]->GetDepthStencilView());
+
+    // Setup Pipeline
+    CmdList.SetGraphicsPipelineState(PipelineState.Get());
+
+    struct TransformBuffer
+    {
+        XMFLOAT4X4 Transform;
+        XMFLOAT4X4 TransformInv;
+    } TransformPerObject;
+
+    for (uint32 i = BeginCommand; i < EndCommand; i++)
+    {
+        const MeshDrawCommand& Command = FrameResources.DeferredVisibleCommands[i];
+
+        CmdList.SetVertexBuffers(&Command.VertexBuffer, 1, 0);
+        CmdList.SetIndexBuffer(Command.IndexBuffer);
+
+        CmdList.SetConstantBuffer(BaseVertexShader.Get(), FrameResources.CameraBuffer.Get(), 0);
+
+        ConstantBuffer* MaterialBuffer = Command.Material->GetMaterialBuffer();
+        CmdList.SetConstantBuffer(BasePixelShader.Get(), MaterialBuffer, 0);
+
+        TransformPerObject.Transform    = Command.Mesh->GetVertexTransform(Command.CurrentActor->GetTransform().GetMatrix());
+        TransformPerObject.TransformInv = Command.CurrentActor->GetTransform().GetMatrixInverse();
+
+        MaterialShaderResourceViews ShaderResourceViews;
+        Command.Material->GetShaderResourceViews(ShaderResourceViews);
+        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[0], 0);
+        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[1], 1);
+        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[2], 2);
+        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[3], 3);
+        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[4], 4);
+        CmdList.SetShaderResourceView(BasePixelShader.Get(), ShaderResourceViews[5], 5);
+
+        SamplerState* Sampler = Command.Material->GetMaterialSampler();
+        CmdList.SetSamplerState(BasePixelShader.Get(), Sampler, 0);
+
+        CmdList.Set32BitShaderConstants(BaseVertexShader.Get(), &TransformPerObject, 32);
+
+        FrameResources.DrawMeshCommand(CmdList, Command);
+    }
+}
+
 bool DeferredRenderer::ResizeResources(FrameResources& FrameResources)
 {
     return CreateGBuffer(FrameResources);
@@ -691,21 +761,5 @@ bool DeferredRenderer::CreateGBuffer(FrameResources& FrameResources)
         return false;
     }
 
-    // Final Image
-    FrameResources.FinalTarget = CreateTexture2D(
-        FrameResources.FinalTargetFormat, 
-        Width, Height, 1, 1, 
-        Usage | TextureFlag_UAV, 
-        EResourceState::Common, 
-        nullptr);
-    if (FrameResources.FinalTarget)
-    {
-        FrameResources.FinalTarget->SetName("Final Target");
-    }
-    else
-    {
-        return false;
-    }
-
     return true;
 }
@@ -5,6 +5,7 @@
 #include "Scene/Scene.h"
 
 #include "RenderLayer/CommandList.h"
+#include "RenderLayer/ParallelCommandListRecorder.h"
 
 class DeferredRenderer
 {
@@ -17,6 +18,11 @@ public:
 
     void RenderPrePass(CommandList& CmdList, const FrameResources& FrameResources);
     void RenderBasePass(CommandList& CmdList, const FrameResources& FrameResources);
+
+    // Records the draws on the TaskManager's workers, split into several CommandLists by draw range
+    void RenderPrePass(ParallelCommandListRecorder& Recorder, const FrameResources& FrameResources);
+    void RenderBasePass(ParallelCommandListRecorder& Recorder, const FrameResources& FrameResources);
+
     void RenderDeferredTiledLightPass(CommandList& CmdList, const FrameResources& FrameResources, const LightSetup& LightSetup);
 
     bool ResizeResources(FrameResources& FrameResources);
@@ -24,6 +30,9 @@ public:
 private:
     bool CreateGBuffer(FrameResources& FrameResources);
 
+    void RecordPrePass(CommandList& CmdList, const FrameResources& FrameResources, uint32 BeginCommand, uint32 EndCommand);
+    void RecordBasePass(CommandList& CmdList, const FrameResources& FrameResources, uint32 BeginCommand, uint32 EndCommand);
+
     TRef<GraphicsPipelineState> PipelineState;
     TRef<VertexShader>          BaseVertexShader;
     TRef<PixelShader>           BasePixelShader;
@@ -17,6 +17,7 @@ bool ForwardRenderer::Init(FrameResources& FrameResources)
     {
         { "ENABLE_PARALLAX_MAPPING", "1" },
         { "ENABLE_NORMAL_MAPPING",   "1" },
+        { "ENABLE_PACKED_VERTICES",  MESH_PACKED_VERTICES ? "1" : "0" },
     };
 
     TArray<uint8> ShaderCode;
@@ -102,7 +103,7 @@ bool ForwardRenderer::Init(FrameResources& FrameResources)
     GraphicsPipelineStateCreateInfo PSOProperties;
     PSOProperties.ShaderState.VertexShader               = VShader.Get();
     PSOProperties.ShaderState.PixelShader                = PShader.Get();
-    PSOProperties.InputLayoutState                       = FrameResources.StdInputLayout.Get();
+    PSOProperties.InputLayoutState                       = FrameResources.MeshInputLayout.Get();
     PSOProperties.DepthStencilState                      = DepthStencilState.Get();
     PSOProperties.BlendState                             = BlendState.Get();
     PSOProperties.RasterizerState                        = RasterizerState.Get();
@@ -187,7 +188,8 @@ void ForwardRenderer::Render(CommandList& CmdList, const FrameResources& FrameRe
         ConstantBuffer* ConstantBuffer = Command.Material->GetMaterialBuffer();
         CmdList.SetConstantBuffer(PShader.Get(), ConstantBuffer, 4);
 
-        ShaderResourceView* const* ShaderResourceViews = Command.Material->GetShaderResourceViews();
+        MaterialShaderResourceViews ShaderResourceViews;
+        Command.Material->GetShaderResourceViews(ShaderResourceViews);
         CmdList.SetShaderResourceView(PShader.Get(), ShaderResourceViews[0], 5);
         CmdList.SetShaderResourceView(PShader.Get(), ShaderResourceViews[1], 6);
         CmdList.SetShaderResourceView(PShader.Get(), ShaderResourceViews[2], 7);
@@ -199,12 +201,12 @@ void ForwardRenderer::Render(CommandList& CmdList, const FrameResources& FrameRe
         SamplerState* SamplerState = Command.Material->GetMaterialSampler();
         CmdList.SetSamplerState(PShader.Get(), SamplerState, 0);
 
-        TransformPerObject.Transform    = Command.CurrentActor->GetTransform().GetMatrix();
+        TransformPerObject.Transform    = Command.Mesh->GetVertexTransform(Command.CurrentActor->GetTransform().GetMatrix());
         TransformPerObject.TransformInv = Command.CurrentActor->GetTransform().GetMatrixInverse();
 
         CmdList.Set32BitShaderConstants(VShader.Get(), &TransformPerObject, 32);
 
-        CmdList.DrawIndexedInstanced(Command.IndexBuffer->GetNumIndicies(), 1, 0, 0, 0);
+        FrameResources.DrawMeshCommand(CmdList, Command);
     }
 
     INSERT_DEBUG_CMDLIST_MARKER(CmdList, "End ForwardPass");
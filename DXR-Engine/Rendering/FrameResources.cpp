@@ -1,6 +1,8 @@
 #include "FrameResources.h"
 #include "LightSetup.h"
 
+#include "RenderLayer/CommandList.h"
+
 void FrameResources::Release()
 {
     BackBuffer = nullptr;
@@ -30,6 +32,7 @@ void FrameResources::Release()
     GBufferSampler.Reset();
 
     StdInputLayout.Reset();
+    MeshInputLayout.Reset();
 
     RTScene.Reset();
     RTOutput.Reset();
@@ -39,8 +42,24 @@ void FrameResources::Release()
 
     DeferredVisibleCommands.Clear();
     ForwardVisibleCommands.Clear();
+    MeshDrawRanges.Clear();
 
     DebugTextures.Clear();
 
     MainWindowViewport.Reset();
+}
+
+void FrameResources::DrawMeshCommand(CommandList& CmdList, const MeshDrawCommand& Command) const
+{
+    if (Command.NumDrawRanges == 0)
+    {
+        CmdList.DrawIndexedInstanced(Command.IndexBuffer->GetNumIndicies(), 1, 0, 0, 0);
+        return;
+    }
+
+    for (uint32 Index = Command.FirstDrawRange; Index < Command.FirstDrawRange + Command.NumDrawRanges; Index++)
+    {
+        const MeshDrawRange& Range = MeshDrawRanges[Index];
+        CmdList.DrawIndexedInstanced(Range.NumIndices, 1, Range.FirstIndex, 0, 0);
+    }
 }
\ No newline at end of file
@@ -61,6 +61,9 @@ struct FrameResources
 
     void Release();
 
+    // Draws the ranges of the index buffer of a visible command, the vertex and index buffers must already be set
+    void DrawMeshCommand(class CommandList& CmdList, const MeshDrawCommand& Command) const;
+
     const EFormat DepthBufferFormat  = EFormat::D32_Float;
     const EFormat SSAOBufferFormat   = EFormat::R16_Float;
     const EFormat FinalTargetFormat  = EFormat::R16G16B16A16_Float;
@@ -85,13 +88,17 @@ struct FrameResources
     TRef<Texture2D>    IntegrationLUT;
     TRef<SamplerState> IntegrationLUTSampler;
 
+    // Transient textures that are allocated by the RenderGraph, these are set every frame
     TRef<Texture2D>    SSAOBuffer;
     TRef<Texture2D>    FinalTarget;
     TRef<Texture2D>    GBuffer[5];
     TRef<SamplerState> GBufferSampler;
     TRef<SamplerState> FXAASampler;
 
+    // Layout of Vertex, and the layout of the vertex buffers of meshes, which is the packed layout when
+    // MESH_PACKED_VERTICES is set
     TRef<InputLayoutState> StdInputLayout;
+    TRef<InputLayoutState> MeshInputLayout;
 
     TRef<Texture2D>       RTOutput;
     TRef<RayTracingScene> RTScene;
@@ -107,6 +114,7 @@ struct FrameResources
 
     TArray<MeshDrawCommand> DeferredVisibleCommands;
     TArray<MeshDrawCommand> ForwardVisibleCommands;
+    TArray<MeshDrawRange>   MeshDrawRanges;
 
     TArray<ImGuiImage> DebugTextures;
 
@@ -28,6 +28,9 @@ struct PointLightShadowMapGenerationData
     TStaticArray<XMFLOAT4X4, 6> ProjMatrix;
     float    FarPlane;
     XMFLOAT3 Position;
+
+    // The six faces are consecutive views in the MultiViewCulling of the renderer
+    uint32 FirstCullingView = 0;
 };
 
 struct DirectionalLightData
@@ -44,6 +47,7 @@ struct DirLightShadowMapGenerationData
     XMFLOAT4X4 Matrix;
     float      FarPlane;
     XMFLOAT3   Position;
+    uint32     CullingView = 0;
 };
 
 struct LightSetup
@@ -1,6 +1,13 @@
 #pragma once
 #include "Core.h"
 
+// Range of an index buffer that is drawn with one draw call
+struct MeshDrawRange
+{
+    uint32 FirstIndex;
+    uint32 NumIndices;
+};
+
 struct MeshDrawCommand
 {
     class Material* Material     = nullptr;
@@ -11,4 +18,9 @@ struct MeshDrawCommand
     class IndexBuffer*  IndexBuffer  = nullptr;
 
     class RayTracingGeometry* Geometry = nullptr;
+
+    // Ranges of the index buffer in FrameResources::MeshDrawRanges that are left after the meshlets have been culled,
+    // the whole index buffer is drawn when there are none
+    uint32 FirstDrawRange = 0;
+    uint32 NumDrawRanges  = 0;
 };
\ No newline at end of file
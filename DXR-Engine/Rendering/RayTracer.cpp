@@ -8,6 +8,8 @@
 #include "Resources/Material.h"
 #include "Resources/Mesh.h"
 
+#include "Scene/Components/MeshComponent.h"
+
 bool RayTracer::Init(FrameResources& Resources)
 {
     TArray<uint8> Code;
@@ -28,7 +30,14 @@ bool RayTracer::Init(FrameResources& Resources)
         RayGenShader->SetName("RayGenShader");
     }
 
-    if (!ShaderCompiler::CompileFromFile("../DXR-Engine/Shaders/ClosestHit.hlsl", "ClosestHit", nullptr, EShaderStage::RayClosestHit, EShaderModel::SM_6_3, Code))
+    // The hit shader decodes the vertices and indices of the meshes, which are the buffers that the meshes are drawn with
+    TArray<ShaderDefine> HitDefines =
+    {
+        { "ENABLE_PACKED_VERTICES",        MESH_PACKED_VERTICES ? "1" : "0" },
+        { "MESH_MAX_16BIT_INDEX_VERTICES", std::to_string(MESH_MAX_16BIT_INDEX_VERTICES) },
+    };
+
+    if (!ShaderCompiler::CompileFromFile("../DXR-Engine/Shaders/ClosestHit.hlsl", "ClosestHit", &HitDefines, EShaderStage::RayClosestHit, EShaderModel::SM_6_3, Code))
     {
         Debug::DebugBreak();
         return false;
@@ -107,10 +116,15 @@ void RayTracer::PreRender(CommandList& CmdList, FrameResources& Resources, const
 
     SamplerState* Sampler = nullptr;
 
-    for (const MeshDrawCommand& Cmd : Scene.GetMeshDrawCommands())
+    // The instances only need the mesh, material and transform, which the components have without the draw state of
+    // the MeshDrawCommands
+    const TComponentView<MeshComponent> MeshComponents = Scene.GetAllComponentsOfType<MeshComponent>();
+    for (uint32 Index = 0; Index < MeshComponents.Size(); Index++)
     {
-        Material* Mat = Cmd.Material;
-        if (Cmd.Material->HasAlphaMask())
+        const MeshComponent* Component = MeshComponents[Index];
+        Material* Mat         = Component->Material.Get();
+        Mesh*     CurrentMesh = Component->Mesh.Get();
+        if (Mat->HasAlphaMask())
         {
             continue;
         }
@@ -123,24 +137,24 @@ void RayTracer::PreRender(CommandList& CmdList, FrameResources& Resources, const
         Resources.RTMaterialTextureCache.Add(Mat->AOMap->GetShaderResourceView());
         Sampler = Mat->GetMaterialSampler();
 
-        const XMFLOAT3X4 TinyTransform = Cmd.CurrentActor->GetTransform().GetTinyMatrix();
+        const XMFLOAT3X4 InstanceTransform = CurrentMesh->GetRayTracingTransform(MeshComponents.GetActor(Index)->GetTransform().GetMatrix());
         uint32 HitGroupIndex = 0;
 
-        auto HitGroupIndexPair = Resources.RTMeshToHitGroupIndex.find(Cmd.Mesh);
+        auto HitGroupIndexPair = Resources.RTMeshToHitGroupIndex.find(CurrentMesh);
         if (HitGroupIndexPair == Resources.RTMeshToHitGroupIndex.end())
         {
             HitGroupIndex = Resources.RTHitGroupResources.Size();
-            Resources.RTMeshToHitGroupIndex[Cmd.Mesh] = HitGroupIndex;
+            Resources.RTMeshToHitGroupIndex[CurrentMesh] = HitGroupIndex;
 
             RayTracingShaderResources HitGroupResources;
             HitGroupResources.Identifier = "HitGroup";
-            if (Cmd.Mesh->VertexBufferSRV)
+            if (CurrentMesh->VertexBufferSRV)
             {
-                HitGroupResources.AddShaderResourceView(Cmd.Mesh->VertexBufferSRV.Get());
+                HitGroupResources.AddShaderResourceView(CurrentMesh->VertexBufferSRV.Get());
             }
-            if (Cmd.Mesh->IndexBufferSRV)
+            if (CurrentMesh->IndexBufferSRV)
             {
-                HitGroupResources.AddShaderResourceView(Cmd.Mesh->IndexBufferSRV.Get());
+                HitGroupResources.AddShaderResourceView(CurrentMesh->IndexBufferSRV.Get());
             }
 
             Resources.RTHitGroupResources.EmplaceBack(HitGroupResources);
@@ -151,12 +165,12 @@ void RayTracer::PreRender(CommandList& CmdList, FrameResources& Resources, const
         }
 
         RayTracingGeometryInstance Instance;
-        Instance.Instance      = MakeSharedRef<RayTracingGeometry>(Cmd.Geometry);
+        Instance.Instance      = MakeSharedRef<RayTracingGeometry>(CurrentMesh->RTGeometry.Get());
         Instance.Flags         = RayTracingInstanceFlags_None;
         Instance.HitGroupIndex = HitGroupIndex;
         Instance.InstanceIndex = AlbedoIndex;
         Instance.Mask          = 0xff;
-        Instance.Transform     = TinyTransform;
+        Instance.Transform     = InstanceTransform;
         Resources.RTGeometryInstances.EmplaceBack(Instance);
     }
 
@@ -213,6 +227,5 @@ void RayTracer::PreRender(CommandList& CmdList, FrameResources& Resources, const
     Resources.DebugTextures.EmplaceBack(
         MakeSharedRef<ShaderResourceView>(Resources.RTOutput->GetShaderResourceView()),
         Resources.RTOutput,
-        EResourceState::UnorderedAccess,
         EResourceState::UnorderedAccess);
 }
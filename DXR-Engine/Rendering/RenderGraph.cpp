@@ -0,0 +1,548 @@
+#include "RenderGraph.h"
+
+#include "RenderLayer/RenderLayer.h"
+
+#include "Core/Application/Log.h"
+
+#include <algorithm>
+
+static std::string ToMegaBytes(uint64 Bytes)
+{
+    char Buffer[32];
+    snprintf(Buffer, sizeof(Buffer), "%.2f MB", double(Bytes) / (1024.0 * 1024.0));
+    return Buffer;
+}
+
+/*
+* RenderGraphTextureDesc
+*/
+
+bool RenderGraphTextureDesc::IsCompatible(const RenderGraphTextureDesc& Other) const
+{
+    if (Format != Other.Format || Width != Other.Width || Height != Other.Height || Flags != Other.Flags)
+    {
+        return false;
+    }
+
+    const ClearValue& Value      = OptimizedClearValue;
+    const ClearValue& OtherValue = Other.OptimizedClearValue;
+    if (Value.GetType() != OtherValue.GetType() || Value.GetFormat() != OtherValue.GetFormat())
+    {
+        return false;
+    }
+
+    if (Value.GetType() == ClearValue::EType::Color)
+    {
+        const ColorF& Color      = Value.AsColor();
+        const ColorF& OtherColor = OtherValue.AsColor();
+        return Color.r == OtherColor.r && Color.g == OtherColor.g && Color.b == OtherColor.b && Color.a == OtherColor.a;
+    }
+    else
+    {
+        const DepthStencilF& DepthStencil      = Value.AsDepthStencil();
+        const DepthStencilF& OtherDepthStencil = OtherValue.AsDepthStencil();
+        return DepthStencil.Depth == OtherDepthStencil.Depth && DepthStencil.Stencil == OtherDepthStencil.Stencil;
+    }
+}
+
+uint64 RenderGraphTextureDesc::GetSizeInBytes() const
+{
+    return uint64(Width) * uint64(Height) * uint64(GetByteStrideFromFormat(Format));
+}
+
+/*
+* RenderGraphPassBuilder
+*/
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Read(RenderGraphTexture Texture, EResourceState State)
+{
+    Assert(Texture.IsValid());
+
+    RenderGraphPassNode& Pass = Graph.Passes[PassIndex];
+    Pass.Accesses.EmplaceBack(RenderGraphTextureAccess{ Texture, State, false });
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::Write(RenderGraphTexture Texture, EResourceState State)
+{
+    Assert(Texture.IsValid());
+
+    RenderGraphPassNode& Pass = Graph.Passes[PassIndex];
+    Pass.Accesses.EmplaceBack(RenderGraphTextureAccess{ Texture, State, true });
+    return *this;
+}
+
+RenderGraphPassBuilder& RenderGraphPassBuilder::SetSideEffects()
+{
+    Graph.Passes[PassIndex].HasSideEffects = true;
+    return *this;
+}
+
+/*
+* RenderGraphResourcePool
+*/
+
+void RenderGraphResourcePool::BeginFrame()
+{
+    FrameIndex++;
+
+    // Release textures that are no longer used, for example textures with the size of the window before a resize
+    for (uint32 i = 0; i < Textures.Size();)
+    {
+        if (FrameIndex - Textures[i].LastUsedFrame > RENDER_GRAPH_POOL_MAX_UNUSED_FRAMES)
+        {
+            Textures[i] = Textures[Textures.Size() - 1];
+            Textures.PopBack();
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+Texture2D* RenderGraphResourcePool::AcquireTexture(const RenderGraphTextureDesc& Desc, const std::string& Name)
+{
+    for (PooledTexture& Pooled : Textures)
+    {
+        if (Pooled.LastUsedFrame != FrameIndex && Pooled.Desc.IsCompatible(Desc))
+        {
+            Pooled.LastUsedFrame = FrameIndex;
+            return Pooled.Texture.Get();
+        }
+    }
+
+    TRef<Texture2D> NewTexture = CreateTexture2D(
+        Desc.Format,
+        Desc.Width, Desc.Height, 1, 1,
+        Desc.Flags,
+        EResourceState::Common,
+        nullptr,
+        Desc.OptimizedClearValue);
+    if (!NewTexture)
+    {
+        LOG_ERROR("[RenderGraphResourcePool]: Failed to create texture '" + Name + "'");
+        return nullptr;
+    }
+    else
+    {
+        NewTexture->SetName(Name);
+    }
+
+    Textures.EmplaceBack(PooledTexture{ Desc, NewTexture, FrameIndex });
+    return NewTexture.Get();
+}
+
+void RenderGraphResourcePool::Release()
+{
+    Textures.Clear();
+}
+
+/*
+* RenderGraph
+*/
+
+RenderGraphTexture RenderGraph::CreateTexture(const std::string& Name, const RenderGraphTextureDesc& Desc)
+{
+    RenderGraphTexture Handle;
+    Handle.Index = Textures.Size();
+
+    RenderGraphTextureNode& Node = Textures.EmplaceBack();
+    Node.Name = Name;
+    Node.Desc = Desc;
+    return Handle;
+}
+
+RenderGraphTexture RenderGraph::ImportTexture(const std::string& Name, Texture* InTexture)
+{
+    Assert(InTexture != nullptr);
+
+    RenderGraphTexture Handle;
+    Handle.Index = Textures.Size();
+
+    // The description of imported textures is only used for debugging
+    RenderGraphTextureNode& Node = Textures.EmplaceBack();
+    Node.Name            = Name;
+    Node.Desc.Format     = InTexture->GetFormat();
+    Node.Desc.Flags      = InTexture->GetFlags();
+    Node.ImportedTexture = InTexture;
+    return Handle;
+}
+
+RenderGraphPassBuilder RenderGraph::AddPass(const std::string& Name, ERenderGraphQueue Queue, const TFunction<void(CommandList&)>& ExecuteFunc)
+{
+    const uint32 PassIndex = Passes.Size();
+
+    RenderGraphPassNode& Pass = Passes.EmplaceBack();
+    Pass.Name        = Name;
+    Pass.Queue       = Queue;
+    Pass.ExecuteFunc = ExecuteFunc;
+    return RenderGraphPassBuilder(*this, PassIndex);
+}
+
+void RenderGraph::Compile()
+{
+    for (RenderGraphTextureNode& Texture : Textures)
+    {
+        Texture.Readers.Clear();
+        Texture.Writers.Clear();
+    }
+
+    for (uint32 PassIndex = 0; PassIndex < Passes.Size(); PassIndex++)
+    {
+        RenderGraphPassNode& Pass = Passes[PassIndex];
+        Pass.IsCulled        = false;
+        Pass.DependencyLevel = 0;
+
+        for (const RenderGraphTextureAccess& Access : Pass.Accesses)
+        {
+            RenderGraphTextureNode& Texture = Textures[Access.Texture.Index];
+            if (Access.IsWrite)
+            {
+                Texture.Writers.EmplaceBack(PassIndex);
+            }
+            else
+            {
+                Texture.Readers.EmplaceBack(PassIndex);
+            }
+        }
+    }
+
+    CullPasses();
+
+    // Passes can only depend on passes that are added before them, which means that the submission order is a valid
+    // order to execute the passes in
+    ExecutionOrder.Clear();
+    for (uint32 PassIndex = 0; PassIndex < Passes.Size(); PassIndex++)
+    {
+        if (!Passes[PassIndex].IsCulled)
+        {
+            ExecutionOrder.EmplaceBack(PassIndex);
+        }
+    }
+
+    ComputeDependencyLevels();
+    ComputeLifetimes();
+    AssignPhysicalTextures();
+
+    Statistics.NumPasses       = Passes.Size();
+    Statistics.NumCulledPasses = Passes.Size() - ExecutionOrder.Size();
+
+    IsCompiled = true;
+}
+
+void RenderGraph::CullPasses()
+{
+    // A pass is referenced by the textures it writes and a texture by the passes that read it. Imported textures are
+    // used after the graph has executed and are therefore always referenced.
+    TArray<uint32> PassRefCounts(Passes.Size(), 0);
+    for (uint32 PassIndex = 0; PassIndex < Passes.Size(); PassIndex++)
+    {
+        for (const RenderGraphTextureAccess& Access : Passes[PassIndex].Accesses)
+        {
+            if (Access.IsWrite)
+            {
+                PassRefCounts[PassIndex]++;
+            }
+        }
+    }
+
+    TArray<uint32> TextureRefCounts(Textures.Size(), 0);
+    TArray<uint32> UnreferencedTextures;
+    for (uint32 TextureIndex = 0; TextureIndex < Textures.Size(); TextureIndex++)
+    {
+        const RenderGraphTextureNode& Texture = Textures[TextureIndex];
+        TextureRefCounts[TextureIndex] = Texture.Readers.Size() + (Texture.IsImported() ? 1 : 0);
+        if (TextureRefCounts[TextureIndex] == 0)
+        {
+            UnreferencedTextures.EmplaceBack(TextureIndex);
+        }
+    }
+
+    auto CullPass = [&](uint32 PassIndex)
+    {
+        RenderGraphPassNode& Pass = Passes[PassIndex];
+        Pass.IsCulled = true;
+
+        for (const RenderGraphTextureAccess& Access : Pass.Accesses)
+        {
+            if (!Access.IsWrite)
+            {
+                uint32& RefCount = TextureRefCounts[Access.Texture.Index];
+                Assert(RefCount > 0);
+                if (--RefCount == 0)
+                {
+                    UnreferencedTextures.EmplaceBack(Access.Texture.Index);
+                }
+            }
+        }
+    };
+
+    for (uint32 PassIndex = 0; PassIndex < Passes.Size(); PassIndex++)
+    {
+        if (PassRefCounts[PassIndex] == 0 && !Passes[PassIndex].HasSideEffects)
+        {
+            CullPass(PassIndex);
+        }
+    }
+
+    while (!UnreferencedTextures.IsEmpty())
+    {
+        const uint32 TextureIndex = UnreferencedTextures[UnreferencedTextures.Size() - 1];
+        UnreferencedTextures.PopBack();
+
+        for (uint32 PassIndex : Textures[TextureIndex].Writers)
+        {
+            RenderGraphPassNode& Pass = Passes[PassIndex];
+            if (Pass.IsCulled)
+            {
+                continue;
+            }
+
+            Assert(PassRefCounts[PassIndex] > 0);
+            if (--PassRefCounts[PassIndex] == 0 && !Pass.HasSideEffects)
+            {
+                CullPass(PassIndex);
+            }
+        }
+    }
+}
+
+void RenderGraph::ComputeDependencyLevels()
+{
+    // A pass that reads a texture depends on the passes that wrote it before, and a pass that writes a texture
+    // depends on all the passes that accessed it before. Passes on the same level do not depend on each other and
+    // could run at the same time on different queues.
+    TArray<uint32> LevelAfterWrite(Textures.Size(), 0);
+    TArray<uint32> LevelAfterAccess(Textures.Size(), 0);
+
+    uint32 NumLevels = 0;
+    for (uint32 PassIndex : ExecutionOrder)
+    {
+        RenderGraphPassNode& Pass = Passes[PassIndex];
+
+        uint32 Level = 0;
+        for (const RenderGraphTextureAccess& Access : Pass.Accesses)
+        {
+            const uint32 TextureIndex = Access.Texture.Index;
+            Level = std::max(Level, Access.IsWrite ? LevelAfterAccess[TextureIndex] : LevelAfterWrite[TextureIndex]);
+        }
+
+        Pass.DependencyLevel = Level;
+        NumLevels = std::max(NumLevels, Level + 1);
+
+        for (const RenderGraphTextureAccess& Access : Pass.Accesses)
+        {
+            const uint32 TextureIndex = Access.Texture.Index;
+            LevelAfterAccess[TextureIndex] = std::max(LevelAfterAccess[TextureIndex], Level + 1);
+            if (Access.IsWrite)
+            {
+                LevelAfterWrite[TextureIndex] = std::max(LevelAfterWrite[TextureIndex], Level + 1);
+            }
+        }
+    }
+
+    Statistics.NumDependencyLevels = NumLevels;
+}
+
+void RenderGraph::ComputeLifetimes()
+{
+    for (RenderGraphTextureNode& Texture : Textures)
+    {
+        Texture.FirstPass = INVALID_RENDER_GRAPH_INDEX;
+        Texture.LastPass  = INVALID_RENDER_GRAPH_INDEX;
+    }
+
+    for (uint32 Position = 0; Position < ExecutionOrder.Size(); Position++)
+    {
+        const RenderGraphPassNode& Pass = Passes[ExecutionOrder[Position]];
+        for (const RenderGraphTextureAccess& Access : Pass.Accesses)
+        {
+            RenderGraphTextureNode& Texture = Textures[Access.Texture.Index];
+            if (!Texture.IsUsed())
+            {
+                if (!Texture.IsImported() && !Access.IsWrite)
+                {
+                    LOG_WARNING("[RenderGraph]: Transient texture '" + Texture.Name + "' is read by '" + Pass.Name + "' before it is written");
+                }
+
+                Texture.FirstPass = Position;
+            }
+
+            Texture.LastPass = Position;
+        }
+    }
+}
+
+void RenderGraph::AssignPhysicalTextures()
+{
+    TArray<uint32> TransientTextures;
+    for (uint32 TextureIndex = 0; TextureIndex < Textures.Size(); TextureIndex++)
+    {
+        RenderGraphTextureNode& Texture = Textures[TextureIndex];
+        Texture.PhysicalSlot = INVALID_RENDER_GRAPH_INDEX;
+
+        if (!Texture.IsImported() && Texture.IsUsed())
+        {
+            TransientTextures.EmplaceBack(TextureIndex);
+        }
+    }
+
+    std::stable_sort(TransientTextures.begin(), TransientTextures.end(), [this](uint32 Lhs, uint32 Rhs)
+    {
+        return Textures[Lhs].FirstPass < Textures[Rhs].FirstPass;
+    });
+
+    // A slot can be reused by a texture with the same description when the lifetime of the last texture in the slot
+    // has ended before the new texture is first used
+    TArray<uint32> SlotLastPasses;
+    PhysicalSlotTextures.Clear();
+
+    Statistics.TransientBytes = 0;
+    Statistics.PhysicalBytes  = 0;
+    for (uint32 TextureIndex : TransientTextures)
+    {
+        RenderGraphTextureNode& Texture = Textures[TextureIndex];
+        Statistics.TransientBytes += Texture.Desc.GetSizeInBytes();
+
+        for (uint32 Slot = 0; Slot < PhysicalSlotTextures.Size(); Slot++)
+        {
+            const RenderGraphTextureDesc& SlotDesc = Textures[PhysicalSlotTextures[Slot]].Desc;
+            if (SlotLastPasses[Slot] < Texture.FirstPass && SlotDesc.IsCompatible(Texture.Desc))
+            {
+                Texture.PhysicalSlot = Slot;
+                SlotLastPasses[Slot] = Texture.LastPass;
+                break;
+            }
+        }
+
+        if (Texture.PhysicalSlot == INVALID_RENDER_GRAPH_INDEX)
+        {
+            Texture.PhysicalSlot = PhysicalSlotTextures.Size();
+            PhysicalSlotTextures.EmplaceBack(TextureIndex);
+            SlotLastPasses.EmplaceBack(Texture.LastPass);
+
+            Statistics.PhysicalBytes += Texture.Desc.GetSizeInBytes();
+        }
+    }
+
+    Statistics.NumTransientTextures = TransientTextures.Size();
+    Statistics.NumPhysicalTextures  = PhysicalSlotTextures.Size();
+}
+
+void RenderGraph::AllocateTextures(RenderGraphResourcePool& Pool)
+{
+    Assert(IsCompiled);
+
+    Pool.BeginFrame();
+
+    PhysicalTextures.Resize(PhysicalSlotTextures.Size(), nullptr);
+    for (uint32 Slot = 0; Slot < PhysicalSlotTextures.Size(); Slot++)
+    {
+        const RenderGraphTextureNode& Texture = Textures[PhysicalSlotTextures[Slot]];
+        PhysicalTextures[Slot] = Pool.AcquireTexture(Texture.Desc, Texture.Name);
+    }
+}
+
+void RenderGraph::Execute(CommandList& CmdList)
+{
+    Assert(IsCompiled);
+    Assert(PhysicalTextures.Size() == PhysicalSlotTextures.Size());
+
+    for (uint32 PassIndex : ExecutionOrder)
+    {
+        RenderGraphPassNode& Pass = Passes[PassIndex];
+
+        // Transitions that already are in the right state are skipped by the RenderLayer
+        for (const RenderGraphTextureAccess& Access : Pass.Accesses)
+        {
+            Texture* PhysicalTexture = GetTexture(Access.Texture);
+            if (PhysicalTexture)
+            {
+                CmdList.TransitionTexture(PhysicalTexture, Access.State);
+            }
+        }
+
+        if (Pass.ExecuteFunc)
+        {
+            Pass.ExecuteFunc(CmdList);
+        }
+    }
+}
+
+Texture* RenderGraph::GetTexture(RenderGraphTexture Texture) const
+{
+    Assert(Texture.IsValid());
+
+    const RenderGraphTextureNode& Node = Textures[Texture.Index];
+    if (Node.IsImported())
+    {
+        return Node.ImportedTexture;
+    }
+    else if (Node.PhysicalSlot < PhysicalTextures.Size())
+    {
+        return PhysicalTextures[Node.PhysicalSlot];
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+std::string RenderGraph::DumpToString() const
+{
+    std::string Text;
+    char Line[256];
+
+    Text += "Passes:\n";
+    for (uint32 PassIndex = 0; PassIndex < Passes.Size(); PassIndex++)
+    {
+        const RenderGraphPassNode& Pass = Passes[PassIndex];
+
+        const char* QueueName = (Pass.Queue == ERenderGraphQueue::Compute) ? "Compute" : "Graphics";
+        if (Pass.IsCulled)
+        {
+            snprintf(Line, sizeof(Line), "    %-24s %-8s Culled\n", Pass.Name.c_str(), QueueName);
+        }
+        else
+        {
+            snprintf(Line, sizeof(Line), "    %-24s %-8s Level=%u\n", Pass.Name.c_str(), QueueName, Pass.DependencyLevel);
+        }
+
+        Text += Line;
+    }
+
+    Text += "Textures:\n";
+    for (const RenderGraphTextureNode& Texture : Textures)
+    {
+        if (!Texture.IsUsed())
+        {
+            snprintf(Line, sizeof(Line), "    %-24s Unused\n", Texture.Name.c_str());
+        }
+        else if (Texture.IsImported())
+        {
+            snprintf(Line, sizeof(Line), "    %-24s Imported  Passes=[%u, %u]\n", Texture.Name.c_str(), Texture.FirstPass, Texture.LastPass);
+        }
+        else
+        {
+            snprintf(Line, sizeof(Line), "    %-24s Transient Passes=[%u, %u] Slot=%u Size=%s\n",
+                Texture.Name.c_str(),
+                Texture.FirstPass,
+                Texture.LastPass,
+                Texture.PhysicalSlot,
+                ToMegaBytes(Texture.Desc.GetSizeInBytes()).c_str());
+        }
+
+        Text += Line;
+    }
+
+    snprintf(Line, sizeof(Line), "Passes=%u Culled=%u DependencyLevels=%u\n", Statistics.NumPasses, Statistics.NumCulledPasses, Statistics.NumDependencyLevels);
+    Text += Line;
+
+    snprintf(Line, sizeof(Line), "TransientTextures=%u PhysicalTextures=%u\n", Statistics.NumTransientTextures, Statistics.NumPhysicalTextures);
+    Text += Line;
+
+    Text += "Memory of the transient textures: " + ToMegaBytes(Statistics.TransientBytes) + "\n";
+    Text += "Memory of the pooled physical textures: " + ToMegaBytes(Statistics.PhysicalBytes) + "\n";
+    return Text;
+}
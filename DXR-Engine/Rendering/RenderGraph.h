@@ -0,0 +1,242 @@
+#pragma once
+#include "RenderLayer/Resources.h"
+#include "RenderLayer/CommandList.h"
+
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Function.h"
+
+#include <string>
+
+class RenderGraph;
+
+constexpr uint32 INVALID_RENDER_GRAPH_INDEX = uint32(~0);
+
+enum class ERenderGraphQueue
+{
+    Graphics = 0,
+    Compute  = 1,
+};
+
+struct RenderGraphTextureDesc
+{
+    RenderGraphTextureDesc() = default;
+
+    RenderGraphTextureDesc(EFormat InFormat, uint32 InWidth, uint32 InHeight, uint32 InFlags, const ClearValue& InOptimizedClearValue = ClearValue())
+        : Format(InFormat)
+        , Width(InWidth)
+        , Height(InHeight)
+        , Flags(InFlags)
+        , OptimizedClearValue(InOptimizedClearValue)
+    {
+    }
+
+    // Textures are only reused for descriptions that are equal, the clear value is part of the D3D12 resource
+    bool IsCompatible(const RenderGraphTextureDesc& Other) const;
+
+    // Estimated size of the texture in bytes, used for the statistics
+    uint64 GetSizeInBytes() const;
+
+    EFormat    Format = EFormat::Unknown;
+    uint32     Width  = 0;
+    uint32     Height = 0;
+    uint32     Flags  = TextureFlag_None;
+    ClearValue OptimizedClearValue;
+};
+
+// Handle to a texture in a RenderGraph, only valid for the graph that created it
+struct RenderGraphTexture
+{
+    bool IsValid() const { return Index != INVALID_RENDER_GRAPH_INDEX; }
+
+    uint32 Index = INVALID_RENDER_GRAPH_INDEX;
+};
+
+struct RenderGraphTextureAccess
+{
+    RenderGraphTexture Texture;
+    EResourceState     State;
+    bool               IsWrite;
+};
+
+struct RenderGraphTextureNode
+{
+    std::string            Name;
+    RenderGraphTextureDesc Desc;
+
+    // Imported textures are owned outside of the graph and live longer than the frame
+    Texture* ImportedTexture = nullptr;
+
+    // Set by Compile, indices of the passes that read or write the texture
+    TArray<uint32> Readers;
+    TArray<uint32> Writers;
+
+    // Set by Compile, index into the execution order
+    uint32 FirstPass = INVALID_RENDER_GRAPH_INDEX;
+    uint32 LastPass  = INVALID_RENDER_GRAPH_INDEX;
+
+    // Set by Compile for transient textures, textures that share a slot share the same physical texture
+    uint32 PhysicalSlot = INVALID_RENDER_GRAPH_INDEX;
+
+    bool IsImported() const { return ImportedTexture != nullptr; }
+    bool IsUsed() const { return FirstPass != INVALID_RENDER_GRAPH_INDEX; }
+};
+
+struct RenderGraphPassNode
+{
+    std::string       Name;
+    ERenderGraphQueue Queue = ERenderGraphQueue::Graphics;
+
+    TFunction<void(CommandList&)> ExecuteFunc;
+
+    TArray<RenderGraphTextureAccess> Accesses;
+
+    // Passes with side effects, such as writing to a buffer outside of the graph, are never culled
+    bool HasSideEffects = false;
+
+    // Set by Compile
+    bool   IsCulled        = false;
+    uint32 DependencyLevel = 0;
+};
+
+/*
+* Returned when a pass is added to a RenderGraph and used to declare the textures that the pass accesses. The state
+* that is declared is the state the texture is transitioned to before the pass is executed.
+*/
+
+class RenderGraphPassBuilder
+{
+public:
+    RenderGraphPassBuilder(RenderGraph& InGraph, uint32 InPassIndex)
+        : Graph(InGraph)
+        , PassIndex(InPassIndex)
+    {
+    }
+
+    RenderGraphPassBuilder& Read(RenderGraphTexture Texture, EResourceState State);
+    RenderGraphPassBuilder& Write(RenderGraphTexture Texture, EResourceState State);
+
+    RenderGraphPassBuilder& SetSideEffects();
+
+private:
+    RenderGraph& Graph;
+    uint32       PassIndex;
+};
+
+struct RenderGraphStatistics
+{
+    uint32 NumPasses            = 0;
+    uint32 NumCulledPasses      = 0;
+    uint32 NumDependencyLevels  = 0;
+    uint32 NumTransientTextures = 0;
+    uint32 NumPhysicalTextures  = 0;
+
+    // Memory of the transient textures if each one had its own physical texture
+    uint64 TransientBytes = 0;
+
+    // Memory of the physical textures, a physical texture is shared by transient textures with equal descriptions
+    // whose lifetimes do not overlap
+    uint64 PhysicalBytes = 0;
+};
+
+/*
+* Caches the physical textures of the transient textures in a RenderGraph between frames. Textures that have not been
+* used for a few frames, for example after the window is resized, are released.
+*/
+
+class RenderGraphResourcePool
+{
+public:
+    RenderGraphResourcePool()  = default;
+    ~RenderGraphResourcePool() = default;
+
+    void BeginFrame();
+
+    Texture2D* AcquireTexture(const RenderGraphTextureDesc& Desc, const std::string& Name);
+
+    void Release();
+
+    uint32 GetNumTextures() const { return Textures.Size(); }
+
+private:
+    struct PooledTexture
+    {
+        RenderGraphTextureDesc Desc;
+        TRef<Texture2D>        Texture;
+        uint64                 LastUsedFrame;
+    };
+
+    TArray<PooledTexture> Textures;
+    uint64 FrameIndex = 0;
+};
+
+// Textures that are not acquired for this many frames are released
+constexpr uint64 RENDER_GRAPH_POOL_MAX_UNUSED_FRAMES = 3;
+
+/*
+* A RenderGraph is built every frame. Passes are added in submission order and declare the textures they read and
+* write. Compile culls the passes whose results are never used, computes the lifetime of each texture and assigns
+* the transient textures to physical textures, without touching the RenderLayer so that it can be run on the CPU only.
+* AllocateTextures acquires the physical textures from a pool and Execute transitions the textures into the declared
+* states before each pass is recorded. A physical texture is only shared by transient textures with equal descriptions,
+* memory is never aliased between different descriptions, and the pool keeps its textures between frames, so a graph
+* only needs less memory than one texture per transient texture when it has chains of equal textures.
+*/
+
+class RenderGraph
+{
+    friend class RenderGraphPassBuilder;
+
+public:
+    RenderGraph()  = default;
+    ~RenderGraph() = default;
+
+    RenderGraphTexture CreateTexture(const std::string& Name, const RenderGraphTextureDesc& Desc);
+    RenderGraphTexture ImportTexture(const std::string& Name, Texture* InTexture);
+
+    RenderGraphPassBuilder AddPass(const std::string& Name, ERenderGraphQueue Queue, const TFunction<void(CommandList&)>& ExecuteFunc);
+
+    void Compile();
+
+    // Acquires the physical textures from the pool, must be called after Compile and before Execute
+    void AllocateTextures(RenderGraphResourcePool& Pool);
+
+    void Execute(CommandList& CmdList);
+
+    // Returns the physical texture after AllocateTextures has been called, nullptr if the texture is not used. Transient
+    // textures are always Texture2Ds.
+    Texture* GetTexture(RenderGraphTexture Texture) const;
+
+    const RenderGraphTextureNode& GetTextureNode(RenderGraphTexture Texture) const
+    {
+        Assert(Texture.IsValid());
+        return Textures[Texture.Index];
+    }
+
+    const RenderGraphPassNode& GetPass(uint32 PassIndex) const { return Passes[PassIndex]; }
+    uint32 GetNumPasses() const { return Passes.Size(); }
+
+    // Indices of the passes that are not culled, in the order they are executed
+    const TArray<uint32>& GetExecutionOrder() const { return ExecutionOrder; }
+
+    const RenderGraphStatistics& GetStatistics() const { return Statistics; }
+
+    // Writes the passes, the lifetime of each texture and the memory statistics as text
+    std::string DumpToString() const;
+
+private:
+    void CullPasses();
+    void ComputeDependencyLevels();
+    void ComputeLifetimes();
+    void AssignPhysicalTextures();
+
+    TArray<RenderGraphTextureNode> Textures;
+    TArray<RenderGraphPassNode>    Passes;
+    TArray<uint32>                 ExecutionOrder;
+
+    // The first texture that is assigned to each physical slot, the slot uses its description
+    TArray<uint32>     PhysicalSlotTextures;
+    TArray<Texture2D*> PhysicalTextures;
+
+    RenderGraphStatistics Statistics;
+    bool IsCompiled = false;
+};
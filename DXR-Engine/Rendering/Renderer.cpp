@@ -5,17 +5,21 @@
 #include "Resources/Mesh.h"
 
 #include "Scene/Frustum.h"
+#include "Scene/FrustumCulling.h"
+#include "Scene/MeshletCulling.h"
 #include "Scene/Lights/PointLight.h"
 #include "Scene/Lights/DirectionalLight.h"
 
 #include "Core/Engine/Engine.h"
 
 #include "RenderLayer/ShaderCompiler.h"
+#include "RenderLayer/CommandListCapture.h"
 
 #include "Debug/Profiler.h"
 #include "Debug/Console/Console.h"
 
 #include <algorithm>
+#include <cfloat>
 #include <imgui_internal.h>
 
 static const uint32 ShadowMapSampleCount = 2;
@@ -36,7 +40,22 @@ TConsoleVariable<bool> GPrePassEnabled(true);
 TConsoleVariable<bool> GDrawAABBs(false);
 TConsoleVariable<bool> GVSyncEnabled(false);
 TConsoleVariable<bool> GFrustumCullEnabled(true);
+TConsoleVariable<bool> GOcclusionCullEnabled(true);
+TConsoleVariable<bool> GBVHCullEnabled(true);
+TConsoleVariable<bool> GLODSelectionEnabled(true);
+TConsoleVariable<bool> GMeshletCullEnabled(true);
+TConsoleVariable<float> GMinScreenPixels(2.0f);
 TConsoleVariable<bool> GRayTracingEnabled(true);
+TConsoleVariable<bool> GParallelRecordingEnabled(true);
+
+ConsoleCommand GCaptureFrame;
+ConsoleCommand GDumpRenderGraph;
+
+// Maximum number of triangles that are rasterized into the OcclusionBuffer each frame
+static constexpr uint32 OCCLUDER_TRIANGLE_BUDGET = 65536;
+
+// Objects whose bounding sphere is smaller than this, as radius over distance, hide too little to be worth rasterizing
+static constexpr float OCCLUDER_MIN_SCREEN_SIZE = 0.1f;
 
 
 struct CameraBufferDesc
@@ -58,31 +77,230 @@ void Renderer::PerformFrustumCulling(const Scene& Scene)
 {
     TRACE_SCOPE("Frustum Culling");
 
-    Camera* Camera        = Scene.GetCamera();
-    Frustum CameraFrustum = Frustum(Camera->GetFarPlane(), Camera->GetViewMatrix(), Camera->GetProjectionMatrix());
-    for (const MeshDrawCommand& Command : Scene.GetMeshDrawCommands())
-    {
-        const XMFLOAT4X4& Transform = Command.CurrentActor->GetTransform().GetMatrix();
-        XMMATRIX XmTransform = XMMatrixTranspose(XMLoadFloat4x4(&Transform));
-        XMVECTOR XmTop       = XMVectorSetW(XMLoadFloat3(&Command.Mesh->BoundingBox.Top), 1.0f);
-        XMVECTOR XmBottom    = XMVectorSetW(XMLoadFloat3(&Command.Mesh->BoundingBox.Bottom), 1.0f);
-        XmTop    = XMVector4Transform(XmTop, XmTransform);
-        XmBottom = XMVector4Transform(XmBottom, XmTransform);
-
-        AABB Box;
-        XMStoreFloat3(&Box.Top, XmTop);
-        XMStoreFloat3(&Box.Bottom, XmBottom);
-        if (CameraFrustum.CheckAABB(Box))
+    const TArray<MeshDrawCommand>& MeshDrawCommands = Scene.GetMeshDrawCommands();
+
+    // All views are culled with a single walk over the bounds of the scene, and the LODs of every view are selected
+    // in one pass afterwards, so both get the views in the same order
+    ViewCulling.ClearViews();
+    ViewLODs.ClearViews();
+
+    Camera* Camera = Scene.GetCamera();
+    const uint32 CameraView = ViewCulling.AddView(Frustum(Camera->GetFarPlane(), Camera->GetViewMatrix(), Camera->GetProjectionMatrix()));
+
+    LODView CameraLODView;
+    CameraLODView.Position        = Camera->GetPosition();
+    CameraLODView.ProjectionScale = Camera->GetProjectionMatrix()._22;
+    CameraLODView.Height          = float(Resources.MainWindowViewport->GetHeight());
+    ViewLODs.AddView(CameraLODView);
+
+    for (PointLightShadowMapGenerationData& Data : LightSetup.PointLightShadowMapsGenerationData)
+    {
+        Data.FirstCullingView = ViewCulling.GetNumViews();
+        for (uint32 Face = 0; Face < 6; Face++)
         {
-            if (Command.Material->HasAlphaMask())
+            ViewCulling.AddView(Frustum(Data.FarPlane, Data.ViewMatrix[Face], Data.ProjMatrix[Face]));
+
+            LODView FaceLODView;
+            FaceLODView.Position        = Data.Position;
+            FaceLODView.ProjectionScale = Data.ProjMatrix[Face]._22;
+            FaceLODView.Height          = float(LightSetup.PointLightShadowSize);
+            ViewLODs.AddView(FaceLODView);
+        }
+    }
+
+    for (DirLightShadowMapGenerationData& Data : LightSetup.DirLightShadowMapsGenerationData)
+    {
+        Frustum LightFrustum;
+        LightFrustum.CreateFromMatrix(Data.Matrix);
+        Data.CullingView = ViewCulling.AddView(LightFrustum);
+
+        // The matrix is transposed, so the second row is what the world position is projected on to get y
+        const XMFLOAT4X4& Matrix = Data.Matrix;
+
+        LODView LightLODView;
+        LightLODView.Position        = Data.Position;
+        LightLODView.ProjectionScale = sqrtf((Matrix._21 * Matrix._21) + (Matrix._22 * Matrix._22) + (Matrix._23 * Matrix._23));
+        LightLODView.Height          = float(LightSetup.ShadowMapHeight);
+        LightLODView.IsOrthographic  = true;
+        ViewLODs.AddView(LightLODView);
+    }
+
+    // The camera and the shadow views are culled with the BoundingVolumeHierarchy of the scene, the linear walk over
+    // all bounds is kept to compare against and for commands that were added after the tree was last updated
+    const BoundingBoxSoA&          WorldBoundingBoxes = Scene.GetWorldBoundingBoxes();
+    const BoundingVolumeHierarchy& BVH                = Scene.GetBoundingVolumeHierarchy();
+    if (GBVHCullEnabled.GetBool() && BVH.GetNumObjects() == WorldBoundingBoxes.Size())
+    {
+        ViewCulling.Cull(BVH);
+    }
+    else
+    {
+        ViewCulling.Cull(WorldBoundingBoxes);
+    }
+
+    // Objects that are too small to be seen are hidden in the culling before the occluders are selected
+    const bool IsLODSelectionEnabled = GLODSelectionEnabled.GetBool();
+    if (IsLODSelectionEnabled)
+    {
+        ViewLODs.Select(MeshDrawCommands, Scene.GetWorldBoundingSpheres(), ViewCulling, GMinScreenPixels.GetFloat());
+    }
+
+    const bool IsOcclusionCullingEnabled = GOcclusionCullEnabled.GetBool();
+    if (IsOcclusionCullingEnabled)
+    {
+        RenderOccluders(Scene, CameraView);
+    }
+
+    const bool     IsMeshletCullingEnabled = GMeshletCullEnabled.GetBool();
+    const Frustum& CameraFrustum           = ViewCulling.GetView(CameraView);
+
+    uint32 NumCulledTriangles = 0;
+
+    for (uint32 Index = 0; Index < MeshDrawCommands.Size(); Index++)
+    {
+        if (!ViewCulling.IsVisible(CameraView, Index))
+        {
+            continue;
+        }
+
+        if (IsOcclusionCullingEnabled)
+        {
+            const XMFLOAT3 Center(WorldBoundingBoxes.GetCenterX()[Index], WorldBoundingBoxes.GetCenterY()[Index], WorldBoundingBoxes.GetCenterZ()[Index]);
+            const XMFLOAT3 Extent(WorldBoundingBoxes.GetExtentX()[Index], WorldBoundingBoxes.GetExtentY()[Index], WorldBoundingBoxes.GetExtentZ()[Index]);
+            if (!OcclusionBuffer.IsBoxVisible(Center, Extent))
             {
-                Resources.ForwardVisibleCommands.EmplaceBack(Command);
+                continue;
+            }
+        }
+
+        MeshDrawCommand Command = MeshDrawCommands[Index];
+        if (IsLODSelectionEnabled)
+        {
+            Mesh* LODMesh = Command.Mesh->GetLOD(ViewLODs.GetLOD(CameraView, Index));
+            Command.Mesh         = LODMesh;
+            Command.VertexBuffer = LODMesh->VertexBuffer.Get();
+            Command.IndexBuffer  = LODMesh->IndexBuffer.Get();
+        }
+
+        // Large meshes are culled per meshlet as well. The forward pass draws both sides of the triangles, so the
+        // meshlets of the commands that it draws are only culled by the frustum.
+        if (IsMeshletCullingEnabled && Command.Mesh->Meshlets.Size() > 1)
+        {
+            const Transform& ActorTransform = Command.CurrentActor->GetTransform();
+            const uint32 NumRanges = CullMeshlets(
+                Command.Mesh->Meshlets.Data(),
+                Command.Mesh->Meshlets.Size(),
+                CameraFrustum,
+                Camera->GetPosition(),
+                ActorTransform.GetMatrix(),
+                ActorTransform.GetMatrixInverse(),
+                !Command.Material->HasAlphaMask(),
+                Resources.MeshDrawRanges);
+
+            uint32 NumVisibleIndices = 0;
+            for (uint32 Range = Resources.MeshDrawRanges.Size() - NumRanges; Range < Resources.MeshDrawRanges.Size(); Range++)
+            {
+                NumVisibleIndices += Resources.MeshDrawRanges[Range].NumIndices;
+            }
+
+            NumCulledTriangles += (Command.Mesh->IndexCount - NumVisibleIndices) / 3;
+            if (NumRanges == 0)
+            {
+                continue;
+            }
+
+            // A single range that covers the whole mesh is the same as drawing without ranges
+            if (NumVisibleIndices == Command.Mesh->IndexCount)
+            {
+                Resources.MeshDrawRanges.PopBack();
             }
             else
             {
-                Resources.DeferredVisibleCommands.EmplaceBack(Command);
+                Command.FirstDrawRange = Resources.MeshDrawRanges.Size() - NumRanges;
+                Command.NumDrawRanges  = NumRanges;
             }
         }
+
+        if (Command.Material->HasAlphaMask())
+        {
+            Resources.ForwardVisibleCommands.EmplaceBack(Command);
+        }
+        else
+        {
+            Resources.DeferredVisibleCommands.EmplaceBack(Command);
+        }
+    }
+
+    LastFrameNumOccluded        = IsOcclusionCullingEnabled ? OcclusionBuffer.GetStatistics().NumOccludedBoxes : 0;
+    LastFrameNumCulledTriangles = NumCulledTriangles;
+}
+
+void Renderer::RenderOccluders(const Scene& Scene, uint32 CameraView)
+{
+    TRACE_SCOPE("Render Occluders");
+
+    const TArray<MeshDrawCommand>& MeshDrawCommands = Scene.GetMeshDrawCommands();
+    const TArray<XMFLOAT4>&        BoundingSpheres  = Scene.GetWorldBoundingSpheres();
+
+    Camera* Camera = Scene.GetCamera();
+    const XMFLOAT3 CameraPosition = Camera->GetPosition();
+
+    // Large objects close to the camera hide the most, objects with alpha masks can be seen through and meshes that
+    // were created without an occluder are never selected
+    struct OccluderCandidate
+    {
+        float  Size;
+        uint32 Index;
+    };
+
+    TArray<OccluderCandidate> Candidates;
+    for (uint32 Index = 0; Index < MeshDrawCommands.Size(); Index++)
+    {
+        const MeshDrawCommand& Command = MeshDrawCommands[Index];
+        if (!ViewCulling.IsVisible(CameraView, Index) || Command.Material->HasAlphaMask() || Command.Mesh->OccluderIndices.IsEmpty())
+        {
+            continue;
+        }
+
+        const XMFLOAT4& Sphere = BoundingSpheres[Index];
+        const float DeltaX   = Sphere.x - CameraPosition.x;
+        const float DeltaY   = Sphere.y - CameraPosition.y;
+        const float DeltaZ   = Sphere.z - CameraPosition.z;
+        const float Distance = sqrtf((DeltaX * DeltaX) + (DeltaY * DeltaY) + (DeltaZ * DeltaZ));
+
+        const float Size = Distance > Sphere.w ? Sphere.w / Distance : FLT_MAX;
+        if (Size >= OCCLUDER_MIN_SCREEN_SIZE)
+        {
+            Candidates.EmplaceBack(OccluderCandidate{ Size, Index });
+        }
+    }
+
+    std::sort(Candidates.Data(), Candidates.Data() + Candidates.Size(), [](const OccluderCandidate& Left, const OccluderCandidate& Right)
+    {
+        return Left.Size > Right.Size;
+    });
+
+    Occluders.Clear();
+
+    uint32 NumTriangles = 0;
+    for (const OccluderCandidate& Candidate : Candidates)
+    {
+        const Mesh* Mesh = MeshDrawCommands[Candidate.Index].Mesh;
+
+        const uint32 NumMeshTriangles = Mesh->OccluderIndices.Size() / 3;
+        if (NumTriangles + NumMeshTriangles <= OCCLUDER_TRIANGLE_BUDGET)
+        {
+            Occluders.EmplaceBack(Candidate.Index);
+            NumTriangles += NumMeshTriangles;
+        }
+    }
+
+    OcclusionBuffer.BeginFrame(Camera->GetViewProjectionMatrix());
+    for (uint32 Index : Occluders)
+    {
+        const MeshDrawCommand& Command = MeshDrawCommands[Index];
+        const Mesh* Mesh = Command.Mesh;
+        OcclusionBuffer.RenderOccluder(Mesh->OccluderPositions.Data(), Mesh->OccluderIndices.Data(), Mesh->OccluderIndices.Size(), Command.CurrentActor->GetTransform().GetMatrix());
     }
 }
 
@@ -306,6 +524,18 @@ void Renderer::RenderDebugInterface()
         ImGui::NextColumn();
 
         ImGui::Text("%d", LastFrameNumCommands);
+        ImGui::NextColumn();
+
+        ImGui::Text("Occluded: ");
+        ImGui::NextColumn();
+
+        ImGui::Text("%d", LastFrameNumOccluded);
+        ImGui::NextColumn();
+
+        ImGui::Text("Culled Triangles: ");
+        ImGui::NextColumn();
+
+        ImGui::Text("%d", LastFrameNumCulledTriangles);
 
         ImGui::Columns(1);
 
@@ -315,34 +545,13 @@ void Renderer::RenderDebugInterface()
 
 void Renderer::Tick(const Scene& Scene)
 {
-    // Perform frustum culling
-    Resources.DeferredVisibleCommands.Clear();
-    Resources.ForwardVisibleCommands.Clear();
     Resources.DebugTextures.Clear();
 
-    if (!GFrustumCullEnabled.GetBool())
-    {
-        for (const MeshDrawCommand& Command : Scene.GetMeshDrawCommands())
-        {
-            if (Command.Material->HasAlphaMask())
-            {
-                Resources.ForwardVisibleCommands.EmplaceBack(Command);
-            }
-            else
-            {
-                Resources.DeferredVisibleCommands.EmplaceBack(Command);
-            }
-        }
-    }
-    else
-    {
-        PerformFrustumCulling(Scene);
-    }
-
     Resources.BackBuffer = Resources.MainWindowViewport->GetBackBuffer();
 
+    // The frame is split into several CommandLists that are executed in the order they are begun
+    CommandList& CmdList = CmdListRecorder.BeginCommandList();
     CmdList.BeginExternalCapture();
-    CmdList.Begin();
 
     Profiler::BeginGPUFrame(CmdList);
 
@@ -353,7 +562,7 @@ void Renderer::Tick(const Scene& Scene)
         INSERT_DEBUG_CMDLIST_MARKER(CmdList, "Begin VRS Image");
         CmdList.SetShadingRate(EShadingRate::VRS_1x1);
 
-        CmdList.TransitionTexture(ShadingImage.Get(), EResourceState::ShadingRateSource, EResourceState::UnorderedAccess);
+        CmdList.TransitionTexture(ShadingImage.Get(), EResourceState::UnorderedAccess);
         
         CmdList.SetComputePipelineState(ShadingRatePipeline.Get());
 
@@ -362,7 +571,7 @@ void Renderer::Tick(const Scene& Scene)
         
         CmdList.Dispatch(ShadingImage->GetWidth(), ShadingImage->GetHeight(), 1);
         
-        CmdList.TransitionTexture(ShadingImage.Get(), EResourceState::UnorderedAccess, EResourceState::ShadingRateSource);
+        CmdList.TransitionTexture(ShadingImage.Get(), EResourceState::ShadingRateSource);
 
         CmdList.SetShadingRateImage(ShadingImage.Get());
 
@@ -375,8 +584,35 @@ void Renderer::Tick(const Scene& Scene)
 
     LightSetup.BeginFrame(CmdList, Scene);
 
-    ShadowMapRenderer.RenderPointLightShadows(CmdList, LightSetup, Scene);
-    ShadowMapRenderer.RenderDirectionalLightShadows(CmdList, LightSetup, Scene);
+    // Perform frustum culling, the views of the shadow maps are known after the lights have been updated
+    Resources.DeferredVisibleCommands.Clear();
+    Resources.ForwardVisibleCommands.Clear();
+    Resources.MeshDrawRanges.Clear();
+
+    if (!GFrustumCullEnabled.GetBool())
+    {
+        for (const MeshDrawCommand& Command : Scene.GetMeshDrawCommands())
+        {
+            if (Command.Material->HasAlphaMask())
+            {
+                Resources.ForwardVisibleCommands.EmplaceBack(Command);
+            }
+            else
+            {
+                Resources.DeferredVisibleCommands.EmplaceBack(Command);
+            }
+        }
+    }
+    else
+    {
+        PerformFrustumCulling(Scene);
+    }
+
+    // The shadow maps are not culled when culling is disabled
+    const MultiViewCulling* ShadowCulling = GFrustumCullEnabled.GetBool() ? &ViewCulling : nullptr;
+    const LODSelection*     ShadowLODs    = ShadowCulling && GLODSelectionEnabled.GetBool() ? &ViewLODs : nullptr;
+    ShadowMapRenderer.RenderPointLightShadows(CmdList, LightSetup, Scene, ShadowCulling, ShadowLODs);
+    ShadowMapRenderer.RenderDirectionalLightShadows(CmdList, LightSetup, Scene, ShadowCulling, ShadowLODs);
 
     if (IsRayTracingSupported())
     {
@@ -398,17 +634,17 @@ void Renderer::Tick(const Scene& Scene)
     CamBuff.FarPlane          = Scene.GetCamera()->GetFarPlane();
     CamBuff.AspectRatio       = Scene.GetCamera()->GetAspectRatio();
 
-    CmdList.TransitionBuffer(Resources.CameraBuffer.Get(), EResourceState::VertexAndConstantBuffer, EResourceState::CopyDest);
+    CmdList.TransitionBuffer(Resources.CameraBuffer.Get(), EResourceState::CopyDest);
 
     CmdList.UpdateBuffer(Resources.CameraBuffer.Get(), 0, sizeof(CameraBufferDesc), &CamBuff);
     
-    CmdList.TransitionBuffer(Resources.CameraBuffer.Get(), EResourceState::CopyDest, EResourceState::VertexAndConstantBuffer);
+    CmdList.TransitionBuffer(Resources.CameraBuffer.Get(), EResourceState::VertexAndConstantBuffer);
     
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_ALBEDO_INDEX].Get(), EResourceState::NonPixelShaderResource, EResourceState::RenderTarget);
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_NORMAL_INDEX].Get(), EResourceState::NonPixelShaderResource, EResourceState::RenderTarget);
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_MATERIAL_INDEX].Get(), EResourceState::NonPixelShaderResource, EResourceState::RenderTarget);
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_VIEW_NORMAL_INDEX].Get(), EResourceState::NonPixelShaderResource, EResourceState::RenderTarget);
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_DEPTH_INDEX].Get(), EResourceState::PixelShaderResource, EResourceState::DepthWrite);
+    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_ALBEDO_INDEX].Get(), EResourceState::RenderTarget);
+    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_NORMAL_INDEX].Get(), EResourceState::RenderTarget);
+    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_MATERIAL_INDEX].Get(), EResourceState::RenderTarget);
+    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_VIEW_NORMAL_INDEX].Get(), EResourceState::RenderTarget);
+    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_DEPTH_INDEX].Get(), EResourceState::DepthWrite);
 
     ColorF BlackClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     CmdList.ClearRenderTargetView(Resources.GBuffer[GBUFFER_ALBEDO_INDEX]->GetRenderTargetView(), BlackClearColor);
@@ -417,182 +653,290 @@ void Renderer::Tick(const Scene& Scene)
     CmdList.ClearRenderTargetView(Resources.GBuffer[GBUFFER_VIEW_NORMAL_INDEX]->GetRenderTargetView(), BlackClearColor);
     CmdList.ClearDepthStencilView(Resources.GBuffer[GBUFFER_DEPTH_INDEX]->GetDepthStencilView(), DepthStencilF(1.0f, 0));
 
+    const bool ParallelRecording = GParallelRecordingEnabled.GetBool();
     if (GPrePassEnabled.GetBool())
     {
-        DeferredRenderer.RenderPrePass(CmdList, Resources);
+        if (ParallelRecording)
+        {
+            DeferredRenderer.RenderPrePass(CmdListRecorder, Resources);
+        }
+        else
+        {
+            DeferredRenderer.RenderPrePass(CmdList, Resources);
+        }
     }
 
+    // The trace is split over several CommandLists so the scope-helper cannot be used here. When recording in parallel
+    // the pre-pass lists are submitted after CmdList, so the begin-timestamp goes into a list that is submitted right
+    // before the base pass lists.
+    if (ParallelRecording)
+    {
+        CommandList& BaseCmdList = CmdListRecorder.BeginCommandList();
+        Profiler::BeginGPUTrace(BaseCmdList, "Base Pass");
+
+        DeferredRenderer.RenderBasePass(CmdListRecorder, Resources);
+    }
+    else
     {
-        GPU_TRACE_SCOPE(CmdList, "Base Pass");
+        Profiler::BeginGPUTrace(CmdList, "Base Pass");
         DeferredRenderer.RenderBasePass(CmdList, Resources);
     }
 
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_ALBEDO_INDEX].Get(), EResourceState::RenderTarget, EResourceState::NonPixelShaderResource);
+    // Rest of the frame is recorded on this thread while the workers finish the base pass
+    CommandList& PostCmdList = CmdListRecorder.BeginCommandList();
+    Profiler::EndGPUTrace(PostCmdList, "Base Pass");
 
     Resources.DebugTextures.EmplaceBack(
         MakeSharedRef<ShaderResourceView>(Resources.GBuffer[GBUFFER_ALBEDO_INDEX]->GetShaderResourceView()),
         Resources.GBuffer[GBUFFER_ALBEDO_INDEX],
-        EResourceState::NonPixelShaderResource,
         EResourceState::NonPixelShaderResource);
 
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_NORMAL_INDEX].Get(), EResourceState::RenderTarget, EResourceState::NonPixelShaderResource);
-
     Resources.DebugTextures.EmplaceBack(
         MakeSharedRef<ShaderResourceView>(Resources.GBuffer[GBUFFER_NORMAL_INDEX]->GetShaderResourceView()),
         Resources.GBuffer[GBUFFER_NORMAL_INDEX],
-        EResourceState::NonPixelShaderResource,
         EResourceState::NonPixelShaderResource);
 
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_VIEW_NORMAL_INDEX].Get(), EResourceState::RenderTarget, EResourceState::NonPixelShaderResource);
-
     Resources.DebugTextures.EmplaceBack(
         MakeSharedRef<ShaderResourceView>(Resources.GBuffer[GBUFFER_VIEW_NORMAL_INDEX]->GetShaderResourceView()),
         Resources.GBuffer[GBUFFER_VIEW_NORMAL_INDEX],
-        EResourceState::NonPixelShaderResource,
         EResourceState::NonPixelShaderResource);
 
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_MATERIAL_INDEX].Get(), EResourceState::RenderTarget, EResourceState::NonPixelShaderResource);
-
     Resources.DebugTextures.EmplaceBack(
         MakeSharedRef<ShaderResourceView>(Resources.GBuffer[GBUFFER_MATERIAL_INDEX]->GetShaderResourceView()),
         Resources.GBuffer[GBUFFER_MATERIAL_INDEX],
-        EResourceState::NonPixelShaderResource,
-        EResourceState::NonPixelShaderResource);
-
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_DEPTH_INDEX].Get(), EResourceState::DepthWrite, EResourceState::NonPixelShaderResource);
-    CmdList.TransitionTexture(Resources.SSAOBuffer.Get(), EResourceState::NonPixelShaderResource, EResourceState::UnorderedAccess);
-
-    const ColorF WhiteColor = { 1.0f, 1.0f, 1.0f, 1.0f };
-    CmdList.ClearUnorderedAccessView(Resources.SSAOBuffer->GetUnorderedAccessView(), WhiteColor);
-
-    if (GEnableSSAO.GetBool())
-    {
-        SSAORenderer.Render(CmdList, Resources);
-    }
-
-    CmdList.TransitionTexture(Resources.SSAOBuffer.Get(), EResourceState::UnorderedAccess, EResourceState::NonPixelShaderResource);
-
-    Resources.DebugTextures.EmplaceBack(
-        MakeSharedRef<ShaderResourceView>(Resources.SSAOBuffer->GetShaderResourceView()),
-        Resources.SSAOBuffer, 
-        EResourceState::NonPixelShaderResource, 
         EResourceState::NonPixelShaderResource);
 
-    CmdList.TransitionTexture(Resources.FinalTarget.Get(), EResourceState::PixelShaderResource, EResourceState::UnorderedAccess);
-    CmdList.TransitionTexture(Resources.BackBuffer, EResourceState::Present, EResourceState::RenderTarget);
-    CmdList.TransitionTexture(LightSetup.IrradianceMap.Get(), EResourceState::PixelShaderResource, EResourceState::NonPixelShaderResource);
-    CmdList.TransitionTexture(LightSetup.SpecularIrradianceMap.Get(), EResourceState::PixelShaderResource, EResourceState::NonPixelShaderResource);
-    CmdList.TransitionTexture(Resources.IntegrationLUT.Get(), EResourceState::PixelShaderResource, EResourceState::NonPixelShaderResource);
-
-    {
-        GPU_TRACE_SCOPE(CmdList, "Light Pass");
-        DeferredRenderer.RenderDeferredTiledLightPass(CmdList, Resources, LightSetup);
-    }
-
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_DEPTH_INDEX].Get(), EResourceState::NonPixelShaderResource, EResourceState::DepthWrite);
-    CmdList.TransitionTexture(Resources.FinalTarget.Get(), EResourceState::UnorderedAccess, EResourceState::RenderTarget);
-
-    SkyboxRenderPass.Render(CmdList, Resources, Scene);
-
-    CmdList.TransitionTexture(LightSetup.PointLightShadowMaps.Get(), EResourceState::NonPixelShaderResource, EResourceState::PixelShaderResource);
-    CmdList.TransitionTexture(LightSetup.DirLightShadowMaps.Get(), EResourceState::NonPixelShaderResource, EResourceState::PixelShaderResource);
-
     Resources.DebugTextures.EmplaceBack(
         MakeSharedRef<ShaderResourceView>(LightSetup.DirLightShadowMaps->GetShaderResourceView()),
         LightSetup.DirLightShadowMaps,
-        EResourceState::PixelShaderResource,
         EResourceState::PixelShaderResource);
 
-    CmdList.TransitionTexture(LightSetup.IrradianceMap.Get(), EResourceState::NonPixelShaderResource, EResourceState::PixelShaderResource);
-    CmdList.TransitionTexture(LightSetup.SpecularIrradianceMap.Get(), EResourceState::NonPixelShaderResource, EResourceState::PixelShaderResource);
-    CmdList.TransitionTexture(Resources.IntegrationLUT.Get(), EResourceState::NonPixelShaderResource, EResourceState::PixelShaderResource);
-
     Resources.DebugTextures.EmplaceBack(
         MakeSharedRef<ShaderResourceView>(Resources.IntegrationLUT->GetShaderResourceView()),
         Resources.IntegrationLUT,
-        EResourceState::PixelShaderResource,
-        EResourceState::PixelShaderResource);
-
-    {
-        GPU_TRACE_SCOPE(CmdList, "Forward Pass");
-        ForwardRenderer.Render(CmdList, Resources, LightSetup);
-    }
-    
-    CmdList.TransitionTexture(Resources.FinalTarget.Get(), EResourceState::RenderTarget, EResourceState::PixelShaderResource);
-
-    Resources.DebugTextures.EmplaceBack(
-        MakeSharedRef<ShaderResourceView>(Resources.FinalTarget->GetShaderResourceView()),
-        Resources.FinalTarget, 
-        EResourceState::PixelShaderResource, 
         EResourceState::PixelShaderResource);
 
-    CmdList.TransitionTexture(Resources.GBuffer[GBUFFER_DEPTH_INDEX].Get(), EResourceState::DepthWrite, EResourceState::PixelShaderResource);
-
     Resources.DebugTextures.EmplaceBack(
         MakeSharedRef<ShaderResourceView>(Resources.GBuffer[GBUFFER_DEPTH_INDEX]->GetShaderResourceView()),
         Resources.GBuffer[GBUFFER_DEPTH_INDEX],
-        EResourceState::PixelShaderResource,
         EResourceState::PixelShaderResource);
 
-    if (GEnableFXAA.GetBool())
-    {
-        PerformFXAA(CmdList);
-    }
-    else
+    // The rest of the frame is scheduled by the RenderGraph, which inserts the transitions before each pass
+    RenderGraph Graph;
+
+    const RenderGraphTexture AlbedoTexture     = Graph.ImportTexture("GBuffer Albedo", Resources.GBuffer[GBUFFER_ALBEDO_INDEX].Get());
+    const RenderGraphTexture NormalTexture     = Graph.ImportTexture("GBuffer Normal", Resources.GBuffer[GBUFFER_NORMAL_INDEX].Get());
+    const RenderGraphTexture MaterialTexture   = Graph.ImportTexture("GBuffer Material", Resources.GBuffer[GBUFFER_MATERIAL_INDEX].Get());
+    const RenderGraphTexture DepthTexture      = Graph.ImportTexture("GBuffer DepthStencil", Resources.GBuffer[GBUFFER_DEPTH_INDEX].Get());
+    const RenderGraphTexture ViewNormalTexture = Graph.ImportTexture("GBuffer ViewNormal", Resources.GBuffer[GBUFFER_VIEW_NORMAL_INDEX].Get());
+    const RenderGraphTexture BackBufferTexture = Graph.ImportTexture("BackBuffer", Resources.BackBuffer);
+
+    const RenderGraphTexture IrradianceTexture         = Graph.ImportTexture("Irradiance Map", LightSetup.IrradianceMap.Get());
+    const RenderGraphTexture SpecularIrradianceTexture = Graph.ImportTexture("Specular Irradiance Map", LightSetup.SpecularIrradianceMap.Get());
+    const RenderGraphTexture IntegrationLUTTexture     = Graph.ImportTexture("Integration LUT", Resources.IntegrationLUT.Get());
+    const RenderGraphTexture DirLightShadowTexture     = Graph.ImportTexture("DirLight ShadowMaps", LightSetup.DirLightShadowMaps.Get());
+    const RenderGraphTexture PointLightShadowTexture   = Graph.ImportTexture("PointLight ShadowMaps", LightSetup.PointLightShadowMaps.Get());
+
+    const uint32 Width  = Resources.MainWindowViewport->GetWidth();
+    const uint32 Height = Resources.MainWindowViewport->GetHeight();
+
+    // The SSAO buffer and the final target have different descriptions and both are alive during the light pass, so
+    // each gets its own physical texture. The graph schedules and transitions these passes but does not save memory.
+    const RenderGraphTexture SSAOTexture = Graph.CreateTexture("SSAO Buffer",
+        RenderGraphTextureDesc(Resources.SSAOBufferFormat, Width, Height, TextureFlags_RWTexture));
+    const RenderGraphTexture FinalTexture = Graph.CreateTexture("Final Target",
+        RenderGraphTextureDesc(Resources.FinalTargetFormat, Width, Height, TextureFlags_RenderTarget | TextureFlag_UAV));
+
+    Graph.AddPass("SSAO", ERenderGraphQueue::Compute, [this](CommandList& InCmdList)
     {
-        PerformBackBufferBlit(CmdList);
-    }
+        const ColorF WhiteColor = { 1.0f, 1.0f, 1.0f, 1.0f };
+        InCmdList.ClearUnorderedAccessView(Resources.SSAOBuffer->GetUnorderedAccessView(), WhiteColor);
+
+        if (GEnableSSAO.GetBool())
+        {
+            SSAORenderer.Render(InCmdList, Resources);
+        }
+
+        Resources.DebugTextures.EmplaceBack(
+            MakeSharedRef<ShaderResourceView>(Resources.SSAOBuffer->GetShaderResourceView()),
+            Resources.SSAOBuffer,
+            EResourceState::PixelShaderResource);
+    })
+    .Read(ViewNormalTexture, EResourceState::NonPixelShaderResource)
+    .Read(DepthTexture, EResourceState::NonPixelShaderResource)
+    .Write(SSAOTexture, EResourceState::UnorderedAccess);
+
+    Graph.AddPass("Light Pass", ERenderGraphQueue::Compute, [this](CommandList& InCmdList)
+    {
+        GPU_TRACE_SCOPE(InCmdList, "Light Pass");
+        DeferredRenderer.RenderDeferredTiledLightPass(InCmdList, Resources, LightSetup);
+    })
+    .Read(AlbedoTexture, EResourceState::NonPixelShaderResource)
+    .Read(NormalTexture, EResourceState::NonPixelShaderResource)
+    .Read(MaterialTexture, EResourceState::NonPixelShaderResource)
+    .Read(DepthTexture, EResourceState::NonPixelShaderResource)
+    .Read(IrradianceTexture, EResourceState::NonPixelShaderResource)
+    .Read(SpecularIrradianceTexture, EResourceState::NonPixelShaderResource)
+    .Read(IntegrationLUTTexture, EResourceState::NonPixelShaderResource)
+    .Read(DirLightShadowTexture, EResourceState::NonPixelShaderResource)
+    .Read(PointLightShadowTexture, EResourceState::NonPixelShaderResource)
+    .Read(SSAOTexture, EResourceState::NonPixelShaderResource)
+    .Write(FinalTexture, EResourceState::UnorderedAccess);
+
+    Graph.AddPass("Skybox", ERenderGraphQueue::Graphics, [this, &Scene](CommandList& InCmdList)
+    {
+        SkyboxRenderPass.Render(InCmdList, Resources, Scene);
+    })
+    .Write(FinalTexture, EResourceState::RenderTarget)
+    .Write(DepthTexture, EResourceState::DepthWrite);
+
+    Graph.AddPass("Forward Pass", ERenderGraphQueue::Graphics, [this](CommandList& InCmdList)
+    {
+        GPU_TRACE_SCOPE(InCmdList, "Forward Pass");
+        ForwardRenderer.Render(InCmdList, Resources, LightSetup);
+    })
+    .Read(IrradianceTexture, EResourceState::PixelShaderResource)
+    .Read(SpecularIrradianceTexture, EResourceState::PixelShaderResource)
+    .Read(IntegrationLUTTexture, EResourceState::PixelShaderResource)
+    .Read(DirLightShadowTexture, EResourceState::PixelShaderResource)
+    .Read(PointLightShadowTexture, EResourceState::PixelShaderResource)
+    .Write(FinalTexture, EResourceState::RenderTarget)
+    .Write(DepthTexture, EResourceState::DepthWrite);
+
+    Graph.AddPass(GEnableFXAA.GetBool() ? "FXAA" : "Draw to BackBuffer", ERenderGraphQueue::Graphics, [this](CommandList& InCmdList)
+    {
+        Resources.DebugTextures.EmplaceBack(
+            MakeSharedRef<ShaderResourceView>(Resources.FinalTarget->GetShaderResourceView()),
+            Resources.FinalTarget,
+            EResourceState::PixelShaderResource);
+
+        if (GEnableFXAA.GetBool())
+        {
+            PerformFXAA(InCmdList);
+        }
+        else
+        {
+            PerformBackBufferBlit(InCmdList);
+        }
+    })
+    .Read(FinalTexture, EResourceState::PixelShaderResource)
+    .Read(DepthTexture, EResourceState::PixelShaderResource)
+    .Write(BackBufferTexture, EResourceState::RenderTarget);
 
     if (GDrawAABBs.GetBool())
     {
-        PerformAABBDebugPass(CmdList);
+        Graph.AddPass("AABB Debug", ERenderGraphQueue::Graphics, [this](CommandList& InCmdList)
+        {
+            PerformAABBDebugPass(InCmdList);
+        })
+        .Write(BackBufferTexture, EResourceState::RenderTarget);
     }
 
-    INSERT_DEBUG_CMDLIST_MARKER(CmdList, "Begin UI Render");
-
+    RenderGraphPassBuilder UIPass = Graph.AddPass("UI", ERenderGraphQueue::Graphics, [this](CommandList& InCmdList)
     {
-        TRACE_SCOPE("Render UI");
+        INSERT_DEBUG_CMDLIST_MARKER(InCmdList, "Begin UI Render");
 
-        DebugUI::DrawUI([]()
         {
-            GRenderer.RenderDebugInterface();
-        });
+            TRACE_SCOPE("Render UI");
 
-        if (IsShadingRateSupported())
-        {
-            CmdList.SetShadingRate(EShadingRate::VRS_1x1);
-            CmdList.SetShadingRateImage(nullptr);
+            DebugUI::DrawUI([]()
+            {
+                GRenderer.RenderDebugInterface();
+            });
+
+            if (IsShadingRateSupported())
+            {
+                InCmdList.SetShadingRate(EShadingRate::VRS_1x1);
+                InCmdList.SetShadingRateImage(nullptr);
+            }
+
+            DebugUI::Render(InCmdList);
         }
 
-        DebugUI::Render(CmdList);
+        INSERT_DEBUG_CMDLIST_MARKER(InCmdList, "End UI Render");
+    });
+
+    UIPass.Write(BackBufferTexture, EResourceState::RenderTarget);
+
+    // The texture debugger displays the transient textures, which extends their lifetime to the end of the frame
+    if (GDrawTextureDebugger.GetBool())
+    {
+        UIPass.Read(SSAOTexture, EResourceState::PixelShaderResource);
+        UIPass.Read(FinalTexture, EResourceState::PixelShaderResource);
+    }
+
+    {
+        TRACE_SCOPE("Compile RenderGraph");
+        Graph.Compile();
+    }
+
+    if (IsRenderGraphDumpRequested)
+    {
+        LOG_INFO("[Renderer]: RenderGraph\n" + Graph.DumpToString());
+        IsRenderGraphDumpRequested = false;
     }
 
-    INSERT_DEBUG_CMDLIST_MARKER(CmdList, "End UI Render");
+    Graph.AllocateTextures(TransientTexturePool);
 
-    CmdList.TransitionTexture(Resources.BackBuffer, EResourceState::RenderTarget, EResourceState::Present);
-    
-    INSERT_DEBUG_CMDLIST_MARKER(CmdList, "--END FRAME--");
+    Resources.SSAOBuffer  = MakeSharedRef<Texture2D>(Graph.GetTexture(SSAOTexture));
+    Resources.FinalTarget = MakeSharedRef<Texture2D>(Graph.GetTexture(FinalTexture));
 
-    Profiler::EndGPUFrame(CmdList);
+    Graph.Execute(PostCmdList);
+
+    PostCmdList.TransitionTexture(Resources.BackBuffer, EResourceState::Present);
+    
+    INSERT_DEBUG_CMDLIST_MARKER(PostCmdList, "--END FRAME--");
 
-    CmdList.End();
-    CmdList.EndExternalCapture();
+    Profiler::EndGPUFrame(PostCmdList);
 
-    LastFrameNumDrawCalls     = CmdList.GetNumDrawCalls();
-    LastFrameNumDispatchCalls = CmdList.GetNumDispatchCalls();
-    LastFrameNumCommands      = CmdList.GetNumCommands();
+    PostCmdList.EndExternalCapture();
 
     {
         TRACE_SCOPE("ExecuteCommandList");
-        GCmdListExecutor.ExecuteCommandList(CmdList);
+        if (IsCaptureRequested)
+        {
+            ExecuteAndCaptureFrame();
+            IsCaptureRequested = false;
+        }
+        else
+        {
+            CmdListRecorder.Execute(GCmdListExecutor);
+        }
     }
 
+    LastFrameNumDrawCalls     = CmdListRecorder.GetNumDrawCalls();
+    LastFrameNumDispatchCalls = CmdListRecorder.GetNumDispatchCalls();
+    LastFrameNumCommands      = CmdListRecorder.GetNumCommands();
+
     {
         TRACE_SCOPE("Present");
         Resources.MainWindowViewport->Present(GVSyncEnabled.GetBool());
     }
 }
 
+void Renderer::ExecuteAndCaptureFrame()
+{
+    CommandListCapture Capture;
+
+    // The capture context records each command before forwarding it to the real context
+    ICommandContext& CmdContext = GCmdListExecutor.GetContext();
+    CaptureCommandContext CaptureContext(Capture, &CmdContext);
+
+    GCmdListExecutor.SetContext(&CaptureContext);
+    CmdListRecorder.Execute(GCmdListExecutor);
+    GCmdListExecutor.SetContext(&CmdContext);
+
+    const std::string Filename = "Frame.dxrcapture";
+    if (Capture.SaveToFile(Filename))
+    {
+        LOG_INFO("[Renderer]: Captured " + std::to_string(Capture.GetNumCommands()) + " commands to '" + Filename + "'");
+    }
+    else
+    {
+        LOG_ERROR("[Renderer]: Failed to save frame capture to '" + Filename + "'");
+    }
+}
+
 bool Renderer::Init()
 {
     INIT_CONSOLE_VARIABLE("r.DrawTextureDebugger", &GDrawTextureDebugger);
@@ -604,8 +948,20 @@ bool Renderer::Init()
     INIT_CONSOLE_VARIABLE("r.EnableDrawAABBs", &GDrawAABBs);
     INIT_CONSOLE_VARIABLE("r.EnableVerticalSync", &GVSyncEnabled);
     INIT_CONSOLE_VARIABLE("r.EnableFrustumCulling", &GFrustumCullEnabled);
+    INIT_CONSOLE_VARIABLE("r.EnableOcclusionCulling", &GOcclusionCullEnabled);
+    INIT_CONSOLE_VARIABLE("r.EnableBVHCulling", &GBVHCullEnabled);
+    INIT_CONSOLE_VARIABLE("r.EnableLODSelection", &GLODSelectionEnabled);
+    INIT_CONSOLE_VARIABLE("r.EnableMeshletCulling", &GMeshletCullEnabled);
+    INIT_CONSOLE_VARIABLE("r.MinScreenPixels", &GMinScreenPixels);
     INIT_CONSOLE_VARIABLE("r.EnableRayTracing", &GRayTracingEnabled);
     INIT_CONSOLE_VARIABLE("r.FXAADebug", &GFXAADebug);
+    INIT_CONSOLE_VARIABLE("r.EnableParallelRecording", &GParallelRecordingEnabled);
+
+    GCaptureFrame.OnExecute.AddObject(this, &Renderer::CaptureNextFrame);
+    INIT_CONSOLE_COMMAND("r.CaptureFrame", &GCaptureFrame);
+
+    GDumpRenderGraph.OnExecute.AddObject(this, &Renderer::DumpNextRenderGraph);
+    INIT_CONSOLE_COMMAND("r.DumpRenderGraph", &GDumpRenderGraph);
 
     Resources.MainWindowViewport = CreateViewport(GEngine.MainWindow.Get(), 0, 0, EFormat::R8G8B8A8_Unorm, EFormat::Unknown);
     if (!Resources.MainWindowViewport)
@@ -649,6 +1005,32 @@ bool Renderer::Init()
         Resources.StdInputLayout->SetName("Standard InputLayoutState");
     }
 
+    if (MESH_PACKED_VERTICES)
+    {
+        InputLayoutStateCreateInfo PackedInputLayout =
+        {
+            { "POSITION", 0, EFormat::R16G16B16A16_Snorm, 0, 0,  EInputClassification::Vertex, 0 },
+            { "NORMAL",   0, EFormat::R16G16_Snorm,       0, 8,  EInputClassification::Vertex, 0 },
+            { "TANGENT",  0, EFormat::R16G16_Snorm,       0, 12, EInputClassification::Vertex, 0 },
+            { "TEXCOORD", 0, EFormat::R16G16_Float,       0, 16, EInputClassification::Vertex, 0 },
+        };
+
+        Resources.MeshInputLayout = CreateInputLayout(PackedInputLayout);
+        if (!Resources.MeshInputLayout)
+        {
+            Debug::DebugBreak();
+            return false;
+        }
+        else
+        {
+            Resources.MeshInputLayout->SetName("Packed InputLayoutState");
+        }
+    }
+    else
+    {
+        Resources.MeshInputLayout = Resources.StdInputLayout;
+    }
+
     {
         SamplerStateCreateInfo CreateInfo;
         CreateInfo.AddressU       = ESamplerMode::Border;
@@ -756,12 +1138,11 @@ bool Renderer::Init()
         }
     }
 
-    CmdList.Begin();
+    CommandList& CmdList = CmdListRecorder.BeginCommandList();
 
     LightProbeRenderer.RenderSkyLightProbe(CmdList, LightSetup, Resources);
 
-    CmdList.End();
-    GCmdListExecutor.ExecuteCommandList(CmdList);
+    CmdListRecorder.Execute(GCmdListExecutor);
 
     // Register EventFunc
     GEngine.OnWindowResizedEvent.AddObject(this, &Renderer::OnWindowResize);
@@ -772,7 +1153,9 @@ void Renderer::Release()
 {
     GCmdListExecutor.WaitForGPU();
 
-    CmdList.Reset();
+    CmdListRecorder.Reset();
+
+    TransientTexturePool.Release();
 
     DeferredRenderer.Release();
     ShadowMapRenderer.Release();
@@ -805,9 +1188,11 @@ void Renderer::Release()
     GPUProfiler.Reset();
     Profiler::SetGPUProfiler(nullptr);
 
-    LastFrameNumDrawCalls     = 0;
-    LastFrameNumDispatchCalls = 0;
-    LastFrameNumCommands      = 0;
+    LastFrameNumDrawCalls       = 0;
+    LastFrameNumDispatchCalls   = 0;
+    LastFrameNumCommands        = 0;
+    LastFrameNumOccluded        = 0;
+    LastFrameNumCulledTriangles = 0;
 }
 
 void Renderer::OnWindowResize(const WindowResizeEvent& Event)
@@ -1248,10 +1633,4 @@ void Renderer::ResizeResources(uint32 Width, uint32 Height)
         Debug::DebugBreak();
         return;
     }
-
-    if (!SSAORenderer.ResizeResources(Resources))
-    {
-        Debug::DebugBreak();
-        return;
-    }
 }
@@ -4,6 +4,9 @@
 #include "Scene/Actor.h"
 #include "Scene/Scene.h"
 #include "Scene/Camera.h"
+#include "Scene/MultiViewCulling.h"
+#include "Scene/OcclusionCulling.h"
+#include "Scene/LODSelection.h"
 
 #include "Resources/Mesh.h"
 #include "Resources/Material.h"
@@ -16,9 +19,11 @@
 #include "SkyboxRenderPass.h"
 #include "ForwardRenderer.h"
 #include "RayTracer.h"
+#include "RenderGraph.h"
 
 #include "RenderLayer/RenderLayer.h"
 #include "RenderLayer/CommandList.h"
+#include "RenderLayer/ParallelCommandListRecorder.h"
 #include "RenderLayer/Viewport.h"
 
 #include "DebugUI.h"
@@ -30,6 +35,7 @@ public:
     void Release();
 
     void PerformFrustumCulling(const Scene& Scene);
+    void RenderOccluders(const Scene& Scene, uint32 CameraView);
     void PerformFXAA(CommandList& InCmdList);
     void PerformBackBufferBlit(CommandList& InCmdList);
 
@@ -39,16 +45,31 @@ public:
 
     void Tick(const Scene& Scene);
 
+    // Captures the commands of the next frame to a file that can be replayed with the CommandListReplay tool
+    void CaptureNextFrame()
+    {
+        IsCaptureRequested = true;
+    }
+
+    // Logs the passes, texture lifetimes and transient memory of the RenderGraph of the next frame
+    void DumpNextRenderGraph()
+    {
+        IsRenderGraphDumpRequested = true;
+    }
+
 private:
     void OnWindowResize(const WindowResizeEvent& Event);
 
+    void ExecuteAndCaptureFrame();
+
     bool InitBoundingBoxDebugPass();
     bool InitAA();
     bool InitShadingImage();
 
     void ResizeResources(uint32 Width, uint32 Height);
 
-    CommandList CmdList;
+    ParallelCommandListRecorder CmdListRecorder;
+    RenderGraphResourcePool     TransientTexturePool;
 
     DeferredRenderer             DeferredRenderer;
     ShadowMapRenderer            ShadowMapRenderer;
@@ -61,6 +82,13 @@ private:
     FrameResources Resources;
     LightSetup     LightSetup;
 
+    MultiViewCulling ViewCulling;
+    LODSelection     ViewLODs;
+    OcclusionBuffer  OcclusionBuffer;
+
+    // Indices of the MeshDrawCommands that are rendered into the OcclusionBuffer this frame
+    TArray<uint32> Occluders;
+
     TRef<Texture2D>            ShadingImage;
     TRef<ComputePipelineState> ShadingRatePipeline;
     TRef<ComputeShader>        ShadingRateShader;
@@ -83,6 +111,13 @@ private:
     uint32 LastFrameNumDrawCalls     = 0;
     uint32 LastFrameNumDispatchCalls = 0;
     uint32 LastFrameNumCommands      = 0;
+    uint32 LastFrameNumOccluded      = 0;
+
+    // Triangles of the meshes that are visible to the camera that are removed by the culling of meshlets
+    uint32 LastFrameNumCulledTriangles = 0;
+
+    bool IsCaptureRequested         = false;
+    bool IsRenderGraphDumpRequested = false;
 };
 
 extern Renderer GRenderer;
\ No newline at end of file
@@ -0,0 +1,998 @@
+#include "GltfFile.h"
+
+#include "Utilities/HashUtilities.h"
+#include "Utilities/StringUtilities.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+// Values of accessor.componentType
+static constexpr uint32 GLTF_BYTE           = 5120;
+static constexpr uint32 GLTF_UNSIGNED_BYTE  = 5121;
+static constexpr uint32 GLTF_SHORT          = 5122;
+static constexpr uint32 GLTF_UNSIGNED_SHORT = 5123;
+static constexpr uint32 GLTF_UNSIGNED_INT   = 5125;
+static constexpr uint32 GLTF_FLOAT          = 5126;
+
+// Value of primitive.mode for triangle lists, which is the default
+static constexpr int64 GLTF_TRIANGLES = 4;
+
+static uint32 ReadUint32(const uint8* Data)
+{
+    uint32 Value;
+    memcpy(&Value, Data, sizeof(Value));
+    return Value;
+}
+
+static uint32 GetComponentSize(uint32 ComponentType)
+{
+    switch (ComponentType)
+    {
+    case GLTF_BYTE:
+    case GLTF_UNSIGNED_BYTE:  return 1;
+    case GLTF_SHORT:
+    case GLTF_UNSIGNED_SHORT: return 2;
+    case GLTF_UNSIGNED_INT:
+    case GLTF_FLOAT:          return 4;
+    default:                  return 0;
+    }
+}
+
+static uint32 GetNumComponents(const std::string& Type)
+{
+    if (Type == "SCALAR")
+    {
+        return 1;
+    }
+    else if (Type == "VEC2")
+    {
+        return 2;
+    }
+    else if (Type == "VEC3")
+    {
+        return 3;
+    }
+    else if (Type == "VEC4" || Type == "MAT2")
+    {
+        return 4;
+    }
+    else if (Type == "MAT3")
+    {
+        return 9;
+    }
+    else if (Type == "MAT4")
+    {
+        return 16;
+    }
+
+    return 0;
+}
+
+static int32 DecodeBase64Character(char Character)
+{
+    if (Character >= 'A' && Character <= 'Z')
+    {
+        return Character - 'A';
+    }
+    else if (Character >= 'a' && Character <= 'z')
+    {
+        return Character - 'a' + 26;
+    }
+    else if (Character >= '0' && Character <= '9')
+    {
+        return Character - '0' + 52;
+    }
+    else if (Character == '+')
+    {
+        return 62;
+    }
+    else if (Character == '/')
+    {
+        return 63;
+    }
+
+    return -1;
+}
+
+// Decodes a "data:[<mime type>];base64,<data>" URI, returns false if the URI is not a base64 data URI
+static bool DecodeDataUri(const std::string& Uri, TArray<uint8>& OutData, std::string& OutMimeType)
+{
+    const std::string Prefix = "data:";
+    const std::string Marker = ";base64,";
+    if (Uri.compare(0, Prefix.size(), Prefix) != 0)
+    {
+        return false;
+    }
+
+    const size_t MarkerPosition = Uri.find(Marker);
+    if (MarkerPosition == std::string::npos)
+    {
+        return false;
+    }
+
+    OutMimeType = Uri.substr(Prefix.size(), MarkerPosition - Prefix.size());
+
+    OutData.Clear();
+    OutData.Reserve(uint32((Uri.size() - MarkerPosition) / 4 * 3));
+
+    uint32 Bits    = 0;
+    uint32 NumBits = 0;
+    for (size_t Index = MarkerPosition + Marker.size(); Index < Uri.size() && Uri[Index] != '='; Index++)
+    {
+        const int32 Value = DecodeBase64Character(Uri[Index]);
+        if (Value < 0)
+        {
+            return false;
+        }
+
+        Bits     = (Bits << 6) | uint32(Value);
+        NumBits += 6;
+        if (NumBits >= 8)
+        {
+            NumBits -= 8;
+            OutData.EmplaceBack(uint8(Bits >> NumBits));
+        }
+    }
+
+    return true;
+}
+
+// Relative URIs can have percent encoded characters, such as %20 for spaces
+static std::string DecodeRelativeUri(const std::string& Uri)
+{
+    std::string Result;
+    Result.reserve(Uri.size());
+
+    for (size_t Index = 0; Index < Uri.size(); Index++)
+    {
+        if (Uri[Index] == '%' && Index + 2 < Uri.size() && isxdigit(uint8(Uri[Index + 1])) && isxdigit(uint8(Uri[Index + 2])))
+        {
+            Result += char(strtol(Uri.substr(Index + 1, 2).c_str(), nullptr, 16));
+            Index += 2;
+        }
+        else
+        {
+            Result += Uri[Index];
+        }
+    }
+
+    ConvertBackslashes(Result);
+    return Result;
+}
+
+static float ReadComponent(const uint8* Data, uint32 ComponentType, bool Normalized)
+{
+    switch (ComponentType)
+    {
+    case GLTF_BYTE:
+    {
+        const int8 Value = int8(*Data);
+        return Normalized ? std::max(float(Value) / 127.0f, -1.0f) : float(Value);
+    }
+    case GLTF_UNSIGNED_BYTE:
+    {
+        return Normalized ? float(*Data) / 255.0f : float(*Data);
+    }
+    case GLTF_SHORT:
+    {
+        int16 Value;
+        memcpy(&Value, Data, sizeof(Value));
+        return Normalized ? std::max(float(Value) / 32767.0f, -1.0f) : float(Value);
+    }
+    case GLTF_UNSIGNED_SHORT:
+    {
+        uint16 Value;
+        memcpy(&Value, Data, sizeof(Value));
+        return Normalized ? float(Value) / 65535.0f : float(Value);
+    }
+    case GLTF_UNSIGNED_INT:
+    {
+        return float(ReadUint32(Data));
+    }
+    default:
+    {
+        float Value;
+        memcpy(&Value, Data, sizeof(Value));
+        return Value;
+    }
+    }
+}
+
+bool GltfFile::Open(const std::string& InFilename)
+{
+    Close();
+
+    if (!File.Open(InFilename))
+    {
+        LOG_ERROR("[GltfFile]: Failed to open '" + InFilename + "'");
+        return false;
+    }
+
+    Filename = InFilename;
+
+    const size_t Slash = Filename.find_last_of("/\\");
+    Directory = (Slash != std::string::npos) ? Filename.substr(0, Slash) : std::string(".");
+
+    const uint8* Data = reinterpret_cast<const uint8*>(File.GetData());
+    const uint64 Size = File.GetSize();
+    if (Size >= 12 && ReadUint32(Data) == GLTF_GLB_MAGIC)
+    {
+        // The header is the magic, the version and the total length, followed by chunks that start with their length
+        // and type. The JSON chunk comes first and the optional BIN chunk second, unknown chunks are skipped.
+        const uint32 Version = ReadUint32(Data + 4);
+        const uint64 Length  = ReadUint32(Data + 8);
+        if (Version != 2 || Length > Size)
+        {
+            LOG_ERROR("[GltfFile]: '" + Filename + "' is not a valid glTF 2.0 binary file");
+            Close();
+            return false;
+        }
+
+        for (uint64 Offset = 12; Offset + 8 <= Length;)
+        {
+            const uint64 ChunkLength = ReadUint32(Data + Offset);
+            const uint32 ChunkType   = ReadUint32(Data + Offset + 4);
+            if (ChunkLength > Length - Offset - 8)
+            {
+                break;
+            }
+
+            const uint8* ChunkData = Data + Offset + 8;
+            if (ChunkType == GLTF_GLB_CHUNK_JSON && !JsonText)
+            {
+                JsonText = reinterpret_cast<const char*>(ChunkData);
+                JsonSize = ChunkLength;
+            }
+            else if (ChunkType == GLTF_GLB_CHUNK_BIN && !BinaryChunk)
+            {
+                BinaryChunk     = ChunkData;
+                BinaryChunkSize = ChunkLength;
+            }
+
+            Offset += 8 + ChunkLength;
+        }
+    }
+    else
+    {
+        JsonText = reinterpret_cast<const char*>(Data);
+        JsonSize = Size;
+
+        // Skip the byte order mark that some exporters write
+        if (JsonSize >= 3 && memcmp(JsonText, "\xEF\xBB\xBF", 3) == 0)
+        {
+            JsonText += 3;
+            JsonSize -= 3;
+        }
+    }
+
+    if (!JsonText || !Document.Parse(JsonText, JsonSize) || Document.GetRoot().Type != EJsonType::Object)
+    {
+        LOG_ERROR("[GltfFile]: Failed to parse the JSON of '" + Filename + "'");
+        Close();
+        return false;
+    }
+
+    const JsonValue* Asset = Document.FindObject(Document.GetRoot(), "asset");
+    if (!Asset || Document.GetString(*Asset, "version", "").compare(0, 2, "2.") != 0)
+    {
+        LOG_ERROR("[GltfFile]: '" + Filename + "' is not a glTF 2.0 file");
+        Close();
+        return false;
+    }
+
+    if (!OpenBuffers())
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void GltfFile::Close()
+{
+    Buffers.Clear();
+    Document = JsonDocument();
+
+    JsonText        = nullptr;
+    JsonSize        = 0;
+    BinaryChunk     = nullptr;
+    BinaryChunkSize = 0;
+
+    File.Close();
+    Filename.clear();
+    Directory.clear();
+}
+
+bool GltfFile::OpenBuffers()
+{
+    const JsonValue* BufferArray = Document.FindArray(Document.GetRoot(), "buffers");
+    if (!BufferArray)
+    {
+        return true;
+    }
+
+    for (uint32 Index = 0; Index < BufferArray->NumChildren; Index++)
+    {
+        const JsonValue& BufferObject = Document.GetChild(*BufferArray, Index);
+        const int64 ByteLength = Document.GetInteger(BufferObject, "byteLength", -1);
+
+        TUniquePtr<Buffer> NewBuffer = MakeUnique<Buffer>();
+
+        const std::string Uri = Document.GetString(BufferObject, "uri", "");
+        std::string MimeType;
+        if (Uri.empty())
+        {
+            // Only the first buffer of a .glb file can refer to the BIN chunk
+            if (Index == 0 && BinaryChunk)
+            {
+                NewBuffer->Data = BinaryChunk;
+                NewBuffer->Size = BinaryChunkSize;
+            }
+        }
+        else if (DecodeDataUri(Uri, NewBuffer->Decoded, MimeType))
+        {
+            NewBuffer->Data = NewBuffer->Decoded.Data();
+            NewBuffer->Size = NewBuffer->Decoded.Size();
+        }
+        else
+        {
+            const std::string BufferFilename = Directory + '/' + DecodeRelativeUri(Uri);
+            if (NewBuffer->File.Open(BufferFilename))
+            {
+                NewBuffer->Data = reinterpret_cast<const uint8*>(NewBuffer->File.GetData());
+                NewBuffer->Size = NewBuffer->File.GetSize();
+            }
+        }
+
+        // The BIN chunk can be padded, so a buffer can be smaller than its data but never larger
+        if (!NewBuffer->Data || ByteLength < 0 || uint64(ByteLength) > NewBuffer->Size)
+        {
+            LOG_ERROR("[GltfFile]: Failed to read buffer " + std::to_string(Index) + " of '" + Filename + "'");
+            return false;
+        }
+
+        NewBuffer->Size = uint64(ByteLength);
+        Buffers.EmplaceBack(Move(NewBuffer));
+    }
+
+    return true;
+}
+
+const JsonValue* GltfFile::GetElement(const char* Array, uint32 Index) const
+{
+    const JsonValue* Elements = Document.FindArray(Document.GetRoot(), Array);
+    if (!Elements || Index >= Elements->NumChildren)
+    {
+        return nullptr;
+    }
+
+    const JsonValue& Element = Document.GetChild(*Elements, Index);
+    return (Element.Type == EJsonType::Object) ? &Element : nullptr;
+}
+
+bool GltfFile::GetBufferView(uint32 Index, const uint8*& OutData, uint64& OutSize, uint32& OutStride) const
+{
+    const JsonValue* View = GetElement("bufferViews", Index);
+    if (!View)
+    {
+        return false;
+    }
+
+    const int64 BufferIndex = Document.GetInteger(*View, "buffer", -1);
+    const int64 ByteOffset  = Document.GetInteger(*View, "byteOffset", 0);
+    const int64 ByteLength  = Document.GetInteger(*View, "byteLength", -1);
+    const int64 ByteStride  = Document.GetInteger(*View, "byteStride", 0);
+    if (BufferIndex < 0 || BufferIndex >= int64(Buffers.Size()) || ByteOffset < 0 || ByteLength < 0 || ByteStride < 0 || ByteStride > 252)
+    {
+        return false;
+    }
+
+    const Buffer& ViewBuffer = *Buffers[uint32(BufferIndex)];
+    if (uint64(ByteOffset) + uint64(ByteLength) > ViewBuffer.Size)
+    {
+        return false;
+    }
+
+    OutData   = ViewBuffer.Data + ByteOffset;
+    OutSize   = uint64(ByteLength);
+    OutStride = uint32(ByteStride);
+    return true;
+}
+
+bool GltfFile::GetAccessor(uint32 Index, AccessorView& OutView) const
+{
+    const JsonValue* Accessor = GetElement("accessors", Index);
+    if (!Accessor)
+    {
+        return false;
+    }
+
+    if (Document.Find(*Accessor, "sparse"))
+    {
+        LOG_WARNING("[GltfFile]: Sparse accessors are not supported");
+        return false;
+    }
+
+    const int64 Count = Document.GetInteger(*Accessor, "count", -1);
+    if (Count < 0 || Count > int64(uint32(~0)))
+    {
+        return false;
+    }
+
+    OutView.Data          = nullptr;
+    OutView.Count         = uint32(Count);
+    OutView.ComponentType = uint32(Document.GetInteger(*Accessor, "componentType", 0));
+    OutView.NumComponents = GetNumComponents(Document.GetString(*Accessor, "type", ""));
+    OutView.Normalized    = Document.GetBool(*Accessor, "normalized", false);
+
+    const uint32 ElementSize = GetComponentSize(OutView.ComponentType) * OutView.NumComponents;
+    if (ElementSize == 0)
+    {
+        return false;
+    }
+
+    OutView.Stride = ElementSize;
+
+    const int64 BufferView = Document.GetInteger(*Accessor, "bufferView", -1);
+    if (BufferView < 0)
+    {
+        return true;
+    }
+
+    const uint8* ViewData   = nullptr;
+    uint64       ViewSize   = 0;
+    uint32       ViewStride = 0;
+    if (!GetBufferView(uint32(BufferView), ViewData, ViewSize, ViewStride))
+    {
+        return false;
+    }
+
+    const int64 ByteOffset = Document.GetInteger(*Accessor, "byteOffset", 0);
+    if (ByteOffset < 0 || (ViewStride != 0 && ViewStride < ElementSize))
+    {
+        return false;
+    }
+
+    if (ViewStride != 0)
+    {
+        OutView.Stride = ViewStride;
+    }
+
+    // The last element only has to fit without the padding of the stride
+    if (OutView.Count > 0 && uint64(ByteOffset) + uint64(OutView.Count - 1) * OutView.Stride + ElementSize > ViewSize)
+    {
+        return false;
+    }
+
+    OutView.Data = ViewData + ByteOffset;
+    return true;
+}
+
+bool GltfFile::ReadFloats(uint32 Accessor, uint32 NumComponents, uint32 Count, float* Output, uint32 OutputStride) const
+{
+    AccessorView View;
+    if (!GetAccessor(Accessor, View) || View.NumComponents != NumComponents || View.Count != Count)
+    {
+        return false;
+    }
+
+    const uint32 ComponentSize = GetComponentSize(View.ComponentType);
+
+    uint8* OutputBytes = reinterpret_cast<uint8*>(Output);
+    for (uint32 Element = 0; Element < Count; Element++)
+    {
+        float* OutputElement = reinterpret_cast<float*>(OutputBytes + uint64(Element) * OutputStride);
+        if (!View.Data)
+        {
+            for (uint32 Component = 0; Component < NumComponents; Component++)
+            {
+                OutputElement[Component] = 0.0f;
+            }
+
+            continue;
+        }
+
+        const uint8* ElementData = View.Data + uint64(Element) * View.Stride;
+        for (uint32 Component = 0; Component < NumComponents; Component++)
+        {
+            OutputElement[Component] = ReadComponent(ElementData + Component * ComponentSize, View.ComponentType, View.Normalized);
+        }
+    }
+
+    return true;
+}
+
+bool GltfFile::ReadIndices(uint32 Accessor, uint32 NumVertices, TArray<uint32>& OutIndices) const
+{
+    AccessorView View;
+    if (!GetAccessor(Accessor, View) || View.NumComponents != 1 || !View.Data)
+    {
+        return false;
+    }
+
+    const uint32 ComponentType = View.ComponentType;
+    if (ComponentType != GLTF_UNSIGNED_BYTE && ComponentType != GLTF_UNSIGNED_SHORT && ComponentType != GLTF_UNSIGNED_INT)
+    {
+        return false;
+    }
+
+    OutIndices.Resize(View.Count);
+    for (uint32 Element = 0; Element < View.Count; Element++)
+    {
+        const uint8* ElementData = View.Data + uint64(Element) * View.Stride;
+
+        uint32 Index = 0;
+        if (ComponentType == GLTF_UNSIGNED_BYTE)
+        {
+            Index = *ElementData;
+        }
+        else if (ComponentType == GLTF_UNSIGNED_SHORT)
+        {
+            uint16 Value;
+            memcpy(&Value, ElementData, sizeof(Value));
+            Index = Value;
+        }
+        else
+        {
+            Index = ReadUint32(ElementData);
+        }
+
+        if (Index >= NumVertices)
+        {
+            return false;
+        }
+
+        OutIndices[Element] = Index;
+    }
+
+    return true;
+}
+
+void GltfFile::GetPrimitiveInstances(TArray<GltfPrimitiveInstance>& OutInstances) const
+{
+    const JsonValue& Root = Document.GetRoot();
+    const JsonValue* Nodes = Document.FindArray(Root, "nodes");
+    if (!Nodes)
+    {
+        return;
+    }
+
+    const JsonValue* Materials    = Document.FindArray(Root, "materials");
+    const int64      NumMaterials = Materials ? int64(Materials->NumChildren) : 0;
+
+    // Without a scene, every node that is not the child of another node is a root
+    TArray<uint32> RootNodes;
+    const JsonValue* Scene = GetElement("scenes", uint32(Document.GetInteger(Root, "scene", 0)));
+    const JsonValue* SceneNodes = Scene ? Document.FindArray(*Scene, "nodes") : nullptr;
+    if (SceneNodes)
+    {
+        for (uint32 Index = 0; Index < SceneNodes->NumChildren; Index++)
+        {
+            const JsonValue& Node = Document.GetChild(*SceneNodes, Index);
+            if (Node.Type == EJsonType::Number && Node.Number >= 0.0 && Node.Number < double(Nodes->NumChildren))
+            {
+                RootNodes.EmplaceBack(uint32(Node.Number));
+            }
+        }
+    }
+    else
+    {
+        TArray<bool> IsChild(Nodes->NumChildren, false);
+        for (uint32 Index = 0; Index < Nodes->NumChildren; Index++)
+        {
+            const JsonValue* Children = Document.FindArray(Document.GetChild(*Nodes, Index), "children");
+            for (uint32 Child = 0; Children && Child < Children->NumChildren; Child++)
+            {
+                const JsonValue& ChildIndex = Document.GetChild(*Children, Child);
+                if (ChildIndex.Type == EJsonType::Number && ChildIndex.Number >= 0.0 && ChildIndex.Number < double(Nodes->NumChildren))
+                {
+                    IsChild[uint32(ChildIndex.Number)] = true;
+                }
+            }
+        }
+
+        for (uint32 Index = 0; Index < Nodes->NumChildren; Index++)
+        {
+            if (!IsChild[Index])
+            {
+                RootNodes.EmplaceBack(Index);
+            }
+        }
+    }
+
+    // Depth first in the order of the file. A node can only have one parent, so a node that is reached twice means
+    // that the file is damaged, and it is skipped to avoid cycles.
+    struct PendingNode
+    {
+        uint32     Node;
+        XMFLOAT4X4 ParentTransform;
+    };
+
+    XMFLOAT4X4 Identity;
+    XMStoreFloat4x4(&Identity, XMMatrixIdentity());
+
+    TArray<PendingNode> Stack;
+    for (uint32 Index = RootNodes.Size(); Index > 0; Index--)
+    {
+        Stack.PushBack({ RootNodes[Index - 1], Identity });
+    }
+
+    TArray<bool> IsVisited(Nodes->NumChildren, false);
+    while (!Stack.IsEmpty())
+    {
+        const PendingNode Current = Stack.Back();
+        Stack.PopBack();
+
+        if (IsVisited[Current.Node])
+        {
+            LOG_WARNING("[GltfFile]: Node " + std::to_string(Current.Node) + " has more than one parent");
+            continue;
+        }
+
+        IsVisited[Current.Node] = true;
+
+        const JsonValue& Node = Document.GetChild(*Nodes, Current.Node);
+        if (Node.Type != EJsonType::Object)
+        {
+            continue;
+        }
+
+        // The matrix is stored column by column, which is the row by row layout of the matrix for row vectors
+        XMMATRIX XmLocal;
+        XMFLOAT4X4 Matrix;
+        if (Document.GetNumbers(Node, "matrix", &Matrix.m[0][0], 16))
+        {
+            XmLocal = XMLoadFloat4x4(&Matrix);
+        }
+        else
+        {
+            XMFLOAT3 Translation = XMFLOAT3(0.0f, 0.0f, 0.0f);
+            XMFLOAT4 Rotation    = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+            XMFLOAT3 Scale       = XMFLOAT3(1.0f, 1.0f, 1.0f);
+            Document.GetNumbers(Node, "translation", &Translation.x, 3);
+            Document.GetNumbers(Node, "rotation", &Rotation.x, 4);
+            Document.GetNumbers(Node, "scale", &Scale.x, 3);
+
+            XMVECTOR XmRotation = XMQuaternionNormalize(XMLoadFloat4(&Rotation));
+            XmLocal = XMMatrixScaling(Scale.x, Scale.y, Scale.z) * XMMatrixRotationQuaternion(XmRotation) * XMMatrixTranslation(Translation.x, Translation.y, Translation.z);
+        }
+
+        XMFLOAT4X4 World;
+        XMStoreFloat4x4(&World, XMMatrixMultiply(XmLocal, XMLoadFloat4x4(&Current.ParentTransform)));
+
+        const int64 MeshIndex = Document.GetInteger(Node, "mesh", -1);
+        const JsonValue* Mesh = (MeshIndex >= 0) ? GetElement("meshes", uint32(MeshIndex)) : nullptr;
+        const JsonValue* Primitives = Mesh ? Document.FindArray(*Mesh, "primitives") : nullptr;
+        if (Primitives)
+        {
+            std::string Name = Document.GetString(Node, "name", "");
+            if (Name.empty())
+            {
+                Name = Document.GetString(*Mesh, "name", "Node " + std::to_string(Current.Node));
+            }
+
+            for (uint32 Primitive = 0; Primitive < Primitives->NumChildren; Primitive++)
+            {
+                const JsonValue& PrimitiveObject = Document.GetChild(*Primitives, Primitive);
+                if (Document.GetInteger(PrimitiveObject, "mode", GLTF_TRIANGLES) != GLTF_TRIANGLES)
+                {
+                    LOG_WARNING("[GltfFile]: Skipped primitive " + std::to_string(Primitive) + " of '" + Name + "', only triangle lists are supported");
+                    continue;
+                }
+
+                const int64 Material = Document.GetInteger(PrimitiveObject, "material", -1);
+
+                GltfPrimitiveInstance& Instance = OutInstances.EmplaceBack();
+                Instance.Name       = Name;
+                Instance.Mesh       = uint32(MeshIndex);
+                Instance.Primitive  = Primitive;
+                Instance.MaterialID = (Material >= 0 && Material < NumMaterials) ? int32(Material) : -1;
+                Instance.Transform  = World;
+            }
+        }
+
+        // Pushed in reverse, so that the first child is visited first
+        const JsonValue* Children = Document.FindArray(Node, "children");
+        for (uint32 Child = Children ? Children->NumChildren : 0; Child > 0; Child--)
+        {
+            const JsonValue& ChildIndex = Document.GetChild(*Children, Child - 1);
+            if (ChildIndex.Type == EJsonType::Number && ChildIndex.Number >= 0.0 && ChildIndex.Number < double(Nodes->NumChildren))
+            {
+                Stack.PushBack({ uint32(ChildIndex.Number), World });
+            }
+        }
+    }
+}
+
+void GltfFile::GetMaterials(TArray<GltfMaterial>& OutMaterials) const
+{
+    const JsonValue* Materials = Document.FindArray(Document.GetRoot(), "materials");
+    if (!Materials)
+    {
+        return;
+    }
+
+    // A texture info refers to a texture, which refers to the image
+    auto GetImage = [this](const JsonValue& Object, const char* Key) -> int32
+    {
+        const JsonValue* TextureInfo = Document.FindObject(Object, Key);
+        if (!TextureInfo)
+        {
+            return -1;
+        }
+
+        const JsonValue* Texture = GetElement("textures", uint32(Document.GetInteger(*TextureInfo, "index", -1)));
+        if (!Texture)
+        {
+            return -1;
+        }
+
+        const int64 Image = Document.GetInteger(*Texture, "source", -1);
+        return (Image >= 0 && GetElement("images", uint32(Image))) ? int32(Image) : -1;
+    };
+
+    for (uint32 Index = 0; Index < Materials->NumChildren; Index++)
+    {
+        GltfMaterial& NewMaterial = OutMaterials.EmplaceBack();
+
+        const JsonValue& Material = Document.GetChild(*Materials, Index);
+        if (Material.Type != EJsonType::Object)
+        {
+            continue;
+        }
+
+        NewMaterial.Name = Document.GetString(Material, "name", "");
+
+        const JsonValue* PBR = Document.FindObject(Material, "pbrMetallicRoughness");
+        if (PBR)
+        {
+            Document.GetNumbers(*PBR, "baseColorFactor", &NewMaterial.BaseColorFactor.x, 4);
+            NewMaterial.MetallicFactor  = float(Document.GetNumber(*PBR, "metallicFactor", 1.0));
+            NewMaterial.RoughnessFactor = float(Document.GetNumber(*PBR, "roughnessFactor", 1.0));
+
+            NewMaterial.BaseColorImage         = GetImage(*PBR, "baseColorTexture");
+            NewMaterial.MetallicRoughnessImage = GetImage(*PBR, "metallicRoughnessTexture");
+        }
+
+        NewMaterial.NormalImage    = GetImage(Material, "normalTexture");
+        NewMaterial.OcclusionImage = GetImage(Material, "occlusionTexture");
+
+        const std::string AlphaMode = Document.GetString(Material, "alphaMode", "OPAQUE");
+        if (AlphaMode == "MASK")
+        {
+            NewMaterial.AlphaMode = EGltfAlphaMode::Mask;
+        }
+        else if (AlphaMode == "BLEND")
+        {
+            NewMaterial.AlphaMode = EGltfAlphaMode::Blend;
+        }
+    }
+}
+
+void GltfFile::ExportImages(TArray<std::string>& OutFilenames) const
+{
+    const JsonValue* Images = Document.FindArray(Document.GetRoot(), "images");
+    if (!Images)
+    {
+        return;
+    }
+
+    const size_t Slash = Filename.find_last_of("/\\");
+    const std::string BaseName = (Slash != std::string::npos) ? Filename.substr(Slash + 1) : Filename;
+
+    OutFilenames.Resize(Images->NumChildren);
+    for (uint32 Index = 0; Index < Images->NumChildren; Index++)
+    {
+        const JsonValue& Image = Document.GetChild(*Images, Index);
+        if (Image.Type != EJsonType::Object)
+        {
+            continue;
+        }
+
+        std::string   MimeType = Document.GetString(Image, "mimeType", "");
+        TArray<uint8> Decoded;
+        const uint8*  Data = nullptr;
+        uint64        Size = 0;
+
+        const std::string Uri = Document.GetString(Image, "uri", "");
+        if (!Uri.empty())
+        {
+            if (!DecodeDataUri(Uri, Decoded, MimeType))
+            {
+                OutFilenames[Index] = DecodeRelativeUri(Uri);
+                continue;
+            }
+
+            Data = Decoded.Data();
+            Size = Decoded.Size();
+        }
+        else
+        {
+            uint32 Stride = 0;
+            if (!GetBufferView(uint32(Document.GetInteger(Image, "bufferView", -1)), Data, Size, Stride))
+            {
+                LOG_WARNING("[GltfFile]: Image " + std::to_string(Index) + " of '" + Filename + "' does not have any data");
+                continue;
+            }
+        }
+
+        // stb_image finds the format from the data, the extension is only there to make the files easy to recognize
+        std::string Extension = ".img";
+        if (MimeType == "image/png")
+        {
+            Extension = ".png";
+        }
+        else if (MimeType == "image/jpeg")
+        {
+            Extension = ".jpg";
+        }
+
+        const std::string ImageName = BaseName + ".image" + std::to_string(Index) + Extension;
+        const std::string ImagePath = Directory + '/' + ImageName;
+
+        FILE* ImageFile = fopen(ImagePath.c_str(), "wb");
+        if (!ImageFile)
+        {
+            LOG_WARNING("[GltfFile]: Failed to write '" + ImagePath + "'");
+            continue;
+        }
+
+        const bool Result = (fwrite(Data, 1, size_t(Size), ImageFile) == size_t(Size));
+        if ((fclose(ImageFile) == 0) && Result)
+        {
+            OutFilenames[Index] = ImageName;
+        }
+        else
+        {
+            LOG_WARNING("[GltfFile]: Failed to write '" + ImagePath + "'");
+        }
+    }
+}
+
+bool GltfFile::ReadPrimitive(const GltfPrimitiveInstance& Instance, bool LeftHanded, MeshData& OutData) const
+{
+    OutData.Vertices.Clear();
+    OutData.Indices.Clear();
+
+    const JsonValue* Mesh       = GetElement("meshes", Instance.Mesh);
+    const JsonValue* Primitives = Mesh ? Document.FindArray(*Mesh, "primitives") : nullptr;
+    if (!Primitives || Instance.Primitive >= Primitives->NumChildren)
+    {
+        return false;
+    }
+
+    const JsonValue& Primitive  = Document.GetChild(*Primitives, Instance.Primitive);
+    const JsonValue* Attributes = Document.FindObject(Primitive, "attributes");
+    if (!Attributes)
+    {
+        return false;
+    }
+
+    AccessorView Positions;
+    const int64 PositionAccessor = Document.GetInteger(*Attributes, "POSITION", -1);
+    if (PositionAccessor < 0 || !GetAccessor(uint32(PositionAccessor), Positions))
+    {
+        LOG_ERROR("[GltfFile]: Primitive of '" + Instance.Name + "' does not have valid positions");
+        return false;
+    }
+
+    // The attributes are converted straight into the vertices, the ones that the primitive does not have stay zero
+    const uint32 NumVertices = Positions.Count;
+    const Vertex ZeroVertex  = { };
+    OutData.Vertices.Resize(NumVertices, ZeroVertex);
+
+    Vertex* Vertices = OutData.Vertices.Data();
+    if (!ReadFloats(uint32(PositionAccessor), 3, NumVertices, &Vertices->Position.x, sizeof(Vertex)))
+    {
+        LOG_ERROR("[GltfFile]: Primitive of '" + Instance.Name + "' does not have valid positions");
+        return false;
+    }
+
+    const int64 NormalAccessor = Document.GetInteger(*Attributes, "NORMAL", -1);
+    const bool  HasNormals     = (NormalAccessor >= 0);
+    if (HasNormals && !ReadFloats(uint32(NormalAccessor), 3, NumVertices, &Vertices->Normal.x, sizeof(Vertex)))
+    {
+        LOG_ERROR("[GltfFile]: Primitive of '" + Instance.Name + "' does not have valid normals");
+        return false;
+    }
+
+    const int64 TexCoordAccessor = Document.GetInteger(*Attributes, "TEXCOORD_0", -1);
+    if (TexCoordAccessor >= 0 && !ReadFloats(uint32(TexCoordAccessor), 2, NumVertices, &Vertices->TexCoord.x, sizeof(Vertex)))
+    {
+        LOG_ERROR("[GltfFile]: Primitive of '" + Instance.Name + "' does not have valid texcoords");
+        return false;
+    }
+
+    const int64 IndexAccessor = Document.GetInteger(Primitive, "indices", -1);
+    if (IndexAccessor >= 0)
+    {
+        if (!ReadIndices(uint32(IndexAccessor), NumVertices, OutData.Indices))
+        {
+            LOG_ERROR("[GltfFile]: Primitive of '" + Instance.Name + "' does not have valid indices");
+            return false;
+        }
+    }
+    else
+    {
+        OutData.Indices.Resize(NumVertices);
+        for (uint32 Index = 0; Index < NumVertices; Index++)
+        {
+            OutData.Indices[Index] = Index;
+        }
+    }
+
+    // Incomplete triangles at the end are dropped
+    OutData.Indices.Resize(OutData.Indices.Size() - (OutData.Indices.Size() % 3));
+
+    // Normals are transformed by the inverse transpose, so that they stay perpendicular under non-uniform scale
+    XMMATRIX XmTransform = XMLoadFloat4x4(&Instance.Transform);
+    if (!XMMatrixIsIdentity(XmTransform))
+    {
+        XMMATRIX XmNormalTransform = XMMatrixTranspose(XMMatrixInverse(nullptr, XmTransform));
+        for (Vertex& CurrentVertex : OutData.Vertices)
+        {
+            XMStoreFloat3(&CurrentVertex.Position, XMVector3TransformCoord(XMLoadFloat3(&CurrentVertex.Position), XmTransform));
+            if (HasNormals)
+            {
+                XMVECTOR XmNormal = XMVector3TransformNormal(XMLoadFloat3(&CurrentVertex.Normal), XmNormalTransform);
+                XMStoreFloat3(&CurrentVertex.Normal, XMVector3Normalize(XmNormal));
+            }
+        }
+    }
+
+    if (LeftHanded)
+    {
+        for (Vertex& CurrentVertex : OutData.Vertices)
+        {
+            CurrentVertex.Position.z = -CurrentVertex.Position.z;
+            CurrentVertex.Normal.z   = -CurrentVertex.Normal.z;
+        }
+    }
+
+    // A mirroring transform and the conversion to left handed coordinates both turn the triangles inside out, so the
+    // winding is flipped when exactly one of them is applied
+    const bool IsMirrored = XMVectorGetX(XMMatrixDeterminant(XmTransform)) < 0.0f;
+    if (IsMirrored != LeftHanded)
+    {
+        for (uint32 Index = 0; Index < OutData.Indices.Size(); Index += 3)
+        {
+            std::swap(OutData.Indices[Index + 1], OutData.Indices[Index + 2]);
+        }
+    }
+
+    if (!HasNormals)
+    {
+        MeshFactory::CalculateHardNormals(OutData);
+    }
+
+    return true;
+}
+
+void GltfFile::HashContents(StreamHasher& Hasher) const
+{
+    Hasher.Update(JsonText, size_t(JsonSize));
+    for (const TUniquePtr<Buffer>& CurrentBuffer : Buffers)
+    {
+        Hasher.Update(CurrentBuffer->Data, size_t(CurrentBuffer->Size));
+    }
+}
+
+bool GltfFile::IsGltfFilename(const std::string& Filename)
+{
+    const size_t Dot = Filename.find_last_of('.');
+    if (Dot == std::string::npos)
+    {
+        return false;
+    }
+
+    std::string Extension = Filename.substr(Dot);
+    for (char& Character : Extension)
+    {
+        Character = char(tolower(uint8(Character)));
+    }
+
+    return Extension == ".gltf" || Extension == ".glb";
+}
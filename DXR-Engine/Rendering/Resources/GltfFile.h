@@ -0,0 +1,151 @@
+#pragma once
+#include "MeshFactory.h"
+
+#include "Core/IO/JsonDocument.h"
+#include "Core/IO/Platform/MappedFile.h"
+
+#include "Core/Containers/Array.h"
+#include "Core/Containers/UniquePtr.h"
+
+constexpr uint32 GLTF_GLB_MAGIC      = 0x46546C67; // "glTF"
+constexpr uint32 GLTF_GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+constexpr uint32 GLTF_GLB_CHUNK_BIN  = 0x004E4942; // "BIN\0"
+
+enum class EGltfAlphaMode : uint32
+{
+    Opaque = 0,
+    Mask   = 1,
+    Blend  = 2,
+};
+
+// Metallic-roughness material, the texture indices are indices into the images and -1 when the texture is not used
+struct GltfMaterial
+{
+    std::string Name;
+
+    XMFLOAT4 BaseColorFactor = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+    float    MetallicFactor  = 1.0f;
+    float    RoughnessFactor = 1.0f;
+
+    EGltfAlphaMode AlphaMode = EGltfAlphaMode::Opaque;
+
+    // Base color in RGB and alpha in A
+    int32 BaseColorImage = -1;
+
+    // Roughness in G and metallic in B
+    int32 MetallicRoughnessImage = -1;
+
+    int32 NormalImage    = -1;
+    int32 OcclusionImage = -1;
+};
+
+// A primitive that a node draws, a mesh that is used by several nodes has an instance for each of them
+struct GltfPrimitiveInstance
+{
+    std::string Name;
+
+    uint32 Mesh      = 0;
+    uint32 Primitive = 0;
+
+    // -1 when the primitive uses the default material
+    int32 MaterialID = -1;
+
+    // World matrix of the node, for row vectors
+    XMFLOAT4X4 Transform;
+};
+
+/*
+* Reader for glTF 2.0 files, both .gltf with external or embedded buffers and binary .glb. The JSON is parsed without
+* copying, and buffers in files are mapped into memory, so the accessors are read straight from the mapping into the
+* vertices without intermediate copies. After Open the file is only read, so ReadPrimitive can be called from several
+* threads at the same time.
+*/
+
+class GltfFile
+{
+public:
+    GltfFile()  = default;
+    ~GltfFile() = default;
+
+    // Returns false if the file is not a valid glTF 2.0 file or one of its buffers could not be read
+    bool Open(const std::string& InFilename);
+    void Close();
+
+    // The triangle list primitives of the nodes in the default scene, with the transforms of the hierarchy applied.
+    // Primitives with another topology are skipped.
+    void GetPrimitiveInstances(TArray<GltfPrimitiveInstance>& OutInstances) const;
+
+    void GetMaterials(TArray<GltfMaterial>& OutMaterials) const;
+
+    // Names of the images relative to the directory of the file, in the same order as the images. Images that are stored
+    // in a buffer or a data URI are written to a file next to the glTF file, so that they can be loaded like any other
+    // image. The name is empty when an image could not be written.
+    void ExportImages(TArray<std::string>& OutFilenames) const;
+
+    // Reads the triangles with the transform of the instance applied to the vertices, and converts them from the right
+    // handed coordinates of glTF to left handed coordinates when LeftHanded is set. Normals are calculated when the
+    // primitive does not have any, the tangents are not read. Returns false if an accessor is invalid.
+    bool ReadPrimitive(const GltfPrimitiveInstance& Instance, bool LeftHanded, MeshData& OutData) const;
+
+    // Adds the JSON and all buffers to the hash
+    void HashContents(StreamHasher& Hasher) const;
+
+    const std::string& GetFilename() const { return Filename; }
+
+    // True when the extension is .gltf or .glb
+    static bool IsGltfFilename(const std::string& Filename);
+
+private:
+    struct Buffer
+    {
+        MappedFile    File;
+        TArray<uint8> Decoded;
+
+        const uint8* Data = nullptr;
+        uint64       Size = 0;
+    };
+
+    // Location of the elements of an accessor, Data is nullptr when the accessor has no buffer view and is all zeros
+    struct AccessorView
+    {
+        const uint8* Data = nullptr;
+
+        uint32 Count         = 0;
+        uint32 Stride        = 0;
+        uint32 ComponentType = 0;
+        uint32 NumComponents = 0;
+        bool   Normalized    = false;
+    };
+
+    bool OpenBuffers();
+
+    // Returns false if the buffer view is out of the bounds of its buffer
+    bool GetBufferView(uint32 Index, const uint8*& OutData, uint64& OutSize, uint32& OutStride) const;
+    bool GetAccessor(uint32 Index, AccessorView& OutView) const;
+
+    // Converts the elements to floats, where normalized integers are mapped to [0, 1] or [-1, 1]. Returns false if the
+    // accessor does not have NumComponents components or Count elements.
+    bool ReadFloats(uint32 Accessor, uint32 NumComponents, uint32 Count, float* Output, uint32 OutputStride) const;
+    bool ReadIndices(uint32 Accessor, uint32 NumVertices, TArray<uint32>& OutIndices) const;
+
+    // Returns nullptr if the JSON does not have the element or the element is not an object
+    const JsonValue* GetElement(const char* Array, uint32 Index) const;
+
+    std::string Filename;
+    std::string Directory;
+
+    MappedFile File;
+
+    // The JSON chunk of a .glb file or the whole .gltf file
+    const char* JsonText = nullptr;
+    uint64      JsonSize = 0;
+
+    // The BIN chunk of a .glb file
+    const uint8* BinaryChunk     = nullptr;
+    uint64       BinaryChunkSize = 0;
+
+    JsonDocument Document;
+
+    // Heap allocated since the mappings can not be moved when the array grows
+    TArray<TUniquePtr<Buffer>> Buffers;
+};
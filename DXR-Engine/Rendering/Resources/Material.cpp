@@ -41,9 +41,9 @@ void Material::Init()
 
 void Material::BuildBuffer(CommandList& CmdList)
 {
-    CmdList.TransitionBuffer(MaterialBuffer.Get(), EResourceState::VertexAndConstantBuffer, EResourceState::CopyDest);
+    CmdList.TransitionBuffer(MaterialBuffer.Get(), EResourceState::CopyDest);
     CmdList.UpdateBuffer(MaterialBuffer.Get(), 0, sizeof(MaterialProperties), &Properties);
-    CmdList.TransitionBuffer(MaterialBuffer.Get(), EResourceState::CopyDest, EResourceState::VertexAndConstantBuffer);
+    CmdList.TransitionBuffer(MaterialBuffer.Get(), EResourceState::VertexAndConstantBuffer);
 
     MaterialBufferIsDirty = false;
 }
@@ -95,15 +95,13 @@ void Material::SetDebugName(const std::string& InDebugName)
     DebugName = InDebugName;
 }
 
-ShaderResourceView* const* Material::GetShaderResourceViews() const
+void Material::GetShaderResourceViews(MaterialShaderResourceViews& OutShaderResourceViews) const
 {
-    ShaderResourceViews[0] = GET_SAFE_SRV(AlbedoMap);
-    ShaderResourceViews[1] = GET_SAFE_SRV(NormalMap);
-    ShaderResourceViews[2] = GET_SAFE_SRV(RoughnessMap);
-    ShaderResourceViews[3] = GET_SAFE_SRV(HeightMap);
-    ShaderResourceViews[4] = GET_SAFE_SRV(MetallicMap);
-    ShaderResourceViews[5] = GET_SAFE_SRV(AOMap);
-    ShaderResourceViews[6] = GET_SAFE_SRV(AlphaMask);
-
-    return ShaderResourceViews.Data();
+    OutShaderResourceViews[0] = GET_SAFE_SRV(AlbedoMap);
+    OutShaderResourceViews[1] = GET_SAFE_SRV(NormalMap);
+    OutShaderResourceViews[2] = GET_SAFE_SRV(RoughnessMap);
+    OutShaderResourceViews[3] = GET_SAFE_SRV(HeightMap);
+    OutShaderResourceViews[4] = GET_SAFE_SRV(MetallicMap);
+    OutShaderResourceViews[5] = GET_SAFE_SRV(AOMap);
+    OutShaderResourceViews[6] = GET_SAFE_SRV(AlphaMask);
 }
@@ -12,6 +12,8 @@ struct MaterialProperties
     int32 EnableHeight = 0;
 };
 
+typedef TStaticArray<ShaderResourceView*, 7> MaterialShaderResourceViews;
+
 class Material
 {
 public:
@@ -39,8 +41,9 @@ public:
     void SetDebugName(const std::string& InDebugName);
 
     // ShaderResourceView are sorted in the way that the deferred rendering pass wants them
-    // This means that one can call BindShaderResourceViews directly with this function
-    ShaderResourceView* const* GetShaderResourceViews() const;
+    // This means that one can call BindShaderResourceViews directly with the result of this function. The views are
+    // written to the caller's array, so that CommandLists can be recorded for the same material on several threads.
+    void GetShaderResourceViews(MaterialShaderResourceViews& OutShaderResourceViews) const;
 
     SamplerState* GetMaterialSampler() const { return Sampler.Get(); }
     ConstantBuffer* GetMaterialBuffer() const { return MaterialBuffer.Get(); }
@@ -67,6 +70,4 @@ private:
     MaterialProperties         Properties;
     TRef<ConstantBuffer> MaterialBuffer;
     TRef<SamplerState>   Sampler;
-
-    mutable TStaticArray<ShaderResourceView*, 7> ShaderResourceViews;
 };
\ No newline at end of file
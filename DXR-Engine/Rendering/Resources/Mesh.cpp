@@ -3,15 +3,43 @@
 #include "RenderLayer/CommandList.h"
 #include "RenderLayer/RenderLayer.h"
 
-bool Mesh::Init(const MeshData& Data)
+bool Mesh::Init(const MeshDataView& Data)
 {
-    VertexCount = static_cast<uint32>(Data.Vertices.Size());
-    IndexCount  = static_cast<uint32>(Data.Indices.Size());
+    PackedMeshData PackedData;
+    MeshFactory::PackMesh(Data, PackedData);
+    return Init(PackedMeshDataView(PackedData));
+}
+
+bool Mesh::Init(const PackedMeshDataView& Data)
+{
+    VertexCount = Data.NumVertices;
+    IndexCount  = Data.NumIndices;
+
+    const bool RTOn              = IsRayTracingSupported();
+    const bool Use16BitIndices   = Data.Has16BitIndices();
+    const bool UsePackedVertices = MESH_PACKED_VERTICES;
 
-    const uint32 BufferFlags = IsRayTracingSupported() ? BufferFlag_SRV | BufferFlag_Default : BufferFlag_Default;
+    // The acceleration structure is built from the same buffers that are drawn, and the hit shaders decode them
+    const uint32 VertexBufferFlags = RTOn ? BufferFlag_SRV | BufferFlag_Default : BufferFlag_Default;
+    const uint32 IndexBufferFlags  = RTOn ? BufferFlag_SRV | BufferFlag_Default : BufferFlag_Default;
+
+    if (UsePackedVertices)
+    {
+        PositionOffset = Data.PositionOffset;
+        PositionScale  = Data.PositionScale;
+
+        ResourceData InitialData(Data.Vertices, VertexCount * sizeof(PackedVertex));
+        VertexBuffer = CreateVertexBuffer<PackedVertex>(VertexCount, VertexBufferFlags, EResourceState::VertexAndConstantBuffer, &InitialData);
+    }
+    else
+    {
+        TArray<Vertex> Vertices;
+        MeshFactory::UnpackVertices(Data.Vertices, VertexCount, Data.PositionOffset, Data.PositionScale, Vertices);
+
+        ResourceData InitialData(Vertices.Data(), Vertices.SizeInBytes());
+        VertexBuffer = CreateVertexBuffer<Vertex>(VertexCount, VertexBufferFlags, EResourceState::VertexAndConstantBuffer, &InitialData);
+    }
 
-    ResourceData InitialData(Data.Vertices.Data(), Data.Vertices.SizeInBytes());
-    VertexBuffer = CreateVertexBuffer<Vertex>(VertexCount, BufferFlags, EResourceState::VertexAndConstantBuffer, &InitialData);
     if (!VertexBuffer)
     {
         return false;
@@ -21,10 +49,17 @@ bool Mesh::Init(const MeshData& Data)
         VertexBuffer->SetName("VertexBuffer");
     }
 
-    const bool RTOn = IsRayTracingSupported();
-    
-    InitialData = ResourceData(Data.Indices.Data(), Data.Indices.SizeInBytes());
-    IndexBuffer = CreateIndexBuffer(EIndexFormat::uint32, IndexCount, BufferFlags, EResourceState::IndexBuffer, &InitialData);
+    if (Use16BitIndices)
+    {
+        ResourceData InitialData(Data.Indices, IndexCount * sizeof(uint16));
+        IndexBuffer = CreateIndexBuffer(EIndexFormat::uint16, IndexCount, IndexBufferFlags, EResourceState::IndexBuffer, &InitialData);
+    }
+    else
+    {
+        ResourceData InitialData(Data.Indices, IndexCount * sizeof(uint32));
+        IndexBuffer = CreateIndexBuffer(EIndexFormat::uint32, IndexCount, IndexBufferFlags, EResourceState::IndexBuffer, &InitialData);
+    }
+
     if (!IndexBuffer)
     {
         return false;
@@ -36,7 +71,9 @@ bool Mesh::Init(const MeshData& Data)
 
     if (RTOn)
     {
-        RTGeometry = CreateRayTracingGeometry(RayTracingStructureBuildFlag_None, VertexBuffer.Get(), IndexBuffer.Get());
+        // The packed positions are relative to the bounding box, GetRayTracingTransform moves the instances back
+        const EFormat PositionFormat = UsePackedVertices ? EFormat::R16G16B16A16_Snorm : EFormat::R32G32B32_Float;
+        RTGeometry = CreateRayTracingGeometry(RayTracingStructureBuildFlag_None, VertexBuffer.Get(), IndexBuffer.Get(), PositionFormat);
         if (!RTGeometry)
         {
             return false;
@@ -59,6 +96,8 @@ bool Mesh::Init(const MeshData& Data)
         }
     }
 
+    Meshlets = TArray<Meshlet>(Data.Meshlets, Data.Meshlets + Data.NumMeshlets);
+
     CreateBoundingBox(Data);
     return true;
 }
@@ -69,7 +108,20 @@ bool Mesh::BuildAccelerationStructure(CommandList& CmdList)
     return true;
 }
 
-TSharedPtr<Mesh> Mesh::Make(const MeshData& Data)
+TSharedPtr<Mesh> Mesh::Make(const MeshDataView& Data)
+{
+    TSharedPtr<Mesh> Result = MakeShared<Mesh>();
+    if (Result->Init(Data))
+    {
+        return Result;
+    }
+    else
+    {
+        return TSharedPtr<Mesh>(nullptr);
+    }
+}
+
+TSharedPtr<Mesh> Mesh::Make(const PackedMeshDataView& Data)
 {
     TSharedPtr<Mesh> Result = MakeShared<Mesh>();
     if (Result->Init(Data))
@@ -82,25 +134,81 @@ TSharedPtr<Mesh> Mesh::Make(const MeshData& Data)
     }
 }
 
-void Mesh::CreateBoundingBox(const MeshData& Data)
+void Mesh::AddLOD(const TSharedPtr<Mesh>& LODMesh, float ScreenSize)
+{
+    Assert(LODMesh != nullptr);
+    Assert(LODScreenSizes.IsEmpty() || ScreenSize < LODScreenSizes.Back());
+
+    LODs.EmplaceBack(LODMesh);
+    LODScreenSizes.EmplaceBack(ScreenSize);
+}
+
+XMFLOAT4X4 Mesh::GetVertexTransform(const XMFLOAT4X4& Transform) const
 {
-    constexpr float Inf = std::numeric_limits<float>::infinity();
-    XMFLOAT3 Min = XMFLOAT3(Inf, Inf, Inf);
-    XMFLOAT3 Max = XMFLOAT3(-Inf, -Inf, -Inf);
+    // The shaders multiply positions with the transpose of the stored matrix, so the transposed dequantization is
+    // multiplied in from the right
+    XMMATRIX Dequantize = XMMatrixMultiply(
+        XMMatrixScaling(PositionScale, PositionScale, PositionScale),
+        XMMatrixTranslation(PositionOffset.x, PositionOffset.y, PositionOffset.z));
+
+    XMFLOAT4X4 Result;
+    XMStoreFloat4x4(&Result, XMMatrixMultiply(XMLoadFloat4x4(&Transform), XMMatrixTranspose(Dequantize)));
+    return Result;
+}
+
+XMFLOAT3X4 Mesh::GetRayTracingTransform(const XMFLOAT4X4& Transform) const
+{
+    // Transform is stored transposed, and instances store the transposed 3x4 part of the matrix
+    XMMATRIX Dequantize = XMMatrixMultiply(
+        XMMatrixScaling(PositionScale, PositionScale, PositionScale),
+        XMMatrixTranslation(PositionOffset.x, PositionOffset.y, PositionOffset.z));
+
+    XMFLOAT3X4 Result;
+    XMStoreFloat3x4(&Result, XMMatrixMultiply(Dequantize, XMMatrixTranspose(XMLoadFloat4x4(&Transform))));
+    return Result;
+}
+
+void Mesh::CreateBoundingBox(const PackedMeshDataView& Data)
+{
+    BoundingBox.Top    = Data.BoundsMax;
+    BoundingBox.Bottom = Data.BoundsMin;
+}
 
-    for (const Vertex& Vertex : Data.Vertices)
+void Mesh::CreateOccluder(const PackedMeshDataView& Data)
+{
+    // Same dequantization as GetVertexTransform
+    OccluderPositions.Resize(Data.NumVertices);
+    for (uint32 Index = 0; Index < Data.NumVertices; Index++)
+    {
+        const int16* Position = Data.Vertices[Index].Position;
+        OccluderPositions[Index] = XMFLOAT3(
+            Data.PositionOffset.x + Math::Max<float>(Position[0] / 32767.0f, -1.0f) * Data.PositionScale,
+            Data.PositionOffset.y + Math::Max<float>(Position[1] / 32767.0f, -1.0f) * Data.PositionScale,
+            Data.PositionOffset.z + Math::Max<float>(Position[2] / 32767.0f, -1.0f) * Data.PositionScale);
+    }
+
+    OccluderIndices.Resize(Data.NumIndices);
+    if (Data.Has16BitIndices())
+    {
+        const uint16* Indices = static_cast<const uint16*>(Data.Indices);
+        for (uint32 Index = 0; Index < Data.NumIndices; Index++)
+        {
+            OccluderIndices[Index] = Indices[Index];
+        }
+    }
+    else
+    {
+        memcpy(OccluderIndices.Data(), Data.Indices, Data.NumIndices * sizeof(uint32));
+    }
+}
+
+void Mesh::CreateOccluder(const MeshDataView& Data)
+{
+    OccluderPositions.Resize(Data.NumVertices);
+    for (uint32 Index = 0; Index < Data.NumVertices; Index++)
     {
-        // X
-        Min.x = Math::Min<float>(Min.x, Vertex.Position.x);
-        Max.x = Math::Max<float>(Max.x, Vertex.Position.x);
-        // Y
-        Min.y = Math::Min<float>(Min.y, Vertex.Position.y);
-        Max.y = Math::Max<float>(Max.y, Vertex.Position.y);
-        // Z
-        Min.z = Math::Min<float>(Min.z, Vertex.Position.z);
-        Max.z = Math::Max<float>(Max.z, Vertex.Position.z);
+        OccluderPositions[Index] = Data.Vertices[Index].Position;
     }
 
-    BoundingBox.Top    = Max;
-    BoundingBox.Bottom = Min;
+    OccluderIndices = TArray<uint32>(Data.Indices, Data.Indices + Data.NumIndices);
 }
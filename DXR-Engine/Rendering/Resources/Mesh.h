@@ -8,20 +8,53 @@
 
 #include "Scene/AABB.h"
 
+// Meshes draw PackedVertex instead of Vertex, and the shaders that draw them are compiled with ENABLE_PACKED_VERTICES
+constexpr bool MESH_PACKED_VERTICES = true;
+
 class Mesh
 {
 public:
     Mesh()  = default;
     ~Mesh() = default;
 
-    bool Init(const MeshData& Data);
+    // Packs the mesh with MeshFactory::PackMesh and uploads it like below
+    bool Init(const MeshDataView& Data);
+
+    // Uploads the packed vertices and indices as they are, the vertices are unpacked first when MESH_PACKED_VERTICES is
+    // false
+    bool Init(const PackedMeshDataView& Data);
     
     bool BuildAccelerationStructure(CommandList& CmdList);
 
-    static TSharedPtr<Mesh> Make(const MeshData& Data);
+    static TSharedPtr<Mesh> Make(const MeshDataView& Data);
+    static TSharedPtr<Mesh> Make(const PackedMeshDataView& Data);
+
+    // Adds a less detailed version of the mesh that is used when the object covers less than ScreenSize of the height
+    // of the view. LODs are added from the most to the least detailed, with decreasing screen sizes.
+    void AddLOD(const TSharedPtr<Mesh>& LODMesh, float ScreenSize);
+
+    // LOD 0 is the mesh itself
+    Mesh* GetLOD(uint32 LOD)
+    {
+        Assert(LOD <= LODs.Size());
+        return LOD == 0 ? this : LODs[LOD - 1].Get();
+    }
+
+    uint32 GetNumLODs() const { return LODs.Size() + 1; }
+
+    // Transform of an actor with the dequantization of the packed positions in front of it, for the vertex shaders
+    // that draw the mesh. Transform is stored transposed, like the transforms of the actors.
+    XMFLOAT4X4 GetVertexTransform(const XMFLOAT4X4& Transform) const;
+
+    // The same for the instances of the ray tracing scene, which are built from the packed positions as well
+    XMFLOAT3X4 GetRayTracingTransform(const XMFLOAT4X4& Transform) const;
 
 public:
-    void CreateBoundingBox(const MeshData& Data);
+    void CreateBoundingBox(const PackedMeshDataView& Data);
+
+    // Init does not create an occluder, since the occluder is usually a LOD of the mesh and most meshes never occlude
+    void CreateOccluder(const PackedMeshDataView& Data);
+    void CreateOccluder(const MeshDataView& Data);
 
     TRef<VertexBuffer>       VertexBuffer;
     TRef<ShaderResourceView> VertexBufferSRV;
@@ -34,5 +67,20 @@ public:
 
     float ShadowOffset = 0.0f;
 
+    // Packed positions are relative to PositionOffset and scaled by PositionScale
+    XMFLOAT3 PositionOffset = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    float    PositionScale  = 1.0f;
+
     AABB BoundingBox;
+
+    // Empty for meshes that were created without meshlets, which are always drawn whole
+    TArray<Meshlet> Meshlets;
+
+    // Copy of the geometry that the OcclusionBuffer rasterizes on the CPU, empty unless CreateOccluder has been called
+    TArray<XMFLOAT3> OccluderPositions;
+    TArray<uint32>   OccluderIndices;
+
+    // LODs[i] is LOD i + 1 and is used below LODScreenSizes[i]
+    TArray<TSharedPtr<Mesh>> LODs;
+    TArray<float>            LODScreenSizes;
 };
\ No newline at end of file
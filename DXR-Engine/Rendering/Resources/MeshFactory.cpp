@@ -1,115 +1,108 @@
 #include "Rendering/Resources/MeshFactory.h"
+#include "Rendering/Resources/GltfFile.h"
 
-//#include <assimp/Importer.hpp>
-//#include <assimp/scene.h>
-//#include <assimp/postprocess.h>
+#include "Math/Float.h"
 
-MeshData MeshFactory::CreateFromFile(const std::string& Filename, bool MergeMeshes, bool LeftHanded) noexcept
+#include "Core/Threading/TaskManager.h"
+#include "Core/Threading/Platform/PlatformProcess.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+// Opens a glTF file and finds the primitives that its nodes place in the scene
+static bool OpenGltfFile(const std::string& Filename, GltfFile& OutFile, TArray<GltfPrimitiveInstance>& OutInstances)
 {
-    UNREFERENCED_VARIABLE(Filename);
-    UNREFERENCED_VARIABLE(MergeMeshes);
-    UNREFERENCED_VARIABLE(LeftHanded);
+    if (!GltfFile::IsGltfFilename(Filename))
+    {
+        LOG_ERROR("[MeshFactory]: Unsupported file format '" + Filename + "', only glTF files can be loaded");
+        return false;
+    }
 
-    /*using namespace std;
+    if (!OutFile.Open(Filename))
+    {
+        return false;
+    }
 
-    // Set import flags
-    uint32 flags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace;
-    if (leftHanded)
+    OutFile.GetPrimitiveInstances(OutInstances);
+    if (OutInstances.IsEmpty())
     {
-        flags |= aiProcess_ConvertToLeftHanded;
+        LOG_ERROR("[MeshFactory]: File '" + Filename + "' does not have any meshes");
+        return false;
     }
-    flags = flags & ~aiProcess_FlipWindingOrder;
 
-    // Load scene
-    Assimp::Importer importer;
-    const aiScene* pScene = importer.ReadFile(filename, flags);
+    return true;
+}
 
-    // Extract scene-data
-    MeshData data;
-    if (pScene)
+MeshData MeshFactory::CreateFromFile(const std::string& Filename, bool MergeMeshes, bool LeftHanded) noexcept
+{
+    GltfFile File;
+    TArray<GltfPrimitiveInstance> Instances;
+    if (!OpenGltfFile(Filename, File, Instances))
     {
-        if (pScene->HasMeshes())
-        {
-            LOG_DEBUG_INFO("[LAMBDA ENGINE] Loading Scene with '%u' meshes\n", pScene->mNumMeshes);
+        return MeshData();
+    }
 
-            size_t vertexOffset = 0;
-            size_t indexOffset = 0;
-            uint32 numMeshesToLoad = (mergeMeshes) ? pScene->mNumMeshes : 1;
-            for (uint32 m = 0; m < numMeshesToLoad; m++)
-            {
-                const aiMesh* pMesh = pScene->mMeshes[m];
-                if (!pMesh->HasNormals())
-                {
-                    LOG_DEBUG_WARNING("[LAMBDA ENGINE] Mesh does not have normals\n");
-                }
-                if (!pMesh->HasTextureCoords(0))
-                {
-                    LOG_DEBUG_WARNING("[LAMBDA ENGINE] Mesh does not have texcoords\n");
-                }
+    if (!MergeMeshes && Instances.Size() > 1)
+    {
+        LOG_WARNING("[MeshFactory]: File '" + Filename + "' has " + std::to_string(Instances.Size()) + " meshes, only the first is loaded. Use CreateAllFromFile to load all of them.");
+    }
 
-                if (pMesh)
-                {
-                    if (pMesh->HasFaces())
-                    {
-                        // Get number of vertices and resize buffer
-                        size_t vertCount = pMesh->mNumVertices;
-                        // Vertexoffset is used when there are more than one mesh in the scene and we want to merge all the meshes
-                        data.Vertices.resize(vertexOffset + vertCount);
-                        for (size_t i = 0; i < vertCount; i++)
-                        {
-                            data.Vertices[vertexOffset + i].Position = XMFLOAT3(pMesh->mVertices[i].x, pMesh->mVertices[i].y, pMesh->mVertices[i].z);
-                            if (pMesh->HasNormals())
-                            {
-                                data.Vertices[vertexOffset + i].Normal = XMFLOAT3(pMesh->mNormals[i].x, pMesh->mNormals[i].y, pMesh->mNormals[i].z);
-                            }
-                            if (pMesh->HasTangentsAndBitangents())
-                            {
-                                data.Vertices[vertexOffset + i].Tangent = XMFLOAT3(pMesh->mTangents[i].x, pMesh->mTangents[i].y, pMesh->mTangents[i].z);
-                            }
-                            if (pMesh->HasTextureCoords(0))
-                            {
-                                data.Vertices[vertexOffset + i].TexCoord = XMFLOAT2(pMesh->mTextureCoords[0][i].x, pMesh->mTextureCoords[0][i].y);
-                            }
-                        }
-
-                        // Get number of indices and resize indexbuffer
-                        size_t triCount = pMesh->mNumFaces;
-                            
-                        // Indexoffset is used when there are more than one mesh in the scene and we want to merge all the meshes
-                        data.Indices.resize(indexOffset + (triCount * 3));
-                        for (size_t i = 0; i < triCount; i++)
-                        {
-                            data.Indices[indexOffset + (i * 3) + 0] = uint32(vertexOffset + pMesh->mFaces[i].mIndices[0]);
-                            data.Indices[indexOffset + (i * 3) + 1] = uint32(vertexOffset + pMesh->mFaces[i].mIndices[1]);
-                            data.Indices[indexOffset + (i * 3) + 2] = uint32(vertexOffset + pMesh->mFaces[i].mIndices[2]);
-                        }
-
-                        // Increase offsets
-                        if (mergeMeshes)
-                        {
-                            vertexOffset += vertCount;
-                            indexOffset += triCount * 3;
-                        }
-                    }
-                }
-            }
+    // The primitives are placed where their nodes put them, so a merged mesh looks like the whole scene
+    const uint32 NumInstances = MergeMeshes ? Instances.Size() : 1;
+
+    MeshData Data;
+    MeshData Primitive;
+    for (uint32 Index = 0; Index < NumInstances; Index++)
+    {
+        if (!File.ReadPrimitive(Instances[Index], LeftHanded, Primitive))
+        {
+            continue;
         }
-        else
+
+        const uint32 VertexOffset = Data.Vertices.Size();
+        for (const Vertex& CurrentVertex : Primitive.Vertices)
+        {
+            Data.Vertices.PushBack(CurrentVertex);
+        }
+
+        for (uint32 CurrentIndex : Primitive.Indices)
         {
-            LOG_DEBUG_ERROR("[LAMBDA ENGINE] File '%s' does not have any meshes\n", filename.c_str());
-            return data;
+            Data.Indices.PushBack(VertexOffset + CurrentIndex);
         }
     }
-    else
+
+    CalculateTangents(Data);
+
+    LOG_INFO("[MeshFactory]: Loaded mesh '" + Filename + "' with " + std::to_string(Data.Vertices.Size()) + " vertices and " + std::to_string(Data.Indices.Size() / 3) + " triangles");
+    return Data;
+}
+
+TArray<MeshData> MeshFactory::CreateAllFromFile(const std::string& Filename, bool LeftHanded) noexcept
+{
+    TArray<MeshData> Meshes;
+
+    GltfFile File;
+    TArray<GltfPrimitiveInstance> Instances;
+    if (!OpenGltfFile(Filename, File, Instances))
     {
-        const char* pErrorMessage = importer.GetErrorString();
-        LOG_SYSTEM_PRINT("[LAMBDA ENGINE] Failed to load file '%s'. Message: %s\n", filename.c_str(), pErrorMessage);
-        return data;
+        return Meshes;
     }
 
-    LOG_SYSTEM_PRINT("[LAMBDA ENGINE] Loaded mesh with %d vertices and %d indices. Triangles: %d\n", data.Vertices.GetSize(), data.Indices.GetSize(), data.Indices.GetSize() / 3);
-    return data;*/
-    return MeshData();
+    Meshes.Reserve(Instances.Size());
+    for (const GltfPrimitiveInstance& Instance : Instances)
+    {
+        MeshData Primitive;
+        if (!File.ReadPrimitive(Instance, LeftHanded, Primitive))
+        {
+            continue;
+        }
+
+        CalculateTangents(Primitive);
+        Meshes.EmplaceBack(Move(Primitive));
+    }
+
+    LOG_INFO("[MeshFactory]: Loaded " + std::to_string(Meshes.Size()) + " meshes from '" + Filename + "'");
+    return Meshes;
 }
 
 MeshData MeshFactory::CreateCube(float Width, float Height, float Depth) noexcept
@@ -185,6 +178,7 @@ MeshData MeshFactory::CreateCube(float Width, float Height, float Depth) noexcep
         21, 23, 22
     };
 
+    Optimize(Cube);
     return Cube;
 }
 
@@ -234,6 +228,8 @@ MeshData MeshFactory::CreatePlane(uint32 Width, uint32 Height) noexcept
         }
     }
 
+    Optimize(data);
+
     data.Vertices.ShrinkToFit();
     data.Indices.ShrinkToFit();
 
@@ -306,10 +302,11 @@ MeshData MeshFactory::CreateSphere(uint32 Subdivisions, float Radius) noexcept
         Sphere.Vertices[i].TexCoord.x = (atan2f(Sphere.Vertices[i].Position.z, Sphere.Vertices[i].Position.x) + XM_PI) / (2.0f * XM_PI);
     }
 
+    CalculateTangents(Sphere);
+    Optimize(Sphere);
+
     Sphere.Indices.ShrinkToFit();
     Sphere.Vertices.ShrinkToFit();
-    
-    CalculateTangents(Sphere);
 
     return Sphere;
 }
@@ -591,6 +588,160 @@ MeshData MeshFactory::CreateCylinder(uint32 Sides, float Radius, float Height) n
     return MeshData();
 }
 
+// Rounds each component from [-1, 1] to a 16-bit snorm
+static void StoreSnorm16(int16* OutValues, FXMVECTOR Value, uint32 NumComponents)
+{
+    XMVECTOR Clamped = XMVectorClamp(Value, XMVectorNegate(XMVectorSplatOne()), XMVectorSplatOne());
+    XMVECTOR Scaled  = XMVectorRound(XMVectorScale(Clamped, 32767.0f));
+
+    XMINT4 Integers;
+    XMStoreSInt4(&Integers, Scaled);
+
+    const int32 Components[4] = { Integers.x, Integers.y, Integers.z, Integers.w };
+    for (uint32 Index = 0; Index < NumComponents; Index++)
+    {
+        OutValues[Index] = int16(Components[Index]);
+    }
+}
+
+// Projects a direction onto the octahedron |x| + |y| + |z| = 1 and folds the lower half over the upper, so that XY
+// are in [-1, 1]. Zero vectors stay zero.
+static XMVECTOR OctahedronEncode(FXMVECTOR Direction)
+{
+    XMVECTOR Sum       = XMVector3Dot(XMVectorAbs(Direction), XMVectorSplatOne());
+    XMVECTOR Projected = XMVectorDivide(Direction, XMVectorMax(Sum, XMVectorReplicate(FLT_MIN)));
+
+    XMVECTOR Sign   = XMVectorSelect(XMVectorNegate(XMVectorSplatOne()), XMVectorSplatOne(), XMVectorGreaterOrEqual(Projected, XMVectorZero()));
+    XMVECTOR Folded = XMVectorMultiply(XMVectorSubtract(XMVectorSplatOne(), XMVectorAbs(XMVectorSwizzle<1, 0, 2, 3>(Projected))), Sign);
+
+    XMVECTOR IsLower = XMVectorLess(XMVectorSplatZ(Projected), XMVectorZero());
+    return XMVectorSelect(Projected, Folded, IsLower);
+}
+
+// Inverse of OctahedronEncode, the result is normalized
+static XMVECTOR OctahedronDecode(FXMVECTOR Encoded)
+{
+    XMVECTOR Sum       = XMVectorAdd(XMVectorAbs(Encoded), XMVectorAbs(XMVectorSwizzle<1, 0, 2, 3>(Encoded)));
+    XMVECTOR Direction = XMVectorSetZ(Encoded, 1.0f - XMVectorGetX(Sum));
+
+    XMVECTOR Fold = XMVectorSaturate(XMVectorNegate(XMVectorSplatZ(Direction)));
+    XMVECTOR Sign = XMVectorSelect(XMVectorSplatOne(), XMVectorNegate(XMVectorSplatOne()), XMVectorGreaterOrEqual(Direction, XMVectorZero()));
+    Direction = XMVectorSelect(Direction, XMVectorMultiplyAdd(Fold, Sign, Direction), XMVectorSelectControl(1, 1, 0, 0));
+    return XMVector3Normalize(Direction);
+}
+
+// Inverse of StoreSnorm16
+static float LoadSnorm16(int16 Value)
+{
+    return std::max(float(Value) / 32767.0f, -1.0f);
+}
+
+static void CalculatePositionBounds(const Vertex* Vertices, uint32 NumVertices, XMVECTOR& OutMin, XMVECTOR& OutMax)
+{
+    OutMin = XMVectorReplicate(FLT_MAX);
+    OutMax = XMVectorReplicate(-FLT_MAX);
+    for (uint32 Index = 0; Index < NumVertices; Index++)
+    {
+        XMVECTOR Position = XMLoadFloat3(&Vertices[Index].Position);
+        OutMin = XMVectorMin(OutMin, Position);
+        OutMax = XMVectorMax(OutMax, Position);
+    }
+
+    if (NumVertices == 0)
+    {
+        OutMin = XMVectorZero();
+        OutMax = XMVectorZero();
+    }
+}
+
+void MeshFactory::PackVertices(const Vertex* Vertices, uint32 NumVertices, TArray<PackedVertex>& OutVertices, XMFLOAT3& OutPositionOffset, float& OutPositionScale) noexcept
+{
+    XMVECTOR Min;
+    XMVECTOR Max;
+    CalculatePositionBounds(Vertices, NumVertices, Min, Max);
+
+    XMVECTOR Center     = XMVectorScale(XMVectorAdd(Min, Max), 0.5f);
+    XMVECTOR HalfExtent = XMVectorScale(XMVectorSubtract(Max, Min), 0.5f);
+
+    float Scale = std::max(std::max(XMVectorGetX(HalfExtent), XMVectorGetY(HalfExtent)), XMVectorGetZ(HalfExtent));
+    if (Scale <= 0.0f)
+    {
+        Scale = 1.0f;
+    }
+
+    XMStoreFloat3(&OutPositionOffset, Center);
+    OutPositionScale = Scale;
+
+    const float InvScale = 1.0f / Scale;
+
+    OutVertices.Resize(NumVertices);
+    for (uint32 Index = 0; Index < NumVertices; Index++)
+    {
+        const Vertex& CurrentVertex = Vertices[Index];
+        PackedVertex& Packed        = OutVertices[Index];
+
+        XMVECTOR Position = XMVectorScale(XMVectorSubtract(XMLoadFloat3(&CurrentVertex.Position), Center), InvScale);
+        StoreSnorm16(Packed.Position, XMVectorSetW(Position, 0.0f), 4);
+
+        StoreSnorm16(Packed.Normal, OctahedronEncode(XMLoadFloat3(&CurrentVertex.Normal)), 2);
+        StoreSnorm16(Packed.Tangent, OctahedronEncode(XMLoadFloat3(&CurrentVertex.Tangent)), 2);
+
+        Packed.TexCoord[0] = Float16(CurrentVertex.TexCoord.x).Encoded;
+        Packed.TexCoord[1] = Float16(CurrentVertex.TexCoord.y).Encoded;
+    }
+}
+
+void MeshFactory::UnpackVertices(const PackedVertex* Vertices, uint32 NumVertices, const XMFLOAT3& PositionOffset, float PositionScale, TArray<Vertex>& OutVertices) noexcept
+{
+    OutVertices.Resize(NumVertices);
+    for (uint32 Index = 0; Index < NumVertices; Index++)
+    {
+        const PackedVertex& Packed   = Vertices[Index];
+        Vertex&             Unpacked = OutVertices[Index];
+
+        Unpacked.Position.x = PositionOffset.x + LoadSnorm16(Packed.Position[0]) * PositionScale;
+        Unpacked.Position.y = PositionOffset.y + LoadSnorm16(Packed.Position[1]) * PositionScale;
+        Unpacked.Position.z = PositionOffset.z + LoadSnorm16(Packed.Position[2]) * PositionScale;
+
+        XMStoreFloat3(&Unpacked.Normal, OctahedronDecode(XMVectorSet(LoadSnorm16(Packed.Normal[0]), LoadSnorm16(Packed.Normal[1]), 0.0f, 0.0f)));
+        XMStoreFloat3(&Unpacked.Tangent, OctahedronDecode(XMVectorSet(LoadSnorm16(Packed.Tangent[0]), LoadSnorm16(Packed.Tangent[1]), 0.0f, 0.0f)));
+
+        Float16 TexCoord;
+        TexCoord.Encoded    = Packed.TexCoord[0];
+        Unpacked.TexCoord.x = TexCoord.GetFloat();
+        TexCoord.Encoded    = Packed.TexCoord[1];
+        Unpacked.TexCoord.y = TexCoord.GetFloat();
+    }
+}
+
+void MeshFactory::PackMesh(const MeshDataView& Data, PackedMeshData& OutData) noexcept
+{
+    PackVertices(Data.Vertices, Data.NumVertices, OutData.Vertices, OutData.PositionOffset, OutData.PositionScale);
+
+    XMVECTOR Min;
+    XMVECTOR Max;
+    CalculatePositionBounds(Data.Vertices, Data.NumVertices, Min, Max);
+    XMStoreFloat3(&OutData.BoundsMin, Min);
+    XMStoreFloat3(&OutData.BoundsMax, Max);
+
+    OutData.Indices16.Clear();
+    OutData.Indices32.Clear();
+    if (Data.NumVertices <= MESH_MAX_16BIT_INDEX_VERTICES)
+    {
+        OutData.Indices16.Resize(Data.NumIndices);
+        for (uint32 Index = 0; Index < Data.NumIndices; Index++)
+        {
+            OutData.Indices16[Index] = uint16(Data.Indices[Index]);
+        }
+    }
+    else
+    {
+        OutData.Indices32 = TArray<uint32>(Data.Indices, Data.Indices + Data.NumIndices);
+    }
+
+    OutData.Meshlets = TArray<Meshlet>(Data.Meshlets, Data.Meshlets + Data.NumMeshlets);
+}
+
 void MeshFactory::Subdivide(MeshData& OutData, uint32 Subdivisions) noexcept
 {    
     if (Subdivisions < 1)
@@ -599,15 +750,13 @@ void MeshFactory::Subdivide(MeshData& OutData, uint32 Subdivisions) noexcept
     }
 
     Vertex TempVertices[3];
-    uint32 IndexCount     = 0;
-    uint32 VertexCount    = 0;
-    uint32 OldVertexCount = 0;
+    uint32 IndexCount  = 0;
+    uint32 VertexCount = 0;
     OutData.Vertices.Reserve((OutData.Vertices.Size() * static_cast<uint32>(pow(2, Subdivisions))));
     OutData.Indices.Reserve((OutData.Indices.Size() * static_cast<uint32>(pow(4, Subdivisions))));
 
     for (uint32 i = 0; i < Subdivisions; i++)
     {
-        OldVertexCount = uint32(OutData.Vertices.Size());
         IndexCount     = uint32(OutData.Indices.Size());
         for (uint32 j = 0; j < IndexCount; j += 3)
         {
@@ -709,142 +858,1592 @@ void MeshFactory::Subdivide(MeshData& OutData, uint32 Subdivisions) noexcept
             OutData.Indices[j + 2] = VertexCount - 2;
         }
 
-        Optimize(OutData, OldVertexCount);
+        WeldVertices(OutData);
     }
 
     OutData.Vertices.ShrinkToFit();
     OutData.Indices.ShrinkToFit();
 }
 
-void MeshFactory::Optimize(MeshData& OutData, uint32 StartVertex) noexcept
+/*
+* Optimization
+*   Welding merges equal vertices through a hash map. Tipsify (Sander et al., "Fast Triangle Reordering for Vertex
+*   Locality and Reduced Overdraw") fans around vertices that are still in the simulated post-transform cache, and
+*   the clusters that the fans form are then sorted so that the triangles that face outwards from the center of the
+*   mesh are drawn first. Last, the vertices are sorted in the order that the index buffer first uses them.
+*/
+
+// Triangles of each vertex, where the triangles of vertex V are VertexTriangles[TriangleOffsets[V]] up to
+// VertexTriangles[TriangleOffsets[V + 1]]
+static void BuildVertexTriangles(const TArray<uint32>& Indices, uint32 NumVertices, TArray<uint32>& OutTriangleOffsets, TArray<uint32>& OutVertexTriangles)
 {
-    uint32 VertexCount = static_cast<uint32>(OutData.Vertices.Size());
-    uint32 IndexCount  = static_cast<uint32>(OutData.Indices.Size());
-        
-    uint32 k = 0;
-    uint32 j = 0;
-    for (uint32 i = StartVertex; i < VertexCount; i++)
+    const uint32 NumIndices = Indices.Size();
+
+    OutTriangleOffsets.Clear();
+    OutTriangleOffsets.Resize(NumVertices + 1, 0);
+    for (uint32 Index = 0; Index < NumIndices; Index++)
     {
-        for (j = 0; j < VertexCount; j++)
-        {
-            if (OutData.Vertices[i] == OutData.Vertices[j])
-            {
-                if (i != j)
-                {
-                    OutData.Vertices.Erase(OutData.Vertices.Begin() + i);
-                    VertexCount--;
-                    j--;
+        OutTriangleOffsets[Indices[Index] + 1]++;
+    }
 
-                    for (k = 0; k < IndexCount; k++)
-                    {
-                        if (OutData.Indices[k] == i)
-                        {
-                            OutData.Indices[k] = j;
-                        }
-                        else if (OutData.Indices[k] > i)
-                        {
-                            OutData.Indices[k]--;
-                        }
-                    }
+    for (uint32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+    {
+        OutTriangleOffsets[VertexIndex + 1] += OutTriangleOffsets[VertexIndex];
+    }
 
-                    i--;
-                    break;
-                }
-            }
-        }
+    TArray<uint32> WriteOffsets(OutTriangleOffsets.Begin(), OutTriangleOffsets.End() - 1);
+    OutVertexTriangles.Resize(NumIndices);
+    for (uint32 Index = 0; Index < NumIndices; Index++)
+    {
+        OutVertexTriangles[WriteOffsets[Indices[Index]]++] = Index / 3;
     }
 }
 
-void MeshFactory::CalculateHardNormals(MeshData& Data) noexcept
+static void BuildVertexTriangles(const MeshData& Data, TArray<uint32>& OutTriangleOffsets, TArray<uint32>& OutVertexTriangles)
 {
-    UNREFERENCED_VARIABLE(Data);
+    BuildVertexTriangles(Data.Indices, Data.Vertices.Size(), OutTriangleOffsets, OutVertexTriangles);
+}
 
-    /*
-    XMFLOAT3 e1;
-    XMFLOAT3 e2;
-    XMFLOAT3 n;
+void MeshFactory::WeldVertices(MeshData& OutData) noexcept
+{
+    const uint32 NumVertices = OutData.Vertices.Size();
+
+    std::unordered_map<VertexKey, uint32, VertexKeyHasher> UniqueVertices;
+    UniqueVertices.reserve(NumVertices);
 
-    for (size_t i = 0; i < data.Indices.GetSize(); i += 3)
+    // The first of the equal vertices is kept, so the vertices keep their order
+    TArray<uint32> Remap(NumVertices);
+    TArray<Vertex> Vertices;
+    Vertices.Reserve(NumVertices);
+    for (uint32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
     {
-        e1 = data.Vertices[data.Indices[i + 2]].Position - data.Vertices[data.Indices[i]].Position;
-        e2 = data.Vertices[data.Indices[i + 1]].Position - data.Vertices[data.Indices[i]].Position;
-        n = cross(e1, e2);
+        const Vertex& CurrentVertex = OutData.Vertices[VertexIndex];
 
-        data.Vertices[data.Indices[i]].Normal = n;
-        data.Vertices[data.Indices[i + 1]].Normal = n;
-        data.Vertices[data.Indices[i + 2]].Normal = n;
+        auto Result = UniqueVertices.emplace(VertexKey(CurrentVertex), Vertices.Size());
+        if (Result.second)
+        {
+            Vertices.PushBack(CurrentVertex);
+        }
+
+        Remap[VertexIndex] = Result.first->second;
     }
-    */
+
+    if (Vertices.Size() == NumVertices)
+    {
+        return;
+    }
+
+    for (uint32& Index : OutData.Indices)
+    {
+        Index = Remap[Index];
+    }
+
+    OutData.Vertices = Move(Vertices);
 }
 
-void MeshFactory::CalculateTangents(MeshData& OutData) noexcept
+// Reorders the triangles of OutIndices, which refer to the vertices [0, NumVertices)
+static void OptimizeVertexCacheIndices(TArray<uint32>& OutIndices, uint32 NumVertices, uint32 CacheSize)
 {
-    auto CalculateTangentFromVectors = [](Vertex& Vertex1, const Vertex& Vertex2, const Vertex& Vertex3)
+    const uint32 NumTriangles = OutIndices.Size() / 3;
+    if (NumTriangles == 0)
     {
-        XMFLOAT3 Edge1;
-        Edge1.x = Vertex2.Position.x - Vertex1.Position.x;
-        Edge1.y = Vertex2.Position.y - Vertex1.Position.y;
-        Edge1.z = Vertex2.Position.z - Vertex1.Position.z;
+        return;
+    }
 
-        XMFLOAT3 Edge2;
-        Edge2.x = Vertex3.Position.x - Vertex1.Position.x;
-        Edge2.y = Vertex3.Position.y - Vertex1.Position.y;
-        Edge2.z = Vertex3.Position.z - Vertex1.Position.z;
+    const TArray<uint32>& Indices = OutIndices;
 
-        XMFLOAT2 UVEdge1;
-        UVEdge1.x = Vertex2.TexCoord.x - Vertex1.TexCoord.x;
-        UVEdge1.y = Vertex2.TexCoord.y - Vertex1.TexCoord.y;
+    TArray<uint32> TriangleOffsets;
+    TArray<uint32> VertexTriangles;
+    BuildVertexTriangles(Indices, NumVertices, TriangleOffsets, VertexTriangles);
 
-        XMFLOAT3 UVEdge2;
-        UVEdge2.x = Vertex3.TexCoord.x - Vertex1.TexCoord.x;
-        UVEdge2.y = Vertex3.TexCoord.y - Vertex1.TexCoord.y;
+    // Number of triangles of each vertex that are not emitted yet
+    TArray<uint32> NumLiveTriangles(NumVertices);
+    for (uint32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+    {
+        NumLiveTriangles[VertexIndex] = TriangleOffsets[VertexIndex + 1] - TriangleOffsets[VertexIndex];
+    }
 
-        float Denominator = 1.0f / (UVEdge1.x * UVEdge2.y - UVEdge2.x * UVEdge1.y);
+    // A vertex is in the cache when less than CacheSize vertices have entered the cache after it
+    TArray<uint32> CacheTimeStamps(NumVertices, 0);
+    uint32 TimeStamp = CacheSize + 1;
 
-        XMFLOAT3 Tangent;
-        Tangent.x = Denominator * (UVEdge2.y * Edge1.x - UVEdge1.y * Edge2.x);
-        Tangent.y = Denominator * (UVEdge2.y * Edge1.y - UVEdge1.y * Edge2.y);
-        Tangent.z = Denominator * (UVEdge2.y * Edge1.z - UVEdge1.y * Edge2.z);
+    TArray<uint8>  IsEmitted(NumTriangles, 0);
+    TArray<uint32> DeadEnds;
+    TArray<uint32> Candidates;
+    DeadEnds.Reserve(Indices.Size());
 
-        float Length = std::sqrt((Tangent.x * Tangent.x) + (Tangent.y * Tangent.y) + (Tangent.z * Tangent.z));
-        if (Length != 0.0f) 
-        {        
-            Tangent.x /= Length;
-            Tangent.y /= Length;
-            Tangent.z /= Length;
-        }
+    TArray<uint32> NewIndices;
+    NewIndices.Reserve(Indices.Size());
 
-        Vertex1.Tangent = Tangent;
-    };
+    const uint32 INVALID_VERTEX = uint32(~0);
 
-    for (uint32 i = 0; i < OutData.Indices.Size(); i += 3)
+    uint32 Cursor        = 0;
+    uint32 FanningVertex = Indices[0];
+    while (FanningVertex != INVALID_VERTEX)
     {
-        Vertex& Vertex1 = OutData.Vertices[OutData.Indices[i + 0]];
-        Vertex& Vertex2 = OutData.Vertices[OutData.Indices[i + 1]];
-        Vertex& Vertex3 = OutData.Vertices[OutData.Indices[i + 2]];
+        Candidates.Clear();
 
-        CalculateTangentFromVectors(Vertex1, Vertex2, Vertex3);
-        CalculateTangentFromVectors(Vertex2, Vertex3, Vertex1);
-        CalculateTangentFromVectors(Vertex3, Vertex1, Vertex2);
+        for (uint32 Offset = TriangleOffsets[FanningVertex]; Offset < TriangleOffsets[FanningVertex + 1]; Offset++)
+        {
+            const uint32 Triangle = VertexTriangles[Offset];
+            if (IsEmitted[Triangle])
+            {
+                continue;
+            }
+
+            for (uint32 Corner = 0; Corner < 3; Corner++)
+            {
+                const uint32 VertexIndex = Indices[Triangle * 3 + Corner];
+                NewIndices.EmplaceBack(VertexIndex);
+                DeadEnds.EmplaceBack(VertexIndex);
+                Candidates.EmplaceBack(VertexIndex);
+
+                NumLiveTriangles[VertexIndex]--;
+                if (TimeStamp - CacheTimeStamps[VertexIndex] > CacheSize)
+                {
+                    CacheTimeStamps[VertexIndex] = TimeStamp++;
+                }
+            }
+
+            IsEmitted[Triangle] = 1;
+        }
+
+        // Prefer the oldest vertex that stays in the cache while its remaining triangles are emitted
+        FanningVertex = INVALID_VERTEX;
+
+        int32 BestPriority = -1;
+        for (uint32 VertexIndex : Candidates)
+        {
+            if (NumLiveTriangles[VertexIndex] == 0)
+            {
+                continue;
+            }
+
+            int32 Priority = 0;
+            if (TimeStamp - CacheTimeStamps[VertexIndex] + 2 * NumLiveTriangles[VertexIndex] <= CacheSize)
+            {
+                Priority = int32(TimeStamp - CacheTimeStamps[VertexIndex]);
+            }
+
+            if (Priority > BestPriority)
+            {
+                BestPriority  = Priority;
+                FanningVertex = VertexIndex;
+            }
+        }
+
+        // At a dead end, go back to the most recent vertex that has triangles left, and after that to the next one
+        // in the vertex buffer
+        while (FanningVertex == INVALID_VERTEX && !DeadEnds.IsEmpty())
+        {
+            const uint32 VertexIndex = DeadEnds.Back();
+            DeadEnds.PopBack();
+
+            if (NumLiveTriangles[VertexIndex] > 0)
+            {
+                FanningVertex = VertexIndex;
+            }
+        }
+
+        while (FanningVertex == INVALID_VERTEX && Cursor < NumVertices)
+        {
+            if (NumLiveTriangles[Cursor] > 0)
+            {
+                FanningVertex = Cursor;
+            }
+
+            Cursor++;
+        }
     }
+
+    OutIndices = Move(NewIndices);
 }
 
-/*void Mesh::calcNormal()
+void MeshFactory::OptimizeVertexCache(MeshData& OutData, uint32 CacheSize) noexcept
 {
-    using namespace Math;
+    OptimizeVertexCacheIndices(OutData.Indices, OutData.Vertices.Size(), CacheSize);
+}
 
-    for (uint32 i = 0; i < indexBuffer->GetSize(); i += 3)
+// Sort key of each cluster of triangles, where Clusters[C] up to Clusters[C + 1] are the triangles of cluster C. The key
+// is how far the area weighted centroid of the cluster is in front of the center of the mesh along the average normal
+// of the cluster, so the clusters that are drawn in descending order of the key are the ones that are in front of the
+// others more often.
+static void CalculateOverdrawSortKeys(const MeshData& Data, const TArray<uint32>& Clusters, TArray<float>& OutSortKeys)
+{
+    const TArray<uint32>& Indices = Data.Indices;
+
+    const uint32 NumClusters = Clusters.Size() - 1;
+
+    TArray<XMFLOAT3> ClusterCentroids(NumClusters);
+    TArray<XMFLOAT3> ClusterNormals(NumClusters);
+
+    XMVECTOR MeshCentroid = XMVectorZero();
+    float    MeshArea     = 0.0f;
+    for (uint32 Cluster = 0; Cluster < NumClusters; Cluster++)
     {
-        XMFLOAT3 edge1 = (*vertexBuffer)[(*indexBuffer)[i + 2]].Position - (*vertexBuffer)[(*indexBuffer)[i + 1]].Position;
-        XMFLOAT3 edge2 = (*vertexBuffer)[(*indexBuffer)[i]].Position - (*vertexBuffer)[(*indexBuffer)[i + 2]].Position;
-        XMFLOAT3 edge3 = (*vertexBuffer)[(*indexBuffer)[i + 1]].Position - (*vertexBuffer)[(*indexBuffer)[i + 0]].Position;
+        XMVECTOR Centroid = XMVectorZero();
+        XMVECTOR Normal   = XMVectorZero();
+        float    Area     = 0.0f;
+        for (uint32 Triangle = Clusters[Cluster]; Triangle < Clusters[Cluster + 1]; Triangle++)
+        {
+            XMVECTOR Position0 = XMLoadFloat3(&Data.Vertices[Indices[Triangle * 3 + 0]].Position);
+            XMVECTOR Position1 = XMLoadFloat3(&Data.Vertices[Indices[Triangle * 3 + 1]].Position);
+            XMVECTOR Position2 = XMLoadFloat3(&Data.Vertices[Indices[Triangle * 3 + 2]].Position);
+
+            // Twice the area, which does not matter since it is only used as a weight
+            XMVECTOR TriangleNormal = XMVector3Cross(XMVectorSubtract(Position1, Position0), XMVectorSubtract(Position2, Position0));
+            float    TriangleArea   = XMVectorGetX(XMVector3Length(TriangleNormal));
+
+            XMVECTOR TriangleCentroid = XMVectorScale(XMVectorAdd(XMVectorAdd(Position0, Position1), Position2), 1.0f / 3.0f);
+            Centroid = XMVectorAdd(Centroid, XMVectorScale(TriangleCentroid, TriangleArea));
+            Normal   = XMVectorAdd(Normal, TriangleNormal);
+            Area    += TriangleArea;
+        }
 
-        XMFLOAT3 Normal = edge1.Cross(edge2);
-        Normal.Normalize();
+        MeshCentroid = XMVectorAdd(MeshCentroid, Centroid);
+        MeshArea    += Area;
 
-        (*vertexBuffer)[(*indexBuffer)[i]].Normal = Normal;
-        (*vertexBuffer)[(*indexBuffer)[i + 1]].Normal = Normal;
-        (*vertexBuffer)[(*indexBuffer)[i + 2]].Normal = Normal;
+        XMStoreFloat3(&ClusterCentroids[Cluster], Area > 0.0f ? XMVectorScale(Centroid, 1.0f / Area) : Centroid);
+        XMStoreFloat3(&ClusterNormals[Cluster], XMVector3Normalize(Normal));
     }
-}*/
 
+    if (MeshArea > 0.0f)
+    {
+        MeshCentroid = XMVectorScale(MeshCentroid, 1.0f / MeshArea);
+    }
+
+    OutSortKeys.Resize(NumClusters);
+    for (uint32 Cluster = 0; Cluster < NumClusters; Cluster++)
+    {
+        XMVECTOR Offset = XMVectorSubtract(XMLoadFloat3(&ClusterCentroids[Cluster]), MeshCentroid);
+        OutSortKeys[Cluster] = XMVectorGetX(XMVector3Dot(Offset, XMLoadFloat3(&ClusterNormals[Cluster])));
+    }
+}
+
+void MeshFactory::OptimizeOverdraw(MeshData& OutData, float Threshold, uint32 CacheSize) noexcept
+{
+    const uint32 NumVertices  = OutData.Vertices.Size();
+    const uint32 NumTriangles = OutData.Indices.Size() / 3;
+    if (NumTriangles < 2)
+    {
+        return;
+    }
+
+    const TArray<uint32>& Indices = OutData.Indices;
+
+    // Simulates a FIFO cache and returns the number of vertices of the triangle that were not in it
+    TArray<uint32> CacheTimeStamps(NumVertices, 0);
+    uint32 TimeStamp = CacheSize + 1;
+
+    auto EmitTriangle = [&](uint32 Triangle)
+    {
+        uint32 NumMisses = 0;
+        for (uint32 Corner = 0; Corner < 3; Corner++)
+        {
+            const uint32 VertexIndex = Indices[Triangle * 3 + Corner];
+            if (TimeStamp - CacheTimeStamps[VertexIndex] > CacheSize)
+            {
+                CacheTimeStamps[VertexIndex] = TimeStamp++;
+                NumMisses++;
+            }
+        }
+
+        return NumMisses;
+    };
+
+    auto FlushCache = [&]()
+    {
+        TimeStamp += CacheSize + 1;
+    };
+
+    // The vertex cache order starts a new cluster where a triangle does not share any vertex with the cache
+    TArray<uint32> HardClusters;
+    TArray<uint32> TriangleMisses(NumTriangles);
+    for (uint32 Triangle = 0; Triangle < NumTriangles; Triangle++)
+    {
+        TriangleMisses[Triangle] = EmitTriangle(Triangle);
+        if (Triangle == 0 || TriangleMisses[Triangle] == 3)
+        {
+            HardClusters.EmplaceBack(Triangle);
+        }
+    }
+
+    HardClusters.EmplaceBack(NumTriangles);
+
+    // Each cluster is split further where the cache misses since the last split get close enough to the ones of the
+    // whole cluster. Smaller clusters can be sorted better, but cost some extra misses where they meet.
+    TArray<uint32> Clusters;
+    for (uint32 HardCluster = 0; HardCluster + 1 < HardClusters.Size(); HardCluster++)
+    {
+        const uint32 Start = HardClusters[HardCluster];
+        const uint32 End   = HardClusters[HardCluster + 1];
+
+        uint32 NumClusterMisses = 0;
+        for (uint32 Triangle = Start; Triangle < End; Triangle++)
+        {
+            NumClusterMisses += TriangleMisses[Triangle];
+        }
+
+        const float MaxMissRatio = (float(NumClusterMisses) / float(End - Start)) * Threshold;
+
+        FlushCache();
+        Clusters.EmplaceBack(Start);
+
+        uint32 NumSplitMisses    = 0;
+        uint32 NumSplitTriangles = 0;
+        for (uint32 Triangle = Start; Triangle + 1 < End; Triangle++)
+        {
+            NumSplitMisses += EmitTriangle(Triangle);
+            NumSplitTriangles++;
+
+            if (float(NumSplitMisses) <= MaxMissRatio * float(NumSplitTriangles))
+            {
+                FlushCache();
+                Clusters.EmplaceBack(Triangle + 1);
+
+                NumSplitMisses    = 0;
+                NumSplitTriangles = 0;
+            }
+        }
+    }
+
+    Clusters.EmplaceBack(NumTriangles);
+
+    // Clusters that face away from the center are in front of the others more often, so they are drawn first
+    const uint32 NumClusters = Clusters.Size() - 1;
+
+    TArray<float> SortKeys;
+    CalculateOverdrawSortKeys(OutData, Clusters, SortKeys);
+
+    TArray<uint32> ClusterOrder(NumClusters);
+    for (uint32 Cluster = 0; Cluster < NumClusters; Cluster++)
+    {
+        ClusterOrder[Cluster] = Cluster;
+    }
+
+    std::stable_sort(ClusterOrder.Begin(), ClusterOrder.End(), [&](uint32 Left, uint32 Right)
+    {
+        return SortKeys[Left] > SortKeys[Right];
+    });
+
+    TArray<uint32> NewIndices;
+    NewIndices.Reserve(Indices.Size());
+    for (uint32 Cluster : ClusterOrder)
+    {
+        for (uint32 Index = Clusters[Cluster] * 3; Index < Clusters[Cluster + 1] * 3; Index++)
+        {
+            NewIndices.EmplaceBack(Indices[Index]);
+        }
+    }
+
+    OutData.Indices = Move(NewIndices);
+}
+
+void MeshFactory::OptimizeVertexFetch(MeshData& OutData) noexcept
+{
+    const uint32 INVALID_VERTEX = uint32(~0);
+
+    // Vertices that no triangle uses are removed
+    TArray<uint32> Remap(OutData.Vertices.Size(), INVALID_VERTEX);
+    TArray<Vertex> Vertices;
+    Vertices.Reserve(OutData.Vertices.Size());
+    for (uint32& Index : OutData.Indices)
+    {
+        if (Remap[Index] == INVALID_VERTEX)
+        {
+            Remap[Index] = Vertices.Size();
+            Vertices.PushBack(OutData.Vertices[Index]);
+        }
+
+        Index = Remap[Index];
+    }
+
+    OutData.Vertices = Move(Vertices);
+}
+
+void MeshFactory::Optimize(MeshData& OutData) noexcept
+{
+    WeldVertices(OutData);
+    OptimizeVertexCache(OutData);
+    OptimizeOverdraw(OutData);
+    OptimizeVertexFetch(OutData);
+}
+
+/*
+* Meshlets
+*   A meshlet starts at the first triangle that is left in the index order, which keeps the locality of the vertex
+*   cache optimization, and grows to the neighbouring triangle that adds the fewest new vertices, where ties go to the
+*   triangle that is closest to the center of the meshlet. A meshlet that runs out of neighbours continues at the next
+*   triangle in the index order if that is close by. The bounding sphere is grown with Ritter's algorithm, and the
+*   normal cone is centered on the average normal of the triangles.
+*/
+
+// A cone with an angle this close to 90 degrees can only cull from a small part of the view directions
+static constexpr float MESHLET_MIN_CONE_COS = 0.1f;
+
+static void CalculateMeshletBounds(const MeshData& Data, const TArray<uint32>& MeshletVertices, const uint32* Indices, Meshlet& OutMeshlet)
+{
+    const TArray<Vertex>& Vertices = Data.Vertices;
+
+    // Start with the two points that are furthest apart along one of the axes
+    uint32 MinVertex[3] = { MeshletVertices[0], MeshletVertices[0], MeshletVertices[0] };
+    uint32 MaxVertex[3] = { MeshletVertices[0], MeshletVertices[0], MeshletVertices[0] };
+    for (uint32 VertexIndex : MeshletVertices)
+    {
+        const float* Position = &Vertices[VertexIndex].Position.x;
+        for (uint32 Axis = 0; Axis < 3; Axis++)
+        {
+            if (Position[Axis] < (&Vertices[MinVertex[Axis]].Position.x)[Axis])
+            {
+                MinVertex[Axis] = VertexIndex;
+            }
+
+            if (Position[Axis] > (&Vertices[MaxVertex[Axis]].Position.x)[Axis])
+            {
+                MaxVertex[Axis] = VertexIndex;
+            }
+        }
+    }
+
+    XMVECTOR Center = XMVectorZero();
+    float    Radius = -1.0f;
+    for (uint32 Axis = 0; Axis < 3; Axis++)
+    {
+        XMVECTOR Min = XMLoadFloat3(&Vertices[MinVertex[Axis]].Position);
+        XMVECTOR Max = XMLoadFloat3(&Vertices[MaxVertex[Axis]].Position);
+
+        const float AxisRadius = XMVectorGetX(XMVector3Length(XMVectorSubtract(Max, Min))) * 0.5f;
+        if (AxisRadius > Radius)
+        {
+            Center = XMVectorScale(XMVectorAdd(Min, Max), 0.5f);
+            Radius = AxisRadius;
+        }
+    }
+
+    // Grow the sphere just enough to reach each point that is outside
+    for (uint32 VertexIndex : MeshletVertices)
+    {
+        XMVECTOR Position = XMLoadFloat3(&Vertices[VertexIndex].Position);
+        XMVECTOR Delta    = XMVectorSubtract(Position, Center);
+
+        const float Distance = XMVectorGetX(XMVector3Length(Delta));
+        if (Distance > Radius)
+        {
+            const float NewRadius = (Radius + Distance) * 0.5f;
+            Center = XMVectorAdd(Center, XMVectorScale(Delta, (NewRadius - Radius) / Distance));
+            Radius = NewRadius;
+        }
+    }
+
+    XMStoreFloat3(&OutMeshlet.Center, Center);
+    OutMeshlet.Radius = Radius;
+
+    TArray<XMVECTOR> Normals;
+    Normals.Reserve(OutMeshlet.NumTriangles);
+
+    XMVECTOR NormalSum = XMVectorZero();
+    for (uint32 Triangle = 0; Triangle < OutMeshlet.NumTriangles; Triangle++)
+    {
+        XMVECTOR Position0 = XMLoadFloat3(&Vertices[Indices[Triangle * 3 + 0]].Position);
+        XMVECTOR Position1 = XMLoadFloat3(&Vertices[Indices[Triangle * 3 + 1]].Position);
+        XMVECTOR Position2 = XMLoadFloat3(&Vertices[Indices[Triangle * 3 + 2]].Position);
+
+        // Degenerate triangles are never drawn, so they do not need to be inside the cone
+        XMVECTOR Normal = XMVector3Cross(XMVectorSubtract(Position1, Position0), XMVectorSubtract(Position2, Position0));
+        const float Length = XMVectorGetX(XMVector3Length(Normal));
+        if (Length > 0.0f)
+        {
+            Normal = XMVectorScale(Normal, 1.0f / Length);
+            Normals.EmplaceBack(Normal);
+            NormalSum = XMVectorAdd(NormalSum, Normal);
+        }
+    }
+
+    OutMeshlet.ConeAxis   = XMFLOAT3(0.0f, 0.0f, 1.0f);
+    OutMeshlet.ConeCutoff = 2.0f;
+
+    const float SumLength = XMVectorGetX(XMVector3Length(NormalSum));
+    if (SumLength <= 0.0f)
+    {
+        return;
+    }
+
+    XMVECTOR Axis = XMVectorScale(NormalSum, 1.0f / SumLength);
+
+    float MinCos = 1.0f;
+    for (XMVECTOR Normal : Normals)
+    {
+        MinCos = std::min(MinCos, XMVectorGetX(XMVector3Dot(Normal, Axis)));
+    }
+
+    XMStoreFloat3(&OutMeshlet.ConeAxis, Axis);
+    if (MinCos > MESHLET_MIN_CONE_COS)
+    {
+        // All triangles face away when the view direction is at most 90 degrees minus the half angle of the cone from
+        // the axis, and the cosine of that is the sine of the half angle
+        OutMeshlet.ConeCutoff = sqrtf(1.0f - (MinCos * MinCos));
+    }
+}
+
+// The greedy growth of the meshlets replaces the order of Optimize, so the meshlets are sorted like the clusters of
+// OptimizeOverdraw, the triangles of each meshlet are sorted for the vertex cache, and the vertices are sorted in the
+// order that the new indices first use them
+static void OptimizeMeshletOrder(MeshData& OutData)
+{
+    const uint32 NumMeshlets = OutData.Meshlets.Size();
+
+    TArray<uint32> Clusters(NumMeshlets + 1);
+    for (uint32 MeshletIndex = 0; MeshletIndex < NumMeshlets; MeshletIndex++)
+    {
+        Clusters[MeshletIndex] = OutData.Meshlets[MeshletIndex].FirstTriangle;
+    }
+
+    Clusters[NumMeshlets] = OutData.Indices.Size() / 3;
+
+    TArray<float> SortKeys;
+    CalculateOverdrawSortKeys(OutData, Clusters, SortKeys);
+
+    TArray<uint32> MeshletOrder(NumMeshlets);
+    for (uint32 MeshletIndex = 0; MeshletIndex < NumMeshlets; MeshletIndex++)
+    {
+        MeshletOrder[MeshletIndex] = MeshletIndex;
+    }
+
+    std::stable_sort(MeshletOrder.Begin(), MeshletOrder.End(), [&](uint32 Left, uint32 Right)
+    {
+        return SortKeys[Left] > SortKeys[Right];
+    });
+
+    // The vertices of a meshlet are renumbered from zero while its triangles are sorted, so that the cache
+    // optimization only touches as many vertices as the meshlet has
+    const uint32 INVALID_VERTEX = uint32(~0);
+
+    TArray<uint32> LocalVertices(OutData.Vertices.Size(), INVALID_VERTEX);
+    TArray<uint32> MeshletVertices;
+    TArray<uint32> MeshletIndices;
+
+    TArray<Meshlet> NewMeshlets;
+    NewMeshlets.Reserve(NumMeshlets);
+
+    TArray<uint32> NewIndices;
+    NewIndices.Reserve(OutData.Indices.Size());
+    for (uint32 MeshletIndex : MeshletOrder)
+    {
+        Meshlet& NewMeshlet = NewMeshlets.EmplaceBack(OutData.Meshlets[MeshletIndex]);
+        NewMeshlet.FirstTriangle = NewIndices.Size() / 3;
+
+        MeshletVertices.Clear();
+        MeshletIndices.Clear();
+
+        const uint32 FirstIndex = OutData.Meshlets[MeshletIndex].FirstTriangle * 3;
+        const uint32 EndIndex   = FirstIndex + NewMeshlet.NumTriangles * 3;
+        for (uint32 Index = FirstIndex; Index < EndIndex; Index++)
+        {
+            const uint32 VertexIndex = OutData.Indices[Index];
+            if (LocalVertices[VertexIndex] == INVALID_VERTEX)
+            {
+                LocalVertices[VertexIndex] = MeshletVertices.Size();
+                MeshletVertices.EmplaceBack(VertexIndex);
+            }
+
+            MeshletIndices.EmplaceBack(LocalVertices[VertexIndex]);
+        }
+
+        OptimizeVertexCacheIndices(MeshletIndices, MeshletVertices.Size(), MESH_VERTEX_CACHE_SIZE);
+
+        for (uint32 LocalIndex : MeshletIndices)
+        {
+            NewIndices.EmplaceBack(MeshletVertices[LocalIndex]);
+        }
+
+        for (uint32 VertexIndex : MeshletVertices)
+        {
+            LocalVertices[VertexIndex] = INVALID_VERTEX;
+        }
+    }
+
+    OutData.Indices  = Move(NewIndices);
+    OutData.Meshlets = Move(NewMeshlets);
+
+    // The bounds of the meshlets only depend on the positions, so they stay valid when the vertices are moved
+    MeshFactory::OptimizeVertexFetch(OutData);
+}
+
+void MeshFactory::BuildMeshlets(MeshData& OutData, uint32 MaxVertices, uint32 MaxPrimitives) noexcept
+{
+    Assert(MaxVertices >= 3 && MaxPrimitives >= 1);
+
+    OutData.Meshlets.Clear();
+
+    const uint32 NumVertices  = OutData.Vertices.Size();
+    const uint32 NumTriangles = OutData.Indices.Size() / 3;
+    if (NumTriangles == 0)
+    {
+        return;
+    }
+
+    const TArray<uint32>& Indices = OutData.Indices;
+
+    TArray<uint32> TriangleOffsets;
+    TArray<uint32> VertexTriangles;
+    BuildVertexTriangles(OutData, TriangleOffsets, VertexTriangles);
+
+    TArray<uint32> NumLiveTriangles(NumVertices);
+    for (uint32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+    {
+        NumLiveTriangles[VertexIndex] = TriangleOffsets[VertexIndex + 1] - TriangleOffsets[VertexIndex];
+    }
+
+    TArray<XMFLOAT3> Centroids(NumTriangles);
+    float Area = 0.0f;
+    for (uint32 Triangle = 0; Triangle < NumTriangles; Triangle++)
+    {
+        XMVECTOR Position0 = XMLoadFloat3(&OutData.Vertices[Indices[Triangle * 3 + 0]].Position);
+        XMVECTOR Position1 = XMLoadFloat3(&OutData.Vertices[Indices[Triangle * 3 + 1]].Position);
+        XMVECTOR Position2 = XMLoadFloat3(&OutData.Vertices[Indices[Triangle * 3 + 2]].Position);
+        XMStoreFloat3(&Centroids[Triangle], XMVectorScale(XMVectorAdd(XMVectorAdd(Position0, Position1), Position2), 1.0f / 3.0f));
+
+        XMVECTOR Normal = XMVector3Cross(XMVectorSubtract(Position1, Position0), XMVectorSubtract(Position2, Position0));
+        Area += XMVectorGetX(XMVector3Length(Normal)) * 0.5f;
+    }
+
+    // A meshlet only continues at a triangle that it is not connected to when the triangle is closer than the radius of
+    // a round meshlet with MaxPrimitives triangles of average size. Otherwise the triangles that are left over between
+    // meshlets would be joined into meshlets that span the mesh, which never get culled.
+    const float MaxJumpDistanceSqr = (Area * float(MaxPrimitives)) / (float(NumTriangles) * XM_PI);
+
+    // The meshlet that a vertex was last added to plus one, so that zero is no meshlet
+    TArray<uint32> VertexMeshlets(NumVertices, 0);
+    TArray<uint32> MeshletVertices;
+    MeshletVertices.Reserve(MaxVertices);
+
+    TArray<uint8>  IsEmitted(NumTriangles, 0);
+    TArray<uint32> NewIndices;
+    NewIndices.Reserve(Indices.Size());
+
+    const uint32 INVALID_TRIANGLE = uint32(~0);
+
+    auto CountNewVertices = [&](uint32 Triangle, uint32 MeshletID) -> uint32
+    {
+        const uint32 Index0 = Indices[Triangle * 3 + 0];
+        const uint32 Index1 = Indices[Triangle * 3 + 1];
+        const uint32 Index2 = Indices[Triangle * 3 + 2];
+
+        uint32 NumNew = (VertexMeshlets[Index0] != MeshletID) ? 1 : 0;
+        NumNew += (VertexMeshlets[Index1] != MeshletID && Index1 != Index0) ? 1 : 0;
+        NumNew += (VertexMeshlets[Index2] != MeshletID && Index2 != Index0 && Index2 != Index1) ? 1 : 0;
+        return NumNew;
+    };
+
+    uint32 Cursor = 0;
+    while (NewIndices.Size() < Indices.Size())
+    {
+        Meshlet NewMeshlet = { };
+        NewMeshlet.FirstTriangle = NewIndices.Size() / 3;
+
+        const uint32 MeshletID = OutData.Meshlets.Size() + 1;
+        MeshletVertices.Clear();
+
+        XMVECTOR CentroidSum = XMVectorZero();
+
+        while (IsEmitted[Cursor])
+        {
+            Cursor++;
+        }
+
+        uint32 Triangle = Cursor;
+        while (Triangle != INVALID_TRIANGLE)
+        {
+            for (uint32 Corner = 0; Corner < 3; Corner++)
+            {
+                const uint32 VertexIndex = Indices[Triangle * 3 + Corner];
+                if (VertexMeshlets[VertexIndex] != MeshletID)
+                {
+                    VertexMeshlets[VertexIndex] = MeshletID;
+                    MeshletVertices.EmplaceBack(VertexIndex);
+                }
+
+                NewIndices.EmplaceBack(VertexIndex);
+                NumLiveTriangles[VertexIndex]--;
+            }
+
+            IsEmitted[Triangle] = 1;
+            CentroidSum = XMVectorAdd(CentroidSum, XMLoadFloat3(&Centroids[Triangle]));
+            NewMeshlet.NumTriangles++;
+
+            if (NewMeshlet.NumTriangles >= MaxPrimitives)
+            {
+                break;
+            }
+
+            XMVECTOR MeshletCenter = XMVectorScale(CentroidSum, 1.0f / float(NewMeshlet.NumTriangles));
+
+            Triangle = INVALID_TRIANGLE;
+
+            bool   HasNeighbours   = false;
+            uint32 BestScore       = uint32(~0);
+            float  BestDistanceSqr = FLT_MAX;
+            for (uint32 VertexIndex : MeshletVertices)
+            {
+                if (NumLiveTriangles[VertexIndex] == 0)
+                {
+                    continue;
+                }
+
+                for (uint32 Offset = TriangleOffsets[VertexIndex]; Offset < TriangleOffsets[VertexIndex + 1]; Offset++)
+                {
+                    const uint32 Neighbour = VertexTriangles[Offset];
+                    if (IsEmitted[Neighbour])
+                    {
+                        continue;
+                    }
+
+                    HasNeighbours = true;
+
+                    const uint32 NumNew = CountNewVertices(Neighbour, MeshletID);
+                    if (MeshletVertices.Size() + NumNew > MaxVertices)
+                    {
+                        continue;
+                    }
+
+                    // Among the triangles that add as many vertices, the last triangle of a vertex goes first, since
+                    // it would otherwise be left over as a small meshlet of its own
+                    const bool IsLastOfVertex =
+                        NumLiveTriangles[Indices[Neighbour * 3 + 0]] == 1 ||
+                        NumLiveTriangles[Indices[Neighbour * 3 + 1]] == 1 ||
+                        NumLiveTriangles[Indices[Neighbour * 3 + 2]] == 1;
+
+                    const uint32 Score = (NumNew * 2) + (IsLastOfVertex ? 0 : 1);
+                    if (Score > BestScore)
+                    {
+                        continue;
+                    }
+
+                    XMVECTOR Delta = XMVectorSubtract(XMLoadFloat3(&Centroids[Neighbour]), MeshletCenter);
+                    const float DistanceSqr = XMVectorGetX(XMVector3LengthSq(Delta));
+                    if (Score < BestScore || DistanceSqr < BestDistanceSqr)
+                    {
+                        Triangle        = Neighbour;
+                        BestScore       = Score;
+                        BestDistanceSqr = DistanceSqr;
+                    }
+                }
+            }
+
+            // A meshlet whose neighbours do not fit is full, one without neighbours continues in the index order
+            if (Triangle == INVALID_TRIANGLE && !HasNeighbours)
+            {
+                while (Cursor < NumTriangles && IsEmitted[Cursor])
+                {
+                    Cursor++;
+                }
+
+                if (Cursor < NumTriangles && MeshletVertices.Size() + CountNewVertices(Cursor, MeshletID) <= MaxVertices)
+                {
+                    XMVECTOR Delta = XMVectorSubtract(XMLoadFloat3(&Centroids[Cursor]), MeshletCenter);
+                    if (XMVectorGetX(XMVector3LengthSq(Delta)) <= MaxJumpDistanceSqr)
+                    {
+                        Triangle = Cursor;
+                    }
+                }
+            }
+        }
+
+        CalculateMeshletBounds(OutData, MeshletVertices, NewIndices.Data() + NewMeshlet.FirstTriangle * 3, NewMeshlet);
+        OutData.Meshlets.EmplaceBack(NewMeshlet);
+    }
+
+    OutData.Indices = Move(NewIndices);
+
+    OptimizeMeshletOrder(OutData);
+}
+
+void MeshFactory::CalculateHardNormals(MeshData& OutData) noexcept
+{
+    // Every triangle gets its own vertices, so that the corners do not share the normal with the neighbouring
+    // triangles. Optimize welds the corners of neighbouring triangles in the same plane again.
+    TArray<Vertex> Vertices(OutData.Indices.Size());
+    for (uint32 i = 0; i < OutData.Indices.Size(); i += 3)
+    {
+        Vertices[i + 0] = OutData.Vertices[OutData.Indices[i + 0]];
+        Vertices[i + 1] = OutData.Vertices[OutData.Indices[i + 1]];
+        Vertices[i + 2] = OutData.Vertices[OutData.Indices[i + 2]];
+
+        // Front faces are clockwise, so the normal of the cross product points out of the front
+        XMVECTOR Position0 = XMLoadFloat3(&Vertices[i + 0].Position);
+        XMVECTOR Edge1     = XMVectorSubtract(XMLoadFloat3(&Vertices[i + 1].Position), Position0);
+        XMVECTOR Edge2     = XMVectorSubtract(XMLoadFloat3(&Vertices[i + 2].Position), Position0);
+
+        XMFLOAT3 Normal;
+        XMStoreFloat3(&Normal, XMVector3Normalize(XMVector3Cross(Edge1, Edge2)));
+
+        Vertices[i + 0].Normal = Normal;
+        Vertices[i + 1].Normal = Normal;
+        Vertices[i + 2].Normal = Normal;
+
+        OutData.Indices[i + 0] = i + 0;
+        OutData.Indices[i + 1] = i + 1;
+        OutData.Indices[i + 2] = i + 2;
+    }
+
+    OutData.Vertices = Move(Vertices);
+}
+
+void MeshFactory::CalculateTangents(MeshData& OutData) noexcept
+{
+    auto CalculateTangentFromVectors = [](Vertex& Vertex1, const Vertex& Vertex2, const Vertex& Vertex3)
+    {
+        XMFLOAT3 Edge1;
+        Edge1.x = Vertex2.Position.x - Vertex1.Position.x;
+        Edge1.y = Vertex2.Position.y - Vertex1.Position.y;
+        Edge1.z = Vertex2.Position.z - Vertex1.Position.z;
+
+        XMFLOAT3 Edge2;
+        Edge2.x = Vertex3.Position.x - Vertex1.Position.x;
+        Edge2.y = Vertex3.Position.y - Vertex1.Position.y;
+        Edge2.z = Vertex3.Position.z - Vertex1.Position.z;
+
+        XMFLOAT2 UVEdge1;
+        UVEdge1.x = Vertex2.TexCoord.x - Vertex1.TexCoord.x;
+        UVEdge1.y = Vertex2.TexCoord.y - Vertex1.TexCoord.y;
+
+        XMFLOAT3 UVEdge2;
+        UVEdge2.x = Vertex3.TexCoord.x - Vertex1.TexCoord.x;
+        UVEdge2.y = Vertex3.TexCoord.y - Vertex1.TexCoord.y;
+
+        float Denominator = 1.0f / (UVEdge1.x * UVEdge2.y - UVEdge2.x * UVEdge1.y);
+
+        XMFLOAT3 Tangent;
+        Tangent.x = Denominator * (UVEdge2.y * Edge1.x - UVEdge1.y * Edge2.x);
+        Tangent.y = Denominator * (UVEdge2.y * Edge1.y - UVEdge1.y * Edge2.y);
+        Tangent.z = Denominator * (UVEdge2.y * Edge1.z - UVEdge1.y * Edge2.z);
+
+        float Length = std::sqrt((Tangent.x * Tangent.x) + (Tangent.y * Tangent.y) + (Tangent.z * Tangent.z));
+        if (Length != 0.0f) 
+        {        
+            Tangent.x /= Length;
+            Tangent.y /= Length;
+            Tangent.z /= Length;
+        }
+
+        Vertex1.Tangent = Tangent;
+    };
+
+    for (uint32 i = 0; i < OutData.Indices.Size(); i += 3)
+    {
+        Vertex& Vertex1 = OutData.Vertices[OutData.Indices[i + 0]];
+        Vertex& Vertex2 = OutData.Vertices[OutData.Indices[i + 1]];
+        Vertex& Vertex3 = OutData.Vertices[OutData.Indices[i + 2]];
+
+        CalculateTangentFromVectors(Vertex1, Vertex2, Vertex3);
+        CalculateTangentFromVectors(Vertex2, Vertex3, Vertex1);
+        CalculateTangentFromVectors(Vertex3, Vertex1, Vertex2);
+    }
+}
+
+/*void Mesh::calcNormal()
+{
+    using namespace Math;
+
+    for (uint32 i = 0; i < indexBuffer->GetSize(); i += 3)
+    {
+        XMFLOAT3 edge1 = (*vertexBuffer)[(*indexBuffer)[i + 2]].Position - (*vertexBuffer)[(*indexBuffer)[i + 1]].Position;
+        XMFLOAT3 edge2 = (*vertexBuffer)[(*indexBuffer)[i]].Position - (*vertexBuffer)[(*indexBuffer)[i + 2]].Position;
+        XMFLOAT3 edge3 = (*vertexBuffer)[(*indexBuffer)[i + 1]].Position - (*vertexBuffer)[(*indexBuffer)[i + 0]].Position;
+
+        XMFLOAT3 Normal = edge1.Cross(edge2);
+        Normal.Normalize();
+
+        (*vertexBuffer)[(*indexBuffer)[i]].Normal = Normal;
+        (*vertexBuffer)[(*indexBuffer)[i + 1]].Normal = Normal;
+        (*vertexBuffer)[(*indexBuffer)[i + 2]].Normal = Normal;
+    }
+}*/
+
+/*
+* Simplification
+*   Half edge collapses ordered by a quadric error metric, where the quadric of a vertex holds the squared distance to
+*   the planes of its triangles and the squared difference to the linear interpolation of the attributes over them.
+*   Each pass collapses the cheapest edges whose vertices have not been touched by another collapse in the same pass,
+*   so that the quadrics and triangles that the cost was calculated from are still valid.
+*/
+
+// Normals, tangents and texcoords, scaled by their weight relative to the positions
+static constexpr uint32 SIMPLIFY_NUM_ATTRIBUTES = 8;
+
+static constexpr float SIMPLIFY_NORMAL_WEIGHT   = 0.5f;
+static constexpr float SIMPLIFY_TANGENT_WEIGHT  = 0.25f;
+static constexpr float SIMPLIFY_TEXCOORD_WEIGHT = 1.0f;
+
+// Collapses that turn a triangle more than about 75 degrees are rejected
+static constexpr float SIMPLIFY_MIN_NORMAL_COS = 0.25f;
+
+struct SimplifyQuadric
+{
+    // Symmetric 3x3 matrix, vector and constant of the quadratic form
+    float A00 = 0.0f;
+    float A11 = 0.0f;
+    float A22 = 0.0f;
+    float A01 = 0.0f;
+    float A02 = 0.0f;
+    float A12 = 0.0f;
+    float B0  = 0.0f;
+    float B1  = 0.0f;
+    float B2  = 0.0f;
+    float C   = 0.0f;
+
+    // Sum of the areas of the triangles
+    float Weight = 0.0f;
+
+    // Weighted sums of the gradients and offsets of each attribute over the triangles
+    float Gradients[SIMPLIFY_NUM_ATTRIBUTES][3] = { };
+    float Offsets[SIMPLIFY_NUM_ATTRIBUTES]      = { };
+};
+
+struct SimplifyCollapse
+{
+    float  Cost;
+    uint32 From;
+    uint32 To;
+};
+
+static void GetSimplifyAttributes(const Vertex& InVertex, float* OutAttributes)
+{
+    OutAttributes[0] = InVertex.Normal.x * SIMPLIFY_NORMAL_WEIGHT;
+    OutAttributes[1] = InVertex.Normal.y * SIMPLIFY_NORMAL_WEIGHT;
+    OutAttributes[2] = InVertex.Normal.z * SIMPLIFY_NORMAL_WEIGHT;
+    OutAttributes[3] = InVertex.Tangent.x * SIMPLIFY_TANGENT_WEIGHT;
+    OutAttributes[4] = InVertex.Tangent.y * SIMPLIFY_TANGENT_WEIGHT;
+    OutAttributes[5] = InVertex.Tangent.z * SIMPLIFY_TANGENT_WEIGHT;
+    OutAttributes[6] = InVertex.TexCoord.x * SIMPLIFY_TEXCOORD_WEIGHT;
+    OutAttributes[7] = InVertex.TexCoord.y * SIMPLIFY_TEXCOORD_WEIGHT;
+}
+
+static void AddQuadric(SimplifyQuadric& OutQuadric, const SimplifyQuadric& Other)
+{
+    OutQuadric.A00    += Other.A00;
+    OutQuadric.A11    += Other.A11;
+    OutQuadric.A22    += Other.A22;
+    OutQuadric.A01    += Other.A01;
+    OutQuadric.A02    += Other.A02;
+    OutQuadric.A12    += Other.A12;
+    OutQuadric.B0     += Other.B0;
+    OutQuadric.B1     += Other.B1;
+    OutQuadric.B2     += Other.B2;
+    OutQuadric.C      += Other.C;
+    OutQuadric.Weight += Other.Weight;
+
+    for (uint32 Attribute = 0; Attribute < SIMPLIFY_NUM_ATTRIBUTES; Attribute++)
+    {
+        OutQuadric.Gradients[Attribute][0] += Other.Gradients[Attribute][0];
+        OutQuadric.Gradients[Attribute][1] += Other.Gradients[Attribute][1];
+        OutQuadric.Gradients[Attribute][2] += Other.Gradients[Attribute][2];
+        OutQuadric.Offsets[Attribute]      += Other.Offsets[Attribute];
+    }
+}
+
+// Adds Weight * (Dot(Normal, P) + Distance)^2 to the quadric
+static void AddPlaneToQuadric(SimplifyQuadric& OutQuadric, float NormalX, float NormalY, float NormalZ, float Distance, float Weight)
+{
+    OutQuadric.A00 += Weight * NormalX * NormalX;
+    OutQuadric.A11 += Weight * NormalY * NormalY;
+    OutQuadric.A22 += Weight * NormalZ * NormalZ;
+    OutQuadric.A01 += Weight * NormalX * NormalY;
+    OutQuadric.A02 += Weight * NormalX * NormalZ;
+    OutQuadric.A12 += Weight * NormalY * NormalZ;
+    OutQuadric.B0  += Weight * NormalX * Distance;
+    OutQuadric.B1  += Weight * NormalY * Distance;
+    OutQuadric.B2  += Weight * NormalZ * Distance;
+    OutQuadric.C   += Weight * Distance * Distance;
+}
+
+static void CalculateTriangleQuadric(SimplifyQuadric& OutQuadric, const XMFLOAT3* Positions, const float (*Attributes)[SIMPLIFY_NUM_ATTRIBUTES])
+{
+    const XMFLOAT3& P0 = Positions[0];
+    const float Edge1[3] = { Positions[1].x - P0.x, Positions[1].y - P0.y, Positions[1].z - P0.z };
+    const float Edge2[3] = { Positions[2].x - P0.x, Positions[2].y - P0.y, Positions[2].z - P0.z };
+
+    float Normal[3] =
+    {
+        (Edge1[1] * Edge2[2]) - (Edge1[2] * Edge2[1]),
+        (Edge1[2] * Edge2[0]) - (Edge1[0] * Edge2[2]),
+        (Edge1[0] * Edge2[1]) - (Edge1[1] * Edge2[0]),
+    };
+
+    const float Length = sqrtf((Normal[0] * Normal[0]) + (Normal[1] * Normal[1]) + (Normal[2] * Normal[2]));
+    if (Length == 0.0f)
+    {
+        return;
+    }
+
+    Normal[0] /= Length;
+    Normal[1] /= Length;
+    Normal[2] /= Length;
+
+    const float Area     = Length * 0.5f;
+    const float Distance = -((Normal[0] * P0.x) + (Normal[1] * P0.y) + (Normal[2] * P0.z));
+    AddPlaneToQuadric(OutQuadric, Normal[0], Normal[1], Normal[2], Distance, Area);
+    OutQuadric.Weight += Area;
+
+    // Each attribute is a linear function Dot(Gradient, P) + Offset over the plane of the triangle, the gradient is
+    // found from the Gram matrix of the edges
+    const float Gram00 = (Edge1[0] * Edge1[0]) + (Edge1[1] * Edge1[1]) + (Edge1[2] * Edge1[2]);
+    const float Gram01 = (Edge1[0] * Edge2[0]) + (Edge1[1] * Edge2[1]) + (Edge1[2] * Edge2[2]);
+    const float Gram11 = (Edge2[0] * Edge2[0]) + (Edge2[1] * Edge2[1]) + (Edge2[2] * Edge2[2]);
+    const float Determinant = (Gram00 * Gram11) - (Gram01 * Gram01);
+    if (Determinant == 0.0f)
+    {
+        return;
+    }
+
+    const float InvDeterminant = 1.0f / Determinant;
+    for (uint32 Attribute = 0; Attribute < SIMPLIFY_NUM_ATTRIBUTES; Attribute++)
+    {
+        const float Delta1 = Attributes[1][Attribute] - Attributes[0][Attribute];
+        const float Delta2 = Attributes[2][Attribute] - Attributes[0][Attribute];
+        const float Scale1 = ((Gram11 * Delta1) - (Gram01 * Delta2)) * InvDeterminant;
+        const float Scale2 = ((Gram00 * Delta2) - (Gram01 * Delta1)) * InvDeterminant;
+
+        const float Gradient[3] =
+        {
+            (Edge1[0] * Scale1) + (Edge2[0] * Scale2),
+            (Edge1[1] * Scale1) + (Edge2[1] * Scale2),
+            (Edge1[2] * Scale1) + (Edge2[2] * Scale2),
+        };
+
+        const float Offset = Attributes[0][Attribute] - ((Gradient[0] * P0.x) + (Gradient[1] * P0.y) + (Gradient[2] * P0.z));
+
+        // Area * (Dot(Gradient, P) + Offset - S)^2, the terms that do not depend on S go into the shared quadratic form
+        AddPlaneToQuadric(OutQuadric, Gradient[0], Gradient[1], Gradient[2], Offset, Area);
+        OutQuadric.Gradients[Attribute][0] += Area * Gradient[0];
+        OutQuadric.Gradients[Attribute][1] += Area * Gradient[1];
+        OutQuadric.Gradients[Attribute][2] += Area * Gradient[2];
+        OutQuadric.Offsets[Attribute]      += Area * Offset;
+    }
+}
+
+static float EvaluateQuadric(const SimplifyQuadric& Quadric, const XMFLOAT3& Position, const float* Attributes)
+{
+    if (Quadric.Weight == 0.0f)
+    {
+        return 0.0f;
+    }
+
+    const float X = Position.x;
+    const float Y = Position.y;
+    const float Z = Position.z;
+
+    float Error =
+        (Quadric.A00 * X * X) + (Quadric.A11 * Y * Y) + (Quadric.A22 * Z * Z) +
+        2.0f * ((Quadric.A01 * X * Y) + (Quadric.A02 * X * Z) + (Quadric.A12 * Y * Z)) +
+        2.0f * ((Quadric.B0 * X) + (Quadric.B1 * Y) + (Quadric.B2 * Z)) +
+        Quadric.C;
+
+    for (uint32 Attribute = 0; Attribute < SIMPLIFY_NUM_ATTRIBUTES; Attribute++)
+    {
+        const float* Gradient = Quadric.Gradients[Attribute];
+        const float  Value    = Attributes[Attribute];
+        const float  Linear   = (Gradient[0] * X) + (Gradient[1] * Y) + (Gradient[2] * Z) + Quadric.Offsets[Attribute];
+        Error += (Quadric.Weight * Value * Value) - (2.0f * Value * Linear);
+    }
+
+    // The error is the average squared distance over the area, rounding can make it slightly negative
+    return std::max(Error / Quadric.Weight, 0.0f);
+}
+
+static bool IsTriangleFlipped(const XMFLOAT3& Moved, const XMFLOAT3& Target, const XMFLOAT3& Second, const XMFLOAT3& Third)
+{
+    auto CalculateNormal = [](const XMFLOAT3& P0, const XMFLOAT3& P1, const XMFLOAT3& P2, float* OutNormal)
+    {
+        const float Edge1[3] = { P1.x - P0.x, P1.y - P0.y, P1.z - P0.z };
+        const float Edge2[3] = { P2.x - P0.x, P2.y - P0.y, P2.z - P0.z };
+        OutNormal[0] = (Edge1[1] * Edge2[2]) - (Edge1[2] * Edge2[1]);
+        OutNormal[1] = (Edge1[2] * Edge2[0]) - (Edge1[0] * Edge2[2]);
+        OutNormal[2] = (Edge1[0] * Edge2[1]) - (Edge1[1] * Edge2[0]);
+    };
+
+    float Before[3];
+    float After[3];
+    CalculateNormal(Moved, Second, Third, Before);
+    CalculateNormal(Target, Second, Third, After);
+
+    const float Dot          = (Before[0] * After[0]) + (Before[1] * After[1]) + (Before[2] * After[2]);
+    const float LengthBefore = sqrtf((Before[0] * Before[0]) + (Before[1] * Before[1]) + (Before[2] * Before[2]));
+    const float LengthAfter  = sqrtf((After[0] * After[0]) + (After[1] * After[1]) + (After[2] * After[2]));
+    return Dot <= SIMPLIFY_MIN_NORMAL_COS * LengthBefore * LengthAfter;
+}
+
+class MeshSimplifier
+{
+public:
+    MeshSimplifier(const MeshData& InData);
+
+    // Collapses edges until there are at most TargetIndexCount indices or the next collapse costs more than MaxCost,
+    // can be called again with a smaller target to continue from the current result
+    void Simplify(uint32 TargetIndexCount, float MaxCost);
+
+    // Copies the current result with the vertices that are no longer used removed
+    void GetResult(MeshData& OutData) const;
+
+    // Largest error of the collapses so far, relative to the size of the mesh
+    float GetError() const { return sqrtf(MaxCollapseCost); }
+
+    uint32 GetNumIndices() const { return Indices.Size(); }
+
+private:
+    void BuildVertexTriangles();
+
+    bool IsCollapseValid(const SimplifyCollapse& Collapse, uint32& OutNumSharedTriangles) const;
+
+    const MeshData& Data;
+    uint32 NumVertices = 0;
+
+    TArray<uint32>          Indices;
+    TArray<XMFLOAT3>        Positions;
+    TArray<float>           Attributes;
+    TArray<SimplifyQuadric> Quadrics;
+    TArray<uint8>           IsLocked;
+
+    // Triangles around each vertex, rebuilt every pass
+    TArray<uint32> TriangleOffsets;
+    TArray<uint32> VertexTriangles;
+
+    TArray<SimplifyCollapse> Collapses;
+    TArray<uint8>            IsChanged;
+    TArray<uint32>           Remap;
+
+    float MaxCollapseCost = 0.0f;
+};
+
+MeshSimplifier::MeshSimplifier(const MeshData& InData)
+    : Data(InData)
+    , NumVertices(InData.Vertices.Size())
+    , Indices(InData.Indices)
+{
+    if (NumVertices == 0)
+    {
+        return;
+    }
+
+    // Positions are scaled to the unit box, so that the errors do not depend on the size of the mesh
+    XMFLOAT3 Min = Data.Vertices[0].Position;
+    XMFLOAT3 Max = Data.Vertices[0].Position;
+    for (const Vertex& CurrentVertex : Data.Vertices)
+    {
+        Min.x = std::min(Min.x, CurrentVertex.Position.x);
+        Min.y = std::min(Min.y, CurrentVertex.Position.y);
+        Min.z = std::min(Min.z, CurrentVertex.Position.z);
+        Max.x = std::max(Max.x, CurrentVertex.Position.x);
+        Max.y = std::max(Max.y, CurrentVertex.Position.y);
+        Max.z = std::max(Max.z, CurrentVertex.Position.z);
+    }
+
+    const float Extent = std::max(Max.x - Min.x, std::max(Max.y - Min.y, Max.z - Min.z));
+    const float Scale  = Extent > 0.0f ? 1.0f / Extent : 1.0f;
+
+    Positions.Resize(NumVertices);
+    Attributes.Resize(NumVertices * SIMPLIFY_NUM_ATTRIBUTES);
+    for (uint32 Index = 0; Index < NumVertices; Index++)
+    {
+        const Vertex& CurrentVertex = Data.Vertices[Index];
+        Positions[Index] = XMFLOAT3((CurrentVertex.Position.x - Min.x) * Scale, (CurrentVertex.Position.y - Min.y) * Scale, (CurrentVertex.Position.z - Min.z) * Scale);
+        GetSimplifyAttributes(CurrentVertex, &Attributes[Index * SIMPLIFY_NUM_ATTRIBUTES]);
+    }
+
+    // Vertices with the same position but different attributes are on a seam, the first one of them is used to find
+    // the borders of the surface independent of the attributes
+    TArray<uint32> SortedVertices(NumVertices);
+    for (uint32 Index = 0; Index < NumVertices; Index++)
+    {
+        SortedVertices[Index] = Index;
+    }
+
+    std::sort(SortedVertices.Data(), SortedVertices.Data() + NumVertices, [this](uint32 Left, uint32 Right)
+    {
+        const XMFLOAT3& LeftPosition  = Data.Vertices[Left].Position;
+        const XMFLOAT3& RightPosition = Data.Vertices[Right].Position;
+        if (LeftPosition.x != RightPosition.x)
+        {
+            return LeftPosition.x < RightPosition.x;
+        }
+        else if (LeftPosition.y != RightPosition.y)
+        {
+            return LeftPosition.y < RightPosition.y;
+        }
+        else if (LeftPosition.z != RightPosition.z)
+        {
+            return LeftPosition.z < RightPosition.z;
+        }
+        else
+        {
+            return Left < Right;
+        }
+    });
+
+    TArray<uint32> PositionIDs(NumVertices);
+    IsLocked.Resize(NumVertices);
+    for (uint32 First = 0; First < NumVertices;)
+    {
+        const XMFLOAT3& Position = Data.Vertices[SortedVertices[First]].Position;
+
+        uint32 Last = First + 1;
+        while (Last < NumVertices && memcmp(&Data.Vertices[SortedVertices[Last]].Position, &Position, sizeof(XMFLOAT3)) == 0)
+        {
+            Last++;
+        }
+
+        for (uint32 Index = First; Index < Last; Index++)
+        {
+            PositionIDs[SortedVertices[Index]] = SortedVertices[First];
+            IsLocked[SortedVertices[Index]]    = (Last - First) > 1 ? 1 : 0;
+        }
+
+        First = Last;
+    }
+
+    // Edges that only have one triangle are on a border, and edges with more than two are not manifold
+    TArray<uint64> Edges;
+    Edges.Reserve(Indices.Size());
+    for (uint32 Index = 0; Index < Indices.Size(); Index += 3)
+    {
+        for (uint32 Corner = 0; Corner < 3; Corner++)
+        {
+            const uint32 Start = PositionIDs[Indices[Index + Corner]];
+            const uint32 End   = PositionIDs[Indices[Index + ((Corner + 1) % 3)]];
+            Edges.EmplaceBack((uint64(std::min(Start, End)) << 32) | uint64(std::max(Start, End)));
+        }
+    }
+
+    std::sort(Edges.Data(), Edges.Data() + Edges.Size());
+
+    TArray<uint8> IsPositionLocked(NumVertices, 0);
+    for (uint32 First = 0; First < Edges.Size();)
+    {
+        uint32 Last = First + 1;
+        while (Last < Edges.Size() && Edges[Last] == Edges[First])
+        {
+            Last++;
+        }
+
+        if ((Last - First) != 2)
+        {
+            IsPositionLocked[uint32(Edges[First] >> 32)]        = 1;
+            IsPositionLocked[uint32(Edges[First] & 0xffffffff)] = 1;
+        }
+
+        First = Last;
+    }
+
+    for (uint32 Index = 0; Index < NumVertices; Index++)
+    {
+        IsLocked[Index] |= IsPositionLocked[PositionIDs[Index]];
+    }
+
+    Quadrics.Resize(NumVertices);
+    for (uint32 Index = 0; Index < Indices.Size(); Index += 3)
+    {
+        XMFLOAT3 TrianglePositions[3];
+        float    TriangleAttributes[3][SIMPLIFY_NUM_ATTRIBUTES];
+        for (uint32 Corner = 0; Corner < 3; Corner++)
+        {
+            const uint32 VertexIndex = Indices[Index + Corner];
+            TrianglePositions[Corner] = Positions[VertexIndex];
+            memcpy(TriangleAttributes[Corner], &Attributes[VertexIndex * SIMPLIFY_NUM_ATTRIBUTES], sizeof(float) * SIMPLIFY_NUM_ATTRIBUTES);
+        }
+
+        SimplifyQuadric TriangleQuadric;
+        CalculateTriangleQuadric(TriangleQuadric, TrianglePositions, TriangleAttributes);
+
+        AddQuadric(Quadrics[Indices[Index + 0]], TriangleQuadric);
+        AddQuadric(Quadrics[Indices[Index + 1]], TriangleQuadric);
+        AddQuadric(Quadrics[Indices[Index + 2]], TriangleQuadric);
+    }
+
+    Remap.Resize(NumVertices);
+    for (uint32 Index = 0; Index < NumVertices; Index++)
+    {
+        Remap[Index] = Index;
+    }
+}
+
+void MeshSimplifier::BuildVertexTriangles()
+{
+    TriangleOffsets.Resize(NumVertices + 1);
+    TriangleOffsets.Fill(0);
+    for (uint32 VertexIndex : Indices)
+    {
+        TriangleOffsets[VertexIndex + 1]++;
+    }
+
+    for (uint32 Index = 0; Index < NumVertices; Index++)
+    {
+        TriangleOffsets[Index + 1] += TriangleOffsets[Index];
+    }
+
+    // Filling moves each offset to the start of the next vertex, so they are shifted back afterwards
+    VertexTriangles.Resize(Indices.Size());
+    for (uint32 Index = 0; Index < Indices.Size(); Index++)
+    {
+        VertexTriangles[TriangleOffsets[Indices[Index]]++] = Index / 3;
+    }
+
+    for (uint32 Index = NumVertices; Index > 0; Index--)
+    {
+        TriangleOffsets[Index] = TriangleOffsets[Index - 1];
+    }
+
+    TriangleOffsets[0] = 0;
+}
+
+bool MeshSimplifier::IsCollapseValid(const SimplifyCollapse& Collapse, uint32& OutNumSharedTriangles) const
+{
+    // The triangles that do not have both vertices are moved with the vertex, and must not be turned around
+    OutNumSharedTriangles = 0;
+    for (uint32 Offset = TriangleOffsets[Collapse.From]; Offset < TriangleOffsets[Collapse.From + 1]; Offset++)
+    {
+        const uint32* Triangle = &Indices[VertexTriangles[Offset] * 3];
+        if (Triangle[0] == Collapse.To || Triangle[1] == Collapse.To || Triangle[2] == Collapse.To)
+        {
+            OutNumSharedTriangles++;
+            continue;
+        }
+
+        const uint32 Corner = Triangle[0] == Collapse.From ? 0 : (Triangle[1] == Collapse.From ? 1 : 2);
+        const uint32 Second = Triangle[(Corner + 1) % 3];
+        const uint32 Third  = Triangle[(Corner + 2) % 3];
+        if (IsTriangleFlipped(Positions[Collapse.From], Positions[Collapse.To], Positions[Second], Positions[Third]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MeshSimplifier::Simplify(uint32 TargetIndexCount, float MaxCost)
+{
+    while (Indices.Size() > TargetIndexCount)
+    {
+        BuildVertexTriangles();
+
+        // The vertices of an edge that is on a border or is not manifold are locked, so every edge that can collapse
+        // is in exactly two triangles and is only added from the one where it goes from the lower index
+        Collapses.Clear();
+        for (uint32 Index = 0; Index < Indices.Size(); Index += 3)
+        {
+            for (uint32 Corner = 0; Corner < 3; Corner++)
+            {
+                const uint32 First  = Indices[Index + Corner];
+                const uint32 Second = Indices[Index + ((Corner + 1) % 3)];
+                if (First > Second || (IsLocked[First] && IsLocked[Second]))
+                {
+                    continue;
+                }
+
+                const float FirstCost  = IsLocked[First] ? FLT_MAX : EvaluateQuadric(Quadrics[First], Positions[Second], &Attributes[Second * SIMPLIFY_NUM_ATTRIBUTES]);
+                const float SecondCost = IsLocked[Second] ? FLT_MAX : EvaluateQuadric(Quadrics[Second], Positions[First], &Attributes[First * SIMPLIFY_NUM_ATTRIBUTES]);
+
+                const SimplifyCollapse Collapse = FirstCost <= SecondCost ? SimplifyCollapse{ FirstCost, First, Second } : SimplifyCollapse{ SecondCost, Second, First };
+                if (Collapse.Cost <= MaxCost)
+                {
+                    Collapses.EmplaceBack(Collapse);
+                }
+            }
+        }
+
+        // Ties are broken by the vertices so that the result does not depend on the sort
+        std::sort(Collapses.Data(), Collapses.Data() + Collapses.Size(), [](const SimplifyCollapse& Left, const SimplifyCollapse& Right)
+        {
+            if (Left.Cost != Right.Cost)
+            {
+                return Left.Cost < Right.Cost;
+            }
+            else
+            {
+                return Left.From != Right.From ? Left.From < Right.From : Left.To < Right.To;
+            }
+        });
+
+        IsChanged.Resize(NumVertices);
+        IsChanged.Fill(0);
+
+        // Every collapse removes at least one triangle
+        const uint32 NumTrianglesToRemove = (Indices.Size() - TargetIndexCount + 2) / 3;
+        uint32 NumRemovedTriangles = 0;
+        uint32 NumCollapses        = 0;
+        for (const SimplifyCollapse& Collapse : Collapses)
+        {
+            if (NumRemovedTriangles >= NumTrianglesToRemove)
+            {
+                break;
+            }
+
+            // The cost was calculated before the quadrics and triangles of a changed vertex were changed
+            if (IsChanged[Collapse.From] || IsChanged[Collapse.To])
+            {
+                continue;
+            }
+
+            uint32 NumSharedTriangles = 0;
+            if (!IsCollapseValid(Collapse, NumSharedTriangles))
+            {
+                continue;
+            }
+
+            AddQuadric(Quadrics[Collapse.To], Quadrics[Collapse.From]);
+            Remap[Collapse.From] = Collapse.To;
+
+            for (uint32 Offset = TriangleOffsets[Collapse.From]; Offset < TriangleOffsets[Collapse.From + 1]; Offset++)
+            {
+                const uint32* Triangle = &Indices[VertexTriangles[Offset] * 3];
+                IsChanged[Triangle[0]] = 1;
+                IsChanged[Triangle[1]] = 1;
+                IsChanged[Triangle[2]] = 1;
+            }
+
+            MaxCollapseCost = std::max(MaxCollapseCost, Collapse.Cost);
+            NumRemovedTriangles += NumSharedTriangles;
+            NumCollapses++;
+        }
+
+        if (NumCollapses == 0)
+        {
+            break;
+        }
+
+        // Move the indices to the vertices that they were collapsed into and remove the triangles that became lines
+        uint32 NumIndices = 0;
+        for (uint32 Index = 0; Index < Indices.Size(); Index += 3)
+        {
+            const uint32 Index0 = Remap[Indices[Index + 0]];
+            const uint32 Index1 = Remap[Indices[Index + 1]];
+            const uint32 Index2 = Remap[Indices[Index + 2]];
+            if (Index0 != Index1 && Index0 != Index2 && Index1 != Index2)
+            {
+                Indices[NumIndices++] = Index0;
+                Indices[NumIndices++] = Index1;
+                Indices[NumIndices++] = Index2;
+            }
+        }
+
+        Indices.Resize(NumIndices);
+    }
+}
+
+void MeshSimplifier::GetResult(MeshData& OutData) const
+{
+    // The vertices keep their order
+    TArray<uint32> NewIndices(NumVertices, uint32(~0));
+    for (uint32 VertexIndex : Indices)
+    {
+        NewIndices[VertexIndex] = 0;
+    }
+
+    OutData.Vertices.Clear();
+    for (uint32 Index = 0; Index < NumVertices; Index++)
+    {
+        if (NewIndices[Index] != uint32(~0))
+        {
+            NewIndices[Index] = OutData.Vertices.Size();
+            OutData.Vertices.EmplaceBack(Data.Vertices[Index]);
+        }
+    }
+
+    OutData.Indices.Resize(Indices.Size());
+    for (uint32 Index = 0; Index < Indices.Size(); Index++)
+    {
+        OutData.Indices[Index] = NewIndices[Indices[Index]];
+    }
+}
+
+float MeshFactory::Simplify(MeshData& OutData, float TargetRatio, float MaxError) noexcept
+{
+    const uint32 TargetIndexCount = uint32(float(OutData.Indices.Size() / 3) * std::min(std::max(TargetRatio, 0.0f), 1.0f)) * 3;
+    if (OutData.Indices.Size() <= TargetIndexCount)
+    {
+        return 0.0f;
+    }
+
+    MeshSimplifier Simplifier(OutData);
+    Simplifier.Simplify(TargetIndexCount, MaxError < sqrtf(FLT_MAX) ? MaxError * MaxError : FLT_MAX);
+
+    MeshData Result;
+    Simplifier.GetResult(Result);
+    OutData = Move(Result);
+
+    return Simplifier.GetError();
+}
+
+MeshLODChain MeshFactory::GenerateLODs(const MeshData& Data, uint32 MaxLODs) noexcept
+{
+    MeshLODChain Chain;
+    Chain.LODs.Reserve(MaxLODs);
+    Chain.Errors.Reserve(MaxLODs);
+
+    // All LODs come from the same simplification, which keeps the quadrics of the original surface. Simplifying each
+    // LOD from the previous one would start over from quadrics that do not know about the removed triangles.
+    MeshSimplifier Simplifier(Data);
+
+    uint32 NumPreviousTriangles = Data.Indices.Size() / 3;
+    for (uint32 LOD = 0; LOD < MaxLODs && NumPreviousTriangles >= MESH_LOD_MIN_TRIANGLES * 2; LOD++)
+    {
+        const uint32 TargetIndexCount = uint32(float(NumPreviousTriangles) * MESH_LOD_TRIANGLE_RATIO) * 3;
+        Simplifier.Simplify(TargetIndexCount, FLT_MAX);
+
+        const uint32 NumTriangles = Simplifier.GetNumIndices() / 3;
+        if (float(NumTriangles) > float(NumPreviousTriangles) * (1.0f - MESH_LOD_MIN_REDUCTION))
+        {
+            break;
+        }
+
+        MeshData& LODData = Chain.LODs.EmplaceBack();
+        Simplifier.GetResult(LODData);
+        Optimize(LODData);
+
+        Chain.Errors.EmplaceBack(Simplifier.GetError());
+        NumPreviousTriangles = NumTriangles;
+    }
+
+    return Chain;
+}
+
+void MeshFactory::GenerateLODs(const TArray<MeshData>& Meshes, TArray<MeshLODChain>& OutChains, uint32 MaxLODs) noexcept
+{
+    OutChains.Clear();
+    OutChains.Resize(Meshes.Size());
+
+    // Tasks take the next mesh until there are no more, and the calling thread takes meshes as well instead of
+    // waiting. The tasks refer to the counters on the stack, so all of them have to finish before returning.
+    ThreadSafeInt32 NextMesh(0);
+    ThreadSafeInt32 NumCompletedTasks(0);
+    auto GenerateMeshLODs = [&]()
+    {
+        for (int32 Index = NextMesh.Increment() - 1; Index < int32(Meshes.Size()); Index = NextMesh.Increment() - 1)
+        {
+            OutChains[Index] = GenerateLODs(Meshes[Index], MaxLODs);
+        }
+    };
+
+    const uint32 NumTasks = std::min(TaskManager::Get().GetNumWorkers(), Meshes.Size());
+    for (uint32 TaskIndex = 0; TaskIndex < NumTasks; TaskIndex++)
+    {
+        Task GenerateTask;
+        GenerateTask.Delegate.BindLambda([&]()
+        {
+            GenerateMeshLODs();
+            NumCompletedTasks.Increment();
+        });
+
+        TaskManager::Get().AddTask(GenerateTask);
+    }
+
+    GenerateMeshLODs();
+
+    while (NumCompletedTasks.Load() < int32(NumTasks))
+    {
+        if (!TaskManager::Get().ExecuteTask())
+        {
+            PlatformProcess::Sleep(0);
+        }
+    }
+}
@@ -3,6 +3,8 @@
 
 #include "Utilities/HashUtilities.h"
 
+#include <cfloat>
+
 struct Vertex
 {
     XMFLOAT3 Position;
@@ -20,31 +22,211 @@ struct Vertex
     }
 };
 
-struct VertexHasher
+// Vertex with quantized attributes, see MeshFactory::PackVertices
+struct PackedVertex
+{
+    // R16G16B16A16_Snorm, relative to the bounding box of the mesh, the last component is padding
+    int16 Position[4];
+
+    // R16G16_Snorm, octahedral encoded
+    int16 Normal[2];
+    int16 Tangent[2];
+
+    // R16G16_Float
+    uint16 TexCoord[2];
+};
+
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex must match the packed input layout");
+
+/*
+* Key for welding vertices, the canonical bits of the floats of a vertex, see GetCanonicalFloatBits. Keys are compared
+* and hashed as plain bits, so vertices that only differ in the sign of a zero are equal just like with operator==, and
+* unlike with operator== a vertex with a NaN is equal to itself and can be welded as well.
+*/
+
+struct VertexKey
 {
-    inline size_t operator()(const Vertex& V) const
+    static constexpr uint32 NumFloats = sizeof(Vertex) / sizeof(float);
+
+    explicit VertexKey(const Vertex& InVertex)
     {
-        std::hash<XMFLOAT3> Hasher;
+        const float* Floats = reinterpret_cast<const float*>(&InVertex);
+        for (uint32 Index = 0; Index < NumFloats; Index++)
+        {
+            Bits[Index] = GetCanonicalFloatBits(Floats[Index]);
+        }
+    }
 
-        size_t Hash = Hasher(V.Position);
-        HashCombine<XMFLOAT3>(Hash, V.Normal);
-        HashCombine<XMFLOAT3>(Hash, V.Tangent);
-        HashCombine<XMFLOAT2>(Hash, V.TexCoord);
+    FORCEINLINE bool operator==(const VertexKey& Other) const
+    {
+        return memcmp(Bits, Other.Bits, sizeof(Bits)) == 0;
+    }
+
+    uint32 Bits[NumFloats];
+};
+
+static_assert(sizeof(Vertex) == 11 * sizeof(float), "VertexKey expects Vertex to only contain floats");
 
-        return Hash;
+struct VertexKeyHasher
+{
+    FORCEINLINE size_t operator()(const VertexKey& Key) const
+    {
+        return size_t(HashBytes(Key.Bits, sizeof(Key.Bits)));
     }
 };
 
+// Meshlets have at most this many vertices and triangles, which are the sizes that mesh shaders are tuned for
+constexpr uint32 MESHLET_MAX_VERTICES   = 64;
+constexpr uint32 MESHLET_MAX_PRIMITIVES = 124;
+
+// A cluster of neighbouring triangles, see MeshFactory::BuildMeshlets
+struct Meshlet
+{
+    // The triangles of the meshlet are the triangles [FirstTriangle, FirstTriangle + NumTriangles) of the index buffer
+    uint32 FirstTriangle;
+    uint32 NumTriangles;
+
+    // Bounding sphere
+    XMFLOAT3 Center;
+    float    Radius;
+
+    // All triangles face away from a viewer at V when Dot(Center - V, ConeAxis) >= ConeCutoff * Length(Center - V) + Radius,
+    // a cutoff larger than one means that the triangles face too many directions for the test to ever pass
+    XMFLOAT3 ConeAxis;
+    float    ConeCutoff;
+};
+
+static_assert(sizeof(Meshlet) == 40, "Meshlet is stored in the scene cache and must not have any padding");
+
 struct MeshData
 {
     TArray<Vertex> Vertices;
     TArray<uint32> Indices;
+
+    // Empty unless MeshFactory::BuildMeshlets has been called, which has to be the last change to the indices
+    TArray<Meshlet> Meshlets;
+};
+
+// Vertices and indices that are owned by someone else, for example a memory mapped file
+struct MeshDataView
+{
+    MeshDataView() = default;
+
+    MeshDataView(const MeshData& Data)
+        : Vertices(Data.Vertices.Data())
+        , Indices(Data.Indices.Data())
+        , Meshlets(Data.Meshlets.Data())
+        , NumVertices(Data.Vertices.Size())
+        , NumIndices(Data.Indices.Size())
+        , NumMeshlets(Data.Meshlets.Size())
+    {
+    }
+
+    const Vertex*  Vertices = nullptr;
+    const uint32*  Indices  = nullptr;
+    const Meshlet* Meshlets = nullptr;
+    uint32 NumVertices = 0;
+    uint32 NumIndices  = 0;
+    uint32 NumMeshlets = 0;
+};
+
+// Meshes with at most this many vertices use 16-bit indices
+constexpr uint32 MESH_MAX_16BIT_INDEX_VERTICES = 65536;
+
+// A mesh in the layout of the buffers of a Mesh, see MeshFactory::PackMesh
+struct PackedMeshData
+{
+    TArray<PackedVertex> Vertices;
+
+    // Indices16 when the mesh has at most MESH_MAX_16BIT_INDEX_VERTICES vertices, otherwise Indices32
+    TArray<uint16> Indices16;
+    TArray<uint32> Indices32;
+
+    TArray<Meshlet> Meshlets;
+
+    // A packed vertex is at PositionOffset + Position * PositionScale
+    XMFLOAT3 PositionOffset = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    float    PositionScale  = 1.0f;
+
+    // Bounding box of the positions before they were quantized
+    XMFLOAT3 BoundsMin = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    XMFLOAT3 BoundsMax = XMFLOAT3(0.0f, 0.0f, 0.0f);
+};
+
+// Packed vertices and indices that are owned by someone else, for example a memory mapped file
+struct PackedMeshDataView
+{
+    PackedMeshDataView() = default;
+
+    PackedMeshDataView(const PackedMeshData& Data)
+        : Vertices(Data.Vertices.Data())
+        , Indices(Data.Vertices.Size() <= MESH_MAX_16BIT_INDEX_VERTICES ? static_cast<const void*>(Data.Indices16.Data()) : static_cast<const void*>(Data.Indices32.Data()))
+        , Meshlets(Data.Meshlets.Data())
+        , NumVertices(Data.Vertices.Size())
+        , NumIndices(Data.Vertices.Size() <= MESH_MAX_16BIT_INDEX_VERTICES ? Data.Indices16.Size() : Data.Indices32.Size())
+        , NumMeshlets(Data.Meshlets.Size())
+        , PositionOffset(Data.PositionOffset)
+        , PositionScale(Data.PositionScale)
+        , BoundsMin(Data.BoundsMin)
+        , BoundsMax(Data.BoundsMax)
+    {
+    }
+
+    bool Has16BitIndices() const
+    {
+        return NumVertices <= MESH_MAX_16BIT_INDEX_VERTICES;
+    }
+
+    const PackedVertex* Vertices = nullptr;
+
+    // uint16 when Has16BitIndices returns true, otherwise uint32
+    const void*    Indices  = nullptr;
+    const Meshlet* Meshlets = nullptr;
+    uint32 NumVertices = 0;
+    uint32 NumIndices  = 0;
+    uint32 NumMeshlets = 0;
+
+    XMFLOAT3 PositionOffset = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    float    PositionScale  = 1.0f;
+    XMFLOAT3 BoundsMin      = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    XMFLOAT3 BoundsMax      = XMFLOAT3(0.0f, 0.0f, 0.0f);
+};
+
+// Number of LODs that GenerateLODs creates at most, not counting the original mesh
+constexpr uint32 MESH_MAX_GENERATED_LODS = 4;
+
+// Each generated LOD targets this fraction of the triangles of the previous LOD
+constexpr float MESH_LOD_TRIANGLE_RATIO = 0.5f;
+
+// The chain stops when a LOD removes less than this fraction of the triangles, or gets fewer triangles than this
+constexpr float  MESH_LOD_MIN_REDUCTION = 0.2f;
+constexpr uint32 MESH_LOD_MIN_TRIANGLES = 32;
+
+// Size of the post-transform vertex cache that the triangle order is optimized for
+constexpr uint32 MESH_VERTEX_CACHE_SIZE = 16;
+
+// The overdraw optimization may cause this many times the cache misses of the vertex cache order
+constexpr float MESH_OVERDRAW_THRESHOLD = 1.05f;
+
+struct MeshLODChain
+{
+    // LOD 1 and onwards, from the most to the least detailed
+    TArray<MeshData> LODs;
+
+    // Error of each LOD relative to the size of the mesh
+    TArray<float> Errors;
 };
 
 class MeshFactory
 {
 public:
+    // Loads a .gltf or .glb file with the node transforms applied to the vertices. All primitives are merged into one
+    // mesh, or only the first one is loaded when MergeMeshes is false, which logs a warning if the file has more.
     static MeshData CreateFromFile(const std::string& Filename, bool MergeMeshes = true, bool LeftHanded = true) noexcept;
+
+    // Loads each primitive of a .gltf or .glb file as its own mesh, in the order of GltfFile::GetPrimitiveInstances.
+    // Primitives that fail to load are skipped.
+    static TArray<MeshData> CreateAllFromFile(const std::string& Filename, bool LeftHanded = true) noexcept;
     static MeshData CreateCube(float Width = 1.0f, float Height = 1.0f, float Depth = 1.0f) noexcept;
     static MeshData CreatePlane(uint32 Width = 1, uint32 Height = 1) noexcept;
     static MeshData CreateSphere(uint32 Subdivisions = 0, float Radius = 0.5f) noexcept;
@@ -54,8 +236,53 @@ public:
     static MeshData CreatePyramid() noexcept;
     static MeshData CreateCylinder(uint32 Sides = 5, float Radius = 0.5f, float Height = 1.0f) noexcept;
 
+    // Quantizes the positions to the bounding box of the vertices, encodes the normals and tangents as octahedrons and
+    // the texcoords as halfs. All axes have the same scale, so that the quantization keeps angles and a packed vertex
+    // is at OutPositionOffset + Position * OutPositionScale.
+    static void PackVertices(const Vertex* Vertices, uint32 NumVertices, TArray<PackedVertex>& OutVertices, XMFLOAT3& OutPositionOffset, float& OutPositionScale) noexcept;
+
+    // Inverse of PackVertices, up to the precision of the packed attributes
+    static void UnpackVertices(const PackedVertex* Vertices, uint32 NumVertices, const XMFLOAT3& PositionOffset, float PositionScale, TArray<Vertex>& OutVertices) noexcept;
+
+    // Packs the vertices, stores the indices with 16 bits when the mesh has few enough vertices and copies the meshlets,
+    // which is everything that Mesh uploads
+    static void PackMesh(const MeshDataView& Data, PackedMeshData& OutData) noexcept;
+
     static void Subdivide(MeshData& OutData, uint32 Subdivisions = 1) noexcept;
-    static void Optimize(MeshData& OutData, uint32 StartVertex = 0) noexcept;
+
+    // Merges the vertices that are equal into the first of them
+    static void WeldVertices(MeshData& OutData) noexcept;
+
+    // Reorders the triangles so that vertices are reused from the post-transform cache as often as possible
+    static void OptimizeVertexCache(MeshData& OutData, uint32 CacheSize = MESH_VERTEX_CACHE_SIZE) noexcept;
+
+    // Sorts the clusters of triangles from OptimizeVertexCache so that the outer ones are drawn first. Threshold is
+    // how many more cache misses than the vertex cache order that the smaller clusters are allowed to cause.
+    static void OptimizeOverdraw(MeshData& OutData, float Threshold = MESH_OVERDRAW_THRESHOLD, uint32 CacheSize = MESH_VERTEX_CACHE_SIZE) noexcept;
+
+    // Sorts the vertices in the order that the indices first use them
+    static void OptimizeVertexFetch(MeshData& OutData) noexcept;
+
+    // Welds the vertices and runs all of the optimizations above
+    static void Optimize(MeshData& OutData) noexcept;
+
+    // Splits the triangles into meshlets with at most MaxVertices unique vertices and MaxPrimitives triangles, which
+    // grow from a triangle to the neighbours that add the fewest vertices and are closest to the meshlet. The indices
+    // are reordered so that the triangles of each meshlet are consecutive, which lets the meshlets that are visible be
+    // drawn as ranges of the index buffer. Like Optimize, the meshlets are then sorted to reduce overdraw, the triangles
+    // of each meshlet for the vertex cache, and the vertices in the order that they are first used.
+    static void BuildMeshlets(MeshData& OutData, uint32 MaxVertices = MESHLET_MAX_VERTICES, uint32 MaxPrimitives = MESHLET_MAX_PRIMITIVES) noexcept;
+
+    // Collapses edges with quadric error metrics until the mesh has TargetRatio of its triangles, or until the next
+    // collapse would have an error larger than MaxError. Errors are relative to the largest side of the bounding box,
+    // and include the change of the normals, tangents and texcoords. Vertices on borders and on attribute seams are
+    // never moved. Returns the largest error of the collapses that were made.
+    static float Simplify(MeshData& OutData, float TargetRatio, float MaxError = FLT_MAX) noexcept;
+
+    static MeshLODChain GenerateLODs(const MeshData& Data, uint32 MaxLODs = MESH_MAX_GENERATED_LODS) noexcept;
+
+    // Generates the LODs of all meshes in parallel on the TaskManager
+    static void GenerateLODs(const TArray<MeshData>& Meshes, TArray<MeshLODChain>& OutChains, uint32 MaxLODs = MESH_MAX_GENERATED_LODS) noexcept;
     static void CalculateHardNormals(MeshData& OutData) noexcept;
     static void CalculateTangents(MeshData& OutData) noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,391 @@
+#include "MipGenerator.h"
+
+#include <cmath>
+
+// Width and shape of the Kaiser window, from the filters used by the NVIDIA texture tools
+constexpr float KAISER_WIDTH = 3.0f;
+constexpr float KAISER_ALPHA = 4.0f;
+
+// Binary search steps for the alpha scale of a mip, enough to get the coverage within a texel of a 4k texture
+constexpr uint32 ALPHA_COVERAGE_ITERATIONS = 16;
+constexpr float  ALPHA_COVERAGE_MAX_SCALE  = 64.0f;
+
+// Modified Bessel function of the first kind of order zero
+static float Bessel0(float x)
+{
+    const float HalfX = 0.5f * x;
+
+    float Sum  = 1.0f;
+    float Term = 1.0f;
+    for (float k = 1.0f; k < 32.0f; k += 1.0f)
+    {
+        const float Factor = HalfX / k;
+        Term *= Factor * Factor;
+        Sum  += Term;
+        if (Term < Sum * 1e-7f)
+        {
+            break;
+        }
+    }
+
+    return Sum;
+}
+
+static float Sinc(float x)
+{
+    if (std::abs(x) < 1e-4f)
+    {
+        return 1.0f;
+    }
+
+    const float PiX = Math::PI * x;
+    return std::sin(PiX) / PiX;
+}
+
+// x is the distance to the center of the destination texel, in destination texels
+static float EvaluateFilter(EMipFilter Filter, float x)
+{
+    if (Filter == EMipFilter::Box)
+    {
+        return (std::abs(x) <= 0.5f) ? 1.0f : 0.0f;
+    }
+    else
+    {
+        const float Ratio = x / KAISER_WIDTH;
+        if (Ratio * Ratio >= 1.0f)
+        {
+            return 0.0f;
+        }
+
+        return Sinc(x) * Bessel0(KAISER_ALPHA * std::sqrt(1.0f - Ratio * Ratio)) / Bessel0(KAISER_ALPHA);
+    }
+}
+
+static float GetFilterSupport(EMipFilter Filter)
+{
+    return (Filter == EMipFilter::Box) ? 0.5f : KAISER_WIDTH;
+}
+
+// Every destination texel has the same number of taps, taps outside of the filter have a weight of zero
+struct FilterWeights
+{
+    uint32 NumTaps = 0;
+    TArray<uint32> Indices;
+    TArray<float>  Weights;
+};
+
+static void ComputeFilterWeights(uint32 SourceSize, uint32 DestSize, EMipFilter Filter, FilterWeights& OutWeights)
+{
+    const float Scale   = float(SourceSize) / float(DestSize);
+    const float Support = GetFilterSupport(Filter) * Scale;
+
+    OutWeights.NumTaps = uint32(std::ceil(Support * 2.0f)) + 1;
+    OutWeights.Indices.Resize(DestSize * OutWeights.NumTaps);
+    OutWeights.Weights.Resize(DestSize * OutWeights.NumTaps);
+
+    for (uint32 x = 0; x < DestSize; x++)
+    {
+        const float Center = (float(x) + 0.5f) * Scale;
+        const int32 First  = int32(std::floor(Center - Support));
+
+        uint32* Indices = OutWeights.Indices.Data() + x * OutWeights.NumTaps;
+        float*  Weights = OutWeights.Weights.Data() + x * OutWeights.NumTaps;
+
+        float Sum = 0.0f;
+        for (uint32 Tap = 0; Tap < OutWeights.NumTaps; Tap++)
+        {
+            const int32 Index = First + int32(Tap);
+
+            // Texels outside of the image are clamped to the edge
+            Indices[Tap] = uint32(std::min(std::max(Index, 0), int32(SourceSize) - 1));
+            Weights[Tap] = EvaluateFilter(Filter, (float(Index) + 0.5f - Center) / Scale);
+            Sum += Weights[Tap];
+        }
+
+        for (uint32 Tap = 0; Tap < OutWeights.NumTaps; Tap++)
+        {
+            Weights[Tap] /= Sum;
+        }
+    }
+}
+
+static float SRGBToLinear(float Value)
+{
+    return (Value <= 0.04045f) ? Value / 12.92f : std::pow((Value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float LinearToSRGB(float Value)
+{
+    return (Value <= 0.0031308f) ? Value * 12.92f : 1.055f * std::pow(Value, 1.0f / 2.4f) - 0.055f;
+}
+
+static uint8 QuantizeUnorm(float Value)
+{
+    return uint8(std::min(std::max(Value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+// Fraction of the texels that pass the alpha test after their alpha has been scaled and stored as 8 bits
+static float ComputeAlphaCoverage(const float* Texels, uint32 NumTexels, uint32 NumChannels, float Scale, float Cutoff)
+{
+    const uint32 AlphaChannel = NumChannels - 1;
+
+    uint32 NumCovered = 0;
+    for (uint32 Texel = 0; Texel < NumTexels; Texel++)
+    {
+        if (float(QuantizeUnorm(Texels[Texel * NumChannels + AlphaChannel] * Scale)) / 255.0f >= Cutoff)
+        {
+            NumCovered++;
+        }
+    }
+
+    return float(NumCovered) / float(NumTexels);
+}
+
+static float FindAlphaScale(const float* Texels, uint32 NumTexels, uint32 NumChannels, float Cutoff, float TargetCoverage)
+{
+    float Low  = 0.0f;
+    float High = ALPHA_COVERAGE_MAX_SCALE;
+    for (uint32 Iteration = 0; Iteration < ALPHA_COVERAGE_ITERATIONS; Iteration++)
+    {
+        const float Middle = 0.5f * (Low + High);
+        if (ComputeAlphaCoverage(Texels, NumTexels, NumChannels, Middle, Cutoff) < TargetCoverage)
+        {
+            Low = Middle;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    // Coverage is a step function, so neither end has to be close to the target
+    const float LowCoverage  = ComputeAlphaCoverage(Texels, NumTexels, NumChannels, Low, Cutoff);
+    const float HighCoverage = ComputeAlphaCoverage(Texels, NumTexels, NumChannels, High, Cutoff);
+    return (std::abs(LowCoverage - TargetCoverage) < std::abs(HighCoverage - TargetCoverage)) ? Low : High;
+}
+
+static void RenormalizeNormals(float* Texels, uint32 NumTexels, uint32 NumChannels)
+{
+    for (uint32 Texel = 0; Texel < NumTexels; Texel++)
+    {
+        float* Normal = Texels + Texel * NumChannels;
+
+        const float x = Normal[0] * 2.0f - 1.0f;
+        const float y = Normal[1] * 2.0f - 1.0f;
+        const float z = Normal[2] * 2.0f - 1.0f;
+
+        const float Length = std::sqrt(x * x + y * y + z * z);
+        if (Length > 1e-6f)
+        {
+            const float InvLength = 1.0f / Length;
+            Normal[0] = (x * InvLength) * 0.5f + 0.5f;
+            Normal[1] = (y * InvLength) * 0.5f + 0.5f;
+            Normal[2] = (z * InvLength) * 0.5f + 0.5f;
+        }
+    }
+}
+
+uint32 MipGenerator::GetNumMips(uint32 Width, uint32 Height)
+{
+    uint32 Size    = std::max(Width, Height);
+    uint32 NumMips = 1;
+    while (Size > 1)
+    {
+        Size >>= 1;
+        NumMips++;
+    }
+
+    return NumMips;
+}
+
+void MipGenerator::GenerateMips(
+    const uint8* Pixels,
+    uint32 Width,
+    uint32 Height,
+    uint32 NumChannels,
+    uint32 NumMips,
+    const MipGeneratorDesc& Desc,
+    TArray<uint8>& OutMips)
+{
+    Assert(NumChannels == 1 || NumChannels == 4);
+    Assert(NumMips >= 1 && NumMips <= GetNumMips(Width, Height));
+
+    const bool IsSRGB         = (Desc.Flags & MipGeneratorFlag_SRGB) && NumChannels == 4;
+    const bool IsNormalMap    = (Desc.Flags & MipGeneratorFlag_NormalMap) && NumChannels == 4;
+    const bool KeepCoverage   = (Desc.Flags & MipGeneratorFlag_AlphaCoverage);
+    const uint32 AlphaChannel = NumChannels - 1;
+
+    uint64 TotalSize = 0;
+    for (uint32 Mip = 0; Mip < NumMips; Mip++)
+    {
+        TotalSize += uint64(std::max(Width >> Mip, 1u)) * std::max(Height >> Mip, 1u) * NumChannels;
+    }
+
+    const uint64 FirstMipSize = uint64(Width) * Height * NumChannels;
+    OutMips.Resize(uint32(TotalSize));
+    Memory::Memcpy(OutMips.Data(), Pixels, FirstMipSize);
+
+    if (NumMips == 1)
+    {
+        return;
+    }
+
+    // Conversion from the first mip to the filtering space for each channel
+    float ToFloat[4][256];
+    for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+    {
+        const bool IsColor = IsSRGB && Channel < 3;
+        for (uint32 Value = 0; Value < 256; Value++)
+        {
+            const float Unorm = float(Value) / 255.0f;
+            ToFloat[Channel][Value] = IsColor ? SRGBToLinear(Unorm) : Unorm;
+        }
+    }
+
+    float TargetCoverage = 0.0f;
+    if (KeepCoverage)
+    {
+        uint32 NumCovered = 0;
+        for (uint64 Texel = 0; Texel < uint64(Width) * Height; Texel++)
+        {
+            if (ToFloat[AlphaChannel][Pixels[Texel * NumChannels + AlphaChannel]] >= Desc.AlphaCutoff)
+            {
+                NumCovered++;
+            }
+        }
+
+        TargetCoverage = float(NumCovered) / float(uint64(Width) * Height);
+    }
+
+    FilterWeights HorizontalWeights;
+    FilterWeights VerticalWeights;
+
+    TArray<float> SourceRow(Width * NumChannels);
+    TArray<float> Horizontal;
+    TArray<float> Previous;
+    TArray<float> Current;
+
+    uint8* OutPixels = OutMips.Data() + FirstMipSize;
+
+    uint32 SourceWidth  = Width;
+    uint32 SourceHeight = Height;
+    for (uint32 Mip = 1; Mip < NumMips; Mip++)
+    {
+        const uint32 DestWidth  = std::max(Width >> Mip, 1u);
+        const uint32 DestHeight = std::max(Height >> Mip, 1u);
+
+        ComputeFilterWeights(SourceWidth, DestWidth, Desc.Filter, HorizontalWeights);
+        ComputeFilterWeights(SourceHeight, DestHeight, Desc.Filter, VerticalWeights);
+
+        // Filter the rows, the first mip is converted one row at a time instead of all at once
+        const uint32 DestRowSize = DestWidth * NumChannels;
+        Horizontal.Resize(DestRowSize * SourceHeight);
+        for (uint32 y = 0; y < SourceHeight; y++)
+        {
+            const float* Row = nullptr;
+            if (Mip == 1)
+            {
+                const uint8* SourcePixels = Pixels + size_t(y) * Width * NumChannels;
+                for (uint32 Index = 0; Index < Width * NumChannels; Index++)
+                {
+                    SourceRow[Index] = ToFloat[Index % NumChannels][SourcePixels[Index]];
+                }
+
+                Row = SourceRow.Data();
+            }
+            else
+            {
+                Row = Previous.Data() + size_t(y) * SourceWidth * NumChannels;
+            }
+
+            float* Dest = Horizontal.Data() + size_t(y) * DestRowSize;
+            for (uint32 x = 0; x < DestWidth; x++)
+            {
+                const uint32* Indices = HorizontalWeights.Indices.Data() + x * HorizontalWeights.NumTaps;
+                const float*  Weights = HorizontalWeights.Weights.Data() + x * HorizontalWeights.NumTaps;
+                for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+                {
+                    float Sum = 0.0f;
+                    for (uint32 Tap = 0; Tap < HorizontalWeights.NumTaps; Tap++)
+                    {
+                        Sum += Weights[Tap] * Row[Indices[Tap] * NumChannels + Channel];
+                    }
+
+                    Dest[x * NumChannels + Channel] = Sum;
+                }
+            }
+        }
+
+        // Filter the columns, whole rows are accumulated at a time which keeps the inner loop contiguous
+        Current.Resize(DestRowSize * DestHeight);
+        for (uint32 y = 0; y < DestHeight; y++)
+        {
+            float* Dest = Current.Data() + size_t(y) * DestRowSize;
+            for (uint32 Index = 0; Index < DestRowSize; Index++)
+            {
+                Dest[Index] = 0.0f;
+            }
+
+            const uint32* Indices = VerticalWeights.Indices.Data() + y * VerticalWeights.NumTaps;
+            const float*  Weights = VerticalWeights.Weights.Data() + y * VerticalWeights.NumTaps;
+            for (uint32 Tap = 0; Tap < VerticalWeights.NumTaps; Tap++)
+            {
+                const float Weight = Weights[Tap];
+                if (Weight == 0.0f)
+                {
+                    continue;
+                }
+
+                const float* Row = Horizontal.Data() + size_t(Indices[Tap]) * DestRowSize;
+                for (uint32 Index = 0; Index < DestRowSize; Index++)
+                {
+                    Dest[Index] += Weight * Row[Index];
+                }
+            }
+
+            // The negative lobes of the Kaiser filter can overshoot
+            for (uint32 Index = 0; Index < DestRowSize; Index++)
+            {
+                Dest[Index] = std::min(std::max(Dest[Index], 0.0f), 1.0f);
+            }
+        }
+
+        const uint32 NumTexels = DestWidth * DestHeight;
+        if (IsNormalMap)
+        {
+            RenormalizeNormals(Current.Data(), NumTexels, NumChannels);
+        }
+
+        // The scale is only applied to the output, the next mip is filtered from the unscaled alpha
+        float AlphaScale = 1.0f;
+        if (KeepCoverage)
+        {
+            AlphaScale = FindAlphaScale(Current.Data(), NumTexels, NumChannels, Desc.AlphaCutoff, TargetCoverage);
+        }
+
+        for (uint32 Texel = 0; Texel < NumTexels; Texel++)
+        {
+            const float* Source = Current.Data() + Texel * NumChannels;
+            for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+            {
+                float Value = Source[Channel];
+                if (IsSRGB && Channel < 3)
+                {
+                    Value = LinearToSRGB(Value);
+                }
+                else if (KeepCoverage && Channel == AlphaChannel)
+                {
+                    Value *= AlphaScale;
+                }
+
+                *(OutPixels++) = QuantizeUnorm(Value);
+            }
+        }
+
+        Previous.Swap(Current);
+        SourceWidth  = DestWidth;
+        SourceHeight = DestHeight;
+    }
+
+    Assert(OutPixels == OutMips.Data() + TotalSize);
+}
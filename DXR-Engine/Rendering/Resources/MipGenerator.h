@@ -0,0 +1,52 @@
+#pragma once
+#include "Core.h"
+
+#include "Core/Containers/Array.h"
+
+// Matches the alpha test in the forward pass
+constexpr float ALPHA_MASK_CUTOFF = 0.1f;
+
+enum class EMipFilter : uint32
+{
+    Box    = 0,
+    Kaiser = 1,
+};
+
+enum EMipGeneratorFlags : uint32
+{
+    MipGeneratorFlag_None          = 0,
+    MipGeneratorFlag_SRGB          = FLAG(1), // Color channels are sRGB encoded and filtered in linear space
+    MipGeneratorFlag_NormalMap     = FLAG(2), // RGB is a normal that is renormalized in every mip
+    MipGeneratorFlag_AlphaCoverage = FLAG(3), // The last channel is scaled so that the alpha test passes as often as in the first mip
+};
+
+struct MipGeneratorDesc
+{
+    EMipFilter Filter = EMipFilter::Kaiser;
+    uint32     Flags  = MipGeneratorFlag_None;
+
+    float AlphaCutoff = ALPHA_MASK_CUTOFF;
+};
+
+/*
+* Generates the mips of an 8-bit texture with one or four channels on the CPU. Every mip is filtered from the previous
+* one in floating point, so rounding errors do not add up along the chain. The Kaiser filter is a windowed sinc that
+* keeps more detail than a box filter without aliasing.
+*/
+
+class MipGenerator
+{
+public:
+    // Size of the full mip chain of a texture, down to a size of 1x1
+    static uint32 GetNumMips(uint32 Width, uint32 Height);
+
+    // OutMips receives NumMips mips tightly packed, largest first, where the first mip is a copy of Pixels
+    static void GenerateMips(
+        const uint8* Pixels,
+        uint32 Width,
+        uint32 Height,
+        uint32 NumChannels,
+        uint32 NumMips,
+        const MipGeneratorDesc& Desc,
+        TArray<uint8>& OutMips);
+};
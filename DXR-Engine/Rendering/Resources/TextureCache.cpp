@@ -0,0 +1,132 @@
+#include "TextureCache.h"
+#include "TextureCompressor.h"
+
+#include "Core/IO/Platform/MappedFile.h"
+
+#include "Core/Threading/ThreadSafeInt.h"
+
+#include "Utilities/HashUtilities.h"
+
+#include <cstdio>
+
+// Largest width and height of a 2D texture in D3D12
+static constexpr uint32 TEXTURE_CACHE_MAX_SIZE = 16384;
+
+// The formats that a texture can be cooked to, which are the block compressed formats and the uncompressed formats
+// that are used when the size of the image is not a multiple of the block size
+static bool IsCookedFormat(EFormat Format)
+{
+    return TextureCompressor::IsSupportedFormat(Format) ||
+        Format == EFormat::R8_Unorm ||
+        Format == EFormat::R8G8B8A8_Unorm ||
+        Format == EFormat::R8G8B8A8_Unorm_SRGB;
+}
+
+bool TextureCache::Read(const std::string& Filename, uint64 SourceHash, CookedTexture& OutTexture)
+{
+    MappedFile File;
+    if (!File.Open(Filename))
+    {
+        return false;
+    }
+
+    const uint64 FileSize = File.GetSize();
+    if (FileSize < sizeof(TextureCacheHeader))
+    {
+        return false;
+    }
+
+    const TextureCacheHeader* Header = reinterpret_cast<const TextureCacheHeader*>(File.GetData());
+    if (Header->Magic != TEXTURE_CACHE_MAGIC || Header->Version != TEXTURE_CACHE_VERSION || Header->SourceHash != SourceHash)
+    {
+        return false;
+    }
+
+    // A file that was not completely written has the wrong size
+    if (Header->FileSize != FileSize || Header->Width == 0 || Header->Height == 0 || Header->NumMips == 0 || Header->NumMips > 16)
+    {
+        return false;
+    }
+
+    // The size of the mips depends on the format and the dimensions, so they are checked before the size is calculated
+    if (!IsCookedFormat(EFormat(Header->Format)) || Header->Width > TEXTURE_CACHE_MAX_SIZE || Header->Height > TEXTURE_CACHE_MAX_SIZE)
+    {
+        return false;
+    }
+
+    CookedTexture Texture;
+    Texture.Format  = EFormat(Header->Format);
+    Texture.Width   = Header->Width;
+    Texture.Height  = Header->Height;
+    Texture.NumMips = Header->NumMips;
+
+    const uint64 DataSize = Texture.GetSize();
+    if (DataSize == 0 || sizeof(TextureCacheHeader) + DataSize != FileSize)
+    {
+        return false;
+    }
+
+    const uint8* Data = reinterpret_cast<const uint8*>(File.GetData()) + sizeof(TextureCacheHeader);
+    Texture.Data = TArray<uint8>(Data, Data + DataSize);
+
+    OutTexture = Move(Texture);
+    return true;
+}
+
+bool TextureCache::Write(const std::string& Filename, uint64 SourceHash, const CookedTexture& Texture)
+{
+    TextureCacheHeader Header;
+    Header.Magic      = TEXTURE_CACHE_MAGIC;
+    Header.Version    = TEXTURE_CACHE_VERSION;
+    Header.SourceHash = SourceHash;
+    Header.FileSize   = sizeof(TextureCacheHeader) + Texture.Data.SizeInBytes();
+    Header.Format     = uint32(Texture.Format);
+    Header.Width      = Texture.Width;
+    Header.Height     = Texture.Height;
+    Header.NumMips    = Texture.NumMips;
+
+    Assert(Texture.Data.SizeInBytes() == Texture.GetSize());
+
+    // Write to a temporary file first, so that a crash never leaves a damaged cache behind. The temporary file is unique,
+    // since two workers can cook the same texture at the same time.
+    static ThreadSafeInt32 NumWrites(0);
+    const std::string TempFilename = Filename + '.' + std::to_string(NumWrites.Increment()) + ".tmp";
+    FILE* File = fopen(TempFilename.c_str(), "wb");
+    if (!File)
+    {
+        LOG_ERROR("[TextureCache]: Failed to open '" + TempFilename + "' for writing");
+        return false;
+    }
+
+    bool Result =
+        fwrite(&Header, sizeof(TextureCacheHeader), 1, File) == 1 &&
+        fwrite(Texture.Data.Data(), 1, Texture.Data.SizeInBytes(), File) == Texture.Data.SizeInBytes();
+
+    Result = (fclose(File) == 0) && Result;
+    if (!Result)
+    {
+        LOG_ERROR("[TextureCache]: Failed to write '" + TempFilename + "'");
+        remove(TempFilename.c_str());
+        return false;
+    }
+
+    remove(Filename.c_str());
+    if (rename(TempFilename.c_str(), Filename.c_str()) != 0)
+    {
+        LOG_ERROR("[TextureCache]: Failed to rename '" + TempFilename + "' to '" + Filename + "'");
+        remove(TempFilename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+uint64 TextureCache::HashSource(const void* SourceData, uint64 SourceSize, EFormat Format, uint32 CreateFlags)
+{
+    // The same image is cooked differently with other settings
+    const uint32 Settings[] = { TEXTURE_CACHE_VERSION, uint32(Format), CreateFlags };
+    StreamHasher Hasher;
+    Hasher.Update(Settings, sizeof(Settings));
+    Hasher.Update(SourceData, size_t(SourceSize));
+    return Hasher.GetHash();
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "RenderLayer/RenderingCore.h"
+
+#include "Core/Containers/Array.h"
+
+constexpr uint32 TEXTURE_CACHE_MAGIC   = 0x54435844; // "DXCT"
+constexpr uint32 TEXTURE_CACHE_VERSION = 2;
+
+// Appended to the path of the source image
+constexpr const char* TEXTURE_CACHE_EXTENSION = ".cooked";
+
+// A texture with all its mips in one allocation, the largest mip first and every mip tightly packed
+struct CookedTexture
+{
+    uint32 GetMipWidth(uint32 Mip) const { return std::max(Width >> Mip, 1u); }
+    uint32 GetMipHeight(uint32 Mip) const { return std::max(Height >> Mip, 1u); }
+
+    uint32 GetMipSize(uint32 Mip) const
+    {
+        return GetRowPitchFromFormat(Format, GetMipWidth(Mip)) * GetNumRowsFromFormat(Format, GetMipHeight(Mip));
+    }
+
+    uint64 GetMipOffset(uint32 Mip) const
+    {
+        uint64 Offset = 0;
+        for (uint32 Index = 0; Index < Mip; Index++)
+        {
+            Offset += GetMipSize(Index);
+        }
+
+        return Offset;
+    }
+
+    uint64 GetSize() const { return GetMipOffset(NumMips); }
+
+    const uint8* GetMipData(uint32 Mip) const { return Data.Data() + GetMipOffset(Mip); }
+
+    EFormat Format  = EFormat::Unknown;
+    uint32  Width   = 0;
+    uint32  Height  = 0;
+    uint32  NumMips = 0;
+
+    TArray<uint8> Data;
+};
+
+struct TextureCacheHeader
+{
+    uint32 Magic;
+    uint32 Version;
+    uint64 SourceHash;
+    uint64 FileSize;
+
+    uint32 Format;
+    uint32 Width;
+    uint32 Height;
+    uint32 NumMips;
+};
+
+static_assert(sizeof(TextureCacheHeader) == 40, "TextureCacheHeader must not have any padding");
+
+/*
+* Cooked textures are stored next to their source image, as a header followed by the mips. The cache stores a hash of
+* the source image and of the settings it was cooked with, and is not used when either has changed.
+*/
+
+class TextureCache
+{
+public:
+    // Returns false if the file does not exist, is damaged, or was cooked from another version of the source
+    static bool Read(const std::string& Filename, uint64 SourceHash, CookedTexture& OutTexture);
+    static bool Write(const std::string& Filename, uint64 SourceHash, const CookedTexture& Texture);
+
+    static uint64 HashSource(const void* SourceData, uint64 SourceSize, EFormat Format, uint32 CreateFlags);
+};
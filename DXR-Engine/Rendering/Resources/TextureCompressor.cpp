@@ -0,0 +1,601 @@
+#include "TextureCompressor.h"
+
+#include <cmath>
+
+constexpr uint32 BLOCK_DIMENSION = 4;
+constexpr uint32 BLOCK_TEXELS    = BLOCK_DIMENSION * BLOCK_DIMENSION;
+
+// Iterations used to find the principal axis of the colors in a block, converges well before this for 16 texels
+constexpr uint32 POWER_ITERATIONS = 8;
+
+// BC7 interpolation weights for 4-bit indices
+static const int32 GBC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Writes the fields of a block starting at the least significant bit, the block has to be zeroed first
+struct BlockBitWriter
+{
+    BlockBitWriter(uint8* InBlock)
+        : Block(InBlock)
+        , Bit(0)
+    {
+    }
+
+    void Write(uint32 Value, uint32 NumBits)
+    {
+        for (uint32 Index = 0; Index < NumBits; Index++, Bit++)
+        {
+            if ((Value >> Index) & 1)
+            {
+                Block[Bit >> 3] |= uint8(1 << (Bit & 7));
+            }
+        }
+    }
+
+    uint8* Block;
+    uint32 Bit;
+};
+
+// Texels of one block, texels outside of the image are clamped to the edge
+static void LoadBlock(const uint8* Pixels, uint32 Width, uint32 Height, uint32 NumChannels, uint32 BlockX, uint32 BlockY, uint8* OutTexels)
+{
+    for (uint32 y = 0; y < BLOCK_DIMENSION; y++)
+    {
+        const uint32 SourceY = std::min(BlockY * BLOCK_DIMENSION + y, Height - 1);
+        for (uint32 x = 0; x < BLOCK_DIMENSION; x++)
+        {
+            const uint32 SourceX = std::min(BlockX * BLOCK_DIMENSION + x, Width - 1);
+            const uint8* Source  = Pixels + (size_t(SourceY) * Width + SourceX) * NumChannels;
+            for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+            {
+                *(OutTexels++) = Source[Channel];
+            }
+        }
+    }
+}
+
+template<typename TEncodeBlock>
+static void CompressBlocks(const uint8* Pixels, uint32 Width, uint32 Height, uint32 NumChannels, uint32 BlockSize, uint8* OutBlocks, TEncodeBlock EncodeBlock)
+{
+    const uint32 NumBlocksX = (Width + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+    const uint32 NumBlocksY = (Height + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+
+    uint8 Texels[BLOCK_TEXELS * 4];
+    for (uint32 BlockY = 0; BlockY < NumBlocksY; BlockY++)
+    {
+        for (uint32 BlockX = 0; BlockX < NumBlocksX; BlockX++)
+        {
+            LoadBlock(Pixels, Width, Height, NumChannels, BlockX, BlockY, Texels);
+            EncodeBlock(Texels, OutBlocks);
+            OutBlocks += BlockSize;
+        }
+    }
+}
+
+// Finds the line through the texels that fits them best, returns the two ends of the texels along it
+template<uint32 NumChannels>
+static void FindEndpoints(const uint8* Texels, float OutMin[NumChannels], float OutMax[NumChannels])
+{
+    float Mean[NumChannels] = { };
+    for (uint32 Texel = 0; Texel < BLOCK_TEXELS; Texel++)
+    {
+        for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+        {
+            Mean[Channel] += float(Texels[Texel * 4 + Channel]);
+        }
+    }
+
+    for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+    {
+        Mean[Channel] /= float(BLOCK_TEXELS);
+    }
+
+    float Covariance[NumChannels][NumChannels] = { };
+    for (uint32 Texel = 0; Texel < BLOCK_TEXELS; Texel++)
+    {
+        float Delta[NumChannels];
+        for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+        {
+            Delta[Channel] = float(Texels[Texel * 4 + Channel]) - Mean[Channel];
+        }
+
+        for (uint32 Row = 0; Row < NumChannels; Row++)
+        {
+            for (uint32 Column = 0; Column < NumChannels; Column++)
+            {
+                Covariance[Row][Column] += Delta[Row] * Delta[Column];
+            }
+        }
+    }
+
+    // The principal axis is the eigenvector with the largest eigenvalue
+    float Axis[NumChannels];
+    for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+    {
+        Axis[Channel] = 1.0f;
+    }
+
+    for (uint32 Iteration = 0; Iteration < POWER_ITERATIONS; Iteration++)
+    {
+        float NewAxis[NumChannels] = { };
+        float Length = 0.0f;
+        for (uint32 Row = 0; Row < NumChannels; Row++)
+        {
+            for (uint32 Column = 0; Column < NumChannels; Column++)
+            {
+                NewAxis[Row] += Covariance[Row][Column] * Axis[Column];
+            }
+
+            Length = std::max(Length, std::abs(NewAxis[Row]));
+        }
+
+        // All texels are equal
+        if (Length < 1e-6f)
+        {
+            break;
+        }
+
+        for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+        {
+            Axis[Channel] = NewAxis[Channel] / Length;
+        }
+    }
+
+    float LengthSquared = 0.0f;
+    for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+    {
+        LengthSquared += Axis[Channel] * Axis[Channel];
+    }
+
+    float MinT = 0.0f;
+    float MaxT = 0.0f;
+    for (uint32 Texel = 0; Texel < BLOCK_TEXELS; Texel++)
+    {
+        float T = 0.0f;
+        for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+        {
+            T += (float(Texels[Texel * 4 + Channel]) - Mean[Channel]) * Axis[Channel];
+        }
+
+        T /= LengthSquared;
+        MinT = std::min(MinT, T);
+        MaxT = std::max(MaxT, T);
+    }
+
+    for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+    {
+        OutMin[Channel] = std::min(std::max(Mean[Channel] + Axis[Channel] * MinT, 0.0f), 255.0f);
+        OutMax[Channel] = std::min(std::max(Mean[Channel] + Axis[Channel] * MaxT, 0.0f), 255.0f);
+    }
+}
+
+template<uint32 NumChannels>
+static int32 SquaredDistance(const uint8* Texel, const int32* Color)
+{
+    int32 Distance = 0;
+    for (uint32 Channel = 0; Channel < NumChannels; Channel++)
+    {
+        const int32 Delta = int32(Texel[Channel]) - Color[Channel];
+        Distance += Delta * Delta;
+    }
+
+    return Distance;
+}
+
+/*
+* BC1
+*/
+
+static uint16 PackRGB565(const float Color[3])
+{
+    const uint32 R = uint32(std::lround(Color[0] * (31.0f / 255.0f)));
+    const uint32 G = uint32(std::lround(Color[1] * (63.0f / 255.0f)));
+    const uint32 B = uint32(std::lround(Color[2] * (31.0f / 255.0f)));
+    return uint16((R << 11) | (G << 5) | B);
+}
+
+static void UnpackRGB565(uint16 Packed, int32 OutColor[3])
+{
+    const int32 R = (Packed >> 11) & 31;
+    const int32 G = (Packed >> 5) & 63;
+    const int32 B = Packed & 31;
+    OutColor[0] = (R << 3) | (R >> 2);
+    OutColor[1] = (G << 2) | (G >> 4);
+    OutColor[2] = (B << 3) | (B >> 2);
+}
+
+static void EncodeBC1Block(const uint8* Texels, uint8* OutBlock)
+{
+    float Min[3];
+    float Max[3];
+    FindEndpoints<3>(Texels, Min, Max);
+
+    // Moving the ends inwards a little lowers the average error, since the texels at the ends are rare
+    for (uint32 Channel = 0; Channel < 3; Channel++)
+    {
+        const float Inset = (Max[Channel] - Min[Channel]) / 16.0f;
+        Min[Channel] += Inset;
+        Max[Channel] -= Inset;
+    }
+
+    uint16 Color0 = PackRGB565(Max);
+    uint16 Color1 = PackRGB565(Min);
+
+    // Color0 > Color1 selects the four color mode, without the transparent index
+    if (Color0 < Color1)
+    {
+        std::swap(Color0, Color1);
+    }
+
+    uint32 Indices = 0;
+    if (Color0 != Color1)
+    {
+        int32 Palette[4][3];
+        UnpackRGB565(Color0, Palette[0]);
+        UnpackRGB565(Color1, Palette[1]);
+        for (uint32 Channel = 0; Channel < 3; Channel++)
+        {
+            Palette[2][Channel] = (2 * Palette[0][Channel] + Palette[1][Channel]) / 3;
+            Palette[3][Channel] = (Palette[0][Channel] + 2 * Palette[1][Channel]) / 3;
+        }
+
+        for (uint32 Texel = 0; Texel < BLOCK_TEXELS; Texel++)
+        {
+            uint32 BestIndex    = 0;
+            int32  BestDistance = INT32_MAX;
+            for (uint32 Index = 0; Index < 4; Index++)
+            {
+                const int32 Distance = SquaredDistance<3>(Texels + Texel * 4, Palette[Index]);
+                if (Distance < BestDistance)
+                {
+                    BestDistance = Distance;
+                    BestIndex    = Index;
+                }
+            }
+
+            Indices |= BestIndex << (Texel * 2);
+        }
+    }
+
+    OutBlock[0] = uint8(Color0 & 0xff);
+    OutBlock[1] = uint8(Color0 >> 8);
+    OutBlock[2] = uint8(Color1 & 0xff);
+    OutBlock[3] = uint8(Color1 >> 8);
+    OutBlock[4] = uint8(Indices & 0xff);
+    OutBlock[5] = uint8((Indices >> 8) & 0xff);
+    OutBlock[6] = uint8((Indices >> 16) & 0xff);
+    OutBlock[7] = uint8(Indices >> 24);
+}
+
+/*
+* BC4
+*/
+
+// Values is 16 bytes, one channel
+static void EncodeBC4Block(const uint8* Values, uint8* OutBlock)
+{
+    int32 Min = 255;
+    int32 Max = 0;
+    for (uint32 Texel = 0; Texel < BLOCK_TEXELS; Texel++)
+    {
+        Min = std::min<int32>(Min, Values[Texel]);
+        Max = std::max<int32>(Max, Values[Texel]);
+    }
+
+    // Red0 > Red1 selects the mode with six interpolated values
+    OutBlock[0] = uint8(Max);
+    OutBlock[1] = uint8(Min);
+
+    uint64 Indices = 0;
+    if (Max != Min)
+    {
+        int32 Palette[8];
+        Palette[0] = Max;
+        Palette[1] = Min;
+        for (int32 Index = 1; Index < 7; Index++)
+        {
+            Palette[Index + 1] = ((7 - Index) * Max + Index * Min) / 7;
+        }
+
+        for (uint32 Texel = 0; Texel < BLOCK_TEXELS; Texel++)
+        {
+            uint64 BestIndex    = 0;
+            int32  BestDistance = INT32_MAX;
+            for (uint32 Index = 0; Index < 8; Index++)
+            {
+                const int32 Distance = std::abs(int32(Values[Texel]) - Palette[Index]);
+                if (Distance < BestDistance)
+                {
+                    BestDistance = Distance;
+                    BestIndex    = Index;
+                }
+            }
+
+            Indices |= BestIndex << (Texel * 3);
+        }
+    }
+
+    for (uint32 Byte = 0; Byte < 6; Byte++)
+    {
+        OutBlock[2 + Byte] = uint8((Indices >> (Byte * 8)) & 0xff);
+    }
+}
+
+/*
+* BC7, encoded with mode 6 only. It has a single subset with 7-bit RGBA endpoints, a p-bit per endpoint and 4-bit
+* indices, which is a good fit for most albedo textures.
+*/
+
+static void QuantizeBC7Endpoint(const float Color[4], int32 OutQuantized[4], uint32& OutPBit)
+{
+    int32 BestError = INT32_MAX;
+    for (uint32 PBit = 0; PBit < 2; PBit++)
+    {
+        int32 Quantized[4];
+        int32 Error = 0;
+        for (uint32 Channel = 0; Channel < 4; Channel++)
+        {
+            Quantized[Channel] = std::min(std::max(int32(std::lround((Color[Channel] - float(PBit)) / 2.0f)), 0), 127);
+
+            const int32 Delta = ((Quantized[Channel] << 1) | int32(PBit)) - int32(std::lround(Color[Channel]));
+            Error += Delta * Delta;
+        }
+
+        if (Error < BestError)
+        {
+            BestError = Error;
+            OutPBit   = PBit;
+            for (uint32 Channel = 0; Channel < 4; Channel++)
+            {
+                OutQuantized[Channel] = Quantized[Channel];
+            }
+        }
+    }
+}
+
+struct BC7Mode6Block
+{
+    int32  Endpoints[2][4];
+    uint32 PBits[2];
+    uint8  Indices[BLOCK_TEXELS];
+    int32  Error;
+};
+
+static void FindBC7Indices(const uint8* Texels, BC7Mode6Block& Block)
+{
+    int32 Colors[2][4];
+    for (uint32 Endpoint = 0; Endpoint < 2; Endpoint++)
+    {
+        for (uint32 Channel = 0; Channel < 4; Channel++)
+        {
+            Colors[Endpoint][Channel] = (Block.Endpoints[Endpoint][Channel] << 1) | int32(Block.PBits[Endpoint]);
+        }
+    }
+
+    int32 Palette[16][4];
+    for (uint32 Index = 0; Index < 16; Index++)
+    {
+        const int32 Weight = GBC7Weights4[Index];
+        for (uint32 Channel = 0; Channel < 4; Channel++)
+        {
+            Palette[Index][Channel] = ((64 - Weight) * Colors[0][Channel] + Weight * Colors[1][Channel] + 32) >> 6;
+        }
+    }
+
+    Block.Error = 0;
+    for (uint32 Texel = 0; Texel < BLOCK_TEXELS; Texel++)
+    {
+        uint8 BestIndex    = 0;
+        int32 BestDistance = INT32_MAX;
+        for (uint32 Index = 0; Index < 16; Index++)
+        {
+            const int32 Distance = SquaredDistance<4>(Texels + Texel * 4, Palette[Index]);
+            if (Distance < BestDistance)
+            {
+                BestDistance = Distance;
+                BestIndex    = uint8(Index);
+            }
+        }
+
+        Block.Indices[Texel] = BestIndex;
+        Block.Error += BestDistance;
+    }
+}
+
+static void FitBC7Block(const uint8* Texels, const float Endpoint0[4], const float Endpoint1[4], BC7Mode6Block& OutBlock)
+{
+    QuantizeBC7Endpoint(Endpoint0, OutBlock.Endpoints[0], OutBlock.PBits[0]);
+    QuantizeBC7Endpoint(Endpoint1, OutBlock.Endpoints[1], OutBlock.PBits[1]);
+    FindBC7Indices(Texels, OutBlock);
+}
+
+// Least squares fit of the endpoints to the texels with the indices of the block kept fixed
+static bool RefineBC7Endpoints(const uint8* Texels, const BC7Mode6Block& Block, float OutEndpoint0[4], float OutEndpoint1[4])
+{
+    float A = 0.0f;
+    float B = 0.0f;
+    float C = 0.0f;
+    float X0[4] = { };
+    float X1[4] = { };
+    for (uint32 Texel = 0; Texel < BLOCK_TEXELS; Texel++)
+    {
+        const float Weight  = float(GBC7Weights4[Block.Indices[Texel]]) / 64.0f;
+        const float Inverse = 1.0f - Weight;
+        A += Inverse * Inverse;
+        B += Inverse * Weight;
+        C += Weight * Weight;
+
+        for (uint32 Channel = 0; Channel < 4; Channel++)
+        {
+            const float Value = float(Texels[Texel * 4 + Channel]);
+            X0[Channel] += Inverse * Value;
+            X1[Channel] += Weight * Value;
+        }
+    }
+
+    // All texels use the same index
+    const float Determinant = A * C - B * B;
+    if (std::abs(Determinant) < 1e-6f)
+    {
+        return false;
+    }
+
+    for (uint32 Channel = 0; Channel < 4; Channel++)
+    {
+        OutEndpoint0[Channel] = std::min(std::max((C * X0[Channel] - B * X1[Channel]) / Determinant, 0.0f), 255.0f);
+        OutEndpoint1[Channel] = std::min(std::max((A * X1[Channel] - B * X0[Channel]) / Determinant, 0.0f), 255.0f);
+    }
+
+    return true;
+}
+
+static void EncodeBC7Block(const uint8* Texels, uint8* OutBlock)
+{
+    float Min[4];
+    float Max[4];
+    FindEndpoints<4>(Texels, Min, Max);
+
+    BC7Mode6Block Block;
+    FitBC7Block(Texels, Min, Max, Block);
+
+    float Refined0[4];
+    float Refined1[4];
+    if (Block.Error > 0 && RefineBC7Endpoints(Texels, Block, Refined0, Refined1))
+    {
+        BC7Mode6Block RefinedBlock;
+        FitBC7Block(Texels, Refined0, Refined1, RefinedBlock);
+        if (RefinedBlock.Error < Block.Error)
+        {
+            Block = RefinedBlock;
+        }
+    }
+
+    // The most significant bit of the first index is implied to be zero
+    if (Block.Indices[0] >= 8)
+    {
+        for (uint32 Channel = 0; Channel < 4; Channel++)
+        {
+            std::swap(Block.Endpoints[0][Channel], Block.Endpoints[1][Channel]);
+        }
+
+        std::swap(Block.PBits[0], Block.PBits[1]);
+        for (uint32 Texel = 0; Texel < BLOCK_TEXELS; Texel++)
+        {
+            Block.Indices[Texel] = uint8(15 - Block.Indices[Texel]);
+        }
+    }
+
+    memset(OutBlock, 0, 16);
+
+    // Mode 6 is a one in bit 6
+    BlockBitWriter Writer(OutBlock);
+    Writer.Write(1 << 6, 7);
+
+    for (uint32 Channel = 0; Channel < 4; Channel++)
+    {
+        Writer.Write(uint32(Block.Endpoints[0][Channel]), 7);
+        Writer.Write(uint32(Block.Endpoints[1][Channel]), 7);
+    }
+
+    Writer.Write(Block.PBits[0], 1);
+    Writer.Write(Block.PBits[1], 1);
+
+    Writer.Write(Block.Indices[0], 3);
+    for (uint32 Texel = 1; Texel < BLOCK_TEXELS; Texel++)
+    {
+        Writer.Write(Block.Indices[Texel], 4);
+    }
+
+    Assert(Writer.Bit == 128);
+}
+
+/*
+* TextureCompressor
+*/
+
+bool TextureCompressor::IsSupportedFormat(EFormat Format)
+{
+    return Format == EFormat::BC1_Unorm || Format == EFormat::BC1_Unorm_SRGB ||
+        Format == EFormat::BC4_Unorm ||
+        Format == EFormat::BC5_Unorm ||
+        Format == EFormat::BC7_Unorm || Format == EFormat::BC7_Unorm_SRGB;
+}
+
+uint32 TextureCompressor::GetNumSourceChannels(EFormat Format)
+{
+    return (Format == EFormat::BC4_Unorm) ? 1 : 4;
+}
+
+uint32 TextureCompressor::GetCompressedSize(EFormat Format, uint32 Width, uint32 Height)
+{
+    return GetRowPitchFromFormat(Format, Width) * GetNumRowsFromFormat(Format, Height);
+}
+
+bool TextureCompressor::Compress(const uint8* Pixels, uint32 Width, uint32 Height, EFormat Format, uint8* OutBlocks)
+{
+    switch (Format)
+    {
+        case EFormat::BC1_Unorm:
+        case EFormat::BC1_Unorm_SRGB:
+        {
+            CompressBC1(Pixels, Width, Height, OutBlocks);
+            return true;
+        }
+
+        case EFormat::BC4_Unorm:
+        {
+            CompressBC4(Pixels, Width, Height, OutBlocks);
+            return true;
+        }
+
+        case EFormat::BC5_Unorm:
+        {
+            CompressBC5(Pixels, Width, Height, OutBlocks);
+            return true;
+        }
+
+        case EFormat::BC7_Unorm:
+        case EFormat::BC7_Unorm_SRGB:
+        {
+            CompressBC7(Pixels, Width, Height, OutBlocks);
+            return true;
+        }
+
+        default:
+        {
+            LOG_ERROR("[TextureCompressor]: Format '" + std::string(ToString(Format)) + "' is not supported");
+            return false;
+        }
+    }
+}
+
+void TextureCompressor::CompressBC1(const uint8* Pixels, uint32 Width, uint32 Height, uint8* OutBlocks)
+{
+    CompressBlocks(Pixels, Width, Height, 4, 8, OutBlocks, EncodeBC1Block);
+}
+
+void TextureCompressor::CompressBC4(const uint8* Pixels, uint32 Width, uint32 Height, uint8* OutBlocks)
+{
+    CompressBlocks(Pixels, Width, Height, 1, 8, OutBlocks, EncodeBC4Block);
+}
+
+void TextureCompressor::CompressBC5(const uint8* Pixels, uint32 Width, uint32 Height, uint8* OutBlocks)
+{
+    CompressBlocks(Pixels, Width, Height, 4, 16, OutBlocks, [](const uint8* Texels, uint8* OutBlock)
+    {
+        uint8 Red[BLOCK_TEXELS];
+        uint8 Green[BLOCK_TEXELS];
+        for (uint32 Texel = 0; Texel < BLOCK_TEXELS; Texel++)
+        {
+            Red[Texel]   = Texels[Texel * 4 + 0];
+            Green[Texel] = Texels[Texel * 4 + 1];
+        }
+
+        EncodeBC4Block(Red, OutBlock);
+        EncodeBC4Block(Green, OutBlock + 8);
+    });
+}
+
+void TextureCompressor::CompressBC7(const uint8* Pixels, uint32 Width, uint32 Height, uint8* OutBlocks)
+{
+    CompressBlocks(Pixels, Width, Height, 4, 16, OutBlocks, EncodeBC7Block);
+}
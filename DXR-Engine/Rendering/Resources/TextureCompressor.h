@@ -0,0 +1,28 @@
+#pragma once
+#include "RenderLayer/RenderingCore.h"
+
+/*
+* CPU encoder for the block compressed formats. Every block of 4x4 texels is encoded on its own, so a texture can be
+* split between threads at any block row. Texels outside a mip that is not a multiple of four are clamped to the edge.
+*
+* The source is R8G8B8A8 for BC1, BC5 and BC7, where BC5 stores the red and green channel, and R8 for BC4.
+*/
+
+class TextureCompressor
+{
+public:
+    static bool IsSupportedFormat(EFormat Format);
+
+    // Number of channels that the source pixels of a format have
+    static uint32 GetNumSourceChannels(EFormat Format);
+
+    static uint32 GetCompressedSize(EFormat Format, uint32 Width, uint32 Height);
+
+    // OutBlocks must be GetCompressedSize bytes, the blocks are stored row by row
+    static bool Compress(const uint8* Pixels, uint32 Width, uint32 Height, EFormat Format, uint8* OutBlocks);
+
+    static void CompressBC1(const uint8* Pixels, uint32 Width, uint32 Height, uint8* OutBlocks);
+    static void CompressBC4(const uint8* Pixels, uint32 Width, uint32 Height, uint8* OutBlocks);
+    static void CompressBC5(const uint8* Pixels, uint32 Width, uint32 Height, uint8* OutBlocks);
+    static void CompressBC7(const uint8* Pixels, uint32 Width, uint32 Height, uint8* OutBlocks);
+};
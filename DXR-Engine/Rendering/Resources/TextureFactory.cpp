@@ -1,24 +1,59 @@
 #include "TextureFactory.h"
+#include "TextureCompressor.h"
+#include "TextureCache.h"
+#include "MipGenerator.h"
 
 #include "RenderLayer/CommandList.h"
 #include "RenderLayer/PipelineState.h"
 #include "RenderLayer/RenderLayer.h"
 #include "RenderLayer/ShaderCompiler.h"
 
+#include "Core/Threading/TaskManager.h"
+#include "Core/Threading/ScopedLock.h"
+#include "Core/Threading/Platform/PlatformProcess.h"
+
+#include "Core/IO/Platform/MappedFile.h"
+
+#include "Debug/Profiler.h"
+
 #ifdef min
     #undef min
 #endif
 
 #include <algorithm>
+#include <cstdio>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+struct AsyncTextureLoad
+{
+    std::string Filepath;
+    uint32  CreateFlags = 0;
+    EFormat Format      = EFormat::Unknown;
+    TextureLoadedDelegate OnLoaded;
+
+    // Written by the worker that decodes the image, nullptr if decoding failed
+    TUniquePtr<uint8> Pixels;
+    int32 Width  = 0;
+    int32 Height = 0;
+
+    // Used instead of the pixels for formats that are cooked on the CPU, NumMips is zero if loading failed
+    CookedTexture Cooked;
+};
+
 struct TextureFactoryData
 {
     TRef<ComputePipelineState> PanoramaPSO;
     TRef<ComputeShader>        ComputeShader;
     CommandList CmdList;
+
+    // Loads that have been decoded and are waiting for Tick
+    TArray<AsyncTextureLoad*> DecodedLoads;
+    Mutex DecodedLoadsMutex;
+
+    // Loads that have been started but not yet finished by Tick
+    ThreadSafeInt32 NumPendingLoads;
 };
 
 static TextureFactoryData GlobalFactoryData;
@@ -53,61 +88,112 @@ bool TextureFactory::Init()
 
 void TextureFactory::Release()
 {
+    // Wait for the workers that are still decoding, the textures are never created
+    while (GlobalFactoryData.NumPendingLoads.Load() > 0)
+    {
+        {
+            TScopedLock<Mutex> Lock(GlobalFactoryData.DecodedLoadsMutex);
+            for (AsyncTextureLoad* Load : GlobalFactoryData.DecodedLoads)
+            {
+                SafeDelete(Load);
+                GlobalFactoryData.NumPendingLoads.Decrement();
+            }
+
+            GlobalFactoryData.DecodedLoads.Clear();
+        }
+
+        PlatformProcess::Sleep(0);
+    }
+
     GlobalFactoryData.PanoramaPSO.Reset();
     GlobalFactoryData.ComputeShader.Reset();
 }
 
-Texture2D* TextureFactory::LoadFromFile(const std::string& Filepath, uint32 CreateFlags, EFormat Format)
+static bool IsSupportedFormat(EFormat Format)
+{
+    return Format == EFormat::R8_Unorm || Format == EFormat::R8G8B8A8_Unorm || Format == EFormat::R32G32B32A32_Float || TextureCompressor::IsSupportedFormat(Format);
+}
+
+static uint32 GetNumMips(uint32 Width, uint32 Height, uint32 CreateFlags)
+{
+    const bool GenerateMips = CreateFlags & ETextureFactoryFlags::TextureFactoryFlag_GenerateMips;
+    return GenerateMips ? uint32(std::min(std::log2(Width), std::log2(Height))) : 1;
+}
+
+// Index of the channel that a single channel format is read from, or -1 when it is the luminance of the image
+static int32 GetSourceChannel(uint32 CreateFlags)
+{
+    if (CreateFlags & TextureFactoryFlag_ChannelR)
+    {
+        return 0;
+    }
+    else if (CreateFlags & TextureFactoryFlag_ChannelG)
+    {
+        return 1;
+    }
+    else if (CreateFlags & TextureFactoryFlag_ChannelB)
+    {
+        return 2;
+    }
+    else if (CreateFlags & TextureFactoryFlag_ChannelA)
+    {
+        return 3;
+    }
+    
+    return -1;
+}
+
+// Turns pixels that were loaded with four channels into single channel pixels in place
+static void SelectChannel(uint8* Pixels, uint32 NumPixels, int32 Channel)
+{
+    for (uint32 i = 0; i < NumPixels; i++)
+    {
+        Pixels[i] = Pixels[i * 4 + Channel];
+    }
+}
+
+// Thread safe, the caller owns the returned pixels
+static uint8* DecodeImage(const std::string& Filepath, EFormat Format, uint32 CreateFlags, int32& OutWidth, int32& OutHeight)
 {
-    int32 Width        = 0;
-    int32 Height       = 0;
     int32 ChannelCount = 0;
 
     // Load based on format
-    TUniquePtr<uint8> Pixels;
+    uint8* Pixels = nullptr;
     if (Format == EFormat::R8G8B8A8_Unorm)
     {
-        Pixels = TUniquePtr<uint8>(stbi_load(Filepath.c_str(), &Width, &Height, &ChannelCount, 4));
+        Pixels = stbi_load(Filepath.c_str(), &OutWidth, &OutHeight, &ChannelCount, 4);
     }
     else if (Format == EFormat::R8_Unorm)
     {
-        Pixels = TUniquePtr<uint8>(stbi_load(Filepath.c_str(), &Width, &Height, &ChannelCount, 1));
+        const int32 SourceChannel = GetSourceChannel(CreateFlags);
+        Pixels = stbi_load(Filepath.c_str(), &OutWidth, &OutHeight, &ChannelCount, SourceChannel >= 0 ? 4 : 1);
+        if (Pixels && SourceChannel >= 0)
+        {
+            SelectChannel(Pixels, uint32(OutWidth * OutHeight), SourceChannel);
+        }
     }
     else if (Format == EFormat::R32G32B32A32_Float)
     {
-        Pixels = TUniquePtr<uint8>(reinterpret_cast<uint8*>(stbi_loadf(Filepath.c_str(), &Width, &Height, &ChannelCount, 4)));
-    }
-    else
-    {
-        LOG_ERROR("[TextureFactory]: Format not supported");
-        return nullptr;
+        Pixels = reinterpret_cast<uint8*>(stbi_loadf(Filepath.c_str(), &OutWidth, &OutHeight, &ChannelCount, 4));
     }
 
     // Check if succeeded
     if (!Pixels)
     {
         LOG_ERROR("[TextureFactory]: Failed to load image '" + Filepath + "'");
-        return nullptr;
     }
     else
     {
         LOG_INFO("[TextureFactory]: Loaded image '" + Filepath + "'");
     }
 
-    return LoadFromMemory(Pixels.Get(), Width, Height, CreateFlags, Format);
+    return Pixels;
 }
 
-Texture2D* TextureFactory::LoadFromMemory(const uint8* Pixels, uint32 Width, uint32 Height, uint32 CreateFlags, EFormat Format)
+// Creates the texture with the pixels in the first mip, the rest of the mips are generated by RecordGenerateMips
+static Texture2D* CreateTextureFromPixels(const uint8* Pixels, uint32 Width, uint32 Height, uint32 CreateFlags, EFormat Format)
 {
-    if (Format != EFormat::R8_Unorm && Format != EFormat::R8G8B8A8_Unorm && Format != EFormat::R32G32B32A32_Float)
-    {
-        LOG_ERROR("[TextureFactory]: Format not supported");
-        return nullptr;
-    }
-
-    const bool GenerateMips = CreateFlags & ETextureFactoryFlags::TextureFactoryFlag_GenerateMips;
-    const uint32 NumMips    = GenerateMips ? uint32(std::min(std::log2(Width), std::log2(Height))) : 1;
-
+    const uint32 NumMips = GetNumMips(Width, Height, CreateFlags);
     Assert(NumMips != 0);
 
     const uint32 Stride   = GetByteStrideFromFormat(Format);
@@ -123,13 +209,252 @@ Texture2D* TextureFactory::LoadFromMemory(const uint8* Pixels, uint32 Width, uin
         return nullptr;
     }
 
-    if (GenerateMips)
+    return Texture.ReleaseOwnership();
+}
+
+static void RecordGenerateMips(CommandList& CmdList, Texture2D* Texture)
+{
+    CmdList.TransitionTexture(Texture, EResourceState::CopyDest);
+    CmdList.GenerateMips(Texture);
+    CmdList.TransitionTexture(Texture, EResourceState::PixelShaderResource);
+}
+
+// Formats that are cooked on the CPU instead of having their mips generated on the GPU
+static bool IsCookedFormat(EFormat Format, uint32 CreateFlags)
+{
+    if (TextureCompressor::IsSupportedFormat(Format))
+    {
+        return true;
+    }
+
+    const bool GenerateMips = CreateFlags & ETextureFactoryFlags::TextureFactoryFlag_GenerateMips;
+    return GenerateMips && (Format == EFormat::R8_Unorm || Format == EFormat::R8G8B8A8_Unorm);
+}
+
+static uint32 GetNumCookedChannels(EFormat Format)
+{
+    return (Format == EFormat::R8_Unorm) ? 1 : TextureCompressor::GetNumSourceChannels(Format);
+}
+
+// Generates the mips on the CPU and block compresses them, thread safe
+static void CookTexture(const uint8* Pixels, uint32 Width, uint32 Height, uint32 CreateFlags, EFormat Format, CookedTexture& OutTexture)
+{
+    Assert(IsCookedFormat(Format, CreateFlags));
+
+    const uint32 NumChannels = GetNumCookedChannels(Format);
+    const bool IsSRGB = (Format == EFormat::BC1_Unorm_SRGB || Format == EFormat::BC7_Unorm_SRGB) || (CreateFlags & TextureFactoryFlag_SRGB);
+
+    // The size of the first mip of a block compressed texture has to be a multiple of the block size
+    EFormat CookedFormat = Format;
+    if (IsBlockCompressed(Format) && ((Width % 4) != 0 || (Height % 4) != 0))
+    {
+        if (NumChannels == 1)
+        {
+            CookedFormat = EFormat::R8_Unorm;
+        }
+        else if (Format == EFormat::BC1_Unorm_SRGB || Format == EFormat::BC7_Unorm_SRGB)
+        {
+            CookedFormat = EFormat::R8G8B8A8_Unorm_SRGB;
+        }
+        else
+        {
+            CookedFormat = EFormat::R8G8B8A8_Unorm;
+        }
+
+        LOG_WARNING("[TextureFactory]: Size of texture is not a multiple of four, it is stored as " + std::string(ToString(CookedFormat)));
+    }
+
+    const bool GenerateMips = CreateFlags & ETextureFactoryFlags::TextureFactoryFlag_GenerateMips;
+
+    OutTexture.Format  = CookedFormat;
+    OutTexture.Width   = Width;
+    OutTexture.Height  = Height;
+    OutTexture.NumMips = GenerateMips ? MipGenerator::GetNumMips(Width, Height) : 1;
+    OutTexture.Data.Resize(uint32(OutTexture.GetSize()));
+
+    MipGeneratorDesc MipDesc;
+    MipDesc.Filter = EMipFilter::Kaiser;
+    if (IsSRGB)
+    {
+        MipDesc.Flags |= MipGeneratorFlag_SRGB;
+    }
+
+    if (CreateFlags & TextureFactoryFlag_NormalMap)
+    {
+        MipDesc.Flags |= MipGeneratorFlag_NormalMap;
+    }
+
+    if (CreateFlags & TextureFactoryFlag_AlphaMask)
+    {
+        MipDesc.Flags |= MipGeneratorFlag_AlphaCoverage;
+    }
+
+    TArray<uint8> Mips;
+    MipGenerator::GenerateMips(Pixels, Width, Height, NumChannels, OutTexture.NumMips, MipDesc, Mips);
+
+    const uint8* MipPixels = Mips.Data();
+    for (uint32 Mip = 0; Mip < OutTexture.NumMips; Mip++)
+    {
+        const uint32 MipWidth  = OutTexture.GetMipWidth(Mip);
+        const uint32 MipHeight = OutTexture.GetMipHeight(Mip);
+
+        uint8* MipData = OutTexture.Data.Data() + OutTexture.GetMipOffset(Mip);
+        if (IsBlockCompressed(CookedFormat))
+        {
+            TextureCompressor::Compress(MipPixels, MipWidth, MipHeight, CookedFormat, MipData);
+        }
+        else
+        {
+            Memory::Memcpy(MipData, MipPixels, OutTexture.GetMipSize(Mip));
+        }
+
+        MipPixels += MipWidth * MipHeight * NumChannels;
+    }
+}
+
+// Loads the cooked version of the image if it is up to date, otherwise the image is cooked and the cache is written
+static bool LoadCookedTexture(const std::string& Filepath, uint32 CreateFlags, EFormat Format, CookedTexture& OutTexture)
+{
+    MappedFile Source;
+    if (!Source.Open(Filepath))
+    {
+        LOG_ERROR("[TextureFactory]: Failed to load image '" + Filepath + "'");
+        return false;
+    }
+
+    const uint64 SourceHash    = TextureCache::HashSource(Source.GetData(), Source.GetSize(), Format, CreateFlags);
+    const int32  SourceChannel = (GetNumCookedChannels(Format) == 1) ? GetSourceChannel(CreateFlags) : -1;
+
+    // Each format and set of flags has its own cache, otherwise textures that are cooked from the same image with other
+    // settings, for example from another channel, would replace each other and could be written at the same time
+    char Settings[64];
+    snprintf(Settings, sizeof(Settings), ".%s.%x", ToString(Format), CreateFlags);
+
+    const std::string CacheFilename = Filepath + Settings + TEXTURE_CACHE_EXTENSION;
+    if (TextureCache::Read(CacheFilename, SourceHash, OutTexture))
+    {
+        LOG_INFO("[TextureFactory]: Loaded cooked image '" + CacheFilename + "'");
+        return true;
+    }
+
+    const uint32 NumChannels = GetNumCookedChannels(Format);
+
+    int32 Width        = 0;
+    int32 Height       = 0;
+    int32 ChannelCount = 0;
+    TUniquePtr<uint8> Pixels = TUniquePtr<uint8>(stbi_load_from_memory(
+        reinterpret_cast<const stbi_uc*>(Source.GetData()),
+        int32(Source.GetSize()),
+        &Width, &Height, &ChannelCount,
+        SourceChannel >= 0 ? 4 : int32(NumChannels)));
+    if (!Pixels)
+    {
+        LOG_ERROR("[TextureFactory]: Failed to load image '" + Filepath + "'");
+        return false;
+    }
+
+    if (SourceChannel >= 0)
+    {
+        SelectChannel(Pixels.Get(), uint32(Width * Height), SourceChannel);
+    }
+
+    CookTexture(Pixels.Get(), Width, Height, CreateFlags, Format, OutTexture);
+    LOG_INFO("[TextureFactory]: Cooked image '" + Filepath + "' as " + ToString(OutTexture.Format));
+
+    if (!TextureCache::Write(CacheFilename, SourceHash, OutTexture))
+    {
+        LOG_WARNING("[TextureFactory]: Failed to write cooked image '" + CacheFilename + "'");
+    }
+
+    return true;
+}
+
+// The mips are uploaded by CmdList, so the texture can not be used before it has been executed
+static Texture2D* CreateTextureFromCooked(const CookedTexture& Cooked, CommandList& CmdList)
+{
+    TRef<Texture2D> Texture = CreateTexture2D(Cooked.Format, Cooked.Width, Cooked.Height, Cooked.NumMips, 1, TextureFlag_SRV, EResourceState::CopyDest, nullptr);
+    if (!Texture)
+    {
+        Debug::DebugBreak();
+        return nullptr;
+    }
+
+    for (uint32 Mip = 0; Mip < Cooked.NumMips; Mip++)
+    {
+        CmdList.UpdateTexture2D(Texture.Get(), Cooked.GetMipWidth(Mip), Cooked.GetMipHeight(Mip), Mip, Cooked.GetMipData(Mip));
+    }
+
+    CmdList.TransitionTexture(Texture.Get(), EResourceState::PixelShaderResource);
+    return Texture.ReleaseOwnership();
+}
+
+static Texture2D* CreateTextureFromCookedNow(const CookedTexture& Cooked)
+{
+    CommandList& CmdList = GlobalFactoryData.CmdList;
+    CmdList.Begin();
+    TRef<Texture2D> Texture = CreateTextureFromCooked(Cooked, CmdList);
+    CmdList.End();
+    GCmdListExecutor.ExecuteCommandList(CmdList);
+    return Texture.ReleaseOwnership();
+}
+
+Texture2D* TextureFactory::LoadFromFile(const std::string& Filepath, uint32 CreateFlags, EFormat Format)
+{
+    if (!IsSupportedFormat(Format))
+    {
+        LOG_ERROR("[TextureFactory]: Format not supported");
+        return nullptr;
+    }
+
+    if (IsCookedFormat(Format, CreateFlags))
+    {
+        CookedTexture Cooked;
+        if (!LoadCookedTexture(Filepath, CreateFlags, Format, Cooked))
+        {
+            return nullptr;
+        }
+
+        return CreateTextureFromCookedNow(Cooked);
+    }
+
+    int32 Width  = 0;
+    int32 Height = 0;
+    TUniquePtr<uint8> Pixels = TUniquePtr<uint8>(DecodeImage(Filepath, Format, CreateFlags, Width, Height));
+    if (!Pixels)
+    {
+        return nullptr;
+    }
+
+    return LoadFromMemory(Pixels.Get(), Width, Height, CreateFlags, Format);
+}
+
+Texture2D* TextureFactory::LoadFromMemory(const uint8* Pixels, uint32 Width, uint32 Height, uint32 CreateFlags, EFormat Format)
+{
+    if (!IsSupportedFormat(Format))
+    {
+        LOG_ERROR("[TextureFactory]: Format not supported");
+        return nullptr;
+    }
+
+    // Pixels have the channels that the cooked format expects
+    if (IsCookedFormat(Format, CreateFlags))
+    {
+        CookedTexture Cooked;
+        CookTexture(Pixels, Width, Height, CreateFlags, Format, Cooked);
+        return CreateTextureFromCookedNow(Cooked);
+    }
+
+    TRef<Texture2D> Texture = CreateTextureFromPixels(Pixels, Width, Height, CreateFlags, Format);
+    if (!Texture)
+    {
+        return nullptr;
+    }
+
+    if (CreateFlags & ETextureFactoryFlags::TextureFactoryFlag_GenerateMips)
     {
         CommandList& CmdList = GlobalFactoryData.CmdList;
         CmdList.Begin();
-        CmdList.TransitionTexture(Texture.Get(), EResourceState::PixelShaderResource, EResourceState::CopyDest);
-        CmdList.GenerateMips(Texture.Get());
-        CmdList.TransitionTexture(Texture.Get(), EResourceState::CopyDest, EResourceState::PixelShaderResource);
+        RecordGenerateMips(CmdList, Texture.Get());
         CmdList.End();
         GCmdListExecutor.ExecuteCommandList(CmdList);
     }
@@ -137,6 +462,125 @@ Texture2D* TextureFactory::LoadFromMemory(const uint8* Pixels, uint32 Width, uin
     return Texture.ReleaseOwnership();
 }
 
+static void DecodeAsyncLoad(AsyncTextureLoad* Load)
+{
+    if (IsCookedFormat(Load->Format, Load->CreateFlags))
+    {
+        if (!LoadCookedTexture(Load->Filepath, Load->CreateFlags, Load->Format, Load->Cooked))
+        {
+            Load->Cooked.NumMips = 0;
+        }
+    }
+    else
+    {
+        Load->Pixels = TUniquePtr<uint8>(DecodeImage(Load->Filepath, Load->Format, Load->CreateFlags, Load->Width, Load->Height));
+    }
+
+    TScopedLock<Mutex> Lock(GlobalFactoryData.DecodedLoadsMutex);
+    GlobalFactoryData.DecodedLoads.EmplaceBack(Load);
+}
+
+void TextureFactory::LoadFromFileAsync(const std::string& Filepath, uint32 CreateFlags, EFormat Format, const TextureLoadedDelegate& OnLoaded)
+{
+    AsyncTextureLoad* Load = DBG_NEW AsyncTextureLoad();
+    Load->Filepath    = Filepath;
+    Load->CreateFlags = CreateFlags;
+    Load->Format      = Format;
+    Load->OnLoaded    = OnLoaded;
+
+    GlobalFactoryData.NumPendingLoads.Increment();
+
+    if (!IsSupportedFormat(Format))
+    {
+        LOG_ERROR("[TextureFactory]: Format not supported");
+
+        // Finished with a nullptr texture by the next Tick
+        TScopedLock<Mutex> Lock(GlobalFactoryData.DecodedLoadsMutex);
+        GlobalFactoryData.DecodedLoads.EmplaceBack(Load);
+        return;
+    }
+
+    // Tasks are not executed without workers, so decode right away instead
+    if (TaskManager::Get().GetNumWorkers() == 0)
+    {
+        DecodeAsyncLoad(Load);
+        return;
+    }
+
+    Task DecodeTask;
+    DecodeTask.Delegate.BindLambda([Load]()
+    {
+        DecodeAsyncLoad(Load);
+    });
+
+    TaskManager::Get().AddTask(DecodeTask);
+}
+
+void TextureFactory::Tick()
+{
+    TArray<AsyncTextureLoad*> Loads;
+    {
+        TScopedLock<Mutex> Lock(GlobalFactoryData.DecodedLoadsMutex);
+        if (GlobalFactoryData.DecodedLoads.IsEmpty())
+        {
+            return;
+        }
+
+        Loads = Move(GlobalFactoryData.DecodedLoads);
+        GlobalFactoryData.DecodedLoads.Clear();
+    }
+
+    TRACE_SCOPE("TextureFactory::Tick");
+
+    // Textures are created on this thread, but the uploads and mips of all of them are recorded into one submission
+    CommandList& CmdList = GlobalFactoryData.CmdList;
+    CmdList.Begin();
+
+    TArray<TRef<Texture2D>> Textures(Loads.Size());
+    for (uint32 Index = 0; Index < Loads.Size(); Index++)
+    {
+        AsyncTextureLoad* Load = Loads[Index];
+        if (Load->Cooked.NumMips > 0)
+        {
+            Textures[Index] = CreateTextureFromCooked(Load->Cooked, CmdList);
+        }
+        else if (Load->Pixels)
+        {
+            Textures[Index] = CreateTextureFromPixels(Load->Pixels.Get(), Load->Width, Load->Height, Load->CreateFlags, Load->Format);
+            if (Textures[Index] && (Load->CreateFlags & ETextureFactoryFlags::TextureFactoryFlag_GenerateMips))
+            {
+                RecordGenerateMips(CmdList, Textures[Index].Get());
+            }
+        }
+    }
+
+    CmdList.End();
+    GCmdListExecutor.ExecuteCommandList(CmdList);
+
+    for (uint32 Index = 0; Index < Loads.Size(); Index++)
+    {
+        AsyncTextureLoad* Load = Loads[Index];
+        Load->OnLoaded.ExecuteIfBound(Textures[Index]);
+
+        SafeDelete(Load);
+        GlobalFactoryData.NumPendingLoads.Decrement();
+    }
+}
+
+void TextureFactory::FlushAsyncLoads()
+{
+    while (GlobalFactoryData.NumPendingLoads.Load() > 0)
+    {
+        Tick();
+        PlatformProcess::Sleep(0);
+    }
+}
+
+uint32 TextureFactory::GetNumPendingLoads()
+{
+    return uint32(GlobalFactoryData.NumPendingLoads.Load());
+}
+
 TextureCube* TextureFactory::CreateTextureCubeFromPanorma(Texture2D* PanoramaSource, uint32 CubeMapSize, uint32 CreateFlags, EFormat Format)
 {
     Assert(PanoramaSource->IsSRV());
@@ -173,8 +617,8 @@ TextureCube* TextureFactory::CreateTextureCubeFromPanorma(Texture2D* PanoramaSou
     CommandList& CmdList = GlobalFactoryData.CmdList;
     CmdList.Begin();
     
-    CmdList.TransitionTexture(PanoramaSource, EResourceState::PixelShaderResource, EResourceState::NonPixelShaderResource);
-    CmdList.TransitionTexture(StagingTexture.Get(), EResourceState::Common, EResourceState::UnorderedAccess);
+    CmdList.TransitionTexture(PanoramaSource, EResourceState::NonPixelShaderResource);
+    CmdList.TransitionTexture(StagingTexture.Get(), EResourceState::UnorderedAccess);
 
     CmdList.SetComputePipelineState(GlobalFactoryData.PanoramaPSO.Get());
 
@@ -195,9 +639,9 @@ TextureCube* TextureFactory::CreateTextureCubeFromPanorma(Texture2D* PanoramaSou
     const uint32 ThreadsY = Math::DivideByMultiple(CubeMapSize, LocalWorkGroupCount);
     CmdList.Dispatch(ThreadsX, ThreadsY, 6);
 
-    CmdList.TransitionTexture(PanoramaSource, EResourceState::NonPixelShaderResource, EResourceState::PixelShaderResource);
-    CmdList.TransitionTexture(StagingTexture.Get(), EResourceState::UnorderedAccess, EResourceState::CopySource);
-    CmdList.TransitionTexture(Texture.Get(), EResourceState::Common, EResourceState::CopyDest);
+    CmdList.TransitionTexture(PanoramaSource, EResourceState::PixelShaderResource);
+    CmdList.TransitionTexture(StagingTexture.Get(), EResourceState::CopySource);
+    CmdList.TransitionTexture(Texture.Get(), EResourceState::CopyDest);
 
     CmdList.CopyTexture(Texture.Get(), StagingTexture.Get());
 
@@ -206,7 +650,7 @@ TextureCube* TextureFactory::CreateTextureCubeFromPanorma(Texture2D* PanoramaSou
         CmdList.GenerateMips(Texture.Get());
     }
 
-    CmdList.TransitionTexture(Texture.Get(), EResourceState::CopyDest, EResourceState::PixelShaderResource);
+    CmdList.TransitionTexture(Texture.Get(), EResourceState::PixelShaderResource);
     CmdList.End();
     GCmdListExecutor.ExecuteCommandList(CmdList);
 
@@ -3,21 +3,53 @@
 
 #include "Utilities/StringUtilities.h"
 
+#include "Core/Delegates/Delegate.h"
+
 enum ETextureFactoryFlags : uint32
 {
     TextureFactoryFlag_None			= 0,
     TextureFactoryFlag_GenerateMips = FLAG(1),
+    TextureFactoryFlag_SRGB         = FLAG(2), // Color channels are sRGB encoded, mips are filtered in linear space
+    TextureFactoryFlag_NormalMap    = FLAG(3), // Normals are renormalized in every mip
+    TextureFactoryFlag_AlphaMask    = FLAG(4), // Mips pass the alpha test as often as the full size texture
+
+    // Single channel formats read one channel of the image instead of its luminance, for images with packed channels
+    TextureFactoryFlag_ChannelR = FLAG(5),
+    TextureFactoryFlag_ChannelG = FLAG(6),
+    TextureFactoryFlag_ChannelB = FLAG(7),
+    TextureFactoryFlag_ChannelA = FLAG(8),
 };
 
+// Called on the main thread with the loaded texture, which is nullptr if the image could not be loaded
+typedef TDelegate<void(const TRef<class Texture2D>&)> TextureLoadedDelegate;
+
+/*
+* LoadFromFileAsync decodes the image on a worker thread and returns immediately. Tick creates the textures of all
+* images that have been decoded since the last call and generates their mips with a single command list, after which
+* the delegate of each load is called. Until then the caller keeps using a placeholder texture.
+*/
+
 class TextureFactory
 {
 public:
     static bool Init();
     static void Release();
 
-    // TODO: Supports R8G8B8A8 and R32G32B32A32 for now, support more formats? Such as Float16?
+    // TODO: Supports R8, R8G8B8A8 and R32G32B32A32 for now, support more formats? Such as Float16?
+    // BC1, BC4, BC5 and BC7 are compressed on the CPU when the image is loaded the first time and cached on disk
+    // 8-bit textures with mips are cooked in the same way, so that their mips are generated on the CPU
     static class Texture2D* LoadFromFile(const std::string& Filepath, uint32 CreateFlags, EFormat Format);
     static class Texture2D* LoadFromMemory(const uint8* Pixels, uint32 Width, uint32 Height, uint32 CreateFlags, EFormat Format);
 
+    static void LoadFromFileAsync(const std::string& Filepath, uint32 CreateFlags, EFormat Format, const TextureLoadedDelegate& OnLoaded);
+
+    // Finishes the asynchronous loads that have been decoded, called once every frame
+    static void Tick();
+
+    // Blocks until all asynchronous loads have finished and their delegates have been called
+    static void FlushAsyncLoads();
+
+    static uint32 GetNumPendingLoads();
+
     static class TextureCube* CreateTextureCubeFromPanorma(class Texture2D* PanoramaSource, uint32 CubeMapSize, uint32 CreateFlags, EFormat Format);
 };
\ No newline at end of file
@@ -16,10 +16,8 @@ bool ScreenSpaceOcclusionRenderer::Init(FrameResources& FrameResources)
     INIT_CONSOLE_VARIABLE("r.SSAOBias", &GSSAOBias);
     INIT_CONSOLE_VARIABLE("r.SSAORadius", &GSSAORadius);
 
-    if (!CreateRenderTarget(FrameResources))
-    {
-        return false;
-    }
+    // The SSAOBuffer is created by the RenderGraph
+    UNREFERENCED_VARIABLE(FrameResources);
 
     TArray<uint8> ShaderCode;
     if (!ShaderCompiler::CompileFromFile("../DXR-Engine/Shaders/SSAO.hlsl", "Main", nullptr, EShaderStage::Compute, EShaderModel::SM_6_0, ShaderCode))
@@ -109,12 +107,11 @@ bool ScreenSpaceOcclusionRenderer::Init(FrameResources& FrameResources)
     CommandList CmdList;
     CmdList.Begin();
 
-    CmdList.TransitionTexture(FrameResources.SSAOBuffer.Get(), EResourceState::Common, EResourceState::NonPixelShaderResource);
-    CmdList.TransitionTexture(SSAONoiseTex.Get(), EResourceState::NonPixelShaderResource, EResourceState::CopyDest);
+    CmdList.TransitionTexture(SSAONoiseTex.Get(), EResourceState::CopyDest);
 
     CmdList.UpdateTexture2D(SSAONoiseTex.Get(), 4, 4, 0, SSAONoise.Data());
 
-    CmdList.TransitionTexture(SSAONoiseTex.Get(), EResourceState::CopyDest, EResourceState::NonPixelShaderResource);
+    CmdList.TransitionTexture(SSAONoiseTex.Get(), EResourceState::NonPixelShaderResource);
 
     CmdList.End();
     GCmdListExecutor.ExecuteCommandList(CmdList);
@@ -227,11 +224,6 @@ void ScreenSpaceOcclusionRenderer::Release()
     BlurVerticalShader.Reset();
 }
 
-bool ScreenSpaceOcclusionRenderer::ResizeResources(FrameResources& FrameResources)
-{
-	return CreateRenderTarget(FrameResources);
-}
-
 void ScreenSpaceOcclusionRenderer::Render(CommandList& CmdList, FrameResources& FrameResources)
 {
     INSERT_DEBUG_CMDLIST_MARKER(CmdList, "Begin SSAO");
@@ -262,7 +254,6 @@ void ScreenSpaceOcclusionRenderer::Render(CommandList& CmdList, FrameResources&
     FrameResources.DebugTextures.EmplaceBack(
         MakeSharedRef<ShaderResourceView>(SSAONoiseTex->GetShaderResourceView()),
         SSAONoiseTex,
-        EResourceState::NonPixelShaderResource,
         EResourceState::NonPixelShaderResource);
 
     CmdList.SetShaderResourceView(SSAOShader.Get(), FrameResources.GBuffer[GBUFFER_VIEW_NORMAL_INDEX]->GetShaderResourceView(), 0);
@@ -301,23 +292,3 @@ void ScreenSpaceOcclusionRenderer::Render(CommandList& CmdList, FrameResources&
 
     INSERT_DEBUG_CMDLIST_MARKER(CmdList, "End SSAO");
 }
-
-bool ScreenSpaceOcclusionRenderer::CreateRenderTarget(FrameResources& FrameResources)
-{
-    const uint32 Width  = FrameResources.MainWindowViewport->GetWidth();
-    const uint32 Height = FrameResources.MainWindowViewport->GetHeight();
-    const uint32 Flags  = TextureFlags_RWTexture;
-
-    FrameResources.SSAOBuffer = CreateTexture2D(FrameResources.SSAOBufferFormat, Width, Height, 1, 1, Flags, EResourceState::Common, nullptr);
-    if (!FrameResources.SSAOBuffer)
-    {
-        Debug::DebugBreak();
-        return false;
-    }
-    else
-    {
-        FrameResources.SSAOBuffer->SetName("SSAO Buffer");
-    }
-
-    return true;
-}
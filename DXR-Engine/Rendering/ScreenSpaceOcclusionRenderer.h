@@ -14,13 +14,10 @@ public:
     bool Init(FrameResources& FrameResources);
     void Release();
 
+    // The SSAOBuffer is a transient texture in the RenderGraph and must be set before the pass is rendered
     void Render(CommandList& CmdList, FrameResources& FrameResources);
 
-    bool ResizeResources(FrameResources& FrameResources);
-
 private:
-    bool CreateRenderTarget(FrameResources& FrameResources);
-
     TRef<ComputePipelineState> PipelineState;
     TRef<ComputeShader>        SSAOShader;
     TRef<ComputePipelineState> BlurHorizontalPSO;
@@ -10,7 +10,6 @@
 
 #include "Rendering/MeshDrawCommand.h"
 
-#include "Scene/Frustum.h"
 #include "Scene/Lights/PointLight.h"
 #include "Scene/Lights/DirectionalLight.h"
 
@@ -39,10 +38,15 @@ bool ShadowMapRenderer::Init(LightSetup& LightSetup, FrameResources& FrameResour
         PerShadowMapBuffer->SetName("PerShadowMap Buffer");
     }
 
+    TArray<ShaderDefine> Defines =
+    {
+        { "ENABLE_PACKED_VERTICES", MESH_PACKED_VERTICES ? "1" : "0" },
+    };
+
     // Linear Shadow Maps
     TArray<uint8> ShaderCode;
     {
-        if (!ShaderCompiler::CompileFromFile("../DXR-Engine/Shaders/ShadowMap.hlsl", "VSMain", nullptr, EShaderStage::Vertex, EShaderModel::SM_6_0, ShaderCode))
+        if (!ShaderCompiler::CompileFromFile("../DXR-Engine/Shaders/ShadowMap.hlsl", "VSMain", &Defines, EShaderStage::Vertex, EShaderModel::SM_6_0, ShaderCode))
         {
             Debug::DebugBreak();
             return false;
@@ -123,7 +127,7 @@ bool ShadowMapRenderer::Init(LightSetup& LightSetup, FrameResources& FrameResour
         PipelineStateInfo.BlendState                         = BlendState.Get();
         PipelineStateInfo.DepthStencilState                  = DepthStencilState.Get();
         PipelineStateInfo.IBStripCutValue                    = EIndexBufferStripCutValue::Disabled;
-        PipelineStateInfo.InputLayoutState                   = FrameResources.StdInputLayout.Get();
+        PipelineStateInfo.InputLayoutState                   = FrameResources.MeshInputLayout.Get();
         PipelineStateInfo.PrimitiveTopologyType              = EPrimitiveTopologyType::Triangle;
         PipelineStateInfo.RasterizerState                    = RasterizerState.Get();
         PipelineStateInfo.SampleCount                        = 1;
@@ -147,7 +151,7 @@ bool ShadowMapRenderer::Init(LightSetup& LightSetup, FrameResources& FrameResour
     }
 
     {
-        if (!ShaderCompiler::CompileFromFile("../DXR-Engine/Shaders/ShadowMap.hlsl", "Main", nullptr, EShaderStage::Vertex, EShaderModel::SM_6_0, ShaderCode))
+        if (!ShaderCompiler::CompileFromFile("../DXR-Engine/Shaders/ShadowMap.hlsl", "Main", &Defines, EShaderStage::Vertex, EShaderModel::SM_6_0, ShaderCode))
         {
             Debug::DebugBreak();
             return false;
@@ -210,7 +214,7 @@ bool ShadowMapRenderer::Init(LightSetup& LightSetup, FrameResources& FrameResour
         PipelineStateInfo.BlendState                         = BlendState.Get();
         PipelineStateInfo.DepthStencilState                  = DepthStencilState.Get();
         PipelineStateInfo.IBStripCutValue                    = EIndexBufferStripCutValue::Disabled;
-        PipelineStateInfo.InputLayoutState                   = FrameResources.StdInputLayout.Get();
+        PipelineStateInfo.InputLayoutState                   = FrameResources.MeshInputLayout.Get();
         PipelineStateInfo.PrimitiveTopologyType              = EPrimitiveTopologyType::Triangle;
         PipelineStateInfo.RasterizerState                    = RasterizerState.Get();
         PipelineStateInfo.SampleCount                        = 1;
@@ -236,7 +240,7 @@ bool ShadowMapRenderer::Init(LightSetup& LightSetup, FrameResources& FrameResour
     return true;
 }
 
-void ShadowMapRenderer::RenderPointLightShadows(CommandList& CmdList, const LightSetup& LightSetup, const Scene& Scene)
+void ShadowMapRenderer::RenderPointLightShadows(CommandList& CmdList, const LightSetup& LightSetup, const Scene& Scene, const MultiViewCulling* Culling, const LODSelection* LODs)
 {
     PointLightFrame++;
     if (PointLightFrame > 6)
@@ -247,7 +251,7 @@ void ShadowMapRenderer::RenderPointLightShadows(CommandList& CmdList, const Ligh
 
     CmdList.SetPrimitiveTopology(EPrimitiveTopology::TriangleList);
 
-    CmdList.TransitionTexture(LightSetup.PointLightShadowMaps.Get(), EResourceState::PixelShaderResource, EResourceState::DepthWrite);
+    CmdList.TransitionTexture(LightSetup.PointLightShadowMaps.Get(), EResourceState::DepthWrite);
 
     INSERT_DEBUG_CMDLIST_MARKER(CmdList, "Begin Render PointLight ShadowMaps");
 
@@ -282,60 +286,37 @@ void ShadowMapRenderer::RenderPointLightShadows(CommandList& CmdList, const Ligh
                 PerShadowMapData.Position = Data.Position;
                 PerShadowMapData.FarPlane = Data.FarPlane;
 
-                CmdList.TransitionBuffer(PerShadowMapBuffer.Get(), EResourceState::VertexAndConstantBuffer, EResourceState::CopyDest);
+                CmdList.TransitionBuffer(PerShadowMapBuffer.Get(), EResourceState::CopyDest);
 
                 CmdList.UpdateBuffer(PerShadowMapBuffer.Get(), 0, sizeof(PerShadowMap), &PerShadowMapData);
 
-                CmdList.TransitionBuffer(PerShadowMapBuffer.Get(), EResourceState::CopyDest, EResourceState::VertexAndConstantBuffer);
+                CmdList.TransitionBuffer(PerShadowMapBuffer.Get(), EResourceState::VertexAndConstantBuffer);
 
                 CmdList.SetConstantBuffer(PointLightVertexShader.Get(), PerShadowMapBuffer.Get(), 0);
                 CmdList.SetConstantBuffer(PointLightPixelShader.Get(), PerShadowMapBuffer.Get(), 0);
 
-                // Draw all objects to depthbuffer
-                ConsoleVariable* GlobalFrustumCullEnabled = GConsole.FindVariable("r.EnableFrustumCulling");
-                if (GlobalFrustumCullEnabled->GetBool())
+                // Draw all visible objects to depthbuffer
+                const TArray<MeshDrawCommand>& MeshDrawCommands = Scene.GetMeshDrawCommands();
+                for (uint32 Index = 0; Index < MeshDrawCommands.Size(); Index++)
                 {
-                    Frustum CameraFrustum = Frustum(Data.FarPlane, Data.ViewMatrix[Face], Data.ProjMatrix[Face]);
-                    for (const MeshDrawCommand& Command : Scene.GetMeshDrawCommands())
+                    if (Culling && !Culling->IsVisible(Data.FirstCullingView + Face, Index))
                     {
-                        const XMFLOAT4X4& Transform = Command.CurrentActor->GetTransform().GetMatrix();
-                        XMMATRIX XmTransform = XMMatrixTranspose(XMLoadFloat4x4(&Transform));
-                        XMVECTOR XmTop       = XMVectorSetW(XMLoadFloat3(&Command.Mesh->BoundingBox.Top), 1.0f);
-                        XMVECTOR XmBottom    = XMVectorSetW(XMLoadFloat3(&Command.Mesh->BoundingBox.Bottom), 1.0f);
-                        XmTop    = XMVector4Transform(XmTop, XmTransform);
-                        XmBottom = XMVector4Transform(XmBottom, XmTransform);
-
-                        AABB Box;
-                        XMStoreFloat3(&Box.Top, XmTop);
-                        XMStoreFloat3(&Box.Bottom, XmBottom);
-                        if (CameraFrustum.CheckAABB(Box))
-                        {
-                            CmdList.SetVertexBuffers(&Command.VertexBuffer, 1, 0);
-                            CmdList.SetIndexBuffer(Command.IndexBuffer);
-
-                            ShadowPerObjectBuffer.Matrix       = Command.CurrentActor->GetTransform().GetMatrix();
-                            ShadowPerObjectBuffer.ShadowOffset = Command.Mesh->ShadowOffset;
-
-                            CmdList.Set32BitShaderConstants(PointLightVertexShader.Get(), &ShadowPerObjectBuffer, 17);
-
-                            CmdList.DrawIndexedInstanced(Command.IndexBuffer->GetNumIndicies(), 1, 0, 0, 0);
-                        }
+                        continue;
                     }
-                }
-                else
-                {
-                    for (const MeshDrawCommand& Command : Scene.GetMeshDrawCommands())
-                    {
-                        CmdList.SetVertexBuffers(&Command.VertexBuffer, 1, 0);
-                        CmdList.SetIndexBuffer(Command.IndexBuffer);
 
-                        ShadowPerObjectBuffer.Matrix       = Command.CurrentActor->GetTransform().GetMatrix();
-                        ShadowPerObjectBuffer.ShadowOffset = Command.Mesh->ShadowOffset;
+                    const MeshDrawCommand& Command = MeshDrawCommands[Index];
 
-                        CmdList.Set32BitShaderConstants(PointLightVertexShader.Get(), &ShadowPerObjectBuffer, 17);
+                    Mesh* DrawMesh = LODs ? Command.Mesh->GetLOD(LODs->GetLOD(Data.FirstCullingView + Face, Index)) : Command.Mesh;
+                    VertexBuffer* DrawVertexBuffer = DrawMesh->VertexBuffer.Get();
+                    CmdList.SetVertexBuffers(&DrawVertexBuffer, 1, 0);
+                    CmdList.SetIndexBuffer(DrawMesh->IndexBuffer.Get());
 
-                        CmdList.DrawIndexedInstanced(Command.IndexBuffer->GetNumIndicies(), 1, 0, 0, 0);
-                    }
+                    ShadowPerObjectBuffer.Matrix       = DrawMesh->GetVertexTransform(Command.CurrentActor->GetTransform().GetMatrix());
+                    ShadowPerObjectBuffer.ShadowOffset = Command.Mesh->ShadowOffset / DrawMesh->PositionScale;
+
+                    CmdList.Set32BitShaderConstants(PointLightVertexShader.Get(), &ShadowPerObjectBuffer, 17);
+
+                    CmdList.DrawIndexedInstanced(DrawMesh->IndexBuffer->GetNumIndicies(), 1, 0, 0, 0);
                 }
             }
         }
@@ -345,10 +326,10 @@ void ShadowMapRenderer::RenderPointLightShadows(CommandList& CmdList, const Ligh
 
     INSERT_DEBUG_CMDLIST_MARKER(CmdList, "End Render PointLight ShadowMaps");
 
-    CmdList.TransitionTexture(LightSetup.PointLightShadowMaps.Get(), EResourceState::DepthWrite, EResourceState::NonPixelShaderResource);
+    CmdList.TransitionTexture(LightSetup.PointLightShadowMaps.Get(), EResourceState::NonPixelShaderResource);
 }
 
-void ShadowMapRenderer::RenderDirectionalLightShadows(CommandList& CmdList, const LightSetup& LightSetup, const Scene& Scene)
+void ShadowMapRenderer::RenderDirectionalLightShadows(CommandList& CmdList, const LightSetup& LightSetup, const Scene& Scene, const MultiViewCulling* Culling, const LODSelection* LODs)
 {
     //DirLightFrame++;
     //if (DirLightFrame > 6)
@@ -367,7 +348,7 @@ void ShadowMapRenderer::RenderDirectionalLightShadows(CommandList& CmdList, cons
     //{
         TRACE_SCOPE("Render DirectionalLight ShadowMaps");
 
-        CmdList.TransitionTexture(LightSetup.DirLightShadowMaps.Get(), EResourceState::PixelShaderResource, EResourceState::DepthWrite);
+        CmdList.TransitionTexture(LightSetup.DirLightShadowMaps.Get(), EResourceState::DepthWrite);
 
         DepthStencilView* DirLightDSV = LightSetup.DirLightShadowMaps->GetDepthStencilView();
         CmdList.ClearDepthStencilView(DirLightDSV, DepthStencilF(1.0f, 0));
@@ -395,26 +376,38 @@ void ShadowMapRenderer::RenderDirectionalLightShadows(CommandList& CmdList, cons
             PerShadowMapData.Position = Data.Position;
             PerShadowMapData.FarPlane = Data.FarPlane;
 
-            CmdList.TransitionBuffer(PerShadowMapBuffer.Get(), EResourceState::VertexAndConstantBuffer, EResourceState::CopyDest);
+            CmdList.TransitionBuffer(PerShadowMapBuffer.Get(), EResourceState::CopyDest);
 
             CmdList.UpdateBuffer(PerShadowMapBuffer.Get(), 0, sizeof(PerShadowMap), &PerShadowMapData);
 
-            CmdList.TransitionBuffer(PerShadowMapBuffer.Get(), EResourceState::CopyDest, EResourceState::VertexAndConstantBuffer);
+            CmdList.TransitionBuffer(PerShadowMapBuffer.Get(), EResourceState::VertexAndConstantBuffer);
 
             CmdList.SetConstantBuffers(DirLightShader.Get(), &PerShadowMapBuffer, 1, 0);
 
-            // Draw all objects to depthbuffer
-            for (const MeshDrawCommand& Command : Scene.GetMeshDrawCommands())
+            // Draw all visible objects to depthbuffer
+            const TArray<MeshDrawCommand>& MeshDrawCommands = Scene.GetMeshDrawCommands();
+            for (uint32 Index = 0; Index < MeshDrawCommands.Size(); Index++)
             {
-                CmdList.SetVertexBuffers(&Command.VertexBuffer, 1, 0);
-                CmdList.SetIndexBuffer(Command.IndexBuffer);
+                if (Culling && !Culling->IsVisible(Data.CullingView, Index))
+                {
+                    continue;
+                }
+
+                const MeshDrawCommand& Command = MeshDrawCommands[Index];
+
+                Mesh* DrawMesh = LODs ? Command.Mesh->GetLOD(LODs->GetLOD(Data.CullingView, Index)) : Command.Mesh;
+                VertexBuffer* DrawVertexBuffer = DrawMesh->VertexBuffer.Get();
+                CmdList.SetVertexBuffers(&DrawVertexBuffer, 1, 0);
+                CmdList.SetIndexBuffer(DrawMesh->IndexBuffer.Get());
+
+                ShadowPerObjectBuffer.Matrix       = DrawMesh->GetVertexTransform(Command.CurrentActor->GetTransform().GetMatrix());
 
-                ShadowPerObjectBuffer.Matrix       = Command.CurrentActor->GetTransform().GetMatrix();
-                ShadowPerObjectBuffer.ShadowOffset = Command.Mesh->ShadowOffset;
+                // The offset is applied to the packed position, before the scale of the dequantization
+                ShadowPerObjectBuffer.ShadowOffset = Command.Mesh->ShadowOffset / DrawMesh->PositionScale;
 
                 CmdList.Set32BitShaderConstants(DirLightShader.Get(), &ShadowPerObjectBuffer, 17);
 
-                CmdList.DrawIndexedInstanced(Command.IndexBuffer->GetNumIndicies(), 1, 0, 0, 0);
+                CmdList.DrawIndexedInstanced(DrawMesh->IndexBuffer->GetNumIndicies(), 1, 0, 0, 0);
             }
         }
 
@@ -427,7 +420,7 @@ void ShadowMapRenderer::RenderDirectionalLightShadows(CommandList& CmdList, cons
 
     INSERT_DEBUG_CMDLIST_MARKER(CmdList, "End Render DirectionalLight ShadowMaps");
 
-    CmdList.TransitionTexture(LightSetup.DirLightShadowMaps.Get(), EResourceState::DepthWrite, EResourceState::NonPixelShaderResource);
+    CmdList.TransitionTexture(LightSetup.DirLightShadowMaps.Get(), EResourceState::NonPixelShaderResource);
 }
 
 void ShadowMapRenderer::Release()
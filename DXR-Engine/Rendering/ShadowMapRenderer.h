@@ -5,6 +5,8 @@
 #include "RenderLayer/CommandList.h"
 
 #include "Scene/Scene.h"
+#include "Scene/MultiViewCulling.h"
+#include "Scene/LODSelection.h"
 
 class ShadowMapRenderer
 {
@@ -14,8 +16,9 @@ public:
 
     bool Init(LightSetup& LightSetup, FrameResources& Resources);
 
-    void RenderPointLightShadows(CommandList& CmdList, const LightSetup& LightSetup, const Scene& Scene);
-    void RenderDirectionalLightShadows(CommandList& CmdList, const LightSetup& LightSetup, const Scene& Scene);
+    // Culling is nullptr when the shadow maps should not be culled
+    void RenderPointLightShadows(CommandList& CmdList, const LightSetup& LightSetup, const Scene& Scene, const MultiViewCulling* Culling, const LODSelection* LODs);
+    void RenderDirectionalLightShadows(CommandList& CmdList, const LightSetup& LightSetup, const Scene& Scene, const MultiViewCulling* Culling, const LODSelection* LODs);
 
     void Release();
 
@@ -1,6 +1,8 @@
 #include "Actor.h"
 #include "Scene.h"
 
+#include <algorithm>
+
 Component::Component(Actor* InOwningActor)
     : CoreObject()
     , OwningActor(InOwningActor)
@@ -19,6 +21,23 @@ Actor::Actor()
 
 Actor::~Actor()
 {
+    // The scene would keep pointers to the actor and its components
+    if (Scene)
+    {
+        Scene->RemoveActor(this);
+    }
+
+    // The transforms of the children point to the transform of this actor
+    while (!Children.IsEmpty())
+    {
+        Children.Back()->SetParent(nullptr);
+    }
+
+    if (Parent)
+    {
+        SetParent(nullptr);
+    }
+
     for (Component* CurrentComponent : Components)
     {
         SafeDelete(CurrentComponent);
@@ -38,6 +57,45 @@ void Actor::AddComponent(Component* InComponent)
     }
 }
 
+void Actor::RemoveComponent(Component* InComponent)
+{
+    Assert(InComponent != nullptr);
+
+    Component** Position = std::find(Components.Begin(), Components.End(), InComponent);
+    Assert(Position != Components.End());
+    Components.Erase(Position);
+
+    if (Scene)
+    {
+        Scene->OnRemovedComponent(InComponent);
+    }
+
+    SafeDelete(InComponent);
+}
+
+void Actor::SetParent(Actor* InParent)
+{
+    Transform.SetParent(InParent ? &InParent->Transform : nullptr);
+
+    if (Parent)
+    {
+        Actor** Position = std::find(Parent->Children.Begin(), Parent->Children.End(), this);
+        Assert(Position != Parent->Children.End());
+        Parent->Children.Erase(Position);
+    }
+
+    Parent = InParent;
+    if (Parent)
+    {
+        Parent->Children.EmplaceBack(this);
+    }
+
+    if (Scene)
+    {
+        Scene->OnActorParentChanged(this);
+    }
+}
+
 void Actor::SetName(const std::string& InName)
 {
     Name = InName;
@@ -45,11 +103,12 @@ void Actor::SetName(const std::string& InName)
 
 Transform::Transform()
     : Matrix()
+    , MatrixInv()
+    , TinyMatrix()
     , Translation(0.0f, 0.0f, 0.0f)
     , Scale(1.0f, 1.0f, 1.0f)
     , Rotation(0.0f, 0.0f, 0.0f)
 {
-    CalculateMatrix();
 }
 
 void Transform::SetTranslation(float x, float y, float z)
@@ -60,7 +119,7 @@ void Transform::SetTranslation(float x, float y, float z)
 void Transform::SetTranslation(const XMFLOAT3& InPosition)
 {
     Translation = InPosition;
-    CalculateMatrix();
+    LocalDirty  = true;
 }
 
 void Transform::SetScale(float x, float y, float z)
@@ -70,8 +129,8 @@ void Transform::SetScale(float x, float y, float z)
 
 void Transform::SetScale(const XMFLOAT3& InScale)
 {
-    Scale = InScale;
-    CalculateMatrix();
+    Scale      = InScale;
+    LocalDirty = true;
 }
 
 void Transform::SetRotation(float x, float y, float z)
@@ -81,8 +140,37 @@ void Transform::SetRotation(float x, float y, float z)
 
 void Transform::SetRotation(const XMFLOAT3& InRotation)
 {
-    Rotation = InRotation;
+    Rotation   = InRotation;
+    LocalDirty = true;
+}
+
+void Transform::SetParent(Transform* InParent)
+{
+    for (const Transform* Current = InParent; Current; Current = Current->Parent)
+    {
+        Assert(Current != this);
+    }
+
+    Parent     = InParent;
+    LocalDirty = true;
+}
+
+bool Transform::UpdateMatrix()
+{
+    bool ParentChanged = false;
+    if (Parent)
+    {
+        Parent->UpdateMatrix();
+        ParentChanged = Parent->Version != ParentVersion;
+    }
+
+    if (!LocalDirty && !ParentChanged)
+    {
+        return false;
+    }
+
     CalculateMatrix();
+    return true;
 }
 
 void Transform::CalculateMatrix()
@@ -91,15 +179,34 @@ void Transform::CalculateMatrix()
     XMVECTOR XmScale       = XMLoadFloat3(&Scale);
     // Convert into Roll, Pitch, Yaw
     XMVECTOR XmRotation = XMVectorSet(Rotation.z, Rotation.y, Rotation.x, 0.0f);
-    
+
+    XMMATRIX XmRotationMatrix = XMMatrixRotationRollPitchYawFromVector(XmRotation);
     XMMATRIX XmMatrix = XMMatrixMultiply(
-            XMMatrixMultiply(XMMatrixScalingFromVector(XmScale), 
-            XMMatrixRotationRollPitchYawFromVector(XmRotation)),
-            XMMatrixTranslationFromVector(XmTranslation));
+        XMMatrixMultiply(XMMatrixScalingFromVector(XmScale), XmRotationMatrix),
+        XMMatrixTranslationFromVector(XmTranslation));
+
+    // The inverse of scale, rotation and translation is the inverse translation, the transposed rotation and the
+    // inverse scale in the opposite order, which is much cheaper than a general inverse
+    XMMATRIX XmMatrixInv = XMMatrixMultiply(
+        XMMatrixMultiply(XMMatrixTranslationFromVector(XMVectorNegate(XmTranslation)), XMMatrixTranspose(XmRotationMatrix)),
+        XMMatrixScalingFromVector(XMVectorReciprocal(XmScale)));
+
+    if (Parent)
+    {
+        // Matrix is stored transposed and MatrixInv is not
+        XMMATRIX XmParent    = XMMatrixTranspose(XMLoadFloat4x4(&Parent->Matrix));
+        XMMATRIX XmParentInv = XMLoadFloat4x4(&Parent->MatrixInv);
+        XmMatrix    = XMMatrixMultiply(XmMatrix, XmParent);
+        XmMatrixInv = XMMatrixMultiply(XmParentInv, XmMatrixInv);
+
+        ParentVersion = Parent->Version;
+    }
+
     XMStoreFloat3x4(&TinyMatrix, XmMatrix);
-    XmMatrix = XMMatrixTranspose(XmMatrix);
-    XMStoreFloat4x4(&Matrix, XmMatrix);
+    XMStoreFloat4x4(&Matrix, XMMatrixTranspose(XmMatrix));
+    XMStoreFloat4x4(&MatrixInv, XmMatrixInv);
 
-    XMMATRIX XmMatrixInv = XMMatrixInverse(nullptr, XmMatrix);
-    XMStoreFloat4x4(&MatrixInv, XMMatrixTranspose(XmMatrixInv));
+    Version++;
+    LocalDirty = false;
+    Dirty      = true;
 }
@@ -4,21 +4,58 @@
 
 class Actor;
 
+constexpr uint32 COMPONENT_INVALID_INDEX = uint32(~0);
+
+// Stays valid when other components are added or removed, and becomes invalid when its own component is removed
+struct ComponentHandle
+{
+    uint32 Slot       = COMPONENT_INVALID_INDEX;
+    uint32 Generation = 0;
+
+    bool IsValid() const { return Slot != COMPONENT_INVALID_INDEX; }
+
+    bool operator==(const ComponentHandle& Other) const
+    {
+        return Slot == Other.Slot && Generation == Other.Generation;
+    }
+
+    bool operator!=(const ComponentHandle& Other) const
+    {
+        return !(*this == Other);
+    }
+};
+
 // Component BaseClass
 class Component : public CoreObject
 {
     CORE_OBJECT(Component, CoreObject);
 
+    friend class ComponentStorage;
+
 public:
     Component(Actor* InOwningActor);
     virtual ~Component() = default;
 
     Actor* GetOwningActor() const { return OwningActor; }
 
+    // Invalid until the owning actor has been added to a scene
+    ComponentHandle GetHandle() const { return Handle; }
+
 protected:
     Actor* OwningActor = nullptr;
+
+private:
+    ComponentHandle Handle;
 };
 
+/*
+* The setters only store the new values, the matrices are recalculated by UpdateMatrix, which the Scene calls for all
+* actors on the game thread before the frame is rendered. The getters only read the matrices, so that the recording
+* threads can call them at the same time. A transform can have a parent, which makes the matrices world space matrices
+* that include the transforms of all parents. Each transform counts how many times its matrices have been recalculated,
+* and a child recalculates its matrices when the count of its parent differs from the count that it last saw.
+*/
+
 class Transform
 {
 public:
@@ -39,26 +76,50 @@ public:
     void SetRotation(float x, float y, float z);
     void SetRotation(const XMFLOAT3& InRotation);
 
+    // The parent must outlive this transform, Actor detaches its children when it is deleted
+    void SetParent(Transform* InParent);
+
+    // Relative to the parent
     const XMFLOAT3& GetTranslation() const { return Translation; }
 
     const XMFLOAT3& GetScale() const { return Scale; }
 
     const XMFLOAT3& GetRotation() const { return Rotation; }
 
+    const Transform* GetParent() const { return Parent; }
+
+    // The matrices as of the last UpdateMatrix
     const XMFLOAT4X4& GetMatrix() const { return Matrix; }
     const XMFLOAT4X4& GetMatrixInverse() const { return MatrixInv; }
-
     const XMFLOAT3X4& GetTinyMatrix() const { return TinyMatrix; }
 
+    // Recalculates the matrices if this transform or one of its parents has changed, returns true if they changed. Not
+    // thread safe, since the parents are updated as well.
+    bool UpdateMatrix();
+
+    // Set every time the matrix changes, the Scene clears it after the cached world bounds have been updated
+    bool IsDirty() const { return Dirty; }
+
+    void MarkDirty()  { Dirty = true; }
+    void ClearDirty() { Dirty = false; }
+
 private:
     void CalculateMatrix();
 
     XMFLOAT4X4 Matrix;
     XMFLOAT4X4 MatrixInv;
     XMFLOAT3X4 TinyMatrix;
-    XMFLOAT3   Translation;
-    XMFLOAT3   Scale;
-    XMFLOAT3   Rotation;
+    XMFLOAT3 Translation;
+    XMFLOAT3 Scale;
+    XMFLOAT3 Rotation;
+
+    Transform* Parent = nullptr;
+
+    uint32 Version       = 0;
+    uint32 ParentVersion = 0;
+
+    bool LocalDirty = true;
+    bool Dirty      = true;
 };
 
 class Scene;
@@ -73,6 +134,9 @@ public:
 
     void AddComponent(Component* InComponent);
 
+    // Removes the component from the actor and from the scene, and deletes it
+    void RemoveComponent(Component* InComponent);
+
     template<typename TComponent>
     FORCEINLINE bool HasComponentOfType() const noexcept
     {
@@ -91,6 +155,16 @@ public:
     template <typename TComponent>
     FORCEINLINE TComponent* GetComponentOfType() const
     {
+        // Most lookups are for the exact class of the component, which does not need to walk the super classes
+        const ClassType* Class = TComponent::GetStaticClass();
+        for (Component* Component : Components)
+        {
+            if (Component->GetClass() == Class)
+            {
+                return static_cast<TComponent*>(Component);
+            }
+        }
+
         for (Component* Component : Components)
         {
             if (IsSubClassOf<TComponent>(Component))
@@ -106,24 +180,44 @@ public:
     {
         Scene = InScene;
     }
+
+    void OnRemovedFromScene()
+    {
+        Scene = nullptr;
+    }
     
     void SetName(const std::string& InDebugName);
 
+    // Copies the translation, rotation and scale but keeps the parent
     void SetTransform(const Transform& InTransform)
     {
-        Transform = InTransform;
+        Transform.SetTranslation(InTransform.GetTranslation());
+        Transform.SetRotation(InTransform.GetRotation());
+        Transform.SetScale(InTransform.GetScale());
     }
 
+    // The transform of the actor becomes relative to the parent, nullptr detaches the actor. The children of an actor
+    // are detached when it is deleted.
+    void SetParent(Actor* InParent);
+
+    Actor* GetParent() const { return Parent; }
+
+    const TArray<Actor*>& GetChildren() const { return Children; }
+
     const std::string& GetName() const { return Name; }
 
+    const TArray<Component*>& GetComponents() const { return Components; }
+
     Scene* GetScene() const { return Scene; }
 
     Transform& GetTransform() { return Transform; }
     const Transform& GetTransform() const { return Transform; }
 
 private:
-    Scene*    Scene = nullptr;
+    Scene*    Scene  = nullptr;
+    Actor*    Parent = nullptr;
     Transform Transform;
+    TArray<Actor*>     Children;
     TArray<Component*> Components;
     std::string        Name;
 };
\ No newline at end of file
@@ -0,0 +1,772 @@
+#include "BoundingVolumeHierarchy.h"
+
+#include "Debug/Profiler.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+static float GetAxis(const XMFLOAT3& Vector, uint32 Axis)
+{
+    return (&Vector.x)[Axis];
+}
+
+static float GetSurfaceArea(const XMFLOAT3& Min, const XMFLOAT3& Max)
+{
+    const float SizeX = Max.x - Min.x;
+    const float SizeY = Max.y - Min.y;
+    const float SizeZ = Max.z - Min.z;
+    return 2.0f * ((SizeX * SizeY) + (SizeY * SizeZ) + (SizeZ * SizeX));
+}
+
+// The part of the SAH cost that a node adds, see BoundingVolumeHierarchy::CalculateCost
+static double GetNodeCost(const BVHNode& Node)
+{
+    const double Area = double(GetSurfaceArea(Node.Min, Node.Max));
+    return Node.IsLeaf() ? Area * double(Node.NumObjects) : Area;
+}
+
+static bool IsBoundsEqual(const BVHNode& Node, const XMFLOAT3& Min, const XMFLOAT3& Max)
+{
+    return
+        Node.Min.x == Min.x && Node.Min.y == Min.y && Node.Min.z == Min.z &&
+        Node.Max.x == Max.x && Node.Max.y == Max.y && Node.Max.z == Max.z;
+}
+
+static void GrowBounds(XMFLOAT3& Min, XMFLOAT3& Max, const XMFLOAT3& OtherMin, const XMFLOAT3& OtherMax)
+{
+    Min.x = std::min(Min.x, OtherMin.x);
+    Min.y = std::min(Min.y, OtherMin.y);
+    Min.z = std::min(Min.z, OtherMin.z);
+    Max.x = std::max(Max.x, OtherMax.x);
+    Max.y = std::max(Max.y, OtherMax.y);
+    Max.z = std::max(Max.z, OtherMax.z);
+}
+
+static void GetBoxBounds(const BoundingBoxSoA& Boxes, uint32 Index, XMFLOAT3& OutMin, XMFLOAT3& OutMax)
+{
+    const float CenterX = Boxes.GetCenterX()[Index];
+    const float CenterY = Boxes.GetCenterY()[Index];
+    const float CenterZ = Boxes.GetCenterZ()[Index];
+    const float ExtentX = Boxes.GetExtentX()[Index];
+    const float ExtentY = Boxes.GetExtentY()[Index];
+    const float ExtentZ = Boxes.GetExtentZ()[Index];
+    OutMin = XMFLOAT3(CenterX - ExtentX, CenterY - ExtentY, CenterZ - ExtentZ);
+    OutMax = XMFLOAT3(CenterX + ExtentX, CenterY + ExtentY, CenterZ + ExtentZ);
+}
+
+static void SetVisibleBit(uint64* VisibilityMask, uint32 Index)
+{
+    VisibilityMask[Index / 64] |= uint64(1) << (Index % 64);
+}
+
+/*
+* Build
+*/
+
+void BoundingVolumeHierarchy::Build(const BoundingBoxSoA& InBoxes)
+{
+    TRACE_SCOPE("Build BVH");
+
+    Boxes = &InBoxes;
+
+    const uint32 NumBoxes = InBoxes.Size();
+    Nodes.Clear();
+    ObjectIndices.Resize(NumBoxes);
+    ObjectLeaves.Resize(NumBoxes);
+    Centroids.Resize(NumBoxes);
+
+    Statistics.NumNodes  = 0;
+    Statistics.NumLeaves = 0;
+    Statistics.MaxDepth  = 0;
+    Statistics.BuildCost = 0.0f;
+    Statistics.Cost      = 0.0f;
+    Statistics.NumBuilds++;
+
+    CostSum = 0.0;
+
+    if (NumBoxes == 0)
+    {
+        return;
+    }
+
+    for (uint32 Index = 0; Index < NumBoxes; Index++)
+    {
+        ObjectIndices[Index] = Index;
+        Centroids[Index]     = XMFLOAT3(InBoxes.GetCenterX()[Index], InBoxes.GetCenterY()[Index], InBoxes.GetCenterZ()[Index]);
+    }
+
+    // A binary tree with N leaves has 2N - 1 nodes
+    Nodes.Reserve((NumBoxes * 2) - 1);
+    Nodes.EmplaceBack();
+
+    BuildNode(0, 0, NumBoxes, 0);
+
+    Statistics.NumNodes  = Nodes.Size();
+    Statistics.BuildCost = CalculateCost();
+    Statistics.Cost      = Statistics.BuildCost;
+
+    CostSum = 0.0;
+    for (const BVHNode& Node : Nodes)
+    {
+        CostSum += GetNodeCost(Node);
+    }
+}
+
+void BoundingVolumeHierarchy::BuildNode(uint32 NodeIndex, uint32 FirstObject, uint32 NumObjects, uint32 Depth)
+{
+    {
+        BVHNode& Node = Nodes[NodeIndex];
+        Node.FirstObject = FirstObject;
+        Node.NumObjects  = NumObjects;
+        Node.LeftChild   = BVH_INVALID_NODE;
+        CalculateLeafBounds(Node);
+    }
+
+    Statistics.MaxDepth = std::max(Statistics.MaxDepth, Depth);
+
+    const uint32 SplitObject = FindSplit(Nodes[NodeIndex], Depth);
+    if (SplitObject == FirstObject)
+    {
+        for (uint32 Index = FirstObject; Index < FirstObject + NumObjects; Index++)
+        {
+            ObjectLeaves[ObjectIndices[Index]] = NodeIndex;
+        }
+
+        Statistics.NumLeaves++;
+        return;
+    }
+
+    // Nodes can be reallocated by the children, so only indices are used from here on
+    const uint32 LeftChild = Nodes.Size();
+    Nodes.EmplaceBack();
+    Nodes.EmplaceBack();
+
+    Nodes[NodeIndex].LeftChild  = LeftChild;
+    Nodes[LeftChild].Parent     = NodeIndex;
+    Nodes[LeftChild + 1].Parent = NodeIndex;
+
+    BuildNode(LeftChild, FirstObject, SplitObject - FirstObject, Depth + 1);
+    BuildNode(LeftChild + 1, SplitObject, (FirstObject + NumObjects) - SplitObject, Depth + 1);
+}
+
+uint32 BoundingVolumeHierarchy::FindSplit(const BVHNode& Node, uint32 Depth)
+{
+    const uint32 FirstObject = Node.FirstObject;
+    const uint32 NumObjects  = Node.NumObjects;
+    const uint32 EndObject   = FirstObject + NumObjects;
+    if (NumObjects <= 1 || Depth >= BVH_MAX_DEPTH)
+    {
+        return FirstObject;
+    }
+
+    XMFLOAT3 CentroidMin = Centroids[ObjectIndices[FirstObject]];
+    XMFLOAT3 CentroidMax = CentroidMin;
+    for (uint32 Index = FirstObject + 1; Index < EndObject; Index++)
+    {
+        const XMFLOAT3& Centroid = Centroids[ObjectIndices[Index]];
+        GrowBounds(CentroidMin, CentroidMax, Centroid, Centroid);
+    }
+
+    struct Bin
+    {
+        XMFLOAT3 Min;
+        XMFLOAT3 Max;
+        uint32   NumObjects;
+    };
+
+    float  BestCost = FLT_MAX;
+    uint32 BestAxis = 0;
+    uint32 BestBin  = 0;
+    for (uint32 Axis = 0; Axis < 3; Axis++)
+    {
+        const float AxisMin    = GetAxis(CentroidMin, Axis);
+        const float AxisExtent = GetAxis(CentroidMax, Axis) - AxisMin;
+        if (AxisExtent <= 0.0f)
+        {
+            continue;
+        }
+
+        Bin Bins[BVH_NUM_SAH_BINS];
+        for (Bin& CurrentBin : Bins)
+        {
+            CurrentBin.Min        = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+            CurrentBin.Max        = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            CurrentBin.NumObjects = 0;
+        }
+
+        const float BinScale = float(BVH_NUM_SAH_BINS) / AxisExtent;
+        for (uint32 Index = FirstObject; Index < EndObject; Index++)
+        {
+            const uint32 Object   = ObjectIndices[Index];
+            const uint32 BinIndex = std::min(uint32((GetAxis(Centroids[Object], Axis) - AxisMin) * BinScale), BVH_NUM_SAH_BINS - 1);
+
+            XMFLOAT3 BoxMin;
+            XMFLOAT3 BoxMax;
+            GetBoxBounds(*Boxes, Object, BoxMin, BoxMax);
+
+            Bin& CurrentBin = Bins[BinIndex];
+            GrowBounds(CurrentBin.Min, CurrentBin.Max, BoxMin, BoxMax);
+            CurrentBin.NumObjects++;
+        }
+
+        // Sweep from the left and store the area and count of the bins to the left of each possible split
+        float  LeftArea[BVH_NUM_SAH_BINS - 1];
+        uint32 LeftCount[BVH_NUM_SAH_BINS - 1];
+
+        XMFLOAT3 Min      = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+        XMFLOAT3 Max      = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        uint32   NumInBox = 0;
+        for (uint32 BinIndex = 0; BinIndex < BVH_NUM_SAH_BINS - 1; BinIndex++)
+        {
+            if (Bins[BinIndex].NumObjects > 0)
+            {
+                GrowBounds(Min, Max, Bins[BinIndex].Min, Bins[BinIndex].Max);
+                NumInBox += Bins[BinIndex].NumObjects;
+            }
+
+            LeftArea[BinIndex]  = NumInBox > 0 ? GetSurfaceArea(Min, Max) : 0.0f;
+            LeftCount[BinIndex] = NumInBox;
+        }
+
+        // Sweep from the right, a split at BinIndex puts the bins [0, BinIndex) to the left
+        Min      = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+        Max      = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        NumInBox = 0;
+        for (uint32 BinIndex = BVH_NUM_SAH_BINS - 1; BinIndex > 0; BinIndex--)
+        {
+            if (Bins[BinIndex].NumObjects > 0)
+            {
+                GrowBounds(Min, Max, Bins[BinIndex].Min, Bins[BinIndex].Max);
+                NumInBox += Bins[BinIndex].NumObjects;
+            }
+
+            const uint32 NumLeft = LeftCount[BinIndex - 1];
+            if (NumLeft == 0 || NumInBox == 0)
+            {
+                continue;
+            }
+
+            const float Cost = (float(NumLeft) * LeftArea[BinIndex - 1]) + (float(NumInBox) * GetSurfaceArea(Min, Max));
+            if (Cost < BestCost)
+            {
+                BestCost = Cost;
+                BestAxis = Axis;
+                BestBin  = BinIndex;
+            }
+        }
+    }
+
+    uint32* Objects = ObjectIndices.Data();
+    if (BestCost == FLT_MAX)
+    {
+        // All centroids are in the same place
+        if (NumObjects <= BVH_MAX_OBJECTS_PER_LEAF)
+        {
+            return FirstObject;
+        }
+        else
+        {
+            return FirstObject + (NumObjects / 2);
+        }
+    }
+
+    // Traversing a node costs as much as testing one object
+    const float NodeArea  = GetSurfaceArea(Node.Min, Node.Max);
+    const float LeafCost  = float(NumObjects) * NodeArea;
+    const float SplitCost = NodeArea + BestCost;
+    if (NumObjects <= BVH_MAX_OBJECTS_PER_LEAF && LeafCost <= SplitCost)
+    {
+        return FirstObject;
+    }
+
+    // The bin index has to be calculated exactly the same way as when the bins were filled
+    const float AxisMin  = GetAxis(CentroidMin, BestAxis);
+    const float BinScale = float(BVH_NUM_SAH_BINS) / (GetAxis(CentroidMax, BestAxis) - AxisMin);
+    uint32* SplitPosition = std::partition(Objects + FirstObject, Objects + EndObject, [&](uint32 Object)
+    {
+        const uint32 BinIndex = std::min(uint32((GetAxis(Centroids[Object], BestAxis) - AxisMin) * BinScale), BVH_NUM_SAH_BINS - 1);
+        return BinIndex < BestBin;
+    });
+
+    const uint32 SplitObject = uint32(SplitPosition - Objects);
+    Assert(SplitObject > FirstObject && SplitObject < EndObject);
+    return SplitObject;
+}
+
+/*
+* Refit
+*/
+
+void BoundingVolumeHierarchy::CalculateLeafBounds(BVHNode& Node) const
+{
+    Node.Min = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+    Node.Max = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (uint32 Index = Node.FirstObject; Index < Node.FirstObject + Node.NumObjects; Index++)
+    {
+        XMFLOAT3 BoxMin;
+        XMFLOAT3 BoxMax;
+        GetBoxBounds(*Boxes, ObjectIndices[Index], BoxMin, BoxMax);
+        GrowBounds(Node.Min, Node.Max, BoxMin, BoxMax);
+    }
+}
+
+void BoundingVolumeHierarchy::CalculateInternalBounds(BVHNode& Node) const
+{
+    const BVHNode& Left  = Nodes[Node.LeftChild];
+    const BVHNode& Right = Nodes[Node.LeftChild + 1];
+    Node.Min = Left.Min;
+    Node.Max = Left.Max;
+    GrowBounds(Node.Min, Node.Max, Right.Min, Right.Max);
+}
+
+void BoundingVolumeHierarchy::Refit()
+{
+    TRACE_SCOPE("Refit BVH");
+
+    // Children are always stored after their parent
+    CostSum = 0.0;
+    for (uint32 NodeIndex = Nodes.Size(); NodeIndex > 0; NodeIndex--)
+    {
+        BVHNode& Node = Nodes[NodeIndex - 1];
+        if (Node.IsLeaf())
+        {
+            CalculateLeafBounds(Node);
+        }
+        else
+        {
+            CalculateInternalBounds(Node);
+        }
+
+        CostSum += GetNodeCost(Node);
+    }
+
+    Statistics.NumRefits++;
+}
+
+void BoundingVolumeHierarchy::Refit(const TArray<uint32>& MovedObjects)
+{
+    // Walking up from every object visits the top of the tree many times, when a large part of the scene has moved
+    // it is faster to refit all nodes once
+    if (MovedObjects.Size() * 4 > Nodes.Size())
+    {
+        Refit();
+        return;
+    }
+
+    TRACE_SCOPE("Refit BVH");
+
+    // The cost is updated with the difference of each node that changes, and the walk stops at the first node whose
+    // bounds stay the same, since the nodes above it do not change either
+    for (uint32 Object : MovedObjects)
+    {
+        uint32 NodeIndex = ObjectLeaves[Object];
+        while (NodeIndex != BVH_INVALID_NODE)
+        {
+            BVHNode& Node = Nodes[NodeIndex];
+            const XMFLOAT3 OldMin = Node.Min;
+            const XMFLOAT3 OldMax = Node.Max;
+            const double   OldCost = GetNodeCost(Node);
+
+            if (Node.IsLeaf())
+            {
+                CalculateLeafBounds(Node);
+            }
+            else
+            {
+                CalculateInternalBounds(Node);
+            }
+
+            if (IsBoundsEqual(Node, OldMin, OldMax))
+            {
+                break;
+            }
+
+            CostSum += GetNodeCost(Node) - OldCost;
+            NodeIndex = Node.Parent;
+        }
+    }
+
+    Statistics.NumRefits++;
+}
+
+bool BoundingVolumeHierarchy::Update(const TArray<uint32>& MovedObjects)
+{
+    Assert(Boxes != nullptr);
+
+    if (Boxes->Size() != ObjectLeaves.Size())
+    {
+        Build(*Boxes);
+        return true;
+    }
+
+    if (MovedObjects.IsEmpty() || Nodes.IsEmpty())
+    {
+        return false;
+    }
+
+    Refit(MovedObjects);
+
+    // The cost is kept up to date by the refit, recalculating it would visit every node even when one object moved
+    Statistics.Cost = float(CostSum / std::max(double(GetSurfaceArea(Nodes[0].Min, Nodes[0].Max)), double(FLT_MIN)));
+    if (Statistics.Cost > Statistics.BuildCost * BVH_REBUILD_COST_RATIO)
+    {
+        Build(*Boxes);
+        return true;
+    }
+
+    return false;
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+    Boxes = nullptr;
+    Nodes.Clear();
+    ObjectIndices.Clear();
+    ObjectLeaves.Clear();
+    Centroids.Clear();
+    Statistics = BVHStatistics();
+    CostSum    = 0.0;
+}
+
+float BoundingVolumeHierarchy::CalculateCost() const
+{
+    if (Nodes.IsEmpty())
+    {
+        return 0.0f;
+    }
+
+    float Cost = 0.0f;
+    for (const BVHNode& Node : Nodes)
+    {
+        const float Area = GetSurfaceArea(Node.Min, Node.Max);
+        Cost += Node.IsLeaf() ? Area * float(Node.NumObjects) : Area;
+    }
+
+    return Cost / std::max(GetSurfaceArea(Nodes[0].Min, Nodes[0].Max), FLT_MIN);
+}
+
+/*
+* Queries
+*   A node that is fully inside the query volume adds all objects in its range without visiting the children. The
+*   traversal stack never holds more than one node per level plus the root.
+*/
+
+void BoundingVolumeHierarchy::QueryFrustum(const Frustum& Frustum, TArray<uint64>& OutVisibilityMask) const
+{
+    OutVisibilityMask.Resize(GetVisibilityMaskSize(ObjectLeaves.Size()));
+    QueryFrustum(Frustum, OutVisibilityMask.Data());
+}
+
+void BoundingVolumeHierarchy::QueryFrustum(const Frustum& Frustum, uint64* OutVisibilityMask) const
+{
+    TRACE_SCOPE("BVH Frustum Query");
+
+    memset(OutVisibilityMask, 0, GetVisibilityMaskSize(ObjectLeaves.Size()) * sizeof(uint64));
+    if (Nodes.IsEmpty())
+    {
+        return;
+    }
+
+    XMFLOAT4 Planes[6];
+    XMFLOAT3 AbsNormals[6];
+    for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+    {
+        Planes[PlaneIndex]     = Frustum.GetPlane(PlaneIndex);
+        AbsNormals[PlaneIndex] = XMFLOAT3(fabsf(Planes[PlaneIndex].x), fabsf(Planes[PlaneIndex].y), fabsf(Planes[PlaneIndex].z));
+    }
+
+    // The planes that a node is fully in front of do not need to be tested for its children
+    struct StackEntry
+    {
+        uint32 NodeIndex;
+        uint32 PlaneMask;
+    };
+
+    StackEntry Stack[BVH_MAX_DEPTH + 2];
+    uint32     StackSize = 0;
+    Stack[StackSize++] = { 0, 0x3f };
+
+    while (StackSize > 0)
+    {
+        const StackEntry Entry = Stack[--StackSize];
+        const BVHNode&   Node  = Nodes[Entry.NodeIndex];
+
+        const XMFLOAT3 Center((Node.Min.x + Node.Max.x) * 0.5f, (Node.Min.y + Node.Max.y) * 0.5f, (Node.Min.z + Node.Max.z) * 0.5f);
+        const XMFLOAT3 Extent((Node.Max.x - Node.Min.x) * 0.5f, (Node.Max.y - Node.Min.y) * 0.5f, (Node.Max.z - Node.Min.z) * 0.5f);
+
+        uint32 PlaneMask = Entry.PlaneMask;
+        bool   IsOutside = false;
+        for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+        {
+            if ((PlaneMask & BIT(PlaneIndex)) == 0)
+            {
+                continue;
+            }
+
+            const XMFLOAT4& Plane = Planes[PlaneIndex];
+            const float Distance  = (Center.x * Plane.x) + (Center.y * Plane.y) + (Center.z * Plane.z) + Plane.w;
+            const float Radius    = (Extent.x * AbsNormals[PlaneIndex].x) + (Extent.y * AbsNormals[PlaneIndex].y) + (Extent.z * AbsNormals[PlaneIndex].z);
+            if (Distance + Radius < 0.0f)
+            {
+                IsOutside = true;
+                break;
+            }
+            else if (Distance - Radius >= 0.0f)
+            {
+                PlaneMask &= ~BIT(PlaneIndex);
+            }
+        }
+
+        if (IsOutside)
+        {
+            continue;
+        }
+
+        if (PlaneMask == 0)
+        {
+            for (uint32 Index = Node.FirstObject; Index < Node.FirstObject + Node.NumObjects; Index++)
+            {
+                SetVisibleBit(OutVisibilityMask, ObjectIndices[Index]);
+            }
+        }
+        else if (Node.IsLeaf())
+        {
+            // Same order of operations as CullBoundingBoxes
+            for (uint32 Index = Node.FirstObject; Index < Node.FirstObject + Node.NumObjects; Index++)
+            {
+                const uint32 Object = ObjectIndices[Index];
+
+                bool IsVisible = true;
+                for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+                {
+                    if ((PlaneMask & BIT(PlaneIndex)) == 0)
+                    {
+                        continue;
+                    }
+
+                    const XMFLOAT4& Plane = Planes[PlaneIndex];
+                    float Distance = Boxes->GetCenterX()[Object] * Plane.x + Plane.w;
+                    Distance = Distance + Boxes->GetCenterY()[Object] * Plane.y;
+                    Distance = Distance + Boxes->GetCenterZ()[Object] * Plane.z;
+
+                    float Radius = Boxes->GetExtentX()[Object] * AbsNormals[PlaneIndex].x;
+                    Radius = Radius + Boxes->GetExtentY()[Object] * AbsNormals[PlaneIndex].y;
+                    Radius = Radius + Boxes->GetExtentZ()[Object] * AbsNormals[PlaneIndex].z;
+
+                    if (!(Distance + Radius >= 0.0f))
+                    {
+                        IsVisible = false;
+                        break;
+                    }
+                }
+
+                if (IsVisible)
+                {
+                    SetVisibleBit(OutVisibilityMask, Object);
+                }
+            }
+        }
+        else
+        {
+            Stack[StackSize++] = { Node.LeftChild + 1, PlaneMask };
+            Stack[StackSize++] = { Node.LeftChild, PlaneMask };
+        }
+    }
+}
+
+// Squared distance from the point to the closest point in the box
+static float GetSquaredDistanceToBox(const XMFLOAT3& Point, const XMFLOAT3& Min, const XMFLOAT3& Max)
+{
+    const float DeltaX = Point.x - std::min(std::max(Point.x, Min.x), Max.x);
+    const float DeltaY = Point.y - std::min(std::max(Point.y, Min.y), Max.y);
+    const float DeltaZ = Point.z - std::min(std::max(Point.z, Min.z), Max.z);
+    return (DeltaX * DeltaX) + (DeltaY * DeltaY) + (DeltaZ * DeltaZ);
+}
+
+// Squared distance from the point to the corner of the box that is furthest away
+static float GetSquaredDistanceToFurthestCorner(const XMFLOAT3& Point, const XMFLOAT3& Min, const XMFLOAT3& Max)
+{
+    const float DeltaX = std::max(fabsf(Point.x - Min.x), fabsf(Point.x - Max.x));
+    const float DeltaY = std::max(fabsf(Point.y - Min.y), fabsf(Point.y - Max.y));
+    const float DeltaZ = std::max(fabsf(Point.z - Min.z), fabsf(Point.z - Max.z));
+    return (DeltaX * DeltaX) + (DeltaY * DeltaY) + (DeltaZ * DeltaZ);
+}
+
+void BoundingVolumeHierarchy::QuerySphere(const XMFLOAT3& Center, float Radius, TArray<uint32>& OutObjects) const
+{
+    OutObjects.Clear();
+    if (Nodes.IsEmpty())
+    {
+        return;
+    }
+
+    const float SquaredRadius = Radius * Radius;
+
+    uint32 Stack[BVH_MAX_DEPTH + 2];
+    uint32 StackSize = 0;
+    Stack[StackSize++] = 0;
+
+    while (StackSize > 0)
+    {
+        const BVHNode& Node = Nodes[Stack[--StackSize]];
+        if (GetSquaredDistanceToBox(Center, Node.Min, Node.Max) > SquaredRadius)
+        {
+            continue;
+        }
+
+        if (GetSquaredDistanceToFurthestCorner(Center, Node.Min, Node.Max) <= SquaredRadius)
+        {
+            for (uint32 Index = Node.FirstObject; Index < Node.FirstObject + Node.NumObjects; Index++)
+            {
+                OutObjects.EmplaceBack(ObjectIndices[Index]);
+            }
+        }
+        else if (Node.IsLeaf())
+        {
+            for (uint32 Index = Node.FirstObject; Index < Node.FirstObject + Node.NumObjects; Index++)
+            {
+                XMFLOAT3 BoxMin;
+                XMFLOAT3 BoxMax;
+                GetBoxBounds(*Boxes, ObjectIndices[Index], BoxMin, BoxMax);
+                if (GetSquaredDistanceToBox(Center, BoxMin, BoxMax) <= SquaredRadius)
+                {
+                    OutObjects.EmplaceBack(ObjectIndices[Index]);
+                }
+            }
+        }
+        else
+        {
+            Stack[StackSize++] = Node.LeftChild + 1;
+            Stack[StackSize++] = Node.LeftChild;
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::QueryAABB(const AABB& Box, TArray<uint32>& OutObjects) const
+{
+    OutObjects.Clear();
+    if (Nodes.IsEmpty())
+    {
+        return;
+    }
+
+    // The corners of an AABB are not required to be sorted
+    const XMFLOAT3 Min(std::min(Box.Top.x, Box.Bottom.x), std::min(Box.Top.y, Box.Bottom.y), std::min(Box.Top.z, Box.Bottom.z));
+    const XMFLOAT3 Max(std::max(Box.Top.x, Box.Bottom.x), std::max(Box.Top.y, Box.Bottom.y), std::max(Box.Top.z, Box.Bottom.z));
+
+    auto IsOverlapping = [&](const XMFLOAT3& OtherMin, const XMFLOAT3& OtherMax)
+    {
+        return OtherMin.x <= Max.x && OtherMax.x >= Min.x && OtherMin.y <= Max.y && OtherMax.y >= Min.y && OtherMin.z <= Max.z && OtherMax.z >= Min.z;
+    };
+
+    auto IsContained = [&](const XMFLOAT3& OtherMin, const XMFLOAT3& OtherMax)
+    {
+        return OtherMin.x >= Min.x && OtherMax.x <= Max.x && OtherMin.y >= Min.y && OtherMax.y <= Max.y && OtherMin.z >= Min.z && OtherMax.z <= Max.z;
+    };
+
+    uint32 Stack[BVH_MAX_DEPTH + 2];
+    uint32 StackSize = 0;
+    Stack[StackSize++] = 0;
+
+    while (StackSize > 0)
+    {
+        const BVHNode& Node = Nodes[Stack[--StackSize]];
+        if (!IsOverlapping(Node.Min, Node.Max))
+        {
+            continue;
+        }
+
+        if (IsContained(Node.Min, Node.Max))
+        {
+            for (uint32 Index = Node.FirstObject; Index < Node.FirstObject + Node.NumObjects; Index++)
+            {
+                OutObjects.EmplaceBack(ObjectIndices[Index]);
+            }
+        }
+        else if (Node.IsLeaf())
+        {
+            for (uint32 Index = Node.FirstObject; Index < Node.FirstObject + Node.NumObjects; Index++)
+            {
+                XMFLOAT3 BoxMin;
+                XMFLOAT3 BoxMax;
+                GetBoxBounds(*Boxes, ObjectIndices[Index], BoxMin, BoxMax);
+                if (IsOverlapping(BoxMin, BoxMax))
+                {
+                    OutObjects.EmplaceBack(ObjectIndices[Index]);
+                }
+            }
+        }
+        else
+        {
+            Stack[StackSize++] = Node.LeftChild + 1;
+            Stack[StackSize++] = Node.LeftChild;
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::QueryRay(const XMFLOAT3& Origin, const XMFLOAT3& Direction, float MaxDistance, TArray<BVHRayHit>& OutHits) const
+{
+    OutHits.Clear();
+    if (Nodes.IsEmpty())
+    {
+        return;
+    }
+
+    // Division by zero gives an infinity with the correct sign, which the slab test handles
+    const XMFLOAT3 InvDirection(1.0f / Direction.x, 1.0f / Direction.y, 1.0f / Direction.z);
+
+    // Returns the distance to where the ray enters the box, or a negative value if it misses
+    auto IntersectBox = [&](const XMFLOAT3& Min, const XMFLOAT3& Max)
+    {
+        const float NearX = (Min.x - Origin.x) * InvDirection.x;
+        const float FarX  = (Max.x - Origin.x) * InvDirection.x;
+        const float NearY = (Min.y - Origin.y) * InvDirection.y;
+        const float FarY  = (Max.y - Origin.y) * InvDirection.y;
+        const float NearZ = (Min.z - Origin.z) * InvDirection.z;
+        const float FarZ  = (Max.z - Origin.z) * InvDirection.z;
+
+        const float Enter = std::max(std::max(std::min(NearX, FarX), std::min(NearY, FarY)), std::max(std::min(NearZ, FarZ), 0.0f));
+        const float Exit  = std::min(std::min(std::max(NearX, FarX), std::max(NearY, FarY)), std::min(std::max(NearZ, FarZ), MaxDistance));
+        return Enter <= Exit ? Enter : -1.0f;
+    };
+
+    uint32 Stack[BVH_MAX_DEPTH + 2];
+    uint32 StackSize = 0;
+    Stack[StackSize++] = 0;
+
+    while (StackSize > 0)
+    {
+        const BVHNode& Node = Nodes[Stack[--StackSize]];
+        if (IntersectBox(Node.Min, Node.Max) < 0.0f)
+        {
+            continue;
+        }
+
+        if (Node.IsLeaf())
+        {
+            for (uint32 Index = Node.FirstObject; Index < Node.FirstObject + Node.NumObjects; Index++)
+            {
+                XMFLOAT3 BoxMin;
+                XMFLOAT3 BoxMax;
+                GetBoxBounds(*Boxes, ObjectIndices[Index], BoxMin, BoxMax);
+
+                const float Distance = IntersectBox(BoxMin, BoxMax);
+                if (Distance >= 0.0f)
+                {
+                    OutHits.EmplaceBack(BVHRayHit{ ObjectIndices[Index], Distance });
+                }
+            }
+        }
+        else
+        {
+            Stack[StackSize++] = Node.LeftChild + 1;
+            Stack[StackSize++] = Node.LeftChild;
+        }
+    }
+
+    std::sort(OutHits.Data(), OutHits.Data() + OutHits.Size(), [](const BVHRayHit& First, const BVHRayHit& Second)
+    {
+        return First.Distance < Second.Distance;
+    });
+}
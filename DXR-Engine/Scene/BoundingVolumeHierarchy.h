@@ -0,0 +1,130 @@
+#pragma once
+#include "FrustumCulling.h"
+
+constexpr uint32 BVH_INVALID_NODE         = uint32(~0);
+constexpr uint32 BVH_MAX_OBJECTS_PER_LEAF = 4;
+constexpr uint32 BVH_NUM_SAH_BINS         = 16;
+
+// Nodes at this depth are always leaves, which bounds the size of the traversal stack
+constexpr uint32 BVH_MAX_DEPTH = 64;
+
+// The tree is rebuilt when refitting has made the SAH cost this much worse than right after the last build
+constexpr float BVH_REBUILD_COST_RATIO = 1.5f;
+
+struct BVHNode
+{
+    XMFLOAT3 Min;
+    XMFLOAT3 Max;
+
+    // The right child is always LeftChild + 1, BVH_INVALID_NODE for leaves
+    uint32 LeftChild = BVH_INVALID_NODE;
+    uint32 Parent    = BVH_INVALID_NODE;
+
+    // Every subtree owns a contiguous range of the object indices, which lets a query that finds a node fully inside
+    // the volume add all objects below it without visiting the children
+    uint32 FirstObject = 0;
+    uint32 NumObjects  = 0;
+
+    bool IsLeaf() const { return LeftChild == BVH_INVALID_NODE; }
+};
+
+struct BVHRayHit
+{
+    uint32 ObjectIndex;
+
+    // Distance along the ray to where it enters the bounding box of the object
+    float Distance;
+};
+
+struct BVHStatistics
+{
+    uint32 NumNodes  = 0;
+    uint32 NumLeaves = 0;
+    uint32 MaxDepth  = 0;
+    uint32 NumBuilds = 0;
+    uint32 NumRefits = 0;
+
+    // SAH cost relative to the surface area of the root, right after the last build and after the last refit
+    float BuildCost = 0.0f;
+    float Cost      = 0.0f;
+};
+
+/*
+* Bounding volume hierarchy over the world space bounding boxes of the objects in a scene. The tree is built with a
+* binned surface area heuristic. When objects move the bounds of the nodes above them are refitted, which keeps the
+* topology and gets slower to query as the objects drift apart, so the tree is rebuilt once the SAH cost has grown by
+* BVH_REBUILD_COST_RATIO.
+*
+* The tree keeps a pointer to the boxes that it was built from, which must stay alive and keep the same number of
+* boxes until the next Build. Object indices are the indices of the boxes.
+*/
+
+class BoundingVolumeHierarchy
+{
+public:
+    BoundingVolumeHierarchy()  = default;
+    ~BoundingVolumeHierarchy() = default;
+
+    void Build(const BoundingBoxSoA& InBoxes);
+
+    // Recalculates the bounds of every node
+    void Refit();
+
+    // Recalculates the bounds of the leaves of the moved objects and of the nodes above them
+    void Refit(const TArray<uint32>& MovedObjects);
+
+    // Refits the tree, or rebuilds it when the number of boxes has changed or the quality has dropped too much.
+    // Returns true if the tree was rebuilt.
+    bool Update(const TArray<uint32>& MovedObjects);
+
+    void Clear();
+
+    // Sets the bit of every object whose box intersects the frustum, the same way as CullBoundingBoxes. The mask must
+    // have room for GetVisibilityMaskSize(number of boxes) words.
+    void QueryFrustum(const Frustum& Frustum, TArray<uint64>& OutVisibilityMask) const;
+    void QueryFrustum(const Frustum& Frustum, uint64* OutVisibilityMask) const;
+
+    void QuerySphere(const XMFLOAT3& Center, float Radius, TArray<uint32>& OutObjects) const;
+    void QueryAABB(const AABB& Box, TArray<uint32>& OutObjects) const;
+
+    // Returns the objects whose boxes are hit within MaxDistance sorted from front to back, the direction does not
+    // need to be normalized but the distances are then in units of its length
+    void QueryRay(const XMFLOAT3& Origin, const XMFLOAT3& Direction, float MaxDistance, TArray<BVHRayHit>& OutHits) const;
+
+    // Sum of the surface areas of the internal nodes and of the leaves times their number of objects, relative to
+    // the surface area of the root. Visits every node, Update keeps the cost in the statistics up to date without this.
+    float CalculateCost() const;
+
+    bool IsEmpty() const { return Nodes.IsEmpty(); }
+
+    uint32 GetNumObjects() const { return ObjectLeaves.Size(); }
+
+    const TArray<BVHNode>& GetNodes() const { return Nodes; }
+    const BVHStatistics& GetStatistics() const { return Statistics; }
+
+private:
+    void BuildNode(uint32 NodeIndex, uint32 FirstObject, uint32 NumObjects, uint32 Depth);
+
+    // Returns the index into ObjectIndices where the right half starts, equal to FirstObject if no split is better
+    // than keeping the objects in a single leaf
+    uint32 FindSplit(const BVHNode& Node, uint32 Depth);
+
+    void CalculateLeafBounds(BVHNode& Node) const;
+    void CalculateInternalBounds(BVHNode& Node) const;
+
+    const BoundingBoxSoA* Boxes = nullptr;
+
+    TArray<BVHNode> Nodes;
+    TArray<uint32>  ObjectIndices;
+
+    // The leaf that each object is in
+    TArray<uint32> ObjectLeaves;
+
+    // Centers of the boxes, only used during Build
+    TArray<XMFLOAT3> Centroids;
+
+    // The cost before it is divided by the surface area of the root, updated by the refits
+    double CostSum = 0.0;
+
+    BVHStatistics Statistics;
+};
@@ -0,0 +1,179 @@
+#include "ComponentStorage.h"
+
+void ComponentArray::Add(Component* InComponent, uint32 Slot)
+{
+    if (Slot >= DenseIndices.Size())
+    {
+        DenseIndices.Resize(Slot + 1, COMPONENT_INVALID_INDEX);
+    }
+
+    Assert(DenseIndices[Slot] == COMPONENT_INVALID_INDEX);
+    DenseIndices[Slot] = Components.Size();
+
+    Components.EmplaceBack(InComponent);
+    Actors.EmplaceBack(InComponent->GetOwningActor());
+    Slots.EmplaceBack(Slot);
+}
+
+void ComponentArray::Remove(uint32 Slot)
+{
+    Assert(Slot < DenseIndices.Size());
+
+    const uint32 Index = DenseIndices[Slot];
+    Assert(Index != COMPONENT_INVALID_INDEX);
+
+    // Move the last component into the hole
+    const uint32 LastIndex = Components.Size() - 1;
+    if (Index != LastIndex)
+    {
+        Components[Index] = Components[LastIndex];
+        Actors[Index]     = Actors[LastIndex];
+        Slots[Index]      = Slots[LastIndex];
+        DenseIndices[Slots[Index]] = Index;
+    }
+
+    Components.PopBack();
+    Actors.PopBack();
+    Slots.PopBack();
+    DenseIndices[Slot] = COMPONENT_INVALID_INDEX;
+}
+
+ComponentHandle ComponentStorage::Add(Component* InComponent)
+{
+    Assert(InComponent != nullptr);
+    Assert(!InComponent->GetHandle().IsValid());
+
+    uint32 Slot;
+    if (!FreeSlots.IsEmpty())
+    {
+        Slot = FreeSlots.Back();
+        FreeSlots.PopBack();
+    }
+    else
+    {
+        Slot = ComponentSlots.Size();
+        ComponentSlots.EmplaceBack();
+    }
+
+    ComponentSlot& NewSlot = ComponentSlots[Slot];
+    NewSlot.Pointer = InComponent;
+
+    // Component itself is included, which makes it possible to iterate every component in the scene
+    const ClassType* ComponentClass = Component::GetStaticClass();
+    for (const ClassType* Class = InComponent->GetClass(); Class; Class = Class->GetSuperClass())
+    {
+        FindOrAddArray(Class).Add(InComponent, Slot);
+        if (Class == ComponentClass)
+        {
+            break;
+        }
+    }
+
+    NumComponents++;
+
+    ComponentHandle Handle;
+    Handle.Slot       = Slot;
+    Handle.Generation = NewSlot.Generation;
+    InComponent->Handle = Handle;
+    return Handle;
+}
+
+void ComponentStorage::Remove(ComponentHandle Handle)
+{
+    Component* RemovedComponent = Get(Handle);
+    if (!RemovedComponent)
+    {
+        return;
+    }
+
+    const ClassType* ComponentClass = Component::GetStaticClass();
+    for (const ClassType* Class = RemovedComponent->GetClass(); Class; Class = Class->GetSuperClass())
+    {
+        for (ComponentArray& Array : Arrays)
+        {
+            if (Array.Class == Class)
+            {
+                Array.Remove(Handle.Slot);
+                break;
+            }
+        }
+
+        if (Class == ComponentClass)
+        {
+            break;
+        }
+    }
+
+    // Bumping the generation makes all copies of the handle invalid
+    ComponentSlot& Slot = ComponentSlots[Handle.Slot];
+    Slot.Pointer = nullptr;
+    Slot.Generation++;
+    FreeSlots.EmplaceBack(Handle.Slot);
+
+    RemovedComponent->Handle = ComponentHandle();
+    NumComponents--;
+}
+
+void ComponentStorage::Clear()
+{
+    for (ComponentSlot& Slot : ComponentSlots)
+    {
+        if (Slot.Pointer)
+        {
+            Slot.Pointer->Handle = ComponentHandle();
+        }
+    }
+
+    Arrays.Clear();
+    ComponentSlots.Clear();
+    FreeSlots.Clear();
+    NumComponents = 0;
+}
+
+Component* ComponentStorage::Get(ComponentHandle Handle) const
+{
+    if (Handle.Slot >= ComponentSlots.Size())
+    {
+        return nullptr;
+    }
+
+    const ComponentSlot& Slot = ComponentSlots[Handle.Slot];
+    return Slot.Generation == Handle.Generation ? Slot.Pointer : nullptr;
+}
+
+uint32 ComponentStorage::GetIndex(const ClassType* Class, ComponentHandle Handle) const
+{
+    const ComponentArray* Array = FindArray(Class);
+    if (!Array || !Get(Handle))
+    {
+        return COMPONENT_INVALID_INDEX;
+    }
+
+    return Array->GetIndex(Handle.Slot);
+}
+
+const ComponentArray* ComponentStorage::FindArray(const ClassType* Class) const
+{
+    for (const ComponentArray& Array : Arrays)
+    {
+        if (Array.Class == Class)
+        {
+            return &Array;
+        }
+    }
+
+    return nullptr;
+}
+
+ComponentArray& ComponentStorage::FindOrAddArray(const ClassType* Class)
+{
+    for (ComponentArray& Array : Arrays)
+    {
+        if (Array.Class == Class)
+        {
+            return Array;
+        }
+    }
+
+    return Arrays.EmplaceBack(Class);
+}
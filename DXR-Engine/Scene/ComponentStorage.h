@@ -0,0 +1,163 @@
+#pragma once
+#include "Actor.h"
+
+#include "Core/Containers/Array.h"
+
+/*
+* Dense array of all components of one class, including the components of its subclasses. Removing a component moves
+* the last component into its place, so the order changes but the arrays never have holes. The owning actor of each
+* component is stored next to it, which lets a system iterate both without touching the components.
+*/
+
+class ComponentArray
+{
+    friend class ComponentStorage;
+
+public:
+    ComponentArray(const ClassType* InClass)
+        : Class(InClass)
+        , Components()
+        , Actors()
+        , Slots()
+        , DenseIndices()
+    {
+    }
+
+    const ClassType* GetClass() const { return Class; }
+
+    uint32 Size() const { return Components.Size(); }
+
+    Component* GetComponent(uint32 Index) const { return Components[Index]; }
+    Component* const* GetComponents() const { return Components.Data(); }
+    Actor* GetActor(uint32 Index) const { return Actors[Index]; }
+
+    // Index of the component in the slot, or COMPONENT_INVALID_INDEX if it is not in this array
+    uint32 GetIndex(uint32 Slot) const
+    {
+        return Slot < DenseIndices.Size() ? DenseIndices[Slot] : COMPONENT_INVALID_INDEX;
+    }
+
+private:
+    void Add(Component* InComponent, uint32 Slot);
+    void Remove(uint32 Slot);
+
+    const ClassType* Class;
+
+    TArray<Component*> Components;
+    TArray<Actor*>     Actors;
+
+    // The slot of each component, and the index into Components of each slot or COMPONENT_INVALID_INDEX
+    TArray<uint32> Slots;
+    TArray<uint32> DenseIndices;
+};
+
+// Iterates the components of a ComponentArray as TComponent
+template<typename TComponent>
+class TComponentView
+{
+public:
+    class Iterator
+    {
+    public:
+        Iterator(Component* const* InPointer)
+            : Pointer(InPointer)
+        {
+        }
+
+        TComponent* operator*() const { return static_cast<TComponent*>(*Pointer); }
+
+        Iterator& operator++()
+        {
+            Pointer++;
+            return *this;
+        }
+
+        bool operator==(const Iterator& Other) const { return Pointer == Other.Pointer; }
+        bool operator!=(const Iterator& Other) const { return Pointer != Other.Pointer; }
+
+    private:
+        Component* const* Pointer;
+    };
+
+    TComponentView(const ComponentArray* InArray)
+        : Array(InArray)
+    {
+    }
+
+    uint32 Size() const { return Array ? Array->Size() : 0; }
+    bool IsEmpty() const { return Size() == 0; }
+
+    TComponent* operator[](uint32 Index) const { return static_cast<TComponent*>(Array->GetComponent(Index)); }
+
+    Actor* GetActor(uint32 Index) const { return Array->GetActor(Index); }
+
+    Iterator begin() const { return Iterator(Array ? Array->GetComponents() : nullptr); }
+    Iterator end() const { return Iterator(Array ? Array->GetComponents() + Array->Size() : nullptr); }
+
+private:
+    const ComponentArray* Array;
+};
+
+/*
+* Stores the components of a scene in one ComponentArray per class, so that all components of a type can be found
+* without visiting every actor. A component is added to the array of its own class and to the arrays of all its
+* super classes up to Component, which makes iterating a base class as cheap as iterating a final class.
+*
+* The components are still owned by their actors, the storage only keeps pointers to them.
+*/
+
+class ComponentStorage
+{
+public:
+    ComponentStorage()  = default;
+    ~ComponentStorage() = default;
+
+    ComponentHandle Add(Component* InComponent);
+    void Remove(ComponentHandle Handle);
+
+    void Clear();
+
+    // Returns nullptr if the component has been removed
+    Component* Get(ComponentHandle Handle) const;
+
+    template<typename TComponent>
+    FORCEINLINE TComponent* Get(ComponentHandle Handle) const
+    {
+        Component* Result = Get(Handle);
+        return Result ? Cast<TComponent>(Result) : nullptr;
+    }
+
+    template<typename TComponent>
+    FORCEINLINE TComponentView<TComponent> GetComponents() const
+    {
+        return TComponentView<TComponent>(FindArray(TComponent::GetStaticClass()));
+    }
+
+    // Index of the component in GetComponents<TComponent>, which changes when another component of the class is removed.
+    // Returns COMPONENT_INVALID_INDEX if the component has been removed or is not a TComponent.
+    template<typename TComponent>
+    FORCEINLINE uint32 GetIndex(ComponentHandle Handle) const
+    {
+        return GetIndex(TComponent::GetStaticClass(), Handle);
+    }
+
+    uint32 GetIndex(const ClassType* Class, ComponentHandle Handle) const;
+
+    uint32 GetNumComponents() const { return NumComponents; }
+
+private:
+    struct ComponentSlot
+    {
+        Component* Pointer    = nullptr;
+        uint32     Generation = 0;
+    };
+
+    // There are only a few component classes, so a linear search is faster than a map
+    const ComponentArray* FindArray(const ClassType* Class) const;
+    ComponentArray& FindOrAddArray(const ClassType* Class);
+
+    TArray<ComponentArray> Arrays;
+    TArray<ComponentSlot>  ComponentSlots;
+    TArray<uint32>         FreeSlots;
+    uint32 NumComponents = 0;
+};
@@ -1,7 +1,7 @@
 #pragma once
 #include "Scene/Actor.h"
 
-class MeshComponent : public Component
+class MeshComponent final : public Component
 {
     CORE_OBJECT(MeshComponent, Component);
 
@@ -22,6 +22,19 @@ void Frustum::Create(float FarPlane, const XMFLOAT4X4& View, const XMFLOAT4X4& P
     XMFLOAT4X4 Matrix;
     XMStoreFloat4x4(&Matrix, XmMatrix);
 
+    ExtractPlanes(Matrix);
+}
+
+void Frustum::CreateFromMatrix(const XMFLOAT4X4& ViewProjection)
+{
+    XMFLOAT4X4 Matrix;
+    XMStoreFloat4x4(&Matrix, XMMatrixTranspose(XMLoadFloat4x4(&ViewProjection)));
+
+    ExtractPlanes(Matrix);
+}
+
+void Frustum::ExtractPlanes(const XMFLOAT4X4& Matrix)
+{
     // Calculate near plane of frustum.
     XMVECTOR XmPlanes[6];
     Planes[0].x = Matrix._14 + Matrix._13;
@@ -78,7 +91,7 @@ void Frustum::Create(float FarPlane, const XMFLOAT4X4& View, const XMFLOAT4X4& P
     XMStoreFloat4(&Planes[5], XmPlanes[5]);
 }
 
-bool Frustum::CheckAABB(const AABB& Box)
+bool Frustum::CheckAABB(const AABB& Box) const
 {
     const XMFLOAT3 Center = Box.GetCenter();
     const float Width     = Box.GetWidth()  / 2.0f;
@@ -98,42 +111,42 @@ bool Frustum::CheckAABB(const AABB& Box)
     for (int32 Index = 0; Index < 6; Index++)
     {
         XMVECTOR Plane = XMLoadFloat4(&Planes[Index]);
-        if (XMPlaneDotCoord(Plane, Coords[0]).m128_f32[0] >= 0.0f)
+        if (XMVectorGetX(XMPlaneDotCoord(Plane, Coords[0])) >= 0.0f)
         {
             continue;
         }
 
-        if (XMPlaneDotCoord(Plane, Coords[1]).m128_f32[0] >= 0.0f)
+        if (XMVectorGetX(XMPlaneDotCoord(Plane, Coords[1])) >= 0.0f)
         {
             continue;
         }
 
-        if (XMPlaneDotCoord(Plane, Coords[2]).m128_f32[0] >= 0.0f)
+        if (XMVectorGetX(XMPlaneDotCoord(Plane, Coords[2])) >= 0.0f)
         {
             continue;
         }
 
-        if (XMPlaneDotCoord(Plane, Coords[3]).m128_f32[0] >= 0.0f)
+        if (XMVectorGetX(XMPlaneDotCoord(Plane, Coords[3])) >= 0.0f)
         {
             continue;
         }
 
-        if (XMPlaneDotCoord(Plane, Coords[4]).m128_f32[0] >= 0.0f)
+        if (XMVectorGetX(XMPlaneDotCoord(Plane, Coords[4])) >= 0.0f)
         {
             continue;
         }
 
-        if (XMPlaneDotCoord(Plane, Coords[5]).m128_f32[0] >= 0.0f)
+        if (XMVectorGetX(XMPlaneDotCoord(Plane, Coords[5])) >= 0.0f)
         {
             continue;
         }
 
-        if (XMPlaneDotCoord(Plane, Coords[6]).m128_f32[0] >= 0.0f)
+        if (XMVectorGetX(XMPlaneDotCoord(Plane, Coords[6])) >= 0.0f)
         {
             continue;
         }
 
-        if (XMPlaneDotCoord(Plane, Coords[7]).m128_f32[0] >= 0.0f)
+        if (XMVectorGetX(XMPlaneDotCoord(Plane, Coords[7])) >= 0.0f)
         {
             continue;
         }
@@ -13,8 +13,20 @@ public:
 
     void Create(float ScreenDepth, const XMFLOAT4X4& View, const XMFLOAT4X4& Projection);
 
-    bool CheckAABB(const AABB& BoundingBox);
+    // The matrix is transposed, the same way as the matrices of the lights, which is used for orthographic shadow maps
+    void CreateFromMatrix(const XMFLOAT4X4& ViewProjection);
+
+    bool CheckAABB(const AABB& BoundingBox) const;
+
+    // Planes are normalized and point into the frustum, in the order near, far, left, right, top and bottom
+    const XMFLOAT4& GetPlane(uint32 Index) const
+    {
+        Assert(Index < 6);
+        return Planes[Index];
+    }
 
 private:
+    void ExtractPlanes(const XMFLOAT4X4& Matrix);
+
     XMFLOAT4 Planes[6];
 };
\ No newline at end of file
@@ -0,0 +1,499 @@
+#include "FrustumCulling.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define CULLING_X64 1
+#else
+    #define CULLING_X64 0
+#endif
+
+#if CULLING_X64
+    #include <immintrin.h>
+    #ifdef COMPILER_VISUAL_STUDIO
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+// MSVC allows intrinsics for any instruction set, other compilers need the instruction set enabled per function
+#if CULLING_X64 && !defined(COMPILER_VISUAL_STUDIO)
+    #define CULLING_TARGET(InstructionSet) __attribute__((target(InstructionSet)))
+#else
+    #define CULLING_TARGET(InstructionSet)
+#endif
+
+/*
+* BoundingBoxSoA
+*/
+
+void BoundingBoxSoA::Reserve(uint32 InNumBoxes)
+{
+    const uint32 PaddedSize = ((InNumBoxes + BOUNDING_BOX_SOA_PADDING - 1) / BOUNDING_BOX_SOA_PADDING) * BOUNDING_BOX_SOA_PADDING;
+    if (PaddedSize > CenterX.Size())
+    {
+        Grow(PaddedSize);
+    }
+}
+
+void BoundingBoxSoA::Add(const XMFLOAT3& Center, const XMFLOAT3& Extent)
+{
+    if (NumBoxes >= CenterX.Size())
+    {
+        // TArray::Resize does not grow geometrically
+        const uint32 NewPaddedSize = std::max<uint32>(CenterX.Size() * 2, BOUNDING_BOX_SOA_PADDING);
+        Grow(NewPaddedSize);
+    }
+
+    CenterX[NumBoxes] = Center.x;
+    CenterY[NumBoxes] = Center.y;
+    CenterZ[NumBoxes] = Center.z;
+    ExtentX[NumBoxes] = Extent.x;
+    ExtentY[NumBoxes] = Extent.y;
+    ExtentZ[NumBoxes] = Extent.z;
+    NumBoxes++;
+}
+
+void BoundingBoxSoA::AddCorners(const XMFLOAT3& First, const XMFLOAT3& Second)
+{
+    const XMFLOAT3 Center((First.x + Second.x) * 0.5f, (First.y + Second.y) * 0.5f, (First.z + Second.z) * 0.5f);
+    const XMFLOAT3 Extent(fabsf(First.x - Second.x) * 0.5f, fabsf(First.y - Second.y) * 0.5f, fabsf(First.z - Second.z) * 0.5f);
+    Add(Center, Extent);
+}
+
+void BoundingBoxSoA::Set(uint32 Index, const XMFLOAT3& Center, const XMFLOAT3& Extent)
+{
+    Assert(Index < NumBoxes);
+
+    CenterX[Index] = Center.x;
+    CenterY[Index] = Center.y;
+    CenterZ[Index] = Center.z;
+    ExtentX[Index] = Extent.x;
+    ExtentY[Index] = Extent.y;
+    ExtentZ[Index] = Extent.z;
+}
+
+void BoundingBoxSoA::Remove(uint32 Index)
+{
+    Assert(Index < NumBoxes);
+
+    const uint32 LastIndex = NumBoxes - 1;
+    CenterX[Index] = CenterX[LastIndex];
+    CenterY[Index] = CenterY[LastIndex];
+    CenterZ[Index] = CenterZ[LastIndex];
+    ExtentX[Index] = ExtentX[LastIndex];
+    ExtentY[Index] = ExtentY[LastIndex];
+    ExtentZ[Index] = ExtentZ[LastIndex];
+    NumBoxes--;
+}
+
+void BoundingBoxSoA::Grow(uint32 NewPaddedSize)
+{
+    Assert(NewPaddedSize % BOUNDING_BOX_SOA_PADDING == 0);
+
+    CenterX.Resize(NewPaddedSize, 0.0f);
+    CenterY.Resize(NewPaddedSize, 0.0f);
+    CenterZ.Resize(NewPaddedSize, 0.0f);
+    ExtentX.Resize(NewPaddedSize, 0.0f);
+    ExtentY.Resize(NewPaddedSize, 0.0f);
+    ExtentZ.Resize(NewPaddedSize, 0.0f);
+}
+
+/*
+* Instruction set detection
+*/
+
+#if CULLING_X64
+static void QueryCPUID(int32 Function, int32 SubFunction, int32 OutRegisters[4])
+{
+#ifdef COMPILER_VISUAL_STUDIO
+    __cpuidex(OutRegisters, Function, SubFunction);
+#else
+    uint32 Eax = 0;
+    uint32 Ebx = 0;
+    uint32 Ecx = 0;
+    uint32 Edx = 0;
+    __cpuid_count(Function, SubFunction, Eax, Ebx, Ecx, Edx);
+
+    OutRegisters[0] = int32(Eax);
+    OutRegisters[1] = int32(Ebx);
+    OutRegisters[2] = int32(Ecx);
+    OutRegisters[3] = int32(Edx);
+#endif
+}
+
+// Register states that the OS saves on a context switch
+static uint64 QueryXCR0()
+{
+#ifdef COMPILER_VISUAL_STUDIO
+    return _xgetbv(0);
+#else
+    uint32 Eax = 0;
+    uint32 Edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(Eax), "=d"(Edx) : "c"(0));
+    return (uint64(Edx) << 32) | Eax;
+#endif
+}
+
+static ECullingInstructionSet QuerySupportedInstructionSet()
+{
+    int32 Registers[4];
+    QueryCPUID(0, 0, Registers);
+    const int32 MaxFunction = Registers[0];
+
+    QueryCPUID(1, 0, Registers);
+    const bool HasOSXSave = (Registers[2] & BIT(27)) != 0;
+    const bool HasAVX     = (Registers[2] & BIT(28)) != 0;
+    if (!HasOSXSave || !HasAVX || MaxFunction < 7)
+    {
+        return ECullingInstructionSet::SSE2;
+    }
+
+    // The OS must save the YMM registers for AVX and the opmask and ZMM registers for AVX-512
+    const uint64 XCR0 = QueryXCR0();
+    const bool OSSavesYMM = (XCR0 & 0x6) == 0x6;
+    const bool OSSavesZMM = (XCR0 & 0xe6) == 0xe6;
+
+    QueryCPUID(7, 0, Registers);
+    const bool HasAVX2    = (Registers[1] & BIT(5)) != 0;
+    const bool HasAVX512F = (Registers[1] & BIT(16)) != 0;
+
+    if (HasAVX512F && OSSavesZMM)
+    {
+        return ECullingInstructionSet::AVX512;
+    }
+    else if (HasAVX2 && OSSavesYMM)
+    {
+        return ECullingInstructionSet::AVX2;
+    }
+    else
+    {
+        return ECullingInstructionSet::SSE2;
+    }
+}
+#endif
+
+ECullingInstructionSet GetSupportedCullingInstructionSet()
+{
+#if CULLING_X64
+    static const ECullingInstructionSet SupportedInstructionSet = QuerySupportedInstructionSet();
+    return SupportedInstructionSet;
+#else
+    return ECullingInstructionSet::Scalar;
+#endif
+}
+
+/*
+* Culling
+*   Each function tests the boxes in [Begin, End), which is at most 64 boxes, and returns one bit per box. All paths
+*   perform the operations in the same order so that the results are exactly the same.
+*/
+
+struct CullingPlane
+{
+    float NormalX;
+    float NormalY;
+    float NormalZ;
+    float Distance;
+    float AbsNormalX;
+    float AbsNormalY;
+    float AbsNormalZ;
+};
+
+static uint64 CullBoxesScalar(const CullingPlane* Planes, const BoundingBoxSoA& Boxes, uint32 Begin, uint32 End)
+{
+    const float* CenterX = Boxes.GetCenterX();
+    const float* CenterY = Boxes.GetCenterY();
+    const float* CenterZ = Boxes.GetCenterZ();
+    const float* ExtentX = Boxes.GetExtentX();
+    const float* ExtentY = Boxes.GetExtentY();
+    const float* ExtentZ = Boxes.GetExtentZ();
+
+    uint64 VisibleBits = 0;
+    for (uint32 Index = Begin; Index < End; Index++)
+    {
+        bool IsVisible = true;
+        for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+        {
+            const CullingPlane& Plane = Planes[PlaneIndex];
+
+            float Distance = CenterX[Index] * Plane.NormalX + Plane.Distance;
+            Distance = Distance + CenterY[Index] * Plane.NormalY;
+            Distance = Distance + CenterZ[Index] * Plane.NormalZ;
+
+            float Radius = ExtentX[Index] * Plane.AbsNormalX;
+            Radius = Radius + ExtentY[Index] * Plane.AbsNormalY;
+            Radius = Radius + ExtentZ[Index] * Plane.AbsNormalZ;
+
+            if (!(Distance + Radius >= 0.0f))
+            {
+                IsVisible = false;
+                break;
+            }
+        }
+
+        if (IsVisible)
+        {
+            VisibleBits |= uint64(1) << (Index - Begin);
+        }
+    }
+
+    return VisibleBits;
+}
+
+#if CULLING_X64
+static uint64 CullBoxesSSE2(const CullingPlane* Planes, const BoundingBoxSoA& Boxes, uint32 Begin, uint32 End)
+{
+    __m128 NormalX[6];
+    __m128 NormalY[6];
+    __m128 NormalZ[6];
+    __m128 Distance[6];
+    __m128 AbsNormalX[6];
+    __m128 AbsNormalY[6];
+    __m128 AbsNormalZ[6];
+    for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+    {
+        NormalX[PlaneIndex]    = _mm_set1_ps(Planes[PlaneIndex].NormalX);
+        NormalY[PlaneIndex]    = _mm_set1_ps(Planes[PlaneIndex].NormalY);
+        NormalZ[PlaneIndex]    = _mm_set1_ps(Planes[PlaneIndex].NormalZ);
+        Distance[PlaneIndex]   = _mm_set1_ps(Planes[PlaneIndex].Distance);
+        AbsNormalX[PlaneIndex] = _mm_set1_ps(Planes[PlaneIndex].AbsNormalX);
+        AbsNormalY[PlaneIndex] = _mm_set1_ps(Planes[PlaneIndex].AbsNormalY);
+        AbsNormalZ[PlaneIndex] = _mm_set1_ps(Planes[PlaneIndex].AbsNormalZ);
+    }
+
+    const __m128 Zero = _mm_setzero_ps();
+
+    uint64 VisibleBits = 0;
+    for (uint32 Index = Begin; Index < End; Index += 4)
+    {
+        const __m128 CenterX = _mm_loadu_ps(Boxes.GetCenterX() + Index);
+        const __m128 CenterY = _mm_loadu_ps(Boxes.GetCenterY() + Index);
+        const __m128 CenterZ = _mm_loadu_ps(Boxes.GetCenterZ() + Index);
+        const __m128 ExtentX = _mm_loadu_ps(Boxes.GetExtentX() + Index);
+        const __m128 ExtentY = _mm_loadu_ps(Boxes.GetExtentY() + Index);
+        const __m128 ExtentZ = _mm_loadu_ps(Boxes.GetExtentZ() + Index);
+
+        __m128 Visible = _mm_cmpeq_ps(Zero, Zero);
+        for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+        {
+            __m128 BoxDistance = _mm_add_ps(_mm_mul_ps(CenterX, NormalX[PlaneIndex]), Distance[PlaneIndex]);
+            BoxDistance = _mm_add_ps(BoxDistance, _mm_mul_ps(CenterY, NormalY[PlaneIndex]));
+            BoxDistance = _mm_add_ps(BoxDistance, _mm_mul_ps(CenterZ, NormalZ[PlaneIndex]));
+
+            __m128 Radius = _mm_mul_ps(ExtentX, AbsNormalX[PlaneIndex]);
+            Radius = _mm_add_ps(Radius, _mm_mul_ps(ExtentY, AbsNormalY[PlaneIndex]));
+            Radius = _mm_add_ps(Radius, _mm_mul_ps(ExtentZ, AbsNormalZ[PlaneIndex]));
+
+            Visible = _mm_and_ps(Visible, _mm_cmpge_ps(_mm_add_ps(BoxDistance, Radius), Zero));
+        }
+
+        VisibleBits |= uint64(_mm_movemask_ps(Visible)) << (Index - Begin);
+    }
+
+    return VisibleBits;
+}
+
+CULLING_TARGET("avx2")
+static uint64 CullBoxesAVX2(const CullingPlane* Planes, const BoundingBoxSoA& Boxes, uint32 Begin, uint32 End)
+{
+    __m256 NormalX[6];
+    __m256 NormalY[6];
+    __m256 NormalZ[6];
+    __m256 Distance[6];
+    __m256 AbsNormalX[6];
+    __m256 AbsNormalY[6];
+    __m256 AbsNormalZ[6];
+    for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+    {
+        NormalX[PlaneIndex]    = _mm256_set1_ps(Planes[PlaneIndex].NormalX);
+        NormalY[PlaneIndex]    = _mm256_set1_ps(Planes[PlaneIndex].NormalY);
+        NormalZ[PlaneIndex]    = _mm256_set1_ps(Planes[PlaneIndex].NormalZ);
+        Distance[PlaneIndex]   = _mm256_set1_ps(Planes[PlaneIndex].Distance);
+        AbsNormalX[PlaneIndex] = _mm256_set1_ps(Planes[PlaneIndex].AbsNormalX);
+        AbsNormalY[PlaneIndex] = _mm256_set1_ps(Planes[PlaneIndex].AbsNormalY);
+        AbsNormalZ[PlaneIndex] = _mm256_set1_ps(Planes[PlaneIndex].AbsNormalZ);
+    }
+
+    const __m256 Zero = _mm256_setzero_ps();
+
+    uint64 VisibleBits = 0;
+    for (uint32 Index = Begin; Index < End; Index += 8)
+    {
+        const __m256 CenterX = _mm256_loadu_ps(Boxes.GetCenterX() + Index);
+        const __m256 CenterY = _mm256_loadu_ps(Boxes.GetCenterY() + Index);
+        const __m256 CenterZ = _mm256_loadu_ps(Boxes.GetCenterZ() + Index);
+        const __m256 ExtentX = _mm256_loadu_ps(Boxes.GetExtentX() + Index);
+        const __m256 ExtentY = _mm256_loadu_ps(Boxes.GetExtentY() + Index);
+        const __m256 ExtentZ = _mm256_loadu_ps(Boxes.GetExtentZ() + Index);
+
+        __m256 Visible = _mm256_cmp_ps(Zero, Zero, _CMP_EQ_OQ);
+        for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+        {
+            __m256 BoxDistance = _mm256_add_ps(_mm256_mul_ps(CenterX, NormalX[PlaneIndex]), Distance[PlaneIndex]);
+            BoxDistance = _mm256_add_ps(BoxDistance, _mm256_mul_ps(CenterY, NormalY[PlaneIndex]));
+            BoxDistance = _mm256_add_ps(BoxDistance, _mm256_mul_ps(CenterZ, NormalZ[PlaneIndex]));
+
+            __m256 Radius = _mm256_mul_ps(ExtentX, AbsNormalX[PlaneIndex]);
+            Radius = _mm256_add_ps(Radius, _mm256_mul_ps(ExtentY, AbsNormalY[PlaneIndex]));
+            Radius = _mm256_add_ps(Radius, _mm256_mul_ps(ExtentZ, AbsNormalZ[PlaneIndex]));
+
+            Visible = _mm256_and_ps(Visible, _mm256_cmp_ps(_mm256_add_ps(BoxDistance, Radius), Zero, _CMP_GE_OQ));
+        }
+
+        VisibleBits |= uint64(_mm256_movemask_ps(Visible)) << (Index - Begin);
+    }
+
+    return VisibleBits;
+}
+
+CULLING_TARGET("avx512f")
+static uint64 CullBoxesAVX512(const CullingPlane* Planes, const BoundingBoxSoA& Boxes, uint32 Begin, uint32 End)
+{
+    __m512 NormalX[6];
+    __m512 NormalY[6];
+    __m512 NormalZ[6];
+    __m512 Distance[6];
+    __m512 AbsNormalX[6];
+    __m512 AbsNormalY[6];
+    __m512 AbsNormalZ[6];
+    for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+    {
+        NormalX[PlaneIndex]    = _mm512_set1_ps(Planes[PlaneIndex].NormalX);
+        NormalY[PlaneIndex]    = _mm512_set1_ps(Planes[PlaneIndex].NormalY);
+        NormalZ[PlaneIndex]    = _mm512_set1_ps(Planes[PlaneIndex].NormalZ);
+        Distance[PlaneIndex]   = _mm512_set1_ps(Planes[PlaneIndex].Distance);
+        AbsNormalX[PlaneIndex] = _mm512_set1_ps(Planes[PlaneIndex].AbsNormalX);
+        AbsNormalY[PlaneIndex] = _mm512_set1_ps(Planes[PlaneIndex].AbsNormalY);
+        AbsNormalZ[PlaneIndex] = _mm512_set1_ps(Planes[PlaneIndex].AbsNormalZ);
+    }
+
+    const __m512 Zero = _mm512_setzero_ps();
+
+    uint64 VisibleBits = 0;
+    for (uint32 Index = Begin; Index < End; Index += 16)
+    {
+        const __m512 CenterX = _mm512_loadu_ps(Boxes.GetCenterX() + Index);
+        const __m512 CenterY = _mm512_loadu_ps(Boxes.GetCenterY() + Index);
+        const __m512 CenterZ = _mm512_loadu_ps(Boxes.GetCenterZ() + Index);
+        const __m512 ExtentX = _mm512_loadu_ps(Boxes.GetExtentX() + Index);
+        const __m512 ExtentY = _mm512_loadu_ps(Boxes.GetExtentY() + Index);
+        const __m512 ExtentZ = _mm512_loadu_ps(Boxes.GetExtentZ() + Index);
+
+        __mmask16 Visible = 0xffff;
+        for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+        {
+            __m512 BoxDistance = _mm512_add_ps(_mm512_mul_ps(CenterX, NormalX[PlaneIndex]), Distance[PlaneIndex]);
+            BoxDistance = _mm512_add_ps(BoxDistance, _mm512_mul_ps(CenterY, NormalY[PlaneIndex]));
+            BoxDistance = _mm512_add_ps(BoxDistance, _mm512_mul_ps(CenterZ, NormalZ[PlaneIndex]));
+
+            __m512 Radius = _mm512_mul_ps(ExtentX, AbsNormalX[PlaneIndex]);
+            Radius = _mm512_add_ps(Radius, _mm512_mul_ps(ExtentY, AbsNormalY[PlaneIndex]));
+            Radius = _mm512_add_ps(Radius, _mm512_mul_ps(ExtentZ, AbsNormalZ[PlaneIndex]));
+
+            Visible = _mm512_mask_cmp_ps_mask(Visible, _mm512_add_ps(BoxDistance, Radius), Zero, _CMP_GE_OQ);
+        }
+
+        VisibleBits |= uint64(Visible) << (Index - Begin);
+    }
+
+    return VisibleBits;
+}
+#endif
+
+typedef uint64(*CullBoxesFunc)(const CullingPlane*, const BoundingBoxSoA&, uint32, uint32);
+
+static CullBoxesFunc GetCullBoxesFunc(ECullingInstructionSet InstructionSet)
+{
+    const ECullingInstructionSet SupportedInstructionSet = GetSupportedCullingInstructionSet();
+    if (InstructionSet > SupportedInstructionSet)
+    {
+        InstructionSet = SupportedInstructionSet;
+    }
+
+#if CULLING_X64
+    if (InstructionSet == ECullingInstructionSet::AVX512)
+    {
+        return CullBoxesAVX512;
+    }
+    else if (InstructionSet == ECullingInstructionSet::AVX2)
+    {
+        return CullBoxesAVX2;
+    }
+    else if (InstructionSet == ECullingInstructionSet::SSE2)
+    {
+        return CullBoxesSSE2;
+    }
+#endif
+
+    return CullBoxesScalar;
+}
+
+static void CreateCullingPlanes(const Frustum& Frustum, CullingPlane* OutPlanes)
+{
+    for (uint32 PlaneIndex = 0; PlaneIndex < 6; PlaneIndex++)
+    {
+        const XMFLOAT4& Plane = Frustum.GetPlane(PlaneIndex);
+        OutPlanes[PlaneIndex].NormalX    = Plane.x;
+        OutPlanes[PlaneIndex].NormalY    = Plane.y;
+        OutPlanes[PlaneIndex].NormalZ    = Plane.z;
+        OutPlanes[PlaneIndex].Distance   = Plane.w;
+        OutPlanes[PlaneIndex].AbsNormalX = fabsf(Plane.x);
+        OutPlanes[PlaneIndex].AbsNormalY = fabsf(Plane.y);
+        OutPlanes[PlaneIndex].AbsNormalZ = fabsf(Plane.z);
+    }
+}
+
+void CullBoundingBoxes(const Frustum& Frustum, const BoundingBoxSoA& Boxes, TArray<uint64>& OutVisibilityMask, ECullingInstructionSet InstructionSet)
+{
+    const uint32 NumWords = GetVisibilityMaskSize(Boxes.Size());
+    OutVisibilityMask.Resize(NumWords);
+
+    CullBoundingBoxesMultiView(&Frustum, 1, Boxes, 0, NumWords, OutVisibilityMask.Data(), NumWords, InstructionSet);
+}
+
+void CullBoundingBoxesMultiView(
+    const Frustum* Frustums,
+    uint32 NumFrustums,
+    const BoundingBoxSoA& Boxes,
+    uint32 FirstWord,
+    uint32 NumWords,
+    uint64* OutVisibilityMasks,
+    uint32 MaskStride,
+    ECullingInstructionSet InstructionSet)
+{
+    Assert(FirstWord + NumWords <= GetVisibilityMaskSize(Boxes.Size()));
+    Assert(MaskStride >= GetVisibilityMaskSize(Boxes.Size()));
+
+    TArray<CullingPlane> Planes(NumFrustums * 6);
+    for (uint32 FrustumIndex = 0; FrustumIndex < NumFrustums; FrustumIndex++)
+    {
+        CreateCullingPlanes(Frustums[FrustumIndex], Planes.Data() + (FrustumIndex * 6));
+    }
+
+    const CullBoxesFunc CullBoxes = GetCullBoxesFunc(InstructionSet);
+
+    const uint32 NumBoxes   = Boxes.Size();
+    const uint32 PaddedSize = Boxes.GetPaddedSize();
+    const uint32 LastWord   = FirstWord + NumWords;
+    for (uint32 WordIndex = FirstWord; WordIndex < LastWord; WordIndex++)
+    {
+        const uint32 Begin = WordIndex * 64;
+        const uint32 End   = std::min(Begin + 64, PaddedSize);
+
+        // The 64 boxes stay in the cache while they are tested against every frustum
+        for (uint32 FrustumIndex = 0; FrustumIndex < NumFrustums; FrustumIndex++)
+        {
+            OutVisibilityMasks[(FrustumIndex * MaskStride) + WordIndex] = CullBoxes(Planes.Data() + (FrustumIndex * 6), Boxes, Begin, End);
+        }
+    }
+
+    // Clear the bits of the boxes in the padding
+    const uint32 NumBitsInLastWord = NumBoxes % 64;
+    if (NumBitsInLastWord != 0 && LastWord == GetVisibilityMaskSize(NumBoxes))
+    {
+        for (uint32 FrustumIndex = 0; FrustumIndex < NumFrustums; FrustumIndex++)
+        {
+            OutVisibilityMasks[(FrustumIndex * MaskStride) + LastWord - 1] &= (uint64(1) << NumBitsInLastWord) - 1;
+        }
+    }
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include "Frustum.h"
+
+#include "Core/Containers/Array.h"
+
+// The arrays in a BoundingBoxSoA are padded to a multiple of this, which is the widest batch that is tested at a time
+constexpr uint32 BOUNDING_BOX_SOA_PADDING = 16;
+
+enum class ECullingInstructionSet : uint32
+{
+    Scalar = 0,
+    SSE2   = 1, // 4 boxes at a time
+    AVX2   = 2, // 8 boxes at a time
+    AVX512 = 3, // 16 boxes at a time
+};
+
+inline const char* ToString(ECullingInstructionSet InstructionSet)
+{
+    switch (InstructionSet)
+    {
+    case ECullingInstructionSet::Scalar: return "Scalar";
+    case ECullingInstructionSet::SSE2:   return "SSE2";
+    case ECullingInstructionSet::AVX2:   return "AVX2";
+    case ECullingInstructionSet::AVX512: return "AVX512";
+    default: return "Unknown";
+    }
+}
+
+/*
+* World space bounding boxes stored as center and half extents in structure of arrays layout, which lets the culling
+* load the same component of several boxes with a single instruction. The boxes in the padding at the end of the arrays
+* are tested as well, but the bits for these are never written to the visibility mask.
+*/
+
+class BoundingBoxSoA
+{
+public:
+    BoundingBoxSoA()  = default;
+    ~BoundingBoxSoA() = default;
+
+    void Reserve(uint32 NumBoxes);
+
+    void Clear()
+    {
+        NumBoxes = 0;
+    }
+
+    void Add(const XMFLOAT3& Center, const XMFLOAT3& Extent);
+
+    // The corners do not need to be sorted, the extent is always positive
+    void AddCorners(const XMFLOAT3& First, const XMFLOAT3& Second);
+
+    // Overwrites a box that has already been added
+    void Set(uint32 Index, const XMFLOAT3& Center, const XMFLOAT3& Extent);
+
+    // Moves the last box into the place of the removed one
+    void Remove(uint32 Index);
+
+    uint32 Size() const { return NumBoxes; }
+
+    // Number of boxes rounded up to the padding, the arrays always contain at least this many elements
+    uint32 GetPaddedSize() const
+    {
+        return ((NumBoxes + BOUNDING_BOX_SOA_PADDING - 1) / BOUNDING_BOX_SOA_PADDING) * BOUNDING_BOX_SOA_PADDING;
+    }
+
+    const float* GetCenterX() const { return CenterX.Data(); }
+    const float* GetCenterY() const { return CenterY.Data(); }
+    const float* GetCenterZ() const { return CenterZ.Data(); }
+    const float* GetExtentX() const { return ExtentX.Data(); }
+    const float* GetExtentY() const { return ExtentY.Data(); }
+    const float* GetExtentZ() const { return ExtentZ.Data(); }
+
+private:
+    void Grow(uint32 NewPaddedSize);
+
+    TArray<float> CenterX;
+    TArray<float> CenterY;
+    TArray<float> CenterZ;
+    TArray<float> ExtentX;
+    TArray<float> ExtentY;
+    TArray<float> ExtentZ;
+
+    uint32 NumBoxes = 0;
+};
+
+// Returns the widest instruction set that both the CPU and the OS supports, the result is queried once
+ECullingInstructionSet GetSupportedCullingInstructionSet();
+
+/*
+* Tests all boxes against the six planes of the frustum. A box is outside when the corner that is furthest along the
+* normal of a plane (the p-vertex) is behind the plane, which is the same as:
+*
+*     Dot(Normal, Center) + Dot(Abs(Normal), Extent) + Distance < 0
+*
+* Bit i in OutVisibilityMask is set when box i is visible. All instruction sets give the same result. If the requested
+* instruction set is not supported the widest supported one is used instead.
+*/
+
+void CullBoundingBoxes(
+    const Frustum& Frustum,
+    const BoundingBoxSoA& Boxes,
+    TArray<uint64>& OutVisibilityMask,
+    ECullingInstructionSet InstructionSet = GetSupportedCullingInstructionSet());
+
+/*
+* Tests the boxes in the words [FirstWord, FirstWord + NumWords) of the masks against several frustums. Each block of 64
+* boxes is tested against all frustums before the next block is loaded, so the bounds are only read from memory once no
+* matter how many frustums there are. The mask of frustum i starts at OutVisibilityMasks + i * MaskStride. Different
+* word ranges can be culled at the same time on different threads.
+*/
+
+void CullBoundingBoxesMultiView(
+    const Frustum* Frustums,
+    uint32 NumFrustums,
+    const BoundingBoxSoA& Boxes,
+    uint32 FirstWord,
+    uint32 NumWords,
+    uint64* OutVisibilityMasks,
+    uint32 MaskStride,
+    ECullingInstructionSet InstructionSet = GetSupportedCullingInstructionSet());
+
+// Number of uint64 that are needed for one bit per box
+inline uint32 GetVisibilityMaskSize(uint32 NumBoxes)
+{
+    return (NumBoxes + 63) / 64;
+}
+
+inline bool IsBoxVisible(const uint64* VisibilityMask, uint32 Index)
+{
+    return (VisibilityMask[Index / 64] >> (Index % 64)) & 1;
+}
+
+inline bool IsBoxVisible(const TArray<uint64>& VisibilityMask, uint32 Index)
+{
+    return IsBoxVisible(VisibilityMask.Data(), Index);
+}
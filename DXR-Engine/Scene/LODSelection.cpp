@@ -0,0 +1,103 @@
+#include "LODSelection.h"
+
+#include "Rendering/Resources/Mesh.h"
+
+#include "Debug/Profiler.h"
+
+#include <algorithm>
+#include <cfloat>
+
+void LODSelection::Select(const TArray<MeshDrawCommand>& Commands, const TArray<XMFLOAT4>& BoundingSpheres, MultiViewCulling& Culling, float MinScreenPixels)
+{
+    TRACE_SCOPE("LOD Selection");
+
+    Assert(Culling.GetNumViews() == Views.Size());
+    Assert(Commands.Size() == BoundingSpheres.Size());
+
+    // The previous selection means nothing when the objects or views have changed
+    if (NumObjects != Commands.Size() || SelectedLODs.Size() != Views.Size() * Commands.Size())
+    {
+        NumObjects = Commands.Size();
+        SelectedLODs.Resize(Views.Size() * NumObjects);
+        SelectedLODs.Fill(0);
+    }
+
+    const float CullSize   = MinScreenPixels * (1.0f - LOD_HYSTERESIS);
+    const float UncullSize = MinScreenPixels * (1.0f + LOD_HYSTERESIS);
+    const uint32 NumWords  = GetVisibilityMaskSize(NumObjects);
+
+    for (uint32 ViewIndex = 0; ViewIndex < Views.Size(); ViewIndex++)
+    {
+        const LODView& View = Views[ViewIndex];
+        const uint64* VisibilityMask = Culling.GetVisibilityMask(ViewIndex);
+        uint8* ViewLODs = SelectedLODs.Data() + (ViewIndex * NumObjects);
+
+        for (uint32 Word = 0; Word < NumWords; Word++)
+        {
+            const uint64 Bits = VisibilityMask[Word];
+            if (Bits == 0)
+            {
+                continue;
+            }
+
+            for (uint32 Bit = 0; Bit < 64; Bit++)
+            {
+                if (!((Bits >> Bit) & 1))
+                {
+                    continue;
+                }
+
+                const uint32 Index = (Word * 64) + Bit;
+                const XMFLOAT4& Sphere = BoundingSpheres[Index];
+
+                float ScreenSize = Sphere.w * View.ProjectionScale;
+                if (!View.IsOrthographic)
+                {
+                    const float DeltaX   = Sphere.x - View.Position.x;
+                    const float DeltaY   = Sphere.y - View.Position.y;
+                    const float DeltaZ   = Sphere.z - View.Position.z;
+                    const float Distance = sqrtf((DeltaX * DeltaX) + (DeltaY * DeltaY) + (DeltaZ * DeltaZ));
+
+                    // The view is inside of the sphere
+                    ScreenSize = Distance > Sphere.w ? ScreenSize / Distance : FLT_MAX;
+                }
+
+                const Mesh*  CurrentMesh   = Commands[Index].Mesh;
+                const uint32 NumThresholds = CurrentMesh->LODScreenSizes.Size();
+
+                uint32 LOD = ViewLODs[Index];
+                const float ScreenPixels = ScreenSize * View.Height;
+                if (LOD == LOD_CULLED)
+                {
+                    if (ScreenPixels <= UncullSize)
+                    {
+                        Culling.Hide(ViewIndex, Index);
+                        continue;
+                    }
+
+                    // Objects that become visible again start at the least detailed LOD
+                    LOD = NumThresholds;
+                }
+                else if (ScreenPixels < CullSize)
+                {
+                    ViewLODs[Index] = LOD_CULLED;
+                    Culling.Hide(ViewIndex, Index);
+                    continue;
+                }
+
+                LOD = std::min(LOD, NumThresholds);
+                while (LOD < NumThresholds && ScreenSize < CurrentMesh->LODScreenSizes[LOD] * (1.0f - LOD_HYSTERESIS))
+                {
+                    LOD++;
+                }
+
+                while (LOD > 0 && ScreenSize > CurrentMesh->LODScreenSizes[LOD - 1] * (1.0f + LOD_HYSTERESIS))
+                {
+                    LOD--;
+                }
+
+                ViewLODs[Index] = uint8(LOD);
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "MultiViewCulling.h"
+
+#include "Rendering/MeshDrawCommand.h"
+
+// Selected LOD of an object that is too small to be drawn in the view
+constexpr uint8 LOD_CULLED = 0xff;
+
+// The LOD only changes when the screen size has moved this fraction past the threshold, so that objects that stay
+// close to a threshold do not switch back and forth every frame
+constexpr float LOD_HYSTERESIS = 0.1f;
+
+struct LODView
+{
+    XMFLOAT3 Position;
+
+    // Scales the radius of a bounding sphere to its size relative to the height of the view, divided by the distance
+    // for perspective views. Equal to the [1][1] element of the projection matrix.
+    float ProjectionScale = 1.0f;
+
+    // Height of the view in pixels
+    float Height = 1.0f;
+
+    bool IsOrthographic = false;
+};
+
+/*
+* Selects the LOD of the objects that are visible in each view of a MultiViewCulling, from the size of their bounding
+* spheres on screen. Objects that are smaller than a number of pixels are removed from the visibility mask of the view.
+* The selection is kept between frames, which is what the hysteresis is applied to, so the views need to be added in
+* the same order every frame.
+*/
+
+class LODSelection
+{
+public:
+    LODSelection()  = default;
+    ~LODSelection() = default;
+
+    void ClearViews()
+    {
+        Views.Clear();
+    }
+
+    // Views are added in the same order as to the MultiViewCulling and have the same index
+    uint32 AddView(const LODView& View)
+    {
+        Views.EmplaceBack(View);
+        return Views.Size() - 1;
+    }
+
+    // Called after MultiViewCulling::Cull, a MinScreenPixels of zero disables the culling of small objects
+    void Select(const TArray<MeshDrawCommand>& Commands, const TArray<XMFLOAT4>& BoundingSpheres, MultiViewCulling& Culling, float MinScreenPixels);
+
+    uint32 GetLOD(uint32 ViewIndex, uint32 ObjectIndex) const
+    {
+        Assert(ViewIndex < Views.Size() && ObjectIndex < NumObjects);
+        return SelectedLODs[(ViewIndex * NumObjects) + ObjectIndex];
+    }
+
+    uint32 GetNumViews() const { return Views.Size(); }
+
+private:
+    TArray<LODView> Views;
+
+    // NumObjects LODs per view, from the last call to Select
+    TArray<uint8> SelectedLODs;
+    uint32 NumObjects = 0;
+};
@@ -1,7 +1,7 @@
 #pragma once
 #include "Light.h"
 
-class DirectionalLight : public Light
+class DirectionalLight final : public Light
 {
     CORE_OBJECT(DirectionalLight, Light);
 
@@ -1,7 +1,7 @@
 #pragma once
 #include "Light.h"
 
-class PointLight : public Light
+class PointLight final : public Light
 {
     CORE_OBJECT(PointLight, Light);
 
@@ -1,7 +1,7 @@
 #pragma once
 #include "Light.h"
 
-class SpotLight : public Light
+class SpotLight final : public Light
 {
     CORE_OBJECT(SpotLight, Light);
 
@@ -0,0 +1,75 @@
+#include "MeshletCulling.h"
+
+uint32 CullMeshlets(
+    const Meshlet* Meshlets,
+    uint32 NumMeshlets,
+    const Frustum& Frustum,
+    const XMFLOAT3& ViewPosition,
+    const XMFLOAT4X4& Transform,
+    const XMFLOAT4X4& TransformInv,
+    bool CullBackfaces,
+    TArray<MeshDrawRange>& OutRanges)
+{
+    // A point is transformed with the transpose of the stored matrix, so a plane is moved into local space by the stored
+    // matrix itself. The planes are normalized again, since the transform can scale them.
+    XMMATRIX XmTransform = XMLoadFloat4x4(&Transform);
+
+    XMFLOAT4 Planes[6];
+    for (uint32 Index = 0; Index < 6; Index++)
+    {
+        XMVECTOR Plane = XMVector4Transform(XMLoadFloat4(&Frustum.GetPlane(Index)), XmTransform);
+        XMStoreFloat4(&Planes[Index], XMPlaneNormalize(Plane));
+    }
+
+    XMFLOAT3 LocalViewPosition;
+    XMStoreFloat3(&LocalViewPosition, XMVector3TransformCoord(XMLoadFloat3(&ViewPosition), XMLoadFloat4x4(&TransformInv)));
+
+    // A mirrored transform turns the triangles that the cones consider to face away into the ones that are drawn
+    if (XMVectorGetX(XMMatrixDeterminant(XmTransform)) < 0.0f)
+    {
+        CullBackfaces = false;
+    }
+
+    const uint32 FirstRange = OutRanges.Size();
+    for (uint32 Index = 0; Index < NumMeshlets; Index++)
+    {
+        const Meshlet& Current = Meshlets[Index];
+        const XMFLOAT3& Center = Current.Center;
+
+        bool IsVisible = true;
+        for (uint32 PlaneIndex = 0; PlaneIndex < 6 && IsVisible; PlaneIndex++)
+        {
+            const XMFLOAT4& Plane = Planes[PlaneIndex];
+            IsVisible = (Plane.x * Center.x) + (Plane.y * Center.y) + (Plane.z * Center.z) + Plane.w >= -Current.Radius;
+        }
+
+        if (IsVisible && CullBackfaces)
+        {
+            const float DeltaX   = Center.x - LocalViewPosition.x;
+            const float DeltaY   = Center.y - LocalViewPosition.y;
+            const float DeltaZ   = Center.z - LocalViewPosition.z;
+            const float Distance = sqrtf((DeltaX * DeltaX) + (DeltaY * DeltaY) + (DeltaZ * DeltaZ));
+
+            const float AxisDistance = (DeltaX * Current.ConeAxis.x) + (DeltaY * Current.ConeAxis.y) + (DeltaZ * Current.ConeAxis.z);
+            IsVisible = AxisDistance < (Current.ConeCutoff * Distance) + Current.Radius;
+        }
+
+        if (!IsVisible)
+        {
+            continue;
+        }
+
+        const uint32 FirstIndex = Current.FirstTriangle * 3;
+        const uint32 NumIndices = Current.NumTriangles * 3;
+        if (OutRanges.Size() > FirstRange && OutRanges.Back().FirstIndex + OutRanges.Back().NumIndices == FirstIndex)
+        {
+            OutRanges.Back().NumIndices += NumIndices;
+        }
+        else
+        {
+            OutRanges.EmplaceBack(MeshDrawRange{ FirstIndex, NumIndices });
+        }
+    }
+
+    return OutRanges.Size() - FirstRange;
+}
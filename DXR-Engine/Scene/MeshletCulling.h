@@ -0,0 +1,28 @@
+#pragma once
+#include "Frustum.h"
+
+#include "Rendering/MeshDrawCommand.h"
+#include "Rendering/Resources/MeshFactory.h"
+
+#include "Core/Containers/Array.h"
+
+/*
+* Tests the bounding spheres of the meshlets of a mesh against a frustum, and when CullBackfaces is set, tests whether
+* all triangles of a meshlet face away from the viewer with the normal cones. The tests are done in the local space of
+* the mesh, where the spheres and cones are, since the planes and the position of the viewer can be moved there without
+* any error even when the transform does not scale all axes the same. Transform and TransformInv are the matrices of an
+* actor, where Transform is stored transposed.
+*
+* The visible meshlets are appended to OutRanges, and meshlets that follow each other in the index buffer are merged
+* into one range. Returns the number of ranges that were appended, which is zero when the whole mesh is culled.
+*/
+
+uint32 CullMeshlets(
+    const Meshlet* Meshlets,
+    uint32 NumMeshlets,
+    const Frustum& Frustum,
+    const XMFLOAT3& ViewPosition,
+    const XMFLOAT4X4& Transform,
+    const XMFLOAT4X4& TransformInv,
+    bool CullBackfaces,
+    TArray<MeshDrawRange>& OutRanges);
@@ -0,0 +1,122 @@
+#include "MultiViewCulling.h"
+
+#include "Core/Threading/TaskManager.h"
+#include "Core/Threading/Platform/PlatformProcess.h"
+
+#include "Debug/Profiler.h"
+
+void MultiViewCulling::Cull(const BoundingBoxSoA& Boxes, ECullingInstructionSet InstructionSet)
+{
+    TRACE_SCOPE("Multi View Culling");
+
+    MaskStride = GetVisibilityMaskSize(Boxes.Size());
+    VisibilityMasks.Resize(Views.Size() * MaskStride);
+
+    if (Views.IsEmpty() || MaskStride == 0)
+    {
+        return;
+    }
+
+    CurrentBoxes          = &Boxes;
+    CurrentInstructionSet = InstructionSet;
+
+    const uint32 NumTasks = (MaskStride + MULTI_VIEW_CULLING_WORDS_PER_TASK - 1) / MULTI_VIEW_CULLING_WORDS_PER_TASK;
+    if (NumTasks <= 1 || TaskManager::Get().GetNumWorkers() == 0)
+    {
+        CullRange(0, MaskStride);
+    }
+    else
+    {
+        NumCompletedTasks.Store(0);
+
+        // The calling thread culls the first range instead of waiting
+        for (uint32 TaskIndex = 1; TaskIndex < NumTasks; TaskIndex++)
+        {
+            const uint32 FirstWord = TaskIndex * MULTI_VIEW_CULLING_WORDS_PER_TASK;
+            const uint32 NumWords  = std::min(MULTI_VIEW_CULLING_WORDS_PER_TASK, MaskStride - FirstWord);
+
+            Task CullTask;
+            CullTask.Delegate.BindLambda([this, FirstWord, NumWords]()
+            {
+                CullRange(FirstWord, NumWords);
+                NumCompletedTasks.Increment();
+            });
+
+            TaskManager::Get().AddTask(CullTask);
+        }
+
+        CullRange(0, MULTI_VIEW_CULLING_WORDS_PER_TASK);
+
+        while (NumCompletedTasks.Load() < int32(NumTasks - 1))
+        {
+            if (!TaskManager::Get().ExecuteTask())
+            {
+                PlatformProcess::Sleep(0);
+            }
+        }
+    }
+
+    CurrentBoxes = nullptr;
+}
+
+void MultiViewCulling::Cull(const BoundingVolumeHierarchy& BVH)
+{
+    TRACE_SCOPE("Multi View Culling BVH");
+
+    MaskStride = GetVisibilityMaskSize(BVH.GetNumObjects());
+    VisibilityMasks.Resize(Views.Size() * MaskStride);
+
+    if (Views.IsEmpty() || MaskStride == 0)
+    {
+        return;
+    }
+
+    // Tasks take the next view until there are no more, the tasks refer to the counter on the stack so all of them
+    // have to finish before returning
+    ThreadSafeInt32 NextView(0);
+    auto QueryViews = [&]()
+    {
+        for (uint32 ViewIndex = uint32(NextView.Increment() - 1); ViewIndex < Views.Size(); ViewIndex = uint32(NextView.Increment() - 1))
+        {
+            BVH.QueryFrustum(Views[ViewIndex], VisibilityMasks.Data() + (ViewIndex * MaskStride));
+        }
+    };
+
+    const uint32 NumTasks = std::min(TaskManager::Get().GetNumWorkers(), Views.Size() - 1);
+    NumCompletedTasks.Store(0);
+    for (uint32 TaskIndex = 0; TaskIndex < NumTasks; TaskIndex++)
+    {
+        Task QueryTask;
+        QueryTask.Delegate.BindLambda([&]()
+        {
+            QueryViews();
+            NumCompletedTasks.Increment();
+        });
+
+        TaskManager::Get().AddTask(QueryTask);
+    }
+
+    QueryViews();
+
+    // This thread only waits for the queries that are still running when it runs out of views
+    while (NumCompletedTasks.Load() < int32(NumTasks))
+    {
+        if (!TaskManager::Get().ExecuteTask())
+        {
+            PlatformProcess::Sleep(0);
+        }
+    }
+}
+
+void MultiViewCulling::CullRange(uint32 FirstWord, uint32 NumWords)
+{
+    CullBoundingBoxesMultiView(
+        Views.Data(),
+        Views.Size(),
+        *CurrentBoxes,
+        FirstWord,
+        NumWords,
+        VisibilityMasks.Data(),
+        MaskStride,
+        CurrentInstructionSet);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "FrustumCulling.h"
+#include "BoundingVolumeHierarchy.h"
+
+#include "Core/Threading/ThreadSafeInt.h"
+
+// Number of 64 box words that are culled by each task, smaller scenes are culled on the calling thread
+constexpr uint32 MULTI_VIEW_CULLING_WORDS_PER_TASK = 64;
+
+/*
+* Culls the bounds of all objects against every view of the frame, such as the camera, the faces of the point light
+* shadow maps and the directional light shadow maps, in a single walk over the bounds. The result is one visibility
+* mask per view. Large scenes are split into ranges of objects that are culled in parallel by the TaskManager.
+*/
+
+class MultiViewCulling
+{
+public:
+    MultiViewCulling()  = default;
+    ~MultiViewCulling() = default;
+
+    void ClearViews()
+    {
+        Views.Clear();
+    }
+
+    // Returns the index of the view that is used to query the visibility after Cull has been called
+    uint32 AddView(const Frustum& ViewFrustum)
+    {
+        Views.EmplaceBack(ViewFrustum);
+        return Views.Size() - 1;
+    }
+
+    void Cull(const BoundingBoxSoA& Boxes, ECullingInstructionSet InstructionSet = GetSupportedCullingInstructionSet());
+
+    // Culls each view with a frustum query in the tree, which skips the parts of the scene that are far from the view.
+    // The views are divided between the TaskManager's workers and the calling thread. Gives the same result as culling
+    // the boxes that the tree was built from.
+    void Cull(const BoundingVolumeHierarchy& BVH);
+
+    bool IsVisible(uint32 ViewIndex, uint32 BoxIndex) const
+    {
+        return IsBoxVisible(GetVisibilityMask(ViewIndex), BoxIndex);
+    }
+
+    // Removes a box from the result of Cull, used by passes that cull more after the frustums
+    void Hide(uint32 ViewIndex, uint32 BoxIndex)
+    {
+        Assert(ViewIndex < Views.Size());
+        VisibilityMasks[(ViewIndex * MaskStride) + (BoxIndex / 64)] &= ~(uint64(1) << (BoxIndex % 64));
+    }
+
+    const uint64* GetVisibilityMask(uint32 ViewIndex) const
+    {
+        Assert(ViewIndex < Views.Size());
+        return VisibilityMasks.Data() + (ViewIndex * MaskStride);
+    }
+
+    const Frustum& GetView(uint32 ViewIndex) const
+    {
+        Assert(ViewIndex < Views.Size());
+        return Views[ViewIndex];
+    }
+
+    uint32 GetNumViews() const { return Views.Size(); }
+
+private:
+    void CullRange(uint32 FirstWord, uint32 NumWords);
+
+    TArray<Frustum> Views;
+    TArray<uint64>  VisibilityMasks;
+    uint32 MaskStride = 0;
+
+    // Only valid during Cull
+    const BoundingBoxSoA*  CurrentBoxes = nullptr;
+    ECullingInstructionSet CurrentInstructionSet = ECullingInstructionSet::Scalar;
+
+    ThreadSafeInt32 NumCompletedTasks;
+};
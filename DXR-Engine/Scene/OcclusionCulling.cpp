@@ -0,0 +1,474 @@
+#include "OcclusionCulling.h"
+
+#include "Debug/Profiler.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define OCCLUSION_X64 1
+#else
+    #define OCCLUSION_X64 0
+#endif
+
+// SSE2 is part of x64, so there is no need to check for support at runtime
+#if OCCLUSION_X64
+    #include <emmintrin.h>
+#endif
+
+// Boxes with a corner closer than this w are treated as crossing the near plane and are always visible
+static constexpr float OCCLUSION_MIN_W = 1e-5f;
+
+// Each clip plane can add one vertex to the triangle
+static constexpr uint32 OCCLUSION_MAX_CLIPPED_VERTICES = 8;
+
+void OcclusionBuffer::Resize(uint32 InWidth, uint32 InHeight)
+{
+    NumTilesX = (InWidth + OCCLUSION_TILE_WIDTH - 1) / OCCLUSION_TILE_WIDTH;
+    NumTilesY = (InHeight + OCCLUSION_TILE_HEIGHT - 1) / OCCLUSION_TILE_HEIGHT;
+    Width     = NumTilesX * OCCLUSION_TILE_WIDTH;
+    Height    = NumTilesY * OCCLUSION_TILE_HEIGHT;
+
+    Tiles.Resize(NumTilesX * NumTilesY);
+}
+
+void OcclusionBuffer::BeginFrame(const XMFLOAT4X4& InViewProjection)
+{
+    if (Tiles.IsEmpty())
+    {
+        Resize(OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT);
+    }
+
+    for (Tile& CurrentTile : Tiles)
+    {
+        CurrentTile.Mask           = 0;
+        CurrentTile.ReferenceDepth = 1.0f;
+        CurrentTile.WorkingDepth   = 0.0f;
+    }
+
+    XMStoreFloat4x4(&ViewProjection, XMMatrixTranspose(XMLoadFloat4x4(&InViewProjection)));
+
+    Statistics = OcclusionStatistics();
+}
+
+void OcclusionBuffer::RenderOccluder(const XMFLOAT3* Positions, const uint32* Indices, uint32 NumIndices, const XMFLOAT4X4& Transform)
+{
+    TRACE_SCOPE("Render Occluder");
+
+    XMMATRIX XmTransform = XMMatrixMultiply(XMMatrixTranspose(XMLoadFloat4x4(&Transform)), XMLoadFloat4x4(&ViewProjection));
+
+    Statistics.NumOccluders++;
+    Statistics.NumOccluderTriangles += NumIndices / 3;
+
+    for (uint32 Index = 0; Index + 2 < NumIndices; Index += 3)
+    {
+        XMFLOAT4 ClipVertices[3];
+        for (uint32 Corner = 0; Corner < 3; Corner++)
+        {
+            XMStoreFloat4(&ClipVertices[Corner], XMVector3Transform(XMLoadFloat3(&Positions[Indices[Index + Corner]]), XmTransform));
+        }
+
+        ClipAndRasterizeTriangle(ClipVertices[0], ClipVertices[1], ClipVertices[2]);
+    }
+}
+
+/*
+* Clipping
+*   Triangles are clipped against the near plane and the sides of the frustum in clip space. The far plane is not
+*   needed since the depth is only ever compared. Clipping against the sides keeps the screen space coordinates
+*   small, so that the edge functions stay precise.
+*/
+
+static float GetClipDistance(const XMFLOAT4& Vertex, uint32 PlaneIndex)
+{
+    switch (PlaneIndex)
+    {
+    case 0:  return Vertex.z;
+    case 1:  return Vertex.w + Vertex.x;
+    case 2:  return Vertex.w - Vertex.x;
+    case 3:  return Vertex.w + Vertex.y;
+    default: return Vertex.w - Vertex.y;
+    }
+}
+
+static XMFLOAT4 LerpVertex(const XMFLOAT4& First, const XMFLOAT4& Second, float Amount)
+{
+    return XMFLOAT4(
+        First.x + (Second.x - First.x) * Amount,
+        First.y + (Second.y - First.y) * Amount,
+        First.z + (Second.z - First.z) * Amount,
+        First.w + (Second.w - First.w) * Amount);
+}
+
+void OcclusionBuffer::ClipAndRasterizeTriangle(const XMFLOAT4& Vertex0, const XMFLOAT4& Vertex1, const XMFLOAT4& Vertex2)
+{
+    XMFLOAT4 Polygon[OCCLUSION_MAX_CLIPPED_VERTICES] = { Vertex0, Vertex1, Vertex2 };
+    uint32   NumVertices = 3;
+
+    uint32 NumPlanesToClip = 0;
+    uint32 PlanesToClip[5];
+    for (uint32 PlaneIndex = 0; PlaneIndex < 5; PlaneIndex++)
+    {
+        const float Distance0 = GetClipDistance(Vertex0, PlaneIndex);
+        const float Distance1 = GetClipDistance(Vertex1, PlaneIndex);
+        const float Distance2 = GetClipDistance(Vertex2, PlaneIndex);
+        if (Distance0 < 0.0f && Distance1 < 0.0f && Distance2 < 0.0f)
+        {
+            return;
+        }
+        else if (Distance0 < 0.0f || Distance1 < 0.0f || Distance2 < 0.0f)
+        {
+            PlanesToClip[NumPlanesToClip++] = PlaneIndex;
+        }
+    }
+
+    // Sutherland-Hodgman for the planes that the triangle crosses
+    for (uint32 Index = 0; Index < NumPlanesToClip; Index++)
+    {
+        const uint32 PlaneIndex = PlanesToClip[Index];
+
+        XMFLOAT4 Clipped[OCCLUSION_MAX_CLIPPED_VERTICES];
+        uint32   NumClipped = 0;
+        for (uint32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+        {
+            const XMFLOAT4& Current = Polygon[VertexIndex];
+            const XMFLOAT4& Next    = Polygon[(VertexIndex + 1) % NumVertices];
+
+            const float CurrentDistance = GetClipDistance(Current, PlaneIndex);
+            const float NextDistance    = GetClipDistance(Next, PlaneIndex);
+            if (CurrentDistance >= 0.0f)
+            {
+                Clipped[NumClipped++] = Current;
+            }
+
+            if ((CurrentDistance >= 0.0f) != (NextDistance >= 0.0f))
+            {
+                Clipped[NumClipped++] = LerpVertex(Current, Next, CurrentDistance / (CurrentDistance - NextDistance));
+            }
+        }
+
+        if (NumClipped < 3)
+        {
+            return;
+        }
+
+        memcpy(Polygon, Clipped, sizeof(XMFLOAT4) * NumClipped);
+        NumVertices = NumClipped;
+    }
+
+    XMFLOAT3 ScreenVertices[OCCLUSION_MAX_CLIPPED_VERTICES];
+    for (uint32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+    {
+        const XMFLOAT4& Vertex = Polygon[VertexIndex];
+        const float InvW = 1.0f / Vertex.w;
+
+        ScreenVertices[VertexIndex].x = ((Vertex.x * InvW) * 0.5f + 0.5f) * float(Width);
+        ScreenVertices[VertexIndex].y = (0.5f - (Vertex.y * InvW) * 0.5f) * float(Height);
+        ScreenVertices[VertexIndex].z = Vertex.z * InvW;
+    }
+
+    // The clipped polygon is convex, so it can be drawn as a fan
+    for (uint32 VertexIndex = 1; VertexIndex + 1 < NumVertices; VertexIndex++)
+    {
+        RasterizeTriangle(ScreenVertices[0], ScreenVertices[VertexIndex], ScreenVertices[VertexIndex + 1]);
+    }
+}
+
+/*
+* Rasterization
+*   A pixel is covered when its center is on the inside of all three edges. The coverage of a tile is calculated one
+*   row at a time, eight pixels wide.
+*/
+
+struct EdgeFunction
+{
+    // Value at (x, y) is A * x + C + B * y, always evaluated in this order so that all paths give the same result
+    float A;
+    float B;
+    float C;
+};
+
+static EdgeFunction CreateEdgeFunction(const XMFLOAT3& Start, const XMFLOAT3& End)
+{
+    EdgeFunction Edge;
+    Edge.A = Start.y - End.y;
+    Edge.B = End.x - Start.x;
+    Edge.C = -((Edge.A * Start.x) + (Edge.B * Start.y));
+    return Edge;
+}
+
+static uint64 CalculateTileCoverage(const EdgeFunction* Edges, float TileLeft, float TileTop)
+{
+    uint64 Coverage = 0;
+
+#if OCCLUSION_X64
+    const __m128 Zero     = _mm_setzero_ps();
+    const __m128 Columns0 = _mm_add_ps(_mm_set1_ps(TileLeft), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+    const __m128 Columns1 = _mm_add_ps(_mm_set1_ps(TileLeft), _mm_setr_ps(4.5f, 5.5f, 6.5f, 7.5f));
+
+    __m128 RowStart0[3];
+    __m128 RowStart1[3];
+    __m128 EdgeB[3];
+    for (uint32 EdgeIndex = 0; EdgeIndex < 3; EdgeIndex++)
+    {
+        const __m128 EdgeA = _mm_set1_ps(Edges[EdgeIndex].A);
+        const __m128 EdgeC = _mm_set1_ps(Edges[EdgeIndex].C);
+        RowStart0[EdgeIndex] = _mm_add_ps(_mm_mul_ps(EdgeA, Columns0), EdgeC);
+        RowStart1[EdgeIndex] = _mm_add_ps(_mm_mul_ps(EdgeA, Columns1), EdgeC);
+        EdgeB[EdgeIndex]     = _mm_set1_ps(Edges[EdgeIndex].B);
+    }
+
+    for (uint32 Row = 0; Row < OCCLUSION_TILE_HEIGHT; Row++)
+    {
+        const __m128 Y = _mm_set1_ps(TileTop + float(Row) + 0.5f);
+
+        __m128 Inside0 = _mm_cmpeq_ps(Zero, Zero);
+        __m128 Inside1 = Inside0;
+        for (uint32 EdgeIndex = 0; EdgeIndex < 3; EdgeIndex++)
+        {
+            const __m128 EdgeY = _mm_mul_ps(EdgeB[EdgeIndex], Y);
+            Inside0 = _mm_and_ps(Inside0, _mm_cmpge_ps(_mm_add_ps(RowStart0[EdgeIndex], EdgeY), Zero));
+            Inside1 = _mm_and_ps(Inside1, _mm_cmpge_ps(_mm_add_ps(RowStart1[EdgeIndex], EdgeY), Zero));
+        }
+
+        const uint64 RowBits = uint64(_mm_movemask_ps(Inside0)) | (uint64(_mm_movemask_ps(Inside1)) << 4);
+        Coverage |= RowBits << (Row * OCCLUSION_TILE_WIDTH);
+    }
+#else
+    for (uint32 Row = 0; Row < OCCLUSION_TILE_HEIGHT; Row++)
+    {
+        const float Y = TileTop + float(Row) + 0.5f;
+        for (uint32 Column = 0; Column < OCCLUSION_TILE_WIDTH; Column++)
+        {
+            const float X = TileLeft + float(Column) + 0.5f;
+
+            bool IsInside = true;
+            for (uint32 EdgeIndex = 0; EdgeIndex < 3; EdgeIndex++)
+            {
+                const float Value = ((Edges[EdgeIndex].A * X) + Edges[EdgeIndex].C) + (Edges[EdgeIndex].B * Y);
+                IsInside = IsInside && (Value >= 0.0f);
+            }
+
+            if (IsInside)
+            {
+                Coverage |= uint64(1) << ((Row * OCCLUSION_TILE_WIDTH) + Column);
+            }
+        }
+    }
+#endif
+
+    return Coverage;
+}
+
+void OcclusionBuffer::RasterizeTriangle(const XMFLOAT3& Vertex0, const XMFLOAT3& InVertex1, const XMFLOAT3& InVertex2)
+{
+    // Occluders are two sided, the vertices are swapped so that the inside of all edges is positive
+    float Area = ((InVertex1.x - Vertex0.x) * (InVertex2.y - Vertex0.y)) - ((InVertex2.x - Vertex0.x) * (InVertex1.y - Vertex0.y));
+    if (Area == 0.0f)
+    {
+        return;
+    }
+
+    const XMFLOAT3& Vertex1 = Area > 0.0f ? InVertex1 : InVertex2;
+    const XMFLOAT3& Vertex2 = Area > 0.0f ? InVertex2 : InVertex1;
+    Area = fabsf(Area);
+
+    // Pixels whose centers are inside the bounds of the triangle
+    const float MinX = std::min(Vertex0.x, std::min(Vertex1.x, Vertex2.x));
+    const float MaxX = std::max(Vertex0.x, std::max(Vertex1.x, Vertex2.x));
+    const float MinY = std::min(Vertex0.y, std::min(Vertex1.y, Vertex2.y));
+    const float MaxY = std::max(Vertex0.y, std::max(Vertex1.y, Vertex2.y));
+
+    const int32 FirstPixelX = std::max(int32(ceilf(MinX - 0.5f)), 0);
+    const int32 LastPixelX  = std::min(int32(floorf(MaxX - 0.5f)), int32(Width) - 1);
+    const int32 FirstPixelY = std::max(int32(ceilf(MinY - 0.5f)), 0);
+    const int32 LastPixelY  = std::min(int32(floorf(MaxY - 0.5f)), int32(Height) - 1);
+    if (FirstPixelX > LastPixelX || FirstPixelY > LastPixelY)
+    {
+        return;
+    }
+
+    Statistics.NumRasterizedTriangles++;
+
+    const EdgeFunction Edges[3] =
+    {
+        CreateEdgeFunction(Vertex0, Vertex1),
+        CreateEdgeFunction(Vertex1, Vertex2),
+        CreateEdgeFunction(Vertex2, Vertex0),
+    };
+
+    // The depth is linear in screen space
+    const float DeltaX1 = Vertex1.x - Vertex0.x;
+    const float DeltaY1 = Vertex1.y - Vertex0.y;
+    const float DeltaZ1 = Vertex1.z - Vertex0.z;
+    const float DeltaX2 = Vertex2.x - Vertex0.x;
+    const float DeltaY2 = Vertex2.y - Vertex0.y;
+    const float DeltaZ2 = Vertex2.z - Vertex0.z;
+    const float DepthDX = ((DeltaZ1 * DeltaY2) - (DeltaY1 * DeltaZ2)) / Area;
+    const float DepthDY = ((DeltaX1 * DeltaZ2) - (DeltaZ1 * DeltaX2)) / Area;
+
+    const float TriangleMinDepth = std::min(Vertex0.z, std::min(Vertex1.z, Vertex2.z));
+    const float TriangleMaxDepth = std::max(Vertex0.z, std::max(Vertex1.z, Vertex2.z));
+
+    const uint32 FirstTileX = uint32(FirstPixelX) / OCCLUSION_TILE_WIDTH;
+    const uint32 LastTileX  = uint32(LastPixelX) / OCCLUSION_TILE_WIDTH;
+    const uint32 FirstTileY = uint32(FirstPixelY) / OCCLUSION_TILE_HEIGHT;
+    const uint32 LastTileY  = uint32(LastPixelY) / OCCLUSION_TILE_HEIGHT;
+    for (uint32 TileY = FirstTileY; TileY <= LastTileY; TileY++)
+    {
+        for (uint32 TileX = FirstTileX; TileX <= LastTileX; TileX++)
+        {
+            const float TileLeft = float(TileX * OCCLUSION_TILE_WIDTH);
+            const float TileTop  = float(TileY * OCCLUSION_TILE_HEIGHT);
+
+            // The depth plane has its extremes at the corners of the pixel centers in the tile, clamped to the
+            // depth of the vertices since the plane continues outside of the triangle
+            const float Left   = TileLeft + 0.5f - Vertex0.x;
+            const float Right  = TileLeft + float(OCCLUSION_TILE_WIDTH) - 0.5f - Vertex0.x;
+            const float Top    = TileTop + 0.5f - Vertex0.y;
+            const float Bottom = TileTop + float(OCCLUSION_TILE_HEIGHT) - 0.5f - Vertex0.y;
+
+            const float DepthX0 = DepthDX * Left;
+            const float DepthX1 = DepthDX * Right;
+            const float DepthY0 = DepthDY * Top;
+            const float DepthY1 = DepthDY * Bottom;
+
+            const float TileMinDepth = std::max(Vertex0.z + std::min(DepthX0, DepthX1) + std::min(DepthY0, DepthY1), TriangleMinDepth);
+            const float TileMaxDepth = std::min(Vertex0.z + std::max(DepthX0, DepthX1) + std::max(DepthY0, DepthY1), TriangleMaxDepth);
+
+            Tile& CurrentTile = Tiles[(TileY * NumTilesX) + TileX];
+            if (TileMinDepth > CurrentTile.ReferenceDepth)
+            {
+                continue;
+            }
+
+            const uint64 Coverage = CalculateTileCoverage(Edges, TileLeft, TileTop);
+            if (Coverage != 0)
+            {
+                UpdateTile(CurrentTile, Coverage, TileMaxDepth);
+            }
+        }
+    }
+}
+
+void OcclusionBuffer::UpdateTile(Tile& InTile, uint64 Coverage, float TriangleDepth)
+{
+    // Merging a triangle that is much closer than the working layer would throw away its depth, so the working layer
+    // is thrown away instead
+    const float DistanceToWorking   = InTile.WorkingDepth - TriangleDepth;
+    const float DistanceToReference = InTile.ReferenceDepth - InTile.WorkingDepth;
+    if (DistanceToWorking > DistanceToReference)
+    {
+        InTile.Mask         = 0;
+        InTile.WorkingDepth = 0.0f;
+    }
+
+    InTile.Mask        |= Coverage;
+    InTile.WorkingDepth = std::max(InTile.WorkingDepth, TriangleDepth);
+
+    if (InTile.Mask == ~uint64(0))
+    {
+        InTile.ReferenceDepth = std::min(InTile.ReferenceDepth, InTile.WorkingDepth);
+        InTile.Mask           = 0;
+        InTile.WorkingDepth   = 0.0f;
+    }
+}
+
+/*
+* Testing
+*/
+
+bool OcclusionBuffer::IsBoxVisible(const XMFLOAT3& Center, const XMFLOAT3& Extent)
+{
+    Statistics.NumTestedBoxes++;
+
+    XMMATRIX XmViewProjection = XMLoadFloat4x4(&ViewProjection);
+
+    float MinX     = FLT_MAX;
+    float MaxX     = -FLT_MAX;
+    float MinY     = FLT_MAX;
+    float MaxY     = -FLT_MAX;
+    float MinDepth = FLT_MAX;
+    for (uint32 Corner = 0; Corner < 8; Corner++)
+    {
+        const XMFLOAT3 Position(
+            (Corner & 1) ? Center.x + Extent.x : Center.x - Extent.x,
+            (Corner & 2) ? Center.y + Extent.y : Center.y - Extent.y,
+            (Corner & 4) ? Center.z + Extent.z : Center.z - Extent.z);
+
+        XMFLOAT4 ClipPosition;
+        XMStoreFloat4(&ClipPosition, XMVector3Transform(XMLoadFloat3(&Position), XmViewProjection));
+        if (ClipPosition.w < OCCLUSION_MIN_W || ClipPosition.z < 0.0f)
+        {
+            return true;
+        }
+
+        const float InvW = 1.0f / ClipPosition.w;
+        const float X    = ((ClipPosition.x * InvW) * 0.5f + 0.5f) * float(Width);
+        const float Y    = (0.5f - (ClipPosition.y * InvW) * 0.5f) * float(Height);
+        MinX     = std::min(MinX, X);
+        MaxX     = std::max(MaxX, X);
+        MinY     = std::min(MinY, Y);
+        MaxY     = std::max(MaxY, Y);
+        MinDepth = std::min(MinDepth, ClipPosition.z * InvW);
+    }
+
+    // All pixels that the rectangle touches, not only the ones whose centers are inside
+    const int32 FirstPixelX = std::max(int32(floorf(MinX)), 0);
+    const int32 LastPixelX  = std::min(int32(ceilf(MaxX)) - 1, int32(Width) - 1);
+    const int32 FirstPixelY = std::max(int32(floorf(MinY)), 0);
+    const int32 LastPixelY  = std::min(int32(ceilf(MaxY)) - 1, int32(Height) - 1);
+    if (FirstPixelX > LastPixelX || FirstPixelY > LastPixelY)
+    {
+        // Outside of the screen, which is up to the frustum culling to decide
+        return true;
+    }
+
+    for (int32 TileY = FirstPixelY / int32(OCCLUSION_TILE_HEIGHT); TileY <= LastPixelY / int32(OCCLUSION_TILE_HEIGHT); TileY++)
+    {
+        const int32 TileTop   = TileY * int32(OCCLUSION_TILE_HEIGHT);
+        const int32 FirstRow  = std::max(FirstPixelY - TileTop, 0);
+        const int32 LastRow   = std::min(LastPixelY - TileTop, int32(OCCLUSION_TILE_HEIGHT) - 1);
+
+        for (int32 TileX = FirstPixelX / int32(OCCLUSION_TILE_WIDTH); TileX <= LastPixelX / int32(OCCLUSION_TILE_WIDTH); TileX++)
+        {
+            const int32 TileLeft    = TileX * int32(OCCLUSION_TILE_WIDTH);
+            const int32 FirstColumn = std::max(FirstPixelX - TileLeft, 0);
+            const int32 LastColumn  = std::min(LastPixelX - TileLeft, int32(OCCLUSION_TILE_WIDTH) - 1);
+
+            const uint64 RowBits = ((uint64(1) << (LastColumn + 1)) - 1) & ~((uint64(1) << FirstColumn) - 1);
+
+            uint64 RectangleMask = 0;
+            for (int32 Row = FirstRow; Row <= LastRow; Row++)
+            {
+                RectangleMask |= RowBits << (Row * int32(OCCLUSION_TILE_WIDTH));
+            }
+
+            // Pixels outside of the mask are only known to be closer than the reference depth
+            const Tile& CurrentTile = Tiles[(TileY * NumTilesX) + TileX];
+            const float TileDepth   = (RectangleMask & ~CurrentTile.Mask) != 0 ? CurrentTile.ReferenceDepth : std::min(CurrentTile.ReferenceDepth, CurrentTile.WorkingDepth);
+            if (MinDepth <= TileDepth)
+            {
+                return true;
+            }
+        }
+    }
+
+    Statistics.NumOccludedBoxes++;
+    return false;
+}
+
+void OcclusionBuffer::ResolveDepth(TArray<float>& OutDepth) const
+{
+    OutDepth.Resize(Width * Height);
+    for (uint32 Y = 0; Y < Height; Y++)
+    {
+        for (uint32 X = 0; X < Width; X++)
+        {
+            const Tile&  CurrentTile = Tiles[((Y / OCCLUSION_TILE_HEIGHT) * NumTilesX) + (X / OCCLUSION_TILE_WIDTH)];
+            const uint32 Bit         = ((Y % OCCLUSION_TILE_HEIGHT) * OCCLUSION_TILE_WIDTH) + (X % OCCLUSION_TILE_WIDTH);
+            const bool   IsInMask    = (CurrentTile.Mask >> Bit) & 1;
+            OutDepth[(Y * Width) + X] = IsInMask ? std::min(CurrentTile.ReferenceDepth, CurrentTile.WorkingDepth) : CurrentTile.ReferenceDepth;
+        }
+    }
+}
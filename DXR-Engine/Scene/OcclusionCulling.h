@@ -0,0 +1,84 @@
+#pragma once
+#include "Core/Containers/Array.h"
+
+// Each tile stores one bit per pixel in a uint64
+constexpr uint32 OCCLUSION_TILE_WIDTH  = 8;
+constexpr uint32 OCCLUSION_TILE_HEIGHT = 8;
+
+constexpr uint32 OCCLUSION_BUFFER_WIDTH  = 256;
+constexpr uint32 OCCLUSION_BUFFER_HEIGHT = 128;
+
+struct OcclusionStatistics
+{
+    uint32 NumOccluders           = 0;
+    uint32 NumOccluderTriangles   = 0;
+    uint32 NumRasterizedTriangles = 0;
+    uint32 NumTestedBoxes         = 0;
+    uint32 NumOccludedBoxes       = 0;
+};
+
+/*
+* Low resolution depth buffer that occluders are rasterized into on the CPU, used to skip objects that are hidden
+* behind other objects before they are drawn. Depth is z / w of the projection, smaller is closer.
+*
+* Instead of a depth per pixel every 8x8 tile stores two depths and a coverage mask, as in masked software occlusion
+* culling. All pixels of the tile are at most at the reference depth, and the pixels in the mask are also at most at
+* the working depth. A triangle is merged into the working layer, and when the mask covers the whole tile the working
+* layer replaces the reference layer. When a triangle is much closer than the working layer, the working layer is
+* discarded instead, since it would only make the working depth worse. The buffer is always conservative, so an
+* object is never reported as occluded when any part of it can be seen.
+*/
+
+class OcclusionBuffer
+{
+public:
+    OcclusionBuffer()  = default;
+    ~OcclusionBuffer() = default;
+
+    // The size is rounded up to whole tiles
+    void Resize(uint32 InWidth, uint32 InHeight);
+
+    // Clears the buffer, the matrix is transposed in the same way as Camera::GetViewProjectionMatrix
+    void BeginFrame(const XMFLOAT4X4& ViewProjection);
+
+    // Rasterizes an indexed triangle list, the transform is transposed in the same way as Transform::GetMatrix
+    void RenderOccluder(const XMFLOAT3* Positions, const uint32* Indices, uint32 NumIndices, const XMFLOAT4X4& Transform);
+
+    // Returns false if the world space box is hidden behind the occluders that have been rendered
+    bool IsBoxVisible(const XMFLOAT3& Center, const XMFLOAT3& Extent);
+
+    // Writes the furthest possible depth of each pixel, used to debug the buffer
+    void ResolveDepth(TArray<float>& OutDepth) const;
+
+    uint32 GetWidth() const { return Width; }
+    uint32 GetHeight() const { return Height; }
+
+    const OcclusionStatistics& GetStatistics() const { return Statistics; }
+
+private:
+    struct Tile
+    {
+        uint64 Mask;
+        float  ReferenceDepth;
+        float  WorkingDepth;
+    };
+
+    // The vertices are in clip space
+    void ClipAndRasterizeTriangle(const XMFLOAT4& Vertex0, const XMFLOAT4& Vertex1, const XMFLOAT4& Vertex2);
+
+    // The vertices are in pixels and the depth is in z
+    void RasterizeTriangle(const XMFLOAT3& Vertex0, const XMFLOAT3& Vertex1, const XMFLOAT3& Vertex2);
+
+    void UpdateTile(Tile& InTile, uint64 Coverage, float TriangleDepth);
+
+    TArray<Tile> Tiles;
+    uint32 Width     = 0;
+    uint32 Height    = 0;
+    uint32 NumTilesX = 0;
+    uint32 NumTilesY = 0;
+
+    // Not transposed
+    XMFLOAT4X4 ViewProjection;
+
+    OcclusionStatistics Statistics;
+};
@@ -1,17 +1,84 @@
 #include "Scene.h"
 
+#include "SceneCache.h"
+
 #include "Components/MeshComponent.h"
 
 #include "Rendering/Resources/TextureFactory.h"
 #include "Rendering/Resources/MeshFactory.h"
+#include "Rendering/Resources/GltfFile.h"
 #include "Rendering/Resources/Material.h"
 #include "Rendering/Resources/Mesh.h"
 
 #include "RenderLayer/Resources.h"
 
+#include "Core/Threading/TaskManager.h"
+#include "Core/Threading/Platform/PlatformProcess.h"
+
+#include "Debug/Profiler.h"
+
 #include <tiny_obj_loader.h>
 
 #include <unordered_map>
+#include <algorithm>
+#include <cfloat>
+
+// A LOD is used when its error is at most this many pixels on a view that is LOD_REFERENCE_HEIGHT pixels high
+static constexpr float LOD_MAX_PIXEL_ERROR  = 1.0f;
+static constexpr float LOD_REFERENCE_HEIGHT = 1080.0f;
+
+// The least detailed LOD with at most this error relative to the size of the mesh is used as occluder
+static constexpr float OCCLUDER_MAX_LOD_ERROR = 0.01f;
+
+// Returns the mesh of an actor that is used as its occluder, Meshes[0] is the original mesh and has no error
+static const PackedMeshDataView& GetOccluderData(const CookedMesh* Meshes, uint32 NumMeshes)
+{
+    uint32 Occluder = 0;
+    for (uint32 LOD = 1; LOD < NumMeshes; LOD++)
+    {
+        if (Meshes[LOD].Error <= OCCLUDER_MAX_LOD_ERROR)
+        {
+            Occluder = LOD;
+        }
+    }
+
+    return Meshes[Occluder].Data;
+}
+
+// Creates a mesh for each LOD in the cooked scene, which are the meshes that follow the original mesh
+static void AddMeshLODs(const TSharedPtr<Mesh>& BaseMesh, const CookedMesh* LODs, uint32 NumLODs)
+{
+    const XMFLOAT3& Top    = BaseMesh->BoundingBox.Top;
+    const XMFLOAT3& Bottom = BaseMesh->BoundingBox.Bottom;
+    const XMFLOAT3  Size   = XMFLOAT3(Top.x - Bottom.x, Top.y - Bottom.y, Top.z - Bottom.z);
+
+    // The errors are relative to the largest side of the box, and the screen size is the diameter of the bounding
+    // sphere relative to the height of the view
+    const float Diameter = sqrtf((Size.x * Size.x) + (Size.y * Size.y) + (Size.z * Size.z));
+    const float Extent   = std::max(Size.x, std::max(Size.y, Size.z));
+
+    float PreviousScreenSize = FLT_MAX;
+    for (uint32 LOD = 0; LOD < NumLODs; LOD++)
+    {
+        const float Error = LODs[LOD].Error;
+
+        float ScreenSize = FLT_MAX;
+        if (Error > 0.0f && Extent > 0.0f)
+        {
+            ScreenSize = (LOD_MAX_PIXEL_ERROR * Diameter) / (Error * Extent * LOD_REFERENCE_HEIGHT);
+        }
+
+        // Two LODs can have the same error, but the thresholds have to decrease
+        ScreenSize = std::min(ScreenSize, PreviousScreenSize * 0.99f);
+        PreviousScreenSize = ScreenSize;
+
+        TSharedPtr<Mesh> LODMesh = Mesh::Make(LODs[LOD].Data);
+        if (LODMesh)
+        {
+            BaseMesh->AddLOD(LODMesh, ScreenSize);
+        }
+    }
+}
 
 Scene::Scene()
     : Actors()
@@ -20,8 +87,12 @@ Scene::Scene()
 
 Scene::~Scene()
 {
+    Components.Clear();
+
+    // The actors are deleted together, so there is no need to remove them one at a time
     for (Actor* CurrentActor : Actors)
     {
+        CurrentActor->OnRemovedFromScene();
         SafeDelete(CurrentActor);
     }
     Actors.Clear();
@@ -38,6 +109,9 @@ Scene::~Scene()
 void Scene::Tick(Timestamp DeltaTime)
 {
     UNREFERENCED_VARIABLE(DeltaTime);
+
+    UpdateTransforms();
+    UpdateWorldBounds();
 }
 
 void Scene::AddCamera(Camera* InCamera)
@@ -56,12 +130,42 @@ void Scene::AddActor(Actor* InActor)
     Actors.EmplaceBack(InActor);
 
     InActor->OnAddedToScene(this);
+    IsTransformOrderDirty = true;
 
-    MeshComponent* Component = InActor->GetComponentOfType<MeshComponent>();
-    if (Component)
+    for (Component* CurrentComponent : InActor->GetComponents())
     {
-        AddMeshComponent(Component);
+        OnAddedComponent(CurrentComponent);
+    }
+}
+
+void Scene::RemoveActor(Actor* InActor)
+{
+    Assert(InActor != nullptr);
+    Assert(InActor->GetScene() == this);
+
+    for (Component* CurrentComponent : InActor->GetComponents())
+    {
+        OnRemovedComponent(CurrentComponent);
+    }
+
+    // The children are not updated by the scene anymore once their parent is gone
+    while (!InActor->GetChildren().IsEmpty())
+    {
+        InActor->GetChildren().Back()->SetParent(nullptr);
+    }
+
+    Actor** ActorPosition = std::find(Actors.Begin(), Actors.End(), InActor);
+    Assert(ActorPosition != Actors.End());
+    Actors.Erase(ActorPosition);
+
+    // Removing an actor keeps the order of the others valid
+    Actor** SortedPosition = std::find(SortedActors.Begin(), SortedActors.End(), InActor);
+    if (SortedPosition != SortedActors.End())
+    {
+        SortedActors.Erase(SortedPosition);
     }
+
+    InActor->OnRemovedFromScene();
 }
 
 void Scene::AddLight(Light* InLight)
@@ -72,6 +176,8 @@ void Scene::AddLight(Light* InLight)
 
 void Scene::OnAddedComponent(Component* NewComponent)
 {
+    Components.Add(NewComponent);
+
     MeshComponent* Component = Cast<MeshComponent>(NewComponent);
     if (Component)
     {
@@ -79,8 +185,233 @@ void Scene::OnAddedComponent(Component* NewComponent)
     }
 }
 
-Scene* Scene::LoadFromFile(const std::string& Filepath)
+void Scene::OnRemovedComponent(Component* RemovedComponent)
+{
+    // The index of the MeshDrawCommand is the index of the component, which is gone after the storage removes it
+    MeshComponent* Component = Cast<MeshComponent>(RemovedComponent);
+    if (Component)
+    {
+        RemoveMeshComponent(Component);
+    }
+
+    Components.Remove(RemovedComponent->GetHandle());
+}
+
+void Scene::OnActorParentChanged(Actor* InActor)
+{
+    UNREFERENCED_VARIABLE(InActor);
+    IsTransformOrderDirty = true;
+}
+
+void Scene::UpdateTransforms()
+{
+    TRACE_SCOPE("Update Transforms");
+
+    if (IsTransformOrderDirty)
+    {
+        SortTransforms();
+        IsTransformOrderDirty = false;
+    }
+
+    // Since the parents come first, each transform only has to compare its version with the one of its parent
+    for (Actor* CurrentActor : SortedActors)
+    {
+        CurrentActor->GetTransform().UpdateMatrix();
+    }
+}
+
+void Scene::SortTransforms()
+{
+    TArray<uint32> Depths(Actors.Size());
+    TArray<uint32> Order(Actors.Size());
+    for (uint32 Index = 0; Index < Actors.Size(); Index++)
+    {
+        uint32 Depth = 0;
+        for (Actor* Parent = Actors[Index]->GetParent(); Parent; Parent = Parent->GetParent())
+        {
+            Depth++;
+        }
+
+        Depths[Index] = Depth;
+        Order[Index]  = Index;
+    }
+
+    std::stable_sort(Order.Data(), Order.Data() + Order.Size(), [&Depths](uint32 Left, uint32 Right)
+    {
+        return Depths[Left] < Depths[Right];
+    });
+
+    SortedActors.Resize(Actors.Size());
+    for (uint32 Index = 0; Index < Order.Size(); Index++)
+    {
+        SortedActors[Index] = Actors[Order[Index]];
+    }
+}
+
+void Scene::UpdateWorldBounds()
 {
+    TRACE_SCOPE("Update World Bounds");
+
+    MovedObjects.Clear();
+    for (uint32 Index = 0; Index < MeshDrawCommands.Size(); Index++)
+    {
+        if (MeshDrawCommands[Index].CurrentActor->GetTransform().IsDirty())
+        {
+            CalculateWorldBounds(Index);
+            MovedObjects.EmplaceBack(Index);
+        }
+    }
+
+    // An actor can have more than one MeshDrawCommand, so the flag is cleared after all commands have been updated
+    for (Actor* CurrentActor : Actors)
+    {
+        CurrentActor->GetTransform().ClearDirty();
+    }
+
+    // The object indices change when MeshDrawCommands are added or removed, even if the number of them stays the same
+    if (IsBVHDirty)
+    {
+        BVH.Build(WorldBoundingBoxes);
+        IsBVHDirty = false;
+    }
+    else
+    {
+        BVH.Update(MovedObjects);
+    }
+}
+
+// Reads each shape with ReadShape and calculates its tangents, triangle order, LODs and meshlets, then packs them and
+// appends an actor for each shape to OutScene. TShape needs a Name and a MaterialID. Nothing is shared between shapes, so
+// the result does not depend on which thread builds which shape, and the meshes of OutScene point into OutMeshData.
+template<typename TShape, typename TReadShape>
+static void CookShapes(const TArray<TShape>& Shapes, const TReadShape& ReadShape, TArray<PackedMeshData>& OutMeshData, CookedScene& OutScene)
+{
+    // ShapeMeshes[i] is the packed mesh of shape i followed by its LODs
+    TArray<TArray<PackedMeshData>> ShapeMeshes(Shapes.Size());
+    TArray<TArray<float>>          ShapeErrors(Shapes.Size());
+
+    auto BuildShapeMesh = [&](uint32 MeshIndex)
+    {
+        MeshData Data;
+        ReadShape(Shapes[MeshIndex], Data);
+
+        MeshFactory::CalculateTangents(Data);
+        MeshFactory::Optimize(Data);
+        MeshLODChain LODChain = MeshFactory::GenerateLODs(Data);
+
+        // The meshlets reorder the triangles, so they are built after the LODs have been simplified from the mesh
+        MeshFactory::BuildMeshlets(Data);
+        for (MeshData& LODData : LODChain.LODs)
+        {
+            MeshFactory::BuildMeshlets(LODData);
+        }
+
+        TArray<PackedMeshData>& Packed = ShapeMeshes[MeshIndex];
+        Packed.Resize(LODChain.LODs.Size() + 1);
+        MeshFactory::PackMesh(Data, Packed[0]);
+        for (uint32 LOD = 0; LOD < LODChain.LODs.Size(); LOD++)
+        {
+            MeshFactory::PackMesh(LODChain.LODs[LOD], Packed[LOD + 1]);
+        }
+
+        TArray<float>& Errors = ShapeErrors[MeshIndex];
+        Errors.EmplaceBack(0.0f);
+        for (float Error : LODChain.Errors)
+        {
+            Errors.EmplaceBack(Error);
+        }
+    };
+
+    // Tasks take the next shape until there are no more, and this thread takes shapes as well instead of waiting. The
+    // GPU resources are created on this thread once all shapes are done. The tasks refer to the counters on the stack,
+    // so all of them have to finish before returning.
+    ThreadSafeInt32 NextMesh(0);
+    ThreadSafeInt32 NumCompletedTasks(0);
+    auto BuildShapeMeshes = [&]()
+    {
+        for (int32 Index = NextMesh.Increment() - 1; Index < int32(Shapes.Size()); Index = NextMesh.Increment() - 1)
+        {
+            BuildShapeMesh(uint32(Index));
+        }
+    };
+
+    const uint32 NumTasks = std::min(TaskManager::Get().GetNumWorkers(), Shapes.Size());
+    for (uint32 TaskIndex = 0; TaskIndex < NumTasks; TaskIndex++)
+    {
+        Task BuildTask;
+        BuildTask.Delegate.BindLambda([&]()
+        {
+            BuildShapeMeshes();
+            NumCompletedTasks.Increment();
+        });
+
+        TaskManager::Get().AddTask(BuildTask);
+    }
+
+    BuildShapeMeshes();
+
+    while (NumCompletedTasks.Load() < int32(NumTasks))
+    {
+        if (!TaskManager::Get().ExecuteTask())
+        {
+            PlatformProcess::Sleep(0);
+        }
+    }
+
+    // Each shape is followed by its LODs
+    TArray<float> Errors;
+    for (uint32 MeshIndex = 0; MeshIndex < ShapeMeshes.Size(); MeshIndex++)
+    {
+        TArray<PackedMeshData>& Packed = ShapeMeshes[MeshIndex];
+
+        CookedActor& NewActor = OutScene.Actors.EmplaceBack();
+        NewActor.Name       = Shapes[MeshIndex].Name;
+        NewActor.MaterialID = Shapes[MeshIndex].MaterialID;
+        NewActor.FirstMesh  = OutMeshData.Size();
+        NewActor.NumMeshes  = Packed.Size();
+
+        for (uint32 LOD = 0; LOD < Packed.Size(); LOD++)
+        {
+            OutMeshData.EmplaceBack(Move(Packed[LOD]));
+            Errors.EmplaceBack(ShapeErrors[MeshIndex][LOD]);
+        }
+    }
+
+    // OutMeshData does not move anymore, so it is safe to point into it
+    OutScene.Meshes.Resize(OutMeshData.Size());
+    for (uint32 MeshIndex = 0; MeshIndex < OutMeshData.Size(); MeshIndex++)
+    {
+        OutScene.Meshes[MeshIndex].Data  = PackedMeshDataView(OutMeshData[MeshIndex]);
+        OutScene.Meshes[MeshIndex].Error = Errors[MeshIndex];
+    }
+}
+
+// The position, normal and texcoord indices of a corner of an OBJ face, -1 when the face does not have the attribute
+struct ObjIndexKey
+{
+    bool operator==(const ObjIndexKey& Other) const
+    {
+        return Position == Other.Position && Normal == Other.Normal && TexCoord == Other.TexCoord;
+    }
+
+    int32 Position;
+    int32 Normal;
+    int32 TexCoord;
+};
+
+struct ObjIndexKeyHasher
+{
+    size_t operator()(const ObjIndexKey& Key) const
+    {
+        return size_t(HashValue(Key));
+    }
+};
+
+// Parses the OBJ file and does all the work that does not need a device, the meshes of OutScene point into OutMeshData
+static bool ImportObjScene(const std::string& Filepath, const std::string& MTLFiledir, TArray<PackedMeshData>& OutMeshData, CookedScene& OutScene)
+{
+    TRACE_SCOPE("Import OBJ Scene");
+
     // Load Scene File
     std::string Warning;
     std::string Error;
@@ -88,17 +419,251 @@ Scene* Scene::LoadFromFile(const std::string& Filepath)
     std::vector<tinyobj::material_t> Materials;
     tinyobj::attrib_t Attributes;
 
-    std::string MTLFiledir = std::string(Filepath.begin(), Filepath.begin() + Filepath.find_last_of('/'));
     if (!tinyobj::LoadObj(&Attributes, &Shapes, &Materials, &Warning, &Error, Filepath.c_str(), MTLFiledir.c_str(), true, false))
     {
         LOG_WARNING("[Scene]: Failed to load Scene '" + Filepath + "'." + " Warning: " + Warning + " Error: " + Error);
-        return nullptr;
+        return false;
     }
     else
     {
         LOG_INFO("[Scene]: Loaded Scene'" + Filepath + "'");
     }
 
+    for (tinyobj::material_t& Mat : Materials)
+    {
+        CookedMaterial& NewMaterial = OutScene.Materials.EmplaceBack();
+        NewMaterial.Metallic = Mat.ambient[0];
+
+        // MTL files do not have an ambient occlusion map
+        std::string* TextureNames[CookedTexture_Count] = { };
+        TextureNames[CookedTexture_Metallic]  = &Mat.ambient_texname;
+        TextureNames[CookedTexture_Albedo]    = &Mat.diffuse_texname;
+        TextureNames[CookedTexture_Roughness] = &Mat.specular_highlight_texname;
+        TextureNames[CookedTexture_Normal]    = &Mat.bump_texname;
+        TextureNames[CookedTexture_Alpha]     = &Mat.alpha_texname;
+
+        for (uint32 Texture = 0; Texture < CookedTexture_Count; Texture++)
+        {
+            if (!TextureNames[Texture])
+            {
+                continue;
+            }
+
+            ConvertBackslashes(*TextureNames[Texture]);
+            NewMaterial.TextureNames[Texture] = *TextureNames[Texture];
+        }
+    }
+
+    // Construct Scene. Each run of faces with the same material in a shape becomes a mesh. The runs are found first, so
+    // that they can be built in parallel and still end up in the same order as in the file.
+    struct ShapeMesh
+    {
+        std::string Name;
+        int32       MaterialID;
+
+        const tinyobj::shape_t* Shape;
+        uint32 FirstIndex;
+        uint32 NumIndices;
+    };
+
+    TArray<ShapeMesh> ShapeMeshes;
+    for (const tinyobj::shape_t& Shape : Shapes)
+    {
+        const uint32 NumIndices = static_cast<uint32>(Shape.mesh.indices.size());
+
+        uint32 i = 0;
+        while (i < NumIndices)
+        {
+            const uint32 FirstIndex = i;
+            const int32  MaterialID = Shape.mesh.material_ids[i / 3];
+
+            // Break if material is not the same
+            while (i < NumIndices && Shape.mesh.material_ids[i / 3] == MaterialID)
+            {
+                i++;
+            }
+
+            ShapeMeshes.EmplaceBack(ShapeMesh{ Shape.name, MaterialID, &Shape, FirstIndex, i - FirstIndex });
+        }
+    }
+
+    // Welds the vertices of one run, nothing is shared between runs so they can be read on any thread
+    auto ReadShapeMesh = [&Attributes](const ShapeMesh& CurrentShape, MeshData& Data)
+    {
+        const tinyobj::shape_t& Shape = *CurrentShape.Shape;
+
+        Data.Indices.Reserve(CurrentShape.NumIndices);
+
+        // Corners with the same indices are the same vertex, so the indices are hashed instead of the vertices. Corners
+        // with other indices but the same attributes are welded by MeshFactory::Optimize.
+        std::unordered_map<ObjIndexKey, uint32, ObjIndexKeyHasher> UniqueVertices;
+        UniqueVertices.reserve(CurrentShape.NumIndices);
+
+        const uint32 EndIndex = CurrentShape.FirstIndex + CurrentShape.NumIndices;
+        for (uint32 i = CurrentShape.FirstIndex; i < EndIndex; i++)
+        {
+            const tinyobj::index_t& Index = Shape.mesh.indices[i];
+
+            const ObjIndexKey Key = { Index.vertex_index, Index.normal_index, Index.texcoord_index };
+            auto Result = UniqueVertices.emplace(Key, static_cast<uint32>(Data.Vertices.Size()));
+            Data.Indices.EmplaceBack(Result.first->second);
+            if (!Result.second)
+            {
+                continue;
+            }
+
+            // The attributes that the file does not have must be zero, since the whole vertex is compared and hashed
+            Vertex TempVertex = { };
+
+            // Normals and texcoords are optional, Positions are required
+            Assert(Index.vertex_index >= 0);
+
+            size_t PositionIndex = 3 * static_cast<size_t>(Index.vertex_index);
+            TempVertex.Position =
+            {
+                Attributes.vertices[PositionIndex + 0],
+                Attributes.vertices[PositionIndex + 1],
+                Attributes.vertices[PositionIndex + 2],
+            };
+
+            if (Index.normal_index >= 0)
+            {
+                size_t NormalIndex = 3 * static_cast<size_t>(Index.normal_index);
+                TempVertex.Normal =
+                {
+                    Attributes.normals[NormalIndex + 0],
+                    Attributes.normals[NormalIndex + 1],
+                    Attributes.normals[NormalIndex + 2],
+                };
+            }
+
+            if (Index.texcoord_index >= 0)
+            {
+                size_t TexCoordIndex = 2 * static_cast<size_t>(Index.texcoord_index);
+                TempVertex.TexCoord =
+                {
+                    Attributes.texcoords[TexCoordIndex + 0],
+                    Attributes.texcoords[TexCoordIndex + 1],
+                };
+            }
+
+            Data.Vertices.PushBack(TempVertex);
+        }
+    };
+
+    CookShapes(ShapeMeshes, ReadShapeMesh, OutMeshData, OutScene);
+    return true;
+}
+
+// Does all the work that does not need a device for a glTF file, the meshes of OutScene point into OutMeshData. Every
+// primitive of a node becomes an actor, with the transforms of the node hierarchy applied to its vertices.
+static bool ImportGltfScene(const GltfFile& File, TArray<PackedMeshData>& OutMeshData, CookedScene& OutScene)
+{
+    TRACE_SCOPE("Import glTF Scene");
+
+    TArray<GltfPrimitiveInstance> Instances;
+    File.GetPrimitiveInstances(Instances);
+    if (Instances.IsEmpty())
+    {
+        LOG_WARNING("[Scene]: Scene '" + File.GetFilename() + "' does not have any meshes");
+        return false;
+    }
+
+    LOG_INFO("[Scene]: Loaded Scene '" + File.GetFilename() + "'");
+
+    TArray<std::string> ImageNames;
+    File.ExportImages(ImageNames);
+
+    auto GetImageName = [&ImageNames](int32 Image) -> std::string
+    {
+        return (Image >= 0 && uint32(Image) < ImageNames.Size()) ? ImageNames[Image] : std::string();
+    };
+
+    TArray<GltfMaterial> Materials;
+    File.GetMaterials(Materials);
+    for (const GltfMaterial& Mat : Materials)
+    {
+        CookedMaterial& NewMaterial = OutScene.Materials.EmplaceBack();
+        NewMaterial.Albedo    = XMFLOAT3(Mat.BaseColorFactor.x, Mat.BaseColorFactor.y, Mat.BaseColorFactor.z);
+        NewMaterial.Roughness = Mat.RoughnessFactor;
+        NewMaterial.Metallic  = Mat.MetallicFactor;
+
+        NewMaterial.TextureNames[CookedTexture_Albedo] = GetImageName(Mat.BaseColorImage);
+        NewMaterial.TextureNames[CookedTexture_Normal] = GetImageName(Mat.NormalImage);
+
+        // Roughness and metallic share an image, and occlusion is often packed into the same image as well
+        NewMaterial.TextureNames[CookedTexture_Roughness] = GetImageName(Mat.MetallicRoughnessImage);
+        NewMaterial.TextureFlags[CookedTexture_Roughness] = TextureFactoryFlag_ChannelG;
+        NewMaterial.TextureNames[CookedTexture_Metallic]  = GetImageName(Mat.MetallicRoughnessImage);
+        NewMaterial.TextureFlags[CookedTexture_Metallic]  = TextureFactoryFlag_ChannelB;
+        NewMaterial.TextureNames[CookedTexture_AO]        = GetImageName(Mat.OcclusionImage);
+        NewMaterial.TextureFlags[CookedTexture_AO]        = TextureFactoryFlag_ChannelR;
+
+        // There is no blending, so blended materials are alpha tested as well
+        if (Mat.AlphaMode != EGltfAlphaMode::Opaque)
+        {
+            NewMaterial.TextureNames[CookedTexture_Alpha] = GetImageName(Mat.BaseColorImage);
+            NewMaterial.TextureFlags[CookedTexture_Alpha] = TextureFactoryFlag_ChannelA;
+        }
+    }
+
+    // A primitive that can not be read is left empty, and no actor is created for it
+    auto ReadPrimitive = [&File](const GltfPrimitiveInstance& Instance, MeshData& Data)
+    {
+        if (!File.ReadPrimitive(Instance, true, Data))
+        {
+            Data.Vertices.Clear();
+            Data.Indices.Clear();
+        }
+    };
+
+    CookShapes(Instances, ReadPrimitive, OutMeshData, OutScene);
+    return true;
+}
+
+Scene* Scene::LoadFromFile(const std::string& Filepath)
+{
+    TRACE_SCOPE("Load Scene");
+
+    std::string MTLFiledir = std::string(Filepath.begin(), Filepath.begin() + Filepath.find_last_of('/'));
+
+    // The glTF file is opened before the cache is checked, since its buffers are part of the source
+    const bool IsGltf = GltfFile::IsGltfFilename(Filepath);
+
+    GltfFile Gltf;
+    if (IsGltf && !Gltf.Open(Filepath))
+    {
+        return nullptr;
+    }
+
+    // The cache is only valid as long as it was cooked from the same source files
+    const std::string CacheFilepath = Filepath + SCENE_CACHE_EXTENSION;
+    const uint64      SourceHash    = IsGltf ? SceneCache::HashGltfSource(Gltf) : SceneCache::HashObjSource(Filepath, MTLFiledir);
+
+    // The meshes of the CookedScene point either into the cache or into ImportedMeshData, which both must stay alive
+    // until the meshes have been created
+    SceneCache             Cache;
+    CookedScene            Cooked;
+    TArray<PackedMeshData> ImportedMeshData;
+    if (SourceHash != 0 && Cache.Open(CacheFilepath, SourceHash))
+    {
+        Cache.GetScene(Cooked);
+        LOG_INFO("[Scene]: Loaded cooked Scene '" + CacheFilepath + "'");
+    }
+    else
+    {
+        const bool Imported = IsGltf ? ImportGltfScene(Gltf, ImportedMeshData, Cooked) : ImportObjScene(Filepath, MTLFiledir, ImportedMeshData, Cooked);
+        if (!Imported)
+        {
+            return nullptr;
+        }
+
+        if (SourceHash != 0 && SceneCache::Write(CacheFilepath, SourceHash, Cooked))
+        {
+            LOG_INFO("[Scene]: Wrote cooked Scene '" + CacheFilepath + "'");
+        }
+    }
+
     // Create standard textures
     uint8 Pixels[] = { 255, 255, 255, 255 };
     TRef<Texture2D> WhiteTexture = TextureFactory::LoadFromMemory(Pixels, 1, 1, 0, EFormat::R8G8B8A8_Unorm);
@@ -141,15 +706,62 @@ Scene* Scene::LoadFromFile(const std::string& Filepath)
     BaseMaterial->Init();
 
     // Create All Materials in scene
+    const EFormat TextureFormats[CookedTexture_Count] =
+    {
+        EFormat::BC4_Unorm, // Metallic
+        EFormat::BC7_Unorm, // Albedo
+        EFormat::BC4_Unorm, // Roughness
+        EFormat::BC5_Unorm, // Normal
+        EFormat::BC4_Unorm, // Alpha
+        EFormat::BC4_Unorm, // AO
+    };
+
+    const uint32 TextureFlags[CookedTexture_Count] =
+    {
+        TextureFactoryFlag_GenerateMips,
+        TextureFactoryFlag_GenerateMips | TextureFactoryFlag_SRGB,
+        TextureFactoryFlag_GenerateMips,
+        TextureFactoryFlag_GenerateMips | TextureFactoryFlag_NormalMap,
+        TextureFactoryFlag_GenerateMips | TextureFactoryFlag_AlphaMask,
+        TextureFactoryFlag_GenerateMips,
+    };
+
+    TRef<Texture2D> Material::* const TextureSlots[CookedTexture_Count] =
+    {
+        &Material::MetallicMap,
+        &Material::AlbedoMap,
+        &Material::RoughnessMap,
+        &Material::NormalMap,
+        &Material::AlphaMask,
+        &Material::AOMap,
+    };
+
+    // The material slots that use each texture, the textures are loaded asynchronously and replace the placeholders
+    struct MaterialTextureSlot
+    {
+        TSharedPtr<Material> Target;
+        TRef<Texture2D> Material::* Slot;
+    };
+
+    struct PendingTexture
+    {
+        std::string Name;
+        EFormat Format;
+        uint32  Flags;
+        TArray<MaterialTextureSlot> Slots;
+    };
+
+    // An image can be loaded more than once, when the slots read different channels of it or use other formats
     TArray<TSharedPtr<Material>> LoadedMaterials;
-    std::unordered_map<std::string, TRef<Texture2D>> MaterialTextures;
-    for (tinyobj::material_t& Mat : Materials)
+    std::unordered_map<std::string, PendingTexture> MaterialTextures;
+    for (const CookedMaterial& Mat : Cooked.Materials)
     {
         // Create new material with default properties
         MaterialProperties MatProps;
-        MatProps.Metallic  = Mat.ambient[0];
+        MatProps.Albedo    = Mat.Albedo;
+        MatProps.Metallic  = Mat.Metallic;
         MatProps.AO        = 1.0f;
-        MatProps.Roughness = 1.0f;
+        MatProps.Roughness = Mat.Roughness;
 
         TSharedPtr<Material>& NewMaterial = LoadedMaterials.EmplaceBack(MakeShared<Material>(MatProps));
         LOG_INFO("Loaded materialID=" + std::to_string(LoadedMaterials.Size() - 1));
@@ -161,216 +773,101 @@ Scene* Scene::LoadFromFile(const std::string& Filepath)
         NewMaterial->RoughnessMap = WhiteTexture;
         NewMaterial->NormalMap    = NormalMap;
 
-        // Metallic
-        if (!Mat.ambient_texname.empty())
+        for (uint32 Texture = 0; Texture < CookedTexture_Count; Texture++)
         {
-            ConvertBackslashes(Mat.ambient_texname);
-            if (MaterialTextures.count(Mat.ambient_texname) == 0)
+            const std::string& TextureName = Mat.TextureNames[Texture];
+            if (TextureName.empty())
             {
-                std::string TexName = MTLFiledir + '/' + Mat.ambient_texname;
-                TRef<Texture2D> Texture = TextureFactory::LoadFromFile(TexName, TextureFactoryFlag_GenerateMips, EFormat::R8_Unorm);
-                if (Texture)
-                {
-                    Texture->SetName(Mat.ambient_texname);
-                    MaterialTextures[Mat.ambient_texname] = Texture;
-                }
-                else
-                {
-                    MaterialTextures[Mat.ambient_texname] = WhiteTexture;
-                }
+                continue;
             }
 
-            NewMaterial->MetallicMap = MaterialTextures[Mat.ambient_texname];
-        }
+            // Set the placeholder now, so that a material with an alpha mask is drawn as one from the first frame
+            TRef<Texture2D> Material::* Slot = TextureSlots[Texture];
+            (NewMaterial.Get()->*Slot) = (Texture == CookedTexture_Normal) ? NormalMap : WhiteTexture;
 
-        // Albedo
-        if (!Mat.diffuse_texname.empty())
-        {
-            ConvertBackslashes(Mat.diffuse_texname);
-            if (MaterialTextures.count(Mat.diffuse_texname) == 0)
-            {
-                std::string TexName = MTLFiledir + '/' + Mat.diffuse_texname;
-                TRef<Texture2D> Texture = TextureFactory::LoadFromFile(TexName, TextureFactoryFlag_GenerateMips, EFormat::R8G8B8A8_Unorm); 
-                if (Texture)
-                {
-                    Texture->SetName(Mat.diffuse_texname);
-                    MaterialTextures[Mat.diffuse_texname] = Texture;
-                }
-                else
-                {
-                    MaterialTextures[Mat.diffuse_texname] = WhiteTexture;
-                }
-            }
+            const uint32 Flags = TextureFlags[Texture] | Mat.TextureFlags[Texture];
 
-            NewMaterial->AlbedoMap = MaterialTextures[Mat.diffuse_texname];
+            PendingTexture& Pending = MaterialTextures[TextureName + '|' + std::to_string(Texture) + '|' + std::to_string(Flags)];
+            Pending.Name   = TextureName;
+            Pending.Format = TextureFormats[Texture];
+            Pending.Flags  = Flags;
+            Pending.Slots.PushBack({ NewMaterial, Slot });
         }
 
-        // Roughness
-        if (!Mat.specular_highlight_texname.empty())
-        {
-            ConvertBackslashes(Mat.specular_highlight_texname);
-            if (MaterialTextures.count(Mat.specular_highlight_texname) == 0)
-            {
-                std::string TexName = MTLFiledir + '/' + Mat.specular_highlight_texname;
-                TRef<Texture2D> Texture = TextureFactory::LoadFromFile(TexName, TextureFactoryFlag_GenerateMips, EFormat::R8_Unorm);
-                if (Texture)
-                {
-                    Texture->SetName(Mat.specular_highlight_texname);
-                    MaterialTextures[Mat.specular_highlight_texname] = Texture;
-                }
-                else
-                {
-                    MaterialTextures[Mat.specular_highlight_texname] = WhiteTexture;
-                }
-            }
+        NewMaterial->Init();
+    }
 
-            NewMaterial->RoughnessMap = MaterialTextures[Mat.specular_highlight_texname];
-        }
+    // Decoding happens on the worker threads and the materials are updated by TextureFactory::Tick
+    for (const auto& Pair : MaterialTextures)
+    {
+        const std::string& TextureName = Pair.second.Name;
 
-        // Normal
-        if (!Mat.bump_texname.empty())
+        TextureLoadedDelegate OnLoaded;
+        OnLoaded.BindLambda([TextureName, Slots = Pair.second.Slots](const TRef<Texture2D>& NewTexture)
         {
-            ConvertBackslashes(Mat.bump_texname);
-            if (MaterialTextures.count(Mat.bump_texname) == 0)
+            // Keep the placeholder if the texture could not be loaded
+            if (!NewTexture)
             {
-                std::string TexName = MTLFiledir + '/' + Mat.bump_texname;
-                TRef<Texture2D> Texture = TextureFactory::LoadFromFile(TexName, TextureFactoryFlag_GenerateMips, EFormat::R8G8B8A8_Unorm);
-                if (Texture)
-                {
-                    Texture->SetName(Mat.bump_texname);
-                    MaterialTextures[Mat.bump_texname] = Texture;
-                }
-                else
-                {
-                    MaterialTextures[Mat.bump_texname] = WhiteTexture;
-                }
+                return;
             }
 
-            NewMaterial->NormalMap = MaterialTextures[Mat.bump_texname];
-        }
-
-        // Alpha
-        if (!Mat.alpha_texname.empty())
-        {
-            ConvertBackslashes(Mat.alpha_texname);
-            if (MaterialTextures.count(Mat.alpha_texname) == 0)
+            NewTexture->SetName(TextureName);
+            for (const MaterialTextureSlot& Slot : Slots)
             {
-                std::string TexName = MTLFiledir + '/' + Mat.alpha_texname;
-                TRef<Texture2D> Texture = TextureFactory::LoadFromFile(TexName, TextureFactoryFlag_GenerateMips, EFormat::R8_Unorm);
-                if (Texture)
-                {
-                    Texture->SetName(Mat.alpha_texname);
-                    MaterialTextures[Mat.alpha_texname] = Texture;
-                }
-                else
-                {
-                    MaterialTextures[Mat.alpha_texname] = WhiteTexture;
-                }
+                (Slot.Target.Get()->*Slot.Slot) = NewTexture;
             }
+        });
 
-            NewMaterial->AlphaMask = MaterialTextures[Mat.alpha_texname];
-        }
-
-        NewMaterial->Init();
+        const std::string TexName = MTLFiledir + '/' + TextureName;
+        TextureFactory::LoadFromFileAsync(TexName, Pair.second.Flags, Pair.second.Format, OnLoaded);
     }
 
-    // Construct Scene
-    MeshData Data;
-    TUniquePtr<Scene> LoadedScene = MakeUnique<Scene>();
-    std::unordered_map<Vertex, uint32, VertexHasher> UniqueVertices;
+    // glTF files are in meters, the OBJ scenes are scaled down to the same size
+    const float ActorScale = IsGltf ? 1.0f : 0.015f;
 
-    for (const tinyobj::shape_t& Shape : Shapes)
+    TUniquePtr<Scene> LoadedScene = MakeUnique<Scene>();
+    for (const CookedActor& CurrentShape : Cooked.Actors)
     {
-        // Start at index zero for eaxh mesh and loop until all indices are processed
-        uint32 i = 0;
-        while (i < Shape.mesh.indices.size())
+        const CookedMesh* Meshes = Cooked.Meshes.Data() + CurrentShape.FirstMesh;
+        if (Meshes[0].Data.NumIndices == 0)
         {
-            // Start a new mesh
-            Data.Indices.Clear();
-            Data.Vertices.Clear();
-
-            UniqueVertices.clear();
-
-            uint32 Face = i / 3;
-            const int32 MaterialID = Shape.mesh.material_ids[Face];
-            for (; i < Shape.mesh.indices.size(); i++)
-            {
-                // Break if material is not the same
-                Face = i / 3;
-                if (Shape.mesh.material_ids[Face] != MaterialID)
-                {
-                    break;
-                }
-
-                const tinyobj::index_t& Index = Shape.mesh.indices[i];
-                Vertex TempVertex;
-
-                // Normals and texcoords are optional, Positions are required
-                Assert(Index.vertex_index >= 0);
-
-                size_t PositionIndex = 3 * static_cast<size_t>(Index.vertex_index);
-                TempVertex.Position =
-                {
-                    Attributes.vertices[PositionIndex + 0],
-                    Attributes.vertices[PositionIndex + 1],
-                    Attributes.vertices[PositionIndex + 2],
-                };
-
-                if (Index.normal_index >= 0)
-                {
-                    size_t NormalIndex = 3 * static_cast<size_t>(Index.normal_index);
-                    TempVertex.Normal =
-                    {
-                        Attributes.normals[NormalIndex + 0],
-                        Attributes.normals[NormalIndex + 1],
-                        Attributes.normals[NormalIndex + 2],
-                    };
-                }
-
-                if (Index.texcoord_index >= 0)
-                {
-                    size_t TexCoordIndex = 2 * static_cast<size_t>(Index.texcoord_index);
-                    TempVertex.TexCoord =
-                    {
-                        Attributes.texcoords[TexCoordIndex + 0],
-                        Attributes.texcoords[TexCoordIndex + 1],
-                    };
-                }
-
-                if (UniqueVertices.count(TempVertex) == 0)
-                {
-                    UniqueVertices[TempVertex] = static_cast<uint32>(Data.Vertices.Size());
-                    Data.Vertices.PushBack(TempVertex);
-                }
+            continue;
+        }
 
-                Data.Indices.EmplaceBack(UniqueVertices[TempVertex]);
-            }
+        TSharedPtr<Mesh> NewMesh = Mesh::Make(Meshes[0].Data);
+        if (!NewMesh)
+        {
+            continue;
+        }
 
-            // Calculate tangents and create mesh
-            MeshFactory::CalculateTangents(Data);
-            TSharedPtr<Mesh> NewMesh = Mesh::Make(Data);
+        AddMeshLODs(NewMesh, Meshes + 1, CurrentShape.NumMeshes - 1);
 
-            // Setup new actor for this shape
-            Actor* NewActor = DBG_NEW Actor();
-            NewActor->SetName(Shape.name);
-            NewActor->GetTransform().SetScale(0.015f, 0.015f, 0.015f);
+        // Setup new actor for this shape
+        Actor* NewActor = DBG_NEW Actor();
+        NewActor->SetName(CurrentShape.Name);
+        NewActor->GetTransform().SetScale(ActorScale, ActorScale, ActorScale);
 
-            // Add a MeshComponent
-            MeshComponent* NewComponent = DBG_NEW MeshComponent(NewActor);
-            NewComponent->Mesh = NewMesh;
-            if (MaterialID >= 0)
-            {
-                LOG_INFO(Shape.name + " got materialID=" + std::to_string(MaterialID));
-                NewComponent->Material = LoadedMaterials[MaterialID];
-            }
-            else
-            {
-                NewComponent->Material = BaseMaterial;
-            }
+        // Add a MeshComponent
+        MeshComponent* NewComponent = DBG_NEW MeshComponent(NewActor);
+        NewComponent->Mesh = NewMesh;
+        if (CurrentShape.MaterialID >= 0)
+        {
+            LOG_INFO(CurrentShape.Name + " got materialID=" + std::to_string(CurrentShape.MaterialID));
+            NewComponent->Material = LoadedMaterials[CurrentShape.MaterialID];
+        }
+        else
+        {
+            NewComponent->Material = BaseMaterial;
+        }
 
-            NewActor->AddComponent(NewComponent);
-            LoadedScene->AddActor(NewActor);
+        // The renderer only selects opaque actors as occluders, and always rasterizes the occluder of the original mesh
+        if (!NewComponent->Material->HasAlphaMask())
+        {
+            NewMesh->CreateOccluder(GetOccluderData(Meshes, CurrentShape.NumMeshes));
         }
+
+        NewActor->AddComponent(NewComponent);
+        LoadedScene->AddActor(NewActor);
     }
 
     return LoadedScene.Release();
@@ -386,4 +883,61 @@ void Scene::AddMeshComponent(MeshComponent* Component)
     Command.Material     = Component->Material.Get();
     Command.Mesh         = Component->Mesh.Get();
     MeshDrawCommands.PushBack(Command);
+
+    WorldBoundingBoxes.Add(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+    WorldBoundingSpheres.EmplaceBack(0.0f, 0.0f, 0.0f, 0.0f);
+
+    // The component can be added between two updates of the transforms
+    Command.CurrentActor->GetTransform().UpdateMatrix();
+    CalculateWorldBounds(MeshDrawCommands.Size() - 1);
+    IsBVHDirty = true;
+}
+
+void Scene::RemoveMeshComponent(MeshComponent* Component)
+{
+    // The commands are added in the same order as the components, and both move the last element into the hole, so a
+    // command is always at the index of its component
+    const uint32 Index = Components.GetIndex<MeshComponent>(Component->GetHandle());
+    Assert(Index < MeshDrawCommands.Size());
+    Assert(MeshDrawCommands[Index].Mesh == Component->Mesh.Get());
+
+    const uint32 LastIndex = MeshDrawCommands.Size() - 1;
+    MeshDrawCommands[Index]     = MeshDrawCommands[LastIndex];
+    WorldBoundingSpheres[Index] = WorldBoundingSpheres[LastIndex];
+    MeshDrawCommands.PopBack();
+    WorldBoundingSpheres.PopBack();
+    WorldBoundingBoxes.Remove(Index);
+    IsBVHDirty = true;
+}
+
+void Scene::CalculateWorldBounds(uint32 CommandIndex)
+{
+    const MeshDrawCommand& Command = MeshDrawCommands[CommandIndex];
+    const AABB& LocalBox = Command.Mesh->BoundingBox;
+
+    const XMFLOAT4X4& Transform = Command.CurrentActor->GetTransform().GetMatrix();
+    XMMATRIX XmTransform = XMMatrixTranspose(XMLoadFloat4x4(&Transform));
+
+    XMVECTOR XmTop         = XMLoadFloat3(&LocalBox.Top);
+    XMVECTOR XmBottom      = XMLoadFloat3(&LocalBox.Bottom);
+    XMVECTOR XmLocalCenter = XMVectorScale(XMVectorAdd(XmTop, XmBottom), 0.5f);
+    XMVECTOR XmLocalExtent = XMVectorAbs(XMVectorScale(XMVectorSubtract(XmTop, XmBottom), 0.5f));
+
+    // Transforming only two corners gives a box that is too small when the actor is rotated. Instead each local axis
+    // of the box is rotated and scaled by a row of the matrix, and the world extent is the sum of their absolute values.
+    XMVECTOR XmCenter = XMVector3TransformCoord(XmLocalCenter, XmTransform);
+    XMVECTOR XmExtent = XMVectorMultiply(XMVectorAbs(XmTransform.r[0]), XMVectorSplatX(XmLocalExtent));
+    XmExtent = XMVectorMultiplyAdd(XMVectorAbs(XmTransform.r[1]), XMVectorSplatY(XmLocalExtent), XmExtent);
+    XmExtent = XMVectorMultiplyAdd(XMVectorAbs(XmTransform.r[2]), XMVectorSplatZ(XmLocalExtent), XmExtent);
+
+    XMFLOAT3 Center;
+    XMFLOAT3 Extent;
+    XMStoreFloat3(&Center, XmCenter);
+    XMStoreFloat3(&Extent, XmExtent);
+    WorldBoundingBoxes.Set(CommandIndex, Center, Extent);
+
+    // The sphere around the local box is scaled by the largest scale of the matrix
+    XMVECTOR XmMaxScale = XMVectorMax(XMVector3Length(XmTransform.r[0]), XMVectorMax(XMVector3Length(XmTransform.r[1]), XMVector3Length(XmTransform.r[2])));
+    const float Radius  = XMVectorGetX(XMVector3Length(XmLocalExtent)) * XMVectorGetX(XmMaxScale);
+    WorldBoundingSpheres[CommandIndex] = XMFLOAT4(Center.x, Center.y, Center.z, Radius);
 }
@@ -1,6 +1,9 @@
 #pragma once
 #include "Actor.h"
+#include "ComponentStorage.h"
 #include "Camera.h"
+#include "FrustumCulling.h"
+#include "BoundingVolumeHierarchy.h"
 
 #include "Lights/Light.h"
 
@@ -22,30 +25,42 @@ public:
     void AddActor(Actor* InActor);
     void AddLight(Light* InLight);
 
+    // Removes the actor and its components from the scene without deleting them. Children of the actor are detached.
+    void RemoveActor(Actor* InActor);
+
     void OnAddedComponent(Component* NewComponent);
+    void OnRemovedComponent(Component* RemovedComponent);
+    void OnActorParentChanged(Actor* InActor);
+
+    // Recalculates the matrices of the transforms that have changed, parents before their children
+    void UpdateTransforms();
 
+    // Recalculates the cached world space bounds of the MeshDrawCommands whose actor has moved since the last call
+    void UpdateWorldBounds();
+
+    // All components of the class or one of its subclasses in the actors of the scene, without visiting the actors
     template<typename TComponent>
-    FORCEINLINE const TArray<TComponent> GetAllComponentsOfType() const
+    FORCEINLINE TComponentView<TComponent> GetAllComponentsOfType() const
     {
-        // TODO: Cache this result
-
-        TArray<TComponent> Components;
-        for (Actor* Actor : Actors)
-        {
-            TComponent* Component = Actor->GetComponentOfType<TComponent>();
-            if (Component)
-            {
-                Components.EmplaceBack(*Component);
-            }
-        }
-
-        return Move(Components);
+        return Components.GetComponents<TComponent>();
     }
 
+    const ComponentStorage& GetComponentStorage() const { return Components; }
+
     const TArray<Actor*>& GetActors() const { return Actors; }
     const TArray<Light*>& GetLights() const { return Lights; }
 
+    // One for each MeshComponent, with the same index as the component in GetAllComponentsOfType<MeshComponent>
     const TArray<MeshDrawCommand>& GetMeshDrawCommands() const { return MeshDrawCommands; }
+
+    // World space bounds of each MeshDrawCommand, with the same index as the command
+    const BoundingBoxSoA& GetWorldBoundingBoxes() const { return WorldBoundingBoxes; }
+
+    // Center in xyz and radius in w
+    const TArray<XMFLOAT4>& GetWorldBoundingSpheres() const { return WorldBoundingSpheres; }
+
+    // Built over the world space bounding boxes, the object indices are the indices of the MeshDrawCommands
+    const BoundingVolumeHierarchy& GetBoundingVolumeHierarchy() const { return BVH; }
      
     Camera* GetCamera() const { return CurrentCamera; }
 
@@ -53,10 +68,28 @@ public:
 
 private:
     void AddMeshComponent(class MeshComponent* Component);
+    void RemoveMeshComponent(class MeshComponent* Component);
+
+    void CalculateWorldBounds(uint32 CommandIndex);
+
+    // Sorts the actors by their depth in the hierarchy
+    void SortTransforms();
 
     TArray<Actor*> Actors;
     TArray<Light*> Lights;
     TArray<MeshDrawCommand> MeshDrawCommands;
 
+    ComponentStorage Components;
+
+    TArray<Actor*> SortedActors;
+    bool           IsTransformOrderDirty = false;
+
+    BoundingBoxSoA   WorldBoundingBoxes;
+    TArray<XMFLOAT4> WorldBoundingSpheres;
+
+    BoundingVolumeHierarchy BVH;
+    TArray<uint32>          MovedObjects;
+    bool                    IsBVHDirty = true;
+
     Camera* CurrentCamera = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,423 @@
+#include "SceneCache.h"
+
+#include "Rendering/Resources/GltfFile.h"
+
+#include "Utilities/HashUtilities.h"
+
+#include <cstdio>
+#include <unordered_map>
+
+static uint64 AlignOffset(uint64 Offset)
+{
+    return (Offset + (SCENE_CACHE_ALIGNMENT - 1)) & ~uint64(SCENE_CACHE_ALIGNMENT - 1);
+}
+
+// True if Count elements of T at Offset fit in the file and are aligned for T. Offset + Count * sizeof(T) is never
+// calculated, since a corrupt header can make it overflow and wrap around to a small value.
+template<typename T>
+static bool IsTableInFile(uint64 Offset, uint64 Count, uint64 FileSize)
+{
+    if (Offset > FileSize || Offset % alignof(T) != 0)
+    {
+        return false;
+    }
+
+    return Count <= (FileSize - Offset) / sizeof(T);
+}
+
+// Size of an index in the index blob of a mesh
+static uint64 GetIndexSize(uint32 NumVertices)
+{
+    return NumVertices <= MESH_MAX_16BIT_INDEX_VERTICES ? sizeof(uint16) : sizeof(uint32);
+}
+
+// The blobs are copies of PackedVertex and Meshlet, so a change to their layouts or to when 16-bit indices are used
+// must invalidate the cache as well
+static void HashLayout(StreamHasher& Hasher)
+{
+    const uint32 Layout[] = { SCENE_CACHE_VERSION, uint32(sizeof(PackedVertex)), uint32(sizeof(Meshlet)), MESH_MAX_16BIT_INDEX_VERTICES };
+    Hasher.Update(Layout, sizeof(Layout));
+}
+
+static bool WritePadding(FILE* File, uint64 CurrentOffset, uint64 AlignedOffset)
+{
+    static const uint8 Zeros[SCENE_CACHE_ALIGNMENT] = { };
+    const size_t Size = size_t(AlignedOffset - CurrentOffset);
+    return Size == 0 || fwrite(Zeros, 1, Size, File) == Size;
+}
+
+bool SceneCache::Open(const std::string& Filename, uint64 SourceHash)
+{
+    Close();
+
+    if (!File.Open(Filename))
+    {
+        return false;
+    }
+
+    Header = reinterpret_cast<const SceneCacheHeader*>(File.GetData());
+    if (!Validate(SourceHash))
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void SceneCache::Close()
+{
+    File.Close();
+    Header = nullptr;
+}
+
+bool SceneCache::Validate(uint64 SourceHash) const
+{
+    const uint64 FileSize = File.GetSize();
+    if (FileSize < sizeof(SceneCacheHeader))
+    {
+        return false;
+    }
+
+    if (Header->Magic != SCENE_CACHE_MAGIC || Header->Version != SCENE_CACHE_VERSION || Header->SourceHash != SourceHash)
+    {
+        return false;
+    }
+
+    // A file that was not completely written has the wrong size
+    if (Header->FileSize != FileSize)
+    {
+        return false;
+    }
+
+    // The mapping starts at a page boundary, so an aligned offset is an aligned address
+    if (!IsTableInFile<SceneCacheMesh>(Header->MeshesOffset, Header->NumMeshes, FileSize) ||
+        !IsTableInFile<SceneCacheMaterial>(Header->MaterialsOffset, Header->NumMaterials, FileSize) ||
+        !IsTableInFile<SceneCacheActor>(Header->ActorsOffset, Header->NumActors, FileSize) ||
+        !IsTableInFile<char>(Header->StringsOffset, Header->StringsSize, FileSize))
+    {
+        return false;
+    }
+
+    // GetString relies on the last string being terminated
+    const char* Strings = GetTable<char>(Header->StringsOffset);
+    if (Header->StringsSize > 0 && Strings[Header->StringsSize - 1] != '\0')
+    {
+        return false;
+    }
+
+    const SceneCacheMesh* Meshes = GetTable<SceneCacheMesh>(Header->MeshesOffset);
+    for (uint32 Index = 0; Index < Header->NumMeshes; Index++)
+    {
+        const SceneCacheMesh& Mesh = Meshes[Index];
+        const bool IndicesInFile = GetIndexSize(Mesh.NumVertices) == sizeof(uint16) ?
+            IsTableInFile<uint16>(Mesh.IndexOffset, Mesh.NumIndices, FileSize) :
+            IsTableInFile<uint32>(Mesh.IndexOffset, Mesh.NumIndices, FileSize);
+
+        if (!IsTableInFile<PackedVertex>(Mesh.VertexOffset, Mesh.NumVertices, FileSize) || !IndicesInFile ||
+            !IsTableInFile<Meshlet>(Mesh.MeshletOffset, Mesh.NumMeshlets, FileSize))
+        {
+            return false;
+        }
+
+        // The renderer draws the triangles of the meshlets as ranges of the index buffer
+        const Meshlet* Meshlets = GetTable<Meshlet>(Mesh.MeshletOffset);
+        for (uint32 MeshletIndex = 0; MeshletIndex < Mesh.NumMeshlets; MeshletIndex++)
+        {
+            if (uint64(Meshlets[MeshletIndex].FirstTriangle) + Meshlets[MeshletIndex].NumTriangles > Mesh.NumIndices / 3)
+            {
+                return false;
+            }
+        }
+    }
+
+    const SceneCacheActor* Actors = GetTable<SceneCacheActor>(Header->ActorsOffset);
+    for (uint32 Index = 0; Index < Header->NumActors; Index++)
+    {
+        const SceneCacheActor& Actor = Actors[Index];
+        if (Actor.NumMeshes == 0 || uint64(Actor.FirstMesh) + Actor.NumMeshes > Header->NumMeshes)
+        {
+            return false;
+        }
+
+        if (Actor.MaterialID >= int32(Header->NumMaterials))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const char* SceneCache::GetString(uint32 Offset) const
+{
+    if (Offset == SCENE_CACHE_NO_STRING || Offset >= Header->StringsSize)
+    {
+        return "";
+    }
+
+    return GetTable<char>(Header->StringsOffset) + Offset;
+}
+
+void SceneCache::GetScene(CookedScene& OutScene) const
+{
+    Assert(Header != nullptr);
+
+    const uint8* FileData = reinterpret_cast<const uint8*>(File.GetData());
+
+    const SceneCacheMesh* Meshes = GetTable<SceneCacheMesh>(Header->MeshesOffset);
+    OutScene.Meshes.Resize(Header->NumMeshes);
+    for (uint32 Index = 0; Index < Header->NumMeshes; Index++)
+    {
+        const SceneCacheMesh& Source = Meshes[Index];
+
+        CookedMesh& Mesh = OutScene.Meshes[Index];
+        Mesh.Data.Vertices       = reinterpret_cast<const PackedVertex*>(FileData + Source.VertexOffset);
+        Mesh.Data.Indices        = FileData + Source.IndexOffset;
+        Mesh.Data.Meshlets       = reinterpret_cast<const Meshlet*>(FileData + Source.MeshletOffset);
+        Mesh.Data.NumVertices    = Source.NumVertices;
+        Mesh.Data.NumIndices     = Source.NumIndices;
+        Mesh.Data.NumMeshlets    = Source.NumMeshlets;
+        Mesh.Data.PositionOffset = Source.PositionOffset;
+        Mesh.Data.PositionScale  = Source.PositionScale;
+        Mesh.Data.BoundsMin      = Source.BoundsMin;
+        Mesh.Data.BoundsMax      = Source.BoundsMax;
+        Mesh.Error = Source.Error;
+    }
+
+    const SceneCacheMaterial* Materials = GetTable<SceneCacheMaterial>(Header->MaterialsOffset);
+    OutScene.Materials.Resize(Header->NumMaterials);
+    for (uint32 Index = 0; Index < Header->NumMaterials; Index++)
+    {
+        CookedMaterial& Material = OutScene.Materials[Index];
+        Material.Albedo    = Materials[Index].Albedo;
+        Material.Roughness = Materials[Index].Roughness;
+        Material.Metallic  = Materials[Index].Metallic;
+        for (uint32 Texture = 0; Texture < CookedTexture_Count; Texture++)
+        {
+            Material.TextureNames[Texture] = GetString(Materials[Index].TextureNames[Texture]);
+            Material.TextureFlags[Texture] = Materials[Index].TextureFlags[Texture];
+        }
+    }
+
+    const SceneCacheActor* Actors = GetTable<SceneCacheActor>(Header->ActorsOffset);
+    OutScene.Actors.Resize(Header->NumActors);
+    for (uint32 Index = 0; Index < Header->NumActors; Index++)
+    {
+        CookedActor& Actor = OutScene.Actors[Index];
+        Actor.Name       = GetString(Actors[Index].Name);
+        Actor.FirstMesh  = Actors[Index].FirstMesh;
+        Actor.NumMeshes  = Actors[Index].NumMeshes;
+        Actor.MaterialID = Actors[Index].MaterialID;
+    }
+}
+
+bool SceneCache::Write(const std::string& Filename, uint64 SourceHash, const CookedScene& Scene)
+{
+    // Texture names are shared by many materials, so each string is only stored once
+    TArray<char> Strings;
+    std::unordered_map<std::string, uint32> StringOffsets;
+    auto AddString = [&Strings, &StringOffsets](const std::string& String) -> uint32
+    {
+        if (String.empty())
+        {
+            return SCENE_CACHE_NO_STRING;
+        }
+
+        auto It = StringOffsets.find(String);
+        if (It != StringOffsets.end())
+        {
+            return It->second;
+        }
+
+        const uint32 Offset = Strings.Size();
+        for (char Character : String)
+        {
+            Strings.EmplaceBack(Character);
+        }
+
+        Strings.EmplaceBack('\0');
+        StringOffsets[String] = Offset;
+        return Offset;
+    };
+
+    TArray<SceneCacheMaterial> Materials(Scene.Materials.Size());
+    for (uint32 Index = 0; Index < Scene.Materials.Size(); Index++)
+    {
+        Materials[Index].Albedo    = Scene.Materials[Index].Albedo;
+        Materials[Index].Roughness = Scene.Materials[Index].Roughness;
+        Materials[Index].Metallic  = Scene.Materials[Index].Metallic;
+        for (uint32 Texture = 0; Texture < CookedTexture_Count; Texture++)
+        {
+            Materials[Index].TextureNames[Texture] = AddString(Scene.Materials[Index].TextureNames[Texture]);
+            Materials[Index].TextureFlags[Texture] = Scene.Materials[Index].TextureFlags[Texture];
+        }
+    }
+
+    TArray<SceneCacheActor> Actors(Scene.Actors.Size());
+    for (uint32 Index = 0; Index < Scene.Actors.Size(); Index++)
+    {
+        Actors[Index].Name       = AddString(Scene.Actors[Index].Name);
+        Actors[Index].FirstMesh  = Scene.Actors[Index].FirstMesh;
+        Actors[Index].NumMeshes  = Scene.Actors[Index].NumMeshes;
+        Actors[Index].MaterialID = Scene.Actors[Index].MaterialID;
+    }
+
+    // Lay out the file before writing it, so that every table can be written in one go
+    SceneCacheHeader Header = { };
+    Header.Magic        = SCENE_CACHE_MAGIC;
+    Header.Version      = SCENE_CACHE_VERSION;
+    Header.SourceHash   = SourceHash;
+    Header.NumMeshes    = Scene.Meshes.Size();
+    Header.NumMaterials = Materials.Size();
+    Header.NumActors    = Actors.Size();
+    Header.StringsSize  = Strings.Size();
+
+    uint64 Offset = sizeof(SceneCacheHeader);
+    Header.MeshesOffset    = Offset;
+    Offset += uint64(Header.NumMeshes) * sizeof(SceneCacheMesh);
+    Header.MaterialsOffset = Offset;
+    Offset += Materials.SizeInBytes();
+    Header.ActorsOffset    = Offset;
+    Offset += Actors.SizeInBytes();
+    Header.StringsOffset   = Offset;
+    Offset += Strings.SizeInBytes();
+
+    TArray<SceneCacheMesh> Meshes(Scene.Meshes.Size());
+    for (uint32 Index = 0; Index < Scene.Meshes.Size(); Index++)
+    {
+        const PackedMeshDataView& Data = Scene.Meshes[Index].Data;
+
+        SceneCacheMesh& Mesh = Meshes[Index];
+        Mesh.NumVertices    = Data.NumVertices;
+        Mesh.NumIndices     = Data.NumIndices;
+        Mesh.NumMeshlets    = Data.NumMeshlets;
+        Mesh.Error          = Scene.Meshes[Index].Error;
+        Mesh.PositionOffset = Data.PositionOffset;
+        Mesh.PositionScale  = Data.PositionScale;
+        Mesh.BoundsMin      = Data.BoundsMin;
+        Mesh.BoundsMax      = Data.BoundsMax;
+
+        Offset = AlignOffset(Offset);
+        Mesh.VertexOffset = Offset;
+        Offset += uint64(Data.NumVertices) * sizeof(PackedVertex);
+
+        Offset = AlignOffset(Offset);
+        Mesh.IndexOffset = Offset;
+        Offset += uint64(Data.NumIndices) * GetIndexSize(Data.NumVertices);
+
+        Offset = AlignOffset(Offset);
+        Mesh.MeshletOffset = Offset;
+        Offset += uint64(Data.NumMeshlets) * sizeof(Meshlet);
+    }
+
+    Header.FileSize = Offset;
+
+    // Write to a temporary file first, so that a crash never leaves a damaged cache behind
+    const std::string TempFilename = Filename + ".tmp";
+    FILE* File = fopen(TempFilename.c_str(), "wb");
+    if (!File)
+    {
+        LOG_ERROR("[SceneCache]: Failed to open '" + TempFilename + "' for writing");
+        return false;
+    }
+
+    bool Result =
+        fwrite(&Header, sizeof(SceneCacheHeader), 1, File) == 1 &&
+        fwrite(Meshes.Data(), 1, Meshes.SizeInBytes(), File) == Meshes.SizeInBytes() &&
+        fwrite(Materials.Data(), 1, Materials.SizeInBytes(), File) == Materials.SizeInBytes() &&
+        fwrite(Actors.Data(), 1, Actors.SizeInBytes(), File) == Actors.SizeInBytes() &&
+        fwrite(Strings.Data(), 1, Strings.SizeInBytes(), File) == Strings.SizeInBytes();
+
+    Offset = Header.StringsOffset + Strings.SizeInBytes();
+    for (uint32 Index = 0; Result && Index < Scene.Meshes.Size(); Index++)
+    {
+        const PackedMeshDataView& Data = Scene.Meshes[Index].Data;
+        const SceneCacheMesh&     Mesh = Meshes[Index];
+
+        const size_t VertexSize = size_t(Data.NumVertices) * sizeof(PackedVertex);
+        Result = WritePadding(File, Offset, Mesh.VertexOffset) && fwrite(Data.Vertices, 1, VertexSize, File) == VertexSize;
+        Offset = Mesh.VertexOffset + VertexSize;
+
+        const size_t IndexSize = size_t(Data.NumIndices * GetIndexSize(Data.NumVertices));
+        Result = Result && WritePadding(File, Offset, Mesh.IndexOffset) && fwrite(Data.Indices, 1, IndexSize, File) == IndexSize;
+        Offset = Mesh.IndexOffset + IndexSize;
+
+        const size_t MeshletSize = size_t(Data.NumMeshlets) * sizeof(Meshlet);
+        Result = Result && WritePadding(File, Offset, Mesh.MeshletOffset) && fwrite(Data.Meshlets, 1, MeshletSize, File) == MeshletSize;
+        Offset = Mesh.MeshletOffset + MeshletSize;
+    }
+
+    Result = (fclose(File) == 0) && Result;
+    if (!Result)
+    {
+        LOG_ERROR("[SceneCache]: Failed to write '" + TempFilename + "'");
+        remove(TempFilename.c_str());
+        return false;
+    }
+
+    remove(Filename.c_str());
+    if (rename(TempFilename.c_str(), Filename.c_str()) != 0)
+    {
+        LOG_ERROR("[SceneCache]: Failed to rename '" + TempFilename + "' to '" + Filename + "'");
+        remove(TempFilename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+uint64 SceneCache::HashObjSource(const std::string& Filename, const std::string& MTLDirectory)
+{
+    MappedFile ObjFile;
+    if (!ObjFile.Open(Filename))
+    {
+        return 0;
+    }
+
+    const char* Text = reinterpret_cast<const char*>(ObjFile.GetData());
+    const uint64 Size = ObjFile.GetSize();
+
+    StreamHasher Hasher;
+    HashLayout(Hasher);
+    Hasher.Update(Text, size_t(Size));
+
+    // The materials are part of the source as well
+    const char MTLLibKeyword[] = "mtllib ";
+    const uint64 KeywordLength = sizeof(MTLLibKeyword) - 1;
+    for (uint64 LineStart = 0; LineStart < Size;)
+    {
+        uint64 LineEnd = LineStart;
+        while (LineEnd < Size && Text[LineEnd] != '\n' && Text[LineEnd] != '\r')
+        {
+            LineEnd++;
+        }
+
+        if (LineEnd - LineStart > KeywordLength && memcmp(Text + LineStart, MTLLibKeyword, KeywordLength) == 0)
+        {
+            const std::string MTLFilename = MTLDirectory + '/' + std::string(Text + LineStart + KeywordLength, Text + LineEnd);
+
+            MappedFile MTLFile;
+            if (MTLFile.Open(MTLFilename))
+            {
+                Hasher.Update(MTLFile.GetData(), size_t(MTLFile.GetSize()));
+            }
+            else
+            {
+                Hasher.Update(MTLFilename.c_str(), MTLFilename.size());
+            }
+        }
+
+        LineStart = LineEnd + 1;
+    }
+
+    return Hasher.GetHash();
+}
+
+uint64 SceneCache::HashGltfSource(const GltfFile& File)
+{
+    StreamHasher Hasher;
+    HashLayout(Hasher);
+    File.HashContents(Hasher);
+    return Hasher.GetHash();
+}
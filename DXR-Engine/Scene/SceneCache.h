@@ -0,0 +1,173 @@
+#pragma once
+#include "Rendering/Resources/MeshFactory.h"
+
+#include "Core/IO/Platform/MappedFile.h"
+
+#include "Core/Containers/Array.h"
+
+constexpr uint32 SCENE_CACHE_MAGIC   = 0x43535844; // "DXSC"
+constexpr uint32 SCENE_CACHE_VERSION = 5;
+
+// Vertex, index and meshlet blobs start at this alignment in the file
+constexpr uint32 SCENE_CACHE_ALIGNMENT = 16;
+
+constexpr uint32 SCENE_CACHE_NO_STRING = uint32(~0);
+
+// Appended to the path of the source file
+constexpr const char* SCENE_CACHE_EXTENSION = ".cooked";
+
+enum ECookedTexture : uint32
+{
+    CookedTexture_Metallic  = 0,
+    CookedTexture_Albedo    = 1,
+    CookedTexture_Roughness = 2,
+    CookedTexture_Normal    = 3,
+    CookedTexture_Alpha     = 4,
+    CookedTexture_AO        = 5,
+    CookedTexture_Count     = 6,
+};
+
+struct CookedMesh
+{
+    PackedMeshDataView Data;
+
+    // Error of the LOD relative to the size of the mesh, zero for the original mesh
+    float Error = 0.0f;
+};
+
+struct CookedMaterial
+{
+    XMFLOAT3 Albedo    = XMFLOAT3(1.0f, 1.0f, 1.0f);
+    float    Roughness = 1.0f;
+    float    Metallic  = 0.0f;
+
+    // Relative to the directory of the scene, empty when the material does not use the texture
+    std::string TextureNames[CookedTexture_Count];
+
+    // ETextureFactoryFlags that are added to the flags of the slot, selects the channel of images with packed channels
+    uint32 TextureFlags[CookedTexture_Count] = { };
+};
+
+struct CookedActor
+{
+    std::string Name;
+
+    // Meshes[FirstMesh] is the mesh of the actor and the following NumMeshes - 1 meshes are its LODs
+    uint32 FirstMesh = 0;
+    uint32 NumMeshes = 0;
+
+    // -1 when the actor uses the default material
+    int32 MaterialID = -1;
+};
+
+// A scene after import, where all the work that does not need a device is already done
+struct CookedScene
+{
+    TArray<CookedMesh>     Meshes;
+    TArray<CookedMaterial> Materials;
+    TArray<CookedActor>    Actors;
+};
+
+/*
+* File layout of the cache. The header is followed by the mesh, material and actor tables, the string table and the
+* vertex, index and meshlet blobs. All offsets are from the start of the file, and strings are offsets into the string table.
+* The blobs are stored the way that Mesh uploads them, PackedVertex and 16-bit indices for meshes with at most
+* MESH_MAX_16BIT_INDEX_VERTICES vertices.
+*/
+
+struct SceneCacheHeader
+{
+    uint32 Magic;
+    uint32 Version;
+    uint64 SourceHash;
+    uint64 FileSize;
+
+    uint32 NumMeshes;
+    uint32 NumMaterials;
+    uint32 NumActors;
+    uint32 StringsSize;
+
+    uint64 MeshesOffset;
+    uint64 MaterialsOffset;
+    uint64 ActorsOffset;
+    uint64 StringsOffset;
+};
+
+struct SceneCacheMesh
+{
+    uint64 VertexOffset;
+    uint64 IndexOffset;
+    uint64 MeshletOffset;
+    uint32 NumVertices;
+    uint32 NumIndices;
+    uint32 NumMeshlets;
+    float  Error;
+
+    XMFLOAT3 PositionOffset;
+    float    PositionScale;
+    XMFLOAT3 BoundsMin;
+    XMFLOAT3 BoundsMax;
+};
+
+struct SceneCacheMaterial
+{
+    XMFLOAT3 Albedo;
+    float    Roughness;
+    float    Metallic;
+    uint32   TextureNames[CookedTexture_Count];
+    uint32   TextureFlags[CookedTexture_Count];
+};
+
+struct SceneCacheActor
+{
+    uint32 Name;
+    uint32 FirstMesh;
+    uint32 NumMeshes;
+    int32  MaterialID;
+};
+
+static_assert(sizeof(SceneCacheHeader) == 72, "SceneCacheHeader must not have any padding");
+static_assert(sizeof(SceneCacheMesh) == 80, "SceneCacheMesh must not have any padding");
+static_assert(sizeof(SceneCacheMaterial) == 68, "SceneCacheMaterial must not have any padding");
+
+/*
+* Cooked version of a scene that is written the first time the scene is imported. Later loads map the file into memory
+* and the meshes of the CookedScene point straight into the mapping, so the vertices, indices and meshlets are used
+* without being parsed or copied. The cache stores a hash of the source files and is not used when they have changed.
+*/
+
+class SceneCache
+{
+public:
+    SceneCache()  = default;
+    ~SceneCache() = default;
+
+    // Returns false if the file does not exist, is damaged, or was cooked from another version of the source
+    bool Open(const std::string& Filename, uint64 SourceHash);
+    void Close();
+
+    // The meshes point into the file, which has to stay open while they are used
+    void GetScene(CookedScene& OutScene) const;
+
+    static bool Write(const std::string& Filename, uint64 SourceHash, const CookedScene& Scene);
+
+    // Hash of an OBJ file and of the MTL files that it references, zero if the OBJ file could not be read
+    static uint64 HashObjSource(const std::string& Filename, const std::string& MTLDirectory);
+
+    // Hash of a glTF file and of the buffers that it references
+    static uint64 HashGltfSource(const class GltfFile& File);
+
+private:
+    bool Validate(uint64 SourceHash) const;
+
+    const char* GetString(uint32 Offset) const;
+
+    template<typename T>
+    const T* GetTable(uint64 Offset) const
+    {
+        return reinterpret_cast<const T*>(reinterpret_cast<const uint8*>(File.GetData()) + Offset);
+    }
+
+    MappedFile File;
+    const SceneCacheHeader* Header = nullptr;
+};
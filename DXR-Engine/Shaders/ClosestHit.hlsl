@@ -2,6 +2,7 @@
 #include "Structs.hlsli"
 #include "RayTracingHelpers.hlsli"
 #include "Constants.hlsli"
+#include "MeshVertex.hlsli"
 
 // Global RootSignature
 RaytracingAccelerationStructure Scene : register(t0, space0);
@@ -13,9 +14,9 @@ Texture2D<float4>   MaterialTextures[128] : register(t4, space0);
 
 SamplerState TextureSampler : register(s1, space0);
 
-// Local RootSignature
-StructuredBuffer<Vertex> Vertices  : register(t0, D3D12_SHADER_REGISTER_SPACE_RT_LOCAL);
-ByteAddressBuffer        InIndices : register(t1, D3D12_SHADER_REGISTER_SPACE_RT_LOCAL);
+// Local RootSignature, the vertex and index buffers that the mesh is drawn with
+ByteAddressBuffer InVertices : register(t0, D3D12_SHADER_REGISTER_SPACE_RT_LOCAL);
+ByteAddressBuffer InIndices  : register(t1, D3D12_SHADER_REGISTER_SPACE_RT_LOCAL);
 
 //ConstantBuffer<Material> MaterialBuffer : register(b0, D3D12_SHADER_REGISTER_SPACE_RT_LOCAL);
 
@@ -28,27 +29,90 @@ ByteAddressBuffer        InIndices : register(t1, D3D12_SHADER_REGISTER_SPACE_RT
 
 //SamplerState TextureSampler : register(s0, D3D12_SHADER_REGISTER_SPACE_RT_LOCAL);
 
+// Size of PackedVertex or Vertex
+#if ENABLE_PACKED_VERTICES
+    #define VERTEX_STRIDE 20
+#else
+    #define VERTEX_STRIDE 44
+#endif
+
+// The attributes of a vertex that the hit shader interpolates
+struct HitVertex
+{
+    float3 Normal;
+    float3 Tangent;
+    float2 TexCoord;
+};
+
+// Two R16_Snorm values in one word, the first in the low bits
+float2 UnpackSnorm2x16(uint Packed)
+{
+    const int2 Signed = asint(uint2(Packed << 16, Packed)) >> 16;
+    return max(float2(Signed) / 32767.0f, -1.0f);
+}
+
+HitVertex LoadVertex(uint VertexIndex)
+{
+    const uint Address = VertexIndex * VERTEX_STRIDE;
+
+    HitVertex Result;
+#if ENABLE_PACKED_VERTICES
+    // The position is not needed, the normal and tangent are octahedral encoded and the texcoord is two halfs
+    const uint3 Packed = InVertices.Load3(Address + 8);
+    Result.Normal   = OctahedronDecode(UnpackSnorm2x16(Packed.x));
+    Result.Tangent  = OctahedronDecode(UnpackSnorm2x16(Packed.y));
+    Result.TexCoord = float2(f16tof32(Packed.z), f16tof32(Packed.z >> 16));
+#else
+    Result.Normal   = asfloat(InVertices.Load3(Address + 12));
+    Result.Tangent  = asfloat(InVertices.Load3(Address + 24));
+    Result.TexCoord = asfloat(InVertices.Load2(Address + 36));
+#endif
+    return Result;
+}
+
+uint3 LoadTriangleIndices(uint TriangleIndex)
+{
+    // MeshFactory::PackMesh uses 16-bit indices exactly when the mesh has at most MESH_MAX_16BIT_INDEX_VERTICES vertices
+    uint NumVertexBytes;
+    InVertices.GetDimensions(NumVertexBytes);
+    if (NumVertexBytes / VERTEX_STRIDE > MESH_MAX_16BIT_INDEX_VERTICES)
+    {
+        return InIndices.Load3(TriangleIndex * 12);
+    }
+
+    // Loads have to be aligned to four bytes, so the two words that contain the three indices are loaded
+    const uint Address        = TriangleIndex * 6;
+    const uint AlignedAddress = Address & ~3;
+    const uint2 Words = InIndices.Load2(AlignedAddress);
+    if (Address == AlignedAddress)
+    {
+        return uint3(Words.x & 0xffff, Words.x >> 16, Words.y & 0xffff);
+    }
+    else
+    {
+        return uint3(Words.x >> 16, Words.y & 0xffff, Words.y >> 16);
+    }
+}
+
 [shader("closesthit")]
 void ClosestHit(inout RayPayload PayLoad, in BuiltInTriangleIntersectionAttributes IntersectionAttributes)
 {
     PayLoad.Color        = float3(1.0f, 0.0f, 0.0f);
     PayLoad.CurrentDepth = PayLoad.CurrentDepth + 1;
     
-    // Get the base index of the triangle's first 16 bit index.
-    const uint IndexSizeInBytes    = 4;
-    const uint IndicesPerTriangle  = 3;
-    const uint TriangleIndexStride = IndicesPerTriangle * IndexSizeInBytes;
-    const uint BaseIndex           = PrimitiveIndex() * TriangleIndexStride;
-
-    // Load up three indices for the triangle.
-    uint3 Indices = InIndices.Load3(BaseIndex);
+    const uint3 Indices = LoadTriangleIndices(PrimitiveIndex());
+    const HitVertex Vertices[3] =
+    {
+        LoadVertex(Indices[0]),
+        LoadVertex(Indices[1]),
+        LoadVertex(Indices[2])
+    };
 
-    // Retrieve corresponding vertex normals for the triangle vertices.
     float3 TriangleNormals[3] =
     {
-        Vertices[Indices[0]].Normal,
-        Vertices[Indices[1]].Normal,
-        Vertices[Indices[2]].Normal
+        Vertices[0].Normal,
+        Vertices[1].Normal,
+        Vertices[2].Normal
     };
 
     float3 BarycentricCoords = float3(
@@ -61,16 +125,16 @@ void ClosestHit(inout RayPayload PayLoad, in BuiltInTriangleIntersectionAttribut
     
     float3 TriangleTangent[3] =
     {
-        Vertices[Indices[0]].Tangent,
-        Vertices[Indices[1]].Tangent,
-        Vertices[Indices[2]].Tangent
+        Vertices[0].Tangent,
+        Vertices[1].Tangent,
+        Vertices[2].Tangent
     };
 
     float2 TriangleTexCoords[3] =
     {
-        Vertices[Indices[0]].TexCoord,
-        Vertices[Indices[1]].TexCoord,
-        Vertices[Indices[2]].TexCoord
+        Vertices[0].TexCoord,
+        Vertices[1].TexCoord,
+        Vertices[2].TexCoord
     };
 
     float2 TexCoords =
@@ -89,8 +153,8 @@ void ClosestHit(inout RayPayload PayLoad, in BuiltInTriangleIntersectionAttribut
     uint AlbedoIndex  = TextureIndex;
     uint NormalIndex  = TextureIndex + 1;
     
-    float3 MappedNormal = MaterialTextures[NormalIndex].SampleLevel(TextureSampler, TexCoords, 0).rgb;
-    MappedNormal = UnpackNormal(MappedNormal);
+    float2 MappedNormalXY = MaterialTextures[NormalIndex].SampleLevel(TextureSampler, TexCoords, 0).rg;
+    float3 MappedNormal   = UnpackNormalMap(MappedNormalXY);
     
     float3 Bitangent = normalize(cross(Normal, Tangent));
     Normal = ApplyNormalMapping(MappedNormal, Normal, Tangent, Bitangent);
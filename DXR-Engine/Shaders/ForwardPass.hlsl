@@ -2,6 +2,7 @@
 #include "Helpers.hlsli"
 #include "Structs.hlsli"
 #include "ShadowHelpers.hlsli"
+#include "MeshVertex.hlsli"
 
 #if ENABLE_PARALLAX_MAPPING
 #define PARALLAX_MAPPING_ENABLED
@@ -76,14 +77,6 @@ Texture2D<float> MetallicTex : register(t9, space0);
 Texture2D<float> AOTex       : register(t10, space0);
 Texture2D<float> AlphaTex    : register(t11, space0);
 
-struct VSInput
-{
-    float3 Position	: POSITION0;
-    float3 Normal	: NORMAL0;
-    float3 Tangent	: TANGENT0;
-    float2 TexCoord	: TEXCOORD0;
-};
-
 struct VSOutput
 {
     float3 WorldPosition : POSITION0;
@@ -100,15 +93,15 @@ struct VSOutput
     float4 Position : SV_Position;
 };
 
-VSOutput VSMain(VSInput Input)
+VSOutput VSMain(MeshVertex Input)
 {
     VSOutput Output;
     
-    float3 Normal = normalize(mul(float4(Input.Normal, 0.0f), TransformBuffer.Transform).xyz);
+    float3 Normal = normalize(mul(float4(GetVertexNormal(Input), 0.0f), TransformBuffer.Transform).xyz);
     Output.Normal = Normal;
     
 #ifdef NORMAL_MAPPING_ENABLED
-    float3 Tangent = normalize(mul(float4(Input.Tangent, 0.0f), TransformBuffer.Transform).xyz);
+    float3 Tangent = normalize(mul(float4(GetVertexTangent(Input), 0.0f), TransformBuffer.Transform).xyz);
     Tangent        = normalize(Tangent - dot(Tangent, Normal) * Normal);
     Output.Tangent = Tangent;
     
@@ -219,8 +212,8 @@ float4 PSMain(PSInput Input) : SV_Target0
     }
     
 #ifdef NORMAL_MAPPING_ENABLED
-    float3 SampledNormal = NormalTex.Sample(MaterialSampler, TexCoords).rgb;
-    SampledNormal        = UnpackNormal(SampledNormal);
+    float2 SampledNormalXY = NormalTex.Sample(MaterialSampler, TexCoords).rg;
+    float3 SampledNormal   = UnpackNormalMap(SampledNormalXY);
     
     float3 Tangent   = normalize(Input.Tangent);
     float3 Bitangent = normalize(Input.Bitangent);
@@ -1,6 +1,7 @@
 #include "PBRHelpers.hlsli"
 #include "Structs.hlsli"
 #include "Constants.hlsli"
+#include "MeshVertex.hlsli"
 
 #if ENABLE_PARALLAX_MAPPING
     #define PARALLAX_MAPPING_ENABLED
@@ -31,14 +32,6 @@ Texture2D<float4> MetallicMap	: register(t4, space0);
 Texture2D<float4> AOMap			: register(t5, space0);
 
 // VertexShader
-struct VSInput
-{
-    float3 Position : POSITION0;
-    float3 Normal	: NORMAL0;
-    float3 Tangent	: TANGENT0;
-    float2 TexCoord : TEXCOORD0;
-};
-
 struct VSOutput
 {
     float3 Normal		: NORMAL0;
@@ -55,19 +48,19 @@ struct VSOutput
     float4 Position		: SV_Position;
 };
 
-VSOutput VSMain(VSInput Input)
+VSOutput VSMain(MeshVertex Input)
 {
     VSOutput Output;
     
     const float4x4 TransformInv = TransformBuffer.TransformInv;
-    float3 Normal = normalize(mul(float4(Input.Normal, 0.0f), TransformInv).xyz);
+    float3 Normal = normalize(mul(float4(GetVertexNormal(Input), 0.0f), TransformInv).xyz);
     Output.Normal = Normal;
     
     float3 ViewNormal = mul(float4(Normal, 0.0f), CameraBuffer.View).xyz;
     Output.ViewNormal = ViewNormal;
     
 #if defined(NORMAL_MAPPING_ENABLED) || defined(PARALLAX_MAPPING_ENABLED)
-    float3 Tangent	= normalize(mul(float4(Input.Tangent, 0.0f), TransformInv).xyz);
+    float3 Tangent	= normalize(mul(float4(GetVertexTangent(Input), 0.0f), TransformInv).xyz);
     Tangent			= normalize(Tangent - dot(Tangent, Normal) * Normal);
     Output.Tangent	= Tangent;
     
@@ -175,8 +168,8 @@ PSOutput PSMain(PSInput Input)
     float3 SampledAlbedo = ApplyGamma(AlbedoMap.Sample(MaterialSampler, TexCoords).rgb) * MaterialBuffer.Albedo;
     
 #ifdef NORMAL_MAPPING_ENABLED
-    float3 SampledNormal	= NormalMap.Sample(MaterialSampler, TexCoords).rgb;
-    SampledNormal			= UnpackNormal(SampledNormal);
+    float2 SampledNormalXY	= NormalMap.Sample(MaterialSampler, TexCoords).rg;
+    float3 SampledNormal	= UnpackNormalMap(SampledNormalXY);
     SampledNormal.y			= -SampledNormal.y;
     
     float3 Tangent		= normalize(Input.Tangent);
@@ -149,6 +149,14 @@ float3 UnpackNormal(float3 SampledNormal)
     return normalize((SampledNormal * 2.0f) - 1.0f);
 }
 
+// Normal maps only store X and Y, since they are compressed as BC5 which has two channels
+float3 UnpackNormalMap(float2 SampledNormal)
+{
+    float2 XY = (SampledNormal * 2.0f) - 1.0f;
+    float  Z  = sqrt(saturate(1.0f - dot(XY, XY)));
+    return normalize(float3(XY, Z));
+}
+
 float3 PackNormal(float3 Normal)
 {
     return (normalize(Normal) + 1.0f) * 0.5f;
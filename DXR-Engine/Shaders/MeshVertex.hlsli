@@ -0,0 +1,46 @@
+#ifndef MESH_VERTEX_HLSLI
+#define MESH_VERTEX_HLSLI
+
+// Vertex of a mesh. With ENABLE_PACKED_VERTICES the position is relative to the bounding box of the mesh, which the
+// transform of the object moves back, and the normal and tangent are octahedral encoded.
+struct MeshVertex
+{
+    float3 Position : POSITION0;
+#if ENABLE_PACKED_VERTICES
+    float2 Normal   : NORMAL0;
+    float2 Tangent  : TANGENT0;
+#else
+    float3 Normal   : NORMAL0;
+    float3 Tangent  : TANGENT0;
+#endif
+    float2 TexCoord : TEXCOORD0;
+};
+
+// Inverse of the octahedral encoding in MeshFactory::PackVertices, the result is not normalized
+float3 OctahedronDecode(float2 Encoded)
+{
+    float3 Direction = float3(Encoded, 1.0f - abs(Encoded.x) - abs(Encoded.y));
+    float  Fold      = saturate(-Direction.z);
+    Direction.xy += (Direction.xy >= 0.0f) ? -Fold : Fold;
+    return Direction;
+}
+
+float3 GetVertexNormal(MeshVertex Vertex)
+{
+#if ENABLE_PACKED_VERTICES
+    return OctahedronDecode(Vertex.Normal);
+#else
+    return Vertex.Normal;
+#endif
+}
+
+float3 GetVertexTangent(MeshVertex Vertex)
+{
+#if ENABLE_PACKED_VERTICES
+    return OctahedronDecode(Vertex.Tangent);
+#else
+    return Vertex.Tangent;
+#endif
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "Structs.hlsli"
 #include "Constants.hlsli"
+#include "MeshVertex.hlsli"
 
 // PerObject Constants
 cbuffer TransformBuffer : register(b0, D3D12_SHADER_REGISTER_SPACE_32BIT_CONSTANTS)
@@ -11,15 +12,7 @@ cbuffer TransformBuffer : register(b0, D3D12_SHADER_REGISTER_SPACE_32BIT_CONSTAN
 ConstantBuffer<Camera> CameraBuffer : register(b0, space0);
 
 // VertexShader
-struct VSInput
-{
-    float3 Position : POSITION0;
-    float3 Normal   : NORMAL0;
-    float3 Tangent  : TANGENT0;
-    float2 TexCoord : TEXCOORD0;
-};
-
-float4 Main(VSInput Input) : SV_POSITION
+float4 Main(MeshVertex Input) : SV_POSITION
 {
     float4 WorldPosition = mul(float4(Input.Position, 1.0f), TransformMat);
     return mul(WorldPosition, CameraBuffer.ViewProjection);
@@ -1,4 +1,5 @@
 #include "Constants.hlsli"
+#include "MeshVertex.hlsli"
 
 // PerObject
 cbuffer TransformBuffer : register(b0, D3D12_SHADER_REGISTER_SPACE_32BIT_CONSTANTS)
@@ -15,19 +16,10 @@ cbuffer LightBuffer : register(b0, space0)
     float    LightFarPlane;
 }
 
-// VS
-struct VSInput
-{
-    float3 Position : POSITION0;
-    float3 Normal	: NORMAL0;
-    float3 Tangent	: TANGENT0;
-    float2 TexCoord : TEXCOORD0;
-};
-
 // Normal ShadowMap Generation
-float4 Main(VSInput Input) : SV_POSITION
+float4 Main(MeshVertex Input) : SV_POSITION
 {
-    float3 Normal	= normalize(Input.Normal);
+    float3 Normal	= normalize(GetVertexNormal(Input));
     float3 Position = Input.Position + (Normal * ShadowOffset);
     
     float4 WorldPosition = mul(float4(Position, 1.0f), Transform);
@@ -41,7 +33,7 @@ struct VSOutput
     float4 Position			: SV_POSITION;
 };
 
-VSOutput VSMain(VSInput Input)
+VSOutput VSMain(MeshVertex Input)
 {
     VSOutput Output = (VSOutput)0;
     
@@ -60,7 +52,7 @@ float PSMain(float3 WorldPosition : POSITION0) : SV_Depth
 }
 
 // Variance Shadow Generation
-float4 VSM_VSMain(VSInput Input) : SV_Position
+float4 VSM_VSMain(MeshVertex Input) : SV_Position
 {
     float4 WorldPosition = mul(float4(Input.Position, 1.0f), Transform);
     return mul(WorldPosition, LightProjection);
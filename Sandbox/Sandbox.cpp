@@ -38,6 +38,7 @@ bool Sandbox::Init()
     MeshData SphereMeshData     = MeshFactory::CreateSphere(3);
     TSharedPtr<Mesh> SphereMesh = Mesh::Make(SphereMeshData);
     SphereMesh->ShadowOffset = 0.05f;
+    SphereMesh->CreateOccluder(SphereMeshData);
 
     // Create standard textures
     uint8 Pixels[] =
@@ -147,9 +148,10 @@ bool Sandbox::Init()
 
     NewComponent = DBG_NEW MeshComponent(NewActor);
     NewComponent->Mesh     = Mesh::Make(CubeMeshData);
+    NewComponent->Mesh->CreateOccluder(CubeMeshData);
     NewComponent->Material = MakeShared<Material>(MatProperties);
 
-    TRef<Texture2D> AlbedoMap = TextureFactory::LoadFromFile("../Assets/Textures/Gate_Albedo.png", TextureFactoryFlag_GenerateMips, EFormat::R8G8B8A8_Unorm);
+    TRef<Texture2D> AlbedoMap = TextureFactory::LoadFromFile("../Assets/Textures/Gate_Albedo.png", TextureFactoryFlag_GenerateMips | TextureFactoryFlag_SRGB, EFormat::R8G8B8A8_Unorm);
     if (!AlbedoMap)
     {
         return false;
@@ -159,7 +161,7 @@ bool Sandbox::Init()
         AlbedoMap->SetName("AlbedoMap");
     }
 
-    TRef<Texture2D> NormalMap = TextureFactory::LoadFromFile("../Assets/Textures/Gate_Normal.png", TextureFactoryFlag_GenerateMips, EFormat::R8G8B8A8_Unorm);
+    TRef<Texture2D> NormalMap = TextureFactory::LoadFromFile("../Assets/Textures/Gate_Normal.png", TextureFactoryFlag_GenerateMips | TextureFactoryFlag_NormalMap, EFormat::R8G8B8A8_Unorm);
     if (!NormalMap)
     {
         return false;
@@ -232,8 +234,11 @@ bool Sandbox::Init()
     MatProperties.EnableHeight = 0;
     MatProperties.Albedo       = XMFLOAT3(1.0f, 1.0f, 1.0f);
 
+    MeshData PlaneMeshData = MeshFactory::CreatePlane(10, 10);
+
     NewComponent = DBG_NEW MeshComponent(NewActor);
-    NewComponent->Mesh     = Mesh::Make(MeshFactory::CreatePlane(10, 10));
+    NewComponent->Mesh     = Mesh::Make(PlaneMeshData);
+    NewComponent->Mesh->CreateOccluder(PlaneMeshData);
     NewComponent->Material = MakeShared<Material>(MatProperties);
     NewComponent->Material->AlbedoMap    = BaseTexture;
     NewComponent->Material->NormalMap    = BaseNormal;
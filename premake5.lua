@@ -238,4 +238,70 @@ workspace "DXR-Project"
 			"DXR-Engine",
 		}
 	project "*"
-	
\ No newline at end of file
+	
+
+	-- CommandListReplay Project
+    project "CommandListReplay"
+		language 		"C++"
+        cppdialect 		"C++17"
+        systemversion 	"latest"
+        location 		"CommandListReplay"
+        kind 			"ConsoleApp"
+		characterset 	"Ascii"
+	
+	    -- Targets
+		targetdir 	("Build/bin/" .. outputdir .. "/%{prj.name}")
+		objdir 		("Build/bin-int/" .. outputdir .. "/%{prj.name}")	
+	
+		sysincludedirs
+		{
+			"DXR-Engine",	
+			"Dependencies/imgui",
+            "Dependencies/Template-Library"
+		}
+		
+		-- Files to include
+		files 
+		{ 
+			"%{prj.name}/**.h",
+			"%{prj.name}/**.cpp",
+        }
+	
+		links
+		{ 
+			"DXR-Engine",
+		}
+	project "*"
+
+	-- Benchmarks Project
+    project "Benchmarks"
+		language 		"C++"
+        cppdialect 		"C++17"
+        systemversion 	"latest"
+        location 		"Benchmarks"
+        kind 			"ConsoleApp"
+		characterset 	"Ascii"
+	
+	    -- Targets
+		targetdir 	("Build/bin/" .. outputdir .. "/%{prj.name}")
+		objdir 		("Build/bin-int/" .. outputdir .. "/%{prj.name}")	
+	
+		sysincludedirs
+		{
+			"DXR-Engine",	
+			"Dependencies/imgui",
+            "Dependencies/Template-Library"
+		}
+		
+		-- Files to include
+		files 
+		{ 
+			"%{prj.name}/**.h",
+			"%{prj.name}/**.cpp",
+        }
+	
+		links
+		{ 
+			"DXR-Engine",
+		}
+	project "*"